@@ -54,6 +54,25 @@ namespace Eagle._Commands
                 {
                     if (arguments.Count >= 2)
                     {
+                        //
+                        // NOTE: When there is exactly one index, attempt to
+                        //       extract that element without splitting the
+                        //       list first.
+                        //
+                        if (arguments.Count == 3)
+                        {
+                            string element = null;
+
+                            if (ListOps.TryGetListElement(
+                                    interpreter, arguments[1], arguments[2],
+                                    interpreter.InternalCultureInfo,
+                                    ref element))
+                            {
+                                result = element;
+                                return ReturnCode.Ok;
+                            }
+                        }
+
                         int argumentIndex = 1;
                         Argument argument = arguments[argumentIndex];
                         StringList inputList;
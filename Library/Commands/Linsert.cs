@@ -51,6 +51,21 @@ namespace Eagle._Commands
                 {
                     if (arguments.Count >= 4)
                     {
+                        string text = null;
+
+                        //
+                        // NOTE: Attempt to insert the new elements without
+                        //       splitting the whole list first.
+                        //
+                        if (ListOps.TryInsertList(
+                                interpreter, arguments[1], arguments[2],
+                                arguments, 3, interpreter.InternalCultureInfo,
+                                ref text))
+                        {
+                            result = text;
+                            return ReturnCode.Ok;
+                        }
+
                         StringList list = null;
 
                         //
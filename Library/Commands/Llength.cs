@@ -49,14 +49,29 @@ namespace Eagle._Commands
                 {
                     if (arguments.Count == 2)
                     {
-                        StringList list = null;
+                        int count = 0;
 
-                        code = ListOps.GetOrCopyOrSplitList(
-                            interpreter, arguments[1], true, ref list,
-                            ref result);
+                        //
+                        // NOTE: Attempt to count the list elements without
+                        //       splitting the list first.  If that is not
+                        //       possible, fallback to splitting it.
+                        //
+                        if (ListOps.TryGetListCount(
+                                interpreter, arguments[1], ref count))
+                        {
+                            result = count;
+                        }
+                        else
+                        {
+                            StringList list = null;
 
-                        if (code == ReturnCode.Ok)
-                            result = list.Count;
+                            code = ListOps.GetOrCopyOrSplitList(
+                                interpreter, arguments[1], true, ref list,
+                                ref result);
+
+                            if (code == ReturnCode.Ok)
+                                result = list.Count;
+                        }
                     }
                     else
                     {
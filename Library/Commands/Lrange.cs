@@ -54,6 +54,21 @@ namespace Eagle._Commands
                 {
                     if (arguments.Count == 4)
                     {
+                        string text = null;
+
+                        //
+                        // NOTE: Attempt to extract the range of elements
+                        //       without splitting the whole list first.
+                        //
+                        if (ListOps.TryGetListRange(
+                                interpreter, arguments[1], arguments[2],
+                                arguments[3], interpreter.InternalCultureInfo,
+                                ref text))
+                        {
+                            result = text;
+                            return ReturnCode.Ok;
+                        }
+
                         StringList list = null;
 
                         code = ListOps.GetOrCopyOrSplitList(
@@ -52,6 +52,21 @@ namespace Eagle._Commands
                 {
                     if (arguments.Count >= 4)
                     {
+                        string text = null;
+
+                        //
+                        // NOTE: Attempt to replace the range of elements
+                        //       without splitting the whole list first.
+                        //
+                        if (ListOps.TryReplaceListRange(
+                                interpreter, arguments[1], arguments[2],
+                                arguments[3], arguments, 4,
+                                interpreter.InternalCultureInfo, ref text))
+                        {
+                            result = text;
+                            return ReturnCode.Ok;
+                        }
+
                         StringList list = null;
 
                         //
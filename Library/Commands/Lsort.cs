@@ -115,6 +115,12 @@ namespace Eagle._Commands
 
                                     IntDictionary duplicates = null;
                                     IComparer<string> comparer = null;
+                                    long[] wideValues = null;
+
+#if NATIVE && NATIVE_UTILITY
+                                    bool nativeSort = false;
+                                    bool nativeInteger = false;
+#endif
 
                                     if (options.IsPresent("-command", ref value))
                                     {
@@ -157,6 +163,14 @@ namespace Eagle._Commands
                                     }
                                     else if (options.IsPresent("-integer"))
                                     {
+#if NATIVE && NATIVE_UTILITY
+                                        if ((indexText == null) && !unique)
+                                        {
+                                            nativeSort = true;
+                                            nativeInteger = true;
+                                        }
+#endif
+
                                         comparer = new _Comparers.StringIntegerComparer(
                                             interpreter, ascending, indexText, false, unique,
                                             interpreter.InternalCultureInfo, ref duplicates);
@@ -176,6 +190,11 @@ namespace Eagle._Commands
                                     }
                                     else if (options.IsPresent("-ascii") || true) // FIXME: PRI 5: Default handling.
                                     {
+#if NATIVE && NATIVE_UTILITY
+                                        if ((indexText == null) && !unique)
+                                            nativeSort = true;
+#endif
+
                                         comparer = new _Comparers.StringAsciiComparer(
                                             interpreter, ascending, indexText, false, noCase,
                                             unique, interpreter.InternalCultureInfo, ref duplicates);
@@ -189,7 +208,51 @@ namespace Eagle._Commands
                                             {
                                                 if (comparer != null)
                                                 {
-                                                    list.Sort(comparer);
+                                                    bool sorted = false;
+
+#if NATIVE && NATIVE_UTILITY
+                                                    if (nativeSort)
+                                                    {
+                                                        //
+                                                        // NOTE: For a large list with no sub-list index, try
+                                                        //       to sort it via one native call.  Failing that,
+                                                        //       try to parse all the elements as wide integers
+                                                        //       up front, in one native call.  That only works
+                                                        //       when the list argument is still a string.
+                                                        //
+                                                        StringList sortedList = null;
+
+                                                        if (ParserOps<string>.TrySortList(
+                                                                interpreter, list, nativeInteger, ascending,
+                                                                noCase && !nativeInteger,
+                                                                interpreter.InternalCultureInfo,
+                                                                ref sortedList))
+                                                        {
+                                                            list = sortedList;
+                                                            sorted = true;
+                                                        }
+                                                        else if (nativeInteger)
+                                                        {
+                                                            string listText =
+                                                                arguments[argumentIndex].Value as string;
+
+                                                            if (listText != null)
+                                                            {
+                                                                /* IGNORED */
+                                                                ParserOps<string>.TryParseWideIntegers(
+                                                                    interpreter, listText, list.Count,
+                                                                    interpreter.InternalCultureInfo,
+                                                                    ref wideValues);
+                                                            }
+                                                        }
+                                                    }
+#endif
+
+                                                    if (!sorted && !ListOps.SortWideIntegers(
+                                                            list, wideValues, ascending))
+                                                    {
+                                                        list.Sort(comparer);
+                                                    }
                                                 }
                                                 else
                                                 {
@@ -1917,7 +1917,8 @@ namespace Eagle._Commands
                                                                         interpreter, mode,
                                                                         arguments[argumentIndex + 1], 0,
                                                                         list2, comparisonType, regExOptions,
-                                                                        maximum, subSpec, ref count);
+                                                                        maximum, subSpec, arguments[argumentIndex],
+                                                                        ref count);
                                                                 }
 
                                                                 if (countVarName != null)
@@ -264,6 +264,13 @@ namespace Eagle._Components.Private.Delegates
 
     #region Native Utility Integration Related Delegates
 #if NATIVE && NATIVE_UTILITY
+    //
+    // NOTE: The native SIZE_T type is the same size as a pointer; hence,
+    //       all the element counts, lengths, and indexes are marshalled
+    //       using IntPtr.  The native utility library version string is
+    //       checked (i.e. by NativeUtility.IsUsable) to make sure it was
+    //       built that way.
+    //
     [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
     [SuppressUnmanagedCodeSecurity()]
     [ObjectId("52ddb2fb-4b4b-4e2f-be2f-7a751aaf9f89")]
@@ -284,7 +291,7 @@ namespace Eagle._Components.Private.Delegates
     [SuppressUnmanagedCodeSecurity()]
     [ObjectId("ad5185f6-f1f1-4736-b1ec-2e7d9d329763")]
     internal delegate IntPtr Eagle_AllocateMemory(
-        int size
+        IntPtr size
     );
 
     ///////////////////////////////////////////////////////////////////////////
@@ -302,7 +309,7 @@ namespace Eagle._Components.Private.Delegates
     [SuppressUnmanagedCodeSecurity()]
     [ObjectId("8a107c25-71af-43c1-bd0a-40b458dabab2")]
     internal delegate void Eagle_FreeElements(
-        int elementCount,
+        IntPtr elementCount,
         IntPtr ppElements
     );
 
@@ -313,9 +320,9 @@ namespace Eagle._Components.Private.Delegates
     [SuppressUnmanagedCodeSecurity()]
     [ObjectId("4d0ffa2a-7968-48ee-b7a0-c6801120ea3f")]
     internal delegate ReturnCode Eagle_SplitList(
-        int length,
+        IntPtr length,
         string text,
-        ref int elementCount,
+        ref IntPtr elementCount,
         ref IntPtr pElementLengths,
         ref IntPtr ppElements,
         ref IntPtr pError
@@ -323,31 +330,314 @@ namespace Eagle._Components.Private.Delegates
 
     ///////////////////////////////////////////////////////////////////////////
 
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl,
+        CharSet = CharSet.Unicode)]
+    [SuppressUnmanagedCodeSecurity()]
+    [ObjectId("6b402773-752c-4508-8d1e-edd9659193f6")]
+    internal delegate ReturnCode Eagle_SplitListSpans(
+        IntPtr length,
+        string text,
+        ref IntPtr elementCount,
+        ref IntPtr pSpans,
+        ref IntPtr pUnescaped,
+        ref IntPtr pError
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    [SuppressUnmanagedCodeSecurity()]
+    [ObjectId("8a35678f-12b2-4f37-aa7a-462be7b8e5b2")]
+    internal delegate ReturnCode Eagle_SplitLists(
+        IntPtr listCount,
+        IntPtr[] lengths,
+        IntPtr[] texts,
+        ref IntPtr elementCount,
+        ref IntPtr pCounts,
+        ref IntPtr pText,
+        ref IntPtr pError
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl,
+        CharSet = CharSet.Unicode)]
+    [SuppressUnmanagedCodeSecurity()]
+    [ObjectId("544783e7-2029-4fc0-a524-a87ece3aef04")]
+    internal delegate ReturnCode Eagle_CountListElements(
+        IntPtr length,
+        string text,
+        ref IntPtr elementCount,
+        ref IntPtr pError
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl,
+        CharSet = CharSet.Unicode)]
+    [SuppressUnmanagedCodeSecurity()]
+    [ObjectId("c9d3063b-c4ed-4720-ac82-8364ebbfa22f")]
+    internal delegate ReturnCode Eagle_GetListElement(
+        IntPtr length,
+        string text,
+        IntPtr index,
+        ref IntPtr elementLength,
+        ref IntPtr pElement,
+        ref IntPtr pError
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl,
+        CharSet = CharSet.Unicode)]
+    [SuppressUnmanagedCodeSecurity()]
+    [ObjectId("1d5eae74-51d3-4740-aa46-df85456a65ba")]
+    internal delegate ReturnCode Eagle_GetListRange(
+        IntPtr length,
+        string text,
+        IntPtr firstIndex,
+        IntPtr lastIndex,
+        ref IntPtr resultLength,
+        ref IntPtr pResult,
+        ref IntPtr pError
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl,
+        CharSet = CharSet.Unicode)]
+    [SuppressUnmanagedCodeSecurity()]
+    [ObjectId("e3bc0593-04bc-43b3-891f-e90ce3a9a10b")]
+    internal delegate ReturnCode Eagle_ReplaceListRange(
+        IntPtr length,
+        string text,
+        IntPtr firstIndex,
+        IntPtr deleteCount,
+        IntPtr elementCount,
+        IntPtr[] elementLengths,
+#if NATIVE_UTILITY_BSTR
+        [MarshalAs(UnmanagedType.LPArray,
+            ArraySubType = UnmanagedType.BStr)]
+#endif
+        string[] elements,
+        ref IntPtr resultLength,
+        ref IntPtr pResult,
+        ref IntPtr pError
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    [SuppressUnmanagedCodeSecurity()]
+    [ObjectId("d957ef69-2e5a-48c0-a376-e4e1d6421b54")]
+    internal delegate ReturnCode Eagle_ListIterBegin(
+        IntPtr length,
+        IntPtr pText,
+        ref IntPtr pIterator,
+        ref IntPtr pError
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    [SuppressUnmanagedCodeSecurity()]
+    [ObjectId("1959ca61-5be4-41d6-b0af-e73be5e1f2b4")]
+    internal delegate ReturnCode Eagle_ListIterNext(
+        IntPtr pIterator,
+        IntPtr pSpan,
+        ref IntPtr pElement,
+        ref IntPtr pError
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    [SuppressUnmanagedCodeSecurity()]
+    [ObjectId("956cf21e-2d0e-43d6-93ee-4c1842feb081")]
+    internal delegate void Eagle_ListIterEnd(
+        IntPtr pIterator
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+
     [UnmanagedFunctionPointer(CallingConvention.Cdecl,
         CharSet = CharSet.Unicode)]
     [SuppressUnmanagedCodeSecurity()]
     [ObjectId("f3d46d80-6b00-44a9-b344-5216b03ac460")]
     internal delegate ReturnCode Eagle_JoinList(
-        int elementCount,
-        int[] elementLengths,
+        IntPtr elementCount,
+        IntPtr[] elementLengths,
+#if NATIVE_UTILITY_BSTR
+        [MarshalAs(UnmanagedType.LPArray,
+            ArraySubType = UnmanagedType.BStr)]
+#endif
+        string[] elements,
+        ref IntPtr length,
+        ref IntPtr pText,
+        ref IntPtr pError
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl,
+        CharSet = CharSet.Unicode)]
+    [SuppressUnmanagedCodeSecurity()]
+    [ObjectId("265d41d5-ab73-4c8e-83e1-ceb14ca9a088")]
+    internal delegate ReturnCode Eagle_JoinLists(
+        IntPtr listCount,
+        IntPtr[] elementCounts,
+        IntPtr[] elementLengths,
 #if NATIVE_UTILITY_BSTR
         [MarshalAs(UnmanagedType.LPArray,
             ArraySubType = UnmanagedType.BStr)]
 #endif
         string[] elements,
-        ref int length,
+        ref IntPtr pLengths,
+        ref IntPtr pText,
+        ref IntPtr pError
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl,
+        CharSet = CharSet.Unicode)]
+    [SuppressUnmanagedCodeSecurity()]
+    [ObjectId("2237468d-f925-4cb8-95b0-bb6fcab7c8e0")]
+    internal delegate ReturnCode Eagle_CompilePattern(
+        IntPtr length,
+        string pattern,
+        int flags,
+        ref IntPtr pPattern,
+        ref IntPtr pError
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl,
+        CharSet = CharSet.Unicode)]
+    [SuppressUnmanagedCodeSecurity()]
+    [ObjectId("1ead44cc-100a-4966-bcac-6430dbaf69a4")]
+    internal delegate ReturnCode Eagle_StringMatchMany(
+        IntPtr pPattern,
+        IntPtr elementCount,
+        IntPtr[] elementLengths,
+#if NATIVE_UTILITY_BSTR
+        [MarshalAs(UnmanagedType.LPArray,
+            ArraySubType = UnmanagedType.BStr)]
+#endif
+        string[] elements,
+        [Out] byte[] bitmap,
+        ref IntPtr matchCount,
+        ref IntPtr pError
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    [SuppressUnmanagedCodeSecurity()]
+    [ObjectId("e38f813c-6928-40ef-ab1d-8abe3c29f641")]
+    internal delegate void Eagle_FreePattern(
+        IntPtr pPattern
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl,
+        CharSet = CharSet.Unicode)]
+    [SuppressUnmanagedCodeSecurity()]
+    [ObjectId("8c3f5a2e-6d41-4b9c-a7e0-3f92d15b6c84")]
+    internal delegate ReturnCode Eagle_ParseScript(
+        IntPtr length,
+        string text,
+        int flags,
+        [In, Out] IntPtr[] state,
+        ref IntPtr tokenCount,
+        ref IntPtr pTokens,
+        ref IntPtr pError
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl,
+        CharSet = CharSet.Unicode)]
+    [SuppressUnmanagedCodeSecurity()]
+    [ObjectId("e41b9d63-2f7a-4c05-b8d2-6a1e03c9f57d")]
+    internal delegate ReturnCode Eagle_SubstBackslashes(
+        IntPtr length,
+        string text,
+        ref IntPtr resultLength,
         ref IntPtr pText,
         ref IntPtr pError
     );
 
     ///////////////////////////////////////////////////////////////////////////
 
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl,
+        CharSet = CharSet.Unicode)]
+    [SuppressUnmanagedCodeSecurity()]
+    [ObjectId("6f2d8a41-c3b7-4e95-9a0c-d71e5b28f436")]
+    internal delegate ReturnCode Eagle_ParseNumbers(
+        IntPtr length,
+        string text,
+        ref IntPtr elementCount,
+        ref IntPtr pValues,
+        ref IntPtr pError
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl,
+        CharSet = CharSet.Unicode)]
+    [SuppressUnmanagedCodeSecurity()]
+    [ObjectId("3c9e51a7-0b2d-4f86-8e4a-a7d6f1c02b95")]
+    internal delegate ReturnCode Eagle_SortList(
+        IntPtr elementCount,
+        IntPtr[] elementLengths,
+#if NATIVE_UTILITY_BSTR
+        [MarshalAs(UnmanagedType.LPArray,
+            ArraySubType = UnmanagedType.BStr)]
+#endif
+        string[] elements,
+        int flags,
+        ref IntPtr pIndexes,
+        ref IntPtr pError
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    [SuppressUnmanagedCodeSecurity()]
+    [ObjectId("5b0e7c2d-93a4-4f18-a6d1-c28e4f70b953")]
+    internal delegate ReturnCode Eagle_GetMemoryStatistics(
+        IntPtr size,
+        [In, Out] IntPtr[] statistics,
+        ref IntPtr pError
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+
     [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
     [SuppressUnmanagedCodeSecurity()]
     [ObjectId("1ec7e25c-1458-4f39-9271-495826c34689")]
     internal delegate IntPtr Eagle_SetMemoryHeap(
         IntPtr newHeap
     );
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    [SuppressUnmanagedCodeSecurity()]
+    [ObjectId("8c1f5a3e-2b74-4d09-9e6a-f3d2c7b8a615")]
+    internal delegate int Eagle_SetMemoryPool(
+        int privatePool
+    );
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    [SuppressUnmanagedCodeSecurity()]
+    [ObjectId("d4e92b07-6a1c-4f5e-8b3d-17c0a9e4f2b6")]
+    internal delegate IntPtr Eagle_CompactMemoryPool();
 #endif
     #endregion
 
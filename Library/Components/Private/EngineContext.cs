@@ -161,6 +161,7 @@ namespace Eagle._Components.Private
             previousProcessId = 0;
 
             arraySearches = new ArraySearchDictionary();
+            stringMapMatchers = new StringMapMatcherDictionary();
 
 #if HISTORY
             historyEngineFilter = null;
@@ -818,6 +819,15 @@ namespace Eagle._Components.Private
 
         ///////////////////////////////////////////////////////////////////////
 
+        private StringMapMatcherDictionary stringMapMatchers;
+        public StringMapMatcherDictionary StringMapMatchers
+        {
+            get { CheckDisposed(); return stringMapMatchers; }
+            set { CheckDisposed(); stringMapMatchers = value; }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
 #if HISTORY
         private IHistoryFilter historyEngineFilter;
         public IHistoryFilter HistoryEngineFilter
@@ -1100,6 +1110,14 @@ namespace Eagle._Components.Private
 
                     ///////////////////////////////////////////////////////////
 
+                    if (stringMapMatchers != null)
+                    {
+                        stringMapMatchers.Clear();
+                        stringMapMatchers = null;
+                    }
+
+                    ///////////////////////////////////////////////////////////
+
 #if HISTORY
                     historyEngineFilter = null;
 
@@ -346,6 +346,341 @@ namespace Eagle._Components.Private
 
         ///////////////////////////////////////////////////////////////////////////////////////////////
 
+        public static ReturnCode GetOrCopyOrSplitLists(
+            Interpreter interpreter,
+            IList<IGetValue> values,
+            bool readOnly,
+            ref StringList[] lists,
+            ref Result error
+            )
+        {
+            if (values == null)
+            {
+                error = "cannot split null values into lists";
+                return ReturnCode.Error;
+            }
+
+            int count = values.Count;
+            StringList[] localLists = new StringList[count];
+            StringList texts = null;
+            IntList indexes = null;
+
+            for (int index = 0; index < count; index++)
+            {
+                IGetValue getValue = values[index];
+
+                //
+                // NOTE: Values that are already collections are handled
+                //       one at a time.  All the others are gathered up so
+                //       they can be split together, which may be faster.
+                //
+                if (!IsStringValue(getValue))
+                {
+                    ReturnCode code = GetOrCopyOrSplitList(
+                        interpreter, getValue, readOnly,
+                        ref localLists[index], ref error);
+
+                    if (code != ReturnCode.Ok)
+                        return code;
+
+                    continue;
+                }
+
+                if (texts == null)
+                    texts = new StringList(count);
+
+                if (indexes == null)
+                    indexes = new IntList(count);
+
+                texts.Add(getValue.String);
+                indexes.Add(index);
+            }
+
+            if (texts != null)
+            {
+                StringList[] splitLists = null;
+
+                ReturnCode code = ParserOps<string>.SplitLists(
+                    interpreter, texts, readOnly, ref splitLists,
+                    ref error);
+
+                if (code != ReturnCode.Ok)
+                    return code;
+
+                /* IGNORED */
+                Interlocked.Add(ref splitListCount, texts.Count);
+
+                for (int index = 0; index < indexes.Count; index++)
+                    localLists[indexes[index]] = splitLists[index];
+            }
+
+            lists = localLists;
+            return ReturnCode.Ok;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+
+        private static bool IsStringValue(
+            IGetValue getValue
+            )
+        {
+            if (getValue == null)
+                return false;
+
+            //
+            // NOTE: When the value is already a collection, it will be
+            //       used directly by GetOrCopyOrSplitList; therefore,
+            //       treating it as a string here would only be slower.
+            //
+            if (Interlocked.CompareExchange(ref canGetOrCopyList, 0, 0) > 0)
+            {
+                object value = getValue.Value;
+
+                if ((value != null) && !(value is string) &&
+                    (value is IEnumerable))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+
+        private static StringList GetElements(
+            ArgumentList arguments,
+            int startIndex
+            )
+        {
+            if ((arguments == null) || (startIndex >= arguments.Count))
+                return null;
+
+            return new StringList(arguments, startIndex);
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+
+        public static bool TryGetListCount(
+            Interpreter interpreter,
+            IGetValue getValue,
+            ref int count
+            )
+        {
+            if (!IsStringValue(getValue))
+                return false;
+
+            return ParserOps<string>.TryCountList(
+                interpreter, getValue.String, ref count);
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+
+        public static bool TryGetListElement(
+            Interpreter interpreter,
+            IGetValue getValue,
+            string indexText,
+            CultureInfo cultureInfo,
+            ref string element
+            )
+        {
+            if (!IsStringValue(getValue))
+                return false;
+
+            //
+            // NOTE: The whole list is always scanned first, so that the
+            //       index may be relative to its end and so that a list
+            //       with improper structure is still reported as such,
+            //       no matter which element was requested.
+            //
+            string text = getValue.String;
+            int count = 0;
+
+            if (!ParserOps<string>.TryCountList(
+                    interpreter, text, ref count))
+            {
+                return false;
+            }
+
+            int index = Index.Invalid;
+            Result error = null;
+
+            if (Value.GetIndex(
+                    indexText, count, ValueFlags.AnyIndex, cultureInfo,
+                    ref index, ref error) != ReturnCode.Ok)
+            {
+                return false;
+            }
+
+            if ((index < 0) || (index >= count))
+            {
+                element = String.Empty;
+                return true;
+            }
+
+            return ParserOps<string>.TryGetListElement(
+                interpreter, text, index, ref element);
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+
+        public static bool TryGetListRange(
+            Interpreter interpreter,
+            IGetValue getValue,
+            string firstText,
+            string lastText,
+            CultureInfo cultureInfo,
+            ref string result
+            )
+        {
+            if (!IsStringValue(getValue))
+                return false;
+
+            string text = getValue.String;
+            int count = 0;
+
+            if (!ParserOps<string>.TryCountList(
+                    interpreter, text, ref count))
+            {
+                return false;
+            }
+
+            int firstIndex = Index.Invalid;
+            int lastIndex = Index.Invalid;
+            Result error = null;
+
+            if ((Value.GetIndex(
+                    firstText, count, ValueFlags.AnyIndex, cultureInfo,
+                    ref firstIndex, ref error) != ReturnCode.Ok) ||
+                (Value.GetIndex(
+                    lastText, count, ValueFlags.AnyIndex, cultureInfo,
+                    ref lastIndex, ref error) != ReturnCode.Ok))
+            {
+                return false;
+            }
+
+            if (firstIndex < 0)
+                firstIndex = 0;
+
+            if (lastIndex >= count)
+                lastIndex = count - 1;
+
+            if (firstIndex > lastIndex)
+            {
+                result = String.Empty;
+                return true;
+            }
+
+            return ParserOps<string>.TryGetListRange(
+                interpreter, text, firstIndex, lastIndex, ref result);
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+
+        public static bool TryReplaceListRange(
+            Interpreter interpreter,
+            IGetValue getValue,
+            string firstText,
+            string lastText,
+            ArgumentList arguments, /* OPTIONAL */
+            int startIndex,
+            CultureInfo cultureInfo,
+            ref string result
+            )
+        {
+            if (!IsStringValue(getValue))
+                return false;
+
+            string text = getValue.String;
+            int count = 0;
+
+            if (!ParserOps<string>.TryCountList(
+                    interpreter, text, ref count))
+            {
+                return false;
+            }
+
+            int firstIndex = Index.Invalid;
+            int lastIndex = Index.Invalid;
+            Result error = null;
+
+            if ((Value.GetIndex(
+                    firstText, count, ValueFlags.AnyIndex, cultureInfo,
+                    ref firstIndex, ref error) != ReturnCode.Ok) ||
+                (Value.GetIndex(
+                    lastText, count, ValueFlags.AnyIndex, cultureInfo,
+                    ref lastIndex, ref error) != ReturnCode.Ok))
+            {
+                return false;
+            }
+
+            if (firstIndex < 0)
+                firstIndex = 0;
+
+            //
+            // NOTE: An empty list or a first index beyond the end of the
+            //       list may be an error; let the caller handle it.
+            //
+            if (firstIndex >= count)
+                return false;
+
+            if (lastIndex >= count)
+                lastIndex = count - 1;
+
+            int deleteCount = (firstIndex <= lastIndex) ?
+                (lastIndex - firstIndex + 1) : 0;
+
+            return ParserOps<string>.TryReplaceListRange(
+                interpreter, text, firstIndex, deleteCount,
+                GetElements(arguments, startIndex), ref result);
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+
+        public static bool TryInsertList(
+            Interpreter interpreter,
+            IGetValue getValue,
+            string indexText,
+            ArgumentList arguments,
+            int startIndex,
+            CultureInfo cultureInfo,
+            ref string result
+            )
+        {
+            if (!IsStringValue(getValue))
+                return false;
+
+            string text = getValue.String;
+            int count = 0;
+
+            if (!ParserOps<string>.TryCountList(
+                    interpreter, text, ref count))
+            {
+                return false;
+            }
+
+            int index = Index.Invalid;
+            Result error = null;
+
+            if (Value.GetIndex(
+                    indexText, count, ValueFlags.AnyIndex, cultureInfo,
+                    ref index, ref error) != ReturnCode.Ok)
+            {
+                return false;
+            }
+
+            if (index < 0)
+                index = 0;
+            else if (index > count)
+                index = count;
+
+            return ParserOps<string>.TryReplaceListRange(
+                interpreter, text, index, 0,
+                GetElements(arguments, startIndex), ref result);
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+
         public static string Concat(params string[] strings)
         {
             return (strings != null) ? Concat(new StringList(strings)) : String.Empty;
@@ -782,6 +1117,77 @@ namespace Eagle._Components.Private
 
         ///////////////////////////////////////////////////////////////////////////////////////////////
 
+        [ObjectId("b0e4f7c9-2a56-4d13-8e6b-95c3d0a18f27")]
+        private sealed class WideIntegerComparer : IComparer<long>
+        {
+            #region Private Data
+            private bool ascending;
+            #endregion
+
+            ///////////////////////////////////////////////////////////////////////////////////////////
+
+            #region Public Constructors
+            public WideIntegerComparer(
+                bool ascending
+                )
+            {
+                this.ascending = ascending;
+            }
+            #endregion
+
+            ///////////////////////////////////////////////////////////////////////////////////////////
+
+            #region IComparer<long> Members
+            //
+            // NOTE: This must compare values exactly like the comparer used
+            //       by [lsort -integer] (i.e. StringIntegerComparer) does,
+            //       so that the resulting order is the same.
+            //
+            public int Compare(
+                long left,
+                long right
+                )
+            {
+                return ascending ?
+                    LogicOps.Compare(left, right) :
+                    LogicOps.Compare(right, left);
+            }
+            #endregion
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+
+        //
+        // NOTE: Sorts the list using the wide integer values that were
+        //       already parsed from its elements, one value per element,
+        //       instead of parsing the elements again for every comparison.
+        //       Both arrays are sorted together, using the same algorithm
+        //       as the List<T>.Sort method.
+        //
+        public static bool SortWideIntegers(
+            StringList list,
+            long[] values,
+            bool ascending
+            )
+        {
+            if ((list == null) || (values == null) ||
+                (values.Length != list.Count))
+            {
+                return false;
+            }
+
+            string[] elements = list.ToArray();
+
+            Array.Sort(values, elements, new WideIntegerComparer(ascending));
+
+            list.Clear();
+            list.AddRange(elements);
+
+            return true;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+
         public static bool ComparerEquals<T>(
             IComparer<T> comparer,
             T left,
@@ -0,0 +1,69 @@
+/*
+ * NativeListEnumerable.cs --
+ *
+ * Copyright (c) 2007-2012 by Joe Mistachkin.  All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution of
+ * this file, and for a DISCLAIMER OF ALL WARRANTIES.
+ *
+ * RCS: @(#) $Id: $
+ */
+
+using System.Collections;
+using System.Collections.Generic;
+using Eagle._Attributes;
+using Eagle._Components.Public;
+
+namespace Eagle._Components.Private
+{
+    //
+    // NOTE: This class allows the elements of a (very large) list to be
+    //       consumed via "foreach" without creating a StringList for the
+    //       whole list.  Each enumerator uses its own native iterator.
+    //
+    [ObjectId("83ef4436-a3ab-4dff-b519-dcc46c71e3fb")]
+    internal sealed class NativeListEnumerable : IEnumerable<string>
+    {
+        #region Private Data
+        private string text;
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////
+
+        #region Public Constructors
+        public NativeListEnumerable(
+            string text
+            )
+        {
+            this.text = text;
+        }
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////
+
+        #region IEnumerable<string> Members
+        public IEnumerator<string> GetEnumerator()
+        {
+            IEnumerator<string> enumerator = null;
+            Result error = null;
+
+            if (NativeUtility.GetListEnumerator(
+                    text, ref enumerator, ref error) != ReturnCode.Ok)
+            {
+                throw new ScriptException(ReturnCode.Error, error);
+            }
+
+            return enumerator;
+        }
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////
+
+        #region IEnumerable Members
+        IEnumerator IEnumerable.GetEnumerator()
+        {
+            return GetEnumerator();
+        }
+        #endregion
+    }
+}
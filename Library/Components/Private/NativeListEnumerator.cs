@@ -0,0 +1,285 @@
+/*
+ * NativeListEnumerator.cs --
+ *
+ * Copyright (c) 2007-2012 by Joe Mistachkin.  All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution of
+ * this file, and for a DISCLAIMER OF ALL WARRANTIES.
+ *
+ * RCS: @(#) $Id: $
+ */
+
+using System;
+using System.Collections;
+using System.Collections.Generic;
+using System.Runtime.InteropServices;
+using Eagle._Attributes;
+using Eagle._Components.Private.Delegates;
+using Eagle._Components.Public;
+
+namespace Eagle._Components.Private
+{
+    //
+    // NOTE: This class extracts the elements of a list one at a time, via
+    //       the native utility library, without ever splitting the whole
+    //       list.  Instances are created by NativeUtility only after the
+    //       native iterator has been successfully created.  The list text
+    //       stays pinned, and the native utility library cannot be unloaded,
+    //       until this object is disposed.
+    //
+    [ObjectId("ed2e2445-b719-4211-b3ea-e93a3ce3306a")]
+    internal sealed class NativeListEnumerator : IEnumerator<string>
+    {
+        #region Private Data
+        private string text;
+        private GCHandle textHandle;
+        private IntPtr pIterator;
+        private IntPtr pSpan;
+        private Eagle_FreeMemory freeMemory;
+        private Eagle_ListIterNext listIterNext;
+        private Eagle_ListIterEnd listIterEnd;
+        private string current;
+        private bool done;
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////
+
+        #region Public Constructors
+        public NativeListEnumerator(
+            string text,
+            GCHandle textHandle,
+            IntPtr pIterator,
+            IntPtr pSpan,
+            Eagle_FreeMemory freeMemory,
+            Eagle_ListIterNext listIterNext,
+            Eagle_ListIterEnd listIterEnd
+            )
+        {
+            this.text = text;
+            this.textHandle = textHandle;
+            this.pIterator = pIterator;
+            this.pSpan = pSpan;
+            this.freeMemory = freeMemory;
+            this.listIterNext = listIterNext;
+            this.listIterEnd = listIterEnd;
+        }
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////
+
+        #region IEnumerator<string> Members
+        public string Current
+        {
+            get
+            {
+                CheckDisposed();
+
+                if (current == null)
+                    throw new InvalidOperationException();
+
+                return current;
+            }
+        }
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////
+
+        #region IEnumerator Members
+        object IEnumerator.Current
+        {
+            get { CheckDisposed(); return ((IEnumerator<string>)this).Current; }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        public bool MoveNext()
+        {
+            CheckDisposed();
+
+            current = null;
+
+            if (done || (pIterator == IntPtr.Zero))
+                return false;
+
+            IntPtr pElement = IntPtr.Zero;
+            IntPtr pError = IntPtr.Zero;
+
+            try
+            {
+                ReturnCode code = listIterNext(
+                    pIterator, pSpan, ref pElement, ref pError);
+
+                if (code != ReturnCode.Ok)
+                {
+                    done = true;
+
+                    throw new ScriptException(
+                        code, Marshal.PtrToStringUni(pError));
+                }
+
+                if (pElement == IntPtr.Zero)
+                {
+                    done = true;
+                    return false;
+                }
+
+                long elementOffset = NativeUtility.ReadSizeT(
+                    pSpan, NativeUtility.elementSpanOffset);
+
+                long elementLength = NativeUtility.ReadSizeT(
+                    pSpan, NativeUtility.elementSpanLength);
+
+                if (!NativeUtility.IsValidSizeT(elementOffset) ||
+                    !NativeUtility.IsValidSizeT(elementLength))
+                {
+                    done = true;
+
+                    throw new ScriptException(String.Format(
+                        "bad list element span: {0}, {1}",
+                        elementOffset, elementLength));
+                }
+
+                if (elementLength == 0)
+                {
+                    current = String.Empty;
+                }
+                else if (NativeUtility.ReadSizeT(pSpan,
+                        NativeUtility.elementSpanNeedsUnescape) != 0)
+                {
+                    //
+                    // NOTE: This element contained backslash sequences;
+                    //       therefore, it was collapsed into the buffer
+                    //       owned by the native iterator.
+                    //
+                    current = Marshal.PtrToStringUni(
+                        pElement, (int)elementLength);
+                }
+                else
+                {
+                    //
+                    // NOTE: This element is used verbatim; build it
+                    //       straight from the original string.
+                    //
+                    if (elementOffset > (text.Length - elementLength))
+                    {
+                        done = true;
+
+                        throw new ScriptException(String.Format(
+                            "list element span out of range: {0}, {1}",
+                            elementOffset, elementLength));
+                    }
+
+                    current = text.Substring(
+                        (int)elementOffset, (int)elementLength);
+                }
+
+                return true;
+            }
+            finally
+            {
+                if (pError != IntPtr.Zero)
+                {
+                    freeMemory(pError);
+                    pError = IntPtr.Zero;
+                }
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        public void Reset()
+        {
+            CheckDisposed();
+
+            //
+            // NOTE: The native iterator only moves forward.  Callers that
+            //       need to start over should simply obtain a new one.
+            //
+            throw new NotSupportedException();
+        }
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////
+
+        #region IDisposable "Pattern" Members
+        private bool disposed;
+        private void CheckDisposed() /* throw */
+        {
+#if THROW_ON_DISPOSED
+            if (disposed && Engine.IsThrowOnDisposed(null, false))
+            {
+                throw new ObjectDisposedException(
+                    typeof(NativeListEnumerator).Name);
+            }
+#endif
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        private /* protected virtual */ void Dispose(
+            bool disposing
+            )
+        {
+            if (!disposed)
+            {
+                if (disposing)
+                {
+                    ////////////////////////////////////
+                    // dispose managed resources here...
+                    ////////////////////////////////////
+
+                    current = null;
+                    text = null;
+                }
+
+                //////////////////////////////////////
+                // release unmanaged resources here...
+                //////////////////////////////////////
+
+                if (pIterator != IntPtr.Zero)
+                {
+                    listIterEnd(pIterator);
+                    pIterator = IntPtr.Zero;
+                }
+
+                if (pSpan != IntPtr.Zero)
+                {
+                    Marshal.FreeHGlobal(pSpan);
+                    pSpan = IntPtr.Zero;
+                }
+
+                if (textHandle.IsAllocated)
+                    textHandle.Free();
+
+                //
+                // NOTE: This enumerator was counted as an active native
+                //       call when it was created; now, let the native
+                //       utility library be unloaded, if necessary.
+                //
+                NativeUtility.ExitNativeCall();
+
+                disposed = true;
+            }
+        }
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////
+
+        #region IDisposable Members
+        public void Dispose()
+        {
+            Dispose(true);
+            GC.SuppressFinalize(this);
+        }
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////
+
+        #region Destructor
+        ~NativeListEnumerator()
+        {
+            Dispose(false);
+        }
+        #endregion
+    }
+}
@@ -10,6 +10,7 @@
  */
 
 using System;
+using System.Collections.Generic;
 using System.IO;
 using System.Reflection;
 using System.Runtime.InteropServices;
@@ -36,9 +37,115 @@ namespace Eagle._Components.Private
         private const string optionDebug = " DEBUG";
         private const string optionRelease = " RELEASE";
         private const string optionSizeOfWcharT = " SIZE_OF_WCHAR_T=2";
+        private const string optionSizeOfSizeT = " SIZE_OF_SIZE_T=";
         private const string optionUse32BitSizeT = " USE_32BIT_SIZE_T=1";
         private const string optionUseSysStringLen = " USE_SYSSTRINGLEN=1";
         private const string optionUseHeapApi = " USE_HEAPAPI=1";
+        private const string optionUsePoolAllocator = " USE_POOL_ALLOCATOR=1";
+
+        ///////////////////////////////////////////////////////////////////////
+
+        //
+        // NOTE: This is the size, in bytes, of the native ELEMENT_SPAN
+        //       structure, which contains three SIZE_T fields.  Also,
+        //       these are the offsets of its fields.  The native SIZE_T
+        //       type is the same size as a pointer.
+        //
+        internal static readonly int elementSpanSize = 3 * IntPtr.Size;
+        internal static readonly int elementSpanOffset = 0;
+        internal static readonly int elementSpanLength = IntPtr.Size;
+        internal static readonly int elementSpanNeedsUnescape = 2 * IntPtr.Size;
+
+        ///////////////////////////////////////////////////////////////////////
+
+        //
+        // NOTE: These must match the native EAGLE_MATCH_* flags.
+        //
+        private const int matchNoCase = 0x1;
+        private const int matchStrictRange = 0x2;
+
+        ///////////////////////////////////////////////////////////////////////
+
+        //
+        // NOTE: These must match the native EAGLE_SORT_* flags.
+        //
+        private const int sortAscii = 0x0;
+        private const int sortInteger = 0x1;
+        private const int sortNoCase = 0x10;
+        private const int sortDecreasing = 0x20;
+
+        ///////////////////////////////////////////////////////////////////////
+
+        //
+        // NOTE: These must match the native EAGLE_PARSE_* flags.  The
+        //       substitution flags have the same values as the managed
+        //       SubstitutionFlags enumeration.
+        //
+        private const int parseSubstitutionMask = (int)SubstitutionFlags.All;
+        private const int parseNested = 0x100;
+
+        ///////////////////////////////////////////////////////////////////////
+
+        //
+        // NOTE: This is the size, in bytes, of the native SCRIPT_TOKEN
+        //       structure, which contains six SIZE_T fields.  Also, these
+        //       are the offsets of its fields.  The token types have the
+        //       same values as the managed TokenType enumeration.
+        //
+        private static readonly int scriptTokenSize = 6 * IntPtr.Size;
+        private static readonly int scriptTokenType = 0;
+        private static readonly int scriptTokenStart = IntPtr.Size;
+        private static readonly int scriptTokenLength = 2 * IntPtr.Size;
+        private static readonly int scriptTokenComponents = 3 * IntPtr.Size;
+        private static readonly int scriptTokenStartLine = 4 * IntPtr.Size;
+        private static readonly int scriptTokenEndLine = 5 * IntPtr.Size;
+
+        ///////////////////////////////////////////////////////////////////////
+
+        //
+        // NOTE: These must match the native SCRIPT_STATE structure, which
+        //       contains ten SIZE_T fields.  All line numbers are relative
+        //       to the start of the script.
+        //
+        private const int scriptStateCurrentLine = 0;
+        private const int scriptStateLineStart = 1;
+        private const int scriptStateCommentStart = 2;
+        private const int scriptStateCommentLength = 3;
+        private const int scriptStateCommandStart = 4;
+        private const int scriptStateCommandLength = 5;
+        private const int scriptStateCommandWords = 6;
+        private const int scriptStateTerminator = 7;
+        private const int scriptStateIncomplete = 8;
+        private const int scriptStateCommandCount = 9;
+        private const int scriptStateLength = 10;
+
+        ///////////////////////////////////////////////////////////////////////
+
+        //
+        // NOTE: These must match the native MEMORY_STATISTICS structure,
+        //       which contains four SIZE_T fields, followed by the number
+        //       of allocations for each call site, followed by the size
+        //       histogram for each call site.  The call site names are in
+        //       the same order as the native EAGLE_MEMORY_SITE_* values.
+        //
+        private const int memoryStatisticsCurrentBytes = 0;
+        private const int memoryStatisticsPeakBytes = 1;
+        private const int memoryStatisticsAllocationCount = 2;
+        private const int memoryStatisticsFreeCount = 3;
+        private const int memoryStatisticsSiteAllocations = 4;
+        private const int memoryStatisticsSites = 8;
+        private const int memoryStatisticsBuckets = 32;
+
+        private const int memoryStatisticsHistogram =
+            memoryStatisticsSiteAllocations + memoryStatisticsSites;
+
+        private const int memoryStatisticsLength = memoryStatisticsHistogram +
+            (memoryStatisticsSites * memoryStatisticsBuckets);
+
+        private static readonly string[] memoryStatisticsSiteNames = {
+            "Other", "Split", "Join", "Query", "Edit", "Printf", "Parse",
+            "Sort"
+        };
 
         ///////////////////////////////////////////////////////////////////////
 
@@ -50,14 +157,25 @@ namespace Eagle._Components.Private
 
         ///////////////////////////////////////////////////////////////////////
 
-#if WINDOWS
         //
-        // HACK: This is purposely not read-only.
+        // HACK: This is purposely not read-only.  This is the maximum number
+        //       of milliseconds to wait for active calls into the native
+        //       utility library to complete prior to unloading it.
+        //
+        private static int unloadWaitTimeout = 10000;
+
+        ///////////////////////////////////////////////////////////////////////
+
+        //
+        // HACK: This is purposely not read-only.  This is how many calls
+        //       into the native utility library are made between attempts
+        //       to compact its heap (or memory pool).
         //
         private static long compactEveryCount = 1000000;
 
         ///////////////////////////////////////////////////////////////////////
 
+#if WINDOWS
         //
         // HACK: These are purposely not read-only.
         //
@@ -85,6 +203,9 @@ namespace Eagle._Components.Private
         private static bool? nativeUseHeapApi = null;
 #endif
 
+        private static bool? nativeUsePoolAllocator = null;
+        private static bool nativePrivatePool = false;
+
         ///////////////////////////////////////////////////////////////////////
 
         private static Eagle_GetVersion nativeGetVersion;
@@ -93,20 +214,57 @@ namespace Eagle._Components.Private
         private static Eagle_FreeMemory nativeFreeMemory;
         private static Eagle_FreeElements nativeFreeElements;
         private static Eagle_SplitList nativeSplitList;
+        private static Eagle_SplitListSpans nativeSplitListSpans;
+        private static Eagle_SplitLists nativeSplitLists;
+        private static Eagle_CountListElements nativeCountListElements;
+        private static Eagle_GetListElement nativeGetListElement;
+        private static Eagle_GetListRange nativeGetListRange;
+        private static Eagle_ReplaceListRange nativeReplaceListRange;
+        private static Eagle_ListIterBegin nativeListIterBegin;
+        private static Eagle_ListIterNext nativeListIterNext;
+        private static Eagle_ListIterEnd nativeListIterEnd;
         private static Eagle_JoinList nativeJoinList;
+        private static Eagle_JoinLists nativeJoinLists;
+        private static Eagle_CompilePattern nativeCompilePattern;
+        private static Eagle_StringMatchMany nativeStringMatchMany;
+        private static Eagle_FreePattern nativeFreePattern;
+        private static Eagle_ParseScript nativeParseScript;
+        private static Eagle_SubstBackslashes nativeSubstBackslashes;
+        private static Eagle_ParseNumbers nativeParseNumbers;
+        private static Eagle_SortList nativeSortList;
+        private static Eagle_GetMemoryStatistics nativeGetMemoryStatistics;
         private static Eagle_SetMemoryHeap nativeSetMemoryHeap;
+        private static Eagle_SetMemoryPool nativeSetMemoryPool;
+        private static Eagle_CompactMemoryPool nativeCompactMemoryPool;
 
         ///////////////////////////////////////////////////////////////////////
 
         private static long splitCount;
         private static long joinCount;
+        private static long queryCount;
+        private static long editCount;
+        private static long matchCount;
+        private static long parseCount;
+        private static long substCount;
+        private static long numberCount;
+        private static long sortCount;
+
+        ///////////////////////////////////////////////////////////////////////
+
+        //
+        // NOTE: The native utility library is reentrant; therefore, calls
+        //       into it are not serialized.  Instead, these fields keep
+        //       track of how many calls are in progress and whether the
+        //       library is being unloaded, so that it cannot be unloaded
+        //       out from under an active call.
+        //
+        private static int activeCount;
+        private static int unloadingCount;
 
         ///////////////////////////////////////////////////////////////////////
 
-#if WINDOWS
         private static long maybeCompactCount;
         private static long compactCount;
-#endif
 
         ///////////////////////////////////////////////////////////////////////
 
@@ -117,6 +275,13 @@ namespace Eagle._Components.Private
         private static bool locked = false;
         private static bool disabled = false; /* INFORMATIONAL */
         private static bool? isAvailable = null;
+
+        //
+        // NOTE: This is non-zero when the native utility library is known
+        //       to be available.  It is used by TryIsAvailable to avoid the
+        //       lock when calling into the library.
+        //
+        private static int fastIsAvailable;
         private static string version = null;
 
         ///////////////////////////////////////////////////////////////////////
@@ -128,7 +293,7 @@ namespace Eagle._Components.Private
 
         //
         // NOTE: Permit native utility library to be loaded on operating
-        //       systems other than Windows?
+        //       systems other than Windows and Unix?
         //
         private static bool forceNonWindows = false;
 
@@ -150,10 +315,12 @@ namespace Eagle._Components.Private
         private static bool IsUsable(
             string version,
             bool debug,
-            out bool useHeapApi
+            out bool useHeapApi,
+            out bool usePoolAllocator
             )
         {
             useHeapApi = false;
+            usePoolAllocator = false;
 
             if (version == null)
             {
@@ -206,12 +373,39 @@ namespace Eagle._Components.Private
                 return false;
             }
 
-            if (version.IndexOf(optionUse32BitSizeT,
-                    optionComparisonType) == Index.Invalid)
+            //
+            // NOTE: All element counts, lengths, and indexes are marshalled
+            //       using IntPtr; therefore, the native SIZE_T type must be
+            //       the same size as a pointer.  Prior to the addition of
+            //       the SIZE_OF_SIZE_T option, the native SIZE_T type was
+            //       always a 32-bit integer, which is only usable from a
+            //       32-bit process.
+            //
+            string optionSizeOfPointer = String.Format(
+                "{0}{1}", optionSizeOfSizeT, IntPtr.Size);
+
+            if (version.IndexOf(optionSizeOfSizeT,
+                    optionComparisonType) != Index.Invalid)
+            {
+                if (version.IndexOf(optionSizeOfPointer,
+                        optionComparisonType) == Index.Invalid)
+                {
+                    TraceOps.DebugTrace(String.Format(
+                        "IsUsable: mismatched option {0}",
+                        FormatOps.WrapOrNull(optionSizeOfPointer)),
+                        typeof(NativeUtility).Name,
+                        TracePriority.NativeError);
+
+                    return false;
+                }
+            }
+            else if ((IntPtr.Size != sizeof(int)) ||
+                (version.IndexOf(optionUse32BitSizeT,
+                    optionComparisonType) == Index.Invalid))
             {
                 TraceOps.DebugTrace(String.Format(
                     "IsUsable: missing option {0}",
-                    FormatOps.WrapOrNull(optionUse32BitSizeT)),
+                    FormatOps.WrapOrNull(optionSizeOfPointer)),
                     typeof(NativeUtility).Name,
                     TracePriority.NativeError);
 
@@ -264,6 +458,18 @@ namespace Eagle._Components.Private
                     TracePriority.NativeWarning);
             }
 
+            if (version.IndexOf(optionUsePoolAllocator,
+                    optionComparisonType) != Index.Invalid)
+            {
+                TraceOps.DebugTrace(String.Format(
+                    "IsUsable: found option {0}",
+                    FormatOps.WrapOrNull(optionUsePoolAllocator)),
+                    typeof(NativeUtility).Name,
+                    TracePriority.NativeDebug);
+
+                usePoolAllocator = true;
+            }
+
             return true;
         }
 
@@ -275,11 +481,14 @@ namespace Eagle._Components.Private
             )
         {
             //
-            // HACK: For now, the native utility library is supported only
-            //       on Windows.
+            // NOTE: The native utility library uses two byte characters on
+            //       all platforms; therefore, it is supported on Windows and
+            //       Unix (e.g. Linux).  Its version string is checked later
+            //       (i.e. by IsUsable) to make sure it was built that way.
             //
             if (!forceNonWindows &&
-                !PlatformOps.IsWindowsOperatingSystem())
+                !PlatformOps.IsWindowsOperatingSystem() &&
+                !PlatformOps.IsUnixOperatingSystem())
             {
                 error = "not supported on this operating system";
                 return null;
@@ -380,7 +589,7 @@ namespace Eagle._Components.Private
         ///////////////////////////////////////////////////////////////////////
 
 #if !NATIVE_UTILITY_BSTR
-        private static int[] ToLengthArray(
+        private static IntPtr[] ToLengthArray(
             StringList list
             )
         {
@@ -388,7 +597,7 @@ namespace Eagle._Components.Private
                 return null;
 
             int count = list.Count;
-            int[] result = new int[count];
+            IntPtr[] result = new IntPtr[count];
 
             for (int index = 0; index < count; index++)
             {
@@ -397,7 +606,7 @@ namespace Eagle._Components.Private
                 if (element == null)
                     continue;
 
-                result[index] = element.Length;
+                result[index] = new IntPtr(element.Length);
             }
 
             return result;
@@ -406,6 +615,70 @@ namespace Eagle._Components.Private
 
         ///////////////////////////////////////////////////////////////////////
 
+        internal static IntPtr ReadIntPtr(
+            IntPtr pointer,
+            long offset
+            )
+        {
+            //
+            // NOTE: The offset may exceed the range of the overloads of
+            //       Marshal.ReadIntPtr that accept one; therefore, do the
+            //       pointer arithmetic here.
+            //
+            return Marshal.ReadIntPtr(new IntPtr(pointer.ToInt64() + offset));
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        internal static long ReadSizeT(
+            IntPtr pointer,
+            long offset
+            )
+        {
+            return ReadIntPtr(pointer, offset).ToInt64();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        internal static bool IsValidSizeT(
+            long value
+            )
+        {
+            //
+            // NOTE: Managed strings and arrays are indexed using a signed
+            //       32-bit integer; therefore, any larger element count or
+            //       length returned by the native code cannot be used.
+            //
+            return (value >= 0) && (value <= int.MaxValue);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        private static int ReadScriptState(
+            IntPtr[] state,
+            int index
+            )
+        {
+            long value = state[index].ToInt64();
+
+            //
+            // NOTE: The native EAGLE_PARSE_INVALID_INDEX value is the
+            //       largest SIZE_T, which becomes negative one here.
+            //
+            if (value == Index.Invalid)
+                return Index.Invalid;
+
+            if (!IsValidSizeT(value))
+            {
+                throw new ScriptException(String.Format(
+                    "bad script state field {0}: {1}", index, value));
+            }
+
+            return (int)value;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
         private static bool MaybeEnableReflection( /* NOT USED */
             bool? enable
             )
@@ -481,15 +754,55 @@ namespace Eagle._Components.Private
                 nativeDelegates.Add(typeof(Eagle_FreeMemory), null);
                 nativeDelegates.Add(typeof(Eagle_FreeElements), null);
                 nativeDelegates.Add(typeof(Eagle_SplitList), null);
+                nativeDelegates.Add(typeof(Eagle_SplitListSpans), null);
+                nativeDelegates.Add(typeof(Eagle_SplitLists), null);
+                nativeDelegates.Add(typeof(Eagle_CountListElements), null);
+                nativeDelegates.Add(typeof(Eagle_GetListElement), null);
+                nativeDelegates.Add(typeof(Eagle_GetListRange), null);
+                nativeDelegates.Add(typeof(Eagle_ReplaceListRange), null);
+                nativeDelegates.Add(typeof(Eagle_ListIterBegin), null);
+                nativeDelegates.Add(typeof(Eagle_ListIterNext), null);
+                nativeDelegates.Add(typeof(Eagle_ListIterEnd), null);
                 nativeDelegates.Add(typeof(Eagle_JoinList), null);
+                nativeDelegates.Add(typeof(Eagle_JoinLists), null);
+                nativeDelegates.Add(typeof(Eagle_CompilePattern), null);
+                nativeDelegates.Add(typeof(Eagle_StringMatchMany), null);
+                nativeDelegates.Add(typeof(Eagle_FreePattern), null);
+                nativeDelegates.Add(typeof(Eagle_ParseScript), null);
+                nativeDelegates.Add(typeof(Eagle_SubstBackslashes), null);
+                nativeDelegates.Add(typeof(Eagle_ParseNumbers), null);
+                nativeDelegates.Add(typeof(Eagle_SortList), null);
+                nativeDelegates.Add(typeof(Eagle_GetMemoryStatistics), null);
                 nativeDelegates.Add(typeof(Eagle_SetMemoryHeap), null);
+                nativeDelegates.Add(typeof(Eagle_SetMemoryPool), null);
+                nativeDelegates.Add(typeof(Eagle_CompactMemoryPool), null);
 
                 if (nativeOptional == null)
                     nativeOptional = new TypeBoolDictionary();
                 else if (clear)
                     nativeOptional.Clear();
 
+                nativeOptional.Add(typeof(Eagle_SplitListSpans), true);
+                nativeOptional.Add(typeof(Eagle_SplitLists), true);
+                nativeOptional.Add(typeof(Eagle_CountListElements), true);
+                nativeOptional.Add(typeof(Eagle_GetListElement), true);
+                nativeOptional.Add(typeof(Eagle_GetListRange), true);
+                nativeOptional.Add(typeof(Eagle_ReplaceListRange), true);
+                nativeOptional.Add(typeof(Eagle_ListIterBegin), true);
+                nativeOptional.Add(typeof(Eagle_ListIterNext), true);
+                nativeOptional.Add(typeof(Eagle_ListIterEnd), true);
+                nativeOptional.Add(typeof(Eagle_JoinLists), true);
+                nativeOptional.Add(typeof(Eagle_CompilePattern), true);
+                nativeOptional.Add(typeof(Eagle_StringMatchMany), true);
+                nativeOptional.Add(typeof(Eagle_FreePattern), true);
+                nativeOptional.Add(typeof(Eagle_ParseScript), true);
+                nativeOptional.Add(typeof(Eagle_SubstBackslashes), true);
+                nativeOptional.Add(typeof(Eagle_ParseNumbers), true);
+                nativeOptional.Add(typeof(Eagle_SortList), true);
+                nativeOptional.Add(typeof(Eagle_GetMemoryStatistics), true);
                 nativeOptional.Add(typeof(Eagle_SetMemoryHeap), true);
+                nativeOptional.Add(typeof(Eagle_SetMemoryPool), true);
+                nativeOptional.Add(typeof(Eagle_CompactMemoryPool), true);
             }
         }
 
@@ -505,8 +818,28 @@ namespace Eagle._Components.Private
                 nativeFreeMemory = null;
                 nativeFreeElements = null;
                 nativeSplitList = null;
+                nativeSplitListSpans = null;
+                nativeSplitLists = null;
+                nativeCountListElements = null;
+                nativeGetListElement = null;
+                nativeGetListRange = null;
+                nativeReplaceListRange = null;
+                nativeListIterBegin = null;
+                nativeListIterNext = null;
+                nativeListIterEnd = null;
                 nativeJoinList = null;
+                nativeJoinLists = null;
+                nativeCompilePattern = null;
+                nativeStringMatchMany = null;
+                nativeFreePattern = null;
+                nativeParseScript = null;
+                nativeSubstBackslashes = null;
+                nativeParseNumbers = null;
+                nativeSortList = null;
+                nativeGetMemoryStatistics = null;
                 nativeSetMemoryHeap = null;
+                nativeSetMemoryPool = null;
+                nativeCompactMemoryPool = null;
 
                 /* NO RESULT */
                 RuntimeOps.UnsetNativeDelegates(
@@ -547,12 +880,72 @@ namespace Eagle._Components.Private
                         nativeSplitList = (Eagle_SplitList)
                             nativeDelegates[typeof(Eagle_SplitList)];
 
+                        nativeSplitListSpans = (Eagle_SplitListSpans)
+                            nativeDelegates[typeof(Eagle_SplitListSpans)];
+
+                        nativeSplitLists = (Eagle_SplitLists)
+                            nativeDelegates[typeof(Eagle_SplitLists)];
+
+                        nativeCountListElements = (Eagle_CountListElements)
+                            nativeDelegates[typeof(Eagle_CountListElements)];
+
+                        nativeGetListElement = (Eagle_GetListElement)
+                            nativeDelegates[typeof(Eagle_GetListElement)];
+
+                        nativeGetListRange = (Eagle_GetListRange)
+                            nativeDelegates[typeof(Eagle_GetListRange)];
+
+                        nativeReplaceListRange = (Eagle_ReplaceListRange)
+                            nativeDelegates[typeof(Eagle_ReplaceListRange)];
+
+                        nativeListIterBegin = (Eagle_ListIterBegin)
+                            nativeDelegates[typeof(Eagle_ListIterBegin)];
+
+                        nativeListIterNext = (Eagle_ListIterNext)
+                            nativeDelegates[typeof(Eagle_ListIterNext)];
+
+                        nativeListIterEnd = (Eagle_ListIterEnd)
+                            nativeDelegates[typeof(Eagle_ListIterEnd)];
+
                         nativeJoinList = (Eagle_JoinList)
                             nativeDelegates[typeof(Eagle_JoinList)];
 
+                        nativeJoinLists = (Eagle_JoinLists)
+                            nativeDelegates[typeof(Eagle_JoinLists)];
+
+                        nativeCompilePattern = (Eagle_CompilePattern)
+                            nativeDelegates[typeof(Eagle_CompilePattern)];
+
+                        nativeStringMatchMany = (Eagle_StringMatchMany)
+                            nativeDelegates[typeof(Eagle_StringMatchMany)];
+
+                        nativeFreePattern = (Eagle_FreePattern)
+                            nativeDelegates[typeof(Eagle_FreePattern)];
+
+                        nativeParseScript = (Eagle_ParseScript)
+                            nativeDelegates[typeof(Eagle_ParseScript)];
+
+                        nativeSubstBackslashes = (Eagle_SubstBackslashes)
+                            nativeDelegates[typeof(Eagle_SubstBackslashes)];
+
+                        nativeParseNumbers = (Eagle_ParseNumbers)
+                            nativeDelegates[typeof(Eagle_ParseNumbers)];
+
+                        nativeSortList = (Eagle_SortList)
+                            nativeDelegates[typeof(Eagle_SortList)];
+
+                        nativeGetMemoryStatistics = (Eagle_GetMemoryStatistics)
+                            nativeDelegates[typeof(Eagle_GetMemoryStatistics)];
+
                         nativeSetMemoryHeap = (Eagle_SetMemoryHeap)
                             nativeDelegates[typeof(Eagle_SetMemoryHeap)];
 
+                        nativeSetMemoryPool = (Eagle_SetMemoryPool)
+                            nativeDelegates[typeof(Eagle_SetMemoryPool)];
+
+                        nativeCompactMemoryPool = (Eagle_CompactMemoryPool)
+                            nativeDelegates[typeof(Eagle_CompactMemoryPool)];
+
                         return true;
                     }
                     catch (Exception e)
@@ -743,146 +1136,330 @@ namespace Eagle._Components.Private
             }
         }
 
+#endif
+
         ///////////////////////////////////////////////////////////////////////
 
-        private static bool MaybeInitializeNativeHeap()
+        private static bool InitializeNativePool(
+            ref Result error
+            )
         {
             lock (syncRoot) /* TRANSACTIONAL */
             {
-                if ((nativeUseHeapApi == null) || !(bool)nativeUseHeapApi)
+                if (nativePrivatePool)
                     return true;
 
-                /* NO RESULT */
-                AddExitedEventHandler();
-
-                Result error = null;
-
-                if (!InitializeNativeHeap(ref error))
+                if (nativeSetMemoryPool != null)
                 {
-                    TraceOps.DebugTrace(String.Format(
-                        "MaybeInitializeNativeHeap: native heap error: {0}",
-                        FormatOps.WrapOrNull(error)),
-                        typeof(NativeUtility).Name,
-                        TracePriority.NativeError);
+                    try
+                    {
+                        /* IGNORED */
+                        nativeSetMemoryPool(1);
 
-                    return false;
+                        nativePrivatePool = true;
+                        return true;
+                    }
+                    catch (Exception e)
+                    {
+                        error = e;
+                    }
+                }
+                else
+                {
+                    error = String.Format(
+                        "one or more required functions are unavailable: " +
+                        "{0}", typeof(Eagle_SetMemoryPool).Name);
                 }
 
-                return true;
+                return false;
             }
         }
 
         ///////////////////////////////////////////////////////////////////////
 
-        private static bool MaybeCompactNativeHeap()
+        private static bool CompactNativePool(
+            ref Result error
+            )
         {
             lock (syncRoot) /* TRANSACTIONAL */
             {
-                if ((nativeUseHeapApi == null) || !(bool)nativeUseHeapApi)
+                if (!nativePrivatePool)
                     return true;
 
-                if ((Interlocked.Increment(
-                        ref maybeCompactCount) % compactEveryCount) != 0)
+                if (nativeCompactMemoryPool != null)
                 {
-                    return true;
-                }
+                    try
+                    {
+                        long size = nativeCompactMemoryPool().ToInt64();
 
-                Result error = null;
+                        Interlocked.Increment(ref compactCount);
 
-                if (!CompactNativeHeap(ref error))
-                {
-                    TraceOps.DebugTrace(String.Format(
-                        "MaybeCompactNativeHeap: native heap error: {0}",
-                        FormatOps.WrapOrNull(error)),
-                        typeof(NativeUtility).Name,
-                        TracePriority.NativeError);
+                        TraceOps.DebugTrace(String.Format(
+                            "CompactNativePool: freed {0} bytes", size),
+                            typeof(NativeUtility).Name,
+                            TracePriority.NativeDebug);
 
-                    return false;
+                        return true;
+                    }
+                    catch (Exception e)
+                    {
+                        error = e;
+                    }
+                }
+                else
+                {
+                    error = String.Format(
+                        "one or more required functions are unavailable: " +
+                        "{0}", typeof(Eagle_CompactMemoryPool).Name);
                 }
 
-                return true;
+                return false;
             }
         }
 
         ///////////////////////////////////////////////////////////////////////
 
-        private static bool MaybeFinalizeNativeHeap()
+        private static bool FinalizeNativePool(
+            ref Result error
+            )
         {
             lock (syncRoot) /* TRANSACTIONAL */
             {
-                if ((nativeUseHeapApi == null) || !(bool)nativeUseHeapApi)
+                if (!nativePrivatePool)
                     return true;
 
-                Result error = null;
-
-                if (!FinalizeNativeHeap(ref error))
+                if (nativeSetMemoryPool != null)
                 {
-                    TraceOps.DebugTrace(String.Format(
-                        "MaybeFinalizeNativeHeap: native heap error: {0}",
-                        FormatOps.WrapOrNull(error)),
-                        typeof(NativeUtility).Name,
-                        TracePriority.NativeError);
+                    try
+                    {
+                        /* IGNORED */
+                        nativeSetMemoryPool(0);
 
-                    return false;
+                        nativePrivatePool = false;
+                        return true;
+                    }
+                    catch (Exception e)
+                    {
+                        error = e;
+                    }
+                }
+                else
+                {
+                    error = String.Format(
+                        "one or more required functions are unavailable: " +
+                        "{0}", typeof(Eagle_SetMemoryPool).Name);
                 }
 
-                /* NO RESULT */
-                RemoveExitedEventHandler();
-
-                return true;
+                return false;
             }
         }
-#endif
 
         ///////////////////////////////////////////////////////////////////////
 
-        private static bool LoadNativeLibrary(
-            Interpreter interpreter
-            )
+        private static bool MaybeInitializeNativeHeap()
         {
             lock (syncRoot) /* TRANSACTIONAL */
             {
-                if (nativeModule != IntPtr.Zero)
-                    return true;
-
-                try
+#if WINDOWS
+                if ((nativeUseHeapApi != null) && (bool)nativeUseHeapApi)
                 {
-                    Result error; /* REUSED */
-                    string fileName;
-
-                    error = null;
+                    /* NO RESULT */
+                    AddExitedEventHandler();
 
-                    fileName = GetNativeLibraryFileName(
-                        interpreter, ref error);
+                    Result error = null;
 
-                    if (!String.IsNullOrEmpty(fileName))
-                    {
-                        TraceOps.DebugTrace(String.Format(
-                            "LoadNativeLibrary: using file name {0}",
-                            FormatOps.WrapOrNull(fileName)),
-                            typeof(NativeUtility).Name,
-                            TracePriority.NativeDebug2);
-                    }
-                    else
+                    if (!InitializeNativeHeap(ref error))
                     {
-                        if (error == null)
-                        {
-                            error = String.Format(
-                                "file name {0} is invalid",
-                                FormatOps.WrapOrNull(fileName));
-                        }
-
                         TraceOps.DebugTrace(String.Format(
-                            "LoadNativeLibrary: {0}",
+                            "MaybeInitializeNativeHeap: native heap error: {0}",
                             FormatOps.WrapOrNull(error)),
                             typeof(NativeUtility).Name,
                             TracePriority.NativeError);
 
                         return false;
                     }
+                }
+#endif
 
-                    //
-                    // NOTE: Check if the native library file name actually
+                //
+                // NOTE: When the pooled memory allocator is used instead of
+                //       the Win32 API, place its shared pool into private
+                //       mode, so memory is only released upon compaction.
+                //
+                if ((nativeUsePoolAllocator != null) &&
+                    (bool)nativeUsePoolAllocator)
+                {
+                    Result error = null;
+
+                    if (!InitializeNativePool(ref error))
+                    {
+                        TraceOps.DebugTrace(String.Format(
+                            "MaybeInitializeNativeHeap: native pool error: {0}",
+                            FormatOps.WrapOrNull(error)),
+                            typeof(NativeUtility).Name,
+                            TracePriority.NativeError);
+
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        private static bool MaybeCompactNativeHeap()
+        {
+            //
+            // NOTE: This is called after every call into the native utility
+            //       library; therefore, avoid taking the lock unless heap
+            //       compaction is actually due.
+            //
+            if ((Interlocked.Increment(
+                    ref maybeCompactCount) % compactEveryCount) != 0)
+            {
+                return true;
+            }
+
+            lock (syncRoot) /* TRANSACTIONAL */
+            {
+#if WINDOWS
+                if ((nativeUseHeapApi != null) && (bool)nativeUseHeapApi)
+                {
+                    Result error = null;
+
+                    if (!CompactNativeHeap(ref error))
+                    {
+                        TraceOps.DebugTrace(String.Format(
+                            "MaybeCompactNativeHeap: native heap error: {0}",
+                            FormatOps.WrapOrNull(error)),
+                            typeof(NativeUtility).Name,
+                            TracePriority.NativeError);
+
+                        return false;
+                    }
+                }
+#endif
+
+                if ((nativeUsePoolAllocator != null) &&
+                    (bool)nativeUsePoolAllocator)
+                {
+                    Result error = null;
+
+                    if (!CompactNativePool(ref error))
+                    {
+                        TraceOps.DebugTrace(String.Format(
+                            "MaybeCompactNativeHeap: native pool error: {0}",
+                            FormatOps.WrapOrNull(error)),
+                            typeof(NativeUtility).Name,
+                            TracePriority.NativeError);
+
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        private static bool MaybeFinalizeNativeHeap()
+        {
+            lock (syncRoot) /* TRANSACTIONAL */
+            {
+#if WINDOWS
+                if ((nativeUseHeapApi != null) && (bool)nativeUseHeapApi)
+                {
+                    Result error = null;
+
+                    if (!FinalizeNativeHeap(ref error))
+                    {
+                        TraceOps.DebugTrace(String.Format(
+                            "MaybeFinalizeNativeHeap: native heap error: {0}",
+                            FormatOps.WrapOrNull(error)),
+                            typeof(NativeUtility).Name,
+                            TracePriority.NativeError);
+
+                        return false;
+                    }
+
+                    /* NO RESULT */
+                    RemoveExitedEventHandler();
+                }
+#endif
+
+                if ((nativeUsePoolAllocator != null) &&
+                    (bool)nativeUsePoolAllocator)
+                {
+                    Result error = null;
+
+                    if (!FinalizeNativePool(ref error))
+                    {
+                        TraceOps.DebugTrace(String.Format(
+                            "MaybeFinalizeNativeHeap: native pool error: {0}",
+                            FormatOps.WrapOrNull(error)),
+                            typeof(NativeUtility).Name,
+                            TracePriority.NativeError);
+
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        private static bool LoadNativeLibrary(
+            Interpreter interpreter
+            )
+        {
+            lock (syncRoot) /* TRANSACTIONAL */
+            {
+                if (nativeModule != IntPtr.Zero)
+                    return true;
+
+                try
+                {
+                    Result error; /* REUSED */
+                    string fileName;
+
+                    error = null;
+
+                    fileName = GetNativeLibraryFileName(
+                        interpreter, ref error);
+
+                    if (!String.IsNullOrEmpty(fileName))
+                    {
+                        TraceOps.DebugTrace(String.Format(
+                            "LoadNativeLibrary: using file name {0}",
+                            FormatOps.WrapOrNull(fileName)),
+                            typeof(NativeUtility).Name,
+                            TracePriority.NativeDebug2);
+                    }
+                    else
+                    {
+                        if (error == null)
+                        {
+                            error = String.Format(
+                                "file name {0} is invalid",
+                                FormatOps.WrapOrNull(fileName));
+                        }
+
+                        TraceOps.DebugTrace(String.Format(
+                            "LoadNativeLibrary: {0}",
+                            FormatOps.WrapOrNull(error)),
+                            typeof(NativeUtility).Name,
+                            TracePriority.NativeError);
+
+                        return false;
+                    }
+
+                    //
+                    // NOTE: Check if the native library file name actually
                     //       exists.  If not, do nothing and return failure
                     //       after tracing the issue.
                     //
@@ -990,12 +1567,39 @@ namespace Eagle._Components.Private
                 if (nativeModule == IntPtr.Zero)
                     return true;
 
-                try
+                Interlocked.Exchange(ref fastIsAvailable, 0);
+                Interlocked.Increment(ref unloadingCount);
+            }
+
+            try
+            {
+                //
+                // BUGFIX: *DEADLOCK* The lock must not be held while waiting
+                //         for the active calls to complete, because they may
+                //         need it before they can complete (e.g. to compact
+                //         the native heap).  No new calls can start now that
+                //         the unloading count is non-zero.
+                //
+                if (!WaitForNativeCalls(unloadWaitTimeout))
                 {
-#if WINDOWS
+                    TraceOps.DebugTrace(String.Format(
+                        "UnloadNativeLibrary: timed out after {0} " +
+                        "milliseconds waiting for {1} active calls",
+                        unloadWaitTimeout, Interlocked.CompareExchange(
+                        ref activeCount, 0, 0)),
+                        typeof(NativeUtility).Name,
+                        TracePriority.NativeError);
+
+                    return false;
+                }
+
+                lock (syncRoot) /* TRANSACTIONAL */
+                {
+                    if (nativeModule == IntPtr.Zero)
+                        return true;
+
                     if (!MaybeFinalizeNativeHeap())
                         return false;
-#endif
 
                     /* NO RESULT */
                     UnsetNativeDelegates();
@@ -1032,15 +1636,70 @@ namespace Eagle._Components.Private
                             TracePriority.NativeError);
                     }
                 }
-                catch (Exception e)
-                {
-                    TraceOps.DebugTrace(
-                        e, typeof(NativeUtility).Name,
-                        TracePriority.NativeError);
-                }
+            }
+            catch (Exception e)
+            {
+                TraceOps.DebugTrace(
+                    e, typeof(NativeUtility).Name,
+                    TracePriority.NativeError);
+            }
+            finally
+            {
+                Interlocked.Decrement(ref unloadingCount);
+            }
 
-                return false;
+            return false;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        internal static bool EnterNativeCall()
+        {
+            //
+            // NOTE: The active count must be incremented before checking
+            //       for an unload in progress.  Both operations are full
+            //       fences; therefore, either the unloader will see this
+            //       call as active -OR- this call will see the unloader.
+            //
+            Interlocked.Increment(ref activeCount);
+
+            if (Interlocked.CompareExchange(ref unloadingCount, 0, 0) == 0)
+                return true;
+
+            Interlocked.Decrement(ref activeCount);
+            return false;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        internal static void ExitNativeCall()
+        {
+            Interlocked.Decrement(ref activeCount);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        private static bool WaitForNativeCalls(
+            int timeout
+            )
+        {
+            //
+            // NOTE: Each sleep may take much longer than one millisecond;
+            //       therefore, measure the elapsed time instead of simply
+            //       counting the iterations.  The subtraction is unchecked
+            //       so that it still works when the tick count wraps.
+            //
+            int start = Environment.TickCount;
+
+            while (Interlocked.CompareExchange(ref activeCount, 0, 0) > 0)
+            {
+                if (unchecked(Environment.TickCount - start) >= timeout)
+                    return false;
+
+                Thread.Sleep(1); /* throw */
             }
+
+            return true;
         }
         #endregion
 
@@ -1103,6 +1762,13 @@ namespace Eagle._Components.Private
                             nativeUseHeapApi.ToString() : FormatOps.DisplayNull);
 #endif
 
+                    if (empty || (nativeUsePoolAllocator != null))
+                        localList.Add("NativeUsePoolAllocator", (nativeUsePoolAllocator != null) ?
+                            nativeUsePoolAllocator.ToString() : FormatOps.DisplayNull);
+
+                    if (empty || nativePrivatePool)
+                        localList.Add("NativePrivatePool", nativePrivatePool.ToString());
+
                     if (empty || (nativeModule != IntPtr.Zero))
                         localList.Add("NativeModule", nativeModule.ToString());
 
@@ -1153,14 +1819,94 @@ namespace Eagle._Components.Private
                         localList.Add("NativeSplitList", (nativeSplitList != null) ?
                             nativeSplitList.ToString() : FormatOps.DisplayNull);
 
+                    if (empty || (nativeSplitListSpans != null))
+                        localList.Add("NativeSplitListSpans", (nativeSplitListSpans != null) ?
+                            nativeSplitListSpans.ToString() : FormatOps.DisplayNull);
+
+                    if (empty || (nativeSplitLists != null))
+                        localList.Add("NativeSplitLists", (nativeSplitLists != null) ?
+                            nativeSplitLists.ToString() : FormatOps.DisplayNull);
+
+                    if (empty || (nativeCountListElements != null))
+                        localList.Add("NativeCountListElements", (nativeCountListElements != null) ?
+                            nativeCountListElements.ToString() : FormatOps.DisplayNull);
+
+                    if (empty || (nativeGetListElement != null))
+                        localList.Add("NativeGetListElement", (nativeGetListElement != null) ?
+                            nativeGetListElement.ToString() : FormatOps.DisplayNull);
+
+                    if (empty || (nativeGetListRange != null))
+                        localList.Add("NativeGetListRange", (nativeGetListRange != null) ?
+                            nativeGetListRange.ToString() : FormatOps.DisplayNull);
+
+                    if (empty || (nativeReplaceListRange != null))
+                        localList.Add("NativeReplaceListRange", (nativeReplaceListRange != null) ?
+                            nativeReplaceListRange.ToString() : FormatOps.DisplayNull);
+
+                    if (empty || (nativeListIterBegin != null))
+                        localList.Add("NativeListIterBegin", (nativeListIterBegin != null) ?
+                            nativeListIterBegin.ToString() : FormatOps.DisplayNull);
+
+                    if (empty || (nativeListIterNext != null))
+                        localList.Add("NativeListIterNext", (nativeListIterNext != null) ?
+                            nativeListIterNext.ToString() : FormatOps.DisplayNull);
+
+                    if (empty || (nativeListIterEnd != null))
+                        localList.Add("NativeListIterEnd", (nativeListIterEnd != null) ?
+                            nativeListIterEnd.ToString() : FormatOps.DisplayNull);
+
                     if (empty || (nativeJoinList != null))
                         localList.Add("NativeJoinList", (nativeJoinList != null) ?
                             nativeJoinList.ToString() : FormatOps.DisplayNull);
 
+                    if (empty || (nativeJoinLists != null))
+                        localList.Add("NativeJoinLists", (nativeJoinLists != null) ?
+                            nativeJoinLists.ToString() : FormatOps.DisplayNull);
+
+                    if (empty || (nativeCompilePattern != null))
+                        localList.Add("NativeCompilePattern", (nativeCompilePattern != null) ?
+                            nativeCompilePattern.ToString() : FormatOps.DisplayNull);
+
+                    if (empty || (nativeStringMatchMany != null))
+                        localList.Add("NativeStringMatchMany", (nativeStringMatchMany != null) ?
+                            nativeStringMatchMany.ToString() : FormatOps.DisplayNull);
+
+                    if (empty || (nativeFreePattern != null))
+                        localList.Add("NativeFreePattern", (nativeFreePattern != null) ?
+                            nativeFreePattern.ToString() : FormatOps.DisplayNull);
+
+                    if (empty || (nativeParseScript != null))
+                        localList.Add("NativeParseScript", (nativeParseScript != null) ?
+                            nativeParseScript.ToString() : FormatOps.DisplayNull);
+
+                    if (empty || (nativeSubstBackslashes != null))
+                        localList.Add("NativeSubstBackslashes", (nativeSubstBackslashes != null) ?
+                            nativeSubstBackslashes.ToString() : FormatOps.DisplayNull);
+
+                    if (empty || (nativeParseNumbers != null))
+                        localList.Add("NativeParseNumbers", (nativeParseNumbers != null) ?
+                            nativeParseNumbers.ToString() : FormatOps.DisplayNull);
+
+                    if (empty || (nativeSortList != null))
+                        localList.Add("NativeSortList", (nativeSortList != null) ?
+                            nativeSortList.ToString() : FormatOps.DisplayNull);
+
+                    if (empty || (nativeGetMemoryStatistics != null))
+                        localList.Add("NativeGetMemoryStatistics", (nativeGetMemoryStatistics != null) ?
+                            nativeGetMemoryStatistics.ToString() : FormatOps.DisplayNull);
+
                     if (empty || (nativeSetMemoryHeap != null))
                         localList.Add("NativeSetMemoryHeap", (nativeSetMemoryHeap != null) ?
                             nativeSetMemoryHeap.ToString() : FormatOps.DisplayNull);
 
+                    if (empty || (nativeSetMemoryPool != null))
+                        localList.Add("NativeSetMemoryPool", (nativeSetMemoryPool != null) ?
+                            nativeSetMemoryPool.ToString() : FormatOps.DisplayNull);
+
+                    if (empty || (nativeCompactMemoryPool != null))
+                        localList.Add("NativeCompactMemoryPool", (nativeCompactMemoryPool != null) ?
+                            nativeCompactMemoryPool.ToString() : FormatOps.DisplayNull);
+
                     if (empty || (version != null))
                         localList.Add("Version", (version != null) ?
                             version : FormatOps.DisplayNull);
@@ -1171,35 +1917,135 @@ namespace Eagle._Components.Private
                         localList.Add("GetVersion", (localVersion != null) ?
                             localVersion : FormatOps.DisplayNull);
 
-                    if (empty || (itemsFieldInfo != null))
-                        localList.Add("ItemsFieldInfo", (itemsFieldInfo != null) ?
-                            itemsFieldInfo.ToString() : FormatOps.DisplayNull);
+                    long[] statistics = GetMemoryStatistics();
 
-                    long localSplitCount = Interlocked.CompareExchange(
-                        ref splitCount, 0, 0);
+                    if (statistics != null)
+                    {
+                        localList.Add("MemoryCurrentBytes",
+                            statistics[memoryStatisticsCurrentBytes].ToString());
 
-                    if (empty || (localSplitCount > 0))
-                        localList.Add("SplitCount", localSplitCount.ToString());
+                        localList.Add("MemoryPeakBytes",
+                            statistics[memoryStatisticsPeakBytes].ToString());
 
-                    long localJoinCount = Interlocked.CompareExchange(
-                        ref joinCount, 0, 0);
+                        localList.Add("MemoryAllocationCount",
+                            statistics[memoryStatisticsAllocationCount].ToString());
 
-                    if (empty || (localJoinCount > 0))
-                        localList.Add("JoinCount", localJoinCount.ToString());
+                        localList.Add("MemoryFreeCount",
+                            statistics[memoryStatisticsFreeCount].ToString());
 
-#if WINDOWS
-                    long localCompactCount = Interlocked.CompareExchange(
-                        ref compactCount, 0, 0);
+                        for (int site = 0; site < memoryStatisticsSites; site++)
+                        {
+                            long siteAllocations = statistics[
+                                memoryStatisticsSiteAllocations + site];
 
-                    if (empty || (localCompactCount > 0))
-                        localList.Add("CompactCount", localCompactCount.ToString());
+                            if (!empty && (siteAllocations == 0))
+                                continue;
+
+                            string siteName = memoryStatisticsSiteNames[site];
+
+                            localList.Add(String.Format(
+                                "Memory{0}AllocationCount", siteName),
+                                siteAllocations.ToString());
+
+                            //
+                            // NOTE: The histogram is formatted as a list of
+                            //       pairs, containing the largest size for
+                            //       each non-empty bucket and its count.
+                            //
+                            StringList histogram = new StringList();
+                            int offset = memoryStatisticsHistogram +
+                                (site * memoryStatisticsBuckets);
+
+                            for (int bucket = 0;
+                                    bucket < memoryStatisticsBuckets;
+                                    bucket++)
+                            {
+                                long count = statistics[offset + bucket];
+
+                                if (count == 0)
+                                    continue;
+
+                                histogram.Add(
+                                    (1L << bucket).ToString());
+
+                                histogram.Add(count.ToString());
+                            }
+
+                            localList.Add(String.Format(
+                                "Memory{0}Histogram", siteName),
+                                histogram.ToString());
+                        }
+                    }
+
+                    if (empty || (itemsFieldInfo != null))
+                        localList.Add("ItemsFieldInfo", (itemsFieldInfo != null) ?
+                            itemsFieldInfo.ToString() : FormatOps.DisplayNull);
+
+                    long localSplitCount = Interlocked.CompareExchange(
+                        ref splitCount, 0, 0);
+
+                    if (empty || (localSplitCount > 0))
+                        localList.Add("SplitCount", localSplitCount.ToString());
+
+                    long localJoinCount = Interlocked.CompareExchange(
+                        ref joinCount, 0, 0);
+
+                    if (empty || (localJoinCount > 0))
+                        localList.Add("JoinCount", localJoinCount.ToString());
+
+                    long localQueryCount = Interlocked.CompareExchange(
+                        ref queryCount, 0, 0);
+
+                    if (empty || (localQueryCount > 0))
+                        localList.Add("QueryCount", localQueryCount.ToString());
+
+                    long localEditCount = Interlocked.CompareExchange(
+                        ref editCount, 0, 0);
+
+                    if (empty || (localEditCount > 0))
+                        localList.Add("EditCount", localEditCount.ToString());
+
+                    long localMatchCount = Interlocked.CompareExchange(
+                        ref matchCount, 0, 0);
+
+                    if (empty || (localMatchCount > 0))
+                        localList.Add("MatchCount", localMatchCount.ToString());
+
+                    long localParseCount = Interlocked.CompareExchange(
+                        ref parseCount, 0, 0);
+
+                    if (empty || (localParseCount > 0))
+                        localList.Add("ParseCount", localParseCount.ToString());
+
+                    long localSubstCount = Interlocked.CompareExchange(
+                        ref substCount, 0, 0);
+
+                    if (empty || (localSubstCount > 0))
+                        localList.Add("SubstCount", localSubstCount.ToString());
+
+                    long localNumberCount = Interlocked.CompareExchange(
+                        ref numberCount, 0, 0);
+
+                    if (empty || (localNumberCount > 0))
+                        localList.Add("NumberCount", localNumberCount.ToString());
+
+                    long localSortCount = Interlocked.CompareExchange(
+                        ref sortCount, 0, 0);
+
+                    if (empty || (localSortCount > 0))
+                        localList.Add("SortCount", localSortCount.ToString());
+
+                    long localCompactCount = Interlocked.CompareExchange(
+                        ref compactCount, 0, 0);
+
+                    if (empty || (localCompactCount > 0))
+                        localList.Add("CompactCount", localCompactCount.ToString());
 
                     long localMaybeCompactCount = Interlocked.CompareExchange(
                         ref maybeCompactCount, 0, 0);
 
                     if (empty || (localMaybeCompactCount > 0))
                         localList.Add("MaybeCompactCount", localMaybeCompactCount.ToString());
-#endif
 
                     if (localList.Count > 0)
                     {
@@ -1310,6 +2156,76 @@ namespace Eagle._Components.Private
 
         ///////////////////////////////////////////////////////////////////////
 
+        private static long[] GetMemoryStatistics()
+        {
+            bool locked = false;
+
+            try
+            {
+                TryLock(ref locked); /* TRANSACTIONAL */
+
+                if (locked)
+                {
+                    if ((nativeFreeMemory != null) &&
+                        (nativeGetMemoryStatistics != null))
+                    {
+                        IntPtr[] statistics = new IntPtr[memoryStatisticsLength];
+                        IntPtr pError = IntPtr.Zero;
+
+                        try
+                        {
+                            if (nativeGetMemoryStatistics(
+                                    new IntPtr(statistics.Length * IntPtr.Size),
+                                    statistics,
+                                    ref pError) == ReturnCode.Ok)
+                            {
+                                long[] result = new long[statistics.Length];
+
+                                for (int index = 0; index < result.Length;
+                                        index++)
+                                {
+                                    result[index] = statistics[index].ToInt64();
+                                }
+
+                                return result;
+                            }
+
+                            TraceOps.DebugTrace(String.Format(
+                                "GetMemoryStatistics: {0}",
+                                FormatOps.WrapOrNull(
+                                    (pError != IntPtr.Zero) ?
+                                        Marshal.PtrToStringUni(pError) :
+                                        null)),
+                                typeof(NativeUtility).Name,
+                                TracePriority.NativeError);
+                        }
+                        catch (Exception e)
+                        {
+                            TraceOps.DebugTrace(
+                                e, typeof(NativeUtility).Name,
+                                TracePriority.NativeError);
+                        }
+                        finally
+                        {
+                            if (pError != IntPtr.Zero)
+                            {
+                                nativeFreeMemory(pError);
+                                pError = IntPtr.Zero;
+                            }
+                        }
+                    }
+                }
+
+                return null;
+            }
+            finally
+            {
+                ExitLock(ref locked); /* TRANSACTIONAL */
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
         private static bool IsDisabled(
             Interpreter interpreter
             )
@@ -1419,10 +2335,12 @@ namespace Eagle._Components.Private
                                         pVersion);
 
                                     bool useHeapApi;
+                                    bool usePoolAllocator;
 
                                     if (IsUsable(
                                             version, Build.Debug,
-                                            out useHeapApi))
+                                            out useHeapApi,
+                                            out usePoolAllocator))
                                     {
 #if WINDOWS
                                         //
@@ -1432,25 +2350,36 @@ namespace Eagle._Components.Private
                                         //
                                         if (nativeUseHeapApi == null)
                                             nativeUseHeapApi = useHeapApi;
+#endif
+
+                                        //
+                                        // HACK: Likewise for the flag that
+                                        //       controls the usage of the
+                                        //       pooled memory allocator.
+                                        //
+                                        if (nativeUsePoolAllocator == null)
+                                            nativeUsePoolAllocator =
+                                                usePoolAllocator;
 
                                         //
                                         // NOTE: If applicable, enable usage
                                         //       of the native Win32 API for
-                                        //       heap management.
+                                        //       heap management -OR- the
+                                        //       private memory pool.
                                         //
                                         if (MaybeInitializeNativeHeap())
-#endif
                                         {
                                             ParserOpsData.EnableNative(true);
                                             isAvailable = true;
+
+                                            Interlocked.Exchange(
+                                                ref fastIsAvailable, 1);
                                         }
-#if WINDOWS
                                         else
                                         {
                                             version = null;
                                             isAvailable = false;
                                         }
-#endif
                                     }
                                     else
                                     {
@@ -1519,6 +2448,28 @@ namespace Eagle._Components.Private
 
         ///////////////////////////////////////////////////////////////////////
 
+        //
+        // NOTE: This method must be used with the TryLock pattern, i.e. the
+        //       caller must call ExitLock from a finally block.  Once the
+        //       native utility library is known to be available, the lock
+        //       is not acquired at all, because calls into the library are
+        //       not serialized.
+        //
+        public static bool TryIsAvailable(
+            Interpreter interpreter, /* OPTIONAL */
+            ref bool locked
+            )
+        {
+            if (Interlocked.CompareExchange(ref fastIsAvailable, 0, 0) != 0)
+                return true;
+
+            TryLock(ref locked); /* TRANSACTIONAL */
+
+            return locked && IsAvailable(interpreter);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
         private static bool ResetAvailable( /* NOT USED */
             Interpreter interpreter,
             bool? available,
@@ -1528,10 +2479,16 @@ namespace Eagle._Components.Private
         {
             try
             {
+                //
+                // NOTE: This must be done without holding the lock; see the
+                //       UnloadNativeLibrary method.
+                //
+                if (unload && !UnloadNativeLibrary(interpreter))
+                    return false;
+
                 lock (syncRoot) /* TRANSACTIONAL */
                 {
-                    if (unload && !UnloadNativeLibrary(interpreter))
-                        return false;
+                    Interlocked.Exchange(ref fastIsAvailable, 0);
 
                     if (unlock)
                         locked = false;
@@ -1603,21 +2560,49 @@ namespace Eagle._Components.Private
                 return ReturnCode.Error;
             }
 
-            lock (syncRoot) /* TRANSACTIONAL */
+            if (!EnterNativeCall())
+            {
+                error = "native utility library is being unloaded";
+                return ReturnCode.Error;
+            }
+
+            try
             {
-                if ((nativeFreeMemory != null) &&
-                    (nativeFreeElements != null) &&
-                    (nativeSplitList != null))
+                //
+                // NOTE: The native utility library is reentrant; therefore,
+                //       no lock is held here.  Instead, grab the delegates
+                //       once, so they cannot change during this call.
+                //
+                Eagle_FreeMemory freeMemory = nativeFreeMemory;
+                Eagle_FreeElements freeElements = nativeFreeElements;
+                Eagle_SplitList splitList = nativeSplitList;
+
+                Eagle_SplitListSpans splitListSpans =
+                    nativeSplitListSpans;
+
+                //
+                // NOTE: When available, prefer the span based entry point
+                //       because it avoids copying most list elements.
+                //
+                if ((freeMemory != null) && (splitListSpans != null))
+                {
+                    return SplitListSpans(
+                        freeMemory, splitListSpans, text, ref list,
+                        ref error);
+                }
+
+                if ((freeMemory != null) && (freeElements != null) &&
+                    (splitList != null))
                 {
-                    int elementCount = 0;
+                    IntPtr elementCount = IntPtr.Zero;
                     IntPtr pElementLengths = IntPtr.Zero;
                     IntPtr ppElements = IntPtr.Zero;
                     IntPtr pError = IntPtr.Zero;
 
                     try
                     {
-                        ReturnCode code = nativeSplitList(
-                            text.Length, text, ref elementCount,
+                        ReturnCode code = splitList(
+                            new IntPtr(text.Length), text, ref elementCount,
                             ref pElementLengths, ref ppElements,
                             ref pError);
 
@@ -1629,35 +2614,26 @@ namespace Eagle._Components.Private
                             return code;
                         }
 
-                        if (elementCount < 0)
+                        long count = elementCount.ToInt64();
+
+                        if (!IsValidSizeT(count))
                         {
                             error = String.Format(
                                 "bad number of elements in list: {0}",
-                                elementCount);
+                                count);
 
                             return ReturnCode.Error;
                         }
 
                         if (list != null)
-                            list.Capacity += elementCount;
+                            list.Capacity += (int)count;
                         else
-                            list = new StringList(elementCount);
+                            list = new StringList((int)count);
 
-                        for (int index = 0; index < elementCount; index++)
+                        for (long index = 0; index < count; index++)
                         {
-                            int elementOffset = index * IntPtr.Size;
-
-                            if (elementOffset < 0)
-                            {
-                                error = String.Format(
-                                    "bad list element {0} offset: {1}",
-                                    index, elementOffset);
-
-                                return ReturnCode.Error;
-                            }
-
-                            IntPtr pElement = Marshal.ReadIntPtr(
-                                ppElements, elementOffset);
+                            IntPtr pElement = ReadIntPtr(
+                                ppElements, index * IntPtr.Size);
 
                             if (pElement == IntPtr.Zero)
                             {
@@ -1665,21 +2641,10 @@ namespace Eagle._Components.Private
                                 continue;
                             }
 
-                            int lengthOffset = index * sizeof(int);
-
-                            if (lengthOffset < 0)
-                            {
-                                error = String.Format(
-                                    "bad list element length {0} offset: {1}",
-                                    index, lengthOffset);
-
-                                return ReturnCode.Error;
-                            }
-
-                            int elementLength = Marshal.ReadInt32(
-                                pElementLengths, lengthOffset);
+                            long elementLength = ReadSizeT(
+                                pElementLengths, index * IntPtr.Size);
 
-                            if (elementLength < 0)
+                            if (!IsValidSizeT(elementLength))
                             {
                                 error = String.Format(
                                     "bad number of characters in list element: {0}",
@@ -1689,7 +2654,7 @@ namespace Eagle._Components.Private
                             }
 
                             list.Add(Marshal.PtrToStringUni(pElement,
-                                elementLength));
+                                (int)elementLength));
                         }
 
                         return ReturnCode.Ok;
@@ -1703,7 +2668,7 @@ namespace Eagle._Components.Private
                         #region Free Error String
                         if (pError != IntPtr.Zero)
                         {
-                            nativeFreeMemory(pError);
+                            freeMemory(pError);
                             pError = IntPtr.Zero;
                         }
                         #endregion
@@ -1713,9 +2678,9 @@ namespace Eagle._Components.Private
                         #region Free Element Array
                         if (ppElements != IntPtr.Zero)
                         {
-                            nativeFreeElements(elementCount, ppElements);
+                            freeElements(elementCount, ppElements);
                             ppElements = IntPtr.Zero;
-                            elementCount = 0;
+                            elementCount = IntPtr.Zero;
                         }
                         #endregion
 
@@ -1724,7 +2689,7 @@ namespace Eagle._Components.Private
                         #region Free Element Lengths Array
                         if (pElementLengths != IntPtr.Zero)
                         {
-                            nativeFreeMemory(pElementLengths);
+                            freeMemory(pElementLengths);
                             pElementLengths = IntPtr.Zero;
                         }
                         #endregion
@@ -1732,10 +2697,8 @@ namespace Eagle._Components.Private
                         ///////////////////////////////////////////////////////
 
                         #region Maybe Compact Native Heap
-#if WINDOWS
                         /* IGNORED */
                         MaybeCompactNativeHeap();
-#endif
                         #endregion
                     }
                 }
@@ -1748,107 +2711,2151 @@ namespace Eagle._Components.Private
                         typeof(Eagle_SplitList).Name);
                 }
             }
+            finally
+            {
+                ExitNativeCall();
+            }
 
             return ReturnCode.Error;
         }
 
         ///////////////////////////////////////////////////////////////////////
 
-        public static ReturnCode JoinList(
-            StringList list,
-            ref string text,
+        private static ReturnCode SplitListSpans(
+            Eagle_FreeMemory freeMemory,
+            Eagle_SplitListSpans splitListSpans,
+            string text,
+            ref StringList list,
             ref Result error
             )
         {
-            if (list == null)
-            {
-                error = "invalid list";
-                return ReturnCode.Error;
-            }
+            //
+            // NOTE: The caller (i.e. SplitList) has already checked for
+            //       an unload in progress and is responsible for noting
+            //       the completion of this native call.
+            //
+            IntPtr elementCount = IntPtr.Zero;
+            IntPtr pSpans = IntPtr.Zero;
+            IntPtr pUnescaped = IntPtr.Zero;
+            IntPtr pError = IntPtr.Zero;
 
-            lock (syncRoot) /* TRANSACTIONAL */
+            try
             {
-                if ((nativeFreeMemory != null) && (nativeJoinList != null))
+                ReturnCode code = splitListSpans(
+                    new IntPtr(text.Length), text, ref elementCount,
+                    ref pSpans, ref pUnescaped, ref pError);
+
+                Interlocked.Increment(ref splitCount);
+
+                if (code != ReturnCode.Ok)
                 {
-                    IntPtr pText = IntPtr.Zero;
-                    IntPtr pError = IntPtr.Zero;
+                    error = Marshal.PtrToStringUni(pError);
+                    return code;
+                }
 
-                    try
-                    {
-                        int length = 0;
+                long count = elementCount.ToInt64();
 
-#if NATIVE_UTILITY_BSTR
-                        ReturnCode code = nativeJoinList(
-                            list.Count, null, ToStringArray(list),
-                            ref length, ref pText, ref pError);
-#else
-                        ReturnCode code = nativeJoinList(
-                            list.Count, ToLengthArray(list),
-                            ToStringArray(list), ref length,
-                            ref pText, ref pError);
-#endif
+                if (!IsValidSizeT(count))
+                {
+                    error = String.Format(
+                        "bad number of elements in list: {0}",
+                        count);
 
-                        Interlocked.Increment(ref joinCount);
+                    return ReturnCode.Error;
+                }
 
-                        if (code != ReturnCode.Ok)
-                        {
-                            error = Marshal.PtrToStringUni(pError);
-                            return code;
-                        }
+                if (list != null)
+                    list.Capacity += (int)count;
+                else
+                    list = new StringList((int)count);
 
-                        if (length < 0)
-                        {
-                            error = String.Format(
-                                "bad number of characters in string: {0}",
-                                length);
+                int textLength = text.Length;
 
-                            return ReturnCode.Error;
-                        }
+                for (long index = 0; index < count; index++)
+                {
+                    long spanOffset = index * elementSpanSize;
 
-                        text = Marshal.PtrToStringUni(pText, length);
-                        return ReturnCode.Ok;
+                    long elementOffset = ReadSizeT(
+                        pSpans, spanOffset + elementSpanOffset);
+
+                    long elementLength = ReadSizeT(
+                        pSpans, spanOffset + elementSpanLength);
+
+                    if (!IsValidSizeT(elementOffset) ||
+                        !IsValidSizeT(elementLength))
+                    {
+                        error = String.Format(
+                            "bad list element {0} span: {1}, {2}",
+                            index, elementOffset, elementLength);
+
+                        return ReturnCode.Error;
                     }
-                    catch (Exception e)
+
+                    if (elementLength == 0)
                     {
-                        error = e;
+                        list.Add(String.Empty);
+                        continue;
                     }
-                    finally
+
+                    if (ReadSizeT(pSpans, spanOffset +
+                            elementSpanNeedsUnescape) != 0)
                     {
-                        #region Free Error String
-                        if (pError != IntPtr.Zero)
+                        //
+                        // NOTE: This element contained backslash
+                        //       sequences; therefore, it was copied
+                        //       and collapsed by the native code.
+                        //
+                        if (pUnescaped == IntPtr.Zero)
                         {
-                            nativeFreeMemory(pError);
-                            pError = IntPtr.Zero;
-                        }
-                        #endregion
+                            error = String.Format(
+                                "missing unescaped text for list " +
+                                "element {0}", index);
 
-                        ///////////////////////////////////////////////////////
+                            return ReturnCode.Error;
+                        }
 
-                        #region Free Text String
-                        if (pText != IntPtr.Zero)
+                        list.Add(Marshal.PtrToStringUni(new IntPtr(
+                            pUnescaped.ToInt64() + (elementOffset *
+                            sizeof(char))), (int)elementLength));
+                    }
+                    else
+                    {
+                        //
+                        // NOTE: This element is used verbatim; build
+                        //       it straight from the original string.
+                        //
+                        if (elementOffset > (textLength - elementLength))
                         {
-                            nativeFreeMemory(pText);
-                            pText = IntPtr.Zero;
-                        }
-                        #endregion
+                            error = String.Format(
+                                "list element {0} span out of range: " +
+                                "{1}, {2}", index, elementOffset,
+                                elementLength);
 
-                        ///////////////////////////////////////////////////////
+                            return ReturnCode.Error;
+                        }
 
-                        #region Maybe Compact Native Heap
-#if WINDOWS
-                        /* IGNORED */
-                        MaybeCompactNativeHeap();
-#endif
-                        #endregion
+                        list.Add(text.Substring(
+                            (int)elementOffset, (int)elementLength));
                     }
                 }
-                else
+
+                return ReturnCode.Ok;
+            }
+            catch (Exception e)
+            {
+                error = e;
+            }
+            finally
+            {
+                #region Free Error String
+                if (pError != IntPtr.Zero)
                 {
-                    error = String.Format(
-                        "one or more required functions are unavailable: " +
-                        "{0} or {1}", typeof(Eagle_FreeMemory).Name,
-                        typeof(Eagle_JoinList).Name);
+                    freeMemory(pError);
+                    pError = IntPtr.Zero;
                 }
+                #endregion
+
+                ///////////////////////////////////////////////////////////////
+
+                #region Free Unescaped Text
+                if (pUnescaped != IntPtr.Zero)
+                {
+                    freeMemory(pUnescaped);
+                    pUnescaped = IntPtr.Zero;
+                }
+                #endregion
+
+                ///////////////////////////////////////////////////////////////
+
+                #region Free Element Spans Array
+                if (pSpans != IntPtr.Zero)
+                {
+                    freeMemory(pSpans);
+                    pSpans = IntPtr.Zero;
+                    elementCount = IntPtr.Zero;
+                }
+                #endregion
+
+                ///////////////////////////////////////////////////////////////
+
+                #region Maybe Compact Native Heap
+                /* IGNORED */
+                MaybeCompactNativeHeap();
+                #endregion
+            }
+
+            return ReturnCode.Error;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        public static ReturnCode SplitLists(
+            IList<string> texts,
+            ref StringList[] lists,
+            ref Result error
+            )
+        {
+            if (texts == null)
+            {
+                error = "invalid text list";
+                return ReturnCode.Error;
+            }
+
+            int listCount = texts.Count;
+
+            if ((lists != null) && (lists.Length != listCount))
+            {
+                error = String.Format(
+                    "wrong number of lists: {0}, expected {1}",
+                    lists.Length, listCount);
+
+                return ReturnCode.Error;
+            }
+
+            for (int listIndex = 0; listIndex < listCount; listIndex++)
+            {
+                if (texts[listIndex] == null)
+                {
+                    error = String.Format(
+                        "invalid text {0}", listIndex);
+
+                    return ReturnCode.Error;
+                }
+            }
+
+            if (!EnterNativeCall())
+            {
+                error = "native utility library is being unloaded";
+                return ReturnCode.Error;
+            }
+
+            try
+            {
+                //
+                // NOTE: The native utility library is reentrant; therefore,
+                //       no lock is held here.  Instead, grab the delegates
+                //       once, so they cannot change during this call.
+                //
+                Eagle_FreeMemory freeMemory = nativeFreeMemory;
+                Eagle_SplitLists splitLists = nativeSplitLists;
+
+                if ((freeMemory != null) && (splitLists != null))
+                {
+                    //
+                    // NOTE: All the texts are pinned, rather than copied,
+                    //       for the duration of the native call.
+                    //
+                    GCHandle[] textHandles = new GCHandle[listCount];
+                    IntPtr elementCount = IntPtr.Zero;
+                    IntPtr pCounts = IntPtr.Zero;
+                    IntPtr pText = IntPtr.Zero;
+                    IntPtr pError = IntPtr.Zero;
+
+                    try
+                    {
+                        IntPtr[] lengths = new IntPtr[listCount];
+                        IntPtr[] pTexts = new IntPtr[listCount];
+
+                        for (int listIndex = 0; listIndex < listCount;
+                                listIndex++)
+                        {
+                            string text = texts[listIndex];
+
+                            textHandles[listIndex] = GCHandle.Alloc(
+                                text, GCHandleType.Pinned);
+
+                            pTexts[listIndex] =
+                                textHandles[listIndex].AddrOfPinnedObject();
+
+                            lengths[listIndex] = new IntPtr(text.Length);
+                        }
+
+                        ReturnCode code = splitLists(
+                            new IntPtr(listCount), lengths, pTexts,
+                            ref elementCount, ref pCounts, ref pText,
+                            ref pError);
+
+                        Interlocked.Increment(ref splitCount);
+
+                        if (code != ReturnCode.Ok)
+                        {
+                            error = Marshal.PtrToStringUni(pError);
+                            return code;
+                        }
+
+                        long totalCount = elementCount.ToInt64();
+
+                        if (!IsValidSizeT(totalCount))
+                        {
+                            error = String.Format(
+                                "bad number of elements in lists: {0}",
+                                totalCount);
+
+                            return ReturnCode.Error;
+                        }
+
+                        //
+                        // NOTE: The result block starts with the number of
+                        //       elements in each list, followed by all the
+                        //       element lengths; the element text follows
+                        //       them, without any terminators.
+                        //
+                        StringList[] localLists = (lists != null) ?
+                            lists : new StringList[listCount];
+
+                        long lengthOffset = (long)listCount * IntPtr.Size;
+                        long textOffset = pText.ToInt64();
+                        long remaining = totalCount;
+
+                        for (int listIndex = 0; listIndex < listCount;
+                                listIndex++)
+                        {
+                            long count = ReadSizeT(
+                                pCounts, (long)listIndex * IntPtr.Size);
+
+                            if ((count < 0) || (count > remaining))
+                            {
+                                error = String.Format(
+                                    "bad number of elements in list {0}: {1}",
+                                    listIndex, count);
+
+                                return ReturnCode.Error;
+                            }
+
+                            StringList list = localLists[listIndex];
+
+                            if (list != null)
+                                list.Capacity += (int)count;
+                            else
+                                list = new StringList((int)count);
+
+                            for (long index = 0; index < count; index++)
+                            {
+                                long elementLength = ReadSizeT(
+                                    pCounts, lengthOffset);
+
+                                if (!IsValidSizeT(elementLength))
+                                {
+                                    error = String.Format(
+                                        "bad number of characters in list element: {0}",
+                                        elementLength);
+
+                                    return ReturnCode.Error;
+                                }
+
+                                if (elementLength > 0)
+                                {
+                                    list.Add(Marshal.PtrToStringUni(
+                                        new IntPtr(textOffset),
+                                        (int)elementLength));
+                                }
+                                else
+                                {
+                                    list.Add(String.Empty);
+                                }
+
+                                lengthOffset += IntPtr.Size;
+                                textOffset += elementLength * sizeof(char);
+                            }
+
+                            localLists[listIndex] = list;
+                            remaining -= count;
+                        }
+
+                        if (remaining != 0)
+                        {
+                            error = String.Format(
+                                "bad number of elements in lists: {0}",
+                                totalCount);
+
+                            return ReturnCode.Error;
+                        }
+
+                        lists = localLists;
+                        return ReturnCode.Ok;
+                    }
+                    catch (Exception e)
+                    {
+                        error = e;
+                    }
+                    finally
+                    {
+                        #region Free Error String
+                        if (pError != IntPtr.Zero)
+                        {
+                            freeMemory(pError);
+                            pError = IntPtr.Zero;
+                        }
+                        #endregion
+
+                        ///////////////////////////////////////////////////////
+
+                        #region Free Result Block
+                        if (pCounts != IntPtr.Zero)
+                        {
+                            freeMemory(pCounts);
+                            pCounts = IntPtr.Zero;
+                            pText = IntPtr.Zero;
+                        }
+                        #endregion
+
+                        ///////////////////////////////////////////////////////
+
+                        #region Unpin Texts
+                        for (int listIndex = 0; listIndex < listCount;
+                                listIndex++)
+                        {
+                            if (textHandles[listIndex].IsAllocated)
+                                textHandles[listIndex].Free();
+                        }
+                        #endregion
+
+                        ///////////////////////////////////////////////////////
+
+                        #region Maybe Compact Native Heap
+                        /* IGNORED */
+                        MaybeCompactNativeHeap();
+                        #endregion
+                    }
+                }
+                else
+                {
+                    error = String.Format(
+                        "one or more required functions are unavailable: " +
+                        "{0} or {1}", typeof(Eagle_FreeMemory).Name,
+                        typeof(Eagle_SplitLists).Name);
+                }
+            }
+            finally
+            {
+                ExitNativeCall();
+            }
+
+            return ReturnCode.Error;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        public static ReturnCode CountList(
+            string text,
+            ref int count,
+            ref Result error
+            )
+        {
+            if (text == null)
+            {
+                error = "invalid text";
+                return ReturnCode.Error;
+            }
+
+            if (!EnterNativeCall())
+            {
+                error = "native utility library is being unloaded";
+                return ReturnCode.Error;
+            }
+
+            try
+            {
+                Eagle_FreeMemory freeMemory = nativeFreeMemory;
+
+                Eagle_CountListElements countListElements =
+                    nativeCountListElements;
+
+                if ((freeMemory != null) && (countListElements != null))
+                {
+                    IntPtr elementCount = IntPtr.Zero;
+                    IntPtr pError = IntPtr.Zero;
+
+                    try
+                    {
+                        ReturnCode code = countListElements(
+                            new IntPtr(text.Length), text, ref elementCount,
+                            ref pError);
+
+                        Interlocked.Increment(ref queryCount);
+
+                        if (code != ReturnCode.Ok)
+                        {
+                            error = Marshal.PtrToStringUni(pError);
+                            return code;
+                        }
+
+                        long localCount = elementCount.ToInt64();
+
+                        if (!IsValidSizeT(localCount))
+                        {
+                            error = String.Format(
+                                "bad number of elements in list: {0}",
+                                localCount);
+
+                            return ReturnCode.Error;
+                        }
+
+                        count = (int)localCount;
+                        return ReturnCode.Ok;
+                    }
+                    catch (Exception e)
+                    {
+                        error = e;
+                    }
+                    finally
+                    {
+                        #region Free Error String
+                        if (pError != IntPtr.Zero)
+                        {
+                            freeMemory(pError);
+                            pError = IntPtr.Zero;
+                        }
+                        #endregion
+                    }
+                }
+                else
+                {
+                    error = String.Format(
+                        "one or more required functions are unavailable: " +
+                        "{0} or {1}", typeof(Eagle_FreeMemory).Name,
+                        typeof(Eagle_CountListElements).Name);
+                }
+            }
+            finally
+            {
+                ExitNativeCall();
+            }
+
+            return ReturnCode.Error;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        public static ReturnCode GetListElement(
+            string text,
+            int index,
+            ref string element,
+            ref Result error
+            )
+        {
+            if (text == null)
+            {
+                error = "invalid text";
+                return ReturnCode.Error;
+            }
+
+            if (index < 0)
+            {
+                error = String.Format(
+                    "bad list element index: {0}", index);
+
+                return ReturnCode.Error;
+            }
+
+            if (!EnterNativeCall())
+            {
+                error = "native utility library is being unloaded";
+                return ReturnCode.Error;
+            }
+
+            try
+            {
+                Eagle_FreeMemory freeMemory = nativeFreeMemory;
+                Eagle_GetListElement getListElement = nativeGetListElement;
+
+                if ((freeMemory != null) && (getListElement != null))
+                {
+                    IntPtr elementLength = IntPtr.Zero;
+                    IntPtr pElement = IntPtr.Zero;
+                    IntPtr pError = IntPtr.Zero;
+
+                    try
+                    {
+                        ReturnCode code = getListElement(
+                            new IntPtr(text.Length), text, new IntPtr(index),
+                            ref elementLength, ref pElement, ref pError);
+
+                        Interlocked.Increment(ref queryCount);
+
+                        if (code != ReturnCode.Ok)
+                        {
+                            error = Marshal.PtrToStringUni(pError);
+                            return code;
+                        }
+
+                        long length = elementLength.ToInt64();
+
+                        if (!IsValidSizeT(length))
+                        {
+                            error = String.Format(
+                                "bad number of characters in list element: {0}",
+                                length);
+
+                            return ReturnCode.Error;
+                        }
+
+                        //
+                        // NOTE: A null element pointer means the index is
+                        //       beyond the end of the list, which is not
+                        //       an error, per Tcl semantics.
+                        //
+                        if ((pElement == IntPtr.Zero) || (length == 0))
+                            element = String.Empty;
+                        else
+                            element = Marshal.PtrToStringUni(pElement, (int)length);
+
+                        return ReturnCode.Ok;
+                    }
+                    catch (Exception e)
+                    {
+                        error = e;
+                    }
+                    finally
+                    {
+                        #region Free Error String
+                        if (pError != IntPtr.Zero)
+                        {
+                            freeMemory(pError);
+                            pError = IntPtr.Zero;
+                        }
+                        #endregion
+
+                        ///////////////////////////////////////////////////////
+
+                        #region Free Element String
+                        if (pElement != IntPtr.Zero)
+                        {
+                            freeMemory(pElement);
+                            pElement = IntPtr.Zero;
+                        }
+                        #endregion
+                    }
+                }
+                else
+                {
+                    error = String.Format(
+                        "one or more required functions are unavailable: " +
+                        "{0} or {1}", typeof(Eagle_FreeMemory).Name,
+                        typeof(Eagle_GetListElement).Name);
+                }
+            }
+            finally
+            {
+                ExitNativeCall();
+            }
+
+            return ReturnCode.Error;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        public static ReturnCode GetListRange(
+            string text,
+            int firstIndex,
+            int lastIndex,
+            ref string result,
+            ref Result error
+            )
+        {
+            if (text == null)
+            {
+                error = "invalid text";
+                return ReturnCode.Error;
+            }
+
+            if ((firstIndex < 0) || (lastIndex < 0))
+            {
+                error = String.Format(
+                    "bad list range: {0}, {1}", firstIndex, lastIndex);
+
+                return ReturnCode.Error;
+            }
+
+            if (!EnterNativeCall())
+            {
+                error = "native utility library is being unloaded";
+                return ReturnCode.Error;
+            }
+
+            try
+            {
+                Eagle_FreeMemory freeMemory = nativeFreeMemory;
+                Eagle_GetListRange getListRange = nativeGetListRange;
+
+                if ((freeMemory != null) && (getListRange != null))
+                {
+                    IntPtr pResult = IntPtr.Zero;
+                    IntPtr pError = IntPtr.Zero;
+
+                    try
+                    {
+                        IntPtr resultLength = IntPtr.Zero;
+
+                        ReturnCode code = getListRange(
+                            new IntPtr(text.Length), text,
+                            new IntPtr(firstIndex), new IntPtr(lastIndex),
+                            ref resultLength, ref pResult, ref pError);
+
+                        Interlocked.Increment(ref editCount);
+
+                        if (code != ReturnCode.Ok)
+                        {
+                            error = Marshal.PtrToStringUni(pError);
+                            return code;
+                        }
+
+                        long length = resultLength.ToInt64();
+
+                        if (!IsValidSizeT(length))
+                        {
+                            error = String.Format(
+                                "bad number of characters in string: {0}",
+                                length);
+
+                            return ReturnCode.Error;
+                        }
+
+                        result = Marshal.PtrToStringUni(
+                            pResult, (int)length);
+
+                        return ReturnCode.Ok;
+                    }
+                    catch (Exception e)
+                    {
+                        error = e;
+                    }
+                    finally
+                    {
+                        #region Free Error String
+                        if (pError != IntPtr.Zero)
+                        {
+                            freeMemory(pError);
+                            pError = IntPtr.Zero;
+                        }
+                        #endregion
+
+                        ///////////////////////////////////////////////////////
+
+                        #region Free Result String
+                        if (pResult != IntPtr.Zero)
+                        {
+                            freeMemory(pResult);
+                            pResult = IntPtr.Zero;
+                        }
+                        #endregion
+
+                        ///////////////////////////////////////////////////////
+
+                        #region Maybe Compact Native Heap
+                        /* IGNORED */
+                        MaybeCompactNativeHeap();
+                        #endregion
+                    }
+                }
+                else
+                {
+                    error = String.Format(
+                        "one or more required functions are unavailable: " +
+                        "{0} or {1}", typeof(Eagle_FreeMemory).Name,
+                        typeof(Eagle_GetListRange).Name);
+                }
+            }
+            finally
+            {
+                ExitNativeCall();
+            }
+
+            return ReturnCode.Error;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        public static ReturnCode ReplaceListRange(
+            string text,
+            int firstIndex,
+            int deleteCount,
+            StringList list, /* OPTIONAL */
+            ref string result,
+            ref Result error
+            )
+        {
+            if (text == null)
+            {
+                error = "invalid text";
+                return ReturnCode.Error;
+            }
+
+            if ((firstIndex < 0) || (deleteCount < 0))
+            {
+                error = String.Format(
+                    "bad list range: {0}, {1}", firstIndex, deleteCount);
+
+                return ReturnCode.Error;
+            }
+
+            if (!EnterNativeCall())
+            {
+                error = "native utility library is being unloaded";
+                return ReturnCode.Error;
+            }
+
+            try
+            {
+                Eagle_FreeMemory freeMemory = nativeFreeMemory;
+
+                Eagle_ReplaceListRange replaceListRange =
+                    nativeReplaceListRange;
+
+                if ((freeMemory != null) && (replaceListRange != null))
+                {
+                    IntPtr pResult = IntPtr.Zero;
+                    IntPtr pError = IntPtr.Zero;
+
+                    try
+                    {
+                        int count = (list != null) ? list.Count : 0;
+                        IntPtr resultLength = IntPtr.Zero;
+
+#if NATIVE_UTILITY_BSTR
+                        ReturnCode code = replaceListRange(
+                            new IntPtr(text.Length), text,
+                            new IntPtr(firstIndex), new IntPtr(deleteCount),
+                            new IntPtr(count), null, ToStringArray(list),
+                            ref resultLength, ref pResult, ref pError);
+#else
+                        ReturnCode code = replaceListRange(
+                            new IntPtr(text.Length), text,
+                            new IntPtr(firstIndex), new IntPtr(deleteCount),
+                            new IntPtr(count), ToLengthArray(list),
+                            ToStringArray(list), ref resultLength,
+                            ref pResult, ref pError);
+#endif
+
+                        Interlocked.Increment(ref editCount);
+
+                        if (code != ReturnCode.Ok)
+                        {
+                            error = Marshal.PtrToStringUni(pError);
+                            return code;
+                        }
+
+                        long length = resultLength.ToInt64();
+
+                        if (!IsValidSizeT(length))
+                        {
+                            error = String.Format(
+                                "bad number of characters in string: {0}",
+                                length);
+
+                            return ReturnCode.Error;
+                        }
+
+                        result = Marshal.PtrToStringUni(
+                            pResult, (int)length);
+
+                        return ReturnCode.Ok;
+                    }
+                    catch (Exception e)
+                    {
+                        error = e;
+                    }
+                    finally
+                    {
+                        #region Free Error String
+                        if (pError != IntPtr.Zero)
+                        {
+                            freeMemory(pError);
+                            pError = IntPtr.Zero;
+                        }
+                        #endregion
+
+                        ///////////////////////////////////////////////////////
+
+                        #region Free Result String
+                        if (pResult != IntPtr.Zero)
+                        {
+                            freeMemory(pResult);
+                            pResult = IntPtr.Zero;
+                        }
+                        #endregion
+
+                        ///////////////////////////////////////////////////////
+
+                        #region Maybe Compact Native Heap
+                        /* IGNORED */
+                        MaybeCompactNativeHeap();
+                        #endregion
+                    }
+                }
+                else
+                {
+                    error = String.Format(
+                        "one or more required functions are unavailable: " +
+                        "{0} or {1}", typeof(Eagle_FreeMemory).Name,
+                        typeof(Eagle_ReplaceListRange).Name);
+                }
+            }
+            finally
+            {
+                ExitNativeCall();
+            }
+
+            return ReturnCode.Error;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        public static ReturnCode GetListEnumerable(
+            string text,
+            ref IEnumerable<string> enumerable,
+            ref Result error
+            )
+        {
+            if (text == null)
+            {
+                error = "invalid text";
+                return ReturnCode.Error;
+            }
+
+            if ((nativeFreeMemory == null) || (nativeListIterBegin == null) ||
+                (nativeListIterNext == null) || (nativeListIterEnd == null))
+            {
+                error = String.Format(
+                    "one or more required functions are unavailable: " +
+                    "{0}, {1}, {2}, or {3}", typeof(Eagle_FreeMemory).Name,
+                    typeof(Eagle_ListIterBegin).Name,
+                    typeof(Eagle_ListIterNext).Name,
+                    typeof(Eagle_ListIterEnd).Name);
+
+                return ReturnCode.Error;
+            }
+
+            enumerable = new NativeListEnumerable(text);
+            return ReturnCode.Ok;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        internal static ReturnCode GetListEnumerator(
+            string text,
+            ref IEnumerator<string> enumerator,
+            ref Result error
+            )
+        {
+            if (text == null)
+            {
+                error = "invalid text";
+                return ReturnCode.Error;
+            }
+
+            if (!EnterNativeCall())
+            {
+                error = "native utility library is being unloaded";
+                return ReturnCode.Error;
+            }
+
+            //
+            // NOTE: The native iterator refers to the list text across
+            //       calls; therefore, it must remain pinned until the
+            //       enumerator is disposed.  Upon success, ownership of
+            //       all these resources, including the active native
+            //       call, is transferred to the new enumerator.
+            //
+            GCHandle textHandle = new GCHandle();
+            IntPtr pIterator = IntPtr.Zero;
+            IntPtr pSpan = IntPtr.Zero;
+            IntPtr pError = IntPtr.Zero;
+            bool success = false;
+
+            Eagle_FreeMemory freeMemory = nativeFreeMemory;
+            Eagle_ListIterBegin listIterBegin = nativeListIterBegin;
+            Eagle_ListIterNext listIterNext = nativeListIterNext;
+            Eagle_ListIterEnd listIterEnd = nativeListIterEnd;
+
+            try
+            {
+                if ((freeMemory == null) || (listIterBegin == null) ||
+                    (listIterNext == null) || (listIterEnd == null))
+                {
+                    error = String.Format(
+                        "one or more required functions are unavailable: " +
+                        "{0}, {1}, {2}, or {3}", typeof(Eagle_FreeMemory).Name,
+                        typeof(Eagle_ListIterBegin).Name,
+                        typeof(Eagle_ListIterNext).Name,
+                        typeof(Eagle_ListIterEnd).Name);
+
+                    return ReturnCode.Error;
+                }
+
+                textHandle = GCHandle.Alloc(text, GCHandleType.Pinned);
+                pSpan = Marshal.AllocHGlobal(elementSpanSize);
+
+                ReturnCode code = listIterBegin(
+                    new IntPtr(text.Length), textHandle.AddrOfPinnedObject(),
+                    ref pIterator, ref pError);
+
+                if (code != ReturnCode.Ok)
+                {
+                    error = Marshal.PtrToStringUni(pError);
+                    return code;
+                }
+
+                enumerator = new NativeListEnumerator(
+                    text, textHandle, pIterator, pSpan, freeMemory,
+                    listIterNext, listIterEnd);
+
+                success = true;
+                return ReturnCode.Ok;
+            }
+            catch (Exception e)
+            {
+                error = e;
+            }
+            finally
+            {
+                #region Free Error String
+                if (pError != IntPtr.Zero)
+                {
+                    freeMemory(pError);
+                    pError = IntPtr.Zero;
+                }
+                #endregion
+
+                ///////////////////////////////////////////////////////////////
+
+                #region Cleanup On Failure
+                if (!success)
+                {
+                    if (pIterator != IntPtr.Zero)
+                    {
+                        listIterEnd(pIterator);
+                        pIterator = IntPtr.Zero;
+                    }
+
+                    if (pSpan != IntPtr.Zero)
+                    {
+                        Marshal.FreeHGlobal(pSpan);
+                        pSpan = IntPtr.Zero;
+                    }
+
+                    if (textHandle.IsAllocated)
+                        textHandle.Free();
+
+                    ExitNativeCall();
+                }
+                #endregion
+            }
+
+            return ReturnCode.Error;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        public static ReturnCode JoinList(
+            StringList list,
+            ref string text,
+            ref Result error
+            )
+        {
+            if (list == null)
+            {
+                error = "invalid list";
+                return ReturnCode.Error;
+            }
+
+            if (!EnterNativeCall())
+            {
+                error = "native utility library is being unloaded";
+                return ReturnCode.Error;
+            }
+
+            try
+            {
+                //
+                // NOTE: The native utility library is reentrant; therefore,
+                //       no lock is held here.  Instead, grab the delegates
+                //       once, so they cannot change during this call.
+                //
+                Eagle_FreeMemory freeMemory = nativeFreeMemory;
+                Eagle_JoinList joinList = nativeJoinList;
+
+                if ((freeMemory != null) && (joinList != null))
+                {
+                    IntPtr pText = IntPtr.Zero;
+                    IntPtr pError = IntPtr.Zero;
+
+                    try
+                    {
+                        IntPtr length = IntPtr.Zero;
+
+#if NATIVE_UTILITY_BSTR
+                        ReturnCode code = joinList(
+                            new IntPtr(list.Count), null, ToStringArray(list),
+                            ref length, ref pText, ref pError);
+#else
+                        ReturnCode code = joinList(
+                            new IntPtr(list.Count), ToLengthArray(list),
+                            ToStringArray(list), ref length,
+                            ref pText, ref pError);
+#endif
+
+                        Interlocked.Increment(ref joinCount);
+
+                        if (code != ReturnCode.Ok)
+                        {
+                            error = Marshal.PtrToStringUni(pError);
+                            return code;
+                        }
+
+                        long textLength = length.ToInt64();
+
+                        if (!IsValidSizeT(textLength))
+                        {
+                            error = String.Format(
+                                "bad number of characters in string: {0}",
+                                textLength);
+
+                            return ReturnCode.Error;
+                        }
+
+                        text = Marshal.PtrToStringUni(pText, (int)textLength);
+                        return ReturnCode.Ok;
+                    }
+                    catch (Exception e)
+                    {
+                        error = e;
+                    }
+                    finally
+                    {
+                        #region Free Error String
+                        if (pError != IntPtr.Zero)
+                        {
+                            freeMemory(pError);
+                            pError = IntPtr.Zero;
+                        }
+                        #endregion
+
+                        ///////////////////////////////////////////////////////
+
+                        #region Free Text String
+                        if (pText != IntPtr.Zero)
+                        {
+                            freeMemory(pText);
+                            pText = IntPtr.Zero;
+                        }
+                        #endregion
+
+                        ///////////////////////////////////////////////////////
+
+                        #region Maybe Compact Native Heap
+                        /* IGNORED */
+                        MaybeCompactNativeHeap();
+                        #endregion
+                    }
+                }
+                else
+                {
+                    error = String.Format(
+                        "one or more required functions are unavailable: " +
+                        "{0} or {1}", typeof(Eagle_FreeMemory).Name,
+                        typeof(Eagle_JoinList).Name);
+                }
+            }
+            finally
+            {
+                ExitNativeCall();
+            }
+
+            return ReturnCode.Error;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        public static ReturnCode JoinLists(
+            IList<StringList> lists,
+            ref string[] texts,
+            ref Result error
+            )
+        {
+            if (lists == null)
+            {
+                error = "invalid list of lists";
+                return ReturnCode.Error;
+            }
+
+            int listCount = lists.Count;
+            int elementCount = 0;
+
+            for (int listIndex = 0; listIndex < listCount; listIndex++)
+            {
+                StringList list = lists[listIndex];
+
+                if (list == null)
+                {
+                    error = String.Format(
+                        "invalid list {0}", listIndex);
+
+                    return ReturnCode.Error;
+                }
+
+                elementCount += list.Count;
+            }
+
+            if (!EnterNativeCall())
+            {
+                error = "native utility library is being unloaded";
+                return ReturnCode.Error;
+            }
+
+            try
+            {
+                //
+                // NOTE: The native utility library is reentrant; therefore,
+                //       no lock is held here.  Instead, grab the delegates
+                //       once, so they cannot change during this call.
+                //
+                Eagle_FreeMemory freeMemory = nativeFreeMemory;
+                Eagle_JoinLists joinLists = nativeJoinLists;
+
+                if ((freeMemory != null) && (joinLists != null))
+                {
+                    IntPtr pLengths = IntPtr.Zero;
+                    IntPtr pText = IntPtr.Zero;
+                    IntPtr pError = IntPtr.Zero;
+
+                    try
+                    {
+                        //
+                        // NOTE: Flatten all the lists into one array of
+                        //       elements, so that they can be passed to
+                        //       the native code using one call.
+                        //
+                        IntPtr[] elementCounts = new IntPtr[listCount];
+                        string[] elements = new string[elementCount];
+
+#if !NATIVE_UTILITY_BSTR
+                        IntPtr[] elementLengths = new IntPtr[elementCount];
+#endif
+
+                        int elementIndex = 0;
+
+                        for (int listIndex = 0; listIndex < listCount;
+                                listIndex++)
+                        {
+                            StringList list = lists[listIndex];
+                            int count = list.Count;
+
+                            list.CopyTo(elements, elementIndex);
+                            elementCounts[listIndex] = new IntPtr(count);
+
+#if !NATIVE_UTILITY_BSTR
+                            for (int index = 0; index < count; index++)
+                            {
+                                string element = elements[elementIndex + index];
+
+                                if (element == null)
+                                    continue;
+
+                                elementLengths[elementIndex + index] =
+                                    new IntPtr(element.Length);
+                            }
+#endif
+
+                            elementIndex += count;
+                        }
+
+#if NATIVE_UTILITY_BSTR
+                        ReturnCode code = joinLists(
+                            new IntPtr(listCount), elementCounts, null,
+                            elements, ref pLengths, ref pText, ref pError);
+#else
+                        ReturnCode code = joinLists(
+                            new IntPtr(listCount), elementCounts,
+                            elementLengths, elements, ref pLengths,
+                            ref pText, ref pError);
+#endif
+
+                        Interlocked.Increment(ref joinCount);
+
+                        if (code != ReturnCode.Ok)
+                        {
+                            error = Marshal.PtrToStringUni(pError);
+                            return code;
+                        }
+
+                        //
+                        // NOTE: The result block starts with the length of
+                        //       each list, followed by the text of all the
+                        //       lists, each with a terminator.
+                        //
+                        string[] localTexts = new string[listCount];
+                        long textOffset = pText.ToInt64();
+
+                        for (int listIndex = 0; listIndex < listCount;
+                                listIndex++)
+                        {
+                            long length = ReadSizeT(
+                                pLengths, (long)listIndex * IntPtr.Size);
+
+                            if (!IsValidSizeT(length))
+                            {
+                                error = String.Format(
+                                    "bad number of characters in string: {0}",
+                                    length);
+
+                                return ReturnCode.Error;
+                            }
+
+                            localTexts[listIndex] = Marshal.PtrToStringUni(
+                                new IntPtr(textOffset), (int)length);
+
+                            textOffset += (length + 1) * sizeof(char);
+                        }
+
+                        texts = localTexts;
+                        return ReturnCode.Ok;
+                    }
+                    catch (Exception e)
+                    {
+                        error = e;
+                    }
+                    finally
+                    {
+                        #region Free Error String
+                        if (pError != IntPtr.Zero)
+                        {
+                            freeMemory(pError);
+                            pError = IntPtr.Zero;
+                        }
+                        #endregion
+
+                        ///////////////////////////////////////////////////////
+
+                        #region Free Result Block
+                        if (pLengths != IntPtr.Zero)
+                        {
+                            freeMemory(pLengths);
+                            pLengths = IntPtr.Zero;
+                            pText = IntPtr.Zero;
+                        }
+                        #endregion
+
+                        ///////////////////////////////////////////////////////
+
+                        #region Maybe Compact Native Heap
+                        /* IGNORED */
+                        MaybeCompactNativeHeap();
+                        #endregion
+                    }
+                }
+                else
+                {
+                    error = String.Format(
+                        "one or more required functions are unavailable: " +
+                        "{0} or {1}", typeof(Eagle_FreeMemory).Name,
+                        typeof(Eagle_JoinLists).Name);
+                }
+            }
+            finally
+            {
+                ExitNativeCall();
+            }
+
+            return ReturnCode.Error;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        public static ReturnCode MatchStrings(
+            StringList list,
+            string pattern,
+            bool noCase,
+            bool strictRange,
+            ref StringList matches,
+            ref Result error
+            )
+        {
+            if (list == null)
+            {
+                error = "invalid list";
+                return ReturnCode.Error;
+            }
+
+            if (pattern == null)
+            {
+                error = "invalid pattern";
+                return ReturnCode.Error;
+            }
+
+            if (!EnterNativeCall())
+            {
+                error = "native utility library is being unloaded";
+                return ReturnCode.Error;
+            }
+
+            try
+            {
+                //
+                // NOTE: The native utility library is reentrant; therefore,
+                //       no lock is held here.  Instead, grab the delegates
+                //       once, so they cannot change during this call.
+                //
+                Eagle_FreeMemory freeMemory = nativeFreeMemory;
+                Eagle_CompilePattern compilePattern = nativeCompilePattern;
+                Eagle_StringMatchMany stringMatchMany = nativeStringMatchMany;
+                Eagle_FreePattern freePattern = nativeFreePattern;
+
+                if ((freeMemory != null) && (compilePattern != null) &&
+                    (stringMatchMany != null) && (freePattern != null))
+                {
+                    IntPtr pPattern = IntPtr.Zero;
+                    IntPtr pError = IntPtr.Zero;
+
+                    try
+                    {
+                        int flags = 0;
+
+                        if (noCase)
+                            flags |= matchNoCase;
+
+                        if (strictRange)
+                            flags |= matchStrictRange;
+
+                        ReturnCode code = compilePattern(
+                            new IntPtr(pattern.Length), pattern, flags,
+                            ref pPattern, ref pError);
+
+                        if (code != ReturnCode.Ok)
+                        {
+                            error = Marshal.PtrToStringUni(pError);
+                            return code;
+                        }
+
+                        int count = list.Count;
+                        byte[] bitmap = new byte[(count + 7) / 8];
+                        IntPtr localCount = IntPtr.Zero;
+
+#if NATIVE_UTILITY_BSTR
+                        code = stringMatchMany(
+                            pPattern, new IntPtr(count), null,
+                            ToStringArray(list), bitmap, ref localCount,
+                            ref pError);
+#else
+                        code = stringMatchMany(
+                            pPattern, new IntPtr(count), ToLengthArray(list),
+                            ToStringArray(list), bitmap, ref localCount,
+                            ref pError);
+#endif
+
+                        Interlocked.Increment(ref matchCount);
+
+                        if (code != ReturnCode.Ok)
+                        {
+                            error = Marshal.PtrToStringUni(pError);
+                            return code;
+                        }
+
+                        long localMatchCount = localCount.ToInt64();
+
+                        if (!IsValidSizeT(localMatchCount) ||
+                            (localMatchCount > count))
+                        {
+                            error = String.Format(
+                                "bad number of matching strings: {0}",
+                                localMatchCount);
+
+                            return ReturnCode.Error;
+                        }
+
+                        StringList localMatches = new StringList(
+                            (int)localMatchCount);
+
+                        for (int index = 0; index < count; index++)
+                        {
+                            if ((bitmap[index >> 3] & (1 << (index & 7))) != 0)
+                                localMatches.Add(list[index]);
+                        }
+
+                        matches = localMatches;
+                        return ReturnCode.Ok;
+                    }
+                    catch (Exception e)
+                    {
+                        error = e;
+                    }
+                    finally
+                    {
+                        #region Free Error String
+                        if (pError != IntPtr.Zero)
+                        {
+                            freeMemory(pError);
+                            pError = IntPtr.Zero;
+                        }
+                        #endregion
+
+                        ///////////////////////////////////////////////////////
+
+                        #region Free Compiled Pattern
+                        if (pPattern != IntPtr.Zero)
+                        {
+                            freePattern(pPattern);
+                            pPattern = IntPtr.Zero;
+                        }
+                        #endregion
+
+                        ///////////////////////////////////////////////////////
+
+                        #region Maybe Compact Native Heap
+                        /* IGNORED */
+                        MaybeCompactNativeHeap();
+                        #endregion
+                    }
+                }
+                else
+                {
+                    error = String.Format(
+                        "one or more required functions are unavailable: " +
+                        "{0}, {1}, {2}, or {3}", typeof(Eagle_FreeMemory).Name,
+                        typeof(Eagle_CompilePattern).Name,
+                        typeof(Eagle_StringMatchMany).Name,
+                        typeof(Eagle_FreePattern).Name);
+                }
+            }
+            finally
+            {
+                ExitNativeCall();
+            }
+
+            return ReturnCode.Error;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        public static ReturnCode ParseScript(
+            string text,
+            bool nested,
+            IParseState parseState,
+            ref TokenList tokens,
+            ref Result error
+            )
+        {
+            if (text == null)
+            {
+                error = "invalid script";
+                return ReturnCode.Error;
+            }
+
+            if (parseState == null)
+            {
+                error = "invalid parse state";
+                return ReturnCode.Error;
+            }
+
+            if (!EnterNativeCall())
+            {
+                error = "native utility library is being unloaded";
+                return ReturnCode.Error;
+            }
+
+            try
+            {
+                //
+                // NOTE: The native utility library is reentrant; therefore,
+                //       no lock is held here.  Instead, grab the delegates
+                //       once, so they cannot change during this call.
+                //
+                Eagle_FreeMemory freeMemory = nativeFreeMemory;
+                Eagle_ParseScript parseScript = nativeParseScript;
+
+                if ((freeMemory != null) && (parseScript != null))
+                {
+                    IntPtr pTokens = IntPtr.Zero;
+                    IntPtr pError = IntPtr.Zero;
+
+                    try
+                    {
+                        int flags = (int)parseState.SubstitutionFlags &
+                            parseSubstitutionMask;
+
+                        if (nested)
+                            flags |= parseNested;
+
+                        IntPtr[] state = new IntPtr[scriptStateLength];
+                        IntPtr tokenCount = IntPtr.Zero;
+
+                        ReturnCode code = parseScript(
+                            new IntPtr(text.Length), text, flags, state,
+                            ref tokenCount, ref pTokens, ref pError);
+
+                        Interlocked.Increment(ref parseCount);
+
+                        if (code != ReturnCode.Ok)
+                        {
+                            error = Marshal.PtrToStringUni(pError);
+                            return code;
+                        }
+
+                        long count = tokenCount.ToInt64();
+
+                        if (!IsValidSizeT(count))
+                        {
+                            error = String.Format(
+                                "bad number of script tokens: {0}",
+                                count);
+
+                            return ReturnCode.Error;
+                        }
+
+                        //
+                        // NOTE: All native line numbers are relative to the
+                        //       start of the script; the managed ones start
+                        //       from the current line of the parse state.
+                        //
+                        int textLength = text.Length;
+                        int baseLine = parseState.CurrentLine;
+                        int lastSeparator = Index.Invalid;
+
+                        TokenList localTokens = new TokenList((int)count);
+
+                        for (long index = 0; index < count; index++)
+                        {
+                            long tokenOffset = index * scriptTokenSize;
+
+                            TokenType type = (TokenType)ReadSizeT(
+                                pTokens, tokenOffset + scriptTokenType);
+
+                            long start = ReadSizeT(
+                                pTokens, tokenOffset + scriptTokenStart);
+
+                            long length = ReadSizeT(
+                                pTokens, tokenOffset + scriptTokenLength);
+
+                            long components = ReadSizeT(
+                                pTokens, tokenOffset + scriptTokenComponents);
+
+                            long startLine = ReadSizeT(
+                                pTokens, tokenOffset + scriptTokenStartLine);
+
+                            long endLine = ReadSizeT(
+                                pTokens, tokenOffset + scriptTokenEndLine);
+
+                            if (!IsValidSizeT(start) ||
+                                !IsValidSizeT(length) ||
+                                (start > (textLength - length)) ||
+                                !IsValidSizeT(components) ||
+                                !IsValidSizeT(startLine) ||
+                                !IsValidSizeT(endLine))
+                            {
+                                error = String.Format(
+                                    "bad script token {0}: {1}, {2}, {3}",
+                                    index, start, length, components);
+
+                                return ReturnCode.Error;
+                            }
+
+                            IToken token = ParseToken.FromState(
+                                null, parseState);
+
+                            token.Type = type;
+                            token.Start = (int)start;
+                            token.Length = (int)length;
+                            token.Components = (int)components;
+                            token.StartLine = baseLine + (int)startLine;
+
+                            //
+                            // NOTE: The managed parser never sets the
+                            //       ending line for command separators.
+                            //
+                            if (type == TokenType.Separator)
+                                lastSeparator = localTokens.Count;
+                            else
+                                token.EndLine = baseLine + (int)endLine;
+
+                            localTokens.Add(token);
+                        }
+
+                        int currentLine = ReadScriptState(
+                            state, scriptStateCurrentLine);
+
+                        int lineStart = ReadScriptState(
+                            state, scriptStateLineStart);
+
+                        int commentStart = ReadScriptState(
+                            state, scriptStateCommentStart);
+
+                        int commentLength = ReadScriptState(
+                            state, scriptStateCommentLength);
+
+                        int commandStart = ReadScriptState(
+                            state, scriptStateCommandStart);
+
+                        int commandLength = ReadScriptState(
+                            state, scriptStateCommandLength);
+
+                        int commandWords = ReadScriptState(
+                            state, scriptStateCommandWords);
+
+                        int terminator = ReadScriptState(
+                            state, scriptStateTerminator);
+
+                        //
+                        // NOTE: Leave the parse state exactly as it would
+                        //       be after the managed parser had handled the
+                        //       final command of the script.
+                        //
+                        parseState.CurrentLine = baseLine + currentLine;
+                        parseState.LineStart = lineStart;
+                        parseState.CommentStart = commentStart;
+                        parseState.CommentLength = commentLength;
+                        parseState.CommandStart = commandStart;
+                        parseState.CommandLength = commandLength;
+                        parseState.CommandWords = commandWords;
+                        parseState.Terminator = terminator;
+
+                        parseState.Incomplete =
+                            (state[scriptStateIncomplete] != IntPtr.Zero);
+
+                        parseState.Text = text;
+                        parseState.Characters = textLength;
+                        parseState.ParseError = ParseError.Success;
+
+                        if (lastSeparator != Index.Invalid)
+                        {
+                            parseState.Tokens = new TokenList(
+                                localTokens.GetRange(lastSeparator + 1,
+                                localTokens.Count - (lastSeparator + 1)));
+                        }
+
+                        if (tokens != null)
+                            tokens.AddRange(localTokens);
+                        else
+                            tokens = localTokens;
+
+                        return ReturnCode.Ok;
+                    }
+                    catch (Exception e)
+                    {
+                        error = e;
+                    }
+                    finally
+                    {
+                        #region Free Error String
+                        if (pError != IntPtr.Zero)
+                        {
+                            freeMemory(pError);
+                            pError = IntPtr.Zero;
+                        }
+                        #endregion
+
+                        ///////////////////////////////////////////////////////
+
+                        #region Free Script Tokens Array
+                        if (pTokens != IntPtr.Zero)
+                        {
+                            freeMemory(pTokens);
+                            pTokens = IntPtr.Zero;
+                        }
+                        #endregion
+
+                        ///////////////////////////////////////////////////////
+
+                        #region Maybe Compact Native Heap
+                        /* IGNORED */
+                        MaybeCompactNativeHeap();
+                        #endregion
+                    }
+                }
+                else
+                {
+                    error = String.Format(
+                        "one or more required functions are unavailable: " +
+                        "{0} or {1}", typeof(Eagle_FreeMemory).Name,
+                        typeof(Eagle_ParseScript).Name);
+                }
+            }
+            finally
+            {
+                ExitNativeCall();
+            }
+
+            return ReturnCode.Error;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        public static ReturnCode SubstituteBackslashes(
+            string text,
+            ref string result,
+            ref Result error
+            )
+        {
+            if (text == null)
+            {
+                error = "invalid text";
+                return ReturnCode.Error;
+            }
+
+            if (!EnterNativeCall())
+            {
+                error = "native utility library is being unloaded";
+                return ReturnCode.Error;
+            }
+
+            try
+            {
+                //
+                // NOTE: The native utility library is reentrant; therefore,
+                //       no lock is held here.  Instead, grab the delegates
+                //       once, so they cannot change during this call.
+                //
+                Eagle_FreeMemory freeMemory = nativeFreeMemory;
+                Eagle_SubstBackslashes substBackslashes = nativeSubstBackslashes;
+
+                if ((freeMemory != null) && (substBackslashes != null))
+                {
+                    IntPtr pText = IntPtr.Zero;
+                    IntPtr pError = IntPtr.Zero;
+
+                    try
+                    {
+                        IntPtr resultLength = IntPtr.Zero;
+
+                        ReturnCode code = substBackslashes(
+                            new IntPtr(text.Length), text, ref resultLength,
+                            ref pText, ref pError);
+
+                        Interlocked.Increment(ref substCount);
+
+                        if (code != ReturnCode.Ok)
+                        {
+                            error = Marshal.PtrToStringUni(pError);
+                            return code;
+                        }
+
+                        long length = resultLength.ToInt64();
+
+                        //
+                        // NOTE: Backslash substitution never produces more
+                        //       characters than it consumes.
+                        //
+                        if (!IsValidSizeT(length) || (length > text.Length))
+                        {
+                            error = String.Format(
+                                "bad length of substituted text: {0}",
+                                length);
+
+                            return ReturnCode.Error;
+                        }
+
+                        result = Marshal.PtrToStringUni(pText, (int)length);
+                        return ReturnCode.Ok;
+                    }
+                    catch (Exception e)
+                    {
+                        error = e;
+                    }
+                    finally
+                    {
+                        #region Free Error String
+                        if (pError != IntPtr.Zero)
+                        {
+                            freeMemory(pError);
+                            pError = IntPtr.Zero;
+                        }
+                        #endregion
+
+                        ///////////////////////////////////////////////////////
+
+                        #region Free Substituted Text
+                        if (pText != IntPtr.Zero)
+                        {
+                            freeMemory(pText);
+                            pText = IntPtr.Zero;
+                        }
+                        #endregion
+
+                        ///////////////////////////////////////////////////////
+
+                        #region Maybe Compact Native Heap
+                        /* IGNORED */
+                        MaybeCompactNativeHeap();
+                        #endregion
+                    }
+                }
+                else
+                {
+                    error = String.Format(
+                        "one or more required functions are unavailable: " +
+                        "{0} or {1}", typeof(Eagle_FreeMemory).Name,
+                        typeof(Eagle_SubstBackslashes).Name);
+                }
+            }
+            finally
+            {
+                ExitNativeCall();
+            }
+
+            return ReturnCode.Error;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        public static ReturnCode ParseNumbers(
+            string text,
+            ref long[] values,
+            ref Result error
+            )
+        {
+            if (text == null)
+            {
+                error = "invalid list";
+                return ReturnCode.Error;
+            }
+
+            if (!EnterNativeCall())
+            {
+                error = "native utility library is being unloaded";
+                return ReturnCode.Error;
+            }
+
+            try
+            {
+                //
+                // NOTE: The native utility library is reentrant; therefore,
+                //       no lock is held here.  Instead, grab the delegates
+                //       once, so they cannot change during this call.
+                //
+                Eagle_FreeMemory freeMemory = nativeFreeMemory;
+                Eagle_ParseNumbers parseNumbers = nativeParseNumbers;
+
+                if ((freeMemory != null) && (parseNumbers != null))
+                {
+                    IntPtr pValues = IntPtr.Zero;
+                    IntPtr pError = IntPtr.Zero;
+
+                    try
+                    {
+                        IntPtr elementCount = IntPtr.Zero;
+
+                        ReturnCode code = parseNumbers(
+                            new IntPtr(text.Length), text, ref elementCount,
+                            ref pValues, ref pError);
+
+                        Interlocked.Increment(ref numberCount);
+
+                        if (code != ReturnCode.Ok)
+                        {
+                            error = Marshal.PtrToStringUni(pError);
+                            return code;
+                        }
+
+                        long count = elementCount.ToInt64();
+
+                        if (!IsValidSizeT(count))
+                        {
+                            error = String.Format(
+                                "bad number of list elements: {0}",
+                                count);
+
+                            return ReturnCode.Error;
+                        }
+
+                        long[] localValues = new long[(int)count];
+
+                        if (count > 0)
+                            Marshal.Copy(pValues, localValues, 0, (int)count);
+
+                        values = localValues;
+                        return ReturnCode.Ok;
+                    }
+                    catch (Exception e)
+                    {
+                        error = e;
+                    }
+                    finally
+                    {
+                        #region Free Error String
+                        if (pError != IntPtr.Zero)
+                        {
+                            freeMemory(pError);
+                            pError = IntPtr.Zero;
+                        }
+                        #endregion
+
+                        ///////////////////////////////////////////////////////
+
+                        #region Free Number Values Array
+                        if (pValues != IntPtr.Zero)
+                        {
+                            freeMemory(pValues);
+                            pValues = IntPtr.Zero;
+                        }
+                        #endregion
+
+                        ///////////////////////////////////////////////////////
+
+                        #region Maybe Compact Native Heap
+                        /* IGNORED */
+                        MaybeCompactNativeHeap();
+                        #endregion
+                    }
+                }
+                else
+                {
+                    error = String.Format(
+                        "one or more required functions are unavailable: " +
+                        "{0} or {1}", typeof(Eagle_FreeMemory).Name,
+                        typeof(Eagle_ParseNumbers).Name);
+                }
+            }
+            finally
+            {
+                ExitNativeCall();
+            }
+
+            return ReturnCode.Error;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        public static ReturnCode SortList(
+            StringList list,
+            bool integer,
+            bool ascending,
+            bool noCase,
+            ref StringList result,
+            ref Result error
+            )
+        {
+            if (list == null)
+            {
+                error = "invalid list";
+                return ReturnCode.Error;
+            }
+
+            if (!EnterNativeCall())
+            {
+                error = "native utility library is being unloaded";
+                return ReturnCode.Error;
+            }
+
+            try
+            {
+                //
+                // NOTE: The native utility library is reentrant; therefore,
+                //       no lock is held here.  Instead, grab the delegates
+                //       once, so they cannot change during this call.
+                //
+                Eagle_FreeMemory freeMemory = nativeFreeMemory;
+                Eagle_SortList sortList = nativeSortList;
+
+                if ((freeMemory != null) && (sortList != null))
+                {
+                    IntPtr pIndexes = IntPtr.Zero;
+                    IntPtr pError = IntPtr.Zero;
+
+                    try
+                    {
+                        int flags = integer ? sortInteger : sortAscii;
+
+                        if (!ascending)
+                            flags |= sortDecreasing;
+
+                        if (noCase)
+                            flags |= sortNoCase;
+
+                        int count = list.Count;
+
+#if NATIVE_UTILITY_BSTR
+                        ReturnCode code = sortList(
+                            new IntPtr(count), null, ToStringArray(list),
+                            flags, ref pIndexes, ref pError);
+#else
+                        ReturnCode code = sortList(
+                            new IntPtr(count), ToLengthArray(list),
+                            ToStringArray(list), flags, ref pIndexes,
+                            ref pError);
+#endif
+
+                        Interlocked.Increment(ref sortCount);
+
+                        if (code != ReturnCode.Ok)
+                        {
+                            error = Marshal.PtrToStringUni(pError);
+                            return code;
+                        }
+
+                        //
+                        // NOTE: The native code returns the original index
+                        //       of each element, in sorted order.  Make sure
+                        //       that it really is a permutation before any
+                        //       of the elements are used.
+                        //
+                        StringList localResult = new StringList(count);
+                        bool[] seen = new bool[count];
+
+                        for (int index = 0; index < count; index++)
+                        {
+                            long elementIndex = ReadSizeT(
+                                pIndexes, (long)index * IntPtr.Size);
+
+                            if ((elementIndex < 0) ||
+                                (elementIndex >= count) ||
+                                seen[(int)elementIndex])
+                            {
+                                error = String.Format(
+                                    "bad sorted list element index: {0}",
+                                    elementIndex);
+
+                                return ReturnCode.Error;
+                            }
+
+                            seen[(int)elementIndex] = true;
+                            localResult.Add(list[(int)elementIndex]);
+                        }
+
+                        result = localResult;
+                        return ReturnCode.Ok;
+                    }
+                    catch (Exception e)
+                    {
+                        error = e;
+                    }
+                    finally
+                    {
+                        #region Free Error String
+                        if (pError != IntPtr.Zero)
+                        {
+                            freeMemory(pError);
+                            pError = IntPtr.Zero;
+                        }
+                        #endregion
+
+                        ///////////////////////////////////////////////////////
+
+                        #region Free Sorted Indexes Array
+                        if (pIndexes != IntPtr.Zero)
+                        {
+                            freeMemory(pIndexes);
+                            pIndexes = IntPtr.Zero;
+                        }
+                        #endregion
+
+                        ///////////////////////////////////////////////////////
+
+                        #region Maybe Compact Native Heap
+                        /* IGNORED */
+                        MaybeCompactNativeHeap();
+                        #endregion
+                    }
+                }
+                else
+                {
+                    error = String.Format(
+                        "one or more required functions are unavailable: " +
+                        "{0} or {1}", typeof(Eagle_FreeMemory).Name,
+                        typeof(Eagle_SortList).Name);
+                }
+            }
+            finally
+            {
+                ExitNativeCall();
             }
 
             return ReturnCode.Error;
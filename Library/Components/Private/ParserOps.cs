@@ -11,14 +11,17 @@
 
 using System;
 using System.Collections.Generic;
+using System.Globalization;
 using System.Text;
 using System.Text.RegularExpressions;
 using System.Threading;
 using Eagle._Attributes;
 using Eagle._Components.Public;
+using Eagle._Constants;
 using Eagle._Containers.Public;
 using Eagle._Interfaces.Private;
 using Eagle._Interfaces.Public;
+using SharedStringOps = Eagle._Components.Shared.StringOps;
 
 namespace Eagle._Components.Private
 {
@@ -33,6 +36,11 @@ namespace Eagle._Components.Private
         //
         internal static bool UseNativeSplitList = false;
         internal static bool UseNativeJoinList = false;
+        internal static bool UseNativeStringMatch = false;
+        internal static bool UseNativeParseScript = false;
+        internal static bool UseNativeSubstitute = false;
+        internal static bool UseNativeParseNumbers = false;
+        internal static bool UseNativeSortList = false;
 
         ///////////////////////////////////////////////////////////////////////
 
@@ -51,6 +59,13 @@ namespace Eagle._Components.Private
 
         internal static long nativeSplitCount;
         internal static long nativeJoinCount;
+        internal static long nativeQueryCount;
+        internal static long nativeEditCount;
+        internal static long nativeMatchCount;
+        internal static long nativeParseCount;
+        internal static long nativeSubstCount;
+        internal static long nativeNumberCount;
+        internal static long nativeSortCount;
 
         ///////////////////////////////////////////////////////////////////////
 
@@ -93,6 +108,36 @@ namespace Eagle._Components.Private
                     UseNativeJoinList.ToString());
             }
 
+            if (empty || UseNativeStringMatch)
+            {
+                localList.Add("UseNativeStringMatch",
+                    UseNativeStringMatch.ToString());
+            }
+
+            if (empty || UseNativeParseScript)
+            {
+                localList.Add("UseNativeParseScript",
+                    UseNativeParseScript.ToString());
+            }
+
+            if (empty || UseNativeSubstitute)
+            {
+                localList.Add("UseNativeSubstitute",
+                    UseNativeSubstitute.ToString());
+            }
+
+            if (empty || UseNativeParseNumbers)
+            {
+                localList.Add("UseNativeParseNumbers",
+                    UseNativeParseNumbers.ToString());
+            }
+
+            if (empty || UseNativeSortList)
+            {
+                localList.Add("UseNativeSortList",
+                    UseNativeSortList.ToString());
+            }
+
             if (empty || (NativeMinimumTextLength > 0))
             {
                 localList.Add("NativeMinimumTextLength",
@@ -145,6 +190,48 @@ namespace Eagle._Components.Private
 
             if (empty || (localCount > 0))
                 localList.Add("NativeJoinCount", localCount.ToString());
+
+            localCount = Interlocked.CompareExchange(
+                ref nativeQueryCount, 0, 0);
+
+            if (empty || (localCount > 0))
+                localList.Add("NativeQueryCount", localCount.ToString());
+
+            localCount = Interlocked.CompareExchange(
+                ref nativeEditCount, 0, 0);
+
+            if (empty || (localCount > 0))
+                localList.Add("NativeEditCount", localCount.ToString());
+
+            localCount = Interlocked.CompareExchange(
+                ref nativeMatchCount, 0, 0);
+
+            if (empty || (localCount > 0))
+                localList.Add("NativeMatchCount", localCount.ToString());
+
+            localCount = Interlocked.CompareExchange(
+                ref nativeParseCount, 0, 0);
+
+            if (empty || (localCount > 0))
+                localList.Add("NativeParseCount", localCount.ToString());
+
+            localCount = Interlocked.CompareExchange(
+                ref nativeSubstCount, 0, 0);
+
+            if (empty || (localCount > 0))
+                localList.Add("NativeSubstCount", localCount.ToString());
+
+            localCount = Interlocked.CompareExchange(
+                ref nativeNumberCount, 0, 0);
+
+            if (empty || (localCount > 0))
+                localList.Add("NativeNumberCount", localCount.ToString());
+
+            localCount = Interlocked.CompareExchange(
+                ref nativeSortCount, 0, 0);
+
+            if (empty || (localCount > 0))
+                localList.Add("NativeSortCount", localCount.ToString());
 #endif
 
             if (localList.Count > 0)
@@ -167,6 +254,11 @@ namespace Eagle._Components.Private
         {
             UseNativeSplitList = enable;
             UseNativeJoinList = enable;
+            UseNativeStringMatch = enable;
+            UseNativeParseScript = enable;
+            UseNativeSubstitute = enable;
+            UseNativeParseNumbers = enable;
+            UseNativeSortList = enable;
         }
 #endif
         #endregion
@@ -201,9 +293,8 @@ namespace Eagle._Components.Private
                 // BUGFIX: *DEADLOCK* Prevent deadlocks here by using
                 //         the TryLock pattern.
                 //
-                NativeUtility.TryLock(ref locked); /* TRANSACTIONAL */
-
-                if (locked && NativeUtility.IsAvailable(interpreter))
+                if (NativeUtility.TryIsAvailable(
+                        interpreter, ref locked)) /* TRANSACTIONAL */
                 {
                     //
                     // NOTE: Convert a null string into a null list
@@ -345,6 +436,136 @@ namespace Eagle._Components.Private
                 NativeUtility.ExitLock(ref locked); /* TRANSACTIONAL */
             }
         }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        private static ReturnCode NativeSplitLists(
+            Interpreter interpreter, /* OPTIONAL */
+            IList<string> texts,
+            bool readOnly,
+            ref StringList[] lists,
+            ref Result error
+            ) /* THREAD-SAFE */
+        {
+            bool locked = false;
+
+            try
+            {
+                //
+                // BUGFIX: *DEADLOCK* Prevent deadlocks here by using
+                //         the TryLock pattern.
+                //
+                if (NativeUtility.TryIsAvailable(
+                        interpreter, ref locked)) /* TRANSACTIONAL */
+                {
+                    int listCount = texts.Count;
+                    StringList[] localLists = new StringList[listCount];
+                    StringList batchTexts = new StringList(listCount);
+                    IntList batchIndexes = new IntList(listCount);
+
+#if LIST_CACHE
+                    bool useCache = (interpreter != null);
+#endif
+
+                    for (int index = 0; index < listCount; index++)
+                    {
+                        string text = texts[index];
+
+#if LIST_CACHE
+                        StringList localList = StringList.MaybeReadOnly(
+                            readOnly);
+
+                        if (useCache && interpreter.GetCachedStringList(
+                                text, ref localList))
+                        {
+                            if (!readOnly && (localList != null))
+                            {
+                                if (!interpreter.RemoveCachedStringList(
+                                        localList.CacheKey))
+                                {
+                                    localList = new StringList(localList);
+                                }
+                            }
+
+                            localLists[index] = localList;
+                            continue;
+                        }
+
+                        localLists[index] = localList;
+#endif
+
+                        batchTexts.Add(text);
+                        batchIndexes.Add(index);
+                    }
+
+                    int batchCount = batchTexts.Count;
+
+                    if (batchCount > 0)
+                    {
+                        StringList[] batchLists = new StringList[batchCount];
+
+                        for (int index = 0; index < batchCount; index++)
+                            batchLists[index] = localLists[batchIndexes[index]];
+
+                        Result localError = null;
+
+                        if (NativeUtility.SplitLists(
+                                batchTexts, ref batchLists,
+                                ref localError) != ReturnCode.Ok)
+                        {
+                            TraceOps.DebugTrace(String.Format(
+                                "NativeSplitLists: {0}", localError),
+                                typeof(ParserOps<T>).Name,
+                                TracePriority.NativeError);
+
+                            error = localError;
+                            return ReturnCode.Error;
+                        }
+
+                        for (int index = 0; index < batchCount; index++)
+                        {
+                            StringList localList = batchLists[index];
+
+#if LIST_CACHE
+                            if (useCache)
+                            {
+                                string text = batchTexts[index];
+
+                                if (localList != null)
+                                    localList.CacheKey = text;
+
+                                if (interpreter.AddCachedStringList(
+                                        text, localList) &&
+                                    !readOnly && (localList != null))
+                                {
+                                    localList = new StringList(localList);
+                                }
+                            }
+#endif
+
+                            localLists[batchIndexes[index]] = localList;
+                        }
+                    }
+
+                    lists = localLists;
+                    return ReturnCode.Ok;
+                }
+                else if (!locked)
+                {
+                    error = "unable to acquire native utility lock";
+                }
+                else
+                {
+                    error = "native utility not available";
+                }
+
+                return ReturnCode.Error;
+            }
+            finally
+            {
+                NativeUtility.ExitLock(ref locked); /* TRANSACTIONAL */
+            }
+        }
 #endif
         #endregion
 
@@ -630,216 +851,124 @@ namespace Eagle._Components.Private
                 interpreter, text, startIndex, length, readOnly,
                 ref list, ref error);
         }
-        #endregion
 
         ///////////////////////////////////////////////////////////////////////
 
-        #region Native List Joining
 #if NATIVE && NATIVE_UTILITY
-        private static ReturnCode FilterList(
-            IList<T> inputList,
-            StringList outputList,
-            int startIndex,
-            int stopIndex,
-            ToStringFlags toStringFlags,
-            string pattern,
-            bool noCase,
-            ref Result error
+        private static bool ShouldUseNativeSplitLists(
+            IList<string> texts
             )
         {
-            if (inputList == null)
-            {
-                error = "invalid input list";
-                return ReturnCode.Error;
-            }
-
-            if (outputList == null)
-            {
-                error = "invalid output list";
-                return ReturnCode.Error;
-            }
+            if (!ParserOpsData.UseNativeSplitList)
+                return false;
 
             //
-            // BUGFIX: Skip everything if the input list is empty.
+            // NOTE: Batching only helps when there are several lists to
+            //       split; therefore, the minimum text length applies to
+            //       all of them together, while the maximum text length
+            //       still applies to each one.
             //
-            int count = inputList.Count;
+            if ((texts == null) || (texts.Count < 2))
+                return false;
 
-            if (count == 0)
-                return ReturnCode.Ok;
+            int maximumLength = ParserOpsData.NativeMaximumTextLength;
+            long totalLength = 0;
 
-            if (!ListOps.CheckStartAndStopIndex(
-                    0, count - 1, ref startIndex, ref stopIndex,
-                    ref error))
+            foreach (string text in texts)
             {
-                return ReturnCode.Error;
-            }
+                if (text == null)
+                    return false;
 
-            for (int index = startIndex; index <= stopIndex; index++)
-            {
-                T element = inputList[index];
-                string elementString;
+                if ((maximumLength > 0) && (text.Length > maximumLength))
+                    return false;
 
-                if (element != null)
-                {
-                    if (toStringFlags != ToStringFlags.None)
-                    {
-                        IToString toString = element as IToString;
+                totalLength += text.Length;
+            }
 
-                        if (toString != null)
-                        {
-                            elementString = toString.ToString(
-                                toStringFlags);
-                        }
-                        else
-                        {
-                            elementString = element.ToString();
-                        }
-                    }
-                    else
-                    {
-                        elementString = element.ToString();
-                    }
-                }
-                else
-                {
-                    elementString = String.Empty;
-                }
+            int minimumLength = ParserOpsData.NativeMinimumTextLength;
 
-                //
-                // NOTE: Match the string representation and add
-                //       the original element and not the string
-                //       representation because this is a generic
-                //       list, not a StringList.
-                //
-                if ((pattern == null) || StringOps.Match(
-                        null, StringOps.DefaultMatchMode,
-                        elementString, pattern, noCase))
-                {
-                    outputList.Add(elementString);
-                }
-            }
+            if ((minimumLength > 0) && (totalLength < minimumLength))
+                return false;
 
-            return ReturnCode.Ok;
+            return true;
         }
+#endif
 
         ///////////////////////////////////////////////////////////////////////
 
-        private static ReturnCode FilterList(
-            IList<T> inputList,
-            StringList outputList,
-            int startIndex,
-            int stopIndex,
-            ToStringFlags toStringFlags,
-            string regExPattern,
-            RegexOptions regExOptions,
+        //
+        // NOTE: This method is used to split several lists at once, e.g.
+        //       the value lists used by [foreach].  When possible, all of
+        //       them are split using one call into the native utility
+        //       library; otherwise, they are split one at a time.
+        //
+        public static ReturnCode SplitLists(
+            Interpreter interpreter, /* OPTIONAL */
+            IList<string> texts,
+            bool readOnly,
+            ref StringList[] lists,
             ref Result error
-            )
+            ) /* ENTRY-POINT, THREAD-SAFE */
         {
-            if (inputList == null)
+            if (texts == null)
             {
-                error = "invalid input list";
+                error = "invalid text list";
                 return ReturnCode.Error;
             }
 
-            if (outputList == null)
+#if NATIVE && NATIVE_UTILITY
+            if (ShouldUseNativeSplitLists(texts))
             {
-                error = "invalid output list";
-                return ReturnCode.Error;
-            }
-
-            //
-            // BUGFIX: Skip everything if the input list is empty.
-            //
-            int count = inputList.Count;
+                ReturnCode code;
+                StringList[] localLists = null;
+                Result localError = null;
 
-            if (count == 0)
-                return ReturnCode.Ok;
+                code = NativeSplitLists(
+                    interpreter, texts, readOnly, ref localLists,
+                    ref localError);
 
-            if (!ListOps.CheckStartAndStopIndex(
-                    0, count - 1, ref startIndex, ref stopIndex,
-                    ref error))
-            {
-                return ReturnCode.Error;
-            }
+                if (code == ReturnCode.Ok)
+                {
+                    Interlocked.Increment(
+                        ref ParserOpsData.nativeSplitCount);
 
-            Regex regEx = null;
+                    lists = localLists;
+                    return code;
+                }
 
-            try
-            {
-                if (regExPattern != null)
-                {
-                    regEx = RegExOps.Create(
-                        regExPattern, regExOptions); /* throw */
-                }
-            }
-            catch
-            {
-                // do nothing.
+                if (!ParserOpsData.NoComplain && (localError != null))
+                    DebugOps.Complain(code, localError);
             }
+#endif
 
-            if ((regExPattern != null) && (regEx == null))
-            {
-                error = "invalid regular expression";
-                return ReturnCode.Error;
-            }
+            int listCount = texts.Count;
+            StringList[] managedLists = new StringList[listCount];
 
-            for (int index = startIndex; index <= stopIndex; index++)
+            for (int index = 0; index < listCount; index++)
             {
-                T element = inputList[index];
-                string elementString;
-
-                if (element != null)
-                {
-                    if (toStringFlags != ToStringFlags.None)
-                    {
-                        IToString toString = element as IToString;
-
-                        if (toString != null)
-                        {
-                            elementString = toString.ToString(
-                                toStringFlags);
-                        }
-                        else
-                        {
-                            elementString = element.ToString();
-                        }
-                    }
-                    else
-                    {
-                        elementString = element.ToString();
-                    }
-                }
-                else
-                {
-                    elementString = String.Empty;
-                }
+                ReturnCode code = SplitList(
+                    interpreter, texts[index], 0, Length.Invalid,
+                    readOnly, ref managedLists[index], ref error);
 
-                //
-                // NOTE: Match the string representation and add
-                //       the original element and not the string
-                //       representation because this is a generic
-                //       list, not a StringList.
-                //
-                if ((regEx == null) || regEx.IsMatch(elementString))
-                    outputList.Add(elementString);
+                if (code != ReturnCode.Ok)
+                    return code;
             }
 
+            lists = managedLists;
             return ReturnCode.Ok;
         }
+        #endregion
 
         ///////////////////////////////////////////////////////////////////////
 
-        private static ReturnCode NativeListToString(
-            IList<T> list,
-            int startIndex,
-            int stopIndex,
-            ToStringFlags toStringFlags,
-            string separator,
-            string pattern,
-            bool noCase,
-            ref string text,
+        #region Native List Querying
+#if NATIVE && NATIVE_UTILITY
+        private static ReturnCode NativeCountList(
+            Interpreter interpreter, /* OPTIONAL */
+            string text,
+            ref int count,
             ref Result error
-            )
+            ) /* THREAD-SAFE */
         {
             bool locked = false;
 
@@ -849,152 +978,57 @@ namespace Eagle._Components.Private
                 // BUGFIX: *DEADLOCK* Prevent deadlocks here by using
                 //         the TryLock pattern.
                 //
-                Result localError; /* REUSED */
-
-                NativeUtility.TryLock(ref locked); /* TRANSACTIONAL */
-
-                if (locked && NativeUtility.IsAvailable(null))
+                if (NativeUtility.TryIsAvailable(
+                        interpreter, ref locked)) /* TRANSACTIONAL */
                 {
+#if LIST_CACHE
                     //
-                    // NOTE: Convert a null list into an empty string
-                    //       without actually calling into the native
-                    //       utility library.
+                    // NOTE: When the list has already been split, just
+                    //       use it; there is no need to scan it again.
                     //
-                    if (list == null)
+                    if (interpreter != null)
                     {
-                        text = String.Empty;
-                        return ReturnCode.Ok;
-                    }
-
-                    StringList localList;
-
-                    if ((startIndex >= 0) || (stopIndex >= 0) ||
-                        (toStringFlags != ToStringFlags.None) ||
-                        (pattern != null))
-                    {
-                        localList = new StringList(list.Count);
-                        localError = null;
+                        StringList localList = null;
 
-                        if (FilterList(
-                                list, localList, startIndex, stopIndex,
-                                toStringFlags, pattern, noCase,
-                                ref localError) != ReturnCode.Ok)
+                        if (interpreter.GetCachedStringList(
+                                text, ref localList) &&
+                            (localList != null))
                         {
-                            TraceOps.DebugTrace(String.Format(
-                                "NativeListToString ({0}): {1}",
-                                MatchMode.Glob, localError),
-                                typeof(ParserOps<T>).Name,
-                                TracePriority.NativeError2);
-
-                            error = localError;
-                            return ReturnCode.Error;
+                            count = localList.Count;
+                            return ReturnCode.Ok;
                         }
                     }
-#if !MONO_BUILD
-                    //
-                    // HACK: *MONO* The Mono C# compiler cannot handle
-                    //       this block of code.  It gives the following
-                    //       warnings:
-                    //
-                    //       warning CS0184: The given expression is
-                    //       never of the provided
-                    //       (`Eagle._Containers.Public.StringList')
-                    //       type
-                    //
-                    //       warning CS0162: Unreachable code detected
-                    //
-                    else if (list is StringList)
-                    {
-                        localList = list as StringList;
-                    }
 #endif
-                    else
-                    {
-                        localList = new StringList(list);
-                    }
-
-                    string localText = null;
-
-                    localError = null;
-
-                    if (NativeUtility.JoinList(
-                            localList, ref localText,
-                            ref localError) == ReturnCode.Ok)
-                    {
-                        text = localText;
-                        return ReturnCode.Ok;
-                    }
-                    else
-                    {
-                        TraceOps.DebugTrace(String.Format(
-                            "NativeListToString ({0}): {1}",
-                            MatchMode.Glob, localError),
-                            typeof(ParserOps<T>).Name,
-                            TracePriority.NativeError);
 
-                        error = localError;
-                        return ReturnCode.Error;
-                    }
+                    return NativeUtility.CountList(
+                        text, ref count, ref error);
                 }
                 else if (!locked)
                 {
-                    localError = "unable to acquire native utility lock";
-
-                    TraceOps.DebugTrace(String.Format(
-                        "NativeListToString ({0}): {1}",
-                        MatchMode.Glob, localError),
-                        typeof(ParserOps<T>).Name,
-                        TracePriority.LockWarning);
-
-                    //
-                    // WARNING: Setting this error message will
-                    //          cause spurious complaints to be
-                    //          seen on secondary threads.
-                    //
-                    error = localError;
+                    error = "unable to acquire native utility lock";
                 }
                 else
                 {
-                    localError = "native utility not available";
-
-#if DEBUG && VERBOSE
-                    TraceOps.DebugTrace(String.Format(
-                        "NativeListToString ({0}): {1}",
-                        MatchMode.Glob, localError),
-                        typeof(ParserOps<T>).Name,
-                        TracePriority.NativeError3);
-#endif
-
-                    //
-                    // HACK: This is not a real "error", per se.
-                    //       It simply means the native utility
-                    //       (library) is not available and the
-                    //       managed fallback should be used.
-                    //
-                    error = localError;
+                    error = "native utility not available";
                 }
 
                 return ReturnCode.Error;
             }
             finally
             {
-                NativeUtility.ExitLock(ref locked);
+                NativeUtility.ExitLock(ref locked); /* TRANSACTIONAL */
             }
         }
 
         ///////////////////////////////////////////////////////////////////////
 
-        private static ReturnCode NativeListToString(
-            IList<T> list,
-            int startIndex,
-            int stopIndex,
-            ToStringFlags toStringFlags,
-            string separator,
-            string regExPattern,
-            RegexOptions regExOptions,
-            ref string text,
+        private static ReturnCode NativeGetListElement(
+            Interpreter interpreter, /* OPTIONAL */
+            string text,
+            int index,
+            ref string element,
             ref Result error
-            )
+            ) /* THREAD-SAFE */
         {
             bool locked = false;
 
@@ -1004,129 +1038,338 @@ namespace Eagle._Components.Private
                 // BUGFIX: *DEADLOCK* Prevent deadlocks here by using
                 //         the TryLock pattern.
                 //
-                Result localError; /* REUSED */
-
-                NativeUtility.TryLock(ref locked); /* TRANSACTIONAL */
-
-                if (locked && NativeUtility.IsAvailable(null))
+                if (NativeUtility.TryIsAvailable(
+                        interpreter, ref locked)) /* TRANSACTIONAL */
                 {
+#if LIST_CACHE
                     //
-                    // NOTE: Convert a null list into an empty string
-                    //       without actually calling into the native
-                    //       utility library.
+                    // NOTE: When the list has already been split, just
+                    //       use it; there is no need to scan it again.
                     //
-                    if (list == null)
-                    {
-                        text = String.Empty;
-                        return ReturnCode.Ok;
-                    }
-
-                    StringList localList;
-
-                    if ((startIndex >= 0) || (stopIndex >= 0) ||
-                        (toStringFlags != ToStringFlags.None) ||
-                        (regExPattern != null))
+                    if (interpreter != null)
                     {
-                        localList = new StringList(list.Count);
-                        localError = null;
+                        StringList localList = null;
 
-                        if (FilterList(
-                                list, localList, startIndex, stopIndex,
-                                toStringFlags, regExPattern, regExOptions,
-                                ref localError) != ReturnCode.Ok)
+                        if (interpreter.GetCachedStringList(
+                                text, ref localList) &&
+                            (localList != null))
                         {
-                            TraceOps.DebugTrace(String.Format(
-                                "NativeListToString ({0}): {1}",
-                                MatchMode.RegExp, localError),
-                                typeof(ParserOps<T>).Name,
-                                TracePriority.NativeError2);
+                            element = (index < localList.Count) ?
+                                localList[index] : String.Empty;
 
-                            error = localError;
-                            return ReturnCode.Error;
+                            return ReturnCode.Ok;
                         }
                     }
-#if !MONO_BUILD
-                    //
-                    // HACK: *MONO* The Mono C# compiler cannot handle
-                    //       this block of code.  It gives the following
-                    //       warnings:
-                    //
-                    //       warning CS0184: The given expression is
-                    //       never of the provided
-                    //       (`Eagle._Containers.Public.StringList')
-                    //       type
-                    //
-                    //       warning CS0162: Unreachable code detected
-                    //
-                    else if (list is StringList)
-                    {
-                        localList = list as StringList;
-                    }
 #endif
-                    else
-                    {
-                        localList = new StringList(list);
-                    }
 
-                    string localText = null;
+                    return NativeUtility.GetListElement(
+                        text, index, ref element, ref error);
+                }
+                else if (!locked)
+                {
+                    error = "unable to acquire native utility lock";
+                }
+                else
+                {
+                    error = "native utility not available";
+                }
 
-                    localError = null;
+                return ReturnCode.Error;
+            }
+            finally
+            {
+                NativeUtility.ExitLock(ref locked); /* TRANSACTIONAL */
+            }
+        }
+#endif
+        #endregion
 
-                    if (NativeUtility.JoinList(
-                            localList, ref localText,
-                            ref localError) == ReturnCode.Ok)
+        ///////////////////////////////////////////////////////////////////////
+
+        #region List Querying
+        //
+        // NOTE: These methods are used to answer simple questions about a
+        //       list (i.e. how many elements it has and what one of them
+        //       is) without splitting it into a StringList.  They return
+        //       false if the answer cannot be obtained this way, including
+        //       when the list is malformed; in that case, the caller must
+        //       fallback to splitting the list, which will produce the
+        //       appropriate error message.
+        //
+        public static bool TryCountList(
+            Interpreter interpreter, /* OPTIONAL */
+            string text,
+            ref int count
+            ) /* ENTRY-POINT, THREAD-SAFE */
+        {
+#if NATIVE && NATIVE_UTILITY
+            if (ShouldUseNativeSplitList(text, 0, Length.Invalid))
+            {
+                ReturnCode code;
+                int localCount = 0;
+                Result localError = null;
+
+                code = NativeCountList(
+                    interpreter, text, ref localCount, ref localError);
+
+                if (code == ReturnCode.Ok)
+                {
+                    Interlocked.Increment(
+                        ref ParserOpsData.nativeQueryCount);
+
+                    count = localCount;
+                    return true;
+                }
+
+                if (!ParserOpsData.NoComplain && (localError != null))
+                    DebugOps.Complain(code, localError);
+            }
+#endif
+
+            return false;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        public static bool TryGetListElement(
+            Interpreter interpreter, /* OPTIONAL */
+            string text,
+            int index,
+            ref string element
+            ) /* ENTRY-POINT, THREAD-SAFE */
+        {
+#if NATIVE && NATIVE_UTILITY
+            if ((index >= 0) &&
+                ShouldUseNativeSplitList(text, 0, Length.Invalid))
+            {
+                ReturnCode code;
+                string localElement = null;
+                Result localError = null;
+
+                code = NativeGetListElement(
+                    interpreter, text, index, ref localElement,
+                    ref localError);
+
+                if (code == ReturnCode.Ok)
+                {
+                    Interlocked.Increment(
+                        ref ParserOpsData.nativeQueryCount);
+
+                    element = localElement;
+                    return true;
+                }
+
+                if (!ParserOpsData.NoComplain && (localError != null))
+                    DebugOps.Complain(code, localError);
+            }
+#endif
+
+            return false;
+        }
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////
+
+        #region Native List Editing
+#if NATIVE && NATIVE_UTILITY
+        private static ReturnCode NativeEditList(
+            Interpreter interpreter, /* OPTIONAL */
+            string text,
+            int firstIndex,
+            int count,
+            bool keep,
+            StringList list, /* OPTIONAL */
+            ref string result,
+            ref Result error
+            ) /* THREAD-SAFE */
+        {
+            bool locked = false;
+
+            try
+            {
+                //
+                // BUGFIX: *DEADLOCK* Prevent deadlocks here by using
+                //         the TryLock pattern.
+                //
+                if (NativeUtility.TryIsAvailable(
+                        interpreter, ref locked)) /* TRANSACTIONAL */
+                {
+                    if (keep)
                     {
-                        text = localText;
-                        return ReturnCode.Ok;
+                        return NativeUtility.GetListRange(
+                            text, firstIndex, firstIndex + count - 1,
+                            ref result, ref error);
                     }
                     else
                     {
-                        TraceOps.DebugTrace(String.Format(
-                            "NativeListToString ({0}): {1}",
-                            MatchMode.RegExp, localError),
-                            typeof(ParserOps<T>).Name,
-                            TracePriority.NativeError);
-
-                        error = localError;
-                        return ReturnCode.Error;
+                        return NativeUtility.ReplaceListRange(
+                            text, firstIndex, count, list, ref result,
+                            ref error);
                     }
                 }
                 else if (!locked)
                 {
-                    localError = "unable to acquire native utility lock";
+                    error = "unable to acquire native utility lock";
+                }
+                else
+                {
+                    error = "native utility not available";
+                }
 
-                    TraceOps.DebugTrace(String.Format(
-                        "NativeListToString ({0}): {1}",
-                        MatchMode.RegExp, localError),
-                        typeof(ParserOps<T>).Name,
-                        TracePriority.LockWarning);
+                return ReturnCode.Error;
+            }
+            finally
+            {
+                NativeUtility.ExitLock(ref locked); /* TRANSACTIONAL */
+            }
+        }
+#endif
+        #endregion
 
-                    //
-                    // WARNING: Setting this error message will
-                    //          cause spurious complaints to be
-                    //          seen on secondary threads.
-                    //
-                    error = localError;
+        ///////////////////////////////////////////////////////////////////////
+
+        #region List Editing
+        //
+        // NOTE: These methods are used to build a new list from part of an
+        //       existing one without splitting it into a StringList.  The
+        //       indexes must already be within range.  They return false if
+        //       the result cannot be obtained this way; in that case, the
+        //       caller must fallback to splitting the list.
+        //
+        public static bool TryGetListRange(
+            Interpreter interpreter, /* OPTIONAL */
+            string text,
+            int firstIndex,
+            int lastIndex,
+            ref string result
+            ) /* ENTRY-POINT, THREAD-SAFE */
+        {
+            if ((firstIndex < 0) || (lastIndex < firstIndex))
+                return false;
+
+            return TryEditList(
+                interpreter, text, firstIndex, lastIndex - firstIndex + 1,
+                true, null, ref result);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        public static bool TryReplaceListRange(
+            Interpreter interpreter, /* OPTIONAL */
+            string text,
+            int firstIndex,
+            int deleteCount,
+            StringList list, /* OPTIONAL */
+            ref string result
+            ) /* ENTRY-POINT, THREAD-SAFE */
+        {
+            if ((firstIndex < 0) || (deleteCount < 0))
+                return false;
+
+            return TryEditList(
+                interpreter, text, firstIndex, deleteCount, false, list,
+                ref result);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        private static bool TryEditList(
+            Interpreter interpreter, /* OPTIONAL */
+            string text,
+            int firstIndex,
+            int count,
+            bool keep,
+            StringList list, /* OPTIONAL */
+            ref string result
+            )
+        {
+#if NATIVE && NATIVE_UTILITY
+            if (ShouldUseNativeSplitList(text, 0, Length.Invalid))
+            {
+#if LIST_CACHE
+                //
+                // NOTE: When the list has already been split, editing
+                //       the cached list is faster; therefore, let the
+                //       caller do that instead.
+                //
+                if (interpreter != null)
+                {
+                    StringList localList = null;
+
+                    if (interpreter.GetCachedStringList(
+                            text, ref localList) && (localList != null))
+                    {
+                        return false;
+                    }
                 }
-                else
+#endif
+
+                ReturnCode code;
+                string localResult = null;
+                Result localError = null;
+
+                code = NativeEditList(
+                    interpreter, text, firstIndex, count, keep, list,
+                    ref localResult, ref localError);
+
+                if (code == ReturnCode.Ok)
                 {
-                    localError = "native utility not available";
+                    Interlocked.Increment(
+                        ref ParserOpsData.nativeEditCount);
 
-#if DEBUG && VERBOSE
-                    TraceOps.DebugTrace(String.Format(
-                        "NativeListToString ({0}): {1}",
-                        MatchMode.RegExp, localError),
-                        typeof(ParserOps<T>).Name,
-                        TracePriority.NativeError3);
+                    result = localResult;
+                    return true;
+                }
+
+                if (!ParserOpsData.NoComplain && (localError != null))
+                    DebugOps.Complain(code, localError);
+            }
 #endif
 
+            return false;
+        }
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////
+
+        #region Native String Matching
+#if NATIVE && NATIVE_UTILITY
+        private static ReturnCode NativeMatchList(
+            Interpreter interpreter, /* OPTIONAL */
+            StringList list,
+            string pattern,
+            bool noCase,
+            ref StringList matches,
+            ref Result error
+            ) /* THREAD-SAFE */
+        {
+            bool locked = false;
+
+            try
+            {
+                //
+                // BUGFIX: *DEADLOCK* Prevent deadlocks here by using
+                //         the TryLock pattern.
+                //
+                if (NativeUtility.TryIsAvailable(
+                        interpreter, ref locked)) /* TRANSACTIONAL */
+                {
                     //
-                    // HACK: This is not a real "error", per se.
-                    //       It simply means the native utility
-                    //       (library) is not available and the
-                    //       managed fallback should be used.
+                    // NOTE: The callers of this method match without
+                    //       an interpreter; therefore, the FixFor219233
+                    //       interpreter flag never applies.
                     //
-                    error = localError;
+                    return NativeUtility.MatchStrings(
+                        list, pattern, noCase, false, ref matches,
+                        ref error);
+                }
+                else if (!locked)
+                {
+                    error = "unable to acquire native utility lock";
+                }
+                else
+                {
+                    error = "native utility not available";
                 }
 
                 return ReturnCode.Error;
@@ -1141,296 +1384,1543 @@ namespace Eagle._Components.Private
 
         ///////////////////////////////////////////////////////////////////////
 
-        #region Managed List Joining
-        private static string ManagedListToString(
-            IList<T> list,
-            int startIndex,
-            int stopIndex,
-            ToStringFlags toStringFlags,
-            string separator,
+        #region String Matching
+#if NATIVE && NATIVE_UTILITY
+        private static bool ShouldUseNativeStringMatch(
+            int count,
             string pattern,
             bool noCase
             )
         {
-            Interlocked.Increment(
-                ref ParserOpsData.managedJoinCount);
+            if (!ParserOpsData.UseNativeStringMatch)
+                return false;
 
-            StringBuilder result = StringBuilderFactory.Create();
+            if (pattern == null)
+                return false;
 
-            if (list != null)
-            {
-                int count = list.Count;
+            int minimumCount = ParserOpsData.NativeMinimumListCount;
 
-                if (ListOps.CheckStartAndStopIndex(
-                        0, count - 1, ref startIndex, ref stopIndex))
+            if ((minimumCount > 0) && (count < minimumCount))
+                return false;
+
+            int maximumCount = ParserOpsData.NativeMaximumListCount;
+
+            if ((maximumCount > 0) && (count > maximumCount))
+                return false;
+
+            //
+            // NOTE: The native utility library only folds the ASCII
+            //       letters, whereas the managed code uses the rules
+            //       for the current culture.  Those only agree when
+            //       the pattern itself is pure ASCII.
+            //
+            if (noCase)
+            {
+                foreach (char character in pattern)
                 {
-                    for (int index = startIndex; index <= stopIndex; index++)
-                    {
-                        T element = list[index];
-                        string elementString;
+                    if (character > 0x7F)
+                        return false;
+                }
+            }
 
-                        if (element != null)
-                        {
-                            if (toStringFlags != ToStringFlags.None)
-                            {
-                                IToString toString = element as IToString;
+            return true;
+        }
 
-                                if (toString != null)
-                                {
-                                    elementString = toString.ToString(
-                                        toStringFlags);
-                                }
-                                else
-                                {
-                                    elementString = element.ToString();
-                                }
-                            }
-                            else
-                            {
-                                elementString = element.ToString();
-                            }
+        ///////////////////////////////////////////////////////////////////////
+
+        private static bool CanNativeStringMatchNoCase(
+            string text
+            )
+        {
+            if (text == null)
+                return true;
+
+            foreach (char character in text)
+            {
+                if (character <= 0x7F)
+                    continue;
+
+                //
+                // HACK: Some runtimes fold a few non-ASCII characters to
+                //       ASCII letters when ignoring case, e.g. the KELVIN
+                //       SIGN (U+212A) to "k".  The native utility library
+                //       never does that; therefore, the managed code must
+                //       be used to match any string containing them.
+                //
+                if ((Char.ToLower(character) <= 0x7F) ||
+                    (Char.ToUpperInvariant(character) <= 0x7F))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        //
+        // NOTE: This method is used to filter a large collection of strings
+        //       using a glob pattern, via one call into the native utility
+        //       library.  It returns false if that cannot be done, in which
+        //       case the caller must fallback to matching each string.
+        //
+        public static bool TryMatchList(
+            ICollection<string> collection,
+            string pattern,
+            bool noCase,
+            ref StringList matches
+            ) /* ENTRY-POINT, THREAD-SAFE */
+        {
+            if ((collection == null) ||
+                !ShouldUseNativeStringMatch(collection.Count, pattern, noCase))
+            {
+                return false;
+            }
+
+            if (noCase)
+            {
+                foreach (string text in collection)
+                {
+                    if (!CanNativeStringMatchNoCase(text))
+                        return false;
+                }
+            }
+
+            StringList list = collection as StringList;
+
+            if (list == null)
+                list = new StringList(collection);
+
+            ReturnCode code;
+            StringList localMatches = null;
+            Result localError = null;
+
+            code = NativeMatchList(
+                null, list, pattern, noCase, ref localMatches,
+                ref localError);
+
+            if (code == ReturnCode.Ok)
+            {
+                Interlocked.Increment(
+                    ref ParserOpsData.nativeMatchCount);
+
+                matches = localMatches;
+                return true;
+            }
+
+            if (!ParserOpsData.NoComplain && (localError != null))
+                DebugOps.Complain(code, localError);
+
+            return false;
+        }
+#endif
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////
+
+        #region Native List Joining
+#if NATIVE && NATIVE_UTILITY
+        private static ReturnCode FilterList(
+            IList<T> inputList,
+            StringList outputList,
+            int startIndex,
+            int stopIndex,
+            ToStringFlags toStringFlags,
+            string pattern,
+            bool noCase,
+            ref Result error
+            )
+        {
+            if (inputList == null)
+            {
+                error = "invalid input list";
+                return ReturnCode.Error;
+            }
+
+            if (outputList == null)
+            {
+                error = "invalid output list";
+                return ReturnCode.Error;
+            }
+
+            //
+            // BUGFIX: Skip everything if the input list is empty.
+            //
+            int count = inputList.Count;
+
+            if (count == 0)
+                return ReturnCode.Ok;
+
+            if (!ListOps.CheckStartAndStopIndex(
+                    0, count - 1, ref startIndex, ref stopIndex,
+                    ref error))
+            {
+                return ReturnCode.Error;
+            }
+
+            //
+            // NOTE: When there are enough elements, gather all of their
+            //       string representations and then match them using
+            //       one call into the native utility library.
+            //
+            StringList elementStrings = ShouldUseNativeStringMatch(
+                stopIndex - startIndex + 1, pattern, noCase) ?
+                    new StringList(stopIndex - startIndex + 1) : null;
+
+            for (int index = startIndex; index <= stopIndex; index++)
+            {
+                T element = inputList[index];
+                string elementString;
+
+                if (element != null)
+                {
+                    if (toStringFlags != ToStringFlags.None)
+                    {
+                        IToString toString = element as IToString;
+
+                        if (toString != null)
+                        {
+                            elementString = toString.ToString(
+                                toStringFlags);
                         }
                         else
                         {
-                            elementString = String.Empty;
+                            elementString = element.ToString();
                         }
+                    }
+                    else
+                    {
+                        elementString = element.ToString();
+                    }
+                }
+                else
+                {
+                    elementString = String.Empty;
+                }
 
-                        if ((pattern == null) || StringOps.Match(
+                if (elementStrings != null)
+                {
+                    elementStrings.Add(elementString);
+                    continue;
+                }
+
+                //
+                // NOTE: Match the string representation and add
+                //       the original element and not the string
+                //       representation because this is a generic
+                //       list, not a StringList.
+                //
+                if ((pattern == null) || StringOps.Match(
+                        null, StringOps.DefaultMatchMode,
+                        elementString, pattern, noCase))
+                {
+                    outputList.Add(elementString);
+                }
+            }
+
+            if (elementStrings != null)
+            {
+                StringList matches = null;
+
+                if (ParserOps<string>.TryMatchList(
+                        elementStrings, pattern, noCase, ref matches))
+                {
+                    outputList.AddRange(matches);
+                }
+                else
+                {
+                    foreach (string elementString in elementStrings)
+                    {
+                        if (StringOps.Match(
                                 null, StringOps.DefaultMatchMode,
                                 elementString, pattern, noCase))
                         {
-                            ListElementFlags flags = (index == startIndex) ?
-                                ListElementFlags.None :
-                                ListElementFlags.DontQuoteHash;
+                            outputList.Add(elementString);
+                        }
+                    }
+                }
+            }
+
+            return ReturnCode.Ok;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        private static ReturnCode FilterList(
+            IList<T> inputList,
+            StringList outputList,
+            int startIndex,
+            int stopIndex,
+            ToStringFlags toStringFlags,
+            string regExPattern,
+            RegexOptions regExOptions,
+            ref Result error
+            )
+        {
+            if (inputList == null)
+            {
+                error = "invalid input list";
+                return ReturnCode.Error;
+            }
+
+            if (outputList == null)
+            {
+                error = "invalid output list";
+                return ReturnCode.Error;
+            }
+
+            //
+            // BUGFIX: Skip everything if the input list is empty.
+            //
+            int count = inputList.Count;
+
+            if (count == 0)
+                return ReturnCode.Ok;
+
+            if (!ListOps.CheckStartAndStopIndex(
+                    0, count - 1, ref startIndex, ref stopIndex,
+                    ref error))
+            {
+                return ReturnCode.Error;
+            }
+
+            Regex regEx = null;
+
+            try
+            {
+                if (regExPattern != null)
+                {
+                    regEx = RegExOps.Create(
+                        regExPattern, regExOptions); /* throw */
+                }
+            }
+            catch
+            {
+                // do nothing.
+            }
+
+            if ((regExPattern != null) && (regEx == null))
+            {
+                error = "invalid regular expression";
+                return ReturnCode.Error;
+            }
+
+            for (int index = startIndex; index <= stopIndex; index++)
+            {
+                T element = inputList[index];
+                string elementString;
+
+                if (element != null)
+                {
+                    if (toStringFlags != ToStringFlags.None)
+                    {
+                        IToString toString = element as IToString;
+
+                        if (toString != null)
+                        {
+                            elementString = toString.ToString(
+                                toStringFlags);
+                        }
+                        else
+                        {
+                            elementString = element.ToString();
+                        }
+                    }
+                    else
+                    {
+                        elementString = element.ToString();
+                    }
+                }
+                else
+                {
+                    elementString = String.Empty;
+                }
+
+                //
+                // NOTE: Match the string representation and add
+                //       the original element and not the string
+                //       representation because this is a generic
+                //       list, not a StringList.
+                //
+                if ((regEx == null) || regEx.IsMatch(elementString))
+                    outputList.Add(elementString);
+            }
+
+            return ReturnCode.Ok;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        private static ReturnCode NativeListToString(
+            IList<T> list,
+            int startIndex,
+            int stopIndex,
+            ToStringFlags toStringFlags,
+            string separator,
+            string pattern,
+            bool noCase,
+            ref string text,
+            ref Result error
+            )
+        {
+            bool locked = false;
+
+            try
+            {
+                //
+                // BUGFIX: *DEADLOCK* Prevent deadlocks here by using
+                //         the TryLock pattern.
+                //
+                Result localError; /* REUSED */
+
+                if (NativeUtility.TryIsAvailable(
+                        null, ref locked)) /* TRANSACTIONAL */
+                {
+                    //
+                    // NOTE: Convert a null list into an empty string
+                    //       without actually calling into the native
+                    //       utility library.
+                    //
+                    if (list == null)
+                    {
+                        text = String.Empty;
+                        return ReturnCode.Ok;
+                    }
+
+                    StringList localList;
+
+                    if ((startIndex >= 0) || (stopIndex >= 0) ||
+                        (toStringFlags != ToStringFlags.None) ||
+                        (pattern != null))
+                    {
+                        localList = new StringList(list.Count);
+                        localError = null;
+
+                        if (FilterList(
+                                list, localList, startIndex, stopIndex,
+                                toStringFlags, pattern, noCase,
+                                ref localError) != ReturnCode.Ok)
+                        {
+                            TraceOps.DebugTrace(String.Format(
+                                "NativeListToString ({0}): {1}",
+                                MatchMode.Glob, localError),
+                                typeof(ParserOps<T>).Name,
+                                TracePriority.NativeError2);
+
+                            error = localError;
+                            return ReturnCode.Error;
+                        }
+                    }
+#if !MONO_BUILD
+                    //
+                    // HACK: *MONO* The Mono C# compiler cannot handle
+                    //       this block of code.  It gives the following
+                    //       warnings:
+                    //
+                    //       warning CS0184: The given expression is
+                    //       never of the provided
+                    //       (`Eagle._Containers.Public.StringList')
+                    //       type
+                    //
+                    //       warning CS0162: Unreachable code detected
+                    //
+                    else if (list is StringList)
+                    {
+                        localList = list as StringList;
+                    }
+#endif
+                    else
+                    {
+                        localList = new StringList(list);
+                    }
+
+                    string localText = null;
+
+                    localError = null;
+
+                    if (NativeUtility.JoinList(
+                            localList, ref localText,
+                            ref localError) == ReturnCode.Ok)
+                    {
+                        text = localText;
+                        return ReturnCode.Ok;
+                    }
+                    else
+                    {
+                        TraceOps.DebugTrace(String.Format(
+                            "NativeListToString ({0}): {1}",
+                            MatchMode.Glob, localError),
+                            typeof(ParserOps<T>).Name,
+                            TracePriority.NativeError);
+
+                        error = localError;
+                        return ReturnCode.Error;
+                    }
+                }
+                else if (!locked)
+                {
+                    localError = "unable to acquire native utility lock";
+
+                    TraceOps.DebugTrace(String.Format(
+                        "NativeListToString ({0}): {1}",
+                        MatchMode.Glob, localError),
+                        typeof(ParserOps<T>).Name,
+                        TracePriority.LockWarning);
+
+                    //
+                    // WARNING: Setting this error message will
+                    //          cause spurious complaints to be
+                    //          seen on secondary threads.
+                    //
+                    error = localError;
+                }
+                else
+                {
+                    localError = "native utility not available";
+
+#if DEBUG && VERBOSE
+                    TraceOps.DebugTrace(String.Format(
+                        "NativeListToString ({0}): {1}",
+                        MatchMode.Glob, localError),
+                        typeof(ParserOps<T>).Name,
+                        TracePriority.NativeError3);
+#endif
+
+                    //
+                    // HACK: This is not a real "error", per se.
+                    //       It simply means the native utility
+                    //       (library) is not available and the
+                    //       managed fallback should be used.
+                    //
+                    error = localError;
+                }
+
+                return ReturnCode.Error;
+            }
+            finally
+            {
+                NativeUtility.ExitLock(ref locked);
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        private static ReturnCode NativeListToString(
+            IList<T> list,
+            int startIndex,
+            int stopIndex,
+            ToStringFlags toStringFlags,
+            string separator,
+            string regExPattern,
+            RegexOptions regExOptions,
+            ref string text,
+            ref Result error
+            )
+        {
+            bool locked = false;
+
+            try
+            {
+                //
+                // BUGFIX: *DEADLOCK* Prevent deadlocks here by using
+                //         the TryLock pattern.
+                //
+                Result localError; /* REUSED */
+
+                if (NativeUtility.TryIsAvailable(
+                        null, ref locked)) /* TRANSACTIONAL */
+                {
+                    //
+                    // NOTE: Convert a null list into an empty string
+                    //       without actually calling into the native
+                    //       utility library.
+                    //
+                    if (list == null)
+                    {
+                        text = String.Empty;
+                        return ReturnCode.Ok;
+                    }
+
+                    StringList localList;
+
+                    if ((startIndex >= 0) || (stopIndex >= 0) ||
+                        (toStringFlags != ToStringFlags.None) ||
+                        (regExPattern != null))
+                    {
+                        localList = new StringList(list.Count);
+                        localError = null;
+
+                        if (FilterList(
+                                list, localList, startIndex, stopIndex,
+                                toStringFlags, regExPattern, regExOptions,
+                                ref localError) != ReturnCode.Ok)
+                        {
+                            TraceOps.DebugTrace(String.Format(
+                                "NativeListToString ({0}): {1}",
+                                MatchMode.RegExp, localError),
+                                typeof(ParserOps<T>).Name,
+                                TracePriority.NativeError2);
+
+                            error = localError;
+                            return ReturnCode.Error;
+                        }
+                    }
+#if !MONO_BUILD
+                    //
+                    // HACK: *MONO* The Mono C# compiler cannot handle
+                    //       this block of code.  It gives the following
+                    //       warnings:
+                    //
+                    //       warning CS0184: The given expression is
+                    //       never of the provided
+                    //       (`Eagle._Containers.Public.StringList')
+                    //       type
+                    //
+                    //       warning CS0162: Unreachable code detected
+                    //
+                    else if (list is StringList)
+                    {
+                        localList = list as StringList;
+                    }
+#endif
+                    else
+                    {
+                        localList = new StringList(list);
+                    }
+
+                    string localText = null;
+
+                    localError = null;
+
+                    if (NativeUtility.JoinList(
+                            localList, ref localText,
+                            ref localError) == ReturnCode.Ok)
+                    {
+                        text = localText;
+                        return ReturnCode.Ok;
+                    }
+                    else
+                    {
+                        TraceOps.DebugTrace(String.Format(
+                            "NativeListToString ({0}): {1}",
+                            MatchMode.RegExp, localError),
+                            typeof(ParserOps<T>).Name,
+                            TracePriority.NativeError);
+
+                        error = localError;
+                        return ReturnCode.Error;
+                    }
+                }
+                else if (!locked)
+                {
+                    localError = "unable to acquire native utility lock";
+
+                    TraceOps.DebugTrace(String.Format(
+                        "NativeListToString ({0}): {1}",
+                        MatchMode.RegExp, localError),
+                        typeof(ParserOps<T>).Name,
+                        TracePriority.LockWarning);
+
+                    //
+                    // WARNING: Setting this error message will
+                    //          cause spurious complaints to be
+                    //          seen on secondary threads.
+                    //
+                    error = localError;
+                }
+                else
+                {
+                    localError = "native utility not available";
+
+#if DEBUG && VERBOSE
+                    TraceOps.DebugTrace(String.Format(
+                        "NativeListToString ({0}): {1}",
+                        MatchMode.RegExp, localError),
+                        typeof(ParserOps<T>).Name,
+                        TracePriority.NativeError3);
+#endif
+
+                    //
+                    // HACK: This is not a real "error", per se.
+                    //       It simply means the native utility
+                    //       (library) is not available and the
+                    //       managed fallback should be used.
+                    //
+                    error = localError;
+                }
+
+                return ReturnCode.Error;
+            }
+            finally
+            {
+                NativeUtility.ExitLock(ref locked); /* TRANSACTIONAL */
+            }
+        }
+#endif
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////
+
+        #region Managed List Joining
+        private static string ManagedListToString(
+            IList<T> list,
+            int startIndex,
+            int stopIndex,
+            ToStringFlags toStringFlags,
+            string separator,
+            string pattern,
+            bool noCase
+            )
+        {
+            Interlocked.Increment(
+                ref ParserOpsData.managedJoinCount);
+
+            StringBuilder result = StringBuilderFactory.Create();
+
+            if (list != null)
+            {
+                int count = list.Count;
+
+                if (ListOps.CheckStartAndStopIndex(
+                        0, count - 1, ref startIndex, ref stopIndex))
+                {
+                    for (int index = startIndex; index <= stopIndex; index++)
+                    {
+                        T element = list[index];
+                        string elementString;
+
+                        if (element != null)
+                        {
+                            if (toStringFlags != ToStringFlags.None)
+                            {
+                                IToString toString = element as IToString;
+
+                                if (toString != null)
+                                {
+                                    elementString = toString.ToString(
+                                        toStringFlags);
+                                }
+                                else
+                                {
+                                    elementString = element.ToString();
+                                }
+                            }
+                            else
+                            {
+                                elementString = element.ToString();
+                            }
+                        }
+                        else
+                        {
+                            elementString = String.Empty;
+                        }
+
+                        if ((pattern == null) || StringOps.Match(
+                                null, StringOps.DefaultMatchMode,
+                                elementString, pattern, noCase))
+                        {
+                            ListElementFlags flags = (index == startIndex) ?
+                                ListElementFlags.None :
+                                ListElementFlags.DontQuoteHash;
+
+                            int length = elementString.Length;
+
+                            Parser.ScanElement(
+                                /* null, */ elementString, 0,
+                                length, ref flags);
+
+                            if ((result.Length > 0) &&
+                                !String.IsNullOrEmpty(separator))
+                            {
+                                result.Append(separator);
+                            }
+
+                            Parser.ConvertElement(
+                                /* null, */ elementString, 0,
+                                length, flags, ref result);
+                        }
+                    }
+                }
+            }
+
+            return StringBuilderCache.GetStringAndRelease(ref result);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        private static string ManagedListToString(
+            IList<T> list,
+            int startIndex,
+            int stopIndex,
+            ToStringFlags toStringFlags,
+            string separator,
+            string regExPattern,
+            RegexOptions regExOptions
+            )
+        {
+            Interlocked.Increment(
+                ref ParserOpsData.managedJoinCount);
+
+            StringBuilder result = StringBuilderFactory.Create();
+
+            if (list != null)
+            {
+                int count = list.Count;
+
+                if (ListOps.CheckStartAndStopIndex(
+                        0, count - 1, ref startIndex, ref stopIndex))
+                {
+                    Regex regEx = null;
+
+                    if (regExPattern != null)
+                    {
+                        regEx = RegExOps.Create(
+                            regExPattern, regExOptions); /* throw */
+                    }
+
+                    for (int index = startIndex; index <= stopIndex; index++)
+                    {
+                        T element = list[index];
+                        string elementString;
+
+                        if (element != null)
+                        {
+                            if (toStringFlags != ToStringFlags.None)
+                            {
+                                IToString toString = element as IToString;
+
+                                if (toString != null)
+                                {
+                                    elementString = toString.ToString(
+                                        toStringFlags);
+                                }
+                                else
+                                {
+                                    elementString = element.ToString();
+                                }
+                            }
+                            else
+                            {
+                                elementString = element.ToString();
+                            }
+                        }
+                        else
+                        {
+                            elementString = String.Empty;
+                        }
+
+                        if ((regEx == null) || regEx.IsMatch(elementString))
+                        {
+                            ListElementFlags flags = (index == startIndex) ?
+                                ListElementFlags.None :
+                                ListElementFlags.DontQuoteHash;
+
+                            int length = elementString.Length;
+
+                            Parser.ScanElement(
+                                /* null, */ elementString, 0,
+                                length, ref flags);
+
+                            if ((result.Length > 0) &&
+                                !String.IsNullOrEmpty(separator))
+                            {
+                                result.Append(separator);
+                            }
+
+                            Parser.ConvertElement(
+                                /* null, */ elementString, 0,
+                                length, flags, ref result);
+                        }
+                    }
+                }
+            }
+
+            return StringBuilderCache.GetStringAndRelease(ref result);
+        }
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////
+
+        #region List Joining
+#if NATIVE && NATIVE_UTILITY
+        private static bool ShouldUseNativeJoinList(
+            IList<T> list,
+            string separator
+            )
+        {
+            if (!ParserOpsData.UseNativeJoinList)
+                return false;
+
+            if ((list == null) || !Parser.IsListSeparator(separator))
+                return false;
+
+            int minimumCount = ParserOpsData.NativeMinimumListCount;
+
+            if ((minimumCount > 0) && (list.Count < minimumCount))
+                return false;
+
+            int maximumCount = ParserOpsData.NativeMaximumListCount;
+
+            if ((maximumCount > 0) && (list.Count > maximumCount))
+                return false;
+
+            return true;
+        }
+#endif
+
+        ///////////////////////////////////////////////////////////////////////
+
+        public static string ListToString(
+            IList<T> list,
+            int startIndex,
+            int stopIndex,
+            ToStringFlags toStringFlags,
+            string separator,
+            string pattern,
+            bool noCase
+            )
+        {
+#if NATIVE && NATIVE_UTILITY
+            if (ShouldUseNativeJoinList(list, separator))
+            {
+                ReturnCode code;
+                string localText = null;
+                Result localError = null;
+
+                code = NativeListToString(
+                    list, startIndex, stopIndex, toStringFlags,
+                    separator, pattern, noCase, ref localText,
+                    ref localError);
+
+                if (code == ReturnCode.Ok)
+                {
+                    Interlocked.Increment(
+                        ref ParserOpsData.nativeJoinCount);
+
+                    return localText;
+                }
+
+                if (!ParserOpsData.NoComplain && (localError != null))
+                    DebugOps.Complain(code, localError);
+            }
+#endif
+
+            return ManagedListToString(
+                list, startIndex, stopIndex, toStringFlags, separator,
+                pattern, noCase);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        public static string ListToString(
+            IList<T> list,
+            int startIndex,
+            int stopIndex,
+            ToStringFlags toStringFlags,
+            string separator,
+            string regExPattern,
+            RegexOptions regExOptions
+            )
+        {
+#if NATIVE && NATIVE_UTILITY
+            if (ShouldUseNativeJoinList(list, separator))
+            {
+                ReturnCode code;
+                string localText = null;
+                Result localError = null;
+
+                code = NativeListToString(
+                    list, startIndex, stopIndex, toStringFlags,
+                    separator, regExPattern, regExOptions,
+                    ref localText, ref localError);
+
+                if (code == ReturnCode.Ok)
+                {
+                    Interlocked.Increment(
+                        ref ParserOpsData.nativeJoinCount);
+
+                    return localText;
+                }
+
+                if (!ParserOpsData.NoComplain && (localError != null))
+                    DebugOps.Complain(code, localError);
+            }
+#endif
+
+            return ManagedListToString(
+                list, startIndex, stopIndex, toStringFlags, separator,
+                regExPattern, regExOptions);
+        }
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////
+
+        #region Native Script Parsing
+#if NATIVE && NATIVE_UTILITY
+        private static ReturnCode NativeParseScript(
+            Interpreter interpreter, /* OPTIONAL */
+            string text,
+            bool nested,
+            IParseState parseState,
+            ref TokenList tokens,
+            ref Result error
+            ) /* THREAD-SAFE */
+        {
+            bool locked = false;
+
+            try
+            {
+                //
+                // BUGFIX: *DEADLOCK* Prevent deadlocks here by using
+                //         the TryLock pattern.
+                //
+                if (NativeUtility.TryIsAvailable(
+                        interpreter, ref locked)) /* TRANSACTIONAL */
+                {
+                    return NativeUtility.ParseScript(
+                        text, nested, parseState, ref tokens,
+                        ref error);
+                }
+                else if (!locked)
+                {
+                    error = "unable to acquire native utility lock";
+                }
+                else
+                {
+                    error = "native utility not available";
+                }
+
+                return ReturnCode.Error;
+            }
+            finally
+            {
+                NativeUtility.ExitLock(ref locked); /* TRANSACTIONAL */
+            }
+        }
+#endif
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////
+
+        #region Script Parsing
+#if NATIVE && NATIVE_UTILITY
+        private static bool ShouldUseNativeParseScript(
+            string text,
+            int startIndex,
+            int characters
+            )
+        {
+            if (!ParserOpsData.UseNativeParseScript)
+                return false;
+
+            if ((text == null) || (startIndex != 0) ||
+                (characters != text.Length))
+            {
+                return false;
+            }
+
+            int minimumLength = ParserOpsData.NativeMinimumTextLength;
+
+            if ((minimumLength > 0) && (text.Length < minimumLength))
+                return false;
+
+            int maximumLength = ParserOpsData.NativeMaximumTextLength;
+
+            if ((maximumLength > 0) && (text.Length > maximumLength))
+                return false;
+
+            return true;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        //
+        // NOTE: This method is used to tokenize an entire script via one
+        //       call into the native utility library.  It returns false if
+        //       that cannot be done, e.g. the script has a syntax error,
+        //       in which case the caller must fallback to the managed
+        //       parser, which will produce the exact error and partial
+        //       results.  The interpreter readiness check is only done
+        //       once, up front, instead of once per command.
+        //
+        public static bool TryParseScript(
+            Interpreter interpreter, /* OPTIONAL */
+            string text,
+            int startIndex,
+            int characters,
+            bool nested,
+            bool noReady,
+            IParseState parseState,
+            ref TokenList tokens
+            ) /* ENTRY-POINT, THREAD-SAFE */
+        {
+            if ((parseState == null) ||
+                !ShouldUseNativeParseScript(text, startIndex, characters))
+            {
+                return false;
+            }
+
+            ReturnCode code;
+            TokenList localTokens = null;
+            Result localError = null;
+
+            if (!noReady && (interpreter != null) && (Parser.Ready(
+                    interpreter, parseState, ref localError) != ReturnCode.Ok))
+            {
+                return false;
+            }
+
+            code = NativeParseScript(
+                interpreter, text, nested, parseState, ref localTokens,
+                ref localError);
+
+            if (code == ReturnCode.Ok)
+            {
+                Interlocked.Increment(
+                    ref ParserOpsData.nativeParseCount);
+
+                if (tokens != null)
+                    tokens.AddRange(localTokens);
+                else
+                    tokens = localTokens;
+
+                return true;
+            }
+
+            if (!ParserOpsData.NoComplain && (localError != null))
+                DebugOps.Complain(code, localError);
+
+            return false;
+        }
+#endif
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////
+
+        #region Native Backslash Substitution
+#if NATIVE && NATIVE_UTILITY
+        private static ReturnCode NativeSubstituteBackslashes(
+            Interpreter interpreter, /* OPTIONAL */
+            string text,
+            ref string result,
+            ref Result error
+            ) /* THREAD-SAFE */
+        {
+            bool locked = false;
+
+            try
+            {
+                //
+                // BUGFIX: *DEADLOCK* Prevent deadlocks here by using
+                //         the TryLock pattern.
+                //
+                if (NativeUtility.TryIsAvailable(
+                        interpreter, ref locked)) /* TRANSACTIONAL */
+                {
+                    return NativeUtility.SubstituteBackslashes(
+                        text, ref result, ref error);
+                }
+                else if (!locked)
+                {
+                    error = "unable to acquire native utility lock";
+                }
+                else
+                {
+                    error = "native utility not available";
+                }
+
+                return ReturnCode.Error;
+            }
+            finally
+            {
+                NativeUtility.ExitLock(ref locked); /* TRANSACTIONAL */
+            }
+        }
+#endif
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////
+
+        #region Backslash Substitution
+#if NATIVE && NATIVE_UTILITY
+        private static bool ShouldUseNativeSubstitute(
+            string text,
+            SubstitutionFlags substitutionFlags
+            )
+        {
+            if (!ParserOpsData.UseNativeSubstitute)
+                return false;
+
+            //
+            // NOTE: Only backslash substitution is handled natively; any
+            //       variable or command substitution requires the engine.
+            //
+            if ((substitutionFlags & SubstitutionFlags.All) !=
+                    SubstitutionFlags.Backslashes)
+            {
+                return false;
+            }
+
+            if (text == null)
+                return false;
+
+            int minimumLength = ParserOpsData.NativeMinimumTextLength;
+
+            if ((minimumLength > 0) && (text.Length < minimumLength))
+                return false;
+
+            int maximumLength = ParserOpsData.NativeMaximumTextLength;
+
+            if ((maximumLength > 0) && (text.Length > maximumLength))
+                return false;
+
+            return true;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        //
+        // NOTE: This method is used to perform backslash substitution on an
+        //       entire string via one call into the native utility library,
+        //       instead of tokenizing it and substituting each token.  It
+        //       returns false if that cannot be done, in which case the
+        //       caller must fallback to the engine.  The interpreter
+        //       readiness check is only done once, up front.
+        //
+        public static bool TrySubstituteBackslashes(
+            Interpreter interpreter, /* OPTIONAL */
+            string text,
+            SubstitutionFlags substitutionFlags,
+            bool noReady,
+            IParseState parseState,
+            ref Result result
+            ) /* ENTRY-POINT, THREAD-SAFE */
+        {
+            if ((parseState == null) ||
+                !ShouldUseNativeSubstitute(text, substitutionFlags))
+            {
+                return false;
+            }
+
+            ReturnCode code;
+            string localResult = null;
+            Result localError = null;
+
+            if (!noReady && (interpreter != null) && (Parser.Ready(
+                    interpreter, parseState, ref localError) != ReturnCode.Ok))
+            {
+                return false;
+            }
+
+            code = NativeSubstituteBackslashes(
+                interpreter, text, ref localResult, ref localError);
+
+            if (code == ReturnCode.Ok)
+            {
+                Interlocked.Increment(
+                    ref ParserOpsData.nativeSubstCount);
+
+                result = localResult;
+                return true;
+            }
+
+            if (!ParserOpsData.NoComplain && (localError != null))
+                DebugOps.Complain(code, localError);
+
+            return false;
+        }
+#endif
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////
+
+        #region Native Number Parsing
+#if NATIVE && NATIVE_UTILITY
+        private static ReturnCode NativeParseNumbers(
+            Interpreter interpreter, /* OPTIONAL */
+            string text,
+            ref long[] values,
+            ref Result error
+            ) /* THREAD-SAFE */
+        {
+            bool locked = false;
+
+            try
+            {
+                //
+                // BUGFIX: *DEADLOCK* Prevent deadlocks here by using
+                //         the TryLock pattern.
+                //
+                if (NativeUtility.TryIsAvailable(
+                        interpreter, ref locked)) /* TRANSACTIONAL */
+                {
+                    return NativeUtility.ParseNumbers(
+                        text, ref values, ref error);
+                }
+                else if (!locked)
+                {
+                    error = "unable to acquire native utility lock";
+                }
+                else
+                {
+                    error = "native utility not available";
+                }
+
+                return ReturnCode.Error;
+            }
+            finally
+            {
+                NativeUtility.ExitLock(ref locked); /* TRANSACTIONAL */
+            }
+        }
+#endif
+        #endregion
 
-                            int length = elementString.Length;
+        ///////////////////////////////////////////////////////////////////////
 
-                            Parser.ScanElement(
-                                /* null, */ elementString, 0,
-                                length, ref flags);
+        #region Number Parsing
+#if NATIVE && NATIVE_UTILITY
+        private static bool IsNativeNumberCulture(
+            CultureInfo cultureInfo
+            )
+        {
+            //
+            // NOTE: The native code only knows about the ASCII plus and
+            //       minus signs; any culture that uses something else
+            //       must be handled by the managed code.
+            //
+            if (cultureInfo == null)
+                return false;
 
-                            if ((result.Length > 0) &&
-                                !String.IsNullOrEmpty(separator))
-                            {
-                                result.Append(separator);
-                            }
+            NumberFormatInfo numberFormatInfo = cultureInfo.NumberFormat;
 
-                            Parser.ConvertElement(
-                                /* null, */ elementString, 0,
-                                length, flags, ref result);
-                        }
-                    }
-                }
+            if ((numberFormatInfo == null) ||
+                !SharedStringOps.SystemEquals(
+                    numberFormatInfo.NegativeSign, "-") ||
+                !SharedStringOps.SystemEquals(
+                    numberFormatInfo.PositiveSign, "+"))
+            {
+                return false;
             }
 
-            return StringBuilderCache.GetStringAndRelease(ref result);
+            return true;
         }
 
         ///////////////////////////////////////////////////////////////////////
 
-        private static string ManagedListToString(
-            IList<T> list,
-            int startIndex,
-            int stopIndex,
-            ToStringFlags toStringFlags,
-            string separator,
-            string regExPattern,
-            RegexOptions regExOptions
+        private static bool ShouldUseNativeParseNumbers(
+            string text,
+            int count,
+            CultureInfo cultureInfo
             )
         {
-            Interlocked.Increment(
-                ref ParserOpsData.managedJoinCount);
+            if (!ParserOpsData.UseNativeParseNumbers)
+                return false;
 
-            StringBuilder result = StringBuilderFactory.Create();
+            if (text == null)
+                return false;
 
-            if (list != null)
-            {
-                int count = list.Count;
+            if (!IsNativeNumberCulture(cultureInfo))
+                return false;
 
-                if (ListOps.CheckStartAndStopIndex(
-                        0, count - 1, ref startIndex, ref stopIndex))
-                {
-                    Regex regEx = null;
+            int minimumCount = ParserOpsData.NativeMinimumListCount;
 
-                    if (regExPattern != null)
-                    {
-                        regEx = RegExOps.Create(
-                            regExPattern, regExOptions); /* throw */
-                    }
+            if ((minimumCount > 0) && (count < minimumCount))
+                return false;
 
-                    for (int index = startIndex; index <= stopIndex; index++)
-                    {
-                        T element = list[index];
-                        string elementString;
+            int maximumCount = ParserOpsData.NativeMaximumListCount;
 
-                        if (element != null)
-                        {
-                            if (toStringFlags != ToStringFlags.None)
-                            {
-                                IToString toString = element as IToString;
+            if ((maximumCount > 0) && (count > maximumCount))
+                return false;
 
-                                if (toString != null)
-                                {
-                                    elementString = toString.ToString(
-                                        toStringFlags);
-                                }
-                                else
-                                {
-                                    elementString = element.ToString();
-                                }
-                            }
-                            else
-                            {
-                                elementString = element.ToString();
-                            }
-                        }
-                        else
-                        {
-                            elementString = String.Empty;
-                        }
+            return true;
+        }
 
-                        if ((regEx == null) || regEx.IsMatch(elementString))
-                        {
-                            ListElementFlags flags = (index == startIndex) ?
-                                ListElementFlags.None :
-                                ListElementFlags.DontQuoteHash;
+        ///////////////////////////////////////////////////////////////////////
 
-                            int length = elementString.Length;
+        //
+        // NOTE: This method is used to convert every element of a list to
+        //       a wide integer via one call into the native utility library,
+        //       without creating a string for any of them.  It returns false
+        //       if that cannot be done, e.g. some element is not a number
+        //       or uses a syntax the native code does not handle, in which
+        //       case the caller must fallback to the managed code, which
+        //       will produce the exact results or error.  The count is the
+        //       number of elements the caller expects to be in the list.
+        //
+        public static bool TryParseWideIntegers(
+            Interpreter interpreter, /* OPTIONAL */
+            string text,
+            int count,
+            CultureInfo cultureInfo,
+            ref long[] values
+            ) /* ENTRY-POINT, THREAD-SAFE */
+        {
+            if (!ShouldUseNativeParseNumbers(text, count, cultureInfo))
+                return false;
 
-                            Parser.ScanElement(
-                                /* null, */ elementString, 0,
-                                length, ref flags);
+            ReturnCode code;
+            long[] localValues = null;
+            Result localError = null;
 
-                            if ((result.Length > 0) &&
-                                !String.IsNullOrEmpty(separator))
-                            {
-                                result.Append(separator);
-                            }
+            code = NativeParseNumbers(
+                interpreter, text, ref localValues, ref localError);
 
-                            Parser.ConvertElement(
-                                /* null, */ elementString, 0,
-                                length, flags, ref result);
-                        }
-                    }
-                }
+            if (code == ReturnCode.Ok)
+            {
+                if ((localValues == null) || (localValues.Length != count))
+                    return false;
+
+                Interlocked.Increment(
+                    ref ParserOpsData.nativeNumberCount);
+
+                values = localValues;
+                return true;
             }
 
-            return StringBuilderCache.GetStringAndRelease(ref result);
+            if (!ParserOpsData.NoComplain && (localError != null))
+                DebugOps.Complain(code, localError);
+
+            return false;
         }
+#endif
         #endregion
 
         ///////////////////////////////////////////////////////////////////////
 
-        #region List Joining
+        #region Native List Sorting
 #if NATIVE && NATIVE_UTILITY
-        private static bool ShouldUseNativeJoinList(
-            IList<T> list,
-            string separator
+        private static ReturnCode NativeSortList(
+            Interpreter interpreter, /* OPTIONAL */
+            StringList list,
+            bool integer,
+            bool ascending,
+            bool noCase,
+            ref StringList result,
+            ref Result error
+            ) /* THREAD-SAFE */
+        {
+            bool locked = false;
+
+            try
+            {
+                //
+                // BUGFIX: *DEADLOCK* Prevent deadlocks here by using
+                //         the TryLock pattern.
+                //
+                if (NativeUtility.TryIsAvailable(
+                        interpreter, ref locked)) /* TRANSACTIONAL */
+                {
+                    return NativeUtility.SortList(
+                        list, integer, ascending, noCase, ref result,
+                        ref error);
+                }
+                else if (!locked)
+                {
+                    error = "unable to acquire native utility lock";
+                }
+                else
+                {
+                    error = "native utility not available";
+                }
+
+                return ReturnCode.Error;
+            }
+            finally
+            {
+                NativeUtility.ExitLock(ref locked); /* TRANSACTIONAL */
+            }
+        }
+#endif
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////
+
+        #region List Sorting
+#if NATIVE && NATIVE_UTILITY
+        private static bool ShouldUseNativeSortList(
+            StringList list,
+            bool integer,
+            CultureInfo cultureInfo
             )
         {
-            if (!ParserOpsData.UseNativeJoinList)
+            if (!ParserOpsData.UseNativeSortList)
                 return false;
 
-            if ((list == null) || !Parser.IsListSeparator(separator))
+            if (list == null)
+                return false;
+
+            if (integer && !IsNativeNumberCulture(cultureInfo))
                 return false;
 
+            int count = list.Count;
             int minimumCount = ParserOpsData.NativeMinimumListCount;
 
-            if ((minimumCount > 0) && (list.Count < minimumCount))
+            if ((minimumCount > 0) && (count < minimumCount))
                 return false;
 
             int maximumCount = ParserOpsData.NativeMaximumListCount;
 
-            if ((maximumCount > 0) && (list.Count > maximumCount))
+            if ((maximumCount > 0) && (count > maximumCount))
                 return false;
 
             return true;
         }
-#endif
 
         ///////////////////////////////////////////////////////////////////////
 
-        public static string ListToString(
-            IList<T> list,
-            int startIndex,
-            int stopIndex,
-            ToStringFlags toStringFlags,
-            string separator,
-            string pattern,
-            bool noCase
-            )
+        //
+        // NOTE: This method is used to sort the elements of a list, either
+        //       as strings, using ordinal comparisons, or as wide integers,
+        //       via one call into the native utility library.  It returns
+        //       false if that cannot be done, e.g. some element is not a
+        //       number or two different elements compare equal, in which
+        //       case the caller must fallback to the managed code, which
+        //       will produce the exact results or error.
+        //
+        public static bool TrySortList(
+            Interpreter interpreter, /* OPTIONAL */
+            StringList list,
+            bool integer,
+            bool ascending,
+            bool noCase,
+            CultureInfo cultureInfo,
+            ref StringList result
+            ) /* ENTRY-POINT, THREAD-SAFE */
         {
-#if NATIVE && NATIVE_UTILITY
-            if (ShouldUseNativeJoinList(list, separator))
-            {
-                ReturnCode code;
-                string localText = null;
-                Result localError = null;
-
-                code = NativeListToString(
-                    list, startIndex, stopIndex, toStringFlags,
-                    separator, pattern, noCase, ref localText,
-                    ref localError);
-
-                if (code == ReturnCode.Ok)
-                {
-                    Interlocked.Increment(
-                        ref ParserOpsData.nativeJoinCount);
-
-                    return localText;
-                }
-
-                if (!ParserOpsData.NoComplain && (localError != null))
-                    DebugOps.Complain(code, localError);
-            }
-#endif
+            if (!ShouldUseNativeSortList(list, integer, cultureInfo))
+                return false;
 
-            return ManagedListToString(
-                list, startIndex, stopIndex, toStringFlags, separator,
-                pattern, noCase);
-        }
+            ReturnCode code;
+            StringList localResult = null;
+            Result localError = null;
 
-        ///////////////////////////////////////////////////////////////////////
+            code = NativeSortList(
+                interpreter, list, integer, ascending, noCase,
+                ref localResult, ref localError);
 
-        public static string ListToString(
-            IList<T> list,
-            int startIndex,
-            int stopIndex,
-            ToStringFlags toStringFlags,
-            string separator,
-            string regExPattern,
-            RegexOptions regExOptions
-            )
-        {
-#if NATIVE && NATIVE_UTILITY
-            if (ShouldUseNativeJoinList(list, separator))
+            if (code == ReturnCode.Ok)
             {
-                ReturnCode code;
-                string localText = null;
-                Result localError = null;
-
-                code = NativeListToString(
-                    list, startIndex, stopIndex, toStringFlags,
-                    separator, regExPattern, regExOptions,
-                    ref localText, ref localError);
-
-                if (code == ReturnCode.Ok)
+                if ((localResult == null) ||
+                    (localResult.Count != list.Count))
                 {
-                    Interlocked.Increment(
-                        ref ParserOpsData.nativeJoinCount);
-
-                    return localText;
+                    return false;
                 }
 
-                if (!ParserOpsData.NoComplain && (localError != null))
-                    DebugOps.Complain(code, localError);
+                Interlocked.Increment(
+                    ref ParserOpsData.nativeSortCount);
+
+                result = localResult;
+                return true;
             }
-#endif
 
-            return ManagedListToString(
-                list, startIndex, stopIndex, toStringFlags, separator,
-                regExPattern, regExOptions);
+            if (!ParserOpsData.NoComplain && (localError != null))
+                DebugOps.Complain(code, localError);
+
+            return false;
         }
+#endif
         #endregion
     }
     #endregion
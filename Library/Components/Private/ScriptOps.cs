@@ -7109,6 +7109,31 @@ namespace Eagle._Components.Private
             IntList valueIndexes = new IntList();
             int maximumIterations = 0;
 
+            //
+            // NOTE: When there are several value lists, try to split all
+            //       of them at once.  Upon failure, they are split again,
+            //       one at a time (below), so that any error is reported
+            //       in the same order as before.
+            //
+            StringList[] splitValueLists = null;
+
+            if (numLists > 1)
+            {
+                IGetValue[] values = new IGetValue[numLists];
+
+                for (int listIndex = 0; listIndex < numLists; listIndex++)
+                    values[listIndex] = arguments[2 + (listIndex * 2)];
+
+                Result splitError = null;
+
+                if (ListOps.GetOrCopyOrSplitLists(
+                        interpreter, values, true, ref splitValueLists,
+                        ref splitError) != ReturnCode.Ok)
+                {
+                    splitValueLists = null;
+                }
+            }
+
             for (int listIndex = 0; listIndex < numLists; listIndex++)
             {
                 int argumentIndex = 1 + (listIndex * 2);
@@ -7136,12 +7161,19 @@ namespace Eagle._Components.Private
 
                 StringList valueList = null;
 
-                code = ListOps.GetOrCopyOrSplitList(
-                    interpreter, arguments[argumentIndex], true,
-                    ref valueList, ref result);
+                if (splitValueLists != null)
+                {
+                    valueList = splitValueLists[listIndex];
+                }
+                else
+                {
+                    code = ListOps.GetOrCopyOrSplitList(
+                        interpreter, arguments[argumentIndex], true,
+                        ref valueList, ref result);
 
-                if (code != ReturnCode.Ok)
-                    goto done;
+                    if (code != ReturnCode.Ok)
+                        goto done;
+                }
 
                 valueLists.Add(valueList);
                 valueIndexes.Add(0);
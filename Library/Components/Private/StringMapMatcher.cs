@@ -0,0 +1,393 @@
+/*
+ * StringMapMatcher.cs --
+ *
+ * Copyright (c) 2007-2012 by Joe Mistachkin.  All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution of
+ * this file, and for a DISCLAIMER OF ALL WARRANTIES.
+ *
+ * RCS: @(#) $Id: $
+ */
+
+using System;
+using System.Collections.Generic;
+using System.Text;
+using Eagle._Attributes;
+using Eagle._Components.Public;
+using Eagle._Constants;
+using Eagle._Containers.Public;
+
+namespace Eagle._Components.Private
+{
+    //
+    // NOTE: This class is a compiled form of the mapping list used by the
+    //       [string map] sub-command.  It uses the Aho-Corasick algorithm
+    //       to find every key that matches at every position in the text,
+    //       using one pass over the text, instead of trying every key at
+    //       every position.  When more than one key matches at the same
+    //       position, the first one in the mapping list is used, exactly
+    //       like the StringOps.StrMap method.
+    //
+    [ObjectId("8d41c6f2-5a3e-4b97-a0d8-3e72f19b6c05")]
+    internal sealed class StringMapMatcher
+    {
+        #region Private Constants
+        //
+        // NOTE: Transitions from the root node for these characters are
+        //       kept in an array, because the root node is visited most
+        //       often.
+        //
+        private const int RootCharacters = 128;
+
+        //
+        // NOTE: This is used for the nodes (and characters) that have no
+        //       pattern and no transition, respectively.
+        //
+        private const int None = -1;
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+
+        #region Private Data
+        private bool noCase;               /* NOTE: Fold the ASCII letters to upper case? */
+        private string[] patterns;         /* NOTE: The old (from) values, in mapping order. */
+        private string[] replacements;     /* NOTE: The new (to) values, in mapping order. */
+        private int[] rootNext;            /* NOTE: Root transitions for the ASCII characters. */
+        private Dictionary<long, int> next; /* NOTE: All other transitions, by node and character. */
+        private int[] failure;             /* NOTE: Longest proper suffix node, per node. */
+        private int[] output;              /* NOTE: First pattern ending at each node -OR- None. */
+        private int[] outputLink;          /* NOTE: Next suffix node with a pattern -OR- zero. */
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+
+        #region Private Constructors
+        private StringMapMatcher(
+            bool noCase
+            )
+        {
+            this.noCase = noCase;
+        }
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+
+        #region Static "Factory" Methods
+        //
+        // NOTE: Returns null if the patterns cannot be compiled, e.g. when
+        //       ignoring case and some pattern is not pure ASCII, in which
+        //       case the caller must use the StringOps.StrMap method.
+        //
+        public static StringMapMatcher Create(
+            StringPairList patterns, /* in */
+            bool noCase              /* in */
+            )
+        {
+            if (patterns == null)
+                return null;
+
+            List<string> localPatterns = new List<string>(patterns.Count);
+            List<string> localReplacements = new List<string>(patterns.Count);
+
+            foreach (StringPair pair in patterns)
+            {
+                string pattern = pair.X;
+
+                //
+                // NOTE: Null and empty patterns never match; see the
+                //       StringOps.StrInMap method.
+                //
+                if (String.IsNullOrEmpty(pattern))
+                    continue;
+
+                //
+                // NOTE: The managed code compares strings ignoring case
+                //       using ordinal rules that may also fold non-ASCII
+                //       characters, which are not handled here.
+                //
+                if (noCase)
+                {
+                    foreach (char character in pattern)
+                    {
+                        if (character >= RootCharacters)
+                            return null;
+                    }
+                }
+
+                localPatterns.Add(pattern);
+                localReplacements.Add(pair.Y);
+            }
+
+            StringMapMatcher matcher = new StringMapMatcher(noCase);
+
+            matcher.patterns = localPatterns.ToArray();
+            matcher.replacements = localReplacements.ToArray();
+            matcher.Compile();
+
+            return matcher;
+        }
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+
+        #region Private Methods
+        private char FoldCase(
+            char character
+            )
+        {
+            if (noCase && (character >= 'a') && (character <= 'z'))
+                return (char)(character - ('a' - 'A'));
+
+            return character;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+
+        private int GetNext(
+            int node,
+            char character
+            )
+        {
+            if ((node == 0) && (character < RootCharacters))
+                return rootNext[character];
+
+            int child;
+
+            if (next.TryGetValue(((long)node << 16) | character, out child))
+                return child;
+
+            return None;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+
+        private void Compile()
+        {
+            List<int> parents = new List<int>();
+            List<char> characters = new List<char>();
+            List<int> depths = new List<int>();
+            List<int> outputs = new List<int>();
+
+            rootNext = new int[RootCharacters];
+            next = new Dictionary<long, int>();
+
+            for (int index = 0; index < RootCharacters; index++)
+                rootNext[index] = None;
+
+            //
+            // NOTE: Node zero is the root node.
+            //
+            parents.Add(None);
+            characters.Add(Characters.Null);
+            depths.Add(0);
+            outputs.Add(None);
+
+            //
+            // NOTE: First, build the trie of all the patterns.  When the
+            //       same pattern appears more than once, only the first
+            //       one can ever be used.
+            //
+            for (int index = 0; index < patterns.Length; index++)
+            {
+                string pattern = patterns[index];
+                int node = 0;
+
+                foreach (char character in pattern)
+                {
+                    char folded = FoldCase(character);
+                    int child = GetNext(node, folded);
+
+                    if (child == None)
+                    {
+                        child = parents.Count;
+
+                        parents.Add(node);
+                        characters.Add(folded);
+                        depths.Add(depths[node] + 1);
+                        outputs.Add(None);
+
+                        if ((node == 0) && (folded < RootCharacters))
+                            rootNext[folded] = child;
+                        else
+                            next.Add(((long)node << 16) | folded, child);
+                    }
+
+                    node = child;
+                }
+
+                if (outputs[node] == None)
+                    outputs[node] = index;
+            }
+
+            //
+            // NOTE: Next, compute the failure and output links, in order
+            //       of increasing depth, so the links for every shorter
+            //       suffix are already known.
+            //
+            int count = parents.Count;
+            int[] order = new int[count];
+
+            for (int index = 0; index < count; index++)
+                order[index] = index;
+
+            int[] keys = depths.ToArray();
+
+            Array.Sort(keys, order);
+
+            failure = new int[count];
+            output = outputs.ToArray();
+            outputLink = new int[count];
+
+            foreach (int node in order)
+            {
+                int parent = parents[node];
+
+                if ((parent == None) || (parent == 0))
+                    continue;
+
+                char character = characters[node];
+                int suffix = failure[parent];
+                int child;
+
+                while ((child = GetNext(suffix, character)) == None)
+                {
+                    if (suffix == 0)
+                        break;
+
+                    suffix = failure[suffix];
+                }
+
+                failure[node] = (child != None) ? child : 0;
+
+                suffix = failure[node];
+
+                outputLink[node] = (output[suffix] != None) ?
+                    suffix : outputLink[suffix];
+            }
+        }
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+
+        #region Public Methods
+        //
+        // NOTE: This method has the same semantics as the StringOps.StrMap
+        //       method, using the exact match mode.  It returns false if
+        //       the text cannot be handled, in which case the caller must
+        //       use that method instead.
+        //
+        public bool TryMap(
+            string text,    /* in */
+            int startIndex, /* in */
+            int maximum,    /* in */
+            ref int count,  /* in, out */
+            ref string result /* out */
+            )
+        {
+            if (text == null)
+                return false;
+
+            int length = text.Length;
+
+            if ((startIndex < 0) || (startIndex > length))
+                return false;
+
+            //
+            // NOTE: First, find the first pattern, in mapping order, that
+            //       matches starting at each position in the text.
+            //
+            int[] firstPatterns = new int[length - startIndex];
+
+            for (int index = 0; index < firstPatterns.Length; index++)
+                firstPatterns[index] = None;
+
+            int node = 0;
+
+            for (int index = startIndex; index < length; index++)
+            {
+                char character = text[index];
+
+                if (noCase && (character >= RootCharacters))
+                {
+                    //
+                    // HACK: Some runtimes fold a few non-ASCII characters
+                    //       to ASCII letters when ignoring case.
+                    //
+                    if (Char.ToUpperInvariant(character) < RootCharacters)
+                        return false;
+                }
+                else
+                {
+                    character = FoldCase(character);
+                }
+
+                int child;
+
+                while ((child = GetNext(node, character)) == None)
+                {
+                    if (node == 0)
+                        break;
+
+                    node = failure[node];
+                }
+
+                node = (child != None) ? child : 0;
+
+                for (int suffix = (output[node] != None) ? node : outputLink[node];
+                        suffix != 0; suffix = outputLink[suffix])
+                {
+                    int pattern = output[suffix];
+                    int start = index - patterns[pattern].Length + 1 - startIndex;
+
+                    if ((firstPatterns[start] == None) ||
+                        (pattern < firstPatterns[start]))
+                    {
+                        firstPatterns[start] = pattern;
+                    }
+                }
+            }
+
+            //
+            // NOTE: Next, replace the matches from left to right, skipping
+            //       over the text that each one covers.
+            //
+            StringBuilder builder = StringBuilderFactory.Create(length);
+            int index2 = startIndex;
+
+            for (int index = startIndex; index < length; )
+            {
+                int pattern = firstPatterns[index - startIndex];
+
+                if (pattern == None)
+                {
+                    index++;
+                    continue;
+                }
+
+                if (index2 != index)
+                    builder.Append(text, index2, index - index2);
+
+                index2 = index + patterns[pattern].Length;
+
+                if ((maximum == Count.Invalid) || (count < maximum))
+                {
+                    builder.Append(replacements[pattern]);
+                    count++;
+                }
+                else
+                {
+                    builder.Append(patterns[pattern]);
+                }
+
+                index = index2;
+            }
+
+            if (index2 != length)
+                builder.Append(text, index2, length - index2);
+
+            result = StringBuilderCache.GetStringAndRelease(ref builder);
+            return true;
+        }
+        #endregion
+    }
+}
@@ -118,6 +118,18 @@ namespace Eagle._Components.Private
 
         ///////////////////////////////////////////////////////////////////////////////////////////////
 
+        //
+        // HACK: These are purposely not read-only.  When the mapping list
+        //       for the StrMap method has at least this many elements, it
+        //       will be compiled into a StringMapMatcher, which is cached
+        //       per-interpreter (and per-thread), up to the maximum number
+        //       of compiled mapping lists.
+        //
+        private static int MinimumMapMatcherPatterns = 4;
+        private static int MaximumMapMatchers = 64;
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+
         internal static readonly MatchMode DefaultMatchMode = MatchMode.Glob; // COMPAT: Tcl.
         internal static readonly MatchMode DefaultSwitchMatchMode = MatchMode.Exact; // COMPAT: Tcl.
         internal static readonly MatchMode DefaultResultMatchMode = MatchMode.Exact; // COMPAT: Tcl.
@@ -3021,6 +3033,99 @@ namespace Eagle._Components.Private
             bool subSpec,                    /* in */
             ref int count                    /* in, out */
             )
+        {
+            return StrMap(
+                interpreter, mode, text, startIndex, patterns,
+                comparisonType, regExOptions, maximum, subSpec,
+                null, ref count);
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+
+        private static StringMapMatcher GetMapMatcher(
+            Interpreter interpreter,         /* in */
+            StringPairList patterns,         /* in */
+            StringComparison comparisonType, /* in */
+            string cacheKey                  /* in: OPTIONAL */
+            )
+        {
+            bool noCase;
+
+            switch (comparisonType)
+            {
+                case StringComparison.Ordinal:
+                    noCase = false;
+                    break;
+                case StringComparison.OrdinalIgnoreCase:
+                    noCase = true;
+                    break;
+                default:
+                    return null;
+            }
+
+#if THREADING
+            StringMapMatcherDictionary matchers = null;
+
+            if ((interpreter != null) && (cacheKey != null))
+            {
+                IEngineContext engineContext =
+                    interpreter.GetEngineContextNoCreate();
+
+                if (engineContext != null)
+                    matchers = engineContext.StringMapMatchers;
+            }
+
+            StringMapMatcher matcher;
+
+            if (matchers != null)
+            {
+                //
+                // NOTE: The cache key is the string representation of the
+                //       mapping list, which may only be compiled one way
+                //       for each case-sensitivity.
+                //
+                cacheKey = String.Format(
+                    "{0}{1}{2}", noCase, Characters.Colon, cacheKey);
+
+                if (matchers.TryGetValue(cacheKey, out matcher))
+                    return matcher;
+            }
+
+            //
+            // NOTE: This may return null, which is cached as well, so the
+            //       same mapping list will not be compiled again.
+            //
+            matcher = StringMapMatcher.Create(patterns, noCase);
+
+            if (matchers != null)
+            {
+                if (matchers.Count >= MaximumMapMatchers)
+                    matchers.Clear();
+
+                matchers.Add(cacheKey, matcher);
+            }
+
+            return matcher;
+#else
+            return StringMapMatcher.Create(patterns, noCase);
+#endif
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+
+        public static string StrMap(
+            Interpreter interpreter,         /* in */
+            MatchMode mode,                  /* in */
+            string text,                     /* in */
+            int startIndex,                  /* in */
+            StringPairList patterns,         /* in */
+            StringComparison comparisonType, /* in */
+            RegexOptions regExOptions,       /* in */
+            int maximum,                     /* in */
+            bool subSpec,                    /* in */
+            string cacheKey,                 /* in: OPTIONAL */
+            ref int count                    /* in, out */
+            )
         {
             //
             // BUGFIX: These are not errors, just return their original
@@ -3032,6 +3137,33 @@ namespace Eagle._Components.Private
             if ((patterns == null) || (patterns.Count == 0))
                 return text;
 
+            //
+            // NOTE: For exact matching, first try to use the compiled form
+            //       of the mapping list, which finds every match with one
+            //       pass over the string, instead of trying every element
+            //       at every position.
+            //
+            if (((mode & ~MatchMode.FlagsMask) == MatchMode.Exact) &&
+                (patterns.Count >= MinimumMapMatcherPatterns))
+            {
+                StringMapMatcher matcher = GetMapMatcher(
+                    interpreter, patterns, comparisonType, cacheKey);
+
+                if (matcher != null)
+                {
+                    int localCount = count;
+                    string localResult = null;
+
+                    if (matcher.TryMap(
+                            text, startIndex, maximum, ref localCount,
+                            ref localResult))
+                    {
+                        count = localCount;
+                        return localResult;
+                    }
+                }
+            }
+
             int length = text.Length;
             int index, index2;
             StringBuilder builder = StringBuilderFactory.Create(length);
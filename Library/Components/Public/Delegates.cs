@@ -19,6 +19,10 @@ using System.Net;
 
 using System.Reflection;
 
+#if NATIVE && TCL && NATIVE_PACKAGE
+using System.Runtime.InteropServices;
+#endif
+
 #if SHELL
 using System.Text;
 #endif
@@ -774,6 +778,23 @@ namespace Eagle._Components.Public.Delegates
 
     ///////////////////////////////////////////////////////////////////////////
 
+    #region Native Package Related Delegates
+#if NATIVE && TCL && NATIVE_PACKAGE
+    //
+    // NOTE: Used by the native package (Garuda) when the CLR is hosted via
+    //       the "hostfxr" library (e.g. on Unix), which requires a delegate
+    //       type matching the signature of the NativePackage class methods
+    //       it calls.  The argument is always passed as a UTF-16 string.
+    //
+    [ObjectId("4e0b7f3d-96c2-4a8e-b51d-2f6c8a03e9d7")]
+    public delegate int NativePackageCallback(
+        [MarshalAs(UnmanagedType.LPWStr)] string argument /* in */
+    );
+#endif
+    #endregion
+
+    ///////////////////////////////////////////////////////////////////////////
+
     #region Windows Forms Related Delegates
 #if WINFORMS
     [ObjectId("79ecb423-d799-4cb8-a7e4-a47c1678afb7")]
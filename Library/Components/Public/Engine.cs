@@ -14724,6 +14724,31 @@ namespace Eagle._Components.Public
                         ResetReturnCode(interpreter, result,
                             EngineFlagOps.HasResetReturnCode(localEngineFlags));
 
+#if NATIVE && NATIVE_UTILITY
+                        //
+                        // NOTE: When only backslash substitution is enabled, there are no
+                        //       side-effects and the whole string can be substituted in a
+                        //       single pass by the native utility library, if available.
+                        //       This is skipped when result limits are in effect, because
+                        //       they are enforced by the engine, one token at a time.
+                        //
+                        bool useNative = true;
+
+#if RESULT_LIMITS
+                        if ((executeResultLimit > 0) || (nestedResultLimit > 0))
+                            useNative = false;
+#endif
+
+                        if (useNative && ParserOps<string>.TrySubstituteBackslashes(
+                                interpreter, text, substitutionFlags, noReady,
+                                parseState, ref result))
+                        {
+                            code = ReturnCode.Ok;
+
+                            goto exit;
+                        }
+#endif
+
                         /*
                          * First parse the string rep of objPtr, as if it were enclosed as a
                          * "-quoted word in a normal Tcl command. Honor flags that selectively
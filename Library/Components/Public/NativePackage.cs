@@ -13,6 +13,7 @@ using System;
 using System.Collections;
 using System.Collections.Generic;
 using System.Globalization;
+using System.Runtime.InteropServices;
 using System.Threading;
 using Eagle._Attributes;
 using Eagle._Components.Private;
@@ -72,6 +73,15 @@ namespace Eagle._Components.Public
         private const string ProtocolIdV1R0 = "Garuda_v1.0"; /* LEGACY */
         private const string ProtocolIdV1R1 = "Garuda_v1.0_r1.0";
         private const string ProtocolIdV1R2 = "Garuda_v1.0_r2.0";
+        private const string ProtocolIdV1R3 = "Garuda_v1.0_r3.0";
+
+        //
+        // NOTE: These are the flags passed from native code via the protocol
+        //       data structure (V1R3).  They must match the values from the
+        //       ProtocolFlags enumeration in the native code.
+        //
+        private const uint ProtocolUseIsolation = 0x1;
+        private const uint ProtocolUseSafeInterp = 0x2;
 
         //
         // NOTE: These are the error messages returned when the string argument
@@ -86,6 +96,9 @@ namespace Eagle._Components.Public
             "argument string, expected at least [{0} <IntPtr> <IntPtr> " +
             "<IntPtr> <Boolean> <Boolean>]: {1}";
 
+        private const string ParseArgumentErrorV1R3 = "could not parse " +
+            "argument string, expected [{0} <IntPtr>]: {1}";
+
         //
         // NOTE: This is the error message returned when the "safe" mode of the
         //       Eagle interpreter is unsuitable for the "safe" mode of the Tcl
@@ -111,6 +124,35 @@ namespace Eagle._Components.Public
 
         ///////////////////////////////////////////////////////////////////////
 
+        #region Private Structures
+        //
+        // NOTE: This structure is passed, by address, from native code when
+        //       using protocol V1R3.  Its layout must match the layout of the
+        //       ClrProtocolData structure in the native code.  All strings
+        //       are UTF-16 with their lengths in characters.
+        //
+        [StructLayout(LayoutKind.Sequential)]
+        [ObjectId("4ef71f2c-94c3-4408-9b19-6bab77d5eda8")]
+        private struct ProtocolData
+        {
+            public /* size_t */ UIntPtr sizeOf;
+            public /* HANDLE */ IntPtr module;
+            public /* ClrTclStubs* */ IntPtr stubs;
+            public /* Tcl_Interp* */ IntPtr interp;
+            public /* ProtocolFlags */ uint flags;
+            public /* LPCWSTR */ IntPtr argument;
+            public /* int */ int argumentLength;
+            public /* int */ int objc;
+            public /* Tcl_Obj** */ IntPtr objv;
+            public /* LPCWSTR* */ IntPtr argv;
+            public /* int* */ IntPtr argl;
+            public /* LPWSTR */ IntPtr result; /* OUT */
+            public /* int */ int resultLength; /* OUT */
+        }
+        #endregion
+
+        ///////////////////////////////////////////////////////////////////////
+
         #region Private Data
         //
         // NOTE: This object is used with the lock statement to protect
@@ -1125,6 +1167,154 @@ namespace Eagle._Components.Public
 
         ///////////////////////////////////////////////////////////////////////
 
+        private static ReturnCode ParseArgumentV1R3(
+            string arg,
+            ref string protocolId,
+            ref IntPtr module,
+            ref IntPtr stubs,
+            ref IntPtr interp,
+            ref bool isolated,
+            ref bool safe,
+            ref StringList list,
+            ref IntPtr data,
+            ref Result error
+            )
+        {
+            Result localError = null;
+
+            //
+            // NOTE: The rest of the argument string is the address of the
+            //       protocol data structure.  Everything else is read from
+            //       that structure.
+            //
+            IntPtr localData = StringToIntPtr(
+                arg.Substring(ProtocolIdV1R3.Length + 1), true,
+                ref localError);
+
+            if (localData == IntPtr.Zero)
+                goto done;
+
+            ProtocolData protocolData = (ProtocolData)Marshal.PtrToStructure(
+                localData, typeof(ProtocolData));
+
+            if (protocolData.sizeOf.ToUInt64() <
+                (ulong)Marshal.SizeOf(typeof(ProtocolData)))
+            {
+                localError = String.Format(
+                    "protocol data structure too small, have {0}, need {1}",
+                    protocolData.sizeOf, Marshal.SizeOf(typeof(ProtocolData)));
+
+                goto done;
+            }
+
+            if ((protocolData.module == IntPtr.Zero) ||
+                (protocolData.stubs == IntPtr.Zero) ||
+                (protocolData.interp == IntPtr.Zero))
+            {
+                localError = "invalid module, stubs, or interpreter";
+                goto done;
+            }
+
+            //
+            // NOTE: The configured argument, if any, is still a list.  The
+            //       extra arguments are added verbatim, without any quoting
+            //       or splitting.
+            //
+            StringList localList = null;
+
+            if (protocolData.argument != IntPtr.Zero)
+            {
+                if (ParserOps<string>.SplitList(
+                        null, Marshal.PtrToStringUni(protocolData.argument,
+                        protocolData.argumentLength), 0, Length.Invalid,
+                        false, ref localList, ref localError) != ReturnCode.Ok)
+                {
+                    goto done;
+                }
+            }
+            else
+            {
+                localList = new StringList();
+            }
+
+            if ((protocolData.argv != IntPtr.Zero) &&
+                (protocolData.argl != IntPtr.Zero))
+            {
+                for (int index = 0; index < protocolData.objc; index++)
+                {
+                    localList.Add(Marshal.PtrToStringUni(
+                        Marshal.ReadIntPtr(protocolData.argv,
+                            index * IntPtr.Size),
+                        Marshal.ReadInt32(protocolData.argl,
+                            index * sizeof(int))));
+                }
+            }
+
+            //
+            // NOTE: Ok, everything was successful.  Commit changes to the
+            //       parameters provided by the caller.
+            //
+            list = localList;
+
+            protocolId = ProtocolIdV1R3;
+            interp = protocolData.interp;
+            module = protocolData.module;
+            stubs = protocolData.stubs;
+
+            isolated = ((protocolData.flags & ProtocolUseIsolation) ==
+                ProtocolUseIsolation);
+
+            safe = ((protocolData.flags & ProtocolUseSafeInterp) ==
+                ProtocolUseSafeInterp);
+
+            data = localData;
+
+            return ReturnCode.Ok;
+
+        done:
+
+            error = String.Format(
+                ParseArgumentErrorV1R3, ProtocolIdV1R3, localError);
+
+            return ReturnCode.Error;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
+        private static bool SetProtocolResult(
+            IntPtr data,
+            Result result
+            )
+        {
+            //
+            // NOTE: Without the protocol data structure (V1R3), there is
+            //       no way to pass the result back to native code.
+            //
+            if (data == IntPtr.Zero)
+                return false;
+
+            string value = result;
+
+            if (!String.IsNullOrEmpty(value))
+            {
+                //
+                // NOTE: The native code frees this via CoTaskMemFree (i.e.
+                //       or free on non-Windows platforms).
+                //
+                Marshal.WriteIntPtr(data, Marshal.OffsetOf(
+                    typeof(ProtocolData), "result").ToInt32(),
+                    Marshal.StringToCoTaskMemUni(value));
+
+                Marshal.WriteInt32(data, Marshal.OffsetOf(
+                    typeof(ProtocolData), "resultLength").ToInt32(),
+                    value.Length);
+            }
+
+            return true;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+
         private static ReturnCode ParseArgument(
             string arg,
             ref string protocolId,
@@ -1134,9 +1324,23 @@ namespace Eagle._Components.Public
             ref bool isolated,
             ref bool safe,
             ref StringList list,
+            ref IntPtr data,
             ref Result error
             )
         {
+            //
+            // NOTE: When using protocol V1R3, the argument string contains
+            //       only the protocol identifier and the address of the
+            //       protocol data structure; therefore, it is not a list.
+            //
+            if (SharedStringOps.SystemStartsWith(
+                    arg, ProtocolIdV1R3 + Characters.Space))
+            {
+                return ParseArgumentV1R3(
+                    arg, ref protocolId, ref module, ref stubs, ref interp,
+                    ref isolated, ref safe, ref list, ref data, ref error);
+            }
+
             StringList localList = null;
             Result localError = null;
             bool haveExtra = false;
@@ -1440,6 +1644,7 @@ namespace Eagle._Components.Public
                 bool isolated = false;
                 bool safe = false;
                 StringList list = null;
+                IntPtr data = IntPtr.Zero;
                 Result result = null;
 
                 TraceOps.DebugTrace(String.Format(
@@ -1452,7 +1657,7 @@ namespace Eagle._Components.Public
                 code = ParseArgument(
                     argument, ref protocolId, ref module, ref stubs,
                     ref interp, ref isolated, ref safe, ref list,
-                    ref result);
+                    ref data, ref result);
 
                 if (code == ReturnCode.Ok)
                 {
@@ -2007,12 +2212,16 @@ namespace Eagle._Components.Public
                 }
 
                 //
-                // NOTE: We have no way of passing the result string back to
-                //       native code; therefore, just "complain" about it
-                //       (e.g. to the console).
+                // NOTE: Unless the protocol data structure is available
+                //       (V1R3), we have no way of passing the result string
+                //       back to native code; therefore, just "complain"
+                //       about it (e.g. to the console).
                 //
-                if (code != ReturnCode.Ok)
+                if (!SetProtocolResult(data, result) &&
+                    (code != ReturnCode.Ok))
+                {
                     Complain(interp, isolated, code, result);
+                }
 
                 DebugTclInterpreters(null, "Startup exited", false);
 
@@ -2058,6 +2267,7 @@ namespace Eagle._Components.Public
                 bool isolated = false;
                 bool safe = false;
                 StringList list = null;
+                IntPtr data = IntPtr.Zero;
                 Result result = null;
 
                 TraceOps.DebugTrace(String.Format(
@@ -2071,7 +2281,7 @@ namespace Eagle._Components.Public
                 code = ParseArgument(
                     argument, ref protocolId, ref module, ref stubs,
                     ref interp, ref isolated, ref safe, ref list,
-                    ref result);
+                    ref data, ref result);
 
                 if (code == ReturnCode.Ok)
                 {
@@ -2128,12 +2338,16 @@ namespace Eagle._Components.Public
                 }
 
                 //
-                // NOTE: We have no way of passing the result string back to
-                //       native code; therefore, just "complain" about it
-                //       (e.g. to the console).
+                // NOTE: Unless the protocol data structure is available
+                //       (V1R3), we have no way of passing the result string
+                //       back to native code; therefore, just "complain"
+                //       about it (e.g. to the console).
                 //
-                if (code != ReturnCode.Ok)
+                if (!SetProtocolResult(data, result) &&
+                    (code != ReturnCode.Ok))
+                {
                     Complain(interp, isolated, code, result);
+                }
 
                 DebugTclInterpreters(null, "Control exited", false);
 
@@ -2179,6 +2393,7 @@ namespace Eagle._Components.Public
                 bool isolated = false;
                 bool safe = false;
                 StringList list = null;
+                IntPtr data = IntPtr.Zero;
                 Result result = null;
 
                 TraceOps.DebugTrace(String.Format(
@@ -2192,7 +2407,7 @@ namespace Eagle._Components.Public
                 code = ParseArgument(
                     argument, ref protocolId, ref module, ref stubs,
                     ref interp, ref isolated, ref safe, ref list,
-                    ref result);
+                    ref data, ref result);
 
                 if (code == ReturnCode.Ok)
                 {
@@ -2321,12 +2536,16 @@ namespace Eagle._Components.Public
                 }
 
                 //
-                // NOTE: We have no way of passing the result string back to
-                //       native code; therefore, just "complain" about it
-                //       (e.g. to the console).
+                // NOTE: Unless the protocol data structure is available
+                //       (V1R3), we have no way of passing the result string
+                //       back to native code; therefore, just "complain"
+                //       about it (e.g. to the console).
                 //
-                if (code != ReturnCode.Ok)
+                if (!SetProtocolResult(data, result) &&
+                    (code != ReturnCode.Ok))
+                {
                     Complain(interp, isolated, code, result);
+                }
 
                 DebugTclInterpreters(null, "Detach exited", false);
 
@@ -2372,6 +2591,7 @@ namespace Eagle._Components.Public
                 bool isolated = false;
                 bool safe = false;
                 StringList list = null;
+                IntPtr data = IntPtr.Zero;
                 Result result = null;
 
                 TraceOps.DebugTrace(String.Format(
@@ -2385,7 +2605,7 @@ namespace Eagle._Components.Public
                 code = ParseArgument(
                     argument, ref protocolId, ref module, ref stubs,
                     ref interp, ref isolated, ref safe, ref list,
-                    ref result);
+                    ref data, ref result);
 
                 if (code == ReturnCode.Ok)
                 {
@@ -2422,12 +2642,16 @@ namespace Eagle._Components.Public
                 }
 
                 //
-                // NOTE: We have no way of passing the result string back to
-                //       native code; therefore, just "complain" about it
-                //       (e.g. to the console).
+                // NOTE: Unless the protocol data structure is available
+                //       (V1R3), we have no way of passing the result string
+                //       back to native code; therefore, just "complain"
+                //       about it (e.g. to the console).
                 //
-                if (code != ReturnCode.Ok)
+                if (!SetProtocolResult(data, result) &&
+                    (code != ReturnCode.Ok))
+                {
                     Complain(interp, isolated, code, result);
+                }
 
                 DebugTclInterpreters(null, "Shutdown exited", false);
 
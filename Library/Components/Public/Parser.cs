@@ -1362,6 +1362,39 @@ namespace Eagle._Components.Public
                     currentLine);
             }
 
+#if NATIVE && NATIVE_UTILITY
+            TokenList nativeTokens = null;
+
+            if (ParserOps<string>.TryParseScript(
+                    interpreter, text, startIndex, characters, nested,
+                    noReady, parseState, ref nativeTokens))
+            {
+                if (syntax)
+                {
+                    int tokenIndex = 0;
+
+                    foreach (IToken nativeToken in nativeTokens)
+                    {
+                        if (nativeToken.Type == TokenType.Separator)
+                        {
+                            tokenIndex = 0;
+                            continue;
+                        }
+
+                        nativeToken.SyntaxType |=
+                            GetTokenSyntaxType(tokenIndex++, nativeToken);
+                    }
+                }
+
+                if (tokens == null)
+                    tokens = nativeTokens;
+                else
+                    tokens.AddRange(nativeTokens);
+
+                return ReturnCode.Ok;
+            }
+#endif
+
             while ((code = ParseCommand(
                     interpreter, text, index,
                     (characters < 0) ? length - index : characters - index,
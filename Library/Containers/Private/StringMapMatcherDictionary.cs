@@ -0,0 +1,27 @@
+/*
+ * StringMapMatcherDictionary.cs --
+ *
+ * Copyright (c) 2007-2012 by Joe Mistachkin.  All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution of
+ * this file, and for a DISCLAIMER OF ALL WARRANTIES.
+ *
+ * RCS: @(#) $Id: $
+ */
+
+using System.Collections.Generic;
+using Eagle._Attributes;
+using Eagle._Components.Private;
+
+namespace Eagle._Containers.Private
+{
+    [ObjectId("c7e2a95b-41f0-4d3a-9b68-0fd5e1a7c324")]
+    internal sealed class StringMapMatcherDictionary : Dictionary<string, StringMapMatcher>
+    {
+        public StringMapMatcherDictionary()
+            : base()
+        {
+            // do nothing.
+        }
+    }
+}
@@ -505,9 +505,27 @@ namespace Eagle._Containers.Public
             RegexOptions regExOptions
             )
         {
-            StringList list = GenericOps<string, object>.KeysAndValues(
-                this, false, true, false, mode, pattern, null, null, null,
-                null, noCase, regExOptions) as StringList;
+            StringList list = null;
+
+#if NATIVE && NATIVE_UTILITY
+            //
+            // NOTE: When there are enough keys, try to match all of them
+            //       against the glob pattern using one native call.
+            //
+            if ((mode == MatchMode.Glob) &&
+                !ParserOps<string>.TryMatchList(
+                    this.Keys, pattern, noCase, ref list))
+            {
+                list = null;
+            }
+#endif
+
+            if (list == null)
+            {
+                list = GenericOps<string, object>.KeysAndValues(
+                    this, false, true, false, mode, pattern, null, null,
+                    null, null, noCase, regExOptions) as StringList;
+            }
 
             return ParserOps<string>.ListToString(
                 list, Index.Invalid, Index.Invalid, ToStringFlags.None,
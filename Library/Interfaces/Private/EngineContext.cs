@@ -127,6 +127,7 @@ namespace Eagle._Interfaces.Private
         long PreviousProcessId { get; set; }
 
         ArraySearchDictionary ArraySearches { get; set; }
+        StringMapMatcherDictionary StringMapMatchers { get; set; }
 
 #if HISTORY
         IHistoryFilter HistoryEngineFilter { get; set; }
@@ -5904,6 +5904,27 @@ namespace Eagle._Tests
 
         ///////////////////////////////////////////////////////////////////////////////////////////////
 
+        public static int TestSleepMethod(
+            string argument /* This is the number of milliseconds to sleep,
+                             * as passed to native CLR API method
+                             * ICLRRuntimeHost.ExecuteInDefaultAppDomain. */
+            )
+        {
+            int value = 0;
+
+            if ((Value.GetInteger2(
+                    argument, ValueFlags.AnyInteger, null,
+                    ref value) == ReturnCode.Ok) && (value >= 0))
+            {
+                HostOps.ThreadSleep(value); /* throw */
+                return value;
+            }
+
+            return -1;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////
+
         public static ReturnCode TestAddListStreamChannel(
             Interpreter interpreter,
             string channelId,
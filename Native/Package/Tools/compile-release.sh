@@ -0,0 +1,33 @@
+#!/bin/bash
+
+scriptdir=`dirname "$BASH_SOURCE"`
+extradefs="$@"
+
+if [[ "$OSTYPE" == "darwin"* ]]; then
+  libname=Garuda.dylib
+  gccflags="-arch x86_64"
+else
+  libname=Garuda.so
+  gccflags=""
+fi
+
+# NOTE: The "tclConfig.sh" file is used to find the Tcl headers and stubs
+#       library; by default, the one for the Tcl shell on the PATH is used.
+if [[ -z "$TCL_CONFIG_SH" ]]; then
+  TCL_CONFIG_SH=`echo 'puts [file join [file dirname [info library]] tclConfig.sh]' | tclsh`
+fi
+
+source "$TCL_CONFIG_SH"
+
+# NOTE: The "nethost" headers and static library are shipped as part of the
+#       .NET application host pack; by default, the latest one is used.
+if [[ -z "$NETHOST_DIR" ]]; then
+  NETHOST_DIR=`ls -d "${DOTNET_ROOT:-$HOME/.dotnet}"/packs/Microsoft.NETCore.App.Host.*/*/runtimes/*/native | sort -V | tail -n 1`
+fi
+
+pushd "$scriptdir/../src/generic"
+gcc -g -fPIC -shared -pthread -fshort-wchar $gccflags -o $libname Garuda.c ../unix/GarudaUnix.c -I. -I../win -I../unix $TCL_INCLUDE_SPEC -I"$NETHOST_DIR" -DNDEBUG=1 -DUSE_TCL_STUBS=1 -DHAVE_UNISTD_H=1 -DHAVE_SYS_PARAM_H=1 -DHAVE_SYS_TIME_H=1 -DSTDC_HEADERS=1 -DTCL_THREADS=1 $extradefs $TCL_STUB_LIB_SPEC "$NETHOST_DIR/libnethost.a" -ldl -lstdc++
+mkdir -p ../../../../bin/Release$CONFIGURATION_SUFFIX/lib/Garuda1.0
+mv $libname ../../../../bin/Release$CONFIGURATION_SUFFIX/lib/Garuda1.0/$libname
+cp ../../lib/*.tcl ../../../../bin/Release$CONFIGURATION_SUFFIX/lib/Garuda1.0/
+popd
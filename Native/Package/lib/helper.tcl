@@ -965,6 +965,18 @@ namespace eval ::Garuda {
       set typeName Eagle._Components.Public.NativePackage
     }
 
+    #
+    # NOTE: The fully qualified name of the delegate type used to call the
+    #       CLR method(s) within the Eagle CLR assembly.  This is only used
+    #       when the CLR is hosted via the "hostfxr" library (e.g. on Unix).
+    #
+    variable delegateTypeName; # DEFAULT: ...NativePackageCallback, Eagle
+
+    if {![info exists delegateTypeName]} then {
+      set delegateTypeName \
+          "Eagle._Components.Public.Delegates.NativePackageCallback, Eagle"
+    }
+
     #
     # NOTE: The name of the CLR method to execute when starting up the bridge
     #       between Eagle and Tcl.  This is used by the code in the CLR
@@ -1026,7 +1038,9 @@ namespace eval ::Garuda {
     # NOTE: The extra method flags to use when invoking the CLR methods.  Refer
     #       to the MethodFlags enumeration for full details.  This is used by
     #       the code in the CLR assembly manager contained in this package.  An
-    #       example of a useful value here is 0x40 (i.e. METHOD_PROTOCOL_V1R2).
+    #       example of a useful value here is 0x40 (i.e. METHOD_PROTOCOL_V1R2)
+    #       or 0x2000 (i.e. METHOD_PROTOCOL_V1R3, which passes the arguments
+    #       via a structure instead of a string).
     #
     variable methodFlags; # DEFAULT: 0x0
 
@@ -1257,6 +1271,17 @@ namespace eval ::Garuda {
       set assemblyBaseName [file rootname [lindex $assemblyFileNames end]]
     }
 
+    #
+    # NOTE: The file name of the runtime configuration file used to load the
+    #       CLR via the "hostfxr" library (e.g. on Unix).  It should reside in
+    #       the same directory as the Eagle CLR assembly.
+    #
+    variable runtimeConfigFileName; # DEFAULT: EagleShell.runtimeconfig.json
+
+    if {![info exists runtimeConfigFileName]} then {
+      set runtimeConfigFileName EagleShell.runtimeconfig.json
+    }
+
     ###########################################################################
     #******************* MANAGED ASSEMBLY SEARCH VARIABLES ********************
     ###########################################################################
@@ -1350,6 +1375,8 @@ namespace eval ::Garuda {
     variable packageBinaryFileName
     variable packageName
     variable rootRegistryKeyName
+    variable runtimeConfigFileName
+    variable runtimeConfigPath
     variable useEnvironment
     variable useLibrary
     variable useRegistry
@@ -1450,6 +1477,17 @@ namespace eval ::Garuda {
       }
     }
 
+    #
+    # NOTE: Unless it has been pre-configured by an external script, use the
+    #       runtime configuration file residing in the same directory as the
+    #       managed assembly.  This is only used when the CLR is hosted via
+    #       the "hostfxr" library (e.g. on Unix).
+    #
+    if {![info exists runtimeConfigPath]} then {
+      set runtimeConfigPath [fileNormalize [file join [file dirname \
+          $assemblyPath] $runtimeConfigFileName]]
+    }
+
     #
     # NOTE: Attempt to load the dynamic link library for the package now that
     #       the managed assembly path has been set [to something].
@@ -9,16 +9,38 @@
  * RCS: @(#) $Id: $
  */
 
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE	/* NOTE: For dladdr, Dl_info, RTLD_NOLOAD, etc. */
+#endif
+
 #include <stdio.h>	/* NOTE: For fprintf, swprintf, va_list, etc. */
 #include <string.h>	/* NOTE: For memset, wcslen, wcsncpy, etc. */
 
 #include "GarudaPre.h"	/* NOTE: For private header setup. */
+
+#if defined(_WIN32)
+#if defined(USE_CLR_CORE)
+#include "windows.h"	/* NOTE: For LoadLibrary, GetProcAddress, etc. */
+#else
 #include "MSCorEE.h"	/* NOTE: For native CLR v2 API. */
+#endif
+#include "objbase.h"	/* NOTE: For CoTaskMemFree. */
+#else
+#include <stdlib.h>	/* NOTE: For free. */
+#include <dlfcn.h>	/* NOTE: For dladdr, dlopen, dlsym, etc. */
+#include "GarudaUnix.h"	/* NOTE: For Win32 types and wide string API. */
+#endif
 
 #if defined(USE_CLR_40)
 #include "MetaHost.h"	/* NOTE: For native CLR v4 API. */
 #endif
 
+#if defined(USE_CLR_CORE)
+#include "nethost.h"	/* NOTE: For get_hostfxr_path. */
+#include "hostfxr.h"	/* NOTE: For hostfxr hosting API. */
+#include "coreclr_delegates.h" /* NOTE: For runtime delegate types. */
+#endif
+
 #include "tcl.h"	/* NOTE: For public Tcl API. */
 #include "tclInt.h"	/* HACK: For internal Tcl API. */
 #include "stubs.h"	/* NOTE: #define and #pragma magic for stubs. */
@@ -40,6 +62,8 @@ static const char *	initTclStubs(Tcl_Interp *interp, const char *version,
  * NOTE: Private functions defined in this file.
  */
 
+static void		LockPackage(void);
+static void		UnlockPackage(void);
 static BOOL		GetPackageModuleFileName(HMODULE hModule,
 			    LPWSTR *pFileName);
 static BOOL		SetClrTclStubs(ClrTclStubs *pTclStubs, BOOL bTip285,
@@ -68,29 +92,58 @@ static void		FreeClrMethodInfo(ClrMethodInfo **ppMethodInfo);
 static int		GetClrConfigInfo(Tcl_Interp *interp, BOOL bForLogOnly,
 			    BOOL bMethods, ClrConfigInfo **ppConfigInfo);
 static void		FreeClrConfigInfo(ClrConfigInfo **ppConfigInfo);
+#if defined(USE_CLR_CORE)
+static LPVOID		GetHostFxrProc(LPCSTR procName);
+static int		LoadTheHostFxr(Tcl_Interp *interp,
+			    LPCWSTR logCommand);
+static const char_t *	GetClrHostString(LPCWSTR string,
+			    Tcl_DString *dsPtr);
+static LPWSTR		GetClrCoreTypeName(LPCWSTR typeName,
+			    LPCWSTR assemblyPath);
+static HRESULT		GetClrCoreVersion(LPWSTR buffer, size_t size);
+static HRESULT		GetClrCoreMethod(ClrMethodInfo *pMethodInfo,
+			    ClrCoreMethodFnPtr *ppMethod);
+static void		FreeClrCoreMethods(void);
+#endif
+static BOOL		IsTheClrLoaded(void);
 static int		LoadAndStartTheClr(Tcl_Interp *interp,
-			    LPCWSTR logCommand, BOOL bLoad,
-			    BOOL bUseMinimumClr, BOOL bStart, BOOL bStrict);
+			    LPCWSTR logCommand, LPCWSTR runtimeConfigPath,
+			    BOOL bLoad, BOOL bUseMinimumClr, BOOL bStart,
+			    BOOL bStrict);
 static int		StopAndReleaseTheClr(Tcl_Interp *interp,
 			    LPCWSTR logCommand, BOOL bRelease, BOOL bStrict);
 static BOOL		CanExecuteClrCode(Tcl_Interp *interp);
+static void		FreeClrProtocolResult(ClrProtocolData *pProtocolData);
 static int		ExecuteClrMethod(HANDLE hModule,
 			    ClrTclStubs *pTclStubs, Tcl_Interp *interp,
 			    LPCWSTR logCommand, ClrMethodInfo *pMethodInfo,
-			    LPCWSTR argument, MethodFlags methodFlags,
-			    LPDWORD pReturnValue);
+			    LPCWSTR argument, int objc, Tcl_Obj *CONST objv[],
+			    MethodFlags methodFlags, LPDWORD pReturnValue);
 static void		MaybeCombineMethodFlags(ClrConfigInfo *pConfigInfo,
 			    MethodFlags *pMethodFlags);
 static int		GetAndExecuteClrMethod(HANDLE hModule,
 			    ClrTclStubs *pTclStubs, ClrConfigInfo *pConfigInfo,
-			    Tcl_Interp *interp, LPCWSTR argument,
-			    MethodFlags methodFlags);
+			    Tcl_Interp *interp, LPCWSTR argument, int objc,
+			    Tcl_Obj *CONST objv[], MethodFlags methodFlags);
 static int		DemandExecuteClrMethod(HANDLE hModule,
 			    ClrTclStubs *pTclStubs, ClrConfigInfo *pConfigInfo,
 			    Tcl_Interp *interp, Tcl_Obj *assemblyPathPtr,
 			    Tcl_Obj *typeNamePtr, Tcl_Obj *methodNamePtr,
 			    Tcl_Obj *argumentPtr, MethodFlags methodFlags,
 			    LPDWORD pReturnValue);
+static void		FreeClrAsyncData(ClrAsyncData **ppAsyncData);
+static void		AddClrAsyncData(ClrAsyncData *pAsyncData);
+static void		RemoveClrAsyncData(ClrAsyncData *pAsyncData);
+static Tcl_ThreadCreateType ClrAsyncThreadProc(ClientData clientData);
+static int		ClrAsyncEventProc(Tcl_Event *evPtr, int flags);
+static int		ClrAsyncDeleteProc(Tcl_Event *evPtr,
+			    ClientData clientData);
+static void		ClrAsyncThreadExitProc(ClientData clientData);
+static int		AsyncExecuteClrMethod(ClrConfigInfo *pConfigInfo,
+			    Tcl_Interp *interp, Tcl_Obj *assemblyPathPtr,
+			    Tcl_Obj *typeNamePtr, Tcl_Obj *methodNamePtr,
+			    Tcl_Obj *argumentPtr, Tcl_Obj *callbackPtr,
+			    MethodFlags methodFlags);
 static void		GarudaExitProc(ClientData clientData);
 static int		GarudaObjCmd(ClientData clientData, Tcl_Interp *interp,
 			    int objc, Tcl_Obj *CONST objv[]);
@@ -110,11 +163,35 @@ static const TclIntPlatStubs *tclIntPlatStubsPtr = NULL;
 
 /*
  * NOTE: This package is thread-safe and this mutex is used to protect access
- *       to the static state defined in this file.
+ *       to the static state defined in this file.  Loading, starting, and
+ *       stopping the CLR are serialized by it; however, it is NOT held while
+ *       a CLR method is being executed, so that the CLR methods for the Tcl
+ *       interpreters in different threads may be executed concurrently.
  */
 
 TCL_DECLARE_MUTEX(packageMutex);
 
+/*
+ * NOTE: This is the key for the per-thread data used by this package.  See the
+ *       ThreadSpecificData structure for details.
+ */
+
+static Tcl_ThreadDataKey dataKey;
+
+/*
+ * NOTE: The package mutex may be locked recursively by the same thread (e.g.
+ *       the ExecuteClrMethod function calls the CanExecuteClrCode function).
+ *       On Windows, Tcl mutexes are critical sections, which already allow
+ *       this; elsewhere, they are not.  Therefore, the thread that currently
+ *       owns the package mutex and the number of times it has been locked by
+ *       that thread are tracked here.
+ */
+
+#if !defined(_WIN32)
+static Tcl_ThreadId packageMutexOwner = NULL;
+static int packageMutexCount = 0;
+#endif
+
 /*
  * NOTE: The package module handle.  This is needed to obtain the full path to
  *       the package module file name.
@@ -140,6 +217,15 @@ static LPWSTR packageFileName;
 
 static LONG lTclStubs = 0;
 
+/*
+ * NOTE: The number of CLR methods being executed asynchronously that have not
+ *       had their results delivered yet.  While this is non-zero, the package
+ *       cannot be unloaded from the process.  This is declared as LONG here so
+ *       that the Win32 interlocked API functions can be used with it.
+ */
+
+static LONG lAsyncCalls = 0;
+
 /*
  * NOTE: The Tcl library module handle.  This is needed to pass to the bridge
  *       so that it can be used as the basis for looking up functions exported
@@ -167,6 +253,53 @@ static ICLRMetaHost *pClrMetaHost = NULL;
 static ICLRRuntimeInfo *pClrRuntimeInfo = NULL;
 #endif
 
+#if defined(USE_CLR_CORE)
+/*
+ * NOTE: This is the "hostfxr" library module handle and the functions from
+ *       it used by this package.  The module handle is obtained via the path
+ *       returned by the get_hostfxr_path function from the "nethost" library
+ *       and it is never unloaded, because the CLR itself cannot be unloaded.
+ */
+
+static HANDLE hHostFxrModule = NULL;
+static hostfxr_initialize_for_runtime_config_fn pHostFxrInitialize = NULL;
+static hostfxr_get_runtime_delegate_fn pHostFxrGetDelegate = NULL;
+static hostfxr_get_runtime_property_value_fn pHostFxrGetProperty = NULL;
+static hostfxr_close_fn pHostFxrClose = NULL;
+
+/*
+ * NOTE: This is the "hostfxr" host context handle.  If NULL, the CLR has not
+ *       been loaded yet or the host context has been closed.  Once the CLR
+ *       has been loaded into the process, it cannot be unloaded; however, a
+ *       new host context may be initialized for it.
+ */
+
+static hostfxr_handle hClrHostContext = NULL;
+
+/*
+ * NOTE: This is the runtime delegate used to load an assembly and return a
+ *       native function pointer for one of its static methods.  It is only
+ *       obtained once, when the CLR is started by this package, and is then
+ *       used for every method executed.  If NULL, the CLR has not been
+ *       started by this package.
+ */
+
+static load_assembly_and_get_function_pointer_fn pClrLoadAssembly = NULL;
+
+/*
+ * NOTE: This is the cache of native function pointers for the CLR methods
+ *       that have already been resolved via the runtime delegate, keyed on
+ *       the assembly path, type name, method name, and delegate type name.
+ *       Each call to the runtime delegate creates a new thunk, which cannot
+ *       be freed, and has to look up the assembly, type, and method by name;
+ *       therefore, each CLR method is only resolved once, and then it will
+ *       simply be called via its cached function pointer.  The cache is only
+ *       valid while the CLR is started by this package.
+ */
+
+static Tcl_HashTable clrCoreMethods;
+static BOOL bClrCoreMethods = FALSE;
+#else
 /*
  * NOTE: This is the CLR v2+ runtime host interface pointer.  If NULL, the CLR
  *       has either not been loaded yet or the resources belonging to it have
@@ -176,12 +309,14 @@ static ICLRRuntimeInfo *pClrRuntimeInfo = NULL;
  */
 
 static ICLRRuntimeHost *pClrRuntimeHost = NULL;
+#endif
 
 /*
  * NOTE: This variable will be TRUE if the ICLRRuntimeHost::Start method has
  *       been called successfully by this package.  When this package calls the
  *       ICLRRuntimeHost::Stop method successfully, the value of this variable
- *       will be reset to FALSE.
+ *       will be reset to FALSE.  When the CLR is hosted via the "hostfxr"
+ *       library, this variable tracks the runtime delegate instead.
  */
 
 static BOOL bClrStarted = FALSE;
@@ -286,6 +421,83 @@ static const char *initTclStubs(
 }
 #endif
 
+/*
+ *----------------------------------------------------------------------
+ *
+ * LockPackage --
+ *
+ *	This function locks the package mutex.  The package mutex may
+ *	be locked recursively by the thread that already owns it.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	The calling thread may block until the package mutex becomes
+ *	available.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static void LockPackage(void)
+{
+#if defined(_WIN32)
+    Tcl_MutexLock(&packageMutex);
+#else
+    Tcl_ThreadId threadId = Tcl_GetCurrentThread();
+
+    /*
+     * NOTE: Only the thread that owns the package mutex can set the owner to
+     *       its own identifier; therefore, if it matches here, this thread
+     *       already owns the package mutex.
+     */
+
+    if (__sync_val_compare_and_swap(&packageMutexOwner, threadId,
+	    threadId) == threadId) {
+	packageMutexCount++;
+	return;
+    }
+
+    Tcl_MutexLock(&packageMutex);
+
+    packageMutexCount = 1;
+    packageMutexOwner = threadId;
+    __sync_synchronize();
+#endif
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * UnlockPackage --
+ *
+ *	This function unlocks the package mutex.  It must be called once
+ *	for each time the LockPackage function was called.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Another thread may acquire the package mutex.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static void UnlockPackage(void)
+{
+#if defined(_WIN32)
+    Tcl_MutexUnlock(&packageMutex);
+#else
+    if (--packageMutexCount > 0)
+	return;
+
+    packageMutexOwner = NULL;
+    __sync_synchronize();
+
+    Tcl_MutexUnlock(&packageMutex);
+#endif
+}
+
 /*
  *----------------------------------------------------------------------
  *
@@ -312,6 +524,7 @@ static BOOL GetPackageModuleFileName(
     HMODULE hModule,		/* The module handle. */
     LPWSTR *pFileName)		/* Pointer to the file name buffer. */
 {
+#if defined(_WIN32)
     DWORD size;
     LPWSTR result[2];
 
@@ -384,6 +597,54 @@ static BOOL GetPackageModuleFileName(
     ckfree((LPVOID) result[0]);
     *pFileName = result[1];
     return TRUE;
+#else
+    Dl_info info;
+    Tcl_DString ds[2];
+    int length;
+    LPWSTR result;
+
+    if (pFileName == NULL)
+	return FALSE;
+
+    /*
+     * NOTE: There is no DllMain on Unix; therefore, the saved module handle
+     *       is normally NULL.  In that case, use the address of a function
+     *       from this package to find the module file name via dladdr.
+     */
+
+    memset(&info, 0, sizeof(Dl_info));
+
+    if ((dladdr((hModule != NULL) ? (LPVOID) hModule : (LPVOID) Garuda_Init,
+	    &info) == 0) || (info.dli_fname == NULL)) {
+	*pFileName = NULL;
+	return FALSE;
+    }
+
+    /*
+     * NOTE: Convert the module file name from the system encoding to the
+     *       Unicode string format used by this package.
+     */
+
+    Tcl_ExternalToUtfDString(NULL, info.dli_fname, -1, &ds[0]);
+    Tcl_DStringInit(&ds[1]);
+
+    Tcl_UtfToUniCharDString(Tcl_DStringValue(&ds[0]),
+	Tcl_DStringLength(&ds[0]), &ds[1]);
+
+    length = Tcl_DStringLength(&ds[1]) / sizeof(Tcl_UniChar);
+    result = (LPWSTR) attemptckalloc((length + 1) * sizeof(WCHAR));
+
+    if (result != NULL) {
+	memset(result, 0, (length + 1) * sizeof(WCHAR));
+	memcpy(result, Tcl_DStringValue(&ds[1]), length * sizeof(WCHAR));
+    }
+
+    Tcl_DStringFree(&ds[1]);
+    Tcl_DStringFree(&ds[0]);
+
+    *pFileName = result;
+    return (result != NULL);
+#endif
 }
 
 /*
@@ -550,6 +811,8 @@ static int TracePrintf(
  * Results:
  *	An error message string (Unicode) based on the specified Tcl
  *	return code.
+ *	The storage for it belongs to the calling thread and it will
+ *	be overwritten by the next error message built by that thread.
  *
  * Side effects:
  *	None.
@@ -562,7 +825,9 @@ static LPCWSTR GetTclErrorMessage(
 			 * NULL if unknown or unavailable. */
     int code)		/* The Tcl return code. */
 {
-    static WCHAR message[PACKAGE_RESULT_SIZE + 1] = {0};
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)
+	Tcl_GetThreadData(&dataKey, sizeof(ThreadSpecificData));
+    LPWSTR message = tsdPtr->message;
     LPCWSTR severity = (code == TCL_OK) ? L"success" : L"failure";
 
     if (source != NULL) {
@@ -587,6 +852,8 @@ static LPCWSTR GetTclErrorMessage(
  * Results:
  *	An error message string (Unicode) based on the specified CLR
  *	error code.
+ *	The storage for it belongs to the calling thread and it will
+ *	be overwritten by the next error message built by that thread.
  *
  * Side effects:
  *	None.
@@ -599,7 +866,9 @@ static LPCWSTR GetClrErrorMessage(
 				 * NULL if unknown or unavailable. */
     HRESULT hResult)		/* The CLR error code. */
 {
-    static WCHAR message[PACKAGE_RESULT_SIZE + 1] = {0};
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)
+	Tcl_GetThreadData(&dataKey, sizeof(ThreadSpecificData));
+    LPWSTR message = tsdPtr->message;
     LPCWSTR severity = SUCCEEDED(hResult) ? L"success" : L"failure";
 
     if (source != NULL) {
@@ -679,15 +948,17 @@ static void TclLog(
     Tcl_RestoreResult(interp, &savedResult);
 
     if (code == TCL_OK) {
-	LPCWSTR args;
-
 	Tcl_AppendUnicodeToObj(objv[1], L"\n", -1);
-	args = Tcl_GetUnicode(objv[1]);
 
 #if defined(_WIN32)
-	OutputDebugStringW(args); /* NON-PORTABLE */
+	OutputDebugStringW(Tcl_GetUnicode(objv[1])); /* NON-PORTABLE */
 #else
-	fwprintf(stderr, L"%s", args);
+	/*
+	 * NOTE: There is no debugger output channel on Unix; therefore,
+	 *       only emit the message when tracing is enabled.
+	 */
+
+	PACKAGE_TRACE(("%s", Tcl_GetString(objv[1])));
 #endif
     }
 
@@ -780,7 +1051,7 @@ static LPWSTR GetStringObjectValue(
     }
 
     memset(result, 0, (length + 1) * sizeof(WCHAR));
-    wcsncpy(result, objValue, length + 1);
+    gwcsncpy(result, objValue, length + 1);
 
     if (lengthPtr != NULL)
 	*lengthPtr = length;
@@ -867,7 +1138,7 @@ static LPWSTR GetStringVariableValue(
     }
 
     memset(result, 0, (length + 1) * sizeof(WCHAR));
-    wcsncpy(result, varValue, length + 1);
+    gwcsncpy(result, varValue, length + 1);
 
     if (lengthPtr != NULL)
 	*lengthPtr = length;
@@ -1128,6 +1399,16 @@ static int CreateClrMethodInfo(
 	return TCL_ERROR;
     }
 
+#if defined(USE_CLR_CORE)
+    (*ppMethodInfo)->delegateTypeName = GetStringVariableValue(interp,
+	PACKAGE_UNICODE_DELEGATE_TYPE_NAME_VAR_NAME, &length);
+
+    if (((*ppMethodInfo)->delegateTypeName == NULL) || (length <= 0)) {
+	Tcl_AppendResult(interp, "invalid delegate type name\n", NULL);
+	return TCL_ERROR;
+    }
+#endif
+
     return TCL_OK;
 }
 
@@ -1244,6 +1525,16 @@ static int GetClrMethodInfo(
 	return TCL_ERROR;
     }
 
+#if defined(USE_CLR_CORE)
+    (*ppMethodInfo)->delegateTypeName = GetStringVariableValue(interp,
+	PACKAGE_UNICODE_DELEGATE_TYPE_NAME_VAR_NAME, &length);
+
+    if (((*ppMethodInfo)->delegateTypeName == NULL) || (length <= 0)) {
+	Tcl_AppendResult(interp, "invalid delegate type name\n", NULL);
+	return TCL_ERROR;
+    }
+#endif
+
     return TCL_OK;
 }
 
@@ -1270,6 +1561,11 @@ static void FreeClrMethodInfo(
     if ((ppMethodInfo == NULL) || (*ppMethodInfo == NULL))
 	return;
 
+    if ((*ppMethodInfo)->delegateTypeName != NULL) {
+	ckfree((LPVOID) (*ppMethodInfo)->delegateTypeName);
+	(*ppMethodInfo)->delegateTypeName = NULL;
+    }
+
     if ((*ppMethodInfo)->argument != NULL) {
 	ckfree((LPVOID) (*ppMethodInfo)->argument);
 	(*ppMethodInfo)->argument = NULL;
@@ -1375,6 +1671,24 @@ static int GetClrConfigInfo(
 	return TCL_ERROR;
     }
 
+#if defined(USE_CLR_CORE)
+    /*
+     * NOTE: The runtime configuration file is needed to load the CLR via the
+     *       "hostfxr" library, which may be done by the [garuda clrload]
+     *       sub-command; therefore, always include it.
+     */
+
+    (*ppConfigInfo)->runtimeConfigPath = GetStringVariableValue(interp,
+	PACKAGE_UNICODE_RUNTIME_CONFIG_VAR_NAME, &length);
+
+    if (((*ppConfigInfo)->runtimeConfigPath == NULL) || (length <= 0)) {
+	Tcl_AppendResult(interp, "invalid runtime configuration path\n",
+	    NULL);
+
+	return TCL_ERROR;
+    }
+#endif
+
     if (!bForLogOnly) {
 	(*ppConfigInfo)->methodFlags = GetIntegerVariableValue(interp,
 	    PACKAGE_UNICODE_METHOD_FLAGS_VAR_NAME, METHOD_NONE);
@@ -1430,6 +1744,11 @@ static void FreeClrConfigInfo(
     if ((ppConfigInfo == NULL) || (*ppConfigInfo == NULL))
 	return;
 
+    if ((*ppConfigInfo)->runtimeConfigPath != NULL) {
+	ckfree((LPVOID) (*ppConfigInfo)->runtimeConfigPath);
+	(*ppConfigInfo)->runtimeConfigPath = NULL;
+    }
+
     if ((*ppConfigInfo)->logCommand != NULL) {
 	ckfree((LPVOID) (*ppConfigInfo)->logCommand);
 	(*ppConfigInfo)->logCommand = NULL;
@@ -1444,548 +1763,2095 @@ static void FreeClrConfigInfo(
     *ppConfigInfo = NULL;
 }
 
+#if defined(USE_CLR_CORE)
 /*
  *----------------------------------------------------------------------
  *
- * LoadAndStartTheClr --
+ * GetHostFxrProc --
  *
- *	This function loads and optionally starts the latest version of
- *	the CLR supported by this package.
+ *	This function looks up the specified function exported from the
+ *	loaded "hostfxr" library.  This function uses global state and
+ *	assumes any required locks are already held by the caller.
+ *
+ * Results:
+ *	The address of the function -OR- NULL if it cannot be found.
+ *
+ * Side effects:
+ *	None.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static LPVOID GetHostFxrProc(
+    LPCSTR procName)		/* The name of the function. */
+{
+    if (hHostFxrModule == NULL)
+	return NULL;
+
+#if defined(_WIN32)
+    /* NON-PORTABLE */
+    return (LPVOID) GetProcAddress((HMODULE) hHostFxrModule, procName);
+#else
+    return dlsym(hHostFxrModule, procName);
+#endif
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * LoadTheHostFxr --
+ *
+ *	This function locates and loads the "hostfxr" library, using
+ *	the get_hostfxr_path function from the "nethost" library, and
+ *	then looks up the functions from it used by this package.  If
+ *	the library has already been loaded, nothing is done.  This
+ *	function uses global state and assumes any required locks are
+ *	already held by the caller.
  *
  * Results:
  *	A standard Tcl result.
  *
  * Side effects:
- *	Since the CLR may execute startup code, this function may
- *	have arbitrary side-effects.
+ *	None.
  *
  *----------------------------------------------------------------------
  */
 
-static int LoadAndStartTheClr(
+static int LoadTheHostFxr(
     Tcl_Interp *interp,	    /* Current Tcl interpreter.*/
-    LPCWSTR logCommand,	    /* The Tcl command used to log the CLR method
-			     * execution, if any. */
-    BOOL bLoad,		    /* Load the CLR if necessary? */
-    BOOL bUseMinimumClr,    /* Force using minimum supported CLR
-			     * version? */
-    BOOL bStart,	    /* Start the CLR after loading it? */
-    BOOL bStrict)	    /* Fail if already loaded and/or started? */
+    LPCWSTR logCommand)	    /* The Tcl command used to log the library
+			     * loading, if any. */
 {
     int code = TCL_OK;
+    HRESULT hResult;
+    size_t size = 0;
+    char_t *path = NULL;
     WCHAR buffer[PACKAGE_RESULT_SIZE + 1] = {0};
 
-    Tcl_MutexLock(&packageMutex);
+    if (hHostFxrModule != NULL)
+	return TCL_OK;
 
     /*
-     * NOTE: Has the CLR been loaded into this process [by this package] yet?
-     *       If not, try to do it now.
+     * NOTE: First, query the size of the buffer needed to hold the path of
+     *       the "hostfxr" library.  This is expected to "fail" with a code
+     *       indicating the buffer is too small.
      */
 
-    if (bLoad) {
-#if defined(USE_CLR_40)
-	if (pClrRuntimeHost == NULL) {
-	    HRESULT hResult;
-	    LPCWSTR clrVersion;
-	    BOOL bLoadable = FALSE;
+    get_hostfxr_path(NULL, &size, NULL);
 
-	    /*
-	     * NOTE: We link to the "MSCorEE" library; therefore, it should
-	     *       already be loaded (i.e. no need to call LoadLibrary here).
-	     *       However, we need the loaded module handle for our call to
-	     *       GetProcAddress; therefore, get the existing module handle
-	     *       using the GetModuleHandle function.
-	     */
+    if (size == 0) {
+	if (interp != NULL) {
+	    Tcl_AppendResult(interp, "hostfxr library not found\n", NULL);
+	}
 
-	    /* NON-PORTABLE */
-	    CLRCreateInstanceFnPtr pClrCreateInstance =
-		(CLRCreateInstanceFnPtr) GetProcAddress(GetModuleHandleW(
-		    UNICODE_TEXT(CLR_MODULE_NAME)), CLR_PROC_NAME);
+	code = TCL_ERROR;
+	goto done;
+    }
 
-	    if (PACKAGE_CAN_LOG(interp, logCommand)) {
-		gwprintf(buffer, PACKAGE_RESULT_SIZE,
-		    L"GetProcAddress(pClrCreateInstance = {"
-		    PACKAGE_UNICODE_PTR_FMT L"})", pClrCreateInstance);
+    path = (char_t *) attemptckalloc(size * sizeof(char_t));
 
-		TclLog(interp, logCommand, buffer, NULL);
-	    }
+    if (path == NULL) {
+	if (interp != NULL) {
+	    Tcl_AppendResult(interp, "out of memory: path\n", NULL);
+	}
 
-	    if (pClrCreateInstance == NULL) {
-		goto fallback;
-	    }
+	code = TCL_ERROR;
+	goto done;
+    }
 
-	    hResult = pClrCreateInstance(&CLSID_CLRMetaHost, &IID_ICLRMetaHost,
-		&pClrMetaHost);
+    memset(path, 0, size * sizeof(char_t));
+    hResult = get_hostfxr_path(path, &size, NULL);
 
-	    if (PACKAGE_CAN_LOG(interp, logCommand)) {
-		gwprintf(buffer, PACKAGE_RESULT_SIZE,
-		    L"pClrCreateInstance(hResult = {0x%lX}, "
-		    L"pClrMetaHost = {" PACKAGE_UNICODE_PTR_FMT L"})",
-		    hResult, pClrMetaHost);
+    if (PACKAGE_CAN_LOG(interp, logCommand)) {
+	gwprintf(buffer, PACKAGE_RESULT_SIZE,
+	    L"get_hostfxr_path(hResult = {0x%lX}, size = {%lu})", hResult,
+	    (ULONG) size);
 
-		TclLog(interp, logCommand, buffer, NULL);
-	    }
+	TclLog(interp, logCommand, buffer, NULL);
+    }
 
-	    if (FAILED(hResult)) {
-		/*
-		 * NOTE: According to Brad Wilson's [MSFT] blog post "Selecting
-		 *       CLR Version From Unmanaged Host", dated 2010/04/19, if
-		 *       E_NOTIMPL is returned from the CLRCreateInstance
-		 *       function, we should simply try to load the CLR using
-		 *       the "legacy" path (i.e. the CorBindToRuntimeEx
-		 *       function).  However, this return value is not called
-		 *       out in the MSDN documentation for this function.
-		 */
+    if (FAILED(hResult)) {
+	if (interp != NULL) {
+	    Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
+		GetClrErrorMessage(L"get_hostfxr_path", hResult), -1);
+	}
 
-		if (hResult == E_NOTIMPL) {
-		    goto fallback;
-		}
+	code = TCL_ERROR;
+	goto done;
+    }
 
-		if (interp != NULL) {
-		    Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
-			GetClrErrorMessage(L"pClrCreateInstance", hResult),
-			    -1);
-		}
+#if defined(_WIN32)
+    hHostFxrModule = LoadLibraryW(path); /* NON-PORTABLE */
+#else
+    hHostFxrModule = dlopen(path, RTLD_LAZY | RTLD_LOCAL);
+#endif
 
-		code = TCL_ERROR;
-		goto done;
-	    }
+    if (hHostFxrModule == NULL) {
+	if (interp != NULL) {
+	    Tcl_AppendResult(interp, "failed to load hostfxr library\n",
+		NULL);
+	}
 
-	    /*
-	     * NOTE: By default, we want to load the latest supported version
-	     *       of the CLR (e.g. "v4.0.30319").  However, this loading
-	     *       behavior can now be overridden by setting the environment
-	     *       variable named "UseMinimumClr" [to anything] -OR- by
-	     *       setting the Tcl variable "useMinimumClr" (in the namespace
-	     *       of the package) to non-zero.  In that case, the minimum
-	     *       supported version of the CLR will be loaded instead (e.g.
-	     *       "v2.0.50727").
-	     */
+	code = TCL_ERROR;
+	goto done;
+    }
 
-	    if (bUseMinimumClr) {
-		/*
-		 * NOTE: Ok, the environment variable is set, use the minimum
-		 *       supported version of the CLR instead of the latest.
-		 */
+    pHostFxrInitialize = (hostfxr_initialize_for_runtime_config_fn)
+	GetHostFxrProc("hostfxr_initialize_for_runtime_config");
 
-		clrVersion = UNICODE_TEXT(CLR_VERSION_MINIMUM);
-	    } else {
-		/*
-		 * NOTE: Ok, use the latest supported version of the CLR.
-		 */
+    pHostFxrGetDelegate = (hostfxr_get_runtime_delegate_fn)
+	GetHostFxrProc("hostfxr_get_runtime_delegate");
 
-		clrVersion = UNICODE_TEXT(CLR_VERSION_LATEST);
-	    }
+    pHostFxrGetProperty = (hostfxr_get_runtime_property_value_fn)
+	GetHostFxrProc("hostfxr_get_runtime_property_value");
 
-	    if (PACKAGE_CAN_LOG(interp, logCommand)) {
-		gwprintf(buffer, PACKAGE_RESULT_SIZE,
-		    L"BEFORE ICLRMetaHost_GetRuntime(pClrMetaHost = {"
-		    PACKAGE_UNICODE_PTR_FMT L"}, clrVersion = {%s})",
-		    pClrMetaHost, clrVersion);
+    pHostFxrClose = (hostfxr_close_fn) GetHostFxrProc("hostfxr_close");
 
-		TclLog(interp, logCommand, buffer, NULL);
-	    }
+    if (PACKAGE_CAN_LOG(interp, logCommand)) {
+	gwprintf(buffer, PACKAGE_RESULT_SIZE,
+	    L"LoadTheHostFxr(hHostFxrModule = {" PACKAGE_UNICODE_PTR_FMT
+	    L"}, pHostFxrInitialize = {" PACKAGE_UNICODE_PTR_FMT
+	    L"}, pHostFxrGetDelegate = {" PACKAGE_UNICODE_PTR_FMT
+	    L"}, pHostFxrGetProperty = {" PACKAGE_UNICODE_PTR_FMT
+	    L"}, pHostFxrClose = {" PACKAGE_UNICODE_PTR_FMT L"})",
+	    hHostFxrModule, pHostFxrInitialize, pHostFxrGetDelegate,
+	    pHostFxrGetProperty, pHostFxrClose);
 
-	    /*
-	     * NOTE: Apparently, a NULL version string cannot be used here to
-	     *       mean "give me the latest version available" and that means
-	     *       we have to hard-code it.
-	     */
+	TclLog(interp, logCommand, buffer, NULL);
+    }
 
-	    hResult = ICLRMetaHost_GetRuntime(pClrMetaHost, clrVersion,
-		&IID_ICLRRuntimeInfo, &pClrRuntimeInfo);
+    if ((pHostFxrInitialize == NULL) || (pHostFxrGetDelegate == NULL) ||
+	    (pHostFxrGetProperty == NULL) || (pHostFxrClose == NULL)) {
+	if (interp != NULL) {
+	    Tcl_AppendResult(interp, "hostfxr library is incompatible\n",
+		NULL);
+	}
 
-	    if (PACKAGE_CAN_LOG(interp, logCommand)) {
-		gwprintf(buffer, PACKAGE_RESULT_SIZE,
-		    L"AFTER ICLRMetaHost_GetRuntime(hResult = {0x%lX}, "
-		    L"pClrRuntimeInfo = {" PACKAGE_UNICODE_PTR_FMT L"})",
-		    hResult, pClrRuntimeInfo);
+#if defined(_WIN32)
+	FreeLibrary((HMODULE) hHostFxrModule); /* NON-PORTABLE */
+#else
+	dlclose(hHostFxrModule);
+#endif
 
-		TclLog(interp, logCommand, buffer, NULL);
-	    }
+	hHostFxrModule = NULL;
+	pHostFxrInitialize = NULL;
+	pHostFxrGetDelegate = NULL;
+	pHostFxrGetProperty = NULL;
+	pHostFxrClose = NULL;
 
-	    if (FAILED(hResult)) {
-		if (interp != NULL) {
-		    Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
-			GetClrErrorMessage(L"ICLRMetaHost_GetRuntime",
-			    hResult), -1);
-		}
+	code = TCL_ERROR;
+	goto done;
+    }
 
-		code = TCL_ERROR;
-		goto done;
-	    }
+done:
+    if (path != NULL) {
+	ckfree((LPVOID) path);
+	path = NULL;
+    }
 
-	    /*
-	     * NOTE: Check if the version of the CLR that we want to load can
-	     *       actually be loaded into this process.
-	     */
+    return code;
+}
 
-	    hResult = ICLRRuntimeInfo_IsLoadable(pClrRuntimeInfo, &bLoadable);
+/*
+ *----------------------------------------------------------------------
+ *
+ * GetClrHostString --
+ *
+ *	This function converts the specified Unicode string to the
+ *	string format used by the "hostfxr" library, i.e. UTF-16 on
+ *	Windows and UTF-8 elsewhere.  When a conversion is necessary,
+ *	the specified Tcl_DString is used to hold the result; it must
+ *	be initialized by the caller and freed afterward.
+ *
+ * Results:
+ *	The converted string.  The storage for it belongs to either the
+ *	original string or the Tcl_DString.
+ *
+ * Side effects:
+ *	None.
+ *
+ *----------------------------------------------------------------------
+ */
 
-	    if (PACKAGE_CAN_LOG(interp, logCommand)) {
-		gwprintf(buffer, PACKAGE_RESULT_SIZE,
-		    L"ICLRRuntimeInfo_IsLoadable(hResult = {0x%lX}, "
-		    L"bLoadable = {%d})", hResult, bLoadable);
+static const char_t *GetClrHostString(
+    LPCWSTR string,		/* The Unicode string to convert. */
+    Tcl_DString *dsPtr)		/* Storage for the converted string. */
+{
+#if defined(_WIN32)
+    return string;
+#else
+    return Tcl_UniCharToUtfDString(string, (int) gwcslen(string), dsPtr);
+#endif
+}
 
-		TclLog(interp, logCommand, buffer, NULL);
-	    }
+/*
+ *----------------------------------------------------------------------
+ *
+ * GetClrCoreTypeName --
+ *
+ *	This function qualifies the specified type name with the name
+ *	of the specified assembly, which is assumed to be the file name
+ *	of the assembly without its extension.  The "hostfxr" library
+ *	requires the type names to be qualified this way.  The result,
+ *	if not NULL, must be freed by the caller via the ckfree Tcl API.
+ *
+ * Results:
+ *	The qualified type name -OR- NULL if the specified type name is
+ *	already qualified or there is not enough memory.
+ *
+ * Side effects:
+ *	None.
+ *
+ *----------------------------------------------------------------------
+ */
 
-	    if (FAILED(hResult)) {
-		if (interp != NULL) {
-		    Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
-			GetClrErrorMessage(L"ICLRRuntimeInfo_IsLoadable",
-			    hResult), -1);
-		}
+static LPWSTR GetClrCoreTypeName(
+    LPCWSTR typeName,		/* The (unqualified) type name. */
+    LPCWSTR assemblyPath)	/* The path of the assembly containing the
+				 * type. */
+{
+    LPCWSTR pointer;
+    LPCWSTR assemblyName = assemblyPath;
+    LPCWSTR extension = NULL;
+    size_t typeLength;
+    size_t nameLength;
+    size_t length;
+    LPWSTR result;
 
-		code = TCL_ERROR;
-		goto done;
-	    }
+    /*
+     * NOTE: If the type name already contains a comma, it is assumed to be
+     *       qualified with the name of its assembly.
+     */
 
-	    if (!bLoadable) {
-		if (interp != NULL) {
-		    Tcl_AppendResult(interp, "CLR version \"", NULL);
+    for (pointer = typeName; *pointer != 0; pointer++)
+	if (*pointer == L',')
+	    return NULL;
 
-		    Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
-			clrVersion, -1);
+    /*
+     * NOTE: Find the file name of the assembly, without its directory and
+     *       extension.
+     */
 
-		    Tcl_AppendResult(interp, "\" not loadable\n", NULL);
-		}
+    for (pointer = assemblyPath; *pointer != 0; pointer++) {
+	if ((*pointer == L'/') || (*pointer == L'\\')) {
+	    assemblyName = pointer + 1;
+	    extension = NULL;
+	} else if (*pointer == L'.') {
+	    extension = pointer;
+	}
+    }
 
-		code = TCL_ERROR;
-		goto done;
-	    }
+    typeLength = gwcslen(typeName);
+    nameLength = (extension != NULL) ? (size_t) (extension - assemblyName) :
+	gwcslen(assemblyName);
 
-	    hResult = ICLRRuntimeInfo_GetInterface(pClrRuntimeInfo,
-		&CLSID_CLRRuntimeHost, &IID_ICLRRuntimeHost,
-		&pClrRuntimeHost);
+    length = typeLength + gwcslen(CLR_CORE_ASSEMBLY_NAME_SEPARATOR) +
+	nameLength + 1;
 
-	    if (PACKAGE_CAN_LOG(interp, logCommand)) {
-		gwprintf(buffer, PACKAGE_RESULT_SIZE,
-		    L"ICLRRuntimeInfo_GetInterface(hResult = {0x%lX}, "
-		    L"pClrRuntimeHost = {" PACKAGE_UNICODE_PTR_FMT L"})",
-		    hResult, pClrRuntimeHost);
+    result = (LPWSTR) attemptckalloc(length * sizeof(WCHAR));
 
-		TclLog(interp, logCommand, buffer, NULL);
-	    }
+    if (result == NULL)
+	return NULL;
 
-	    if (SUCCEEDED(hResult)) {
-		/*
-		 * NOTE: Ok, the CLR should now be loaded into the process.
-		 *       Vector to our normal CLR startup logic (below).
-		 */
+    memset(result, 0, length * sizeof(WCHAR));
 
-		goto start;
-	    } else {
-		if (interp != NULL) {
-		    Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
-			GetClrErrorMessage(L"ICLRRuntimeInfo_GetInterface",
-			    hResult), -1);
-		}
+    gwprintf(result, length - GWPRINTF_LENGTH_HAS_NUL, L"%s%s%.*s", typeName,
+	CLR_CORE_ASSEMBLY_NAME_SEPARATOR, (int) nameLength, assemblyName);
 
-		code = TCL_ERROR;
-		goto done;
-	    }
-	} else if (bStrict) {
-	    if (interp != NULL) {
-		Tcl_AppendResult(interp, "CLR already loaded\n", NULL);
-	    }
+    return result;
+}
 
-	    code = TCL_ERROR;
-	    goto done;
-	}
+/*
+ *----------------------------------------------------------------------
+ *
+ * GetClrCoreMethod --
+ *
+ *	This function returns a native function pointer that can be used
+ *	to call the specified CLR method.  The first time a CLR method is
+ *	requested, the runtime delegate obtained from the "hostfxr"
+ *	library is used to load the assembly containing it, if necessary,
+ *	and the resulting function pointer is cached.  After that, the
+ *	cached function pointer is simply returned.  This function uses
+ *	global state and assumes any required locks are already held by
+ *	the caller.
+ *
+ * Results:
+ *	The error code returned by the runtime delegate -OR- S_OK if the
+ *	function pointer was already cached.
+ *
+ * Side effects:
+ *	The assembly and its dependencies may be loaded, potentially
+ *	executing third-party CLR code.
+ *
+ *----------------------------------------------------------------------
+ */
 
-fallback:
-#endif
+static HRESULT GetClrCoreMethod(
+    ClrMethodInfo *pMethodInfo, /* Contains the information necessary for this
+				 * function to find the CLR method. */
+    ClrCoreMethodFnPtr *ppMethod) /* Upon success, the native function pointer
+				 * for the CLR method. */
+{
+    HRESULT hResult;
+    LPWSTR typeName = NULL;
+    ClrCoreMethodFnPtr pMethod = NULL;
+    Tcl_HashEntry *hPtr;
+    int isNew = 0;
+    Tcl_DString key;
+    Tcl_DString ds[4];
 
-	if (pClrRuntimeHost == NULL) {
-	    HRESULT hResult = CorBindToRuntimeEx(NULL, NULL, 0,
-		&CLSID_CLRRuntimeHost, &IID_ICLRRuntimeHost,
-		&pClrRuntimeHost);
+    /*
+     * NOTE: Build the key used to lookup the CLR method in the cache.  The
+     *       line-feed character cannot appear in any of its parts.
+     */
 
-	    if (PACKAGE_CAN_LOG(interp, logCommand)) {
-		gwprintf(buffer, PACKAGE_RESULT_SIZE,
-		    L"CorBindToRuntimeEx(hResult = {0x%lX}, "
-		    L"pClrRuntimeHost = {" PACKAGE_UNICODE_PTR_FMT L"})",
-		    hResult, pClrRuntimeHost);
+    Tcl_DStringInit(&key);
 
-		TclLog(interp, logCommand, buffer, NULL);
-	    }
+    Tcl_UniCharToUtfDString(pMethodInfo->assemblyPath,
+	(int) gwcslen(pMethodInfo->assemblyPath), &key);
 
-	    if (FAILED(hResult)) {
-		if (interp != NULL) {
-		    Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
-			GetClrErrorMessage(L"CorBindToRuntimeEx", hResult),
-			    -1);
-		}
+    Tcl_DStringAppend(&key, "\n", 1);
 
-		code = TCL_ERROR;
-		goto done;
-	    }
-	} else if (bStrict) {
-	    if (interp != NULL) {
-		Tcl_AppendResult(interp, "CLR already loaded\n", NULL);
-	    }
+    Tcl_UniCharToUtfDString(pMethodInfo->typeName,
+	(int) gwcslen(pMethodInfo->typeName), &key);
 
-	    code = TCL_ERROR;
-	    goto done;
-	}
+    Tcl_DStringAppend(&key, "\n", 1);
+
+    Tcl_UniCharToUtfDString(pMethodInfo->methodName,
+	(int) gwcslen(pMethodInfo->methodName), &key);
+
+    Tcl_DStringAppend(&key, "\n", 1);
+
+    Tcl_UniCharToUtfDString(pMethodInfo->delegateTypeName,
+	(int) gwcslen(pMethodInfo->delegateTypeName), &key);
+
+    if (!bClrCoreMethods) {
+	Tcl_InitHashTable(&clrCoreMethods, TCL_STRING_KEYS);
+	bClrCoreMethods = TRUE;
     }
 
-    /*
-     * NOTE: This label is only referenced if CLR v4 support is enabled at
-     *       compile-time; therefore, to avoid a compiler warning, we #ifdef
-     *       it out when that option is not enabled.
-     */
+    hPtr = Tcl_CreateHashEntry(&clrCoreMethods, Tcl_DStringValue(&key),
+	&isNew);
 
-#if defined(USE_CLR_40)
-start:
-#endif
+    Tcl_DStringFree(&key);
+
+    if (!isNew) {
+	*ppMethod = (ClrCoreMethodFnPtr) Tcl_GetHashValue(hPtr);
+	return S_OK;
+    }
+
+    Tcl_DStringInit(&ds[0]);
+    Tcl_DStringInit(&ds[1]);
+    Tcl_DStringInit(&ds[2]);
+    Tcl_DStringInit(&ds[3]);
+
+    typeName = GetClrCoreTypeName(pMethodInfo->typeName,
+	pMethodInfo->assemblyPath);
+
+    hResult = pClrLoadAssembly(
+	GetClrHostString(pMethodInfo->assemblyPath, &ds[0]),
+	GetClrHostString((typeName != NULL) ? typeName :
+	    pMethodInfo->typeName, &ds[1]),
+	GetClrHostString(pMethodInfo->methodName, &ds[2]),
+	GetClrHostString(pMethodInfo->delegateTypeName, &ds[3]),
+	NULL, (void **) &pMethod);
+
+    if (typeName != NULL) {
+	ckfree((LPVOID) typeName);
+	typeName = NULL;
+    }
+
+    Tcl_DStringFree(&ds[3]);
+    Tcl_DStringFree(&ds[2]);
+    Tcl_DStringFree(&ds[1]);
+    Tcl_DStringFree(&ds[0]);
 
     /*
-     * NOTE: Has the CLR been started in this process [by this package] yet?
-     *       If not, try to do it now.
+     * NOTE: Only cache the function pointer if it was actually obtained;
+     *       otherwise, the next attempt will try to resolve it again.
      */
 
-    if (bStart) {
-	if (pClrRuntimeHost == NULL) {
-	    if (interp != NULL) {
-		Tcl_AppendResult(interp, "CLR not loaded\n", NULL);
+    if (SUCCEEDED(hResult) && (pMethod != NULL)) {
+	Tcl_SetHashValue(hPtr, (ClientData) pMethod);
+	*ppMethod = pMethod;
+    } else {
+	Tcl_DeleteHashEntry(hPtr);
+    }
+
+    return hResult;
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * FreeClrCoreMethods --
+ *
+ *	This function forgets all the native function pointers that have
+ *	been cached by the GetClrCoreMethod function.  It must be called
+ *	whenever the runtime delegate used to obtain them is no longer
+ *	valid.  This function uses global state and assumes any required
+ *	locks are already held by the caller.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	None.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static void FreeClrCoreMethods(void)
+{
+    if (bClrCoreMethods) {
+	Tcl_DeleteHashTable(&clrCoreMethods);
+	bClrCoreMethods = FALSE;
+    }
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * GetClrCoreVersion --
+ *
+ *	This function queries the version of the shared framework that
+ *	was selected by the "hostfxr" library.  There is no runtime
+ *	property for it; however, the dependencies file for the shared
+ *	framework is always located in a directory named after it.
+ *	This function uses global state and assumes any required locks
+ *	are already held by the caller.
+ *
+ * Results:
+ *	The error code returned by the "hostfxr" library.
+ *
+ * Side effects:
+ *	None.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static HRESULT GetClrCoreVersion(
+    LPWSTR buffer,		/* Upon success, the version string. */
+    size_t size)		/* The size of the buffer, in characters. */
+{
+    HRESULT hResult;
+    const char_t *value = NULL;
+    LPCWSTR path;
+    LPCWSTR pointer;
+    LPCWSTR start = NULL;
+    LPCWSTR end = NULL;
+    Tcl_DString ds;
+
+    hResult = pHostFxrGetProperty(hClrHostContext,
+	CLR_CORE_VERSION_PROPERTY_NAME, &value);
+
+    if (FAILED(hResult) || (value == NULL))
+	return hResult;
+
+    Tcl_DStringInit(&ds);
+
+#if defined(_WIN32)
+    path = value;
+#else
+    path = (LPCWSTR) Tcl_UtfToUniCharDString(value, -1, &ds);
+#endif
+
+    /*
+     * NOTE: Find the directory containing the file, e.g. "8.0.0" from the
+     *       path ".../shared/Microsoft.NETCore.App/8.0.0/<file>".
+     */
+
+    for (pointer = path; *pointer != 0; pointer++) {
+	if ((*pointer == L'/') || (*pointer == L'\\')) {
+	    start = end;
+	    end = pointer;
+	}
+    }
+
+    if (start != NULL) {
+	gwprintf(buffer, size, L"v%.*s", (int) (end - start - 1), start + 1);
+    } else {
+	gwcsncpy(buffer, path, size);
+    }
+
+    Tcl_DStringFree(&ds);
+    return hResult;
+}
+#endif
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * IsTheClrLoaded --
+ *
+ *	This function checks if the CLR has been loaded by this package.
+ *	This function uses global state and assumes any required locks
+ *	are already held by the caller.
+ *
+ * Results:
+ *	Non-zero if the CLR has been loaded, zero otherwise.
+ *
+ * Side effects:
+ *	None.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static BOOL IsTheClrLoaded(void)
+{
+#if defined(USE_CLR_CORE)
+    return (hClrHostContext != NULL);
+#else
+    return (pClrRuntimeHost != NULL);
+#endif
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * LoadAndStartTheClr --
+ *
+ *	This function loads and optionally starts the latest version of
+ *	the CLR supported by this package.
+ *
+ * Results:
+ *	A standard Tcl result.
+ *
+ * Side effects:
+ *	Since the CLR may execute startup code, this function may
+ *	have arbitrary side-effects.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static int LoadAndStartTheClr(
+    Tcl_Interp *interp,	    /* Current Tcl interpreter.*/
+    LPCWSTR logCommand,	    /* The Tcl command used to log the CLR method
+			     * execution, if any. */
+    LPCWSTR runtimeConfigPath, /* The runtime configuration file used to
+			     * load the CLR via the "hostfxr" library, if
+			     * applicable. */
+    BOOL bLoad,		    /* Load the CLR if necessary? */
+    BOOL bUseMinimumClr,    /* Force using minimum supported CLR
+			     * version? */
+    BOOL bStart,	    /* Start the CLR after loading it? */
+    BOOL bStrict)	    /* Fail if already loaded and/or started? */
+{
+    int code = TCL_OK;
+    WCHAR buffer[PACKAGE_RESULT_SIZE + 1] = {0};
+
+    LockPackage();
+
+    /*
+     * NOTE: Has the CLR been loaded into this process [by this package] yet?
+     *       If not, try to do it now.
+     */
+
+    if (bLoad) {
+#if defined(USE_CLR_CORE)
+	if (hClrHostContext == NULL) {
+	    HRESULT hResult;
+	    Tcl_DString ds;
+
+	    if (runtimeConfigPath == NULL) {
+		if (interp != NULL) {
+		    Tcl_AppendResult(interp,
+			"runtime configuration path not set\n", NULL);
+		}
+
+		code = TCL_ERROR;
+		goto done;
+	    }
+
+	    code = LoadTheHostFxr(interp, logCommand);
+
+	    if (code != TCL_OK)
+		goto done;
+
+	    /*
+	     * NOTE: The runtime configuration file determines which version
+	     *       of the CLR is loaded; therefore, the bUseMinimumClr flag
+	     *       is not used here.
+	     */
+
+	    Tcl_DStringInit(&ds);
+
+	    hResult = pHostFxrInitialize(
+		GetClrHostString(runtimeConfigPath, &ds), NULL,
+		&hClrHostContext);
+
+	    Tcl_DStringFree(&ds);
+
+	    if (PACKAGE_CAN_LOG(interp, logCommand)) {
+		gwprintf(buffer, PACKAGE_RESULT_SIZE,
+		    L"hostfxr_initialize_for_runtime_config("
+		    L"hResult = {0x%lX}, hClrHostContext = {" PACKAGE_UNICODE_PTR_FMT L"})",
+		    hResult, hClrHostContext);
+
+		TclLog(interp, logCommand, buffer, NULL);
+	    }
+
+	    if (FAILED(hResult)) {
+		if (hClrHostContext != NULL) {
+		    pHostFxrClose(hClrHostContext);
+		    hClrHostContext = NULL;
+		}
+
+		if (interp != NULL) {
+		    Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
+			GetClrErrorMessage(
+			    L"hostfxr_initialize_for_runtime_config",
+			    hResult), -1);
+		}
+
+		code = TCL_ERROR;
+		goto done;
+	    }
+	} else if (bStrict) {
+	    if (interp != NULL) {
+		Tcl_AppendResult(interp, "CLR already loaded\n", NULL);
 	    }
 
 	    code = TCL_ERROR;
 	    goto done;
 	}
+#else
+#if defined(USE_CLR_40)
+	if (pClrRuntimeHost == NULL) {
+	    HRESULT hResult;
+	    LPCWSTR clrVersion;
+	    BOOL bLoadable = FALSE;
 
-	if (!bClrStarted) {
-	    HRESULT hResult = ICLRRuntimeHost_Start(pClrRuntimeHost);
+	    /*
+	     * NOTE: We link to the "MSCorEE" library; therefore, it should
+	     *       already be loaded (i.e. no need to call LoadLibrary here).
+	     *       However, we need the loaded module handle for our call to
+	     *       GetProcAddress; therefore, get the existing module handle
+	     *       using the GetModuleHandle function.
+	     */
+
+	    /* NON-PORTABLE */
+	    CLRCreateInstanceFnPtr pClrCreateInstance =
+		(CLRCreateInstanceFnPtr) GetProcAddress(GetModuleHandleW(
+		    UNICODE_TEXT(CLR_MODULE_NAME)), CLR_PROC_NAME);
+
+	    if (PACKAGE_CAN_LOG(interp, logCommand)) {
+		gwprintf(buffer, PACKAGE_RESULT_SIZE,
+		    L"GetProcAddress(pClrCreateInstance = {"
+		    PACKAGE_UNICODE_PTR_FMT L"})", pClrCreateInstance);
+
+		TclLog(interp, logCommand, buffer, NULL);
+	    }
+
+	    if (pClrCreateInstance == NULL) {
+		goto fallback;
+	    }
+
+	    hResult = pClrCreateInstance(&CLSID_CLRMetaHost, &IID_ICLRMetaHost,
+		&pClrMetaHost);
+
+	    if (PACKAGE_CAN_LOG(interp, logCommand)) {
+		gwprintf(buffer, PACKAGE_RESULT_SIZE,
+		    L"pClrCreateInstance(hResult = {0x%lX}, "
+		    L"pClrMetaHost = {" PACKAGE_UNICODE_PTR_FMT L"})",
+		    hResult, pClrMetaHost);
+
+		TclLog(interp, logCommand, buffer, NULL);
+	    }
+
+	    if (FAILED(hResult)) {
+		/*
+		 * NOTE: According to Brad Wilson's [MSFT] blog post "Selecting
+		 *       CLR Version From Unmanaged Host", dated 2010/04/19, if
+		 *       E_NOTIMPL is returned from the CLRCreateInstance
+		 *       function, we should simply try to load the CLR using
+		 *       the "legacy" path (i.e. the CorBindToRuntimeEx
+		 *       function).  However, this return value is not called
+		 *       out in the MSDN documentation for this function.
+		 */
+
+		if (hResult == E_NOTIMPL) {
+		    goto fallback;
+		}
+
+		if (interp != NULL) {
+		    Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
+			GetClrErrorMessage(L"pClrCreateInstance", hResult),
+			    -1);
+		}
+
+		code = TCL_ERROR;
+		goto done;
+	    }
+
+	    /*
+	     * NOTE: By default, we want to load the latest supported version
+	     *       of the CLR (e.g. "v4.0.30319").  However, this loading
+	     *       behavior can now be overridden by setting the environment
+	     *       variable named "UseMinimumClr" [to anything] -OR- by
+	     *       setting the Tcl variable "useMinimumClr" (in the namespace
+	     *       of the package) to non-zero.  In that case, the minimum
+	     *       supported version of the CLR will be loaded instead (e.g.
+	     *       "v2.0.50727").
+	     */
+
+	    if (bUseMinimumClr) {
+		/*
+		 * NOTE: Ok, the environment variable is set, use the minimum
+		 *       supported version of the CLR instead of the latest.
+		 */
+
+		clrVersion = UNICODE_TEXT(CLR_VERSION_MINIMUM);
+	    } else {
+		/*
+		 * NOTE: Ok, use the latest supported version of the CLR.
+		 */
+
+		clrVersion = UNICODE_TEXT(CLR_VERSION_LATEST);
+	    }
 
 	    if (PACKAGE_CAN_LOG(interp, logCommand)) {
 		gwprintf(buffer, PACKAGE_RESULT_SIZE,
-		    L"ICLRRuntimeHost_Start(hResult = {0x%lX})", hResult);
+		    L"BEFORE ICLRMetaHost_GetRuntime(pClrMetaHost = {"
+		    PACKAGE_UNICODE_PTR_FMT L"}, clrVersion = {%s})",
+		    pClrMetaHost, clrVersion);
 
 		TclLog(interp, logCommand, buffer, NULL);
 	    }
 
-	    if (SUCCEEDED(hResult)) {
-		bClrStarted = TRUE;
-	    } else {
-		Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
-		    GetClrErrorMessage(L"ICLRRuntimeHost_Start", hResult),
-			-1);
+	    /*
+	     * NOTE: Apparently, a NULL version string cannot be used here to
+	     *       mean "give me the latest version available" and that means
+	     *       we have to hard-code it.
+	     */
+
+	    hResult = ICLRMetaHost_GetRuntime(pClrMetaHost, clrVersion,
+		&IID_ICLRRuntimeInfo, &pClrRuntimeInfo);
+
+	    if (PACKAGE_CAN_LOG(interp, logCommand)) {
+		gwprintf(buffer, PACKAGE_RESULT_SIZE,
+		    L"AFTER ICLRMetaHost_GetRuntime(hResult = {0x%lX}, "
+		    L"pClrRuntimeInfo = {" PACKAGE_UNICODE_PTR_FMT L"})",
+		    hResult, pClrRuntimeInfo);
+
+		TclLog(interp, logCommand, buffer, NULL);
+	    }
+
+	    if (FAILED(hResult)) {
+		if (interp != NULL) {
+		    Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
+			GetClrErrorMessage(L"ICLRMetaHost_GetRuntime",
+			    hResult), -1);
+		}
+
+		code = TCL_ERROR;
+		goto done;
+	    }
+
+	    /*
+	     * NOTE: Check if the version of the CLR that we want to load can
+	     *       actually be loaded into this process.
+	     */
+
+	    hResult = ICLRRuntimeInfo_IsLoadable(pClrRuntimeInfo, &bLoadable);
+
+	    if (PACKAGE_CAN_LOG(interp, logCommand)) {
+		gwprintf(buffer, PACKAGE_RESULT_SIZE,
+		    L"ICLRRuntimeInfo_IsLoadable(hResult = {0x%lX}, "
+		    L"bLoadable = {%d})", hResult, bLoadable);
+
+		TclLog(interp, logCommand, buffer, NULL);
+	    }
+
+	    if (FAILED(hResult)) {
+		if (interp != NULL) {
+		    Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
+			GetClrErrorMessage(L"ICLRRuntimeInfo_IsLoadable",
+			    hResult), -1);
+		}
+
+		code = TCL_ERROR;
+		goto done;
+	    }
+
+	    if (!bLoadable) {
+		if (interp != NULL) {
+		    Tcl_AppendResult(interp, "CLR version \"", NULL);
+
+		    Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
+			clrVersion, -1);
+
+		    Tcl_AppendResult(interp, "\" not loadable\n", NULL);
+		}
+
+		code = TCL_ERROR;
+		goto done;
+	    }
+
+	    hResult = ICLRRuntimeInfo_GetInterface(pClrRuntimeInfo,
+		&CLSID_CLRRuntimeHost, &IID_ICLRRuntimeHost,
+		&pClrRuntimeHost);
+
+	    if (PACKAGE_CAN_LOG(interp, logCommand)) {
+		gwprintf(buffer, PACKAGE_RESULT_SIZE,
+		    L"ICLRRuntimeInfo_GetInterface(hResult = {0x%lX}, "
+		    L"pClrRuntimeHost = {" PACKAGE_UNICODE_PTR_FMT L"})",
+		    hResult, pClrRuntimeHost);
+
+		TclLog(interp, logCommand, buffer, NULL);
+	    }
+
+	    if (SUCCEEDED(hResult)) {
+		/*
+		 * NOTE: Ok, the CLR should now be loaded into the process.
+		 *       Vector to our normal CLR startup logic (below).
+		 */
+
+		goto start;
+	    } else {
+		if (interp != NULL) {
+		    Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
+			GetClrErrorMessage(L"ICLRRuntimeInfo_GetInterface",
+			    hResult), -1);
+		}
+
+		code = TCL_ERROR;
+		goto done;
+	    }
+	} else if (bStrict) {
+	    if (interp != NULL) {
+		Tcl_AppendResult(interp, "CLR already loaded\n", NULL);
+	    }
+
+	    code = TCL_ERROR;
+	    goto done;
+	}
+
+fallback:
+#endif
+
+	if (pClrRuntimeHost == NULL) {
+	    HRESULT hResult = CorBindToRuntimeEx(NULL, NULL, 0,
+		&CLSID_CLRRuntimeHost, &IID_ICLRRuntimeHost,
+		&pClrRuntimeHost);
+
+	    if (PACKAGE_CAN_LOG(interp, logCommand)) {
+		gwprintf(buffer, PACKAGE_RESULT_SIZE,
+		    L"CorBindToRuntimeEx(hResult = {0x%lX}, "
+		    L"pClrRuntimeHost = {" PACKAGE_UNICODE_PTR_FMT L"})",
+		    hResult, pClrRuntimeHost);
+
+		TclLog(interp, logCommand, buffer, NULL);
+	    }
+
+	    if (FAILED(hResult)) {
+		if (interp != NULL) {
+		    Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
+			GetClrErrorMessage(L"CorBindToRuntimeEx", hResult),
+			    -1);
+		}
+
+		code = TCL_ERROR;
+		goto done;
+	    }
+	} else if (bStrict) {
+	    if (interp != NULL) {
+		Tcl_AppendResult(interp, "CLR already loaded\n", NULL);
+	    }
+
+	    code = TCL_ERROR;
+	    goto done;
+	}
+#endif
+    }
+
+    /*
+     * NOTE: This label is only referenced if CLR v4 support is enabled at
+     *       compile-time; therefore, to avoid a compiler warning, we #ifdef
+     *       it out when that option is not enabled.
+     */
+
+#if defined(USE_CLR_40)
+start:
+#endif
+
+    /*
+     * NOTE: Has the CLR been started in this process [by this package] yet?
+     *       If not, try to do it now.
+     */
+
+    if (bStart) {
+	if (!IsTheClrLoaded()) {
+	    if (interp != NULL) {
+		Tcl_AppendResult(interp, "CLR not loaded\n", NULL);
+	    }
+
+	    code = TCL_ERROR;
+	    goto done;
+	}
+
+	if (!bClrStarted) {
+#if defined(USE_CLR_CORE)
+	    /*
+	     * NOTE: When using the "hostfxr" library, the CLR is actually
+	     *       started by the first request for a runtime delegate.
+	     */
+
+	    LPCWSTR procName = L"hostfxr_get_runtime_delegate";
+
+	    HRESULT hResult = pHostFxrGetDelegate(hClrHostContext,
+		hdt_load_assembly_and_get_function_pointer,
+		(void **) &pClrLoadAssembly);
+#else
+	    LPCWSTR procName = L"ICLRRuntimeHost_Start";
+	    HRESULT hResult = ICLRRuntimeHost_Start(pClrRuntimeHost);
+#endif
+
+	    if (PACKAGE_CAN_LOG(interp, logCommand)) {
+		gwprintf(buffer, PACKAGE_RESULT_SIZE,
+		    L"%s(hResult = {0x%lX})", procName, hResult);
+
+		TclLog(interp, logCommand, buffer, NULL);
+	    }
+
+	    if (SUCCEEDED(hResult)) {
+		bClrStarted = TRUE;
+	    } else {
+		Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
+		    GetClrErrorMessage(procName, hResult), -1);
+
+		code = TCL_ERROR;
+		goto done;
+	    }
+	} else if (bStrict) {
+	    if (interp != NULL) {
+		Tcl_AppendResult(interp, "CLR already started\n", NULL);
+	    }
+
+	    code = TCL_ERROR;
+	    goto done;
+	}
+    }
+
+done:
+    UnlockPackage();
+    return code;
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * StopAndReleaseTheClr --
+ *
+ *	This function stops and releases the CLR.
+ *
+ * Results:
+ *	A standard Tcl result.
+ *
+ * Side effects:
+ *	Since the CLR may execute cleanup code, this function may have
+ *	arbitrary side-effects.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static int StopAndReleaseTheClr(
+    Tcl_Interp *interp,	    /* Current Tcl interpreter. */
+    LPCWSTR logCommand,	    /* The Tcl command used to log the CLR method
+			     * execution, if any. */
+    BOOL bRelease,	    /* Release the CLR after stopping it? */
+    BOOL bStrict)	    /* Fail if already stopped and/or released? */
+{
+    int code = TCL_OK;
+    WCHAR buffer[PACKAGE_RESULT_SIZE + 1] = {0};
+
+    LockPackage();
+
+    if (IsTheClrLoaded()) {
+	/*
+	 * NOTE: If we were previously able to start the CLR, stop it now.
+	 */
+
+	if (bClrStarted) {
+#if defined(USE_CLR_CORE)
+	    /*
+	     * NOTE: The "hostfxr" library provides no way to stop the CLR
+	     *       once it has been started; therefore, simply forget the
+	     *       runtime delegate, and the function pointers obtained via
+	     *       it, so that no more CLR code is executed via this package
+	     *       until it is started again.
+	     */
+
+	    FreeClrCoreMethods();
+	    pClrLoadAssembly = NULL;
+	    bClrStarted = FALSE;
+#else
+	    HRESULT hResult = S_OK;
+
+	    /* NON-PORTABLE */
+	    SetEnvironmentVariableW(CLR_STOPPING_ENVVAR_NAME, L"1");
+
+	    hResult = ICLRRuntimeHost_Stop(pClrRuntimeHost);
+
+	    /* NON-PORTABLE */
+	    SetEnvironmentVariableW(CLR_STOPPING_ENVVAR_NAME, NULL);
+
+	    if (PACKAGE_CAN_LOG(interp, logCommand)) {
+		gwprintf(buffer, PACKAGE_RESULT_SIZE,
+		    L"ICLRRuntimeHost_Stop(hResult = {0x%lX})", hResult);
+
+		TclLog(interp, logCommand, buffer, NULL);
+	    }
+
+	    if (SUCCEEDED(hResult)) {
+		bClrStarted = FALSE;
+	    } else {
+		if (interp != NULL) {
+		    Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
+			GetClrErrorMessage(L"ICLRRuntimeHost_Stop", hResult),
+			    -1);
+		}
+
+		code = TCL_ERROR;
+		goto done;
+	    }
+#endif
+	} else if (bStrict) {
+	    if (interp != NULL) {
+		Tcl_AppendResult(interp, "CLR not started\n", NULL);
+	    }
+
+	    code = TCL_ERROR;
+	    goto done;
+	}
+
+	/*
+	 * NOTE: Should we also release the COM reference to the CLR runtime
+	 *       host?
+	 */
+
+	if (bRelease) {
+#if defined(USE_CLR_CORE)
+	    /*
+	     * NOTE: Closing the host context does not unload the CLR; it
+	     *       will remain loaded until the process exits.
+	     */
+
+	    HRESULT hResult = pHostFxrClose(hClrHostContext);
+
+	    hClrHostContext = NULL;
+
+	    if (PACKAGE_CAN_LOG(interp, logCommand)) {
+		gwprintf(buffer, PACKAGE_RESULT_SIZE,
+		    L"hostfxr_close(hResult = {0x%lX})", hResult);
+
+		TclLog(interp, logCommand, buffer, NULL);
+	    }
+#else
+	    ULONG result = ICLRRuntimeHost_Release(pClrRuntimeHost);
+
+	    pClrRuntimeHost = NULL;
+
+	    if (PACKAGE_CAN_LOG(interp, logCommand)) {
+		gwprintf(buffer, PACKAGE_RESULT_SIZE,
+		    L"ICLRRuntimeHost_Release(result = {%lu})", result);
+
+		TclLog(interp, logCommand, buffer, NULL);
+	    }
+#endif
+	}
+    } else if (bStrict) {
+	if (interp != NULL) {
+	    Tcl_AppendResult(interp, "CLR not loaded\n", NULL);
+	}
+
+	code = TCL_ERROR;
+	goto done;
+    }
+
+#if defined(USE_CLR_40)
+    /*
+     * BUGFIX: Only release these interface pointers if we released the CLR
+     *         runtime host (above).
+     */
+
+    if (bRelease) {
+	if (pClrRuntimeInfo != NULL) {
+	    ICLRRuntimeInfo_Release(pClrRuntimeInfo);
+	    pClrRuntimeInfo = NULL;
+	}
+
+	if (pClrMetaHost != NULL) {
+	    ICLRMetaHost_Release(pClrMetaHost);
+	    pClrMetaHost = NULL;
+	}
+    }
+#endif
+
+done:
+
+    /*
+     * BUGFIX: If the CLR has been stopped, then the bridge cannot be
+     *         running either.
+     */
+
+    if ((code == TCL_OK) && bBridgeStarted) {
+	bBridgeStarted = FALSE;
+
+	if (PACKAGE_CAN_LOG(interp, logCommand)) {
+	    TclLog(interp, logCommand,
+		L"WARNING: CLR was stopped with bridge running.", NULL);
+	}
+    }
+
+    UnlockPackage();
+    return code;
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * CanExecuteClrCode --
+ *
+ *	This function checks if CLR code can safely be executed by this
+ *	package.
+ *
+ * Results:
+ *	Non-zero if CLR code can be safely executed by this package,
+ *	zero otherwise.
+ *
+ * Side effects:
+ *	None.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static BOOL CanExecuteClrCode(
+    Tcl_Interp *interp)			/* Current Tcl interpreter. */
+{
+    BOOL bResult = FALSE;
+
+    LockPackage();
+
+    if (!IsTheClrLoaded()) {
+	if (interp != NULL) {
+	    Tcl_AppendResult(interp, "CLR not loaded\n", NULL);
+	}
+
+	goto done;
+    }
+
+    if (!bClrStarted) {
+	if (interp != NULL) {
+	    Tcl_AppendResult(interp, "CLR not started\n", NULL);
+	}
+
+	goto done;
+    }
+
+    bResult = TRUE;
+
+done:
+    UnlockPackage();
+    return bResult;
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * FreeClrProtocolResult --
+ *
+ *	This function frees the result string returned by a CLR method
+ *	via the specified protocol data structure.  The storage for it
+ *	was allocated by the CLR via the CoTaskMemAlloc function, which
+ *	is the same as the malloc function on non-Windows platforms.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	None.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static void FreeClrProtocolResult(
+    ClrProtocolData *pProtocolData) /* The protocol data structure. */
+{
+    if (pProtocolData->result != NULL) {
+#if defined(_WIN32)
+	CoTaskMemFree(pProtocolData->result);
+#else
+	free(pProtocolData->result);
+#endif
+
+	pProtocolData->result = NULL;
+    }
+
+    pProtocolData->resultLength = 0;
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * ExecuteClrMethod --
+ *
+ *	This function executes the specified CLR method.
+ *
+ * Results:
+ *	A standard Tcl result.
+ *
+ * Side effects:
+ *	Since third-party code is executed during this function, there
+ *	may be arbitrary side-effects.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static int ExecuteClrMethod(
+    HANDLE hModule,		/* Tcl library module handle. */
+    ClrTclStubs *pTclStubs,	/* Tcl C API stub function pointer table. */
+    Tcl_Interp *interp,		/* Current Tcl interpreter. */
+    LPCWSTR logCommand,		/* The Tcl command used to log the CLR method
+				 * execution, if any. */
+    ClrMethodInfo *pMethodInfo, /* Contains the information necessary for this
+				 * function to execute the CLR method. */
+    LPCWSTR argument,		/* Extra argument to the method, if any. */
+    int objc,			/* Number of extra argument objects, if any. */
+    Tcl_Obj *CONST objv[],	/* Extra argument objects for the method, if
+				 * any.  These are used instead of the extra
+				 * argument string, if any. */
+    MethodFlags methodFlags,	/* Flags that control logging, arguments, etc.
+				 * See the MethodFlags enum for details. */
+    LPDWORD pReturnValue)	/* Location where the return value should be
+				 * stored or NULL if the return value is not
+				 * required. */
+{
+    int code = TCL_OK;
+    BOOL bUseProtocolR1;
+    BOOL bUseProtocolR2;
+    BOOL bUseProtocolR3;
+    BOOL bLegacyProtocol;
+    BOOL bUseIsolation;
+    BOOL bUseSafeInterp;
+    BOOL bLogExecute;
+    BOOL bCanExecute;
+    LPWSTR protocolRevision = NULL;
+    LPWSTR newArgument = NULL;
+    Tcl_Obj *listPtr = NULL;
+    ClrProtocolData protocolData;
+    int argumentLength = 0;
+    HRESULT hResult;
+    DWORD returnValue = TCL_OK;
+#if defined(USE_CLR_CORE)
+    ClrCoreMethodFnPtr pMethod = NULL;
+#else
+    ICLRRuntimeHost *pRuntimeHost = NULL;
+#endif
+
+    if (pMethodInfo == NULL) {
+	if (interp != NULL) {
+	    Tcl_AppendResult(interp, "invalid method information\n", NULL);
+	}
+
+	return TCL_ERROR;
+    }
+
+    memset(&protocolData, 0, sizeof(ClrProtocolData));
+
+    /*
+     * NOTE: The package mutex is only held while checking the state of the
+     *       CLR and obtaining what is needed to execute the CLR method.  It
+     *       is NOT held while the CLR method is being executed; otherwise,
+     *       only one CLR method could be executed at a time in the entire
+     *       process, even when the Tcl interpreters are in different threads.
+     *       The CLR cannot be unloaded; therefore, the function pointer for
+     *       the CLR method remains valid even if the CLR is stopped by some
+     *       other thread while it is being executed.  Likewise, an extra COM
+     *       reference to the CLR runtime host is held while executing it.
+     */
+
+    LockPackage();
+
+    /*
+     * NOTE: If the CLR is either not loaded -OR- not started, then we cannot
+     *	     use it to execute any code.
+     */
+
+    bCanExecute = CanExecuteClrCode(interp);
+
+    if (bCanExecute) {
+#if defined(USE_CLR_CORE)
+	hResult = GetClrCoreMethod(pMethodInfo, &pMethod);
+#else
+	pRuntimeHost = pClrRuntimeHost;
+	ICLRRuntimeHost_AddRef(pRuntimeHost);
+	hResult = S_OK;
+#endif
+    }
+
+    UnlockPackage();
+
+    if (!bCanExecute) {
+	code = TCL_ERROR;
+	goto done;
+    }
+
+    bUseProtocolR1 = (methodFlags & METHOD_PROTOCOL_V1R1);
+    bUseProtocolR2 = (methodFlags & METHOD_PROTOCOL_V1R2);
+    bUseProtocolR3 = bUseProtocolR1 && (methodFlags & METHOD_PROTOCOL_V1R3);
+    bLegacyProtocol = (methodFlags & METHOD_PROTOCOL_LEGACY);
+    bUseIsolation = (methodFlags & METHOD_USE_ISOLATION);
+    bUseSafeInterp = (methodFlags & METHOD_USE_SAFE_INTERP);
+
+    /*
+     * NOTE: Unless the native-to-managed code protocol (V1R3) is in use, the
+     *       extra argument objects, if any, must be converted to one string,
+     *       which is a well-formed Tcl list.
+     */
+
+    if ((objv != NULL) && !bUseProtocolR3) {
+	listPtr = Tcl_NewListObj(objc, objv);
+
+	if (listPtr == NULL) {
+	    if (interp != NULL) {
+		Tcl_AppendResult(interp, "out of memory: listPtr\n", NULL);
+	    }
+
+	    code = TCL_ERROR;
+	    goto done;
+	}
+
+	Tcl_IncrRefCount(listPtr);
+	argument = Tcl_GetUnicode(listPtr);
+    }
+
+    if (bUseProtocolR3) {
+	size_t length = 0;
+
+	/*
+	 * NOTE: Everything is passed to the CLR method via the protocol data
+	 *       structure, including the configured argument and the extra
+	 *       arguments, if any; only its address is converted to a string.
+	 *       The extra arguments are passed as-is, i.e. there is no need
+	 *       to build a list from them and then parse that list again.
+	 */
+
+	protocolData.sizeOf = sizeof(ClrProtocolData);
+	protocolData.hModule = hModule;
+	protocolData.pTclStubs = pTclStubs;
+	protocolData.interp = interp;
+
+	if (bUseIsolation)
+	    protocolData.flags |= PROTOCOL_USE_ISOLATION;
+
+	if (bUseSafeInterp)
+	    protocolData.flags |= PROTOCOL_USE_SAFE_INTERP;
+
+	if (pMethodInfo->argument != NULL) {
+	    protocolData.argument = pMethodInfo->argument;
+	    protocolData.argumentLength = (int) gwcslen(pMethodInfo->argument);
+	}
+
+	if (objv != NULL) {
+	    int index;
+
+	    if (objc > 0) {
+		protocolData.argv = (LPCWSTR *) attemptckalloc(
+		    objc * sizeof(LPCWSTR));
+
+		protocolData.argl = (int *) attemptckalloc(objc * sizeof(int));
+
+		if ((protocolData.argv == NULL) ||
+			(protocolData.argl == NULL)) {
+		    if (interp != NULL) {
+			Tcl_AppendResult(interp, "out of memory: argv\n", NULL);
+		    }
+
+		    code = TCL_ERROR;
+		    goto done;
+		}
+
+		for (index = 0; index < objc; index++) {
+		    protocolData.argv[index] = (LPCWSTR) Tcl_GetUnicodeFromObj(
+			objv[index], &protocolData.argl[index]);
+		}
+
+		protocolData.objc = objc;
+		protocolData.objv = objv;
+	    }
+	} else if (argument != NULL) {
+	    argumentLength = (int) gwcslen(argument);
+
+	    protocolData.objc = 1;
+	    protocolData.argv = &argument;
+	    protocolData.argl = &argumentLength;
+	}
+
+	length += gwcslen(PACKAGE_UNICODE_NAME) + 1; /* strlen("Garuda_") */
+	length += gwcslen(PACKAGE_UNICODE_PROTOCOL_V1R3) + 1; /* "vX.0_rY.0 " */
+	length += (sizeof(LPVOID) * 2) + 2; /* "0x" + hexPtrAsStr */
+	length++; /* NUL terminator character. */
+
+	newArgument = (LPWSTR) attemptckalloc(length * sizeof(WCHAR));
+
+	if (newArgument == NULL) {
+	    if (interp != NULL) {
+		Tcl_AppendResult(interp, "out of memory: newArgument\n", NULL);
+	    }
+
+	    code = TCL_ERROR;
+	    goto done;
+	}
+
+	memset(newArgument, 0, length * sizeof(WCHAR));
+
+	gwprintf(newArgument, length - GWPRINTF_LENGTH_HAS_NUL,
+	    L"%s_%s " PACKAGE_UNICODE_PTR_FMT L"\0", PACKAGE_UNICODE_NAME,
+	    PACKAGE_UNICODE_PROTOCOL_V1R3, &protocolData);
+    } else if ((argument != NULL) || bUseProtocolR1) {
+	size_t length = 0;
+
+	/*
+	 * NOTE: If an argument is present in the method information (i.e. this
+	 *       method has been configured by the package to use it), add the
+	 *       entire length of the argument plus one space to separate it
+	 *       from the rest of the final argument string.
+	 */
+
+	if (pMethodInfo->argument != NULL)
+	    length += gwcslen(pMethodInfo->argument) + 1; /* argument + " " */
+
+	/*
+	 * NOTE: If an extra argument was supplied by the caller, add the
+	 *       entire length of the argument plus one space to separate it
+	 *       from the rest of the final argument string.
+	 */
+
+	if (argument != NULL)
+	    length += gwcslen(argument) + 1; /* argument + space. */
+
+	/*
+	 * NOTE: Do we need to prepend additional information required by our
+	 *       native-to-managed code protocol (V1)?  The reason a "protocol"
+	 *       is required at all is because the native CLR API only allows
+	 *       us to pass one string argument to the target CLR method;
+	 *       therefore, we have to make the most of it.
+	 */
+
+	if (bUseProtocolR1) {
+	    /*
+	     * HACK: Build the final argument string to pass to CLR method.  We
+	     *       need to include the Tcl library module handle and a pointer
+	     *       to the Tcl interpreter here in order for Eagle to build a
+	     *       bridge back to us.  Since the type signature of the method
+	     *       only allows us to pass a single string argument, we must
+	     *       convert the Tcl library module handle and the Tcl
+	     *       interpreter pointer to strings and then add any arguments
+	     *       supplied by the configuration or our immediate caller
+	     *       after that.  The final argument string MUST parse as a
+	     *       valid list; otherwise, the CLR method MAY simply refuse to
+	     *       process it.  We also include a prefix indicating the
+	     *       version of the "protocol" that is in use (currently
+	     *       "Garuda_v1.0" or "Garuda_v1.0_r2.0") and a Tcl interpreter
+	     *       "safety indicator" (i.e. logical boolean) after the Tcl
+	     *       interpreter pointer.
+	     */
+
+	    length += gwcslen(PACKAGE_UNICODE_NAME) + 1; /* strlen(" Garuda") */
+
+	    if (bUseProtocolR2) {
+		protocolRevision = PACKAGE_UNICODE_PROTOCOL_V1R2;
+	    } else if (bLegacyProtocol) {
+		protocolRevision = PACKAGE_UNICODE_PROTOCOL_V1R0;
+	    } else {
+		protocolRevision = PACKAGE_UNICODE_PROTOCOL_V1R1;
+	    }
+
+	    length += gwcslen(protocolRevision); /* "vX.0_rY.0", etc */
+	    length += 2; /* space before and after protocol revision */
+	    length += (sizeof(HANDLE) * 2) + 3; /* "0x" + handleAsStr + " " */
+	    length += (sizeof(LPVOID) * 2) + 3; /* "0x" + hexPtrAsStr + " " */
+	    length += 2; /* strlen("1 "), "safe", note trailing space */
+	}
+
+	/*
+	 * NOTE: Do we need to prepend additional information required by our
+	 *       native-to-managed code protocol (R2)?
+	 */
+
+	if (bUseProtocolR2) {
+	    /*
+	     * HACK: Include a pointer to the structure containing the Tcl C
+	     *       API function pointers.
+	     */
+
+	    length += (sizeof(LPVOID) * 2) + 3; /* "0x" + hexPtrAsStr + " " */
+	    length += 2; /* strlen("1 "), "isolation", note trailing space */
+	}
+
+	length++; /* NUL terminator character. */
+	newArgument = (LPWSTR) attemptckalloc(length * sizeof(WCHAR));
+
+	if (newArgument == NULL) {
+	    if (interp != NULL) {
+		Tcl_AppendResult(interp, "out of memory: newArgument\n", NULL);
+	    }
+
+	    code = TCL_ERROR;
+	    goto done;
+	}
+
+	memset(newArgument, 0, length * sizeof(WCHAR));
+
+	if (bUseProtocolR1) {
+	    if (bUseProtocolR2) {
+		gwprintf(newArgument, length - GWPRINTF_LENGTH_HAS_NUL,
+		    L"%s_%s " PACKAGE_UNICODE_PTR_FMT L" "
+		    PACKAGE_UNICODE_PTR_FMT L" " PACKAGE_UNICODE_PTR_FMT
+		    L" %s %s %s %s\0", PACKAGE_UNICODE_NAME,
+		    protocolRevision, hModule, pTclStubs, interp,
+		    bUseIsolation ? L"1 " : L"0 ",
+		    bUseSafeInterp ? L"1 " : L"0 ",
+		    (pMethodInfo->argument != NULL) ? pMethodInfo->argument :
+		    L"", (argument != NULL) ? argument : L"");
+	    } else {
+		gwprintf(newArgument, length - GWPRINTF_LENGTH_HAS_NUL,
+		    L"%s_%s " PACKAGE_UNICODE_PTR_FMT L" "
+		    PACKAGE_UNICODE_PTR_FMT L" %s %s %s\0",
+		    PACKAGE_UNICODE_NAME, protocolRevision, hModule, interp,
+		    bUseSafeInterp ? L"1 " : L"0 ",
+		    (pMethodInfo->argument != NULL) ? pMethodInfo->argument :
+		    L"", (argument != NULL) ? argument : L"");
+	    }
+	} else {
+	    gwprintf(newArgument, length - GWPRINTF_LENGTH_HAS_NUL, L"%s %s\0",
+		(pMethodInfo->argument != NULL) ? pMethodInfo->argument : L"",
+		(argument != NULL) ? argument : L"");
+	}
+    } else {
+	newArgument = (LPWSTR) pMethodInfo->argument;
+    }
+
+    bLogExecute = (methodFlags & METHOD_LOG_EXECUTE);
+
+    if (bLogExecute && PACKAGE_CAN_LOG(interp, logCommand)) {
+	/*
+	 * NOTE: Verbose mode is enabled; show all the information about the
+	 *       CLR method we are about to execute.
+	 */
+
+	TclLog(interp, logCommand, L"BEFORE ", CLR_EXECUTE_PROC_NAME,
+	    L"(assemblyPath = {", pMethodInfo->assemblyPath,
+	    L"}, typeName = {", pMethodInfo->typeName, L"}, methodName = {",
+	    pMethodInfo->methodName, L"}, argument = {",
+	    newArgument, L"})", NULL);
+    }
+
+#if defined(USE_CLR_CORE)
+    if (SUCCEEDED(hResult))
+	returnValue = (DWORD) pMethod(newArgument);
+#else
+    hResult = ICLRRuntimeHost_ExecuteInDefaultAppDomain(pRuntimeHost,
+	pMethodInfo->assemblyPath, pMethodInfo->typeName,
+	pMethodInfo->methodName, newArgument, &returnValue);
+#endif
+
+    /*
+     * NOTE: If the CLR method returned a result string via the protocol data
+     *       structure, add it to the interpreter result.
+     */
+
+    if (protocolData.result != NULL) {
+	if ((interp != NULL) && (protocolData.resultLength > 0)) {
+	    Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
+		protocolData.result, protocolData.resultLength);
+	}
+
+	FreeClrProtocolResult(&protocolData);
+    }
+
+    if (bLogExecute && PACKAGE_CAN_LOG(interp, logCommand)) {
+	WCHAR buffer[PACKAGE_RESULT_SIZE + 1] = {0};
+
+	gwprintf(buffer, PACKAGE_RESULT_SIZE, L"AFTER " CLR_EXECUTE_PROC_NAME
+	    L"(hResult = {0x%lX}, returnValue = {%d})", hResult, returnValue);
+
+	TclLog(interp, logCommand, buffer, NULL);
+    }
+
+    if (SUCCEEDED(hResult)) {
+	if (pReturnValue != NULL)
+	    *pReturnValue = returnValue;
+    } else {
+	if (interp != NULL) {
+	    Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
+		GetClrErrorMessage(CLR_EXECUTE_PROC_NAME, hResult), -1);
+	}
+
+	code = TCL_ERROR;
+	goto done;
+    }
+
+done:
+    if ((newArgument != NULL) && (newArgument != pMethodInfo->argument)) {
+	ckfree((LPVOID) newArgument);
+	newArgument = NULL;
+    }
+
+    if (protocolData.argv != &argument) {
+	if (protocolData.argl != NULL) {
+	    ckfree((LPVOID) protocolData.argl);
+	    protocolData.argl = NULL;
+	}
+
+	if (protocolData.argv != NULL) {
+	    ckfree((LPVOID) protocolData.argv);
+	    protocolData.argv = NULL;
+	}
+    }
+
+    if (listPtr != NULL) {
+	Tcl_DecrRefCount(listPtr);
+	listPtr = NULL;
+    }
+
+#if !defined(USE_CLR_CORE)
+    if (pRuntimeHost != NULL) {
+	ICLRRuntimeHost_Release(pRuntimeHost);
+	pRuntimeHost = NULL;
+    }
+#endif
+
+    return code;
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * MaybeCombineMethodFlags --
+ *
+ *	This function combines the specified method flags with those
+ *	from the configuration information for this package.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	None.
+ *
+ *----------------------------------------------------------------------
+ */
+static void MaybeCombineMethodFlags(
+    ClrConfigInfo *pConfigInfo, /* The configuration information. */
+    MethodFlags *pMethodFlags)	/* Type [and flags] of the CLR method to
+				 * execute. */
+{
+    MethodFlags methodFlags;
+
+    /*
+     * NOTE: This function does nothing if either of the required parameters
+     *       is invalid.
+     */
+
+    if ((pConfigInfo == NULL) || (pMethodFlags == NULL))
+	return;
+
+    /*
+     * NOTE: Start out with the method flags specified by the immediate chain
+     *       of callers.
+     */
+
+    methodFlags = *pMethodFlags;
+
+    /*
+     * NOTE: Add the configured method flags to the ones passed to us by the
+     *       caller.
+     */
+
+    methodFlags |= pConfigInfo->methodFlags;
+
+    /*
+     * NOTE: Add the method flags associated with the "use isolation" and the
+     *       "use safe interp" configuration settings, if necessary.
+     */
+
+    if (pConfigInfo->bUseIsolation)
+	methodFlags |= METHOD_USE_ISOLATION;
+
+    if (pConfigInfo->bUseSafeInterp)
+	methodFlags |= METHOD_USE_SAFE_INTERP;
+
+    /*
+     * NOTE: Update the original method flags specified by the caller to the
+     *       newly combined value.
+     */
+
+    *pMethodFlags = methodFlags;
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * GetAndExecuteClrMethod --
+ *
+ *	This function queries the CLR method information from the Tcl
+ *	interpreter and executes the CLR method responsible for setting
+ *	up, controlling, detaching from, or shutting down the bridge
+ *	between Eagle and Tcl.
+ *
+ * Results:
+ *	A standard Tcl result.
+ *
+ * Side effects:
+ *	Since third-party code is executed during this function, there
+ *	may be arbitrary side-effects.
+ *
+ *----------------------------------------------------------------------
+ */
+
+static int GetAndExecuteClrMethod(
+    HANDLE hModule,		/* Tcl library module handle. */
+    ClrTclStubs *pTclStubs,	/* Tcl C API stub function pointer table. */
+    ClrConfigInfo *pConfigInfo, /* The configuration information. */
+    Tcl_Interp *interp,		/* Current Tcl interpreter. */
+    LPCWSTR argument,		/* Extra argument to the method, if any. */
+    int objc,			/* Number of extra argument objects, if any. */
+    Tcl_Obj *CONST objv[],	/* Extra argument objects for the method, if
+				 * any.  These are used instead of the extra
+				 * argument string, if any. */
+    MethodFlags methodFlags)	/* Type [and flags] of the CLR method to
+				 * execute. */
+{
+    int code = TCL_OK;
+    ClrMethodInfo *pMethodInfo = NULL;
+    DWORD returnValue = TCL_OK;
+
+    /*
+     * NOTE: Check the Tcl interpreter for the configuration settings.  The Tcl
+     *       variables being queried should have been set by code in our custom
+     *       "helper.tcl" file.  If not, this function call should fail.
+     */
+
+    if (pConfigInfo == NULL) {
+	Tcl_AppendResult(interp, "invalid argument: pConfigInfo\n", NULL);
+	code = TCL_ERROR;
+	goto done;
+    }
+
+    MaybeCombineMethodFlags(pConfigInfo, &methodFlags);
+
+    /*
+     * NOTE: If the CLR is either not loaded -OR- not started, then we cannot
+     *	     use it to execute any code.
+     */
+
+    if (!CanExecuteClrCode(interp)) {
+	if (methodFlags & METHOD_STRICT_CLR)
+	    code = TCL_ERROR;
+
+	goto done;
+    }
+
+    /*
+     * NOTE: Query the Tcl interpreter for the information required to execute
+     *       the CLR method responsible for starting up, controlling, detaching
+     *       from, or shutting down the bridge.  The Tcl variables being
+     *       queried should have been set by code in our custom "helper.tcl"
+     *       file.  If not, this function call should fail.
+     */
+
+    code = GetClrMethodInfo(interp, methodFlags, &pMethodInfo);
+
+    if (code != TCL_OK)
+	goto done;
+
+    /*
+     * NOTE: Attempt to execute the CLR method.
+     */
+
+    code = ExecuteClrMethod(hModule, pTclStubs, interp,
+	pConfigInfo->logCommand, pMethodInfo, argument, objc, objv,
+	methodFlags, &returnValue);
+
+    if (code != TCL_OK)
+	goto done;
+
+    /*
+     * NOTE: By "convention", the pre-defined CLR methods used by this package
+     *       must return the value TCL_OK upon success; therefore, check the
+     *       return value against that and fail if this is not the case;
+     *       however, we allow this handling to be bypassed by the caller if
+     *       necessary.
+     */
+
+    if ((methodFlags & METHOD_STRICT_RETURN) && (returnValue != TCL_OK)) {
+	if (interp != NULL) {
+	    LPCWSTR methodTypeName; /* NOTE: For display only. */
+	    WCHAR buffer[PACKAGE_RESULT_SIZE + 1] = {0};
+
+	    switch (methodFlags & METHOD_TYPE_MASK) {
+		case METHOD_TYPE_DEMAND: {
+		    methodTypeName = L"demand";
+		    break;
+		}
+		case METHOD_TYPE_STARTUP: {
+		    methodTypeName = L"startup";
+		    break;
+		}
+		case METHOD_TYPE_CONTROL: {
+		    methodTypeName = L"control";
+		    break;
+		}
+		case METHOD_TYPE_DETACH: {
+		    methodTypeName = L"detach";
+		    break;
+		}
+		case METHOD_TYPE_SHUTDOWN: {
+		    methodTypeName = L"shutdown";
+		    break;
+		}
+		default: {
+		    methodTypeName = L"unknown";
+		    break;
+		}
+	    }
+
+	    /*
+	     * NOTE: Build an informative error message about this specific
+	     *       CLR method execution failure.
+	     */
 
-		code = TCL_ERROR;
-		goto done;
-	    }
-	} else if (bStrict) {
-	    if (interp != NULL) {
-		Tcl_AppendResult(interp, "CLR already started\n", NULL);
-	    }
+	    gwprintf(buffer, PACKAGE_RESULT_SIZE,
+		L"%s return value not TCL_OK, method: \"%s.%s\", assembly: "
+		L"\"%s\"\0", methodTypeName, pMethodInfo->typeName,
+		pMethodInfo->methodName, pMethodInfo->assemblyPath);
 
-	    code = TCL_ERROR;
-	    goto done;
+	    Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
+		GetTclErrorMessage(buffer, returnValue), -1);
 	}
+
+	code = TCL_ERROR;
+	goto done;
     }
 
 done:
-    Tcl_MutexUnlock(&packageMutex);
+    FreeClrMethodInfo(&pMethodInfo);
+
     return code;
 }
 
 /*
  *----------------------------------------------------------------------
  *
- * StopAndReleaseTheClr --
+ * DemandExecuteClrMethod --
  *
- *	This function stops and releases the CLR.
+ *	This function executes the specified CLR method using the
+ *	specified assembly, type, and method information.
  *
  * Results:
  *	A standard Tcl result.
  *
  * Side effects:
- *	Since the CLR may execute cleanup code, this function may have
- *	arbitrary side-effects.
+ *	Since third-party code is executed during this function, there
+ *	may be arbitrary side-effects.
  *
  *----------------------------------------------------------------------
  */
 
-static int StopAndReleaseTheClr(
-    Tcl_Interp *interp,	    /* Current Tcl interpreter. */
-    LPCWSTR logCommand,	    /* The Tcl command used to log the CLR method
-			     * execution, if any. */
-    BOOL bRelease,	    /* Release the CLR after stopping it? */
-    BOOL bStrict)	    /* Fail if already stopped and/or released? */
+static int DemandExecuteClrMethod(
+    HANDLE hModule,		/* Tcl library module handle. */
+    ClrTclStubs *pTclStubs,	/* Tcl C API stub function pointer table. */
+    ClrConfigInfo *pConfigInfo, /* The configuration information. */
+    Tcl_Interp *interp,		/* Current Tcl interpreter. */
+    Tcl_Obj *assemblyPathPtr,	/* The path of the assembly containing the
+				 * method. */
+    Tcl_Obj *typeNamePtr,	/* The managed type containing the method. */
+    Tcl_Obj *methodNamePtr,	/* The name of the method. */
+    Tcl_Obj *argumentPtr,	/* The argument string for the method. */
+    MethodFlags methodFlags,	/* Flags that control logging, arguments, etc.
+				 * See the MethodFlags enum for details. */
+    LPDWORD pReturnValue)	/* Location where the return value should be
+				 * stored or NULL if the return value is not
+				 * required. */
 {
     int code = TCL_OK;
-    WCHAR buffer[PACKAGE_RESULT_SIZE + 1] = {0};
-
-    Tcl_MutexLock(&packageMutex);
-
-    if (pClrRuntimeHost != NULL) {
-	/*
-	 * NOTE: If we were previously able to start the CLR, stop it now.
-	 */
-
-	if (bClrStarted) {
-	    HRESULT hResult = S_OK;
-
-	    /* NON-PORTABLE */
-	    SetEnvironmentVariableW(CLR_STOPPING_ENVVAR_NAME, L"1");
+    ClrMethodInfo *pMethodInfo = NULL;
 
-	    hResult = ICLRRuntimeHost_Stop(pClrRuntimeHost);
+    /*
+     * NOTE: Check the Tcl interpreter for the configuration settings.  The Tcl
+     *       variables being queried should have been set by code in our custom
+     *       "helper.tcl" file.  If not, this function call should fail.
+     */
 
-	    /* NON-PORTABLE */
-	    SetEnvironmentVariableW(CLR_STOPPING_ENVVAR_NAME, NULL);
+    if (pConfigInfo == NULL) {
+	Tcl_AppendResult(interp, "invalid argument: pConfigInfo\n", NULL);
+	code = TCL_ERROR;
+	goto done;
+    }
 
-	    if (PACKAGE_CAN_LOG(interp, logCommand)) {
-		gwprintf(buffer, PACKAGE_RESULT_SIZE,
-		    L"ICLRRuntimeHost_Stop(hResult = {0x%lX})", hResult);
+    MaybeCombineMethodFlags(pConfigInfo, &methodFlags);
 
-		TclLog(interp, logCommand, buffer, NULL);
-	    }
+    /*
+     * NOTE: Copy the information required to execute the CLR method.
+     */
 
-	    if (SUCCEEDED(hResult)) {
-		bClrStarted = FALSE;
-	    } else {
-		if (interp != NULL) {
-		    Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
-			GetClrErrorMessage(L"ICLRRuntimeHost_Stop", hResult),
-			    -1);
-		}
+    code = CreateClrMethodInfo(interp, assemblyPathPtr, typeNamePtr,
+	methodNamePtr, argumentPtr, &pMethodInfo);
 
-		code = TCL_ERROR;
-		goto done;
-	    }
-	} else if (bStrict) {
-	    if (interp != NULL) {
-		Tcl_AppendResult(interp, "CLR not started\n", NULL);
-	    }
+    if (code != TCL_OK)
+	goto done;
 
-	    code = TCL_ERROR;
-	    goto done;
-	}
+    /*
+     * NOTE: Attempt to execute the CLR method.
+     */
 
-	/*
-	 * NOTE: Should we also release the COM reference to the CLR runtime
-	 *       host?
-	 */
+    code = ExecuteClrMethod(hModule, pTclStubs, interp,
+	pConfigInfo->logCommand, pMethodInfo, NULL, 0, NULL, methodFlags,
+	pReturnValue);
 
-	if (bRelease) {
-	    ULONG result = ICLRRuntimeHost_Release(pClrRuntimeHost);
+    if (code != TCL_OK)
+	goto done;
 
-	    pClrRuntimeHost = NULL;
+done:
+    FreeClrMethodInfo(&pMethodInfo);
 
-	    if (PACKAGE_CAN_LOG(interp, logCommand)) {
-		gwprintf(buffer, PACKAGE_RESULT_SIZE,
-		    L"ICLRRuntimeHost_Release(result = {%lu})", result);
+    return code;
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * FreeClrAsyncData --
+ *
+ *	This function frees all the resources associated with the
+ *	asynchronous execution of a CLR method.  Unless the Tcl
+ *	interpreter and callback script have already been released,
+ *	it must be called by the thread that owns the Tcl interpreter.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	The Tcl interpreter may be deleted if it was only being kept
+ *	alive for the asynchronous execution of a CLR method.
+ *
+ *----------------------------------------------------------------------
+ */
 
-		TclLog(interp, logCommand, buffer, NULL);
-	    }
-	}
-    } else if (bStrict) {
-	if (interp != NULL) {
-	    Tcl_AppendResult(interp, "CLR not loaded\n", NULL);
-	}
+static void FreeClrAsyncData(
+    ClrAsyncData **ppAsyncData)	/* Pointer to structure to free. */
+{
+    if ((ppAsyncData == NULL) || (*ppAsyncData == NULL))
+	return;
 
-	code = TCL_ERROR;
-	goto done;
+    if ((*ppAsyncData)->errorMessage != NULL) {
+	ckfree((LPVOID) (*ppAsyncData)->errorMessage);
+	(*ppAsyncData)->errorMessage = NULL;
     }
 
-#if defined(USE_CLR_40)
-    /*
-     * BUGFIX: Only release these interface pointers if we released the CLR
-     *         runtime host (above).
-     */
-
-    if (bRelease) {
-	if (pClrRuntimeInfo != NULL) {
-	    ICLRRuntimeInfo_Release(pClrRuntimeInfo);
-	    pClrRuntimeInfo = NULL;
-	}
+    FreeClrMethodInfo(&(*ppAsyncData)->pMethodInfo);
 
-	if (pClrMetaHost != NULL) {
-	    ICLRMetaHost_Release(pClrMetaHost);
-	    pClrMetaHost = NULL;
-	}
+    if ((*ppAsyncData)->callbackPtr != NULL) {
+	Tcl_DecrRefCount((*ppAsyncData)->callbackPtr);
+	(*ppAsyncData)->callbackPtr = NULL;
     }
-#endif
-
-done:
-
-    /*
-     * BUGFIX: If the CLR has been stopped, then the bridge cannot be
-     *         running either.
-     */
 
-    if ((code == TCL_OK) && bBridgeStarted) {
-	bBridgeStarted = FALSE;
-
-	if (PACKAGE_CAN_LOG(interp, logCommand)) {
-	    TclLog(interp, logCommand,
-		L"WARNING: CLR was stopped with bridge running.", NULL);
-	}
+    if ((*ppAsyncData)->interp != NULL) {
+	Tcl_Release((ClientData) (*ppAsyncData)->interp);
+	(*ppAsyncData)->interp = NULL;
     }
 
-    Tcl_MutexUnlock(&packageMutex);
-    return code;
+    ckfree((LPVOID) *ppAsyncData);
+    *ppAsyncData = NULL;
 }
-
+
 /*
  *----------------------------------------------------------------------
  *
- * CanExecuteClrCode --
+ * AddClrAsyncData --
  *
- *	This function checks if CLR code can safely be executed by this
- *	package.
+ *	This function adds the asynchronous execution of a CLR method
+ *	to the list of those pending for the current thread, which must
+ *	be the thread that owns the Tcl interpreter.
  *
  * Results:
- *	Non-zero if CLR code can be safely executed by this package,
- *	zero otherwise.
+ *	None.
  *
  * Side effects:
- *	None.
+ *	When the list was empty, a thread exit handler is created, so
+ *	that the pending CLR methods can be canceled if this thread
+ *	exits before their results are delivered.
  *
  *----------------------------------------------------------------------
  */
 
-static BOOL CanExecuteClrCode(
-    Tcl_Interp *interp)			/* Current Tcl interpreter. */
+static void AddClrAsyncData(
+    ClrAsyncData *pAsyncData)	/* The asynchronous execution data. */
 {
-    BOOL bResult = FALSE;
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)
+	Tcl_GetThreadData(&dataKey, sizeof(ThreadSpecificData));
 
-    Tcl_MutexLock(&packageMutex);
+    if (tsdPtr->pAsyncList == NULL)
+	Tcl_CreateThreadExitHandler(ClrAsyncThreadExitProc, NULL);
 
-    if (pClrRuntimeHost == NULL) {
-	if (interp != NULL) {
-	    Tcl_AppendResult(interp, "CLR not loaded\n", NULL);
-	}
+    pAsyncData->nextPtr = tsdPtr->pAsyncList;
+    tsdPtr->pAsyncList = pAsyncData;
+}
 
-	goto done;
-    }
+/*
+ *----------------------------------------------------------------------
+ *
+ * RemoveClrAsyncData --
+ *
+ *	This function removes the asynchronous execution of a CLR method
+ *	from the list of those pending for the current thread, which
+ *	must be the thread that owns the Tcl interpreter.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	When the list becomes empty, the thread exit handler is deleted.
+ *	This is necessary because the package cannot be unloaded while
+ *	any thread still refers to it.
+ *
+ *----------------------------------------------------------------------
+ */
 
-    if (!bClrStarted) {
-	if (interp != NULL) {
-	    Tcl_AppendResult(interp, "CLR not started\n", NULL);
+static void RemoveClrAsyncData(
+    ClrAsyncData *pAsyncData)	/* The asynchronous execution data. */
+{
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)
+	Tcl_GetThreadData(&dataKey, sizeof(ThreadSpecificData));
+    ClrAsyncData **ppAsyncData = &tsdPtr->pAsyncList;
+
+    while (*ppAsyncData != NULL) {
+	if (*ppAsyncData == pAsyncData) {
+	    *ppAsyncData = pAsyncData->nextPtr;
+	    pAsyncData->nextPtr = NULL;
+	    break;
 	}
 
-	goto done;
+	ppAsyncData = &(*ppAsyncData)->nextPtr;
     }
-
-    bResult = TRUE;
-
-done:
-    Tcl_MutexUnlock(&packageMutex);
-    return bResult;
+
+    if (tsdPtr->pAsyncList == NULL)
+	Tcl_DeleteThreadExitHandler(ClrAsyncThreadExitProc, NULL);
 }
-
+
 /*
  *----------------------------------------------------------------------
  *
- * ExecuteClrMethod --
+ * ClrAsyncThreadProc --
  *
- *	This function executes the specified CLR method.
+ *	This function is the entry point for the threads used to execute
+ *	CLR methods asynchronously.  It executes the CLR method and then
+ *	queues a Tcl event to deliver the results to the thread that
+ *	owns the Tcl interpreter.
  *
  * Results:
- *	A standard Tcl result.
+ *	None.
  *
  * Side effects:
  *	Since third-party code is executed during this function, there
@@ -1994,470 +3860,310 @@ done:
  *----------------------------------------------------------------------
  */
 
-static int ExecuteClrMethod(
-    HANDLE hModule,		/* Tcl library module handle. */
-    ClrTclStubs *pTclStubs,	/* Tcl C API stub function pointer table. */
-    Tcl_Interp *interp,		/* Current Tcl interpreter. */
-    LPCWSTR logCommand,		/* The Tcl command used to log the CLR method
-				 * execution, if any. */
-    ClrMethodInfo *pMethodInfo, /* Contains the information necessary for this
-				 * function to execute the CLR method. */
-    LPCWSTR argument,		/* Extra argument to the method, if any. */
-    MethodFlags methodFlags,	/* Flags that control logging, arguments, etc.
-				 * See the MethodFlags enum for details. */
-    LPDWORD pReturnValue)	/* Location where the return value should be
-				 * stored or NULL if the return value is not
-				 * required. */
+static Tcl_ThreadCreateType ClrAsyncThreadProc(
+    ClientData clientData)	/* The asynchronous execution data. */
 {
-    int code = TCL_OK;
-    BOOL bUseProtocolR1;
-    BOOL bUseProtocolR2;
-    BOOL bLegacyProtocol;
-    BOOL bUseIsolation;
-    BOOL bUseSafeInterp;
-    BOOL bLogExecute;
-    LPWSTR protocolRevision = NULL;
-    LPWSTR newArgument = NULL;
-    HRESULT hResult;
-    DWORD returnValue = TCL_OK;
-
-    if (pMethodInfo == NULL) {
-	if (interp != NULL) {
-	    Tcl_AppendResult(interp, "invalid method information\n", NULL);
-	}
-
-	return TCL_ERROR;
-    }
-
-    Tcl_MutexLock(&packageMutex);
+    ClrAsyncData *pAsyncData = (ClrAsyncData *) clientData;
+    ClrAsyncEvent *pAsyncEvent;
+    Tcl_Interp *interp;
 
     /*
-     * NOTE: If the CLR is either not loaded -OR- not started, then we cannot
-     *	     use it to execute any code.
+     * NOTE: The Tcl interpreter belonging to the caller cannot be used by this
+     *       thread; therefore, a temporary one is used to collect the error
+     *       message, if any, from the ExecuteClrMethod function.
      */
 
-    if (!CanExecuteClrCode(interp)) {
-	code = TCL_ERROR;
-	goto done;
-    }
-
-    bUseProtocolR1 = (methodFlags & METHOD_PROTOCOL_V1R1);
-    bUseProtocolR2 = (methodFlags & METHOD_PROTOCOL_V1R2);
-    bLegacyProtocol = (methodFlags & METHOD_PROTOCOL_LEGACY);
-    bUseIsolation = (methodFlags & METHOD_USE_ISOLATION);
-    bUseSafeInterp = (methodFlags & METHOD_USE_SAFE_INTERP);
-
-    if ((argument != NULL) || bUseProtocolR1) {
-	size_t length = 0;
-
-	/*
-	 * NOTE: If an argument is present in the method information (i.e. this
-	 *       method has been configured by the package to use it), add the
-	 *       entire length of the argument plus one space to separate it
-	 *       from the rest of the final argument string.
-	 */
-
-	if (pMethodInfo->argument != NULL)
-	    length += wcslen(pMethodInfo->argument) + 1; /* argument + space. */
-
-	/*
-	 * NOTE: If an extra argument was supplied by the caller, add the
-	 *       entire length of the argument plus one space to separate it
-	 *       from the rest of the final argument string.
-	 */
+    interp = Tcl_CreateInterp();
 
-	if (argument != NULL)
-	    length += wcslen(argument) + 1; /* argument + space. */
+    if (interp != NULL) {
+	pAsyncData->code = ExecuteClrMethod(hTclModule, &uTclStubs, interp,
+	    NULL, pAsyncData->pMethodInfo, NULL, 0, NULL,
+	    pAsyncData->methodFlags, &pAsyncData->returnValue);
 
-	/*
-	 * NOTE: Do we need to prepend additional information required by our
-	 *       native-to-managed code protocol (V1)?  The reason a "protocol"
-	 *       is required at all is because the native CLR API only allows
-	 *       us to pass one string argument to the target CLR method;
-	 *       therefore, we have to make the most of it.
-	 */
+	if (pAsyncData->code != TCL_OK) {
+	    int length = 0;
+	    LPCWSTR message = (LPCWSTR) Tcl_GetUnicodeFromObj(
+		Tcl_GetObjResult(interp), &length);
 
-	if (bUseProtocolR1) {
-	    /*
-	     * HACK: Build the final argument string to pass to CLR method.  We
-	     *       need to include the Tcl library module handle and a pointer
-	     *       to the Tcl interpreter here in order for Eagle to build a
-	     *       bridge back to us.  Since the type signature of the method
-	     *       only allows us to pass a single string argument, we must
-	     *       convert the Tcl library module handle and the Tcl
-	     *       interpreter pointer to strings and then add any arguments
-	     *       supplied by the configuration or our immediate caller
-	     *       after that.  The final argument string MUST parse as a
-	     *       valid list; otherwise, the CLR method MAY simply refuse to
-	     *       process it.  We also include a prefix indicating the
-	     *       version of the "protocol" that is in use (currently
-	     *       "Garuda_v1.0" or "Garuda_v1.0_r2.0") and a Tcl interpreter
-	     *       "safety indicator" (i.e. logical boolean) after the Tcl
-	     *       interpreter pointer.
-	     */
+	    pAsyncData->errorMessage = (LPWSTR) attemptckalloc(
+		(length + 1) * sizeof(WCHAR));
 
-	    length += wcslen(PACKAGE_UNICODE_NAME) + 1; /* strlen(" Garuda") */
+	    if (pAsyncData->errorMessage != NULL) {
+		memcpy(pAsyncData->errorMessage, message,
+		    length * sizeof(WCHAR));
 
-	    if (bUseProtocolR2) {
-		protocolRevision = PACKAGE_UNICODE_PROTOCOL_V1R2;
-	    } else if (bLegacyProtocol) {
-		protocolRevision = PACKAGE_UNICODE_PROTOCOL_V1R0;
-	    } else {
-		protocolRevision = PACKAGE_UNICODE_PROTOCOL_V1R1;
+		pAsyncData->errorMessage[length] = 0;
+		pAsyncData->errorLength = length;
 	    }
-
-	    length += wcslen(protocolRevision); /* "vX.0_rY.0", etc */
-	    length += 2; /* space before and after protocol revision */
-	    length += (sizeof(HANDLE) * 2) + 3; /* "0x" + handleAsStr + " " */
-	    length += (sizeof(LPVOID) * 2) + 3; /* "0x" + hexPtrAsStr + " " */
-	    length += 2; /* strlen("1 "), "safe", note trailing space */
-	}
-
-	/*
-	 * NOTE: Do we need to prepend additional information required by our
-	 *       native-to-managed code protocol (R2)?
-	 */
-
-	if (bUseProtocolR2) {
-	    /*
-	     * HACK: Include a pointer to the structure containing the Tcl C
-	     *       API function pointers.
-	     */
-
-	    length += (sizeof(LPVOID) * 2) + 3; /* "0x" + hexPtrAsStr + " " */
-	    length += 2; /* strlen("1 "), "isolation", note trailing space */
 	}
 
-	length++; /* NUL terminator character. */
-	newArgument = (LPWSTR) attemptckalloc(length * sizeof(WCHAR));
+	Tcl_DeleteInterp(interp);
+    } else {
+	pAsyncData->code = TCL_ERROR;
+    }
 
-	if (newArgument == NULL) {
-	    if (interp != NULL) {
-		Tcl_AppendResult(interp, "out of memory: newArgument\n", NULL);
-	    }
+    /*
+     * NOTE: Queue the event to deliver the results and then wake up the thread
+     *       that owns the Tcl interpreter, in case it is waiting for events.
+     *       The storage for the event is freed by the Tcl notifier.  This is
+     *       done while holding the package mutex, so that it cannot race with
+     *       the ClrAsyncThreadExitProc function.  If that thread has already
+     *       exited, there is nobody to deliver the results to; therefore, just
+     *       free everything now.  The Tcl interpreter and callback script were
+     *       already released by that thread.
+     */
 
-	    code = TCL_ERROR;
-	    goto done;
-	}
+    LockPackage();
 
-	memset(newArgument, 0, length * sizeof(WCHAR));
+    if (pAsyncData->canceled) {
+	UnlockPackage();
 
-	if (bUseProtocolR1) {
-	    if (bUseProtocolR2) {
-		gwprintf(newArgument, length - GWPRINTF_LENGTH_HAS_NUL,
-		    L"%s_%s " PACKAGE_UNICODE_PTR_FMT L" "
-		    PACKAGE_UNICODE_PTR_FMT L" " PACKAGE_UNICODE_PTR_FMT
-		    L" %s %s %s %s\0", PACKAGE_UNICODE_NAME,
-		    protocolRevision, hModule, pTclStubs, interp,
-		    bUseIsolation ? L"1 " : L"0 ",
-		    bUseSafeInterp ? L"1 " : L"0 ",
-		    (pMethodInfo->argument != NULL) ? pMethodInfo->argument :
-		    L"", (argument != NULL) ? argument : L"");
-	    } else {
-		gwprintf(newArgument, length - GWPRINTF_LENGTH_HAS_NUL,
-		    L"%s_%s " PACKAGE_UNICODE_PTR_FMT L" "
-		    PACKAGE_UNICODE_PTR_FMT L" %s %s %s\0",
-		    PACKAGE_UNICODE_NAME, protocolRevision, hModule, interp,
-		    bUseSafeInterp ? L"1 " : L"0 ",
-		    (pMethodInfo->argument != NULL) ? pMethodInfo->argument :
-		    L"", (argument != NULL) ? argument : L"");
-	    }
-	} else {
-	    gwprintf(newArgument, length - GWPRINTF_LENGTH_HAS_NUL, L"%s %s\0",
-		(pMethodInfo->argument != NULL) ? pMethodInfo->argument : L"",
-		(argument != NULL) ? argument : L"");
-	}
+	FreeClrAsyncData(&pAsyncData);
+	InterlockedDecrement(&lAsyncCalls); /* NON-PORTABLE */
     } else {
-	newArgument = (LPWSTR) pMethodInfo->argument;
-    }
-
-    bLogExecute = (methodFlags & METHOD_LOG_EXECUTE);
-
-    if (bLogExecute && PACKAGE_CAN_LOG(interp, logCommand)) {
 	/*
-	 * NOTE: Verbose mode is enabled; show all the information about the
-	 *       CLR method we are about to execute.
+	 * NOTE: Once the event has been queued, the data may be freed at any
+	 *       time by the thread that owns the Tcl interpreter.
 	 */
 
-	TclLog(interp, logCommand, L"BEFORE ",
-	    L"ICLRRuntimeHost_ExecuteInDefaultAppDomain(assemblyPath = {",
-	    pMethodInfo->assemblyPath, L"}, typeName = {",
-	    pMethodInfo->typeName, L"}, methodName = {",
-	    pMethodInfo->methodName, L"}, argument = {",
-	    newArgument, L"})", NULL);
-    }
-
-    hResult = ICLRRuntimeHost_ExecuteInDefaultAppDomain(pClrRuntimeHost,
-	pMethodInfo->assemblyPath, pMethodInfo->typeName,
-	pMethodInfo->methodName, newArgument, &returnValue);
-
-    if (bLogExecute && PACKAGE_CAN_LOG(interp, logCommand)) {
-	WCHAR buffer[PACKAGE_RESULT_SIZE + 1] = {0};
-
-	gwprintf(buffer, PACKAGE_RESULT_SIZE, L"AFTER "
-	    L"ICLRRuntimeHost_ExecuteInDefaultAppDomain(hResult = {0x%lX}, "
-	    L"returnValue = {%d})", hResult, returnValue);
+	Tcl_ThreadId threadId = pAsyncData->threadId;
 
-	TclLog(interp, logCommand, buffer, NULL);
-    }
+	pAsyncEvent = (ClrAsyncEvent *) ckalloc(sizeof(ClrAsyncEvent));
+	pAsyncEvent->header.proc = ClrAsyncEventProc;
+	pAsyncEvent->pAsyncData = pAsyncData;
 
-    if (SUCCEEDED(hResult)) {
-	if (pReturnValue != NULL)
-	    *pReturnValue = returnValue;
-    } else {
-	if (interp != NULL) {
-	    Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
-		GetClrErrorMessage(
-		    L"ICLRRuntimeHost_ExecuteInDefaultAppDomain",
-		    hResult), -1);
-	}
+	pAsyncData->queued = TRUE;
+	pAsyncData = NULL;
 
-	code = TCL_ERROR;
-	goto done;
-    }
+	Tcl_ThreadQueueEvent(threadId, (Tcl_Event *) pAsyncEvent,
+	    TCL_QUEUE_TAIL);
 
-done:
-    if ((newArgument != NULL) && (newArgument != pMethodInfo->argument)) {
-	ckfree((LPVOID) newArgument);
-	newArgument = NULL;
+	Tcl_ThreadAlert(threadId);
+	UnlockPackage();
     }
 
-    Tcl_MutexUnlock(&packageMutex);
-    return code;
+    Tcl_ExitThread(TCL_OK);
+    TCL_THREAD_CREATE_RETURN;
 }
-
+
 /*
  *----------------------------------------------------------------------
  *
- * MaybeCombineMethodFlags --
+ * ClrAsyncEventProc --
  *
- *	This function combines the specified method flags with those
- *	from the configuration information for this package.
+ *	This function handles the Tcl event used to deliver the results
+ *	of a CLR method executed asynchronously.  The return code and
+ *	the return value (or error message) are appended to the callback
+ *	script, which is then evaluated at the global level.
  *
  * Results:
- *	None.
+ *	Non-zero if the event was handled, zero otherwise.
  *
  * Side effects:
- *	None.
+ *	Since the callback script is evaluated, this function may have
+ *	arbitrary side-effects.
  *
  *----------------------------------------------------------------------
  */
-static void MaybeCombineMethodFlags(
-    ClrConfigInfo *pConfigInfo, /* The configuration information. */
-    MethodFlags *pMethodFlags)	/* Type [and flags] of the CLR method to
-				 * execute. */
+
+static int ClrAsyncEventProc(
+    Tcl_Event *evPtr,		/* The event to handle. */
+    int flags)			/* The event flags from the Tcl notifier. */
 {
-    MethodFlags methodFlags;
+    ClrAsyncData *pAsyncData = ((ClrAsyncEvent *) evPtr)->pAsyncData;
+    Tcl_Interp *interp = pAsyncData->interp;
 
     /*
-     * NOTE: This function does nothing if either of the required parameters
-     *       is invalid.
+     * NOTE: The results are delivered just like the file events; therefore,
+     *       wait until those are being handled.
      */
 
-    if ((pConfigInfo == NULL) || (pMethodFlags == NULL))
-	return;
+    if (!(flags & TCL_FILE_EVENTS))
+	return 0;
 
-    /*
-     * NOTE: Start out with the method flags specified by the immediate chain
-     *       of callers.
-     */
+    RemoveClrAsyncData(pAsyncData);
 
-    methodFlags = *pMethodFlags;
+    if (!Tcl_InterpDeleted(interp)) {
+	Tcl_Obj *objPtr = Tcl_DuplicateObj(pAsyncData->callbackPtr);
+	Tcl_Obj *codePtr = Tcl_NewIntObj(pAsyncData->code);
+	Tcl_Obj *resultPtr;
 
-    /*
-     * NOTE: Add the configured method flags to the ones passed to us by the
-     *       caller.
-     */
+	if (pAsyncData->code == TCL_OK) {
+	    resultPtr = Tcl_NewLongObj(pAsyncData->returnValue);
+	} else if (pAsyncData->errorMessage != NULL) {
+	    resultPtr = Tcl_NewUnicodeObj(pAsyncData->errorMessage,
+		pAsyncData->errorLength);
+	} else {
+	    resultPtr = Tcl_NewStringObj("out of memory: errorMessage\n", -1);
+	}
 
-    methodFlags |= pConfigInfo->methodFlags;
+	/*
+	 * NOTE: If appending to the callback script fails, the elements will
+	 *       not be owned by it; therefore, hold a reference to each one
+	 *       until they are no longer needed.
+	 */
 
-    /*
-     * NOTE: Add the method flags associated with the "use isolation" and the
-     *       "use safe interp" configuration settings, if necessary.
-     */
+	Tcl_IncrRefCount(objPtr);
+	Tcl_IncrRefCount(codePtr);
+	Tcl_IncrRefCount(resultPtr);
 
-    if (pConfigInfo->bUseIsolation)
-	methodFlags |= METHOD_USE_ISOLATION;
+	if ((Tcl_ListObjAppendElement(interp, objPtr, codePtr) != TCL_OK) ||
+		(Tcl_ListObjAppendElement(interp, objPtr,
+		resultPtr) != TCL_OK) ||
+		(Tcl_EvalObjEx(interp, objPtr, TCL_EVAL_GLOBAL) != TCL_OK)) {
+	    Tcl_AddErrorInfo(interp,
+		"\n    (\"garuda clrexecute\" callback script)");
 
-    if (pConfigInfo->bUseSafeInterp)
-	methodFlags |= METHOD_USE_SAFE_INTERP;
+	    Tcl_BackgroundError(interp);
+	}
 
-    /*
-     * NOTE: Update the original method flags specified by the caller to the
-     *       newly combined value.
-     */
+	Tcl_DecrRefCount(resultPtr);
+	Tcl_DecrRefCount(codePtr);
+	Tcl_DecrRefCount(objPtr);
+    }
+
+    FreeClrAsyncData(&pAsyncData);
+    InterlockedDecrement(&lAsyncCalls); /* NON-PORTABLE */
+
+    return 1;
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * ClrAsyncDeleteProc --
+ *
+ *	This function is used with Tcl_DeleteEvents to find the queued
+ *	Tcl events used to deliver the results of the CLR methods that
+ *	were executed asynchronously.
+ *
+ * Results:
+ *	Non-zero if the event should be deleted, zero otherwise.
+ *
+ * Side effects:
+ *	None.
+ *
+ *----------------------------------------------------------------------
+ */
 
-    *pMethodFlags = methodFlags;
+static int ClrAsyncDeleteProc(
+    Tcl_Event *evPtr,		/* The event to check. */
+    ClientData clientData)	/* Not used. */
+{
+    return (evPtr->proc == ClrAsyncEventProc);
 }
-
+
 /*
  *----------------------------------------------------------------------
  *
- * GetAndExecuteClrMethod --
+ * ClrAsyncThreadExitProc --
  *
- *	This function queries the CLR method information from the Tcl
- *	interpreter and executes the CLR method responsible for setting
- *	up, controlling, detaching from, or shutting down the bridge
- *	between Eagle and Tcl.
+ *	This function is called when a thread that has CLR methods being
+ *	executed asynchronously exits before all of their results have
+ *	been delivered.  Those CLR methods are canceled, i.e. their
+ *	results will never be delivered.
  *
  * Results:
- *	A standard Tcl result.
+ *	None.
  *
  * Side effects:
- *	Since third-party code is executed during this function, there
- *	may be arbitrary side-effects.
+ *	The Tcl interpreters and callback scripts are released.  Where
+ *	the CLR method has already returned, its queued event is deleted
+ *	and everything else is freed; otherwise, the thread executing it
+ *	frees everything else when the CLR method returns.
  *
  *----------------------------------------------------------------------
  */
 
-static int GetAndExecuteClrMethod(
-    HANDLE hModule,		/* Tcl library module handle. */
-    ClrTclStubs *pTclStubs,	/* Tcl C API stub function pointer table. */
-    ClrConfigInfo *pConfigInfo, /* The configuration information. */
-    Tcl_Interp *interp,		/* Current Tcl interpreter. */
-    LPCWSTR argument,		/* Extra argument to the method, if any. */
-    MethodFlags methodFlags)	/* Type [and flags] of the CLR method to
-				 * execute. */
+static void ClrAsyncThreadExitProc(
+    ClientData clientData)	/* Not used. */
 {
-    int code = TCL_OK;
-    ClrMethodInfo *pMethodInfo = NULL;
-    DWORD returnValue = TCL_OK;
-
-    /*
-     * NOTE: Check the Tcl interpreter for the configuration settings.  The Tcl
-     *       variables being queried should have been set by code in our custom
-     *       "helper.tcl" file.  If not, this function call should fail.
-     */
-
-    if (pConfigInfo == NULL) {
-	Tcl_AppendResult(interp, "invalid argument: pConfigInfo\n", NULL);
-	code = TCL_ERROR;
-	goto done;
-    }
-
-    MaybeCombineMethodFlags(pConfigInfo, &methodFlags);
+    ThreadSpecificData *tsdPtr = (ThreadSpecificData *)
+	Tcl_GetThreadData(&dataKey, sizeof(ThreadSpecificData));
+    ClrAsyncData *pAsyncData;
+    ClrAsyncData *pNextAsyncData;
+    ClrAsyncData *pQueuedList = NULL;
 
     /*
-     * NOTE: If the CLR is either not loaded -OR- not started, then we cannot
-     *	     use it to execute any code.
+     * NOTE: First, release the resources that can only be used by this thread.
+     *       The threads executing the CLR methods never use them.
      */
 
-    if (!CanExecuteClrCode(interp)) {
-	if (methodFlags & METHOD_STRICT_CLR)
-	    code = TCL_ERROR;
+    for (pAsyncData = tsdPtr->pAsyncList; pAsyncData != NULL;
+	    pAsyncData = pAsyncData->nextPtr) {
+	if (pAsyncData->callbackPtr != NULL) {
+	    Tcl_DecrRefCount(pAsyncData->callbackPtr);
+	    pAsyncData->callbackPtr = NULL;
+	}
 
-	goto done;
+	if (pAsyncData->interp != NULL) {
+	    Tcl_Release((ClientData) pAsyncData->interp);
+	    pAsyncData->interp = NULL;
+	}
     }
 
     /*
-     * NOTE: Query the Tcl interpreter for the information required to execute
-     *       the CLR method responsible for starting up, controlling, detaching
-     *       from, or shutting down the bridge.  The Tcl variables being
-     *       queried should have been set by code in our custom "helper.tcl"
-     *       file.  If not, this function call should fail.
+     * NOTE: Next, cancel the CLR methods that have not returned yet.  Once this
+     *       is done, the thread executing each of them owns its data and may
+     *       free it at any time; therefore, it cannot be used after this point.
      */
 
-    code = GetClrMethodInfo(interp, methodFlags, &pMethodInfo);
-
-    if (code != TCL_OK)
-	goto done;
+    LockPackage();
 
-    /*
-     * NOTE: Attempt to execute the CLR method.
-     */
+    for (pAsyncData = tsdPtr->pAsyncList; pAsyncData != NULL;
+	    pAsyncData = pNextAsyncData) {
+	pNextAsyncData = pAsyncData->nextPtr;
+	pAsyncData->nextPtr = NULL;
 
-    code = ExecuteClrMethod(hModule, pTclStubs, interp,
-	pConfigInfo->logCommand, pMethodInfo, argument, methodFlags,
-	&returnValue);
+	if (pAsyncData->queued) {
+	    pAsyncData->nextPtr = pQueuedList;
+	    pQueuedList = pAsyncData;
+	} else {
+	    pAsyncData->canceled = TRUE;
+	}
+    }
 
-    if (code != TCL_OK)
-	goto done;
+    tsdPtr->pAsyncList = NULL;
+    UnlockPackage();
 
     /*
-     * NOTE: By "convention", the pre-defined CLR methods used by this package
-     *       must return the value TCL_OK upon success; therefore, check the
-     *       return value against that and fail if this is not the case;
-     *       however, we allow this handling to be bypassed by the caller if
-     *       necessary.
+     * NOTE: Finally, delete the queued events for the CLR methods that have
+     *       already returned, which are never going to be handled, and free
+     *       their data.
      */
 
-    if ((methodFlags & METHOD_STRICT_RETURN) && (returnValue != TCL_OK)) {
-	if (interp != NULL) {
-	    LPCWSTR methodTypeName; /* NOTE: For display only. */
-	    WCHAR buffer[PACKAGE_RESULT_SIZE + 1] = {0};
-
-	    switch (methodFlags & METHOD_TYPE_MASK) {
-		case METHOD_TYPE_DEMAND: {
-		    methodTypeName = L"demand";
-		    break;
-		}
-		case METHOD_TYPE_STARTUP: {
-		    methodTypeName = L"startup";
-		    break;
-		}
-		case METHOD_TYPE_CONTROL: {
-		    methodTypeName = L"control";
-		    break;
-		}
-		case METHOD_TYPE_DETACH: {
-		    methodTypeName = L"detach";
-		    break;
-		}
-		case METHOD_TYPE_SHUTDOWN: {
-		    methodTypeName = L"shutdown";
-		    break;
-		}
-		default: {
-		    methodTypeName = L"unknown";
-		    break;
-		}
-	    }
-
-	    /*
-	     * NOTE: Build an informative error message about this specific
-	     *       CLR method execution failure.
-	     */
-
-	    gwprintf(buffer, PACKAGE_RESULT_SIZE,
-		L"%s return value not TCL_OK, method: \"%s.%s\", assembly: "
-		L"\"%s\"\0", methodTypeName, pMethodInfo->typeName,
-		pMethodInfo->methodName, pMethodInfo->assemblyPath);
+    Tcl_DeleteEvents(ClrAsyncDeleteProc, NULL);
 
-	    Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
-		GetTclErrorMessage(buffer, returnValue), -1);
-	}
+    for (pAsyncData = pQueuedList; pAsyncData != NULL;
+	    pAsyncData = pNextAsyncData) {
+	pNextAsyncData = pAsyncData->nextPtr;
 
-	code = TCL_ERROR;
-	goto done;
+	FreeClrAsyncData(&pAsyncData);
+	InterlockedDecrement(&lAsyncCalls); /* NON-PORTABLE */
     }
-
-done:
-    FreeClrMethodInfo(&pMethodInfo);
-
-    return code;
 }
-
+
 /*
  *----------------------------------------------------------------------
  *
- * DemandExecuteClrMethod --
+ * AsyncExecuteClrMethod --
  *
- *	This function executes the specified CLR method using the
- *	specified assembly, type, and method information.
+ *	This function executes the specified CLR method asynchronously,
+ *	using a new thread.  When the CLR method returns, the results
+ *	are delivered to the specified callback script via the event
+ *	loop of the current thread.
  *
  * Results:
  *	A standard Tcl result.
  *
  * Side effects:
- *	Since third-party code is executed during this function, there
- *	may be arbitrary side-effects.
+ *	A new thread is created.  Since third-party code is executed
+ *	by that thread, there may be arbitrary side-effects.
  *
  *----------------------------------------------------------------------
  */
 
-static int DemandExecuteClrMethod(
-    HANDLE hModule,		/* Tcl library module handle. */
-    ClrTclStubs *pTclStubs,	/* Tcl C API stub function pointer table. */
+static int AsyncExecuteClrMethod(
     ClrConfigInfo *pConfigInfo, /* The configuration information. */
     Tcl_Interp *interp,		/* Current Tcl interpreter. */
     Tcl_Obj *assemblyPathPtr,	/* The path of the assembly containing the
@@ -2465,20 +4171,13 @@ static int DemandExecuteClrMethod(
     Tcl_Obj *typeNamePtr,	/* The managed type containing the method. */
     Tcl_Obj *methodNamePtr,	/* The name of the method. */
     Tcl_Obj *argumentPtr,	/* The argument string for the method. */
-    MethodFlags methodFlags,	/* Flags that control logging, arguments, etc.
+    Tcl_Obj *callbackPtr,	/* The script used to deliver the results. */
+    MethodFlags methodFlags)	/* Flags that control logging, arguments, etc.
 				 * See the MethodFlags enum for details. */
-    LPDWORD pReturnValue)	/* Location where the return value should be
-				 * stored or NULL if the return value is not
-				 * required. */
 {
     int code = TCL_OK;
-    ClrMethodInfo *pMethodInfo = NULL;
-
-    /*
-     * NOTE: Check the Tcl interpreter for the configuration settings.  The Tcl
-     *       variables being queried should have been set by code in our custom
-     *       "helper.tcl" file.  If not, this function call should fail.
-     */
+    ClrAsyncData *pAsyncData = NULL;
+    Tcl_ThreadId threadId;
 
     if (pConfigInfo == NULL) {
 	Tcl_AppendResult(interp, "invalid argument: pConfigInfo\n", NULL);
@@ -2489,32 +4188,77 @@ static int DemandExecuteClrMethod(
     MaybeCombineMethodFlags(pConfigInfo, &methodFlags);
 
     /*
-     * NOTE: Copy the information required to execute the CLR method.
+     * NOTE: The CLR method cannot use the Tcl interpreter, because it will not
+     *       be executed by the thread that owns it; therefore, none of the
+     *       native-to-managed code protocols may be used.
+     */
+
+    methodFlags &= ~METHOD_PROTOCOL_MASK;
+
+    /*
+     * NOTE: If the CLR is either not loaded -OR- not started, then we cannot
+     *	     use it to execute any code.  Check now, so that the caller gets
+     *	     the error right away.
      */
 
+    if (!CanExecuteClrCode(interp)) {
+	code = TCL_ERROR;
+	goto done;
+    }
+
+    pAsyncData = (ClrAsyncData *) attemptckalloc(sizeof(ClrAsyncData));
+
+    if (pAsyncData == NULL) {
+	Tcl_AppendResult(interp, "out of memory: pAsyncData\n", NULL);
+	code = TCL_ERROR;
+	goto done;
+    }
+
+    memset(pAsyncData, 0, sizeof(ClrAsyncData));
+    pAsyncData->sizeOf = sizeof(ClrAsyncData);
+
     code = CreateClrMethodInfo(interp, assemblyPathPtr, typeNamePtr,
-	methodNamePtr, argumentPtr, &pMethodInfo);
+	methodNamePtr, argumentPtr, &pAsyncData->pMethodInfo);
 
     if (code != TCL_OK)
 	goto done;
 
-    /*
-     * NOTE: Attempt to execute the CLR method.
-     */
+    Tcl_Preserve((ClientData) interp);
+    Tcl_IncrRefCount(callbackPtr);
 
-    code = ExecuteClrMethod(hModule, pTclStubs, interp,
-	pConfigInfo->logCommand, pMethodInfo, NULL, methodFlags,
-	pReturnValue);
+    pAsyncData->threadId = Tcl_GetCurrentThread();
+    pAsyncData->interp = interp;
+    pAsyncData->callbackPtr = callbackPtr;
+    pAsyncData->methodFlags = methodFlags;
+    pAsyncData->code = TCL_OK;
 
-    if (code != TCL_OK)
+    InterlockedIncrement(&lAsyncCalls); /* NON-PORTABLE */
+    AddClrAsyncData(pAsyncData);
+
+    if (Tcl_CreateThread(&threadId, ClrAsyncThreadProc,
+	    (ClientData) pAsyncData, TCL_THREAD_STACK_DEFAULT,
+	    TCL_THREAD_NOFLAGS) != TCL_OK) {
+	RemoveClrAsyncData(pAsyncData);
+	InterlockedDecrement(&lAsyncCalls); /* NON-PORTABLE */
+
+	Tcl_AppendResult(interp, "could not create thread\n", NULL);
+	code = TCL_ERROR;
 	goto done;
+    }
+
+    /*
+     * NOTE: The new thread now owns the asynchronous execution data.  It will
+     *       be freed after the results have been delivered.
+     */
+
+    pAsyncData = NULL;
 
 done:
-    FreeClrMethodInfo(&pMethodInfo);
+    FreeClrAsyncData(&pAsyncData);
 
     return code;
 }
-
+
 /*
  *----------------------------------------------------------------------
  *
@@ -2569,7 +4313,7 @@ int Garuda_Init(
      */
 
     InterlockedIncrement(&lTclStubs);
-    Tcl_MutexLock(&packageMutex);
+    LockPackage();
 
     /*
      * NOTE: Query the package module file name, before proceeding further.
@@ -2639,8 +4383,23 @@ int Garuda_Init(
      */
 
     if (hTclModule == NULL) {
+#if defined(_WIN32)
 	/* NON-PORTABLE */
 	hTclModule = TclWinGetTclInstance(); /* HACK: Requires "tclInt.h". */
+#else
+	Dl_info info;
+
+	/*
+	 * NOTE: Find the shared library containing the Tcl API functions and
+	 *       obtain a handle for it without loading it again.  The handle
+	 *       is only used to look up the exported Tcl API functions.
+	 */
+
+	memset(&info, 0, sizeof(Dl_info));
+
+	if (dladdr((LPVOID) Tcl_GetVersion, &info) && info.dli_fname != NULL)
+	    hTclModule = dlopen(info.dli_fname, RTLD_LAZY | RTLD_NOLOAD);
+#endif
     }
 
     if (hTclModule == NULL) {
@@ -2665,14 +4424,15 @@ int Garuda_Init(
      *       package (i.e. in another Tcl interpreter)?
      */
 
-    bClrWasLoaded = (pClrRuntimeHost != NULL);
+    bClrWasLoaded = IsTheClrLoaded();
     bClrWasStarted = bClrStarted;
 
     /*
      * NOTE: Load [and possibly start] the CLR now.
      */
 
-    code = LoadAndStartTheClr(interp, logCommand, pConfigInfo->bLoadClr,
+    code = LoadAndStartTheClr(interp, logCommand,
+	pConfigInfo->runtimeConfigPath, pConfigInfo->bLoadClr,
 	pConfigInfo->bUseMinimumClr, pConfigInfo->bStartClr, FALSE);
 
     if (code != TCL_OK)
@@ -2688,7 +4448,7 @@ int Garuda_Init(
 	(bClrWasStarted || pConfigInfo->bStartClr) &&
 	    pConfigInfo->bStartBridge) {
 	code = GetAndExecuteClrMethod(hTclModule, &uTclStubs, pConfigInfo,
-	    interp, NULL, METHOD_TYPE_STARTUP | METHOD_VIA_LOAD);
+	    interp, NULL, 0, NULL, METHOD_TYPE_STARTUP | METHOD_VIA_LOAD);
 
 	if (code != TCL_OK)
 	    goto done;
@@ -2768,7 +4528,7 @@ done:
      *         an access violation.
      */
 
-    Tcl_MutexUnlock(&packageMutex);
+    UnlockPackage();
 
     /*
      * NOTE: If some step of loading the package failed, attempt to cleanup now
@@ -2860,12 +4620,28 @@ int Garuda_Unload(
 	return TCL_ERROR;
     }
 
+    /*
+     * NOTE: If any CLR methods are still being executed asynchronously, this
+     *       package cannot be unloaded from the process because the threads
+     *       executing them, and the events used to deliver their results,
+     *       refer to the code in this package.  This does not apply when the
+     *       process itself is exiting.
+     */
+
+    if (bShutdown && (interp != NULL) && /* NON-PORTABLE */
+	    (InterlockedCompareExchange(&lAsyncCalls, 0, 0) > 0)) {
+	Tcl_AppendResult(interp,
+	    "asynchronous CLR method execution pending\n", NULL);
+
+	return TCL_ERROR;
+    }
+
     /*
      * NOTE: Grab the package lock and hold onto it for the entire time we are
      *       cleaning up and unloading the package.
      */
 
-    Tcl_MutexLock(&packageMutex);
+    LockPackage();
 
     /*
      * NOTE: If we are unloading this package from the process, determine if we
@@ -2979,7 +4755,7 @@ int Garuda_Unload(
 		methodFlags &= ~METHOD_LOG_EXECUTE;
 
 	    code = GetAndExecuteClrMethod(hTclModule, &uTclStubs, pConfigInfo,
-		interp, NULL, methodFlags);
+		interp, NULL, 0, NULL, methodFlags);
 
 	    if (code != TCL_OK)
 		goto done;
@@ -3076,7 +4852,7 @@ done:
      *       the entire process).
      */
 
-    Tcl_MutexUnlock(&packageMutex);
+    UnlockPackage();
 
     /*
      * NOTE: If we are unloading this package from the process, finalize our
@@ -3176,8 +4952,8 @@ static int GarudaObjCmd(
 {
     int code = TCL_OK;
     int option;
+    BOOL bLocked;
     ClrConfigInfo *pConfigInfo = NULL;
-    Tcl_Obj *listPtr = NULL;
 
     static CONST char *cmdOptions[] = {
 	"bridgerunning", "clrappdomainid", "clrexecute", "clrload",
@@ -3206,7 +4982,18 @@ static int GarudaObjCmd(
 	return TCL_ERROR;
     }
 
-    Tcl_MutexLock(&packageMutex);
+    /*
+     * NOTE: The sub-commands that execute an arbitrary CLR method do not hold
+     *       the package mutex while doing so; see the ExecuteClrMethod
+     *       function.  All the other sub-commands hold it until they are
+     *       done, e.g. so that the loading, starting, and stopping of the CLR
+     *       and the bridge remain serialized.
+     */
+
+    bLocked = (option != OPT_CLREXECUTE) && (option != OPT_CONTROL);
+
+    if (bLocked)
+	LockPackage();
 
     switch ((enum options)option) {
 	case OPT_BRIDGERUNNING: { /* SAFE */
@@ -3241,7 +5028,7 @@ static int GarudaObjCmd(
 		goto done;
 	    }
 
-	    if (pClrRuntimeHost == NULL) {
+	    if (!IsTheClrLoaded()) {
 		Tcl_AppendResult(interp, "CLR not loaded\n", NULL);
 		code = TCL_ERROR;
 		goto done;
@@ -3253,8 +5040,18 @@ static int GarudaObjCmd(
 		goto done;
 	    }
 
+#if defined(USE_CLR_CORE)
+	    /*
+	     * NOTE: When using the "hostfxr" library, there is only ever one
+	     *       application domain, i.e. the default one.
+	     */
+
+	    hResult = S_OK;
+	    appDomainId = 1;
+#else
 	    hResult = ICLRRuntimeHost_GetCurrentAppDomainId(pClrRuntimeHost,
 		&appDomainId);
+#endif
 
 	    if (SUCCEEDED(hResult)) {
 		Tcl_Obj *objPtr = Tcl_NewLongObj(appDomainId);
@@ -3281,15 +5078,41 @@ static int GarudaObjCmd(
 	}
 	case OPT_CLREXECUTE: {
 	    DWORD returnValue = TCL_OK;
+	    Tcl_Obj *callbackPtr = NULL;
+	    int argIndex = 2;
+
+	    static CONST char *execOptions[] = {
+		"-command", (char *) NULL
+	    };
 
-	    if (objc != 6) {
+	    if ((objc != 6) && (objc != 8)) {
 		Tcl_WrongNumArgs(interp, 2, objv,
-		    "assemblyPath typeName methodName argument");
+		    "?-command script? assemblyPath typeName methodName "
+		    "argument");
 
 		code = TCL_ERROR;
 		goto done;
 	    }
 
+	    /*
+	     * NOTE: When a callback script is specified, the CLR method will
+	     *       be executed asynchronously and the results will be passed
+	     *       to that script.
+	     */
+
+	    if (objc == 8) {
+		int index;
+
+		if (Tcl_GetIndexFromObj(interp, objv[2], execOptions, "option",
+			0, &index) != TCL_OK) {
+		    code = TCL_ERROR;
+		    goto done;
+		}
+
+		callbackPtr = objv[3];
+		argIndex = 4;
+	    }
+
 	    if (Tcl_IsSafe(interp)) {
 		Tcl_AppendResult(interp, "permission denied: safe interp\n",
 		    NULL);
@@ -3303,9 +5126,19 @@ static int GarudaObjCmd(
 	    if (code != TCL_OK)
 		goto done;
 
+	    if (callbackPtr != NULL) {
+		code = AsyncExecuteClrMethod(pConfigInfo, interp,
+		    objv[argIndex], objv[argIndex + 1], objv[argIndex + 2],
+		    objv[argIndex + 3], callbackPtr, METHOD_TYPE_DEMAND |
+		    METHOD_VIA_DEMAND);
+
+		break;
+	    }
+
 	    code = DemandExecuteClrMethod(hTclModule, &uTclStubs, pConfigInfo,
-		interp, objv[2], objv[3], objv[4], objv[5], METHOD_TYPE_DEMAND |
-		METHOD_VIA_DEMAND, &returnValue);
+		interp, objv[argIndex], objv[argIndex + 1], objv[argIndex + 2],
+		objv[argIndex + 3], METHOD_TYPE_DEMAND | METHOD_VIA_DEMAND,
+		&returnValue);
 
 	    if (code == TCL_OK) {
 		Tcl_Obj *objPtr = Tcl_NewLongObj(returnValue);
@@ -3364,8 +5197,8 @@ static int GarudaObjCmd(
 	    if (code != TCL_OK)
 		goto done;
 
-	    code = LoadAndStartTheClr(interp, pConfigInfo->logCommand, TRUE,
-		FALSE, FALSE, TRUE);
+	    code = LoadAndStartTheClr(interp, pConfigInfo->logCommand,
+		pConfigInfo->runtimeConfigPath, TRUE, FALSE, FALSE, TRUE);
 
 	    break;
 	}
@@ -3389,8 +5222,8 @@ static int GarudaObjCmd(
 	    if (code != TCL_OK)
 		goto done;
 
-	    code = LoadAndStartTheClr(interp, pConfigInfo->logCommand, FALSE,
-		FALSE, TRUE, TRUE);
+	    code = LoadAndStartTheClr(interp, pConfigInfo->logCommand,
+		pConfigInfo->runtimeConfigPath, FALSE, FALSE, TRUE, TRUE);
 
 	    break;
 	}
@@ -3428,7 +5261,9 @@ static int GarudaObjCmd(
 	case OPT_CLRVERSION: { /* SAFE */
 	    HRESULT hResult;
 	    WCHAR buffer[PACKAGE_RESULT_SIZE + 1] = {0};
+#if !defined(USE_CLR_CORE)
 	    DWORD length;
+#endif
 
 	    if (objc != 2) {
 		Tcl_WrongNumArgs(interp, 2, objv, NULL);
@@ -3436,7 +5271,15 @@ static int GarudaObjCmd(
 		goto done;
 	    }
 
-#if defined(USE_CLR_40)
+#if defined(USE_CLR_CORE)
+	    if (hClrHostContext == NULL) {
+		Tcl_AppendResult(interp, "CLR not loaded\n", NULL);
+		code = TCL_ERROR;
+		goto done;
+	    }
+
+	    hResult = GetClrCoreVersion(buffer, PACKAGE_RESULT_SIZE);
+#elif defined(USE_CLR_40)
 	    if (pClrRuntimeInfo == NULL) {
 		Tcl_AppendResult(interp, "CLR not loaded\n", NULL);
 		code = TCL_ERROR;
@@ -3465,7 +5308,10 @@ static int GarudaObjCmd(
 		Tcl_DecrRefCount(objPtr);
 	    } else {
 		Tcl_AppendUnicodeToObj(Tcl_GetObjResult(interp),
-#if defined(USE_CLR_40)
+#if defined(USE_CLR_CORE)
+		    GetClrErrorMessage(L"hostfxr_get_runtime_property_value",
+			hResult), -1);
+#elif defined(USE_CLR_40)
 		    GetClrErrorMessage(L"ICLRRuntimeInfo_GetVersionString",
 			hResult), -1);
 #else
@@ -3486,24 +5332,19 @@ static int GarudaObjCmd(
 		goto done;
 	    }
 
-	    if (objc > 2) {
-		listPtr = Tcl_NewListObj(objc - 2, objv + 2);
-
-		if (listPtr == NULL) {
-		    Tcl_AppendResult(interp, "out of memory: listPtr\n", NULL);
-		    goto done;
-		}
-
-		Tcl_IncrRefCount(listPtr);
-	    }
-
 	    code = GetClrConfigInfo(interp, FALSE, FALSE, &pConfigInfo);
 
 	    if (code != TCL_OK)
 		goto done;
 
+	    /*
+	     * NOTE: The extra arguments are passed as-is.  They will only be
+	     *       converted to a list, if necessary, based on the protocol
+	     *       used by the control method.
+	     */
+
 	    code = GetAndExecuteClrMethod(hTclModule, &uTclStubs, pConfigInfo,
-		interp, (listPtr != NULL) ? Tcl_GetUnicode(listPtr) : NULL,
+		interp, NULL, objc - 2, (objc > 2) ? objv + 2 : NULL,
 		METHOD_TYPE_CONTROL | METHOD_VIA_COMMAND);
 
 	    break;
@@ -3529,7 +5370,7 @@ static int GarudaObjCmd(
 		goto done;
 
 	    code = GetAndExecuteClrMethod(hTclModule, &uTclStubs, pConfigInfo,
-		interp, NULL, METHOD_TYPE_DETACH | METHOD_VIA_COMMAND);
+		interp, NULL, 0, NULL, METHOD_TYPE_DETACH | METHOD_VIA_COMMAND);
 
 	    break;
 	}
@@ -3557,18 +5398,29 @@ static int GarudaObjCmd(
 		L" packageFileName {%s} lTclStubs %ld hTclModule "
 		PACKAGE_UNICODE_PTR_FMT L" pTclStubs "
 		PACKAGE_UNICODE_PTR_FMT
+#if defined(USE_CLR_CORE)
+		L" hHostFxrModule " PACKAGE_UNICODE_PTR_FMT
+		L" hClrHostContext " PACKAGE_UNICODE_PTR_FMT
+		L" pClrLoadAssembly " PACKAGE_UNICODE_PTR_FMT
+#else
 #if defined(USE_CLR_40)
 		L" pClrMetaHost " PACKAGE_UNICODE_PTR_FMT
 		L" pClrRuntimeInfo " PACKAGE_UNICODE_PTR_FMT
 #endif
 		L" pClrRuntimeHost " PACKAGE_UNICODE_PTR_FMT
+#endif
 		L" bClrStarted %d bBridgeStarted %d", packageMutex,
 		hPackageModule, packageFileName, lTclStubs, hTclModule,
 		&uTclStubs,
+#if defined(USE_CLR_CORE)
+		hHostFxrModule, hClrHostContext, pClrLoadAssembly,
+#else
 #if defined(USE_CLR_40)
 		pClrMetaHost, pClrRuntimeInfo,
 #endif
-		pClrRuntimeHost, bClrStarted, bBridgeStarted);
+		pClrRuntimeHost,
+#endif
+		bClrStarted, bBridgeStarted);
 
 	    objPtr = Tcl_NewUnicodeObj(buffer, -1);
 
@@ -3616,7 +5468,8 @@ static int GarudaObjCmd(
 		goto done;
 
 	    code = GetAndExecuteClrMethod(hTclModule, &uTclStubs, pConfigInfo,
-		interp, NULL, METHOD_TYPE_SHUTDOWN | METHOD_VIA_COMMAND);
+		interp, NULL, 0, NULL, METHOD_TYPE_SHUTDOWN |
+		METHOD_VIA_COMMAND);
 
 	    if (code == TCL_OK)
 		bBridgeStarted = FALSE;
@@ -3644,7 +5497,8 @@ static int GarudaObjCmd(
 		goto done;
 
 	    code = GetAndExecuteClrMethod(hTclModule, &uTclStubs, pConfigInfo,
-		interp, NULL, METHOD_TYPE_STARTUP | METHOD_VIA_COMMAND);
+		interp, NULL, 0, NULL, METHOD_TYPE_STARTUP |
+		METHOD_VIA_COMMAND);
 
 	    if (code == TCL_OK)
 		bBridgeStarted = TRUE;
@@ -3659,14 +5513,11 @@ static int GarudaObjCmd(
     }
 
 done:
-    if (listPtr != NULL) {
-	Tcl_DecrRefCount(listPtr);
-	listPtr = NULL;
-    }
-
     FreeClrConfigInfo(&pConfigInfo);
 
-    Tcl_MutexUnlock(&packageMutex);
+    if (bLocked)
+	UnlockPackage();
+
     return code;
 }
 
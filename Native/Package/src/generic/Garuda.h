@@ -42,6 +42,8 @@
 #define USE_MINIMUM_CLR_VAR_NAME			"::useMinimumClr"
 #define USE_ISOLATION					"::useIsolation"
 #define USE_SAFE_INTERP					"::useSafeInterp"
+#define RUNTIME_CONFIG_VAR_NAME				"::runtimeConfigPath"
+#define DELEGATE_TYPE_NAME_VAR_NAME			"::delegateTypeName"
 
 /*
  * NOTE: These are the public functions exported by this library.
@@ -19,6 +19,7 @@
 #define PACKAGE_UNICODE_PROTOCOL_V1R0	UNICODE_TEXT(PACKAGE_PROTOCOL_V1R0)
 #define PACKAGE_UNICODE_PROTOCOL_V1R1	UNICODE_TEXT(PACKAGE_PROTOCOL_V1R1)
 #define PACKAGE_UNICODE_PROTOCOL_V1R2	UNICODE_TEXT(PACKAGE_PROTOCOL_V1R2)
+#define PACKAGE_UNICODE_PROTOCOL_V1R3	UNICODE_TEXT(PACKAGE_PROTOCOL_V1R3)
 
 #define PACKAGE_HEX_FMT			"0x%X"
 #define PACKAGE_UNICODE_HEX_FMT		UNICODE_TEXT(PACKAGE_HEX_FMT)
@@ -26,7 +27,18 @@
 #define PACKAGE_PTR_FMT			"0x%p"
 #define PACKAGE_UNICODE_PTR_FMT		UNICODE_TEXT(PACKAGE_PTR_FMT)
 
-#define PACKAGE_ISTR_FMT		"%S"
+/*
+ * HACK: Outside of Windows, the C library cannot format the UTF-16 strings
+ *       used by this package (i.e. it expects wchar_t to be 32-bits), so
+ *       the narrow (trace) output shows their addresses instead.
+ */
+
+#if defined(_WIN32)
+  #define PACKAGE_ISTR_FMT		"%S"
+#else
+  #define PACKAGE_ISTR_FMT		"%p"
+#endif
+
 #define PACKAGE_UNICODE_ISTR_FMT	UNICODE_TEXT(PACKAGE_ISTR_FMT)
 
 #define PACKAGE_RESULT_SIZE		(1024)
@@ -41,7 +53,11 @@
  *       method of getting that level of precision via the preprocessor.
  */
 
-#if !defined(_MSC_VER) || _MSC_VER >= 1500
+#if !defined(_WIN32)
+  #define gwprintf				GarudaSwprintf
+  #define gsnprintf				vsnprintf
+  #define GWPRINTF_LENGTH_HAS_NUL		(0)
+#elif !defined(_MSC_VER) || _MSC_VER >= 1500
   #define gwprintf				swprintf
   #define gsnprintf				vsnprintf
   #define GWPRINTF_LENGTH_HAS_NUL		(0)
@@ -51,6 +67,20 @@
   #define GWPRINTF_LENGTH_HAS_NUL		(1)
 #endif
 
+/*
+ * NOTE: The CRT wide character string functions cannot be used on platforms
+ *       where the C library expects its wchar_t type to be 32-bits, even if
+ *       this package was compiled with a 16-bit wchar_t type.
+ */
+
+#if !defined(_WIN32)
+  #define gwcslen				GarudaWcsLen
+  #define gwcsncpy				GarudaWcsNCpy
+#else
+  #define gwcslen				wcslen
+  #define gwcsncpy				wcsncpy
+#endif
+
 /*
  * NOTE: The maximum size of the buffer to be used with OutputDebugString.
  */
@@ -97,6 +127,18 @@
   #define PACKAGE_PANIC(x)
 #endif
 
+/*
+ * NOTE: Pasting two string literal tokens together, as the JOIN macro from
+ *       "tcl.h" does, is only accepted by the MSVC compiler.  Elsewhere, the
+ *       concatenation of adjacent string literals is used instead.
+ */
+
+#if defined(_MSC_VER)
+  #define PACKAGE_UNICODE_JOIN(a,b)	JOIN(a,b)
+#else
+  #define PACKAGE_UNICODE_JOIN(a,b)	a b
+#endif
+
 /*
  * NOTE: These variable names are built using the base variable name strings
  *       defined in "Garuda.h".  The package name is prefixed to each variable
@@ -105,58 +147,84 @@
  */
 
 #define PACKAGE_UNICODE_ASSEMBLY_PATH_VAR_NAME \
-    JOIN(PACKAGE_UNICODE_NAME, UNICODE_TEXT(ASSEMBLY_PATH_VAR_NAME))
+    PACKAGE_UNICODE_JOIN(PACKAGE_UNICODE_NAME, \
+	UNICODE_TEXT(ASSEMBLY_PATH_VAR_NAME))
 
 #define PACKAGE_UNICODE_TYPE_NAME_VAR_NAME \
-    JOIN(PACKAGE_UNICODE_NAME, UNICODE_TEXT(TYPE_NAME_VAR_NAME))
+    PACKAGE_UNICODE_JOIN(PACKAGE_UNICODE_NAME, \
+	UNICODE_TEXT(TYPE_NAME_VAR_NAME))
 
 #define PACKAGE_UNICODE_STARTUP_METHOD_VAR_NAME \
-    JOIN(PACKAGE_UNICODE_NAME, UNICODE_TEXT(STARTUP_METHOD_VAR_NAME))
+    PACKAGE_UNICODE_JOIN(PACKAGE_UNICODE_NAME, \
+	UNICODE_TEXT(STARTUP_METHOD_VAR_NAME))
 
 #define PACKAGE_UNICODE_CONTROL_METHOD_VAR_NAME \
-    JOIN(PACKAGE_UNICODE_NAME, UNICODE_TEXT(CONTROL_METHOD_VAR_NAME))
+    PACKAGE_UNICODE_JOIN(PACKAGE_UNICODE_NAME, \
+	UNICODE_TEXT(CONTROL_METHOD_VAR_NAME))
 
 #define PACKAGE_UNICODE_DETACH_METHOD_VAR_NAME \
-    JOIN(PACKAGE_UNICODE_NAME, UNICODE_TEXT(DETACH_METHOD_VAR_NAME))
+    PACKAGE_UNICODE_JOIN(PACKAGE_UNICODE_NAME, \
+	UNICODE_TEXT(DETACH_METHOD_VAR_NAME))
 
 #define PACKAGE_UNICODE_SHUTDOWN_METHOD_VAR_NAME \
-    JOIN(PACKAGE_UNICODE_NAME, UNICODE_TEXT(SHUTDOWN_METHOD_VAR_NAME))
+    PACKAGE_UNICODE_JOIN(PACKAGE_UNICODE_NAME, \
+	UNICODE_TEXT(SHUTDOWN_METHOD_VAR_NAME))
 
 #define PACKAGE_UNICODE_METHOD_ARGUMENTS_VAR_NAME \
-    JOIN(PACKAGE_UNICODE_NAME, UNICODE_TEXT(METHOD_ARGUMENTS_VAR_NAME))
+    PACKAGE_UNICODE_JOIN(PACKAGE_UNICODE_NAME, \
+	UNICODE_TEXT(METHOD_ARGUMENTS_VAR_NAME))
 
 #define PACKAGE_UNICODE_METHOD_FLAGS_VAR_NAME \
-    JOIN(PACKAGE_UNICODE_NAME, UNICODE_TEXT(METHOD_FLAGS_VAR_NAME))
+    PACKAGE_UNICODE_JOIN(PACKAGE_UNICODE_NAME, \
+	UNICODE_TEXT(METHOD_FLAGS_VAR_NAME))
 
 #define PACKAGE_UNICODE_VERBOSE_VAR_NAME \
-    JOIN(PACKAGE_UNICODE_NAME, UNICODE_TEXT(VERBOSE_VAR_NAME))
+    PACKAGE_UNICODE_JOIN(PACKAGE_UNICODE_NAME, \
+	UNICODE_TEXT(VERBOSE_VAR_NAME))
 
 #define PACKAGE_UNICODE_LOAD_CLR_VAR_NAME \
-    JOIN(PACKAGE_UNICODE_NAME, UNICODE_TEXT(LOAD_CLR_VAR_NAME))
+    PACKAGE_UNICODE_JOIN(PACKAGE_UNICODE_NAME, \
+	UNICODE_TEXT(LOAD_CLR_VAR_NAME))
 
 #define PACKAGE_UNICODE_START_CLR_VAR_NAME \
-    JOIN(PACKAGE_UNICODE_NAME, UNICODE_TEXT(START_CLR_VAR_NAME))
+    PACKAGE_UNICODE_JOIN(PACKAGE_UNICODE_NAME, \
+	UNICODE_TEXT(START_CLR_VAR_NAME))
 
 #define PACKAGE_UNICODE_START_BRIDGE_VAR_NAME \
-    JOIN(PACKAGE_UNICODE_NAME, UNICODE_TEXT(START_BRIDGE_VAR_NAME))
+    PACKAGE_UNICODE_JOIN(PACKAGE_UNICODE_NAME, \
+	UNICODE_TEXT(START_BRIDGE_VAR_NAME))
 
 #define PACKAGE_UNICODE_STOP_CLR_VAR_NAME \
-    JOIN(PACKAGE_UNICODE_NAME, UNICODE_TEXT(STOP_CLR_VAR_NAME))
+    PACKAGE_UNICODE_JOIN(PACKAGE_UNICODE_NAME, \
+	UNICODE_TEXT(STOP_CLR_VAR_NAME))
 
 #define PACKAGE_UNICODE_LOG_COMMAND_VAR_NAME \
-    JOIN(PACKAGE_UNICODE_NAME, UNICODE_TEXT(LOG_COMMAND_VAR_NAME))
+    PACKAGE_UNICODE_JOIN(PACKAGE_UNICODE_NAME, \
+	UNICODE_TEXT(LOG_COMMAND_VAR_NAME))
 
 #define PACKAGE_UNICODE_NO_NORMALIZE_VAR_NAME \
-    JOIN(PACKAGE_UNICODE_NAME, UNICODE_TEXT(NO_NORMALIZE_VAR_NAME))
+    PACKAGE_UNICODE_JOIN(PACKAGE_UNICODE_NAME, \
+	UNICODE_TEXT(NO_NORMALIZE_VAR_NAME))
 
 #define PACKAGE_UNICODE_USE_MINIMUM_CLR_VAR_NAME \
-    JOIN(PACKAGE_UNICODE_NAME, UNICODE_TEXT(USE_MINIMUM_CLR_VAR_NAME))
+    PACKAGE_UNICODE_JOIN(PACKAGE_UNICODE_NAME, \
+	UNICODE_TEXT(USE_MINIMUM_CLR_VAR_NAME))
 
 #define PACKAGE_UNICODE_USE_ISOLATION \
-    JOIN(PACKAGE_UNICODE_NAME, UNICODE_TEXT(USE_ISOLATION))
+    PACKAGE_UNICODE_JOIN(PACKAGE_UNICODE_NAME, \
+	UNICODE_TEXT(USE_ISOLATION))
 
 #define PACKAGE_UNICODE_USE_SAFE_INTERP \
-    JOIN(PACKAGE_UNICODE_NAME, UNICODE_TEXT(USE_SAFE_INTERP))
+    PACKAGE_UNICODE_JOIN(PACKAGE_UNICODE_NAME, \
+	UNICODE_TEXT(USE_SAFE_INTERP))
+
+#define PACKAGE_UNICODE_RUNTIME_CONFIG_VAR_NAME \
+    PACKAGE_UNICODE_JOIN(PACKAGE_UNICODE_NAME, \
+	UNICODE_TEXT(RUNTIME_CONFIG_VAR_NAME))
+
+#define PACKAGE_UNICODE_DELEGATE_TYPE_NAME_VAR_NAME \
+    PACKAGE_UNICODE_JOIN(PACKAGE_UNICODE_NAME, \
+	UNICODE_TEXT(DELEGATE_TYPE_NAME_VAR_NAME))
 
 /*
  * NOTE: This is the latest version of the CLR that we know about.  This is
@@ -175,6 +243,46 @@
   #define CLR_VERSION_LATEST			CLR_VERSION_V4
 #endif
 
+/*
+ * NOTE: When the CLR is hosted via the "hostfxr" library, the type name of
+ *       each method must be qualified with the name of its assembly.  When
+ *       the configured type name is not, this separator and the file name
+ *       of the assembly, without its extension, are appended to it.
+ */
+
+#if defined(USE_CLR_CORE)
+  #define CLR_CORE_ASSEMBLY_NAME_SEPARATOR	L", "
+#endif
+
+/*
+ * NOTE: This is the name of the runtime property that contains the path of
+ *       the dependencies file for the shared framework selected by the
+ *       "hostfxr" library, which is used to determine its version.  Since
+ *       it is passed directly to that library, it uses its string format,
+ *       i.e. UTF-16 on Windows and UTF-8 elsewhere.
+ */
+
+#if defined(USE_CLR_CORE)
+  #if defined(_WIN32)
+    #define CLR_CORE_VERSION_PROPERTY_NAME	L"FX_DEPS_FILE"
+  #else
+    #define CLR_CORE_VERSION_PROPERTY_NAME	"FX_DEPS_FILE"
+  #endif
+#endif
+
+/*
+ * NOTE: This is the name of the native API used to execute the CLR methods,
+ *       for use in diagnostic messages.
+ */
+
+#if defined(USE_CLR_CORE)
+  #define CLR_EXECUTE_PROC_NAME \
+    L"load_assembly_and_get_function_pointer"
+#else
+  #define CLR_EXECUTE_PROC_NAME \
+    L"ICLRRuntimeHost_ExecuteInDefaultAppDomain"
+#endif
+
 /*
  * NOTE: The environment variable used to indicate that the CLR is being
  *       stopped.
@@ -273,6 +381,13 @@ typedef enum {
 				      * created?  Automatically set to non-zero
 				      * when the associated configuration
 				      * setting is enabled. */
+    METHOD_PROTOCOL_V1R3 = 0x2000,   /* Superset of METHOD_PROTOCOL_V1R2.  If
+				      * set, the protocol information and the
+				      * method arguments will be passed via a
+				      * pointer to a ClrProtocolData structure
+				      * instead of being converted to strings,
+				      * and the method may use it to return a
+				      * result string. */
 
     /*
      * NOTE: These are the "standard" flag combinations used by this package to
@@ -291,6 +406,14 @@ typedef enum {
 
     METHOD_VIA_UNLOAD = METHOD_PROTOCOL_V1R1 | METHOD_LOG_EXECUTE |
 			METHOD_STRICT_RETURN | METHOD_PROTOCOL_LEGACY,
+
+    /*
+     * NOTE: These are all the flags that select the native-to-managed code
+     *       protocol.
+     */
+
+    METHOD_PROTOCOL_MASK = METHOD_PROTOCOL_V1R1 | METHOD_PROTOCOL_V1R2 |
+			   METHOD_PROTOCOL_LEGACY | METHOD_PROTOCOL_V1R3
 } MethodFlags;
 
 /*
@@ -392,6 +515,61 @@ typedef struct ClrTclStubs {
     void (*tcl_Finalize) (void);
 } ClrTclStubs;
 
+/*
+ * NOTE: This is the signature of the CLR methods executed by this package.
+ *       When the CLR is hosted via the "hostfxr" library, these methods are
+ *       called directly, via a native function pointer.
+ */
+
+#if defined(USE_CLR_CORE)
+typedef int (CORECLR_DELEGATE_CALLTYPE *ClrCoreMethodFnPtr)(LPCWSTR argument);
+#endif
+
+/*
+ * NOTE: This enumeration contains the flags passed to the CLR methods executed
+ *       using the native-to-managed code protocol (V1R3).
+ */
+
+typedef enum {
+    PROTOCOL_NONE = 0x0,	     /* No flags. */
+    PROTOCOL_USE_ISOLATION = 0x1,    /* Should an isolated Eagle interpreter be
+				      * used? */
+    PROTOCOL_USE_SAFE_INTERP = 0x2   /* Is the Tcl interpreter "safe"?  If so,
+				      * the Eagle interpreter must be as
+				      * well. */
+} ProtocolFlags;
+
+/*
+ * NOTE: This structure is passed, by address, to the CLR methods executed using
+ *       the native-to-managed code protocol (V1R3).  The argument string for
+ *       those methods only contains the protocol version indicator and the
+ *       address of this structure.  All strings are UTF-16 and their lengths
+ *       are in characters; they are not necessarily NUL terminated.  The CLR
+ *       method may return a result string by setting the result and length
+ *       fields; the storage for it must be allocated via CoTaskMemAlloc (i.e.
+ *       the Marshal.StringToCoTaskMemUni method) and is freed by this package.
+ *       The layout of this structure must match the one used by the CLR.
+ */
+
+typedef struct ClrProtocolData {
+    size_t sizeOf;		/* The size of this structure, in bytes. */
+    HANDLE hModule;		/* The Tcl library module handle. */
+    ClrTclStubs *pTclStubs;	/* The Tcl C API function pointers. */
+    Tcl_Interp *interp;		/* The Tcl interpreter. */
+    ProtocolFlags flags;	/* The flags for the CLR method. */
+    LPCWSTR argument;		/* The configured argument for the method, if
+				 * any.  This SHOULD be a well-formed Tcl
+				 * list. */
+    int argumentLength;		/* The length of the configured argument. */
+    int objc;			/* The number of extra arguments. */
+    Tcl_Obj *CONST *objv;	/* The extra arguments, as Tcl objects. */
+    LPCWSTR *argv;		/* The extra arguments, as strings.  These are
+				 * passed as-is, without any list quoting. */
+    int *argl;			/* The lengths of the extra arguments. */
+    LPWSTR result;		/* OUT: The result string, if any. */
+    int resultLength;		/* OUT: The length of the result string. */
+} ClrProtocolData;
+
 /*
  * NOTE: This structure contains the information used by this package to execute
  *       a CLR method.
@@ -406,6 +584,10 @@ typedef struct ClrMethodInfo {
     LPCWSTR methodName;	    /* The method name to execute. */
     LPCWSTR argument;	    /* The argument string to be passed to the method.
 			     * This SHOULD be a well-formed Tcl list. */
+    LPCWSTR delegateTypeName; /* The assembly qualified name of the delegate
+			     * type matching the method signature.  This is
+			     * only used when the CLR is hosted via the
+			     * "hostfxr" library. */
 } ClrMethodInfo;
 
 /*
@@ -430,6 +612,10 @@ typedef struct ClrConfigInfo {
 				     * any. */
     LPCWSTR logCommand;		    /* The name of the Tcl command to use for
 				     * logging purposes (e.g. tclLog). */
+    LPCWSTR runtimeConfigPath;	    /* The fully qualified path and file name
+				     * of the runtime configuration file used
+				     * to initialize the CLR via the "hostfxr"
+				     * library, if any. */
     MethodFlags methodFlags;	    /* The method flags to use when executing
 				     * any of the CLR methods. */
     BOOL bVerbose;		    /* Enable extra diagnostic output from the
@@ -458,6 +644,65 @@ typedef struct ClrConfigInfo {
 				     * associated MethodFlags to be set. */
 } ClrConfigInfo;
 
+/*
+ * NOTE: This structure contains the information used by this package to execute
+ *       a CLR method asynchronously, i.e. on another thread, and to deliver the
+ *       results back to the thread that owns the Tcl interpreter.
+ */
+
+typedef struct ClrAsyncData {
+    size_t sizeOf;		/* The size of this structure, in bytes. */
+    Tcl_ThreadId threadId;	/* The thread that owns the Tcl interpreter. */
+    Tcl_Interp *interp;		/* The Tcl interpreter used to evaluate the
+				 * callback script.  It is preserved until
+				 * the results have been delivered. */
+    Tcl_Obj *callbackPtr;	/* The callback script.  This may only be
+				 * used by the thread that owns the Tcl
+				 * interpreter. */
+    ClrMethodInfo *pMethodInfo; /* The CLR method to execute. */
+    MethodFlags methodFlags;	/* The flags used to execute the CLR method. */
+    int code;			/* OUT: The standard Tcl result. */
+    DWORD returnValue;		/* OUT: The return value of the CLR method. */
+    LPWSTR errorMessage;	/* OUT: The error message, if any. */
+    int errorLength;		/* OUT: The length of the error message. */
+    BOOL queued;		/* Non-zero if the event used to deliver the
+				 * results has been queued.  This is protected
+				 * by the package mutex. */
+    BOOL canceled;		/* Non-zero if the thread that owns the Tcl
+				 * interpreter has exited before the results
+				 * were delivered.  This is protected by the
+				 * package mutex. */
+    struct ClrAsyncData *nextPtr; /* The next CLR method pending for the
+				 * thread that owns the Tcl interpreter.  This
+				 * may only be used by that thread. */
+} ClrAsyncData;
+
+/*
+ * NOTE: This structure is the Tcl event used to deliver the results of a CLR
+ *       method executed asynchronously.
+ */
+
+typedef struct ClrAsyncEvent {
+    Tcl_Event header;		/* The standard Tcl event header.  This MUST be
+				 * the first field. */
+    ClrAsyncData *pAsyncData;	/* The results to deliver. */
+} ClrAsyncEvent;
+
+/*
+ * NOTE: This structure contains the per-thread data used by this package.  The
+ *       CLR methods are executed without holding the package mutex; therefore,
+ *       any storage used while executing them cannot be shared by threads.
+ */
+
+typedef struct ThreadSpecificData {
+    WCHAR message[PACKAGE_RESULT_SIZE + 1]; /* The last error message built
+					     * by this thread. */
+    ClrAsyncData *pAsyncList;		    /* The CLR methods executed
+					     * asynchronously by this thread
+					     * that have not had their results
+					     * delivered yet. */
+} ThreadSpecificData;
+
 /*
  * NOTE: These are the functions used internally by this library (i.e. they are
  *       shared by several files).
@@ -28,16 +28,33 @@
   #define STDC_HEADERS
 #endif
 
+/*
+ * NOTE: The native CLR API (i.e. "MSCorEE") is only available on Windows.
+ *       Everywhere else, the CLR must be hosted via the "hostfxr" library
+ *       that ships with .NET Core (and later).  That hosting API may also
+ *       be used on Windows when the CLR_CORE compile-time option is enabled.
+ */
+
+#if !defined(_WIN32) && !defined(CLR_CORE)
+  #define CLR_CORE
+#endif
+
+#if defined(CLR_CORE)
+  #define USE_CLR_CORE
+#endif
+
 /*
  * NOTE: For now, only enable use of the latest version of the CLR if we are
  *       compiling with the MSVC compiler that shipped with Visual Studio 2010
  *       or higher -AND- the CLR_40 compile-time option is enabled.
  */
 
-#if defined(_MSC_VER) && _MSC_VER >= 1600 && defined(CLR_40)
-  #define USE_CLR_40
-#elif defined(RC_MSC_VER) && RC_MSC_VER >= 1600 && defined(CLR_40)
-  #define USE_CLR_40
+#if !defined(USE_CLR_CORE)
+  #if defined(_MSC_VER) && _MSC_VER >= 1600 && defined(CLR_40)
+    #define USE_CLR_40
+  #elif defined(RC_MSC_VER) && RC_MSC_VER >= 1600 && defined(CLR_40)
+    #define USE_CLR_40
+  #endif
 #endif
 
 /*
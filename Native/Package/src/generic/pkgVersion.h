@@ -19,6 +19,7 @@
 #define PACKAGE_PROTOCOL_V1R0	"v1.0"
 #define PACKAGE_PROTOCOL_V1R1	"v1.0_r1.0"
 #define PACKAGE_PROTOCOL_V1R2	"v1.0_r2.0"
+#define PACKAGE_PROTOCOL_V1R3	"v1.0_r3.0"
 #define PACKAGE_TCL_VERSION	"8.4"
 #define SOURCE_ID		"687511caf5977ca1c8261dba4d77e6bbcf444161"
 #define SOURCE_TIMESTAMP	"2024-02-29 17:27:11 UTC"
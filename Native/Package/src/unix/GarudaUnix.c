@@ -0,0 +1,361 @@
+/*
+ * GarudaUnix.c -- Eagle Package for Tcl (Garuda)
+ *
+ * Copyright (c) 2007-2012 by Joe Mistachkin.  All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution of
+ * this file, and for a DISCLAIMER OF ALL WARRANTIES.
+ *
+ * RCS: @(#) $Id: $
+ */
+
+#include <stdio.h>	/* NOTE: For snprintf, etc. */
+#include <string.h>	/* NOTE: For memcpy, etc. */
+
+#include "GarudaUnix.h"	/* NOTE: For Win32 types and wide string API. */
+
+/*
+ * NOTE: The maximum size of the buffers used to format a single numeric
+ *       conversion specification, including any flags and its width.
+ */
+
+#define NUMBER_BUFFER_SIZE			(128)
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * GarudaWcsLen --
+ *
+ *	This function returns the number of UTF-16 code units in the
+ *	specified string, not including the terminating NUL character.
+ *
+ * Results:
+ *	The length of the string.
+ *
+ * Side effects:
+ *	None.
+ *
+ *----------------------------------------------------------------------
+ */
+
+size_t GarudaWcsLen(
+    LPCWSTR string)		/* The string to measure. */
+{
+    LPCWSTR pointer = string;
+
+    while (*pointer != 0)
+	pointer++;
+
+    return (size_t)(pointer - string);
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * GarudaWcsNCpy --
+ *
+ *	This function copies at most the specified number of UTF-16
+ *	code units from the source string to the destination buffer.
+ *	If the source string is shorter than that, the rest of the
+ *	destination buffer is filled with NUL characters.
+ *
+ * Results:
+ *	The destination buffer.
+ *
+ * Side effects:
+ *	None.
+ *
+ *----------------------------------------------------------------------
+ */
+
+LPWSTR GarudaWcsNCpy(
+    LPWSTR destination,		/* The buffer to copy into. */
+    LPCWSTR source,		/* The string to copy from. */
+    size_t count)		/* The size of the buffer, in characters. */
+{
+    size_t index = 0;
+
+    for (; (index < count) && (source[index] != 0); index++)
+	destination[index] = source[index];
+
+    for (; index < count; index++)
+	destination[index] = 0;
+
+    return destination;
+}
+
+/*
+ *----------------------------------------------------------------------
+ *
+ * GarudaSwprintf --
+ *
+ *	This function formats a UTF-16 string using the semantics of
+ *	the "swprintf" function provided by the MSVC runtime library,
+ *	which the generic code for this package was written against.
+ *	In particular, "%s" expects a wide string argument and "%p"
+ *	emits the pointer value as upper-case hexadecimal digits, zero
+ *	padded to the full width of a pointer, without any prefix.  The
+ *	"c", "d", "i", "u", "x", "X", "p", "s", and "%" conversions are
+ *	supported, along with the flags, width, precision (including
+ *	"*"), and the "h", "l", and "ll" length modifiers.
+ *
+ * Results:
+ *	The number of characters written, not including the terminating
+ *	NUL character, -OR- -1 if the output was truncated.
+ *
+ * Side effects:
+ *	None.
+ *
+ *----------------------------------------------------------------------
+ */
+
+int GarudaSwprintf(
+    LPWSTR buffer,		/* The buffer to format into. */
+    size_t count,		/* The size of the buffer, in characters. */
+    LPCWSTR format,		/* The "printf-style" format string. */
+    ...)			/* The extra arguments, if any. */
+{
+    va_list argList;
+    size_t length = 0;
+    BOOL bTruncated = FALSE;
+
+    if ((buffer == NULL) || (count == 0) || (format == NULL))
+	return -1;
+
+    va_start(argList, format);
+
+    while ((*format != 0) && !bTruncated) {
+	char spec[NUMBER_BUFFER_SIZE];
+	char number[NUMBER_BUFFER_SIZE];
+	size_t specLength = 0;
+	int width = 0;
+	int precision = -1;
+	int longs = 0;
+	BOOL bLeft = FALSE;
+	WCHAR character;
+	LPCWSTR string = NULL;
+	size_t stringLength = 0;
+	size_t padding = 0;
+	size_t index;
+
+	if (*format != L'%') {
+	    if (length + 1 >= count) {
+		bTruncated = TRUE;
+		break;
+	    }
+
+	    buffer[length++] = *format++;
+	    continue;
+	}
+
+	/*
+	 * NOTE: Collect the flags, width, and precision, keeping a narrow
+	 *       copy of them for the numeric conversions.
+	 */
+
+	spec[specLength++] = '%';
+	format++;
+
+	while ((*format == L'-') || (*format == L'+') || (*format == L' ') ||
+		(*format == L'#') || (*format == L'0')) {
+	    if (*format == L'-')
+		bLeft = TRUE;
+
+	    if (specLength < NUMBER_BUFFER_SIZE - 8)
+		spec[specLength++] = (char) *format;
+
+	    format++;
+	}
+
+	if (*format == L'*') {
+	    width = va_arg(argList, int);
+
+	    if (width < 0) {
+		bLeft = TRUE;
+		width = -width;
+
+		if (specLength < NUMBER_BUFFER_SIZE - 24)
+		    spec[specLength++] = '-';
+	    }
+
+	    if (specLength < NUMBER_BUFFER_SIZE - 24)
+		specLength += snprintf(&spec[specLength], 24, "%d", width);
+
+	    format++;
+	} else {
+	    while ((*format >= L'0') && (*format <= L'9')) {
+		width = (width * 10) + (*format - L'0');
+
+		if (specLength < NUMBER_BUFFER_SIZE - 8)
+		    spec[specLength++] = (char) *format;
+
+		format++;
+	    }
+	}
+
+	if (*format == L'.') {
+	    precision = 0;
+
+	    if (specLength < NUMBER_BUFFER_SIZE - 8)
+		spec[specLength++] = '.';
+
+	    format++;
+
+	    if (*format == L'*') {
+		precision = va_arg(argList, int);
+
+		if (specLength < NUMBER_BUFFER_SIZE - 24) {
+		    specLength += snprintf(&spec[specLength], 24, "%d",
+			(precision >= 0) ? precision : 0);
+		}
+
+		format++;
+	    } else {
+		while ((*format >= L'0') && (*format <= L'9')) {
+		    precision = (precision * 10) + (*format - L'0');
+
+		    if (specLength < NUMBER_BUFFER_SIZE - 8)
+			spec[specLength++] = (char) *format;
+
+		    format++;
+		}
+	    }
+	}
+
+	while ((*format == L'h') || (*format == L'l')) {
+	    if (*format == L'l')
+		longs++;
+
+	    format++;
+	}
+
+	number[0] = '\0';
+
+	switch (*format) {
+	    case L'd':
+	    case L'i':
+	    case L'u':
+	    case L'x':
+	    case L'X': {
+		BOOL bSigned = (*format == L'd') || (*format == L'i');
+
+		/*
+		 * NOTE: Per the MSVC runtime library, the "long" type is
+		 *       always 32-bits; therefore, only "ll" is 64-bits.
+		 */
+
+		if (longs >= 2) {
+		    spec[specLength++] = 'l';
+		    spec[specLength++] = 'l';
+		}
+
+		spec[specLength++] = (char) *format;
+		spec[specLength] = '\0';
+
+		if (longs >= 2) {
+		    if (bSigned) {
+			snprintf(number, sizeof(number), spec,
+			    va_arg(argList, long long));
+		    } else {
+			snprintf(number, sizeof(number), spec,
+			    va_arg(argList, unsigned long long));
+		    }
+		} else {
+		    if (bSigned) {
+			snprintf(number, sizeof(number), spec,
+			    va_arg(argList, int));
+		    } else {
+			snprintf(number, sizeof(number), spec,
+			    va_arg(argList, unsigned int));
+		    }
+		}
+		break;
+	    }
+	    case L'p': {
+		snprintf(number, sizeof(number), "%0*llX",
+		    (int)(sizeof(LPVOID) * 2),
+		    (unsigned long long)(size_t) va_arg(argList, LPVOID));
+		break;
+	    }
+	    case L'c': {
+		character = (WCHAR) va_arg(argList, int);
+		string = &character;
+		stringLength = 1;
+		break;
+	    }
+	    case L's': {
+		string = va_arg(argList, LPCWSTR);
+
+		if (string == NULL)
+		    string = L"(null)";
+
+		stringLength = GarudaWcsLen(string);
+
+		if ((precision >= 0) && ((size_t) precision < stringLength))
+		    stringLength = (size_t) precision;
+
+		break;
+	    }
+	    case L'%': {
+		number[0] = '%';
+		number[1] = '\0';
+		break;
+	    }
+	    default: {
+		/*
+		 * NOTE: Unsupported conversion, stop formatting here.
+		 */
+
+		bTruncated = TRUE;
+		continue;
+	    }
+	}
+
+	format++;
+
+	/*
+	 * NOTE: The numeric conversions are always ASCII; otherwise, use
+	 *       the wide string, padded to the requested width.
+	 */
+
+	if (string == NULL) {
+	    for (index = 0; number[index] != '\0'; index++) {
+		if (length + 1 >= count) {
+		    bTruncated = TRUE;
+		    break;
+		}
+
+		buffer[length++] = (WCHAR) (unsigned char) number[index];
+	    }
+
+	    continue;
+	}
+
+	if ((width > 0) && ((size_t) width > stringLength))
+	    padding = (size_t) width - stringLength;
+
+	if (length + padding + stringLength >= count) {
+	    bTruncated = TRUE;
+	    break;
+	}
+
+	if (!bLeft) {
+	    for (index = 0; index < padding; index++)
+		buffer[length++] = L' ';
+	}
+
+	memcpy(&buffer[length], string, stringLength * sizeof(WCHAR));
+	length += stringLength;
+
+	if (bLeft) {
+	    for (index = 0; index < padding; index++)
+		buffer[length++] = L' ';
+	}
+    }
+
+    va_end(argList);
+
+    buffer[length] = 0;
+
+    return bTruncated ? -1 : (int) length;
+}
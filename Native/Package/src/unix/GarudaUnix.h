@@ -0,0 +1,94 @@
+/*
+ * GarudaUnix.h -- Eagle Package for Tcl (Garuda)
+ *
+ * Copyright (c) 2007-2012 by Joe Mistachkin.  All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution of
+ * this file, and for a DISCLAIMER OF ALL WARRANTIES.
+ *
+ * RCS: @(#) $Id: $
+ */
+
+#ifndef _GARUDA_UNIX_H_
+#define _GARUDA_UNIX_H_
+
+#include <stddef.h>	/* NOTE: For size_t, wchar_t, etc. */
+#include <stdarg.h>	/* NOTE: For va_list, etc. */
+
+/*
+ * NOTE: This package passes Unicode strings between Tcl, the CLR, and its
+ *       own code without any conversion; therefore, the wchar_t type (i.e.
+ *       including the "L" string literals) must be UTF-16, exactly like on
+ *       Windows.  With GCC and Clang, this requires the -fshort-wchar option.
+ */
+
+#if defined(__SIZEOF_WCHAR_T__) && __SIZEOF_WCHAR_T__ != 2
+  #error "wchar_t must be 16-bits; please compile with -fshort-wchar"
+#endif
+
+/*
+ * NOTE: These are the Win32 types and macros used by the generic code for
+ *       this package.  Only the subset actually needed is defined here.
+ */
+
+typedef int BOOL;
+typedef unsigned int DWORD, *LPDWORD;
+typedef int LONG;
+typedef unsigned int ULONG;
+typedef int HRESULT;
+typedef void *HANDLE, *HMODULE, *LPVOID;
+typedef const char *LPCSTR;
+typedef wchar_t WCHAR, *LPWSTR;
+typedef const wchar_t *LPCWSTR;
+
+#ifndef TRUE
+  #define TRUE					(1)
+#endif
+
+#ifndef FALSE
+  #define FALSE					(0)
+#endif
+
+#ifndef S_OK
+  #define S_OK					((HRESULT)0)
+#endif
+
+#ifndef SUCCEEDED
+  #define SUCCEEDED(hr)				(((HRESULT)(hr)) >= 0)
+#endif
+
+#ifndef FAILED
+  #define FAILED(hr)				(((HRESULT)(hr)) < 0)
+#endif
+
+#ifndef UNICODE_STRING_MAX_CHARS
+  #define UNICODE_STRING_MAX_CHARS		(32767)
+#endif
+
+/*
+ * NOTE: The Win32 interlocked API functions used by this package, mapped to
+ *       the equivalent GCC (and Clang) atomic builtins.
+ */
+
+#define InterlockedIncrement(p)			__sync_add_and_fetch((p), 1)
+#define InterlockedDecrement(p)			__sync_sub_and_fetch((p), 1)
+#define InterlockedCompareExchange(p,x,c) \
+    __sync_val_compare_and_swap((p), (c), (x))
+
+/*
+ * NOTE: These are the functions that replace the CRT wide character string
+ *       functions, which cannot be used because the C library expects its
+ *       wchar_t type to be 32-bits.  They are defined in "GarudaUnix.c".
+ */
+
+#ifndef PACKAGE_INTERN
+#define PACKAGE_INTERN
+#endif
+
+PACKAGE_INTERN size_t	GarudaWcsLen(LPCWSTR string);
+PACKAGE_INTERN LPWSTR	GarudaWcsNCpy(LPWSTR destination, LPCWSTR source,
+			    size_t count);
+PACKAGE_INTERN int	GarudaSwprintf(LPWSTR buffer, size_t count,
+			    LPCWSTR format, ...);
+
+#endif /* _GARUDA_UNIX_H_ */
@@ -15,7 +15,9 @@ fi
 
 pushd "$scriptdir/../src/generic"
 tclsh ../../../Common/Tools/tagViaBuild.tcl ../..
-gcc -g -fPIC -shared $gccflags -o $libname Spilornis.c -I. -DNDEBUG=1 -DHAVE_MALLOC_H=1 -DHAVE_MALLOC_USABLE_SIZE=1 -DUSE_32BIT_SIZE_T=1 $extradefs
+gcc -g -fPIC -shared -pthread $gccflags -o $libname Spilornis.c -I. -DNDEBUG=1 -DHAVE_MALLOC_H=1 -DHAVE_MALLOC_USABLE_SIZE=1 $extradefs
+gcc -g $gccflags -o spilornisBench SpilornisBench.c -I. -DNDEBUG=1 $extradefs -ldl
 mkdir -p ../../../../bin/Release$CONFIGURATION_SUFFIX/bin
 mv $libname ../../../../bin/Release$CONFIGURATION_SUFFIX/bin/spilornis.dll
+mv spilornisBench ../../../../bin/Release$CONFIGURATION_SUFFIX/bin/spilornisBench
 popd
@@ -29,11 +29,11 @@
 #endif
 
 #include <stdarg.h>		/* NOTE: For va_list, etc. */
-#include <stdio.h>		/* NOTE: For fprintf, swprintf, etc. */
+#include <stdio.h>		/* NOTE: For fprintf, vsnprintf, etc. */
 #include <stdlib.h>		/* NOTE: For getenv, calloc, free, etc. */
 #include <string.h>		/* NOTE: For memset, etc. */
 #include <limits.h>		/* NOTE: For USHRT_MAX, etc. */
-#include <wchar.h>		/* NOTE: For wcslen, swprintf, wcsncpy, etc. */
+#include <wchar.h>		/* NOTE: For WCHAR_MAX, etc. */
 
 #include "pkgVersion.h"		/* NOTE: Package version information. */
 #include "rcVersion.h"		/* NOTE: Resource version information. */
@@ -41,6 +41,31 @@
 #include "SpilornisInt.h"	/* NOTE: For private package API. */
 #include "Spilornis.h"		/* NOTE: For public package API. */
 
+#if defined(USE_SSE2_SCAN) && USE_SSE2_SCAN
+#include <emmintrin.h>		/* NOTE: For SSE2 intrinsics. */
+#endif
+
+#if defined(USE_AVX2_SCAN) && USE_AVX2_SCAN
+#include <immintrin.h>		/* NOTE: For AVX2 intrinsics. */
+#endif
+
+#if defined(USE_NEON_SCAN) && USE_NEON_SCAN
+#include <arm_neon.h>		/* NOTE: For NEON intrinsics. */
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>		/* NOTE: For _InterlockedExchangeAdd, etc. */
+#endif
+
+#if (defined(USE_POOL_ALLOCATOR) && USE_POOL_ALLOCATOR) || \
+    (defined(USE_PARALLEL_SPLIT) && USE_PARALLEL_SPLIT)
+#include <pthread.h>		/* NOTE: For pthread_mutex_lock, etc. */
+#endif
+
+#if defined(USE_PARALLEL_SPLIT) && USE_PARALLEL_SPLIT
+#include <unistd.h>		/* NOTE: For sysconf, etc. */
+#endif
+
 /*
  * The following macros are used to check if a character is a space, a
  * decimal digit, or a hexadecimal digit.  For maximum portability, we
@@ -95,12 +120,17 @@
  * 				the element is not the first element of a
  * 				list, so [eval] cannot mis-parse the element
  * 				as a comment.
+ * EAGLE_VERBATIM -		1 means the string contains no characters
+ *				that could require quoting; therefore, it
+ *				can be copied as-is, unless it starts with
+ *				a hash character that must be quoted.
  */
 
 #define EAGLE_DONT_USE_BRACES			(1)
 #define EAGLE_USE_BRACES			(2)
 #define EAGLE_BRACES_UNMATCHED			(4)
 #define EAGLE_DONT_QUOTE_HASH			(8)
+#define EAGLE_VERBATIM				(16)
 
 /*
  * NOTE: Win32 API functions required by this file.  These functions are
@@ -123,6 +153,10 @@ extern __declspec(dllimport) SIZE_T __stdcall HeapSize(
 
 extern __declspec(dllimport) BOOL __stdcall HeapFree(
 			    HANDLE, DWORD, LPVOID);
+
+#ifndef HEAP_ZERO_MEMORY
+#define HEAP_ZERO_MEMORY		(0x00000008)
+#endif
 #endif
 
 extern __declspec(dllimport) DWORD __stdcall GetEnvironmentVariableW(
@@ -146,38 +180,309 @@ extern __declspec(dllimport) UINT __stdcall SysStringLen(BSTR);
 #define SysStringLenWrapper(i)		pElementLengths[i]
 #endif
 
+/*
+ * NOTE: When using GCC (or Clang), functions containing AVX2 instructions
+ *       must be marked as such, because the rest of this file is compiled
+ *       for the baseline instruction set.  The AVX2 code is only called if
+ *       the processor supports it (i.e. see EagleGetScanLevel).
+ */
+
+#if defined(USE_AVX2_SCAN) && USE_AVX2_SCAN && \
+    (defined(__GNUC__) || defined(__clang__))
+#define AVX2_TARGET			__attribute__((target("avx2")))
+#else
+#define AVX2_TARGET
+#endif
+
 /*
  * NOTE: How should memory be allocated, freed, etc?
  */
 
-#if defined(_WIN32) && defined(USE_HEAPAPI) && USE_HEAPAPI
-static LPVOID EagleAllocateMemory(SIZE_T size);
+#if (defined(_WIN32) && defined(USE_HEAPAPI) && USE_HEAPAPI) || \
+    (defined(USE_POOL_ALLOCATOR) && USE_POOL_ALLOCATOR)
+static LPVOID EagleAllocateMemory(SIZE_T size, BOOL zero);
 static SIZE_T EagleMemorySize(LPVOID pMemory);
 static VOID EagleFreeMemory(LPVOID pMemory);
 #else
-#define EagleAllocateMemory(size)	AllocateMemoryWrapper((size))
+#define EagleAllocateMemory(size, zero)	((zero) ? \
+					AllocateMemoryWrapper((size)) : \
+					AllocateRawMemoryWrapper((size)))
 #define EagleMemorySize(pMemory)	MemorySizeWrapper((pMemory))
 #define EagleFreeMemory(pMemory)	FreeMemoryWrapper((pMemory))
 #endif
 
+#ifndef _ARENA_DEFINED
+#define _ARENA_DEFINED
+/*
+ * NOTE: This structure is a simple "bump" allocator for per-thread scratch
+ *       memory.  Blocks must be released in the reverse order they were
+ *       obtained.  The union is only used to align the storage.
+ */
+typedef struct _ARENA {
+    SIZE_T used;		/* Number of bytes currently in use. */
+    union {
+	BYTE bytes[LIBRARY_ARENA_SIZE];
+	double alignment;
+	LPVOID pointer;
+    } storage;
+} ARENA, *LPARENA;
+#endif
+
+#if defined(USE_POOL_ALLOCATOR) && USE_POOL_ALLOCATOR
+#ifndef _POOL_HEADER_DEFINED
+#define _POOL_HEADER_DEFINED
+/*
+ * NOTE: This structure precedes every memory block obtained from the pooled
+ *       memory allocator.  For pooled memory blocks, the size is that of
+ *       the size class; otherwise, it is the size originally requested.
+ *       While a memory block is free, its first bytes hold the pointer to
+ *       the next free memory block of the same size class.
+ */
+typedef struct _POOL_HEADER {
+    SIZE_T size;		/* Usable size of the memory block, in bytes. */
+    INT sizeClass;		/* Size class -OR- LIBRARY_POOL_LARGE_CLASS. */
+} POOL_HEADER, *LPPOOL_HEADER;
+#endif
+
+#ifndef _POOL_CACHE_DEFINED
+#define _POOL_CACHE_DEFINED
+/*
+ * NOTE: This structure holds the free memory blocks kept by one thread, or
+ *       by the shared pool, for each size class.
+ */
+typedef struct _POOL_CACHE {
+    LPVOID pFree[LIBRARY_POOL_CLASSES];	/* Free memory block lists. */
+    SIZE_T count[LIBRARY_POOL_CLASSES];	/* Number of free memory blocks. */
+    BOOL registered;		/* Non-zero if flushed upon thread exit. */
+} POOL_CACHE, *LPPOOL_CACHE;
+#endif
+#endif
+
+#if defined(USE_PARALLEL_SPLIT) && USE_PARALLEL_SPLIT
+#ifndef _SPLIT_CHUNK_DEFINED
+#define _SPLIT_CHUNK_DEFINED
+/*
+ * NOTE: This structure describes one chunk of a very large list that is
+ *       split by its own thread.  The start of the chunk is only assumed
+ *       to be the start of an element; this is verified after all of the
+ *       chunks have been split.
+ */
+typedef struct _SPLIT_CHUNK {
+    LPCWSTR pText;		/* The whole list text. */
+    SIZE_T length;		/* Length of the whole list text. */
+    SIZE_T start;		/* Offset where this chunk starts. */
+    SIZE_T limit;		/* Offset where the next chunk starts -OR-
+				 * one past the end of the list text. */
+    LPWSTR pBuffer;		/* Result text for the whole list. */
+    LPSIZE_T pLengths;		/* Element lengths for this chunk. */
+    LPWSTR *ppElements;		/* Element pointers for this chunk. */
+    SIZE_T capacity;		/* Number of element slots available. */
+    SIZE_T count;		/* Number of elements found. */
+    SIZE_T next;		/* Offset where this chunk stopped. */
+    BOOL counting;		/* Non-zero to count whitespace runs only. */
+    BOOL failed;		/* Non-zero if this chunk stopped early. */
+    LPCWSTR pError;		/* Error message, if any. */
+} SPLIT_CHUNK, *LPSPLIT_CHUNK;
+#endif
+
+#ifndef _SPLIT_FIXUP_DEFINED
+#define _SPLIT_FIXUP_DEFINED
+/*
+ * NOTE: This structure holds the elements that had to be split again while
+ *       stitching the chunks of a very large list back together.
+ */
+typedef struct _SPLIT_FIXUP {
+    LPSIZE_T pLengths;		/* Element lengths. */
+    LPWSTR *ppElements;		/* Element pointers. */
+    SIZE_T count;		/* Number of elements. */
+    SIZE_T capacity;		/* Number of element slots available. */
+} SPLIT_FIXUP, *LPSPLIT_FIXUP;
+#endif
+#endif
+
+#ifndef _SORT_CONTEXT_DEFINED
+#define _SORT_CONTEXT_DEFINED
+/*
+ * NOTE: This structure holds the elements of a list being sorted by the
+ *       function Eagle_SortList, along with the options used to compare
+ *       them.  It is shared by all of the sort threads; each thread only
+ *       fills in the keys for its own range of elements.
+ */
+typedef struct _SORT_CONTEXT {
+    SIZE_T elementCount;	/* The number of elements. */
+    LPCSIZE_T pElementLengths;	/* The lengths of the elements. */
+    LPCWSTR *ppElements;	/* The elements to sort. */
+    LPWIDEINT pKeys;		/* The integer value of each element -OR-
+				 * NULL if the elements are compared as
+				 * strings. */
+    BOOL noCase;		/* Non-zero to fold the ASCII letters. */
+    BOOL decreasing;		/* Non-zero to reverse the sort order. */
+} SORT_CONTEXT, *LPSORT_CONTEXT;
+#endif
+
+#ifndef _SORT_TASK_DEFINED
+#define _SORT_TASK_DEFINED
+/*
+ * NOTE: This structure describes one range of element indexes that is
+ *       sorted, or merged, by its own thread.  When sorting, the range
+ *       from start to limit is sorted in place, using the target as the
+ *       scratch space.  When merging, the sorted ranges from start to
+ *       middle and from middle to limit are merged from the source into
+ *       the target.
+ */
+typedef struct _SORT_TASK {
+    LPSORT_CONTEXT pContext;	/* The elements being sorted. */
+    LPSIZE_T pSource;		/* The element indexes to sort or merge. */
+    LPSIZE_T pTarget;		/* The merged element indexes -OR- scratch
+				 * space when sorting. */
+    SIZE_T start;		/* Index where this range starts. */
+    SIZE_T middle;		/* Index where the second half starts. */
+    SIZE_T limit;		/* One past the end of this range. */
+    BOOL merging;		/* Non-zero to merge instead of sort. */
+    LPCWSTR pFormat;		/* Error message format, if any. */
+    SIZE_T errorIndex;		/* The element with the error, if any. */
+} SORT_TASK, *LPSORT_TASK;
+#endif
+
+#ifndef _LIST_ITERATOR_DEFINED
+#define _LIST_ITERATOR_DEFINED
+/*
+ * NOTE: This structure holds the state used by Eagle_ListIterNext.  It is
+ *       opaque to callers of this library.  The buffer is only used for
+ *       elements that contain backslash sequences.
+ */
+struct _LIST_ITERATOR {
+    LPCWSTR pText;		/* The original list text. */
+    LPCWSTR pNext;		/* Start of the remaining list text. */
+    LPCWSTR pEnd;		/* One past the end of the list text. */
+    SIZE_T remaining;		/* Number of characters remaining. */
+    LPWSTR pBuffer;		/* Unescaped text for the current element. */
+    SIZE_T bufferLength;	/* Capacity of the buffer, in characters. */
+};
+#endif
+
+#ifndef _MATCH_PATTERN_DEFINED
+#define _MATCH_PATTERN_DEFINED
+/*
+ * NOTE: This structure holds a glob pattern compiled by the function
+ *       Eagle_CompilePattern.  It is opaque to callers of this library.
+ *       The pattern and literal text are stored immediately after this
+ *       structure, in the same allocation.  When case folding is used,
+ *       both are folded in advance.
+ */
+struct _MATCH_PATTERN {
+    INT flags;			/* The EAGLE_MATCH_* flags. */
+    INT kind;			/* The MATCH_KIND_* value. */
+    SIZE_T length;		/* Length of the pattern, in characters. */
+    LPWSTR pPattern;		/* The pattern text. */
+    SIZE_T literalLength;	/* Length of the literal, in characters. */
+    LPWSTR pLiteral;		/* The pattern text without any asterisks at
+				 * either end and without any backslashes.
+				 * Only used for non-generic patterns. */
+};
+#endif
+
+#ifndef _TOKEN_BUFFER_DEFINED
+#define _TOKEN_BUFFER_DEFINED
 /*
- * NOTE: Private functions defined in this file.
+ * NOTE: This structure holds the tokens found by Eagle_ParseScript.  It is
+ *       shared by a command and all of the commands nested within it.
  */
+typedef struct _TOKEN_BUFFER {
+    LPSCRIPT_TOKEN pTokens;	/* The tokens found so far. */
+    SIZE_T count;		/* Number of tokens. */
+    SIZE_T capacity;		/* Number of token slots available. */
+} TOKEN_BUFFER, *LPTOKEN_BUFFER;
+#endif
 
-#if defined(USE_WCHARSTRTOUSHORTSTR) && USE_WCHARSTRTOUSHORTSTR
-static SIZE_T EagleWcharStrToUshortStr(LPWSTR wstr);
+#ifndef _PARSE_STATE_DEFINED
+#define _PARSE_STATE_DEFINED
+/*
+ * NOTE: This structure holds the state used while parsing a script.  It is
+ *       the same as the managed ParseState class.  Each nested command uses
+ *       its own parse state, with its own line number, just like the managed
+ *       parser.  Its tokens are discarded after it has been parsed.
+ */
+typedef struct _PARSE_STATE {
+    LPCWSTR pText;		/* The whole script text. */
+    SIZE_T length;		/* Length of the script text. */
+    INT flags;			/* The EAGLE_PARSE_* flags. */
+    SIZE_T depth;		/* Nesting level of this command. */
+    SIZE_T currentLine;		/* The current line number. */
+    SIZE_T lineStart;		/* Offset of the last line terminator that
+				 * was counted -OR- invalid. */
+    SIZE_T commentStart;	/* Offset of the comment -OR- invalid. */
+    SIZE_T commentLength;	/* Number of characters in the comment. */
+    SIZE_T commandStart;	/* Offset of the command -OR- invalid. */
+    SIZE_T commandLength;	/* Number of characters in the command. */
+    SIZE_T commandWords;	/* Number of words in the command. */
+    SIZE_T terminator;		/* Offset of the terminating character. */
+    BOOL incomplete;		/* Non-zero if the command is incomplete. */
+    LPTOKEN_BUFFER pBuffer;	/* The shared token buffer. */
+    SIZE_T firstToken;		/* Index of the first token for the command
+				 * being parsed. */
+} PARSE_STATE, *LPPARSE_STATE;
 #endif
 
 /*
- * NOTE: This is the private data for this file.
+ * NOTE: This is the private data for this file.  Since this library may be
+ *       called from multiple threads at the same time, without any locking
+ *       on the part of the caller, the memory accounting and statistics are
+ *       always updated atomically and all scratch memory is per-thread.  A
+ *       snapshot of the statistics is not guaranteed to be consistent.  The
+ *       instruction set level is only written once (i.e. with the same
+ *       value), so the race for it is benign.
  */
 
-static SIZE_T memoryBytesAllocated = 0;
+static volatile SIZE_T memoryBytesAllocated = 0;
+static volatile SIZE_T memoryBytesPeak = 0;
+static volatile SIZE_T memoryAllocationCount = 0;
+static volatile SIZE_T memoryFreeCount = 0;
+static volatile SIZE_T memorySiteAllocations[EAGLE_MEMORY_SITES];
+static volatile SIZE_T memoryHistogram[EAGLE_MEMORY_SITES]
+				      [EAGLE_MEMORY_BUCKETS];
+static INT scanLevel = SCAN_LEVEL_UNKNOWN;
+
+#if defined(USE_THREAD_ARENA) && USE_THREAD_ARENA
+static THREAD_LOCAL ARENA threadArena;
+#endif
 
 #if defined(_WIN32) && defined(USE_HEAPAPI) && USE_HEAPAPI
 static HANDLE hMemoryHeap = NULL;
 #endif
 
+/*
+ * NOTE: The shared pool is protected by its mutex.  The per-thread caches
+ *       are registered with the thread-specific data key only so that they
+ *       can be flushed back into the shared pool when their thread exits.
+ *       In private mode, the shared pool never returns memory blocks back
+ *       to the C runtime library unless it is explicitly compacted.
+ */
+
+#if defined(USE_POOL_ALLOCATOR) && USE_POOL_ALLOCATOR
+static pthread_mutex_t poolMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t poolKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t poolKey;
+static BOOL poolKeyCreated = FALSE;
+static BOOL poolPrivate = FALSE;
+static POOL_CACHE sharedPool;
+static THREAD_LOCAL POOL_CACHE threadPool;
+#endif
+
+/*
+ * NOTE: These are the options used when splitting very large lists.  They
+ *       are loaded from the environment the first time they are needed,
+ *       before any changes made via Eagle_SetSplitOptions.  A threshold of
+ *       zero disables the use of more than one thread.  A thread count of
+ *       zero means one thread per processor.
+ */
+
+#if defined(USE_PARALLEL_SPLIT) && USE_PARALLEL_SPLIT
+static pthread_once_t splitOptionsOnce = PTHREAD_ONCE_INIT;
+static volatile SIZE_T splitThreshold = LIBRARY_SPLIT_THRESHOLD;
+static volatile SIZE_T splitThreadCount = 0;
+#endif
+
 /*
  * NOTE: These are the prototypes of the functions defined in this file.
  */
@@ -188,6 +493,66 @@ static BOOL EagleIsBinDigit(WCHAR c);
 static BOOL EagleIsOctDigit(WCHAR c);
 static BOOL EagleIsDecDigit(WCHAR c);
 static BOOL EagleIsHexDigit(WCHAR c);
+static SIZE_T EagleFindSpecialScalar(LPCWSTR src, SIZE_T length);
+static SIZE_T EagleFindQuoteScalar(LPCWSTR src, SIZE_T length);
+static SIZE_T EagleFindBackslashScalar(LPCWSTR src, SIZE_T length);
+static SIZE_T EagleCountSpaceRunsScalar(LPCWSTR src, SIZE_T length,
+			    BOOL inSpace);
+
+#if defined(USE_SIMD_SCAN) && USE_SIMD_SCAN
+static INT EagleFindFirstBit(UINT mask);
+static INT EagleCountBits(UINT mask);
+#endif
+
+#if defined(USE_SSE2_SCAN) && USE_SSE2_SCAN
+static __m128i EagleSpaceMaskSse2(__m128i chars);
+static __m128i EagleSpecialMaskSse2(__m128i chars);
+static SIZE_T EagleFindSpecialSse2(LPCWSTR src, SIZE_T length);
+static __m128i EagleQuoteMaskSse2(__m128i chars);
+static SIZE_T EagleFindQuoteSse2(LPCWSTR src, SIZE_T length);
+static SIZE_T EagleFindBackslashSse2(LPCWSTR src, SIZE_T length);
+static SIZE_T EagleCountSpaceRunsSse2(LPCWSTR src, SIZE_T length);
+#endif
+
+#if defined(USE_AVX2_SCAN) && USE_AVX2_SCAN
+static BOOL EagleHasAvx2(VOID);
+static AVX2_TARGET __m256i EagleSpaceMaskAvx2(__m256i chars);
+static AVX2_TARGET __m256i EagleSpecialMaskAvx2(__m256i chars);
+static AVX2_TARGET UINT EaglePackMaskAvx2(__m256i lo, __m256i hi);
+static AVX2_TARGET SIZE_T EagleFindSpecialAvx2(LPCWSTR src, SIZE_T length);
+static AVX2_TARGET __m256i EagleQuoteMaskAvx2(__m256i chars);
+static AVX2_TARGET SIZE_T EagleFindQuoteAvx2(LPCWSTR src, SIZE_T length);
+static AVX2_TARGET SIZE_T EagleFindBackslashAvx2(LPCWSTR src,
+			    SIZE_T length);
+static AVX2_TARGET SIZE_T EagleCountSpaceRunsAvx2(LPCWSTR src,
+			    SIZE_T length);
+#endif
+
+#if defined(USE_NEON_SCAN) && USE_NEON_SCAN
+static uint16x8_t EagleSpaceMaskNeon(uint16x8_t chars);
+static uint16x8_t EagleSpecialMaskNeon(uint16x8_t chars);
+static UINT EaglePackMaskNeon(uint16x8_t lo, uint16x8_t hi);
+static SIZE_T EagleFindSpecialNeon(LPCWSTR src, SIZE_T length);
+static uint16x8_t EagleQuoteMaskNeon(uint16x8_t chars);
+static SIZE_T EagleFindQuoteNeon(LPCWSTR src, SIZE_T length);
+static SIZE_T EagleFindBackslashNeon(LPCWSTR src, SIZE_T length);
+static SIZE_T EagleCountSpaceRunsNeon(LPCWSTR src, SIZE_T length);
+#endif
+
+static INT EagleGetScanLevel(VOID);
+static SIZE_T EagleFindSpecial(LPCWSTR src, SIZE_T length);
+static SIZE_T EagleFindQuote(LPCWSTR src, SIZE_T length);
+static SIZE_T EagleFindBackslash(LPCWSTR src, SIZE_T length);
+static SIZE_T EagleCountSpaceRuns(LPCWSTR src, SIZE_T length);
+static LPVOID EagleAllocateScratch(SIZE_T size, INT site);
+static VOID EagleFreeScratch(LPVOID pMemory);
+static INT EagleGetMemoryBucket(SIZE_T size);
+static VOID EagleUpdateMemoryPeak(SIZE_T total);
+static LPVOID EagleAllocateBuffer(SIZE_T size, BOOL zero, INT site);
+static SIZE_T EagleStrLen(LPCWSTR src);
+static SIZE_T EagleFormatString(LPWSTR dst, SIZE_T length, LPCWSTR format,
+			    va_list ap);
+static SIZE_T EagleFormat(LPWSTR dst, SIZE_T length, LPCWSTR format, ...);
 static LPCWSTR EaglePrintf(SIZE_T length, LPCWSTR format, ...);
 static SIZE_T EagleParseBin(LPCWSTR src, SIZE_T numChars,
 			    LPUCSCHAR resultPtr);
@@ -197,6 +562,16 @@ static SIZE_T EagleParseDec(LPCWSTR src, SIZE_T numChars,
 			    LPUCSCHAR resultPtr);
 static SIZE_T EagleParseHex(LPCWSTR src, SIZE_T numChars,
 			    LPUCSCHAR resultPtr);
+static BOOL EagleParseWideInteger(LPCWSTR src, SIZE_T numChars,
+			    LPWIDEINT dst);
+static INT EagleCompareSortElements(LPSORT_CONTEXT pContext,
+			    SIZE_T index1, SIZE_T index2);
+static VOID EagleMergeSortRuns(LPSORT_CONTEXT pContext, LPCSIZE_T pSource,
+			    LPSIZE_T pTarget, SIZE_T start, SIZE_T middle,
+			    SIZE_T limit);
+static VOID EagleSortChunk(LPSORT_TASK pTask);
+static VOID EagleSortTask(LPSORT_TASK pTask);
+static VOID EagleRunSortTasks(LPSORT_TASK pTasks, SIZE_T taskCount);
 static SIZE_T EagleParseBackslash(LPCWSTR src, SIZE_T numChars,
 			    SIZE_T *readPtr, LPWSTR dst);
 static SIZE_T EagleCopyAndCollapse(SIZE_T count, LPCWSTR src, LPWSTR dst);
@@ -207,7 +582,77 @@ static SIZE_T EagleConvertCountedElement(LPCWSTR src, SIZE_T length,
 static RETURNCODE EagleFindElement(LPCWSTR list, SIZE_T listLength,
 			    LPCWSTR *elementPtr, LPCWSTR *nextPtr,
 			    SIZE_T *sizePtr, LPBOOL bracePtr,
-			    LPCWSTR *errorPtr);
+			    LPBOOL literalPtr, LPCWSTR *errorPtr);
+static SIZE_T EagleAppendElement(LPCWSTR src, SIZE_T length,
+			    SIZE_T index, LPWSTR dst);
+static RETURNCODE EagleEditList(SIZE_T length, LPCWSTR pText,
+			    SIZE_T first, SIZE_T count, BOOL keep,
+			    SIZE_T elementCount, LPCSIZE_T pElementLengths,
+			    LPCWSTR *ppElements, LPSIZE_T pLength,
+			    LPCWSTR *ppText, LPCWSTR *ppError);
+static WCHAR EagleFoldCase(WCHAR c);
+static BOOL EagleMatchBracket(LPCWSTR pPattern, SIZE_T patternLength,
+			    LPSIZE_T pIndex, WCHAR c, INT flags);
+static BOOL EagleMatchGeneric(LPCWSTR pText, SIZE_T textLength,
+			    LPCWSTR pPattern, SIZE_T patternLength,
+			    INT flags);
+static BOOL EagleMatchLiteral(LPCWSTR pText, LPCWSTR pLiteral,
+			    SIZE_T length, BOOL noCase);
+static INT EagleClassifyPattern(LPCWSTR pPattern, SIZE_T length,
+			    LPWSTR pLiteral, LPSIZE_T pLiteralLength);
+static BOOL EagleMatchPattern(LPMATCH_PATTERN pPattern, LPCWSTR pText,
+			    SIZE_T textLength);
+static INT EagleGetCharType(WCHAR c, LPBOOL pNextLine);
+static BOOL EagleCountLine(LPPARSE_STATE pState, SIZE_T index);
+static VOID EagleInitToken(LPPARSE_STATE pState, LPSCRIPT_TOKEN pToken);
+static BOOL EagleAddToken(LPPARSE_STATE pState, LPSCRIPT_TOKEN pToken,
+			    LPCWSTR *ppError);
+static SIZE_T EagleParseWhiteSpace(LPPARSE_STATE pState, SIZE_T startIndex,
+			    INT *pCharType);
+static SIZE_T EagleParseComment(LPPARSE_STATE pState, SIZE_T startIndex);
+static RETURNCODE EagleParseBraces(LPPARSE_STATE pState, SIZE_T startIndex,
+			    LPSIZE_T pTerminator, LPCWSTR *ppError);
+static RETURNCODE EagleParseVariableName(LPPARSE_STATE pState,
+			    SIZE_T startIndex, LPCWSTR *ppError);
+static RETURNCODE EagleParseTokens(LPPARSE_STATE pState, SIZE_T startIndex,
+			    INT mask, LPCWSTR *ppError);
+static RETURNCODE EagleParseQuotedString(LPPARSE_STATE pState,
+			    SIZE_T startIndex, LPSIZE_T pTerminator,
+			    LPCWSTR *ppError);
+static RETURNCODE EagleParseCommand(LPPARSE_STATE pState, SIZE_T startIndex,
+			    BOOL nested, LPCWSTR *ppError);
+
+#if defined(USE_POOL_ALLOCATOR) && USE_POOL_ALLOCATOR
+static INT EagleGetPoolClass(SIZE_T size);
+static SIZE_T EagleGetPoolLimit(INT sizeClass, SIZE_T limitSize);
+static VOID EagleCreatePoolKey(VOID);
+static VOID EagleExitPoolThread(LPVOID pData);
+static BOOL EagleRegisterPoolCache(LPPOOL_CACHE pCache);
+static VOID EagleFlushPoolCache(LPPOOL_CACHE pCache, INT sizeClass,
+			    SIZE_T keepCount);
+static SIZE_T EagleReleasePool(VOID);
+static VOID EagleUnloadPool(VOID) __attribute__((destructor));
+#endif
+
+#if defined(USE_PARALLEL_SPLIT) && USE_PARALLEL_SPLIT
+static SIZE_T EagleGetEnvironmentSize(LPCSTR name, SIZE_T defaultValue);
+static VOID EagleLoadSplitOptions(VOID);
+static SIZE_T EagleGetThreadCount(VOID);
+static SIZE_T EagleGetSplitChunkCount(SIZE_T length);
+static SIZE_T EagleFindSplitStart(LPCWSTR pText, SIZE_T length,
+			    SIZE_T offset);
+static VOID EagleSplitChunk(LPSPLIT_CHUNK pChunk);
+static LPVOID EagleSplitChunkThread(LPVOID pData);
+static VOID EagleRunSplitChunks(LPSPLIT_CHUNK pChunks, SIZE_T chunkCount);
+static BOOL EagleAddSplitFixup(LPSPLIT_FIXUP pFixup, SIZE_T elementLength,
+			    LPWSTR pElement);
+static RETURNCODE EagleSplitListParallel(SIZE_T length, LPCWSTR pText,
+			    SIZE_T chunkCount, LPSIZE_T pElementCount,
+			    LPSIZE_T *ppElementLengths,
+			    LPCWSTR **pppElements, LPCWSTR *ppError);
+static SIZE_T EagleGetSortChunkCount(SIZE_T elementCount);
+static LPVOID EagleSortTaskThread(LPVOID pData);
+#endif
 
 #if defined(USE_HEAPAPI) && USE_HEAPAPI
 /*
@@ -230,8 +675,9 @@ static RETURNCODE EagleFindElement(LPCWSTR list, SIZE_T listLength,
 
 static LPVOID
 EagleAllocateMemory(
-    SIZE_T size)	/* The size, in bytes, of the memory block to be
+    SIZE_T size,	/* The size, in bytes, of the memory block to be
 			 * allocated. */
+    BOOL zero)		/* Non-zero if the memory block must be zeroed. */
 {
 #if defined(_WIN32)
     HANDLE hHeap = hMemoryHeap;
@@ -239,11 +685,14 @@ EagleAllocateMemory(
     if (hHeap != NULL) {
 	assert(HeapValidate(hHeap, 0, NULL));
 
-	return HeapAlloc(hHeap, 0, size);
+	return HeapAlloc(hHeap, zero ? HEAP_ZERO_MEMORY : 0, size);
     }
 #endif
 
-    return AllocateMemoryWrapper(size);
+    if (zero)
+	return AllocateMemoryWrapper(size);
+
+    return AllocateRawMemoryWrapper(size);
 }
 
 /*
@@ -325,20 +774,19 @@ EagleFreeMemory(
     return;
 }
 #endif
-
-#if defined(USE_WCHARSTRTOUSHORTSTR) && USE_WCHARSTRTOUSHORTSTR
+
+#if defined(USE_POOL_ALLOCATOR) && USE_POOL_ALLOCATOR
 /*
  *---------------------------------------------------------------------------
  *
- * EagleWcharStrToUshortStr --
+ * EagleGetPoolClass --
  *
- *	This function modifies a WCHAR based string to force the use
- *	of two byte characters.  This is only necessary on platforms
- *	where the wchar_t type is four bytes in size.  The string is
- *	modified in-place.
+ *	This function determines the size class to be used for a memory
+ *	block of the specified size.
  *
  * Results:
- *	The number of characters converted.
+ *	The size class -OR- LIBRARY_POOL_LARGE_CLASS if the memory block
+ *	is too large to be pooled.
  *
  * Side effects:
  *	None.
@@ -346,43 +794,35 @@ EagleFreeMemory(
  *---------------------------------------------------------------------------
  */
 
-static SIZE_T
-EagleWcharStrToUshortStr(
-    LPWSTR wstr)		/* The string to convert. */
+static INT
+EagleGetPoolClass(
+    SIZE_T size)	/* The size, in bytes, of the memory block. */
 {
-    if (wstr != NULL) {
-	SIZE_T i = 0;
-	LPUSHORT sstr = (LPUSHORT)wstr;
+    INT sizeClass = 0;
+    SIZE_T classSize = (SIZE_T)1 << LIBRARY_POOL_MINIMUM_SHIFT;
 
-	assert(sizeof(WCHAR) == 4);
-	assert(sizeof(USHORT) == 2);
+    while (classSize < size) {
+	if (++sizeClass >= LIBRARY_POOL_CLASSES)
+	    return LIBRARY_POOL_LARGE_CLASS;
 
-	while (1) {
-	    assert(wstr[i] >= 0);
-	    assert(wstr[i] <= USHRT_MAX);
-	    sstr[i] = (USHORT)wstr[i];
-	    if (sstr[i] == 0) break;
-	    i++;
-	}
-	return i + 1;
+	classSize <<= 1;
     }
-    return 0;
+
+    return sizeClass;
 }
-#endif
-
+
 /*
  *---------------------------------------------------------------------------
  *
- * EagleTracePrintf --
+ * EagleGetPoolLimit --
  *
- *	This function sends a printf-style formatted trace message to
- *	the connected debugger (Win32), if any -OR- to the standard
- *	error channel.
+ *	This function determines how many free memory blocks of the
+ *	specified size class may be kept within the specified number of
+ *	bytes.
  *
  * Results:
- *	The number of characters written (which may be zero), -1 if
- *	the trace output was truncated, or -2 if trace output was
- *	disabled.
+ *	The maximum number of free memory blocks, which is always at least
+ *	two.
  *
  * Side effects:
  *	None.
@@ -390,1052 +830,7687 @@ EagleWcharStrToUshortStr(
  *---------------------------------------------------------------------------
  */
 
-static INT
-EagleTracePrintf(
-    LPCSTR format,		/* The "printf-style" format string. */
-    ...)			/* The extra arguments, if any. */
+static SIZE_T
+EagleGetPoolLimit(
+    INT sizeClass,	/* The size class of the memory blocks. */
+    SIZE_T limitSize)	/* The number of bytes the memory blocks may use. */
 {
-    va_list argList;
-    CHAR buffer[LIBRARY_TRACE_BUFFER_LENGTH + 1];
-    INT result;
-
-#if defined(_WIN32)
-    {
-	WCHAR envBuffer[LIBRARY_VAR_BUFFER_LENGTH + 1];
-	memset(envBuffer, 0, sizeof(envBuffer));
-	if (GetEnvironmentVariableW( /* NON-PORTABLE */
-		NO_TRACE_UNICODE_VAR_NAME, envBuffer,
-		LIBRARY_VAR_BUFFER_LENGTH)) {
-	    return -2; /* DISABLED */
-	}
-    }
-#else
-    if (getenv(NO_TRACE_VAR_NAME) != NULL) { /* POSIX, MSVC */
-	return -2; /* DISABLED */
-    }
-#endif
-
-    va_start(argList, format);
+    SIZE_T count = limitSize >> (sizeClass + LIBRARY_POOL_MINIMUM_SHIFT);
 
-    memset(buffer, 0, sizeof(buffer));
-
-    result = vsnprintf(buffer,
-	LIBRARY_TRACE_BUFFER_LENGTH, format, argList);
-
-    va_end(argList);
-
-#if defined(_WIN32)
-    OutputDebugStringA(buffer); /* NON-PORTABLE */
-#else
-    fprintf(stderr, "%s", buffer);
-#endif
-
-    return result;
+    return (count > 2) ? count : 2;
 }
-
+
 /*
  *---------------------------------------------------------------------------
  *
- * EagleIsSpace --
+ * EagleCreatePoolKey --
  *
- *	Checks if the specified character is whitespace, i.e. either a space
- *	(0x20), a horizontal tab (0x09), a line feed (0x0a), a vertical tab
- *	(0x0b), a form feed (0x0c), or a carriage return (0x0d).
+ *	This function creates the thread-specific data key used to flush
+ *	the per-thread cache of free memory blocks when a thread exits.
+ *	It is called exactly once, via pthread_once().
  *
  * Results:
- *	Non-zero if the specified character is whitespace, zero otherwise.
+ *	None.
+ *
+ * Side effects:
+ *	None.
  *
  *---------------------------------------------------------------------------
  */
 
-static BOOL
-EagleIsSpace(
-    WCHAR c)		/* The character to check. */
+static VOID
+EagleCreatePoolKey(VOID)
 {
-    switch (c) {
-	case L' ':
-	case L'\f':
-	case L'\n':
-	case L'\r':
-	case L'\t':
-	case L'\v':
-	    return TRUE;
-    }
-    return FALSE;
+    if (pthread_key_create(&poolKey, EagleExitPoolThread) == 0)
+	poolKeyCreated = TRUE;
 }
-
+
 /*
  *---------------------------------------------------------------------------
  *
- * EagleIsBinDigit --
+ * EagleExitPoolThread --
  *
- *	Checks if the specified character is a binary digit.
+ *	This function is called when a thread that has a registered cache
+ *	of free memory blocks exits.  All of its free memory blocks are
+ *	moved into the shared pool.
  *
  * Results:
- *	Non-zero if the specified character is a binary digit, zero
- *	otherwise.
- *
- * Notes:
- *	Relies on the following properties of the ASCII character set, with
- *	which UTF-8/UTF-16 are compatible:
+ *	None.
  *
- *	The digits '0' .. '9' and the letters 'A' .. 'Z' and 'a' .. 'z'
- *	occupy consecutive code points, and '0' < 'A' < 'a'.
+ * Side effects:
+ *	None.
  *
  *---------------------------------------------------------------------------
  */
 
-static BOOL
-EagleIsBinDigit(
-    WCHAR c)		/* The character to check. */
+static VOID
+EagleExitPoolThread(
+    LPVOID pData)	/* The per-thread cache of the exiting thread. */
 {
-    return ((c >= L'0') && (c <= L'1'));
+    LPPOOL_CACHE pCache = (LPPOOL_CACHE)pData;
+    INT sizeClass;
+
+    if (pCache == NULL)
+	return;
+
+    pCache->registered = FALSE;
+
+    for (sizeClass = 0; sizeClass < LIBRARY_POOL_CLASSES; sizeClass++)
+	EagleFlushPoolCache(pCache, sizeClass, 0);
 }
-
+
 /*
  *---------------------------------------------------------------------------
  *
- * EagleIsOctDigit --
+ * EagleRegisterPoolCache --
  *
- *	Checks if the specified character is an octal digit.
+ *	This function makes sure the per-thread cache of free memory blocks
+ *	will be flushed when the current thread exits.  Until that can be
+ *	guaranteed, the per-thread cache must not be used.
  *
  * Results:
- *	Non-zero if the specified character is an octal digit, zero
- *	otherwise.
- *
- * Notes:
- *	Relies on the following properties of the ASCII character set, with
- *	which UTF-8/UTF-16 are compatible:
+ *	Non-zero if the per-thread cache may be used.
  *
- *	The digits '0' .. '9' and the letters 'A' .. 'Z' and 'a' .. 'z'
- *	occupy consecutive code points, and '0' < 'A' < 'a'.
+ * Side effects:
+ *	None.
  *
  *---------------------------------------------------------------------------
  */
 
 static BOOL
-EagleIsOctDigit(
-    WCHAR c)		/* The character to check. */
+EagleRegisterPoolCache(
+    LPPOOL_CACHE pCache)	/* The per-thread cache to register. */
 {
-    return ((c >= L'0') && (c <= L'7'));
+    if (pCache->registered)
+	return TRUE;
+
+    pthread_once(&poolKeyOnce, EagleCreatePoolKey);
+
+    if (!poolKeyCreated || (pthread_setspecific(poolKey, pCache) != 0))
+	return FALSE;
+
+    pCache->registered = TRUE;
+    return TRUE;
 }
-
+
 /*
  *---------------------------------------------------------------------------
  *
- * EagleIsDecDigit --
+ * EagleFlushPoolCache --
  *
- *	Checks if the specified character is a decimal digit.
+ *	This function moves free memory blocks of the specified size class
+ *	from a per-thread cache into the shared pool, until the specified
+ *	number remain.  Unless the shared pool is in private mode, memory
+ *	blocks that do not fit within its limit are freed.
  *
  * Results:
- *	Non-zero if the specified character is a decimal digit, zero
- *	otherwise.
- *
- * Notes:
- *	Relies on the following properties of the ASCII character set, with
- *	which UTF-8/UTF-16 are compatible:
+ *	None.
  *
- *	The digits '0' .. '9' and the letters 'A' .. 'Z' and 'a' .. 'z'
- *	occupy consecutive code points, and '0' < 'A' < 'a'.
+ * Side effects:
+ *	Memory may be freed.
  *
  *---------------------------------------------------------------------------
  */
 
-static BOOL
-EagleIsDecDigit(
-    WCHAR c)		/* The character to check. */
+static VOID
+EagleFlushPoolCache(
+    LPPOOL_CACHE pCache,	/* The per-thread cache to flush. */
+    INT sizeClass,		/* The size class to flush. */
+    SIZE_T keepCount)		/* The number of memory blocks to keep. */
 {
-    return ((c >= L'0') && (c <= L'9'));
+    LPVOID pFree = NULL;
+    SIZE_T limit = EagleGetPoolLimit(sizeClass, LIBRARY_POOL_SHARED_SIZE);
+
+    if (pCache->count[sizeClass] <= keepCount)
+	return;
+
+    pthread_mutex_lock(&poolMutex);
+
+    while (pCache->count[sizeClass] > keepCount) {
+	LPVOID pMemory = pCache->pFree[sizeClass];
+
+	pCache->pFree[sizeClass] = *(LPVOID *)pMemory;
+	pCache->count[sizeClass]--;
+
+	if (poolPrivate || (sharedPool.count[sizeClass] < limit)) {
+	    *(LPVOID *)pMemory = sharedPool.pFree[sizeClass];
+	    sharedPool.pFree[sizeClass] = pMemory;
+	    sharedPool.count[sizeClass]++;
+	} else {
+	    *(LPVOID *)pMemory = pFree;
+	    pFree = pMemory;
+	}
+    }
+
+    pthread_mutex_unlock(&poolMutex);
+
+    /*
+     * NOTE: Free the memory blocks that did not fit into the shared pool
+     *       after releasing the mutex.
+     */
+
+    while (pFree != NULL) {
+	LPVOID pNext = *(LPVOID *)pFree;
+
+	FreeMemoryWrapper((LPBYTE)pFree - LIBRARY_POOL_HEADER_SIZE);
+	pFree = pNext;
+    }
 }
-
+
 /*
  *---------------------------------------------------------------------------
  *
- * EagleIsHexDigit --
+ * EagleReleasePool --
  *
- *	Checks if the specified character is a hexadecimal digit.
+ *	This function frees all free memory blocks kept by the shared pool
+ *	and by the per-thread cache of the current thread.  The per-thread
+ *	caches of other threads are not affected.
  *
  * Results:
- *	Non-zero if the specified character is a hexadecimal digit, zero
- *	otherwise.
+ *	The number of bytes that were freed, not including the headers.
  *
- * Notes:
- *	Relies on the following properties of the ASCII character set, with
- *	which UTF-8/UTF-16 are compatible:
- *
- *	The digits '0' .. '9' and the letters 'A' .. 'Z' and 'a' .. 'z'
- *	occupy consecutive code points, and '0' < 'A' < 'a'.
+ * Side effects:
+ *	Memory may be freed.
  *
  *---------------------------------------------------------------------------
  */
 
-static BOOL
-EagleIsHexDigit(
-    WCHAR c)		/* The character to check. */
+static SIZE_T
+EagleReleasePool(VOID)
 {
-    return (((c >= L'0') && (c <= L'9')) || ((c >= L'A') && (c <= L'F')) ||
-	((c >= L'a') && (c <= L'f')));
+    LPPOOL_CACHE pCache = &threadPool;
+    LPVOID pFree[LIBRARY_POOL_CLASSES];
+    SIZE_T size = 0;
+    INT sizeClass;
+
+    pthread_mutex_lock(&poolMutex);
+
+    for (sizeClass = 0; sizeClass < LIBRARY_POOL_CLASSES; sizeClass++) {
+	pFree[sizeClass] = sharedPool.pFree[sizeClass];
+	sharedPool.pFree[sizeClass] = NULL;
+	sharedPool.count[sizeClass] = 0;
+    }
+
+    pthread_mutex_unlock(&poolMutex);
+
+    for (sizeClass = 0; sizeClass < LIBRARY_POOL_CLASSES; sizeClass++) {
+	SIZE_T classSize = (SIZE_T)1 <<
+	    (sizeClass + LIBRARY_POOL_MINIMUM_SHIFT);
+	LPVOID pMemory = pFree[sizeClass];
+	LPVOID pNext;
+
+	while (pMemory != NULL) {
+	    pNext = *(LPVOID *)pMemory;
+	    FreeMemoryWrapper((LPBYTE)pMemory - LIBRARY_POOL_HEADER_SIZE);
+	    size += classSize;
+	    pMemory = pNext;
+	}
+
+	pMemory = pCache->pFree[sizeClass];
+
+	while (pMemory != NULL) {
+	    pNext = *(LPVOID *)pMemory;
+	    FreeMemoryWrapper((LPBYTE)pMemory - LIBRARY_POOL_HEADER_SIZE);
+	    size += classSize;
+	    pMemory = pNext;
+	}
+
+	pCache->pFree[sizeClass] = NULL;
+	pCache->count[sizeClass] = 0;
+    }
+
+    return size;
 }
-
+
 /*
  *---------------------------------------------------------------------------
  *
- * EaglePrintf --
+ * EagleUnloadPool --
  *
- *	Prints a formatted string into a new memory buffer obtained from
- *	the Eagle_AllocateMemory function.
+ *	This function is called when this library is being unloaded.  It
+ *	deletes the thread-specific data key, so that exiting threads will
+ *	not call into this library after it has been unloaded, and frees all
+ *	the free memory blocks it can.
  *
  * Results:
- *	The newly allocated memory buffer containing the formatted string
- *	-OR- NULL if the necessary memory could not be obtained.
+ *	None.
+ *
+ * Side effects:
+ *	Memory may be freed.
  *
  *---------------------------------------------------------------------------
  */
 
-static LPCWSTR
-EaglePrintf(
-    SIZE_T length,	/* The estimated length of the final string -OR-
-			 * zero if the default length should be used. */
-    LPCWSTR format,	/* The format string for vswprintf(). */
-    ...)		/* The optional list of arguments containing the
-			 * various pieces of data to insert into the result
-			 * string, if any. */
+static VOID
+EagleUnloadPool(VOID)
 {
-    SIZE_T size;
-    LPWSTR z;
-    va_list ap;
-
-    assert(length >= 0);
-    assert(format != NULL);
-
-    if (length == 0) length = LIBRARY_RESULT_LENGTH;
-    size = (length + 1 /* NUL */) * sizeof(WCHAR);
-
-    assert(size > 0);
-    assert(size <= LIBRARY_MAXIMUM_SIZE_T);
-    z = Eagle_AllocateMemory(size);
-    if (z == NULL) return NULL;
-
-    va_start(ap, format);
-    vswprintf(z, size, format, ap);
-    va_end(ap);
+    if (poolKeyCreated) {
+	pthread_key_delete(poolKey);
+	poolKeyCreated = FALSE;
+    }
 
-    return z;
+    EagleReleasePool();
 }
-
+
 /*
  *---------------------------------------------------------------------------
  *
- * EagleParseBin --
+ * EagleAllocateMemory --
  *
- *	Scans a binary number as a character value (e.g., for parsing
- *	\B escape sequences).  At most numChars characters are scanned.
+ *	This function allocates a block of memory of at least the specified
+ *	size.  If possible, a free memory block of the same size class will
+ *	be reused, from the per-thread cache or else from the shared pool.
  *
  * Results:
- *	The numeric value is stored in dst.  Returns the number of
- *	characters consumed.
- *
- * Notes:
- *	Relies on the following properties of the ASCII character set, with
- *	which UTF-8/UTF-16 are compatible:
+ *	The pointer to the new memory block -OR- NULL if the memory could not
+ *	be obtained.
  *
- *	The digits '0' .. '9' and the letters 'A' .. 'Z' and 'a' .. 'z'
- *	occupy consecutive code points, and '0' < 'A' < 'a'.
+ * Side effects:
+ *	None.
  *
  *---------------------------------------------------------------------------
  */
 
-static SIZE_T
-EagleParseBin(
-    LPCWSTR src,		/* First character to parse. */
-    SIZE_T numChars,		/* Max number of characters to scan */
-    LPUCSCHAR dst)		/* Points to storage provided by
-				 * caller where the UCS-2 character
-				 * resulting from the conversion is
-				 * to be written. */
+static LPVOID
+EagleAllocateMemory(
+    SIZE_T size,	/* The size, in bytes, of the memory block to be
+			 * allocated. */
+    BOOL zero)		/* Non-zero if the memory block must be zeroed. */
 {
-    UCSCHAR result = 0;
-    LPCWSTR p = src;
+    LPPOOL_CACHE pCache = &threadPool;
+    INT sizeClass = EagleGetPoolClass(size);
+    LPPOOL_HEADER pHeader;
+    LPVOID pMemory;
 
-    assert(src != NULL);
-    assert(dst != NULL);
+    assert(sizeof(POOL_HEADER) <= LIBRARY_POOL_HEADER_SIZE);
 
-    while (numChars--) {
-	WCHAR digit = *p;
+    if (sizeClass == LIBRARY_POOL_LARGE_CLASS) {
+	if (size > LIBRARY_MAXIMUM_SIZE_T - LIBRARY_POOL_HEADER_SIZE)
+	    return NULL;
 
-	if (!iswbdigit(digit))
-	    break;
+	pHeader = zero ?
+	    AllocateMemoryWrapper(LIBRARY_POOL_HEADER_SIZE + size) :
+	    AllocateRawMemoryWrapper(LIBRARY_POOL_HEADER_SIZE + size);
 
-	p++;
+	if (pHeader == NULL)
+	    return NULL;
 
-	result <<= 1;
-	result |= (digit - L'0');
+	pHeader->size = size;
+	pHeader->sizeClass = LIBRARY_POOL_LARGE_CLASS;
+
+	return (LPBYTE)pHeader + LIBRARY_POOL_HEADER_SIZE;
     }
 
-    *dst = result;
-    return (SIZE_T)(p - src);
+    pMemory = pCache->pFree[sizeClass];
+
+    if (pMemory == NULL) {
+	/*
+	 * NOTE: The per-thread cache is empty.  Refill up to half of it
+	 *       from the shared pool while holding the mutex.
+	 */
+
+	SIZE_T limit = EagleGetPoolLimit(sizeClass,
+	    LIBRARY_POOL_CACHE_SIZE) / 2;
+
+	if (!EagleRegisterPoolCache(pCache))
+	    limit = 0;
+
+	pthread_mutex_lock(&poolMutex);
+
+	pMemory = sharedPool.pFree[sizeClass];
+
+	if (pMemory != NULL) {
+	    sharedPool.pFree[sizeClass] = *(LPVOID *)pMemory;
+	    sharedPool.count[sizeClass]--;
+
+	    while ((pCache->count[sizeClass] < limit) &&
+		    (sharedPool.pFree[sizeClass] != NULL)) {
+		LPVOID pNext = sharedPool.pFree[sizeClass];
+
+		sharedPool.pFree[sizeClass] = *(LPVOID *)pNext;
+		sharedPool.count[sizeClass]--;
+
+		*(LPVOID *)pNext = pCache->pFree[sizeClass];
+		pCache->pFree[sizeClass] = pNext;
+		pCache->count[sizeClass]++;
+	    }
+	}
+
+	pthread_mutex_unlock(&poolMutex);
+    } else {
+	pCache->pFree[sizeClass] = *(LPVOID *)pMemory;
+	pCache->count[sizeClass]--;
+    }
+
+    if (pMemory == NULL) {
+	SIZE_T classSize = (SIZE_T)1 <<
+	    (sizeClass + LIBRARY_POOL_MINIMUM_SHIFT);
+
+	pHeader = AllocateRawMemoryWrapper(
+	    LIBRARY_POOL_HEADER_SIZE + classSize);
+
+	if (pHeader == NULL)
+	    return NULL;
+
+	pHeader->size = classSize;
+	pHeader->sizeClass = sizeClass;
+
+	pMemory = (LPBYTE)pHeader + LIBRARY_POOL_HEADER_SIZE;
+    }
+
+    if (zero)
+	memset(pMemory, 0, size);
+
+    return pMemory;
 }
-
+
 /*
  *---------------------------------------------------------------------------
  *
- * EagleParseOct --
+ * EagleMemorySize --
  *
- *	Scans an octal number as a character value (e.g., for parsing
- *	\o escape sequences).  At most numChars characters are scanned.
+ *	This function returns the size, in bytes, of memory that was
+ *	previously allocated by the EagleAllocateMemory function.  The
+ *	size is read from the header; the C runtime library is not used.
  *
  * Results:
- *	The numeric value is stored in dst.  Returns the number of
- *	characters consumed.
- *
- * Notes:
- *	Relies on the following properties of the ASCII character set, with
- *	which UTF-8/UTF-16 are compatible:
+ *	Size of the memory, in bytes, if any -OR- zero if the size cannot
+ *	be determined.
  *
- *	The digits '0' .. '9' and the letters 'A' .. 'Z' and 'a' .. 'z'
- *	occupy consecutive code points, and '0' < 'A' < 'a'.
+ * Side effects:
+ *	None.
  *
  *---------------------------------------------------------------------------
  */
 
 static SIZE_T
-EagleParseOct(
-    LPCWSTR src,		/* First character to parse. */
-    SIZE_T numChars,		/* Max number of characters to scan */
-    LPUCSCHAR dst)		/* Points to storage provided by
-				 * caller where the UCS-2 character
-				 * resulting from the conversion is
-				 * to be written. */
+EagleMemorySize(
+    LPVOID pMemory)	/* The memory block to query the size of.  This
+			 * memory block must have been obtained from
+			 * EagleAllocateMemory. */
 {
-    UCSCHAR result = 0;
-    LPCWSTR p = src;
-
-    assert(src != NULL);
-    assert(dst != NULL);
-
-    while (numChars--) {
-	WCHAR digit = *p;
-
-	if (!iswodigit(digit))
-	    break;
+    LPPOOL_HEADER pHeader;
 
-	p++;
+    if (pMemory == NULL)
+	return 0;
 
-	result <<= 3;
-	result |= (digit - L'0');
-    }
+    pHeader = (LPPOOL_HEADER)((LPBYTE)pMemory - LIBRARY_POOL_HEADER_SIZE);
 
-    *dst = result;
-    return (SIZE_T)(p - src);
+    return pHeader->size;
 }
-
+
 /*
  *---------------------------------------------------------------------------
  *
- * EagleParseDec --
+ * EagleFreeMemory --
  *
- *	Scans an decimal number as a character value (e.g., for parsing
- *	\d escape sequences).  At most numChars characters are scanned.
+ *	This function frees a block of memory that was previously allocated
+ *	by the EagleAllocateMemory function.  Pooled memory blocks are kept
+ *	in the per-thread cache, which is flushed into the shared pool when
+ *	it becomes full.
  *
  * Results:
- *	The numeric value is stored in dst.  Returns the number of
- *	characters consumed.
- *
- * Notes:
- *	Relies on the following properties of the ASCII character set, with
- *	which UTF-8/UTF-16 are compatible:
+ *	None.
  *
- *	The digits '0' .. '9' and the letters 'A' .. 'Z' and 'a' .. 'z'
- *	occupy consecutive code points, and '0' < 'A' < 'a'.
+ * Side effects:
+ *	Memory may be freed.
  *
  *---------------------------------------------------------------------------
  */
 
-static SIZE_T
-EagleParseDec(
-    LPCWSTR src,		/* First character to parse. */
-    SIZE_T numChars,		/* Max number of characters to scan */
-    LPUCSCHAR dst)		/* Points to storage provided by
-				 * caller where the UCS-2 character
-				 * resulting from the conversion is
-				 * to be written. */
+static VOID
+EagleFreeMemory(
+    LPVOID pMemory)	/* The memory block to free.  This memory block must
+			 * have been obtained from EagleAllocateMemory. */
 {
-    UCSCHAR result = 0;
-    LPCWSTR p = src;
+    LPPOOL_CACHE pCache = &threadPool;
+    LPPOOL_HEADER pHeader;
+    INT sizeClass;
+    SIZE_T limit;
 
-    assert(src != NULL);
-    assert(dst != NULL);
+    if (pMemory == NULL)
+	return;
 
-    while (numChars--) {
-	WCHAR digit = *p;
+    pHeader = (LPPOOL_HEADER)((LPBYTE)pMemory - LIBRARY_POOL_HEADER_SIZE);
+    sizeClass = pHeader->sizeClass;
 
-	if (!iswdigit(digit))
-	    break;
+    if (sizeClass == LIBRARY_POOL_LARGE_CLASS) {
+	FreeMemoryWrapper(pHeader);
+	return;
+    }
 
-	p++;
+    assert((sizeClass >= 0) && (sizeClass < LIBRARY_POOL_CLASSES));
 
-	result *= 10;
-	result += (digit - L'0');
+    *(LPVOID *)pMemory = pCache->pFree[sizeClass];
+    pCache->pFree[sizeClass] = pMemory;
+    pCache->count[sizeClass]++;
+
+    /*
+     * NOTE: When the per-thread cache cannot be flushed upon thread exit,
+     *       it cannot be used; otherwise, flush half of it when full.
+     */
+
+    if (!EagleRegisterPoolCache(pCache)) {
+	EagleFlushPoolCache(pCache, sizeClass, 0);
+	return;
     }
 
-    *dst = result;
-    return (SIZE_T)(p - src);
+    limit = EagleGetPoolLimit(sizeClass, LIBRARY_POOL_CACHE_SIZE);
+
+    if (pCache->count[sizeClass] > limit)
+	EagleFlushPoolCache(pCache, sizeClass, limit / 2);
 }
+#endif
 
+
 /*
  *---------------------------------------------------------------------------
  *
- * EagleParseHex --
+ * EagleTracePrintf --
  *
- *	Scans a hexadecimal number as a character value (e.g., for parsing
- *	\x, \X, \u, and \U escape sequences).  At most numChars characters
- *	are scanned.
+ *	This function sends a printf-style formatted trace message to
+ *	the connected debugger (Win32), if any -OR- to the standard
+ *	error channel.
  *
  * Results:
- *	The numeric value is stored in dst.  Returns the number of
- *	characters consumed.
- *
- * Notes:
- *	Relies on the following properties of the ASCII character set, with
- *	which UTF-8/UTF-16 are compatible:
+ *	The number of characters written (which may be zero), -1 if
+ *	the trace output was truncated, or -2 if trace output was
+ *	disabled.
  *
- *	The digits '0' .. '9' and the letters 'A' .. 'Z' and 'a' .. 'z'
- *	occupy consecutive code points, and '0' < 'A' < 'a'.
+ * Side effects:
+ *	None.
  *
  *---------------------------------------------------------------------------
  */
 
-static SIZE_T
-EagleParseHex(
-    LPCWSTR src,		/* First character to parse. */
-    SIZE_T numChars,		/* Max number of characters to scan */
-    LPUCSCHAR dst)		/* Points to storage provided by
-				 * caller where the UCS-2 character
-				 * resulting from the conversion is
-				 * to be written. */
+static INT
+EagleTracePrintf(
+    LPCSTR format,		/* The "printf-style" format string. */
+    ...)			/* The extra arguments, if any. */
 {
-    UCSCHAR result = 0;
-    LPCWSTR p = src;
+    va_list argList;
+    CHAR buffer[LIBRARY_TRACE_BUFFER_LENGTH + 1];
+    INT result;
 
-    assert(src != NULL);
-    assert(dst != NULL);
+#if defined(_WIN32)
+    {
+	WCHAR envBuffer[LIBRARY_VAR_BUFFER_LENGTH + 1];
+	memset(envBuffer, 0, sizeof(envBuffer));
+	if (GetEnvironmentVariableW( /* NON-PORTABLE */
+		NO_TRACE_UNICODE_VAR_NAME, envBuffer,
+		LIBRARY_VAR_BUFFER_LENGTH)) {
+	    return -2; /* DISABLED */
+	}
+    }
+#else
+    if (getenv(NO_TRACE_VAR_NAME) != NULL) { /* POSIX, MSVC */
+	return -2; /* DISABLED */
+    }
+#endif
 
-    while (numChars--) {
-	WCHAR digit = *p;
+    va_start(argList, format);
 
-	if (!iswxdigit(digit))
-	    break;
+    memset(buffer, 0, sizeof(buffer));
 
-	p++;
-	result <<= 4;
+    result = vsnprintf(buffer,
+	LIBRARY_TRACE_BUFFER_LENGTH, format, argList);
 
-	if (digit >= L'a') {
-	    result |= (10 + digit - L'a');
-	} else if (digit >= L'A') {
-	    result |= (10 + digit - L'A');
-	} else {
-	    result |= (digit - L'0');
-	}
+    va_end(argList);
+
+#if defined(_WIN32)
+    OutputDebugStringA(buffer); /* NON-PORTABLE */
+#else
+    fprintf(stderr, "%s", buffer);
+#endif
+
+    return result;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleIsSpace --
+ *
+ *	Checks if the specified character is whitespace, i.e. either a space
+ *	(0x20), a horizontal tab (0x09), a line feed (0x0a), a vertical tab
+ *	(0x0b), a form feed (0x0c), or a carriage return (0x0d).
+ *
+ * Results:
+ *	Non-zero if the specified character is whitespace, zero otherwise.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static BOOL
+EagleIsSpace(
+    WCHAR c)		/* The character to check. */
+{
+    switch (c) {
+	case L' ':
+	case L'\f':
+	case L'\n':
+	case L'\r':
+	case L'\t':
+	case L'\v':
+	    return TRUE;
     }
+    return FALSE;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleIsBinDigit --
+ *
+ *	Checks if the specified character is a binary digit.
+ *
+ * Results:
+ *	Non-zero if the specified character is a binary digit, zero
+ *	otherwise.
+ *
+ * Notes:
+ *	Relies on the following properties of the ASCII character set, with
+ *	which UTF-8/UTF-16 are compatible:
+ *
+ *	The digits '0' .. '9' and the letters 'A' .. 'Z' and 'a' .. 'z'
+ *	occupy consecutive code points, and '0' < 'A' < 'a'.
+ *
+ *---------------------------------------------------------------------------
+ */
 
-    *dst = result;
-    return (SIZE_T)(p - src);
+static BOOL
+EagleIsBinDigit(
+    WCHAR c)		/* The character to check. */
+{
+    return ((c >= L'0') && (c <= L'1'));
 }
 
 /*
  *---------------------------------------------------------------------------
  *
- * EagleParseBackslash --
+ * EagleIsOctDigit --
  *
- *	Scans up to numChars characters starting at src, consuming a
- *	backslash sequence as defined by Tcl's parsing rules.
+ *	Checks if the specified character is an octal digit.
  *
  * Results:
- *	Records at readPtr the number of bytes making up the backslash
- *	sequence.  Records at dst the UCS-2 encoded equivalent of that
- *	backslash sequence.  Returns the number of "characters" written to
- *	dst, at most 2.  Either readPtr or dst may be NULL, if the results
- *	are not needed, but the return value is the same either way.
+ *	Non-zero if the specified character is an octal digit, zero
+ *	otherwise.
  *
- * Side effects:
- * 	None.
+ * Notes:
+ *	Relies on the following properties of the ASCII character set, with
+ *	which UTF-8/UTF-16 are compatible:
+ *
+ *	The digits '0' .. '9' and the letters 'A' .. 'Z' and 'a' .. 'z'
+ *	occupy consecutive code points, and '0' < 'A' < 'a'.
  *
  *---------------------------------------------------------------------------
  */
 
-static SIZE_T
-EagleParseBackslash(
-    LPCWSTR src,	/* Points to the backslash character of a
-			 * a backslash sequence */
-    SIZE_T numChars,	/* Max number of characters to scan */
-    SIZE_T *readPtr,	/* NULL, or points to storage where the
-			 * number of characters scanned should be
-			 * written. */
-    LPWSTR dst)		/* NULL, or points to buffer where the UTF-16
-			 * encoding of the backslash sequence is to be
-			 * written. */
+static BOOL
+EagleIsOctDigit(
+    WCHAR c)		/* The character to check. */
 {
-    LPCWSTR p = (src + 1);
-    UCSCHAR result;
-    SIZE_T count;
-    BYTE buf[sizeof(UCSCHAR)];
+    return ((c >= L'0') && (c <= L'7'));
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleIsDecDigit --
+ *
+ *	Checks if the specified character is a decimal digit.
+ *
+ * Results:
+ *	Non-zero if the specified character is a decimal digit, zero
+ *	otherwise.
+ *
+ * Notes:
+ *	Relies on the following properties of the ASCII character set, with
+ *	which UTF-8/UTF-16 are compatible:
+ *
+ *	The digits '0' .. '9' and the letters 'A' .. 'Z' and 'a' .. 'z'
+ *	occupy consecutive code points, and '0' < 'A' < 'a'.
+ *
+ *---------------------------------------------------------------------------
+ */
 
-    assert(sizeof(WCHAR) == sizeof(unsigned short));
-    assert(sizeof(UCSCHAR) >= (2 * sizeof(WCHAR)));
-    assert(src != NULL);
-    assert(numChars >= 0);
+static BOOL
+EagleIsDecDigit(
+    WCHAR c)		/* The character to check. */
+{
+    return ((c >= L'0') && (c <= L'9'));
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleIsHexDigit --
+ *
+ *	Checks if the specified character is a hexadecimal digit.
+ *
+ * Results:
+ *	Non-zero if the specified character is a hexadecimal digit, zero
+ *	otherwise.
+ *
+ * Notes:
+ *	Relies on the following properties of the ASCII character set, with
+ *	which UTF-8/UTF-16 are compatible:
+ *
+ *	The digits '0' .. '9' and the letters 'A' .. 'Z' and 'a' .. 'z'
+ *	occupy consecutive code points, and '0' < 'A' < 'a'.
+ *
+ *---------------------------------------------------------------------------
+ */
 
-    /*
-     * If no characters can be consumed, do nothing and return zero.
-     */
+static BOOL
+EagleIsHexDigit(
+    WCHAR c)		/* The character to check. */
+{
+    return (((c >= L'0') && (c <= L'9')) || ((c >= L'A') && (c <= L'F')) ||
+	((c >= L'a') && (c <= L'f')));
+}
+
+#if defined(USE_SIMD_SCAN) && USE_SIMD_SCAN
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleFindFirstBit --
+ *
+ *	Finds the index of the least significant bit that is set in the
+ *	specified (non-zero) mask.
+ *
+ * Results:
+ *	The zero-based index of the least significant bit that is set.
+ *
+ *---------------------------------------------------------------------------
+ */
 
-    if (numChars == 0) {
-	if (readPtr != NULL) {
-	    *readPtr = 0;
-	}
-	return 0;
-    }
+static INT
+EagleFindFirstBit(
+    UINT mask)		/* The mask to check, must be non-zero. */
+{
+    assert(mask != 0);
 
-    if (dst == NULL) {
-	memset(buf, 0, sizeof(buf));
-	dst = (LPWSTR)buf;
+#if defined(_MSC_VER)
+    {
+	unsigned long index;
+
+	_BitScanForward(&index, mask);
+	return (INT)index;
     }
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    {
+	INT index = 0;
 
-    if (numChars == 1) {
-	/* Can only scan the backslash.  Return it. */
-	result = L'\\';
-	count = 1;
-	goto done;
+	while ((mask & 1) == 0) {
+	    mask >>= 1;
+	    index++;
+	}
+	return index;
     }
+#endif
+}
 
-    count = 2;
-    switch (*p) {
-	case L'\0':
-	    result = L'\\';
-	    count = 1;
-	    break;
-	case L'a':
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleCountBits --
+ *
+ *	Counts the number of bits that are set in the specified mask.
+ *
+ * Results:
+ *	The number of bits that are set.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static INT
+EagleCountBits(
+    UINT mask)		/* The mask to count the set bits of. */
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcount(mask);
+#else
+    mask = mask - ((mask >> 1) & 0x55555555);
+    mask = (mask & 0x33333333) + ((mask >> 2) & 0x33333333);
+    mask = (mask + (mask >> 4)) & 0x0F0F0F0F;
+    return (INT)((mask * 0x01010101) >> 24);
+#endif
+}
+#endif
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleFindSpecialScalar --
+ *
+ *	Scans up to length characters starting at src, looking for the first
+ *	character that may change the state of the list element parser, i.e.
+ *	whitespace, an open or close brace, a double-quote, or a backslash.
+ *	This is the portable (non-vector) implementation.
+ *
+ * Results:
+ *	The number of characters that precede the first such character -OR-
+ *	length if there is no such character.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleFindSpecialScalar(
+    LPCWSTR src,	/* The first character to check. */
+    SIZE_T length)	/* The number of characters to check. */
+{
+    SIZE_T index;
+
+    assert(src != NULL);
+    assert(length >= 0);
+
+    for (index = 0; index < length; index++) {
+	switch (src[index]) {
+	    case L'{':
+	    case L'}':
+	    case L'"':
+	    case L'\\':
+	    case L' ':
+	    case L'\f':
+	    case L'\n':
+	    case L'\r':
+	    case L'\t':
+	    case L'\v':
+		return index;
+	}
+    }
+    return length;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleFindQuoteScalar --
+ *
+ *	Scans up to length characters starting at src, looking for the first
+ *	character that may require a list element to be quoted, i.e. any of
+ *	those checked by EagleFindSpecialScalar, an open or close bracket, a
+ *	dollar sign, or a semicolon.  This is the portable (non-vector)
+ *	implementation.
+ *
+ * Results:
+ *	The number of characters that precede the first such character -OR-
+ *	length if there is no such character.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleFindQuoteScalar(
+    LPCWSTR src,	/* The first character to check. */
+    SIZE_T length)	/* The number of characters to check. */
+{
+    SIZE_T index;
+
+    assert(src != NULL);
+    assert(length >= 0);
+
+    for (index = 0; index < length; index++) {
+	switch (src[index]) {
+	    case L'{':
+	    case L'}':
+	    case L'[':
+	    case L']':
+	    case L'$':
+	    case L';':
+	    case L'"':
+	    case L'\\':
+	    case L' ':
+	    case L'\f':
+	    case L'\n':
+	    case L'\r':
+	    case L'\t':
+	    case L'\v':
+		return index;
+	}
+    }
+    return length;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleFindBackslashScalar --
+ *
+ *	Scans up to length characters starting at src, looking for the first
+ *	backslash.  This is the portable (non-vector) implementation.
+ *
+ * Results:
+ *	The number of characters that precede the first backslash -OR-
+ *	length if there is no backslash.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleFindBackslashScalar(
+    LPCWSTR src,	/* The first character to check. */
+    SIZE_T length)	/* The number of characters to check. */
+{
+    SIZE_T index;
+
+    assert(src != NULL);
+    assert(length >= 0);
+
+    for (index = 0; index < length; index++) {
+	if (src[index] == L'\\')
+	    return index;
+    }
+    return length;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleCountSpaceRunsScalar --
+ *
+ *	Counts the number of runs of consecutive whitespace characters in the
+ *	length characters starting at src.  A run that continues from before
+ *	src is not counted again.  This is the portable (non-vector)
+ *	implementation.
+ *
+ * Results:
+ *	The number of whitespace runs that start within the characters.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleCountSpaceRunsScalar(
+    LPCWSTR src,	/* The first character to check. */
+    SIZE_T length,	/* The number of characters to check. */
+    BOOL inSpace)	/* Non-zero if the character just before src is
+			 * whitespace. */
+{
+    SIZE_T index, count = 0;
+
+    assert(src != NULL);
+    assert(length >= 0);
+
+    for (index = 0; index < length; index++) {
+	if (iswspace(src[index])) { /* INTL: ISO space. */
+	    if (!inSpace) {
+		count++;
+		inSpace = TRUE;
+	    }
+	} else {
+	    inSpace = FALSE;
+	}
+    }
+    return count;
+}
+
+#if defined(USE_SSE2_SCAN) && USE_SSE2_SCAN
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleSpaceMaskSse2 --
+ *
+ *	Classifies eight characters at once, checking for whitespace.
+ *
+ * Results:
+ *	A vector with all bits set in the lanes holding whitespace.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static __m128i
+EagleSpaceMaskSse2(
+    __m128i chars)	/* The eight characters to classify. */
+{
+    /*
+     * NOTE: The horizontal tab, line feed, vertical tab, form feed, and
+     *       carriage return characters are contiguous (0x09 to 0x0D);
+     *       therefore, a single (unsigned) range check handles them.
+     */
+
+    __m128i ranged = _mm_subs_epu16(
+	_mm_sub_epi16(chars, _mm_set1_epi16(L'\t')), _mm_set1_epi16(4));
+
+    return _mm_or_si128(
+	_mm_cmpeq_epi16(chars, _mm_set1_epi16(L' ')),
+	_mm_cmpeq_epi16(ranged, _mm_setzero_si128()));
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleSpecialMaskSse2 --
+ *
+ *	Classifies eight characters at once, checking for whitespace, braces,
+ *	double-quotes, and backslashes.
+ *
+ * Results:
+ *	A vector with all bits set in the lanes holding those characters.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static __m128i
+EagleSpecialMaskSse2(
+    __m128i chars)	/* The eight characters to classify. */
+{
+    __m128i mask = EagleSpaceMaskSse2(chars);
+
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi16(chars, _mm_set1_epi16(L'{')));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi16(chars, _mm_set1_epi16(L'}')));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi16(chars, _mm_set1_epi16(L'"')));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi16(chars, _mm_set1_epi16(L'\\')));
+
+    return mask;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleFindSpecialSse2 --
+ *
+ *	This is the SSE2 implementation of EagleFindSpecialScalar.  It checks
+ *	sixteen characters per iteration.
+ *
+ * Results:
+ *	See EagleFindSpecialScalar.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleFindSpecialSse2(
+    LPCWSTR src,	/* The first character to check. */
+    SIZE_T length)	/* The number of characters to check. */
+{
+    SIZE_T index = 0;
+
+    for (; (index + 16) <= length; index += 16) {
+	__m128i lo = _mm_loadu_si128((const __m128i *)(src + index));
+	__m128i hi = _mm_loadu_si128((const __m128i *)(src + index + 8));
+	UINT mask = (UINT)_mm_movemask_epi8(_mm_packs_epi16(
+	    EagleSpecialMaskSse2(lo), EagleSpecialMaskSse2(hi)));
+
+	if (mask != 0)
+	    return index + EagleFindFirstBit(mask);
+    }
+
+    return index + EagleFindSpecialScalar(src + index, length - index);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleQuoteMaskSse2 --
+ *
+ *	Classifies eight characters at once, checking for all the characters
+ *	that may require a list element to be quoted.
+ *
+ * Results:
+ *	A vector with all bits set in the lanes holding those characters.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static __m128i
+EagleQuoteMaskSse2(
+    __m128i chars)	/* The eight characters to classify. */
+{
+    __m128i mask = EagleSpecialMaskSse2(chars);
+
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi16(chars, _mm_set1_epi16(L'[')));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi16(chars, _mm_set1_epi16(L']')));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi16(chars, _mm_set1_epi16(L'$')));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi16(chars, _mm_set1_epi16(L';')));
+
+    return mask;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleFindQuoteSse2 --
+ *
+ *	This is the SSE2 implementation of EagleFindQuoteScalar.  It checks
+ *	sixteen characters per iteration.
+ *
+ * Results:
+ *	See EagleFindQuoteScalar.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleFindQuoteSse2(
+    LPCWSTR src,	/* The first character to check. */
+    SIZE_T length)	/* The number of characters to check. */
+{
+    SIZE_T index = 0;
+
+    for (; (index + 16) <= length; index += 16) {
+	__m128i lo = _mm_loadu_si128((const __m128i *)(src + index));
+	__m128i hi = _mm_loadu_si128((const __m128i *)(src + index + 8));
+	UINT mask = (UINT)_mm_movemask_epi8(_mm_packs_epi16(
+	    EagleQuoteMaskSse2(lo), EagleQuoteMaskSse2(hi)));
+
+	if (mask != 0)
+	    return index + EagleFindFirstBit(mask);
+    }
+
+    return index + EagleFindQuoteScalar(src + index, length - index);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleFindBackslashSse2 --
+ *
+ *	This is the SSE2 implementation of EagleFindBackslashScalar.  It
+ *	checks sixteen characters per iteration.
+ *
+ * Results:
+ *	See EagleFindBackslashScalar.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleFindBackslashSse2(
+    LPCWSTR src,	/* The first character to check. */
+    SIZE_T length)	/* The number of characters to check. */
+{
+    __m128i backslash = _mm_set1_epi16(L'\\');
+    SIZE_T index = 0;
+
+    for (; (index + 16) <= length; index += 16) {
+	__m128i lo = _mm_loadu_si128((const __m128i *)(src + index));
+	__m128i hi = _mm_loadu_si128((const __m128i *)(src + index + 8));
+	UINT mask = (UINT)_mm_movemask_epi8(_mm_packs_epi16(
+	    _mm_cmpeq_epi16(lo, backslash), _mm_cmpeq_epi16(hi, backslash)));
+
+	if (mask != 0)
+	    return index + EagleFindFirstBit(mask);
+    }
+
+    return index + EagleFindBackslashScalar(src + index, length - index);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleCountSpaceRunsSse2 --
+ *
+ *	This is the SSE2 implementation of EagleCountSpaceRunsScalar.  It
+ *	checks sixteen characters per iteration.
+ *
+ * Results:
+ *	See EagleCountSpaceRunsScalar.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleCountSpaceRunsSse2(
+    LPCWSTR src,	/* The first character to check. */
+    SIZE_T length)	/* The number of characters to check. */
+{
+    SIZE_T index = 0, count = 0;
+    UINT carry = 0;
+
+    for (; (index + 16) <= length; index += 16) {
+	__m128i lo = _mm_loadu_si128((const __m128i *)(src + index));
+	__m128i hi = _mm_loadu_si128((const __m128i *)(src + index + 8));
+	UINT mask = (UINT)_mm_movemask_epi8(_mm_packs_epi16(
+	    EagleSpaceMaskSse2(lo), EagleSpaceMaskSse2(hi)));
+
+	/*
+	 * NOTE: A run starts at each whitespace character that is not
+	 *       preceded by another whitespace character.
+	 */
+
+	count += EagleCountBits(mask & ~((mask << 1) | carry));
+	carry = (mask >> 15) & 1;
+    }
+
+    return count + EagleCountSpaceRunsScalar(
+	src + index, length - index, (BOOL)carry);
+}
+#endif
+
+#if defined(USE_AVX2_SCAN) && USE_AVX2_SCAN
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleHasAvx2 --
+ *
+ *	Checks if the processor and operating system both support the AVX2
+ *	instruction set.
+ *
+ * Results:
+ *	Non-zero if AVX2 instructions may be used, zero otherwise.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static BOOL
+EagleHasAvx2(VOID)
+{
+#if defined(_MSC_VER)
+    int info[4];
+
+    __cpuid(info, 0);
+    if (info[0] < 7) return FALSE;
+
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0) return FALSE; /* OSXSAVE */
+    if ((info[2] & (1 << 28)) == 0) return FALSE; /* AVX */
+    if ((_xgetbv(0) & 0x6) != 0x6) return FALSE; /* XMM/YMM state */
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0; /* AVX2 */
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? TRUE : FALSE;
+#endif
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleSpaceMaskAvx2 --
+ *
+ *	Classifies sixteen characters at once, checking for whitespace.
+ *
+ * Results:
+ *	A vector with all bits set in the lanes holding whitespace.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static AVX2_TARGET __m256i
+EagleSpaceMaskAvx2(
+    __m256i chars)	/* The sixteen characters to classify. */
+{
+    __m256i ranged = _mm256_subs_epu16(
+	_mm256_sub_epi16(chars, _mm256_set1_epi16(L'\t')),
+	_mm256_set1_epi16(4));
+
+    return _mm256_or_si256(
+	_mm256_cmpeq_epi16(chars, _mm256_set1_epi16(L' ')),
+	_mm256_cmpeq_epi16(ranged, _mm256_setzero_si256()));
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleSpecialMaskAvx2 --
+ *
+ *	Classifies sixteen characters at once, checking for whitespace,
+ *	braces, double-quotes, and backslashes.
+ *
+ * Results:
+ *	A vector with all bits set in the lanes holding those characters.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static AVX2_TARGET __m256i
+EagleSpecialMaskAvx2(
+    __m256i chars)	/* The sixteen characters to classify. */
+{
+    __m256i mask = EagleSpaceMaskAvx2(chars);
+
+    mask = _mm256_or_si256(mask,
+	_mm256_cmpeq_epi16(chars, _mm256_set1_epi16(L'{')));
+    mask = _mm256_or_si256(mask,
+	_mm256_cmpeq_epi16(chars, _mm256_set1_epi16(L'}')));
+    mask = _mm256_or_si256(mask,
+	_mm256_cmpeq_epi16(chars, _mm256_set1_epi16(L'"')));
+    mask = _mm256_or_si256(mask,
+	_mm256_cmpeq_epi16(chars, _mm256_set1_epi16(L'\\')));
+
+    return mask;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EaglePackMaskAvx2 --
+ *
+ *	Combines two sixteen lane masks into one bit per lane, in order.
+ *
+ * Results:
+ *	A thirty-two bit mask, with one bit per character.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static AVX2_TARGET UINT
+EaglePackMaskAvx2(
+    __m256i lo,		/* The mask for the first sixteen characters. */
+    __m256i hi)		/* The mask for the next sixteen characters. */
+{
+    /*
+     * NOTE: The pack instruction works within each 128-bit half; the
+     *       permutation puts the 64-bit quarters back in order.
+     */
+
+    return (UINT)_mm256_movemask_epi8(_mm256_permute4x64_epi64(
+	_mm256_packs_epi16(lo, hi), 0xD8));
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleFindSpecialAvx2 --
+ *
+ *	This is the AVX2 implementation of EagleFindSpecialScalar.  It checks
+ *	thirty-two characters per iteration.
+ *
+ * Results:
+ *	See EagleFindSpecialScalar.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static AVX2_TARGET SIZE_T
+EagleFindSpecialAvx2(
+    LPCWSTR src,	/* The first character to check. */
+    SIZE_T length)	/* The number of characters to check. */
+{
+    SIZE_T index = 0;
+
+    for (; (index + 32) <= length; index += 32) {
+	__m256i lo = _mm256_loadu_si256((const __m256i *)(src + index));
+	__m256i hi = _mm256_loadu_si256((const __m256i *)(src + index + 16));
+	UINT mask = EaglePackMaskAvx2(
+	    EagleSpecialMaskAvx2(lo), EagleSpecialMaskAvx2(hi));
+
+	if (mask != 0)
+	    return index + EagleFindFirstBit(mask);
+    }
+
+    return index + EagleFindSpecialSse2(src + index, length - index);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleQuoteMaskAvx2 --
+ *
+ *	Classifies sixteen characters at once, checking for all the characters
+ *	that may require a list element to be quoted.
+ *
+ * Results:
+ *	A vector with all bits set in the lanes holding those characters.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static AVX2_TARGET __m256i
+EagleQuoteMaskAvx2(
+    __m256i chars)	/* The sixteen characters to classify. */
+{
+    __m256i mask = EagleSpecialMaskAvx2(chars);
+
+    mask = _mm256_or_si256(mask,
+	_mm256_cmpeq_epi16(chars, _mm256_set1_epi16(L'[')));
+    mask = _mm256_or_si256(mask,
+	_mm256_cmpeq_epi16(chars, _mm256_set1_epi16(L']')));
+    mask = _mm256_or_si256(mask,
+	_mm256_cmpeq_epi16(chars, _mm256_set1_epi16(L'$')));
+    mask = _mm256_or_si256(mask,
+	_mm256_cmpeq_epi16(chars, _mm256_set1_epi16(L';')));
+
+    return mask;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleFindQuoteAvx2 --
+ *
+ *	This is the AVX2 implementation of EagleFindQuoteScalar.  It checks
+ *	thirty-two characters per iteration.
+ *
+ * Results:
+ *	See EagleFindQuoteScalar.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static AVX2_TARGET SIZE_T
+EagleFindQuoteAvx2(
+    LPCWSTR src,	/* The first character to check. */
+    SIZE_T length)	/* The number of characters to check. */
+{
+    SIZE_T index = 0;
+
+    for (; (index + 32) <= length; index += 32) {
+	__m256i lo = _mm256_loadu_si256((const __m256i *)(src + index));
+	__m256i hi = _mm256_loadu_si256((const __m256i *)(src + index + 16));
+	UINT mask = EaglePackMaskAvx2(
+	    EagleQuoteMaskAvx2(lo), EagleQuoteMaskAvx2(hi));
+
+	if (mask != 0)
+	    return index + EagleFindFirstBit(mask);
+    }
+
+    return index + EagleFindQuoteSse2(src + index, length - index);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleFindBackslashAvx2 --
+ *
+ *	This is the AVX2 implementation of EagleFindBackslashScalar.  It
+ *	checks thirty-two characters per iteration.
+ *
+ * Results:
+ *	See EagleFindBackslashScalar.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static AVX2_TARGET SIZE_T
+EagleFindBackslashAvx2(
+    LPCWSTR src,	/* The first character to check. */
+    SIZE_T length)	/* The number of characters to check. */
+{
+    __m256i backslash = _mm256_set1_epi16(L'\\');
+    SIZE_T index = 0;
+
+    for (; (index + 32) <= length; index += 32) {
+	__m256i lo = _mm256_loadu_si256((const __m256i *)(src + index));
+	__m256i hi = _mm256_loadu_si256((const __m256i *)(src + index + 16));
+	UINT mask = EaglePackMaskAvx2(_mm256_cmpeq_epi16(lo, backslash),
+	    _mm256_cmpeq_epi16(hi, backslash));
+
+	if (mask != 0)
+	    return index + EagleFindFirstBit(mask);
+    }
+
+    return index + EagleFindBackslashSse2(src + index, length - index);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleCountSpaceRunsAvx2 --
+ *
+ *	This is the AVX2 implementation of EagleCountSpaceRunsScalar.  It
+ *	checks thirty-two characters per iteration.
+ *
+ * Results:
+ *	See EagleCountSpaceRunsScalar.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static AVX2_TARGET SIZE_T
+EagleCountSpaceRunsAvx2(
+    LPCWSTR src,	/* The first character to check. */
+    SIZE_T length)	/* The number of characters to check. */
+{
+    SIZE_T index = 0, count = 0;
+    UINT carry = 0;
+
+    for (; (index + 32) <= length; index += 32) {
+	__m256i lo = _mm256_loadu_si256((const __m256i *)(src + index));
+	__m256i hi = _mm256_loadu_si256((const __m256i *)(src + index + 16));
+	UINT mask = EaglePackMaskAvx2(
+	    EagleSpaceMaskAvx2(lo), EagleSpaceMaskAvx2(hi));
+
+	count += EagleCountBits(mask & ~((mask << 1) | carry));
+	carry = (mask >> 31) & 1;
+    }
+
+    return count + EagleCountSpaceRunsScalar(
+	src + index, length - index, (BOOL)carry);
+}
+#endif
+
+#if defined(USE_NEON_SCAN) && USE_NEON_SCAN
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleSpaceMaskNeon --
+ *
+ *	Classifies eight characters at once, checking for whitespace.
+ *
+ * Results:
+ *	A vector with all bits set in the lanes holding whitespace.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static uint16x8_t
+EagleSpaceMaskNeon(
+    uint16x8_t chars)	/* The eight characters to classify. */
+{
+    return vorrq_u16(
+	vceqq_u16(chars, vdupq_n_u16(L' ')),
+	vcleq_u16(vsubq_u16(chars, vdupq_n_u16(L'\t')), vdupq_n_u16(4)));
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleSpecialMaskNeon --
+ *
+ *	Classifies eight characters at once, checking for whitespace, braces,
+ *	double-quotes, and backslashes.
+ *
+ * Results:
+ *	A vector with all bits set in the lanes holding those characters.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static uint16x8_t
+EagleSpecialMaskNeon(
+    uint16x8_t chars)	/* The eight characters to classify. */
+{
+    uint16x8_t mask = EagleSpaceMaskNeon(chars);
+
+    mask = vorrq_u16(mask, vceqq_u16(chars, vdupq_n_u16(L'{')));
+    mask = vorrq_u16(mask, vceqq_u16(chars, vdupq_n_u16(L'}')));
+    mask = vorrq_u16(mask, vceqq_u16(chars, vdupq_n_u16(L'"')));
+    mask = vorrq_u16(mask, vceqq_u16(chars, vdupq_n_u16(L'\\')));
+
+    return mask;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EaglePackMaskNeon --
+ *
+ *	Combines two eight lane masks into one bit per lane, in order.  This
+ *	emulates the "movemask" instruction, which NEON lacks.
+ *
+ * Results:
+ *	A sixteen bit mask, with one bit per character.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static UINT
+EaglePackMaskNeon(
+    uint16x8_t lo,	/* The mask for the first eight characters. */
+    uint16x8_t hi)	/* The mask for the next eight characters. */
+{
+    static const uint8_t weights[16] = {
+	1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128
+    };
+
+    uint8x16_t bits = vandq_u8(
+	vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)), vld1q_u8(weights));
+
+    return (UINT)vaddv_u8(vget_low_u8(bits)) |
+	((UINT)vaddv_u8(vget_high_u8(bits)) << 8);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleFindSpecialNeon --
+ *
+ *	This is the NEON implementation of EagleFindSpecialScalar.  It checks
+ *	sixteen characters per iteration.
+ *
+ * Results:
+ *	See EagleFindSpecialScalar.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleFindSpecialNeon(
+    LPCWSTR src,	/* The first character to check. */
+    SIZE_T length)	/* The number of characters to check. */
+{
+    SIZE_T index = 0;
+
+    for (; (index + 16) <= length; index += 16) {
+	uint16x8_t lo = vld1q_u16((const uint16_t *)(src + index));
+	uint16x8_t hi = vld1q_u16((const uint16_t *)(src + index + 8));
+	uint16x8_t any = vorrq_u16(
+	    EagleSpecialMaskNeon(lo), EagleSpecialMaskNeon(hi));
+
+	/*
+	 * NOTE: Most blocks contain nothing of interest; therefore, only
+	 *       build the precise mask when something was found.
+	 */
+
+	if (vmaxvq_u16(any) != 0) {
+	    return index + EagleFindFirstBit(EaglePackMaskNeon(
+		EagleSpecialMaskNeon(lo), EagleSpecialMaskNeon(hi)));
+	}
+    }
+
+    return index + EagleFindSpecialScalar(src + index, length - index);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleQuoteMaskNeon --
+ *
+ *	Classifies eight characters at once, checking for all the characters
+ *	that may require a list element to be quoted.
+ *
+ * Results:
+ *	A vector with all bits set in the lanes holding those characters.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static uint16x8_t
+EagleQuoteMaskNeon(
+    uint16x8_t chars)	/* The eight characters to classify. */
+{
+    uint16x8_t mask = EagleSpecialMaskNeon(chars);
+
+    mask = vorrq_u16(mask, vceqq_u16(chars, vdupq_n_u16(L'[')));
+    mask = vorrq_u16(mask, vceqq_u16(chars, vdupq_n_u16(L']')));
+    mask = vorrq_u16(mask, vceqq_u16(chars, vdupq_n_u16(L'$')));
+    mask = vorrq_u16(mask, vceqq_u16(chars, vdupq_n_u16(L';')));
+
+    return mask;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleFindQuoteNeon --
+ *
+ *	This is the NEON implementation of EagleFindQuoteScalar.  It checks
+ *	sixteen characters per iteration.
+ *
+ * Results:
+ *	See EagleFindQuoteScalar.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleFindQuoteNeon(
+    LPCWSTR src,	/* The first character to check. */
+    SIZE_T length)	/* The number of characters to check. */
+{
+    SIZE_T index = 0;
+
+    for (; (index + 16) <= length; index += 16) {
+	uint16x8_t lo = vld1q_u16((const uint16_t *)(src + index));
+	uint16x8_t hi = vld1q_u16((const uint16_t *)(src + index + 8));
+	uint16x8_t any = vorrq_u16(
+	    EagleQuoteMaskNeon(lo), EagleQuoteMaskNeon(hi));
+
+	if (vmaxvq_u16(any) != 0) {
+	    return index + EagleFindFirstBit(EaglePackMaskNeon(
+		EagleQuoteMaskNeon(lo), EagleQuoteMaskNeon(hi)));
+	}
+    }
+
+    return index + EagleFindQuoteScalar(src + index, length - index);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleFindBackslashNeon --
+ *
+ *	This is the NEON implementation of EagleFindBackslashScalar.  It
+ *	checks sixteen characters per iteration.
+ *
+ * Results:
+ *	See EagleFindBackslashScalar.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleFindBackslashNeon(
+    LPCWSTR src,	/* The first character to check. */
+    SIZE_T length)	/* The number of characters to check. */
+{
+    uint16x8_t backslash = vdupq_n_u16(L'\\');
+    SIZE_T index = 0;
+
+    for (; (index + 16) <= length; index += 16) {
+	uint16x8_t lo = vceqq_u16(
+	    vld1q_u16((const uint16_t *)(src + index)), backslash);
+	uint16x8_t hi = vceqq_u16(
+	    vld1q_u16((const uint16_t *)(src + index + 8)), backslash);
+
+	if (vmaxvq_u16(vorrq_u16(lo, hi)) != 0)
+	    return index + EagleFindFirstBit(EaglePackMaskNeon(lo, hi));
+    }
+
+    return index + EagleFindBackslashScalar(src + index, length - index);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleCountSpaceRunsNeon --
+ *
+ *	This is the NEON implementation of EagleCountSpaceRunsScalar.  It
+ *	checks sixteen characters per iteration.
+ *
+ * Results:
+ *	See EagleCountSpaceRunsScalar.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleCountSpaceRunsNeon(
+    LPCWSTR src,	/* The first character to check. */
+    SIZE_T length)	/* The number of characters to check. */
+{
+    SIZE_T index = 0, count = 0;
+    UINT carry = 0;
+
+    for (; (index + 16) <= length; index += 16) {
+	uint16x8_t lo = vld1q_u16((const uint16_t *)(src + index));
+	uint16x8_t hi = vld1q_u16((const uint16_t *)(src + index + 8));
+	UINT mask = EaglePackMaskNeon(
+	    EagleSpaceMaskNeon(lo), EagleSpaceMaskNeon(hi));
+
+	count += EagleCountBits(mask & ~((mask << 1) | carry));
+	carry = (mask >> 15) & 1;
+    }
+
+    return count + EagleCountSpaceRunsScalar(
+	src + index, length - index, (BOOL)carry);
+}
+#endif
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleGetScanLevel --
+ *
+ *	Determines which instruction set should be used to scan list text.
+ *	The processor is only checked the first time this function is called.
+ *	Setting the "NoSimdSpilornis" environment variable forces the use of
+ *	the portable (non-vector) code.
+ *
+ * Results:
+ *	One of the SCAN_LEVEL_* values, never SCAN_LEVEL_UNKNOWN.
+ *
+ * Side effects:
+ *	The detected level is saved for use by subsequent calls.  There is no
+ *	need for locking here, because every thread computes the same value.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static INT
+EagleGetScanLevel(VOID)
+{
+    INT level = scanLevel;
+
+    if (level != SCAN_LEVEL_UNKNOWN)
+	return level;
+
+    level = SCAN_LEVEL_SCALAR;
+
+#if defined(USE_SIMD_SCAN) && USE_SIMD_SCAN
+#if defined(_WIN32)
+    {
+	WCHAR envBuffer[LIBRARY_VAR_BUFFER_LENGTH + 1];
+	memset(envBuffer, 0, sizeof(envBuffer));
+	if (GetEnvironmentVariableW( /* NON-PORTABLE */
+		NO_SIMD_UNICODE_VAR_NAME, envBuffer,
+		LIBRARY_VAR_BUFFER_LENGTH)) {
+	    goto done;
+	}
+    }
+#else
+    if (getenv(NO_SIMD_VAR_NAME) != NULL) { /* POSIX, MSVC */
+	goto done;
+    }
+#endif
+
+#if defined(USE_SSE2_SCAN) && USE_SSE2_SCAN
+    level = SCAN_LEVEL_SSE2;
+#endif
+
+#if defined(USE_AVX2_SCAN) && USE_AVX2_SCAN
+    if (EagleHasAvx2())
+	level = SCAN_LEVEL_AVX2;
+#endif
+
+#if defined(USE_NEON_SCAN) && USE_NEON_SCAN
+    level = SCAN_LEVEL_NEON;
+#endif
+
+done:
+#endif
+
+    scanLevel = level;
+    return level;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleFindSpecial --
+ *
+ *	Scans up to length characters starting at src, looking for the first
+ *	character that may change the state of the list element parser, i.e.
+ *	whitespace, an open or close brace, a double-quote, or a backslash.
+ *	The fastest instruction set supported by the processor is used.
+ *
+ * Results:
+ *	The number of characters that precede the first such character -OR-
+ *	length if there is no such character.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleFindSpecial(
+    LPCWSTR src,	/* The first character to check. */
+    SIZE_T length)	/* The number of characters to check. */
+{
+    switch (EagleGetScanLevel()) {
+#if defined(USE_AVX2_SCAN) && USE_AVX2_SCAN
+	case SCAN_LEVEL_AVX2:
+	    return EagleFindSpecialAvx2(src, length);
+#endif
+#if defined(USE_SSE2_SCAN) && USE_SSE2_SCAN
+	case SCAN_LEVEL_SSE2:
+	    return EagleFindSpecialSse2(src, length);
+#endif
+#if defined(USE_NEON_SCAN) && USE_NEON_SCAN
+	case SCAN_LEVEL_NEON:
+	    return EagleFindSpecialNeon(src, length);
+#endif
+    }
+    return EagleFindSpecialScalar(src, length);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleFindQuote --
+ *
+ *	Scans up to length characters starting at src, looking for the first
+ *	character that may require a list element to be quoted.  The fastest
+ *	instruction set supported by the processor is used.
+ *
+ * Results:
+ *	The number of characters that precede the first such character -OR-
+ *	length if there is no such character.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleFindQuote(
+    LPCWSTR src,	/* The first character to check. */
+    SIZE_T length)	/* The number of characters to check. */
+{
+    switch (EagleGetScanLevel()) {
+#if defined(USE_AVX2_SCAN) && USE_AVX2_SCAN
+	case SCAN_LEVEL_AVX2:
+	    return EagleFindQuoteAvx2(src, length);
+#endif
+#if defined(USE_SSE2_SCAN) && USE_SSE2_SCAN
+	case SCAN_LEVEL_SSE2:
+	    return EagleFindQuoteSse2(src, length);
+#endif
+#if defined(USE_NEON_SCAN) && USE_NEON_SCAN
+	case SCAN_LEVEL_NEON:
+	    return EagleFindQuoteNeon(src, length);
+#endif
+    }
+    return EagleFindQuoteScalar(src, length);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleFindBackslash --
+ *
+ *	Scans up to length characters starting at src, looking for the first
+ *	backslash.  The fastest instruction set supported by the processor is
+ *	used.
+ *
+ * Results:
+ *	The number of characters that precede the first backslash -OR-
+ *	length if there is no backslash.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleFindBackslash(
+    LPCWSTR src,	/* The first character to check. */
+    SIZE_T length)	/* The number of characters to check. */
+{
+    switch (EagleGetScanLevel()) {
+#if defined(USE_AVX2_SCAN) && USE_AVX2_SCAN
+	case SCAN_LEVEL_AVX2:
+	    return EagleFindBackslashAvx2(src, length);
+#endif
+#if defined(USE_SSE2_SCAN) && USE_SSE2_SCAN
+	case SCAN_LEVEL_SSE2:
+	    return EagleFindBackslashSse2(src, length);
+#endif
+#if defined(USE_NEON_SCAN) && USE_NEON_SCAN
+	case SCAN_LEVEL_NEON:
+	    return EagleFindBackslashNeon(src, length);
+#endif
+    }
+    return EagleFindBackslashScalar(src, length);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleCountSpaceRuns --
+ *
+ *	Counts the number of runs of consecutive whitespace characters in the
+ *	length characters starting at src.  The fastest instruction set
+ *	supported by the processor is used.
+ *
+ * Results:
+ *	The number of whitespace runs.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleCountSpaceRuns(
+    LPCWSTR src,	/* The first character to check. */
+    SIZE_T length)	/* The number of characters to check. */
+{
+    switch (EagleGetScanLevel()) {
+#if defined(USE_AVX2_SCAN) && USE_AVX2_SCAN
+	case SCAN_LEVEL_AVX2:
+	    return EagleCountSpaceRunsAvx2(src, length);
+#endif
+#if defined(USE_SSE2_SCAN) && USE_SSE2_SCAN
+	case SCAN_LEVEL_SSE2:
+	    return EagleCountSpaceRunsSse2(src, length);
+#endif
+#if defined(USE_NEON_SCAN) && USE_NEON_SCAN
+	case SCAN_LEVEL_NEON:
+	    return EagleCountSpaceRunsNeon(src, length);
+#endif
+    }
+    return EagleCountSpaceRunsScalar(src, length, FALSE);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleAllocateScratch --
+ *
+ *	Allocates a block of scratch memory that is only used for the
+ *	duration of one call into this library.  If possible, the memory
+ *	is taken from the per-thread arena; otherwise, it is allocated
+ *	from the heap.  Blocks taken from the arena must be released in
+ *	the reverse order they were obtained.  The memory is not zeroed.
+ *
+ * Results:
+ *	The pointer to the new memory block -OR- NULL if the memory could
+ *	not be obtained.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static LPVOID
+EagleAllocateScratch(
+    SIZE_T size,		/* The size, in bytes, of the scratch memory
+				 * block to be allocated. */
+    INT site)			/* The call site to record if the memory
+				 * must be allocated from the heap. */
+{
+#if defined(USE_THREAD_ARENA) && USE_THREAD_ARENA
+    LPARENA pArena = &threadArena;
+    SIZE_T alignedSize = (size + sizeof(double) - 1) &
+	~(SIZE_T)(sizeof(double) - 1);
+
+    assert(size > 0);
+
+    if ((alignedSize >= size) &&
+	    (alignedSize <= LIBRARY_ARENA_SIZE - pArena->used)) {
+	LPVOID pMemory = &pArena->storage.bytes[pArena->used];
+
+	pArena->used += alignedSize;
+	return pMemory;
+    }
+#endif
+
+    return EagleAllocateBuffer(size, FALSE, site);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleFreeScratch --
+ *
+ *	Frees a block of scratch memory that was previously allocated by
+ *	the EagleAllocateScratch function.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static VOID
+EagleFreeScratch(
+    LPVOID pMemory)		/* The scratch memory block to free. */
+{
+#if defined(USE_THREAD_ARENA) && USE_THREAD_ARENA
+    LPARENA pArena = &threadArena;
+    LPBYTE pBytes = (LPBYTE)pMemory;
+
+    if ((pBytes >= pArena->storage.bytes) &&
+	    (pBytes < pArena->storage.bytes + LIBRARY_ARENA_SIZE)) {
+	SIZE_T offset = (SIZE_T)(pBytes - pArena->storage.bytes);
+
+	assert(offset < pArena->used);
+	pArena->used = offset;
+	return;
+    }
+#endif
+
+    Eagle_FreeMemory(pMemory);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleStrLen --
+ *
+ *	Counts the characters in a NUL terminated WCHAR string.  This is
+ *	used instead of wcslen() because the WCHAR type may not be the
+ *	same as the wchar_t type.
+ *
+ * Results:
+ *	The number of characters, not including the terminating NUL.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleStrLen(
+    LPCWSTR src)		/* The NUL terminated string. */
+{
+    LPCWSTR p = src;
+
+    assert(src != NULL);
+
+    while (*p != 0) {
+	p++;
+    }
+    return (SIZE_T)(p - src);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleFormatString --
+ *
+ *	Formats a string into the specified buffer.  This is used instead
+ *	of vswprintf() because the WCHAR type may not be the same as the
+ *	wchar_t type.  Only the conversions actually used by this library
+ *	are supported: "%%", "%d", "%zu", "%ls", and "%.*ls".  The "%zu"
+ *	conversion takes a SIZE_T argument, which may be wider than an
+ *	INT.  Any other conversion is copied verbatim.
+ *
+ * Results:
+ *	The number of characters written, not including the terminating
+ *	NUL.  The output is always NUL terminated and is silently
+ *	truncated if the buffer is too small.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleFormatString(
+    LPWSTR dst,			/* The output buffer. */
+    SIZE_T length,		/* The size of the output buffer, in
+				 * characters, including the NUL. */
+    LPCWSTR format,		/* The format string. */
+    va_list ap)			/* The list of arguments. */
+{
+    SIZE_T count = 0;
+    LPCWSTR p = format;
+
+    assert(dst != NULL);
+    assert(length > 0);
+    assert(format != NULL);
+
+    while ((*p != 0) && (count + 1 < length)) {
+	if ((p[0] == L'%') && (p[1] == L'%')) {
+	    dst[count++] = L'%';
+	    p += 2;
+	} else if ((p[0] == L'%') && (p[1] == L'd')) {
+	    WCHAR digits[LIBRARY_INTEGER_BUFFER_LENGTH];
+	    INT value = va_arg(ap, INT);
+	    unsigned int magnitude;
+	    SIZE_T numDigits = 0;
+
+	    if (value < 0) {
+		dst[count++] = L'-';
+		magnitude = 0U - (unsigned int)value;
+	    } else {
+		magnitude = (unsigned int)value;
+	    }
+	    do {
+		digits[numDigits++] = (WCHAR)(L'0' + (magnitude % 10));
+		magnitude /= 10;
+	    } while (magnitude != 0);
+	    while ((numDigits > 0) && (count + 1 < length)) {
+		dst[count++] = digits[--numDigits];
+	    }
+	    p += 2;
+	} else if ((p[0] == L'%') && (p[1] == L'z') && (p[2] == L'u')) {
+	    WCHAR digits[LIBRARY_INTEGER_BUFFER_LENGTH];
+	    UWIDEINT magnitude = (UWIDEINT)va_arg(ap, SIZE_T);
+	    SIZE_T numDigits = 0;
+
+	    do {
+		digits[numDigits++] = (WCHAR)(L'0' + (magnitude % 10));
+		magnitude /= 10;
+	    } while (magnitude != 0);
+	    while ((numDigits > 0) && (count + 1 < length)) {
+		dst[count++] = digits[--numDigits];
+	    }
+	    p += 3;
+	} else if ((p[0] == L'%') && (p[1] == L'l') && (p[2] == L's')) {
+	    LPCWSTR arg = va_arg(ap, LPCWSTR);
+
+	    if (arg != NULL) {
+		while ((*arg != 0) && (count + 1 < length)) {
+		    dst[count++] = *arg++;
+		}
+	    }
+	    p += 3;
+	} else if ((p[0] == L'%') && (p[1] == L'.') && (p[2] == L'*') &&
+		(p[3] == L'l') && (p[4] == L's')) {
+	    INT precision = va_arg(ap, INT);
+	    LPCWSTR arg = va_arg(ap, LPCWSTR);
+
+	    if (arg != NULL) {
+		while ((precision-- > 0) && (*arg != 0) &&
+			(count + 1 < length)) {
+		    dst[count++] = *arg++;
+		}
+	    }
+	    p += 5;
+	} else {
+	    dst[count++] = *p++;
+	}
+    }
+
+    dst[count] = 0;
+    return count;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleFormat --
+ *
+ *	Formats a string into the specified buffer.  This is a wrapper
+ *	around EagleFormatString that accepts a variable number of
+ *	arguments.
+ *
+ * Results:
+ *	See EagleFormatString.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleFormat(
+    LPWSTR dst,			/* The output buffer. */
+    SIZE_T length,		/* The size of the output buffer, in
+				 * characters, including the NUL. */
+    LPCWSTR format,		/* The format string. */
+    ...)			/* The optional list of arguments. */
+{
+    SIZE_T result;
+    va_list ap;
+
+    va_start(ap, format);
+    result = EagleFormatString(dst, length, format, ap);
+    va_end(ap);
+
+    return result;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EaglePrintf --
+ *
+ *	Prints a formatted string into a new memory buffer obtained from
+ *	the Eagle_AllocateMemory function.
+ *
+ * Results:
+ *	The newly allocated memory buffer containing the formatted string
+ *	-OR- NULL if the necessary memory could not be obtained.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static LPCWSTR
+EaglePrintf(
+    SIZE_T length,	/* The estimated length of the final string -OR-
+			 * zero if the default length should be used. */
+    LPCWSTR format,	/* The format string for EagleFormatString(). */
+    ...)		/* The optional list of arguments containing the
+			 * various pieces of data to insert into the result
+			 * string, if any. */
+{
+    SIZE_T size;
+    LPWSTR z;
+    va_list ap;
+
+    assert(length >= 0);
+    assert(format != NULL);
+
+    if (length == 0) length = LIBRARY_RESULT_LENGTH;
+    size = (length + 1 /* NUL */) * sizeof(WCHAR);
+
+    assert(size > 0);
+    assert(size <= LIBRARY_MAXIMUM_SIZE_T);
+    z = EagleAllocateBuffer(size, TRUE, EAGLE_MEMORY_SITE_PRINTF);
+    if (z == NULL) return NULL;
+
+    va_start(ap, format);
+    EagleFormatString(z, length + 1 /* NUL */, format, ap);
+    va_end(ap);
+
+    return z;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleParseBin --
+ *
+ *	Scans a binary number as a character value (e.g., for parsing
+ *	\B escape sequences).  At most numChars characters are scanned.
+ *
+ * Results:
+ *	The numeric value is stored in dst.  Returns the number of
+ *	characters consumed.
+ *
+ * Notes:
+ *	Relies on the following properties of the ASCII character set, with
+ *	which UTF-8/UTF-16 are compatible:
+ *
+ *	The digits '0' .. '9' and the letters 'A' .. 'Z' and 'a' .. 'z'
+ *	occupy consecutive code points, and '0' < 'A' < 'a'.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleParseBin(
+    LPCWSTR src,		/* First character to parse. */
+    SIZE_T numChars,		/* Max number of characters to scan */
+    LPUCSCHAR dst)		/* Points to storage provided by
+				 * caller where the UCS-2 character
+				 * resulting from the conversion is
+				 * to be written. */
+{
+    UCSCHAR result = 0;
+    LPCWSTR p = src;
+
+    assert(src != NULL);
+    assert(dst != NULL);
+
+    while (numChars--) {
+	WCHAR digit = *p;
+
+	if (!iswbdigit(digit))
+	    break;
+
+	p++;
+
+	result <<= 1;
+	result |= (digit - L'0');
+    }
+
+    *dst = result;
+    return (SIZE_T)(p - src);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleParseOct --
+ *
+ *	Scans an octal number as a character value (e.g., for parsing
+ *	\o escape sequences).  At most numChars characters are scanned.
+ *
+ * Results:
+ *	The numeric value is stored in dst.  Returns the number of
+ *	characters consumed.
+ *
+ * Notes:
+ *	Relies on the following properties of the ASCII character set, with
+ *	which UTF-8/UTF-16 are compatible:
+ *
+ *	The digits '0' .. '9' and the letters 'A' .. 'Z' and 'a' .. 'z'
+ *	occupy consecutive code points, and '0' < 'A' < 'a'.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleParseOct(
+    LPCWSTR src,		/* First character to parse. */
+    SIZE_T numChars,		/* Max number of characters to scan */
+    LPUCSCHAR dst)		/* Points to storage provided by
+				 * caller where the UCS-2 character
+				 * resulting from the conversion is
+				 * to be written. */
+{
+    UCSCHAR result = 0;
+    LPCWSTR p = src;
+
+    assert(src != NULL);
+    assert(dst != NULL);
+
+    while (numChars--) {
+	WCHAR digit = *p;
+
+	if (!iswodigit(digit))
+	    break;
+
+	p++;
+
+	result <<= 3;
+	result |= (digit - L'0');
+    }
+
+    *dst = result;
+    return (SIZE_T)(p - src);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleParseDec --
+ *
+ *	Scans an decimal number as a character value (e.g., for parsing
+ *	\d escape sequences).  At most numChars characters are scanned.
+ *
+ * Results:
+ *	The numeric value is stored in dst.  Returns the number of
+ *	characters consumed.
+ *
+ * Notes:
+ *	Relies on the following properties of the ASCII character set, with
+ *	which UTF-8/UTF-16 are compatible:
+ *
+ *	The digits '0' .. '9' and the letters 'A' .. 'Z' and 'a' .. 'z'
+ *	occupy consecutive code points, and '0' < 'A' < 'a'.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleParseDec(
+    LPCWSTR src,		/* First character to parse. */
+    SIZE_T numChars,		/* Max number of characters to scan */
+    LPUCSCHAR dst)		/* Points to storage provided by
+				 * caller where the UCS-2 character
+				 * resulting from the conversion is
+				 * to be written. */
+{
+    UCSCHAR result = 0;
+    LPCWSTR p = src;
+
+    assert(src != NULL);
+    assert(dst != NULL);
+
+    while (numChars--) {
+	WCHAR digit = *p;
+
+	if (!iswdigit(digit))
+	    break;
+
+	p++;
+
+	result *= 10;
+	result += (digit - L'0');
+    }
+
+    *dst = result;
+    return (SIZE_T)(p - src);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleParseHex --
+ *
+ *	Scans a hexadecimal number as a character value (e.g., for parsing
+ *	\x, \X, \u, and \U escape sequences).  At most numChars characters
+ *	are scanned.
+ *
+ * Results:
+ *	The numeric value is stored in dst.  Returns the number of
+ *	characters consumed.
+ *
+ * Notes:
+ *	Relies on the following properties of the ASCII character set, with
+ *	which UTF-8/UTF-16 are compatible:
+ *
+ *	The digits '0' .. '9' and the letters 'A' .. 'Z' and 'a' .. 'z'
+ *	occupy consecutive code points, and '0' < 'A' < 'a'.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleParseHex(
+    LPCWSTR src,		/* First character to parse. */
+    SIZE_T numChars,		/* Max number of characters to scan */
+    LPUCSCHAR dst)		/* Points to storage provided by
+				 * caller where the UCS-2 character
+				 * resulting from the conversion is
+				 * to be written. */
+{
+    UCSCHAR result = 0;
+    LPCWSTR p = src;
+
+    assert(src != NULL);
+    assert(dst != NULL);
+
+    while (numChars--) {
+	WCHAR digit = *p;
+
+	if (!iswxdigit(digit))
+	    break;
+
+	p++;
+	result <<= 4;
+
+	if (digit >= L'a') {
+	    result |= (10 + digit - L'a');
+	} else if (digit >= L'A') {
+	    result |= (10 + digit - L'A');
+	} else {
+	    result |= (digit - L'0');
+	}
+    }
+
+    *dst = result;
+    return (SIZE_T)(p - src);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleParseWideInteger --
+ *
+ *	Scans exactly numChars characters as a wide integer, using the same
+ *	rules as the managed Value.GetWideInteger2 method with the default
+ *	value flags: an optional sign, followed by either decimal digits or
+ *	one of the 0b, 0o, 0d, or 0x radix prefixes and digits of that radix.
+ *	Decimal numbers without a prefix must fit within a wide integer; the
+ *	ones with a prefix are allowed to wrap around, like they do for the
+ *	managed Parser.ParseHexadecimal method, et al.
+ *
+ * Results:
+ *	Non-zero if the characters were a valid wide integer, in which case
+ *	the value is stored in dst.  Anything else, including white space,
+ *	is rejected; the caller is expected to let the managed code deal
+ *	with such values, e.g. to produce the appropriate error message.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static BOOL
+EagleParseWideInteger(
+    LPCWSTR src,		/* First character to parse. */
+    SIZE_T numChars,		/* Number of characters to parse. */
+    LPWIDEINT dst)		/* Points to storage provided by caller
+				 * where the resulting value is to be
+				 * written. */
+{
+    LPCWSTR p = src;
+    LPCWSTR limit = src + numChars;
+    UWIDEINT value = 0;
+    BOOL negative = FALSE;
+    int radix = 0;
+
+    assert(src != NULL);
+    assert(dst != NULL);
+
+    if ((p < limit) && ((*p == L'+') || (*p == L'-'))) {
+	negative = (*p == L'-');
+	p++;
+    }
+
+    if (((limit - p) >= 2) && (p[0] == L'0')) {
+	switch (p[1]) {
+	    case L'b': case L'B': radix = 2; break;
+	    case L'o': case L'O': radix = 8; break;
+	    case L'd': case L'D': radix = 10; break;
+	    case L'x': case L'X': radix = 16; break;
+	}
+    }
+
+    if (radix != 0) {
+	/*
+	 * NOTE: An empty number after the prefix is zero, just like it is
+	 *       for the managed code.
+	 */
+	for (p += 2; p < limit; p++) {
+	    WCHAR digit = *p;
+	    int digitValue;
+
+	    if ((radix == 2) && iswbdigit(digit)) {
+		digitValue = digit - L'0';
+	    } else if ((radix == 8) && iswodigit(digit)) {
+		digitValue = digit - L'0';
+	    } else if ((radix == 10) && iswdigit(digit)) {
+		digitValue = digit - L'0';
+	    } else if ((radix == 16) && iswxdigit(digit)) {
+		if (digit >= L'a') {
+		    digitValue = 10 + digit - L'a';
+		} else if (digit >= L'A') {
+		    digitValue = 10 + digit - L'A';
+		} else {
+		    digitValue = digit - L'0';
+		}
+	    } else {
+		return FALSE;
+	    }
+
+	    value = (value * radix) + digitValue;
+	}
+
+	if (negative && (value == ((UWIDEINT)1 << 63))) {
+	    return FALSE;
+	}
+    } else {
+	UWIDEINT maximum = ((UWIDEINT)1 << 63) - (negative ? 0 : 1);
+
+	if (p == limit) {
+	    return FALSE;
+	}
+
+	for (; p < limit; p++) {
+	    WCHAR digit = *p;
+	    int digitValue;
+
+	    if (!iswdigit(digit)) {
+		return FALSE;
+	    }
+
+	    digitValue = digit - L'0';
+
+	    if (value > ((maximum - digitValue) / 10)) {
+		return FALSE;
+	    }
+
+	    value = (value * 10) + digitValue;
+	}
+    }
+
+    *dst = (WIDEINT)(negative ? (0 - value) : value);
+    return TRUE;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleParseBackslash --
+ *
+ *	Scans up to numChars characters starting at src, consuming a
+ *	backslash sequence as defined by Tcl's parsing rules.
+ *
+ * Results:
+ *	Records at readPtr the number of bytes making up the backslash
+ *	sequence.  Records at dst the UCS-2 encoded equivalent of that
+ *	backslash sequence.  Returns the number of "characters" written to
+ *	dst, at most 2.  Either readPtr or dst may be NULL, if the results
+ *	are not needed, but the return value is the same either way.
+ *
+ * Side effects:
+ * 	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleParseBackslash(
+    LPCWSTR src,	/* Points to the backslash character of a
+			 * a backslash sequence */
+    SIZE_T numChars,	/* Max number of characters to scan */
+    SIZE_T *readPtr,	/* NULL, or points to storage where the
+			 * number of characters scanned should be
+			 * written. */
+    LPWSTR dst)		/* NULL, or points to buffer where the UTF-16
+			 * encoding of the backslash sequence is to be
+			 * written. */
+{
+    LPCWSTR p = (src + 1);
+    UCSCHAR result;
+    SIZE_T count;
+    BYTE buf[sizeof(UCSCHAR)];
+
+    assert(sizeof(WCHAR) == sizeof(unsigned short));
+    assert(sizeof(UCSCHAR) >= (2 * sizeof(WCHAR)));
+    assert(src != NULL);
+    assert(numChars >= 0);
+
+    /*
+     * If no characters can be consumed, do nothing and return zero.
+     */
+
+    if (numChars == 0) {
+	if (readPtr != NULL) {
+	    *readPtr = 0;
+	}
+	return 0;
+    }
+
+    if (dst == NULL) {
+	memset(buf, 0, sizeof(buf));
+	dst = (LPWSTR)buf;
+    }
+
+    if (numChars == 1) {
+	/* Can only scan the backslash.  Return it. */
+	result = L'\\';
+	count = 1;
+	goto done;
+    }
+
+    count = 2;
+    switch (*p) {
+	case L'\0':
+	    result = L'\\';
+	    count = 1;
+	    break;
+	case L'a':
 	    result = L'\a';
 	    break;
-	case L'b':
-	    result = L'\b';
+	case L'b':
+	    result = L'\b';
+	    break;
+	case L'f':
+	    result = L'\f';
+	    break;
+	case L'n':
+	    result = L'\n';
+	    break;
+	case L'r':
+	    result = L'\r';
+	    break;
+	case L't':
+	    result = L'\t';
+	    break;
+	case L'v':
+	    result = L'\v';
+	    break;
+	case L'\\': /* COMPAT: Eagle only. */
+	    result = L'\\';
+	    break;
+	case L'B':  /* COMPAT: Eagle only. */
+	    count += EagleParseBin(p + 1, numChars - 2, &result);
+	    if (count == 2) {
+		/* No digits -> This is just "B". */
+		result = L'B';
+	    } else {
+		/* Keep only the last byte (8 bin digits) */
+		result = (BYTE)result;
+	    }
+	    break;
+	case L'o': /* COMPAT: Eagle only. */
+	    count += EagleParseOct(p + 1, numChars - 2, &result);
+	    if (count == 2) {
+		/* No digits -> This is just "o". */
+		result = L'o';
+	    } else {
+		/* Keep only the last byte (3 oct digits) */
+		result = (BYTE)result;
+	    }
+	    break;
+	case L'd': /* COMPAT: Eagle only. */
+	    count += EagleParseDec(p + 1, numChars - 2, &result);
+	    if (count == 2) {
+		/* No digits -> This is just "d". */
+		result = L'd';
+	    } else {
+		/* Keep only the last byte (~3 dec digits) */
+		result = (BYTE)result;
+	    }
+	    break;
+	case L'x':
+	    count += EagleParseHex(p + 1, numChars - 2, &result);
+	    if (count == 2) {
+		/* No digits -> This is just "x". */
+		result = L'x';
+	    } else {
+		/* Keep only the last byte (2 hex digits) */
+		result = (BYTE)result;
+	    }
+	    break;
+	case L'X': /* COMPAT: Eagle only. */
+	    count += EagleParseHex(p + 1, numChars - 2, &result);
+	    if (count == 2) {
+		/* No digits -> This is just "X". */
+		result = L'X';
+	    }
+	    break;
+	case L'u':
+	    count += EagleParseHex(
+		    p + 1, (numChars > 5) ? 4 : numChars - 2, &result);
+	    if (count == 2) {
+		/* No digits -> This is just "u". */
+		result = L'u';
+	    }
+	    break;
+	case L'U': /* COMPAT: Tcl only. */
+	    count += EagleParseHex(
+		    p + 1, (numChars > 9) ? 8 : numChars - 2, &result);
+	    if (count == 2) {
+		/* No digits -> This is just "U". */
+		result = L'U';
+	    }
+	    break;
+	case L'\n':
+	    count--;
+	    do {
+		p++; count++;
+	    } while ((count < numChars) && ((*p == L' ') || (*p == L'\t')));
+	    result = L' ';
+	    break;
+	default:
+	    /*
+	     * Check for an octal number \oo?o?
+	     */
+	    if (iswdigit(*p) && (*p < L'8')) { /* INTL: digit */
+		result = (WCHAR)(*p - L'0');
+		p++;
+		if ((numChars == 2) || !iswdigit(*p) /* INTL: digit */
+			|| (*p >= L'8')) {
+		    break;
+		}
+		count = 3;
+		result = (WCHAR)((result << 3) + (*p - L'0'));
+		p++;
+		if ((numChars == 3) || !iswdigit(*p) /* INTL: digit */
+			|| (*p >= L'8')) {
+		    break;
+		}
+		count = 4;
+		result = (WCHAR)((result << 3) + (*p - L'0'));
+		break;
+	    }
+	    result = *p;
+	    break;
+    }
+
+done:
+
+    if (readPtr != NULL) {
+	*readPtr = count;
+    }
+    /*
+     * NOTE: Only the low 32 bits of the result are used, like the managed
+     *       Parser.ParseBackslash method, which splits them into two UTF-16
+     *       characters and omits the second one when it would be zero.
+     */
+
+    dst[0] = (WCHAR)(result & USHRT_MAX);
+    if (((result >> 16) & USHRT_MAX) != 0) {
+	dst[1] = (WCHAR)((result >> 16) & USHRT_MAX);
+	return 2;
+    }
+    return 1;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleCopyAndCollapse --
+ *
+ *	Copy a string and eliminate any backslashes that aren't in braces.
+ *
+ * Results:
+ *	Count characters that get copied from src to dst. Along the way,
+ *	backslash sequences are substituted in the copy.  After scanning
+ *	count characters from src, a null character is placed at the end
+ *	of dst.  Returns the number of characters that got written to dst.
+ *	The runs of characters without any backslash are found using the
+ *	fastest instruction set supported by the processor and then copied
+ *	all at once.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleCopyAndCollapse(
+    SIZE_T count,		/* Number of characters to copy from src. */
+    LPCWSTR src,		/* Copy from here... */
+    LPWSTR dst)			/* ... to here. */
+{
+    SIZE_T newCount = 0;
+
+    assert(count >= 0);
+    assert(src != NULL);
+    assert(dst != NULL);
+
+    while (count > 0) {
+	SIZE_T numRead, numWrite;
+	SIZE_T numPlain = EagleFindBackslash(src, count);
+
+	if (numPlain > 0) {
+	    memmove(dst, src, numPlain * sizeof(WCHAR));
+	    dst += numPlain;
+	    newCount += numPlain;
+	    src += numPlain;
+	    count -= numPlain;
+
+	    if (count == 0)
+		break;
+	}
+
+	numWrite = EagleParseBackslash(src, count, &numRead, dst);
+
+	dst += numWrite;
+	newCount += numWrite;
+	src += numRead;
+	count -= numRead;
+    }
+    return newCount;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleScanCountedElement --
+ *
+ *	This procedure is a companion procedure to
+ *	EagleConvertCountedElement.  It scans a string to see what needs to
+ *	be done to it (e.g. add backslashes or enclosing braces) to make the
+ *	string into a valid Tcl list element.  If length is -1, then the
+ *	string is scanned up to the first NUL character.
+ *
+ * Results:
+ *	The return value is an overestimate of the number of characters that
+ *	will be needed by EagleConvertCountedElement to produce a valid list
+ *	element from string.  The word at *flagPtr is filled in with a value
+ *	needed by EagleConvertCountedElement when doing the actual
+ *	conversion.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleScanCountedElement(
+    LPCWSTR string,		/* String to convert to Tcl list element. */
+    SIZE_T length,		/* Number of characters in string, or -1. */
+    FLAGS *flagPtr)		/* Where to store information to guide
+				 * EagleConvertCountedElement. */
+{
+    FLAGS flags;
+    int nestingLevel;
+    LPCWSTR p, lastChar;
+
+    assert((length >= 0) || (length == (SIZE_T)-1));
+    assert(flagPtr != NULL);
+
+    /*
+     * This procedure and EagleConvertCountedElement together do two things:
+     *
+     * 1. They produce a proper list, one that will yield back the argument
+     *    strings when evaluated or when disassembled with Eagle_SplitList.
+     *    This is the most important thing.
+     *
+     * 2. They try to produce legible output, which means minimizing the use
+     *    of backslashes (using braces instead).  However, there are some
+     *    situations where backslashes must be used (e.g. an element like
+     *    "{abc": the leading brace will have to be backslashed.  For each
+     *    element, one of three things must be done:
+     *
+     *    (a) Use the element as-is (it doesn't contain any special
+     *        characters).  This is the most desirable option.
+     *
+     *    (b) Enclose the element in braces, but leave the contents alone.
+     *        This happens if the element contains embedded space, or if it
+     *        contains characters with special interpretation ($, [, ;, or \),
+     *        or if it starts with a brace or double-quote, or if there are
+     *        no characters in the element.
+     *
+     *    (c) Don't enclose the element in braces, but add backslashes to
+     *        prevent special interpretation of special characters.  This is
+     *        a last resort used when the argument would normally fall under
+     *        case (b) but contains unmatched braces.  It also occurs if the
+     *        last character of the argument is a backslash or if the element
+     *        contains a backslash followed by newline.
+     *
+     * The procedure figures out how many characters will be needed to store
+     * the result (actually, it overestimates). It also collects information
+     * about the element in the form of a flags word.
+     *
+     * Note: list elements produced by this procedure and
+     * EagleConvertCountedElement must have the property that they can be
+     * enclosed in curly braces to make sub-lists.  This means, for example,
+     * that we must not leave unmatched curly braces in the resulting list
+     * element.
+     */
+
+    nestingLevel = 0;
+    flags = 0;
+    if (string == NULL) {
+	string = UNICODIFY("");
+    }
+    if (length == (SIZE_T)-1) {
+	length = EagleStrLen(string);
+    }
+    lastChar = string + length;
+    p = string;
+    if ((p == lastChar) || (*p == L'{') || (*p == L'"')) {
+	flags |= EAGLE_USE_BRACES;
+    }
+
+    /*
+     * Most list elements do not contain any characters that could require
+     * quoting.  Check for that using the fastest instruction set available;
+     * in that case, EagleConvertCountedElement can simply copy the element
+     * and, at most, two braces are needed.  Otherwise, the characters that
+     * precede the first such character do not matter below.
+     */
+
+    p += EagleFindQuote(p, length);
+    if ((p == lastChar) && (length > 0)) {
+	*flagPtr = flags | EAGLE_VERBATIM;
+	return length + 2;
+    }
+    for (; p < lastChar; p++) {
+	switch (*p) {
+	    case L'{':
+		nestingLevel++;
+		break;
+	    case L'}':
+		nestingLevel--;
+		if (nestingLevel < 0) {
+		    flags |= EAGLE_DONT_USE_BRACES | EAGLE_BRACES_UNMATCHED;
+		}
+		break;
+	    case L'[':
+	    case L'$':
+	    case L';':
+	    case L' ':
+	    case L'\f':
+	    case L'\n':
+	    case L'\r':
+	    case L'\t':
+	    case L'\v':
+		flags |= EAGLE_USE_BRACES;
+		break;
+	    case L'\\':
+		/*
+		 * The first portion of this check used to compare "p + 1"
+		 * against "lastChar" with the "==" operator; however, the
+		 * static analysis tool thinks that could lead to accessing
+		 * one character beyond the end of the string; therefore,
+		 * the check was changed to use the ">=" operator instead.
+		 *
+		 * Really, the loop invariant of the enclosing "for" loop
+		 * already defends against this, since the value of "p" is
+		 * guaranteed to be less than "lastChar" here; therefore,
+		 * the maximum value of "p + 1" is "lastChar", which would
+		 * cause the short-circuit semantics of the "if" statement,
+		 * thus preventing access to "p[1]".  Changing this to use
+		 * the ">=" operator should make it much easier for the
+		 * static analysis tool to figure all this out (i.e. since
+		 * it should then assert "(p + 1) < lastChar" at the point
+		 * where "p[1]" is used).
+		 */
+		if (((p + 1) >= lastChar) || (p[1] == L'\n')) {
+		    flags = EAGLE_DONT_USE_BRACES | EAGLE_BRACES_UNMATCHED;
+		} else {
+		    SIZE_T size;
+
+		    EagleParseBackslash(
+			p, (SIZE_T)(lastChar - p), &size, NULL);
+
+		    p += size - 1;
+		    flags |= EAGLE_USE_BRACES;
+		}
+		break;
+	}
+    }
+    if (nestingLevel != 0) {
+	flags = EAGLE_DONT_USE_BRACES | EAGLE_BRACES_UNMATCHED;
+    }
+    *flagPtr = flags;
+
+    /*
+     * Allow enough space to backslash every character plus leave
+     * two spaces for braces.
+     */
+
+    return (SIZE_T)((2 * (p - string)) + 2);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleConvertCountedElement --
+ *
+ *	This is a companion procedure to EagleScanCountedElement.  Given the
+ *	information produced by EagleScanCountedElement, this procedure
+ *	converts a string to a list element equal to that string.
+ *
+ * Results:
+ *	Information is copied to *dst in the form of a list element identical
+ *	to src (i.e. if Eagle_SplitList is applied to dst it will produce a
+ *	string identical to src).  The return value is a count of the number
+ *	of characters copied (not including the terminating NULL character).
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleConvertCountedElement(
+    LPCWSTR src,		/* Source information for list element. */
+    SIZE_T length,		/* Number of characters in src, or -1. */
+    LPWSTR dst,			/* Place to put list-ified element. */
+    FLAGS flags)		/* Flags produced by Tcl_ScanElement. */
+{
+    LPWSTR p = dst;
+    LPCWSTR lastChar;
+
+    assert((length >= 0) || (length == (SIZE_T)-1));
+    assert(dst != NULL);
+
+    /*
+     * See the comment block at the beginning of the Tcl_ScanElement
+     * code for details of how this works.
+     */
+
+    if (src && (length == (SIZE_T)-1)) {
+	length = EagleStrLen(src);
+    }
+    if ((src == NULL) || (length == 0)) {
+	p[0] = L'{';
+	p[1] = L'}';
+	return 2;
+    }
+    lastChar = src + length;
+    if ((*src == L'#') && !(flags & EAGLE_DONT_QUOTE_HASH)) {
+	flags |= EAGLE_USE_BRACES;
+    }
+    if ((flags & (EAGLE_VERBATIM | EAGLE_USE_BRACES)) == EAGLE_VERBATIM) {
+	memcpy(p, src, length * sizeof(WCHAR));
+	return length;
+    }
+    if ((flags & EAGLE_USE_BRACES) && !(flags & EAGLE_DONT_USE_BRACES)) {
+	*p = L'{';
+	p++;
+	memcpy(p, src, length * sizeof(WCHAR));
+	p += length;
+	*p = L'}';
+	p++;
+    } else {
+	if (*src == L'{') {
+	    /*
+	     * Can't have a leading brace unless the whole element is
+	     * enclosed in braces.  Add a backslash before the brace.
+	     * Furthermore, this may destroy the balance between open
+	     * and close braces, so set EAGLE_BRACES_UNMATCHED.
+	     */
+
+	    p[0] = L'\\';
+	    p[1] = L'{';
+	    p += 2;
+	    src++;
+	    flags |= EAGLE_BRACES_UNMATCHED;
+	} else if ((*src == L'#') && !(flags & EAGLE_DONT_QUOTE_HASH)) {
+	    /*
+	     * Leading '#' could be seen by [eval] as the start of
+	     * a comment, if on the first element of a list, so
+	     * quote it.
+	     */
+
+	    p[0] = L'\\';
+	    p[1] = L'#';
+	    p += 2;
+	    src++;
+	}
+	for (; src != lastChar; src++) {
+	    switch (*src) {
+		case L']':
+		case L'[':
+		case L'$':
+		case L';':
+		case L' ':
+		case L'\\':
+		case L'"':
+		    *p = L'\\';
+		    p++;
+		    break;
+		case L'{':
+		case L'}':
+		    /*
+		     * It may not seem necessary to backslash braces, but
+		     * it is.  The reason for this is that the resulting
+		     * list element may actually be an element of a sub-list
+		     * enclosed in braces (e.g. if Tcl_DStringStartSublist
+		     * has been invoked), so there may be a brace mismatch
+		     * if the braces aren't backslashed.
+		     */
+
+		    if (flags & EAGLE_BRACES_UNMATCHED) {
+			*p = L'\\';
+			p++;
+		    }
+		    break;
+		case L'\f':
+		    *p = L'\\';
+		    p++;
+		    *p = L'f';
+		    p++;
+		    continue;
+		case L'\n':
+		    *p = L'\\';
+		    p++;
+		    *p = L'n';
+		    p++;
+		    continue;
+		case L'\r':
+		    *p = L'\\';
+		    p++;
+		    *p = L'r';
+		    p++;
+		    continue;
+		case L'\t':
+		    *p = L'\\';
+		    p++;
+		    *p = L't';
+		    p++;
+		    continue;
+		case L'\v':
+		    *p = L'\\';
+		    p++;
+		    *p = L'v';
+		    p++;
+		    continue;
+	    }
+	    *p = *src;
+	    p++;
+	}
+    }
+    return (SIZE_T)(p - dst);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleFindElement --
+ *
+ *	Given a pointer into a Tcl list, locate the first (or next) element
+ *	in the list.
+ *
+ * Results:
+ *	The return value is normally EAGLE_OK, which means that the element
+ *	was successfully located.  If EAGLE_ERROR is returned it means that
+ *	list didn't have proper list structure; the interp's result contains
+ *	a more detailed error message.
+ *
+ *	If EAGLE_OK is returned, then *elementPtr will be set to point to
+ *	the first element of list, and *nextPtr will be set to point to the
+ *	character just after any white space following the last character
+ *	that's part of the element. If this is the last argument in the
+ *	list, then *nextPtr will point just after the last character in the
+ *	list (i.e., at the character at list+listLength). If sizePtr is
+ *	non-NULL, *sizePtr is filled in with the number of characters in the
+ *	element.  If the element is in braces, then *elementPtr will point
+ *	to the character after the opening brace and *sizePtr will not
+ *	include either of the braces. If there isn't an element in the list,
+ *	*sizePtr will be zero, and both *elementPtr and *termPtr will point
+ *	just after the last character in the list. If literalPtr is non-NULL,
+ *	*literalPtr is set to non-zero if the element does not require any
+ *	backslash processing (i.e. it may be used exactly as it appears in
+ *	the list).  Note: this procedure does NOT collapse backslash
+ *	sequences.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static RETURNCODE
+EagleFindElement(
+    LPCWSTR list,		/* Points to the first character of a string
+				 * containing a Tcl list with zero or more
+				 * elements (possibly in braces). */
+    SIZE_T listLength,		/* Number of characters in the string. */
+    LPCWSTR *elementPtr,	/* Where to put address of first significant
+				 * character in first element of list. */
+    LPCWSTR *nextPtr,		/* Fill in with location of character just
+				 * after all white space following end of
+				 * argument (next arg or end of list). */
+    SIZE_T *sizePtr,		/* If non-zero, fill in with size of
+				 * element. */
+    LPBOOL bracePtr,		/* If non-zero, fill in with non-zero/zero
+				 * to indicate that arg was/wasn't
+				 * in braces. */
+    LPBOOL literalPtr,		/* If non-zero, fill in with non-zero/zero
+				 * to indicate that arg does/doesn't
+				 * contain backslash sequences that
+				 * need to be collapsed. */
+    LPCWSTR *errorPtr)		/* Where to put the error message, if any. */
+{
+    LPCWSTR p = list;
+    LPCWSTR elemStart;		/* Points to first character of first element. */
+    LPCWSTR limit;		/* Points just after list's last character. */
+    int openBraces = 0;		/* Brace nesting level during parse. */
+    BOOL inQuotes = FALSE;
+    BOOL literal = TRUE;	/* Element has no backslash sequences? */
+    SIZE_T size = 0;		/* lint. */
+    SIZE_T numChars;
+    LPCWSTR p2;
+
+    assert(list != NULL);
+    assert(listLength >= 0);
+    assert(elementPtr != NULL);
+    assert(nextPtr != NULL);
+
+    /*
+     * Skim off leading white space and check for an opening brace or
+     * quote. We treat embedded NULs in the list as characters belonging
+     * to a list element.
+     */
+
+    limit = (list + listLength);
+    while ((p < limit) && iswspace(*p)) { /* INTL: ISO space. */
+	p++;
+    }
+    if (p == limit) { /* no element found */
+	elemStart = limit;
+	goto done;
+    }
+
+    if (*p == L'{') {
+	openBraces++;
+	p++;
+    } else if (*p == L'"') {
+	inQuotes = TRUE;
+	p++;
+    }
+    elemStart = p;
+
+    /*
+     * Find element's end (a space, close brace, or the end of the string).
+     */
+
+    while (p < limit) {
+	/*
+	 * Skip over any characters that cannot end the element or change
+	 * the nesting level, many at a time if the processor allows it.
+	 */
+
+	p += EagleFindSpecial(p, (SIZE_T)(limit - p));
+	if (p >= limit) {
+	    break;
+	}
+
+	switch (*p) {
+
+	    /*
+	     * Open brace: don't treat specially unless the element is in
+	     * braces. In this case, keep a nesting count.
+	     */
+
+	    case L'{':
+		if (openBraces != 0) {
+		    openBraces++;
+		}
+		break;
+
+	    /*
+	     * Close brace: if element is in braces, keep nesting count and
+	     * quit when the last close brace is seen.
+	     */
+
+	    case L'}':
+		if (openBraces > 1) {
+		    openBraces--;
+		} else if (openBraces == 1) {
+		    size = (SIZE_T)(p - elemStart);
+		    p++;
+		    if ((p >= limit)
+			    || iswspace(*p)) { /* INTL: ISO space. */
+			goto done;
+		    }
+
+		    /*
+		     * Garbage after the closing brace; return an error.
+		     */
+
+		    if (errorPtr != NULL) {
+			p2 = p;
+			while ((p2 < limit)
+				&& (!iswspace(*p2)) /* INTL: ISO space. */
+				&& (p2 < (p + 20))) {
+			    p2++;
+			}
+			*errorPtr = EaglePrintf(0,
+				UNICODIFY("list element in braces ")
+				UNICODIFY("followed by ")
+				UNICODIFY("\"%.*ls\" %ls"), (int)(p2 - p), p,
+				UNICODIFY("instead of space"));
+		    }
+		    return EAGLE_ERROR;
+		}
+		break;
+
+	    /*
+	     * Backslash:  skip over everything up to the end of the
+	     * backslash sequence.
+	     */
+
+	    case L'\\': {
+		if (openBraces == 0) {
+		    literal = FALSE;
+		}
+		EagleParseBackslash(p, (SIZE_T)(limit - p), &numChars, NULL);
+		p += (numChars - 1);
+		break;
+	    }
+
+	    /*
+	     * Space: ignore if element is in braces or quotes; otherwise
+	     * terminate element.
+	     */
+
+	    case L' ':
+	    case L'\f':
+	    case L'\n':
+	    case L'\r':
+	    case L'\t':
+	    case L'\v':
+		if ((openBraces == 0) && !inQuotes) {
+		    size = (SIZE_T)(p - elemStart);
+		    goto done;
+		}
+		break;
+
+	    /*
+	     * Double-quote: if element is in quotes then terminate it.
+	     */
+
+	    case L'"':
+		if (inQuotes) {
+		    size = (SIZE_T)(p - elemStart);
+		    p++;
+		    if ((p >= limit)
+			    || iswspace(*p)) { /* INTL: ISO space */
+			goto done;
+		    }
+
+		    /*
+		     * Garbage after the closing quote; return an error.
+		     */
+
+		    if (errorPtr != NULL) {
+			p2 = p;
+			while ((p2 < limit)
+				&& (!iswspace(*p2)) /* INTL: ISO space */
+				&& (p2 < (p + 20))) {
+			    p2++;
+			}
+			*errorPtr = EaglePrintf(0,
+				UNICODIFY("list element in quotes ")
+				UNICODIFY("followed by ")
+				UNICODIFY("\"%.*ls\" %ls"), (int)(p2 - p), p,
+				UNICODIFY("instead of space"));
+		    }
+		    return EAGLE_ERROR;
+		}
+		break;
+	}
+	p++;
+    }
+
+    /*
+     * End of list: terminate element.
+     */
+
+    if (p == limit) {
+	if (openBraces != 0) {
+	    if (errorPtr != NULL) {
+		*errorPtr = EaglePrintf(0,
+		    UNICODIFY("unmatched open brace in list"));
+	    }
+	    return EAGLE_ERROR;
+	} else if (inQuotes) {
+	    if (errorPtr != NULL) {
+		*errorPtr = EaglePrintf(0,
+		    UNICODIFY("unmatched open quote in list"));
+	    }
+	    return EAGLE_ERROR;
+	}
+	size = (SIZE_T)(p - elemStart);
+    }
+
+done:
+
+    while ((p < limit) && iswspace(*p)) { /* INTL: ISO space. */
+	p++;
+    }
+    *elementPtr = elemStart;
+    *nextPtr = p;
+    if (sizePtr != NULL) {
+	*sizePtr = size;
+    }
+    if (bracePtr != NULL) {
+	*bracePtr = (openBraces != 0);
+    }
+    if (literalPtr != NULL) {
+	*literalPtr = literal;
+    }
+
+    return EAGLE_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleAppendElement --
+ *
+ *	Converts a string to a properly quoted list element and appends it
+ *	to a list being built, preceded by a separator unless it will be the
+ *	first element of that list.
+ *
+ * Results:
+ *	The number of characters written to dst.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleAppendElement(
+    LPCWSTR src,		/* The element to append. */
+    SIZE_T length,		/* Number of characters in src. */
+    SIZE_T index,		/* Index of the element in the new list. */
+    LPWSTR dst)			/* Place to put list-ified element. */
+{
+    FLAGS flags;
+    SIZE_T numChars = 0;
+
+    assert(length >= 0);
+    assert(dst != NULL);
+
+    if (index > 0) {
+	*dst = L' ';
+	dst++;
+	numChars++;
+    }
+    EagleScanCountedElement(src, length, &flags);
+    numChars += EagleConvertCountedElement(src, length, dst,
+	flags | ((index == 0) ? 0 : EAGLE_DONT_QUOTE_HASH));
+    return numChars;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleEditList --
+ *
+ *	Builds a new list from an existing one, without splitting it up into
+ *	separate elements first.  Either the specified range of elements is
+ *	kept and all others are dropped, or the specified range of elements
+ *	is replaced with the new elements (which may be none).  Every element
+ *	of the result is quoted exactly as Eagle_JoinList would quote it, so
+ *	the result is identical to splitting, editing, and joining the list.
+ *	Only those elements that contain backslash sequences are copied into
+ *	a temporary buffer (to be collapsed) before being appended.
+ *
+ * Results:
+ *	A standard Eagle return code.  The resulting text must be freed via
+ *	Eagle_FreeMemory.
+ *
+ * Side effects:
+ *	Memory is allocated and possibly freed.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static RETURNCODE
+EagleEditList(
+    SIZE_T length,		/* Length of string with list structure. */
+    LPCWSTR pText,		/* Pointer to string with list structure. */
+    SIZE_T first,		/* Index of the first element in the range. */
+    SIZE_T count,		/* Number of elements in the range. */
+    BOOL keep,			/* Non-zero to keep only the elements in the
+				 * range; zero to replace them. */
+    SIZE_T elementCount,	/* The number of new list elements. */
+    LPCSIZE_T pElementLengths,	/* The string lengths of the new elements. */
+    LPCWSTR *ppElements,	/* The new list elements. */
+    LPSIZE_T pLength,		/* The string length of the resulting list. */
+    LPCWSTR *ppText,		/* The textual representation of the list. */
+    LPCWSTR *ppError)		/* The error message, if any. */
+{
+    LPCWSTR list, q, element;
+    LPWSTR result, dst, buffer = NULL;
+    SIZE_T allocSize, bufferLength = 0;
+    SIZE_T listLength, numChars, i, j, outIndex, elSize;
+    BOOL literal, inserted;
+    RETURNCODE code;
+
+    assert(length >= 0);
+    assert(pText != NULL);
+    assert(first >= 0);
+    assert(count >= 0);
+    assert(elementCount >= 0);
+    assert((elementCount == 0) || (ppElements != NULL));
+    assert(pLength != NULL);
+    assert(ppText != NULL);
+    assert(ppError != NULL);
+
+    /*
+     * Pass 1: estimate space.  Each element needs, at most, twice its
+     * length plus two braces plus one separator (see the comments in
+     * EagleScanCountedElement).
+     */
+
+    numChars = 0;
+    list = pText;
+    listLength = length;
+    q = pText + length;
+    for (i = 0; listLength > 0; i++) {
+	LPCWSTR prevList = list;
+
+	if (keep && (i >= first) && (i - first >= count)) {
+	    break;
+	}
+	code = EagleFindElement(list, listLength, &element, &list,
+				&elSize, NULL, NULL, ppError);
+	if (code != EAGLE_OK) {
+	    return code;
+	}
+	listLength -= (SIZE_T)(list - prevList);
+	if (element == q) {
+	    break;
+	}
+	if (keep != ((i >= first) && (i - first < count))) {
+	    continue;
+	}
+	numChars += (2 * elSize) + 3;
+    }
+    if (!keep) {
+	for (j = 0; j < elementCount; j++) {
+	    numChars += (2 * SysStringLenWrapper(j)) + 3;
+	}
+    }
+
+    /*
+     * Pass 2: copy into the result area.
+     */
+
+    allocSize = (numChars + 1) * sizeof(WCHAR);
+    assert(allocSize > 0);
+    assert(allocSize <= LIBRARY_MAXIMUM_SIZE_T);
+    result = EagleAllocateBuffer(allocSize, FALSE,
+	EAGLE_MEMORY_SITE_EDIT);
+    if (result == NULL) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("out of memory for list element text (%zu)"),
+		allocSize);
+	}
+	return EAGLE_ERROR;
+    }
+
+    dst = result;
+    outIndex = 0;
+    inserted = keep;
+    list = pText;
+    listLength = length;
+    for (i = 0; listLength > 0; i++) {
+	LPCWSTR prevList = list;
+
+	if (keep && (i >= first) && (i - first >= count)) {
+	    break;
+	}
+	code = EagleFindElement(list, listLength, &element, &list,
+				&elSize, NULL, &literal, ppError);
+	if (code != EAGLE_OK) {
+	    Eagle_FreeMemory(result);
+	    Eagle_FreeMemory(buffer);
+	    return code;
+	}
+	listLength -= (SIZE_T)(list - prevList);
+	if (element == q) {
+	    break;
+	}
+	if (!inserted && (i == first)) {
+	    for (j = 0; j < elementCount; j++) {
+		dst += EagleAppendElement(ppElements[j],
+		    SysStringLenWrapper(j) /* NON-PORTABLE? */, outIndex++,
+		    dst);
+	    }
+	    inserted = TRUE;
+	}
+	if (keep != ((i >= first) && (i - first < count))) {
+	    continue;
+	}
+	if (!literal) {
+	    /*
+	     * This element contains backslash sequences; therefore, it
+	     * must be collapsed before it can be quoted again.
+	     * Collapsing never makes an element longer.
+	     */
+
+	    if (bufferLength < elSize + 1) {
+		Eagle_FreeMemory(buffer);
+		bufferLength = elSize + 1;
+		allocSize = bufferLength * sizeof(WCHAR);
+		assert(allocSize > 0);
+		assert(allocSize <= LIBRARY_MAXIMUM_SIZE_T);
+		buffer = EagleAllocateBuffer(allocSize, FALSE,
+		    EAGLE_MEMORY_SITE_EDIT);
+		if (buffer == NULL) {
+		    if (ppError != NULL) {
+			*ppError = EaglePrintf(0,
+			    UNICODIFY("out of memory for list element (%zu)"),
+			    allocSize);
+		    }
+		    Eagle_FreeMemory(result);
+		    return EAGLE_ERROR;
+		}
+	    }
+	    elSize = EagleCopyAndCollapse(elSize, element, buffer);
+	    element = buffer;
+	}
+	dst += EagleAppendElement(element, elSize, outIndex++, dst);
+    }
+    if (!inserted) {
+	/*
+	 * The insertion point is at (or beyond) the end of the list.
+	 */
+
+	for (j = 0; j < elementCount; j++) {
+	    dst += EagleAppendElement(ppElements[j],
+		SysStringLenWrapper(j) /* NON-PORTABLE? */, outIndex++, dst);
+	}
+    }
+    *dst = 0;
+
+    Eagle_FreeMemory(buffer);
+
+    *pLength = (SIZE_T)(dst - result);
+    *ppText = result;
+
+    return EAGLE_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleFoldCase --
+ *
+ *	Folds the specified character to lowercase for the purposes of glob
+ *	matching.  Only the ASCII letters are folded, so the result does not
+ *	depend on the current locale.
+ *
+ * Results:
+ *	The folded character.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static WCHAR
+EagleFoldCase(
+    WCHAR c)		/* The character to fold. */
+{
+    if ((c >= L'A') && (c <= L'Z'))
+	return (WCHAR)(c + (L'a' - L'A'));
+
+    return c;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleMatchBracket --
+ *
+ *	Attempts to match one character against the bracketed character set
+ *	that starts at the specified pattern index.  There is no escaping
+ *	within the set and a range may be specified in either order.  Upon
+ *	success, the index is advanced beyond the closing bracket, if any.
+ *	This mirrors the glob matching algorithm used by the Parser class.
+ *
+ * Results:
+ *	Non-zero if the character matches the set, zero otherwise.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static BOOL
+EagleMatchBracket(
+    LPCWSTR pPattern,		/* The glob pattern. */
+    SIZE_T patternLength,	/* Length of the pattern, in characters. */
+    LPSIZE_T pIndex,		/* IN: Index of the open bracket.
+				 * OUT: Index after the close bracket. */
+    WCHAR c,			/* The character to match, folded if
+				 * necessary. */
+    INT flags)			/* The EAGLE_MATCH_* flags. */
+{
+    BOOL noCase = (flags & EAGLE_MATCH_NO_CASE) ? TRUE : FALSE;
+    SIZE_T index = *pIndex + 1;
+    WCHAR startChar, endChar;
+
+    while (1) {
+	if ((index >= patternLength) || (pPattern[index] == L']'))
+	    return FALSE;
+
+	startChar = pPattern[index++];
+
+	if (noCase)
+	    startChar = EagleFoldCase(startChar);
+
+	if ((index < patternLength) && (pPattern[index] == L'-')) {
+	    index++;
+
+	    if (index >= patternLength)
+		return FALSE;
+
+	    endChar = pPattern[index++];
+
+	    if (noCase)
+		endChar = EagleFoldCase(endChar);
+
+	    if ((flags & EAGLE_MATCH_STRICT_RANGE) &&
+		    (index >= patternLength) && (endChar == L']')) {
+		return FALSE;
+	    }
+
+	    if (((startChar <= c) && (c <= endChar)) ||
+		    ((endChar <= c) && (c <= startChar))) {
+		break;
+	    }
+	} else if (startChar == c) {
+	    break;
+	}
+    }
+
+    while ((index < patternLength) && (pPattern[index] != L']'))
+	index++;
+
+    if (index < patternLength)
+	index++;
+
+    *pIndex = index;
+    return TRUE;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleMatchGeneric --
+ *
+ *	Matches a string against a glob pattern, using the same semantics
+ *	as the [string match] command.  Since every pattern element other
+ *	than an asterisk matches exactly one character, only the position
+ *	of the most recent asterisk needs to be remembered; therefore, no
+ *	recursion is used and the worst case is proportional to the product
+ *	of the text and pattern lengths.
+ *
+ * Results:
+ *	Non-zero if the string matches the pattern, zero otherwise.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static BOOL
+EagleMatchGeneric(
+    LPCWSTR pText,		/* The string to match. */
+    SIZE_T textLength,		/* Length of the string, in characters. */
+    LPCWSTR pPattern,		/* The glob pattern. */
+    SIZE_T patternLength,	/* Length of the pattern, in characters. */
+    INT flags)			/* The EAGLE_MATCH_* flags. */
+{
+    BOOL noCase = (flags & EAGLE_MATCH_NO_CASE) ? TRUE : FALSE;
+    BOOL haveStar = FALSE;
+    SIZE_T textIndex = 0, patternIndex = 0;
+    SIZE_T starTextIndex = 0, starPatternIndex = 0;
+    WCHAR textChar, patternChar;
+
+    while (1) {
+	if ((patternIndex < patternLength) &&
+		(pPattern[patternIndex] == L'*')) {
+	    /*
+	     * Collapse a run of asterisks.  When the pattern ends with
+	     * one, it matches the rest of the string, whatever it is.
+	     */
+
+	    while ((patternIndex < patternLength) &&
+		    (pPattern[patternIndex] == L'*')) {
+		patternIndex++;
+	    }
+
+	    if (patternIndex >= patternLength)
+		return TRUE;
+
+	    haveStar = TRUE;
+	    starTextIndex = textIndex;
+	    starPatternIndex = patternIndex;
+	    continue;
+	}
+
+	if (patternIndex >= patternLength) {
+	    if (textIndex >= textLength)
+		return TRUE;
+
+	    goto backtrack;
+	}
+
+	/*
+	 * Every remaining pattern element requires at least one more
+	 * character, which no asterisk can provide.
+	 */
+
+	if (textIndex >= textLength)
+	    return FALSE;
+
+	textChar = pText[textIndex];
+
+	if (noCase)
+	    textChar = EagleFoldCase(textChar);
+
+	patternChar = pPattern[patternIndex];
+
+	if (patternChar == L'?') {
+	    patternIndex++;
+	    textIndex++;
+	    continue;
+	}
+
+	if (patternChar == L'[') {
+	    if (EagleMatchBracket(pPattern, patternLength, &patternIndex,
+		    textChar, flags)) {
+		textIndex++;
+		continue;
+	    }
+
+	    goto backtrack;
+	}
+
+	if (patternChar == L'\\') {
+	    if (++patternIndex >= patternLength)
+		goto backtrack;
+
+	    patternChar = pPattern[patternIndex];
+	}
+
+	if (noCase)
+	    patternChar = EagleFoldCase(patternChar);
+
+	if (patternChar == textChar) {
+	    patternIndex++;
+	    textIndex++;
+	    continue;
+	}
+
+    backtrack:
+	/*
+	 * Let the most recent asterisk consume one more character and
+	 * then try the rest of the pattern again.
+	 */
+
+	if (!haveStar || (starTextIndex >= textLength))
+	    return FALSE;
+
+	textIndex = ++starTextIndex;
+	patternIndex = starPatternIndex;
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleMatchLiteral --
+ *
+ *	Compares part of a string with the literal text of a compiled glob
+ *	pattern.  The caller must make sure the string is long enough.
+ *
+ * Results:
+ *	Non-zero if the characters are equal, zero otherwise.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static BOOL
+EagleMatchLiteral(
+    LPCWSTR pText,		/* The characters to compare. */
+    LPCWSTR pLiteral,		/* The literal, folded if necessary. */
+    SIZE_T length,		/* The number of characters to compare. */
+    BOOL noCase)		/* Non-zero to fold the characters. */
+{
+    SIZE_T index;
+
+    if (noCase) {
+	for (index = 0; index < length; index++) {
+	    if (EagleFoldCase(pText[index]) != pLiteral[index])
+		return FALSE;
+	}
+    } else {
+	for (index = 0; index < length; index++) {
+	    if (pText[index] != pLiteral[index])
+		return FALSE;
+	}
+    }
+
+    return TRUE;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleClassifyPattern --
+ *
+ *	Determines if a glob pattern consists of only literal characters,
+ *	optionally preceded and/or followed by asterisks.  If so, copies the
+ *	literal characters, without any backslashes, into the buffer, which
+ *	must be at least as long as the pattern.
+ *
+ * Results:
+ *	One of the MATCH_KIND_* values.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static INT
+EagleClassifyPattern(
+    LPCWSTR pPattern,		/* The glob pattern. */
+    SIZE_T length,		/* Length of the pattern, in characters. */
+    LPWSTR pLiteral,		/* OUT: The literal characters. */
+    LPSIZE_T pLiteralLength)	/* OUT: Number of literal characters. */
+{
+    SIZE_T index = 0, literalLength = 0;
+    BOOL leading = FALSE, trailing = FALSE;
+
+    while ((index < length) && (pPattern[index] == L'*')) {
+	leading = TRUE;
+	index++;
+    }
+
+    while (index < length) {
+	WCHAR c = pPattern[index];
+
+	if (c == L'*') {
+	    /*
+	     * An unescaped asterisk is only allowed here when the rest of
+	     * the pattern consists entirely of asterisks.
+	     */
+
+	    while ((index < length) && (pPattern[index] == L'*'))
+		index++;
+
+	    if (index < length)
+		return MATCH_KIND_GENERIC;
+
+	    trailing = TRUE;
+	    break;
+	}
+
+	if ((c == L'?') || (c == L'['))
+	    return MATCH_KIND_GENERIC;
+
+	if (c == L'\\') {
+	    /*
+	     * A trailing backslash never matches anything; leave that to
+	     * the generic algorithm.
+	     */
+
+	    if (++index >= length)
+		return MATCH_KIND_GENERIC;
+
+	    c = pPattern[index];
+	}
+
+	pLiteral[literalLength++] = c;
+	index++;
+    }
+
+    *pLiteralLength = literalLength;
+
+    if (leading || trailing) {
+	if (literalLength == 0)
+	    return MATCH_KIND_ANY;
+
+	if (leading && trailing)
+	    return MATCH_KIND_CONTAINS;
+
+	return leading ? MATCH_KIND_SUFFIX : MATCH_KIND_PREFIX;
+    }
+
+    return MATCH_KIND_EXACT;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleMatchPattern --
+ *
+ *	Matches a string against a compiled glob pattern, using the fastest
+ *	method suitable for the kind of pattern.
+ *
+ * Results:
+ *	Non-zero if the string matches the pattern, zero otherwise.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static BOOL
+EagleMatchPattern(
+    LPMATCH_PATTERN pPattern,	/* The compiled glob pattern. */
+    LPCWSTR pText,		/* The string to match. */
+    SIZE_T textLength)		/* Length of the string, in characters. */
+{
+    BOOL noCase = (pPattern->flags & EAGLE_MATCH_NO_CASE) ? TRUE : FALSE;
+    LPCWSTR pLiteral = pPattern->pLiteral;
+    SIZE_T literalLength = pPattern->literalLength;
+    SIZE_T index, lastIndex;
+
+    switch (pPattern->kind) {
+	case MATCH_KIND_ANY:
+	    return TRUE;
+	case MATCH_KIND_EXACT:
+	    return (textLength == literalLength) &&
+		EagleMatchLiteral(pText, pLiteral, literalLength, noCase);
+	case MATCH_KIND_PREFIX:
+	    return (textLength >= literalLength) &&
+		EagleMatchLiteral(pText, pLiteral, literalLength, noCase);
+	case MATCH_KIND_SUFFIX:
+	    return (textLength >= literalLength) &&
+		EagleMatchLiteral(pText + (textLength - literalLength),
+		    pLiteral, literalLength, noCase);
+	case MATCH_KIND_CONTAINS:
+	    if (textLength < literalLength)
+		return FALSE;
+
+	    lastIndex = textLength - literalLength;
+
+	    for (index = 0; index <= lastIndex; index++) {
+		WCHAR c = noCase ? EagleFoldCase(pText[index]) : pText[index];
+
+		if ((c == pLiteral[0]) && EagleMatchLiteral(pText + index,
+			pLiteral, literalLength, noCase)) {
+		    return TRUE;
+		}
+	    }
+
+	    return FALSE;
+    }
+
+    return EagleMatchGeneric(pText, textLength, pPattern->pPattern,
+	pPattern->length, pPattern->flags);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleGetCharType --
+ *
+ *	Classifies a character for the purpose of parsing a script.  This
+ *	is the same as the managed Parser.GetCharacterType method.
+ *
+ * Results:
+ *	One of the CHAR_TYPE_* values.  Records at pNextLine non-zero if the
+ *	character is a line feed, which advances the current line.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static INT
+EagleGetCharType(
+    WCHAR c,			/* The character to classify. */
+    LPBOOL pNextLine)		/* OUT: Non-zero for a new line. */
+{
+    *pNextLine = FALSE;
+
+    switch (c) {
+	case L'\n':
+	    *pNextLine = TRUE;
+	    return CHAR_TYPE_COMMAND_TERMINATOR;
+	case L';':
+	    return CHAR_TYPE_COMMAND_TERMINATOR;
+	case L'\0':
+	case L'[':
+	case L'$':
+	case L'\\':
+	    return CHAR_TYPE_SUBSTITUTION;
+	case L'"':
+	    return CHAR_TYPE_QUOTE;
+	case L')':
+	    return CHAR_TYPE_CLOSE_PARENTHESIS;
+	case L']':
+	    return CHAR_TYPE_CLOSE_BRACKET;
+	case L'{':
+	case L'}':
+	    return CHAR_TYPE_BRACE;
+    }
+
+    return EagleIsSpace(c) ? CHAR_TYPE_SPACE : CHAR_TYPE_NONE;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleCountLine --
+ *
+ *	Advances the current line of a parse state, unless the line feed
+ *	at the specified offset has already been counted.
+ *
+ * Results:
+ *	Non-zero if the current line was advanced.
+ *
+ * Side effects:
+ *	The parse state may be modified.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static BOOL
+EagleCountLine(
+    LPPARSE_STATE pState,	/* The parse state. */
+    SIZE_T index)		/* Offset of the line feed. */
+{
+    if ((pState->lineStart != EAGLE_PARSE_INVALID_INDEX) &&
+	    (index <= pState->lineStart)) {
+	return FALSE;
+    }
+
+    pState->currentLine++;
+    pState->lineStart = index;
+
+    return TRUE;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleInitToken --
+ *
+ *	Initializes a token for the current line of a parse state.  This
+ *	is the same as the managed ParseToken.FromState method.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	The token is modified.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static VOID
+EagleInitToken(
+    LPPARSE_STATE pState,	/* The parse state. */
+    LPSCRIPT_TOKEN pToken)	/* The token to initialize. */
+{
+    memset(pToken, 0, sizeof(SCRIPT_TOKEN));
+    pToken->startLine = pState->currentLine;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleAddToken --
+ *
+ *	Appends a copy of a token to the token buffer of a parse state and
+ *	records the current line as the line where it was finished.
+ *
+ * Results:
+ *	Non-zero upon success -OR- zero if out of memory.
+ *
+ * Side effects:
+ *	Memory may be allocated and freed.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static BOOL
+EagleAddToken(
+    LPPARSE_STATE pState,	/* The parse state. */
+    LPSCRIPT_TOKEN pToken,	/* The token to append. */
+    LPCWSTR *ppError)		/* The error message, if any. */
+{
+    LPTOKEN_BUFFER pBuffer = pState->pBuffer;
+
+    if (pBuffer->count >= pBuffer->capacity) {
+	SIZE_T newCapacity = (pBuffer->capacity > 0) ?
+	    pBuffer->capacity * 2 : LIBRARY_PARSE_TOKEN_SIZE;
+	LPSCRIPT_TOKEN pTokens = NULL;
+
+	if (newCapacity <= (LIBRARY_MAXIMUM_SIZE_T /
+		(SIZE_T)sizeof(SCRIPT_TOKEN))) {
+	    pTokens = EagleAllocateBuffer(
+		newCapacity * (SIZE_T)sizeof(SCRIPT_TOKEN), FALSE,
+		EAGLE_MEMORY_SITE_PARSE);
+	}
+	if (pTokens == NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("out of memory for tokens (%zu)"),
+		newCapacity);
+	    return FALSE;
+	}
+	if (pBuffer->count > 0) {
+	    memcpy(pTokens, pBuffer->pTokens,
+		pBuffer->count * sizeof(SCRIPT_TOKEN));
+	}
+	Eagle_FreeMemory(pBuffer->pTokens);
+	pBuffer->pTokens = pTokens;
+	pBuffer->capacity = newCapacity;
+    }
+
+    pToken->endLine = pState->currentLine;
+    pBuffer->pTokens[pBuffer->count++] = *pToken;
+
+    return TRUE;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleParseWhiteSpace --
+ *
+ *	Scans the white space, including any backslash-newline sequences,
+ *	starting at the specified offset.  This is the same as the managed
+ *	Parser.ParseWhiteSpace method.
+ *
+ * Results:
+ *	The number of characters scanned.  Records at pCharType the type of
+ *	the character that stopped the scan.
+ *
+ * Side effects:
+ *	The parse state may be modified.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleParseWhiteSpace(
+    LPPARSE_STATE pState,	/* The parse state. */
+    SIZE_T startIndex,		/* Offset of the first character. */
+    INT *pCharType)		/* OUT: Type of the last character. */
+{
+    LPCWSTR pText = pState->pText;
+    SIZE_T length = pState->length;
+    SIZE_T index = startIndex;
+    INT charType = CHAR_TYPE_NONE;
+    BOOL nextLine = FALSE;
+
+    if (length == 0)
+	return 0;
+
+    while (1) {
+	while ((index < length) && ((charType = EagleGetCharType(
+		pText[index], &nextLine)) == CHAR_TYPE_SPACE)) {
+	    if (nextLine && EagleCountLine(pState, index))
+		nextLine = FALSE;
+
+	    index++;
+	}
+
+	if (nextLine && EagleCountLine(pState, index))
+	    nextLine = FALSE;
+
+	if ((index < length) && (charType == CHAR_TYPE_SUBSTITUTION)) {
+	    if ((pText[index] != L'\\') || ((index + 1) >= length) ||
+		    (pText[index + 1] != L'\n')) {
+		break;
+	    }
+
+	    EagleCountLine(pState, index + 1);
+	    index += 2;
+
+	    if (index >= length) {
+		pState->incomplete = TRUE;
+		break;
+	    }
+	    continue;
+	}
+	break;
+    }
+
+    *pCharType = charType;
+    return index - startIndex;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleParseComment --
+ *
+ *	Scans the white space and comments, if any, that precede a command.
+ *	This is the same as the managed Parser.ParseComment method.
+ *
+ * Results:
+ *	The number of characters scanned.
+ *
+ * Side effects:
+ *	The parse state may be modified.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleParseComment(
+    LPPARSE_STATE pState,	/* The parse state. */
+    SIZE_T startIndex)		/* Offset of the first character. */
+{
+    LPCWSTR pText = pState->pText;
+    SIZE_T length = pState->length;
+    SIZE_T index = startIndex;
+    SIZE_T scanned;
+    INT charType = CHAR_TYPE_NONE;
+
+    while (index < length) {
+	do {
+	    index += EagleParseWhiteSpace(pState, index, &charType);
+	} while ((index < length) && (pText[index] == L'\n') && (++index > 0));
+
+	if ((index >= length) || (pText[index] != L'#'))
+	    break;
+
+	if (pState->commentStart == EAGLE_PARSE_INVALID_INDEX)
+	    pState->commentStart = index;
+
+	while (index < length) {
+	    if (pText[index] == L'\\') {
+		scanned = EagleParseWhiteSpace(pState, index, &charType);
+
+		if (scanned == 0) {
+		    EagleParseBackslash(
+			pText + index, length - index, &scanned, NULL);
+		}
+
+		index += scanned;
+	    } else {
+		index++;
+
+		if (pText[index - 1] == L'\n') {
+		    EagleCountLine(pState, index - 1);
+		    break;
+		}
+	    }
+	}
+
+	pState->commentLength = index - pState->commentStart;
+    }
+
+    return index - startIndex;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleParseBraces --
+ *
+ *	Parses a word enclosed in braces, starting at the open brace.  This
+ *	is the same as the managed Parser.ParseBraces method.
+ *
+ * Results:
+ *	A standard Eagle return code.  Records at pTerminator the offset of
+ *	the character just after the close brace.
+ *
+ * Side effects:
+ *	The parse state is modified.  Memory may be allocated.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static RETURNCODE
+EagleParseBraces(
+    LPPARSE_STATE pState,	/* The parse state. */
+    SIZE_T startIndex,		/* Offset of the open brace. */
+    LPSIZE_T pTerminator,	/* OUT: Offset after the close brace. */
+    LPCWSTR *ppError)		/* The error message, if any. */
+{
+    LPCWSTR pText = pState->pText;
+    SIZE_T length = pState->length;
+    SIZE_T oldTokens = pState->pBuffer->count;
+    SIZE_T index = startIndex;
+    SIZE_T read;
+    SCRIPT_TOKEN token;
+    BOOL nextLine;
+    INT level = 1;
+
+    EagleInitToken(pState, &token);
+    token.type = EAGLE_TOKEN_TEXT;
+    token.start = index + 1;
+
+    while (1) {
+	while (++index < length) {
+	    if (EagleGetCharType(pText[index], &nextLine) != CHAR_TYPE_NONE) {
+		if (nextLine)
+		    EagleCountLine(pState, index);
+
+		break;
+	    }
+	}
+
+	if (index >= length) {
+	    pState->terminator = startIndex;
+	    pState->incomplete = TRUE;
+
+	    *ppError = EaglePrintf(0, UNICODIFY("missing close-brace"));
+	    return EAGLE_ERROR;
+	}
+
+	switch (pText[index]) {
+	    case L'{':
+		level++;
+		break;
+	    case L'}':
+		if (--level == 0) {
+		    if ((index != token.start) ||
+			    (pState->pBuffer->count == oldTokens)) {
+			token.length = index - token.start;
+
+			if (!EagleAddToken(pState, &token, ppError))
+			    return EAGLE_ERROR;
+		    }
+
+		    *pTerminator = index + 1;
+		    return EAGLE_OK;
+		}
+		break;
+	    case L'\\':
+		EagleParseBackslash(pText + index, length - index, &read, NULL);
+
+		if ((read > 1) && (pText[index + 1] == L'\n')) {
+		    if ((length - index) == 2)
+			pState->incomplete = TRUE;
+
+		    token.length = index - token.start;
+
+		    if ((token.length > 0) &&
+			    !EagleAddToken(pState, &token, ppError)) {
+			return EAGLE_ERROR;
+		    }
+
+		    EagleInitToken(pState, &token);
+		    token.type = EAGLE_TOKEN_BACKSLASH;
+		    token.start = index;
+		    token.length = read;
+
+		    /*
+		     * Only the text after the backslash token itself is on
+		     * the next line.
+		     */
+
+		    EagleCountLine(pState, index + 1);
+
+		    if (!EagleAddToken(pState, &token, ppError))
+			return EAGLE_ERROR;
+
+		    index += (read - 1);
+
+		    EagleInitToken(pState, &token);
+		    token.type = EAGLE_TOKEN_TEXT;
+		    token.start = index + 1;
+		} else {
+		    index += (read - 1);
+		}
+		break;
+	}
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleParseVariableName --
+ *
+ *	Parses a variable reference, starting at the dollar sign.  This is
+ *	the same as the managed Parser.ParseVariableName method, except that
+ *	a name containing any non-ASCII character is rejected, because the
+ *	managed method uses the Unicode rules for letters and digits.
+ *
+ * Results:
+ *	A standard Eagle return code.
+ *
+ * Side effects:
+ *	The parse state is modified.  Memory may be allocated.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static RETURNCODE
+EagleParseVariableName(
+    LPPARSE_STATE pState,	/* The parse state. */
+    SIZE_T startIndex,		/* Offset of the dollar sign. */
+    LPCWSTR *ppError)		/* The error message, if any. */
+{
+    LPCWSTR pText = pState->pText;
+    SIZE_T length = pState->length;
+    SIZE_T index = startIndex;
+    SIZE_T variableIndex;
+    LPSCRIPT_TOKEN pVariable;
+    SCRIPT_TOKEN token;
+    BOOL array;
+
+    EagleInitToken(pState, &token);
+    token.type = EAGLE_TOKEN_VARIABLE;
+    token.start = index;
+
+    variableIndex = pState->pBuffer->count;
+
+    if (!EagleAddToken(pState, &token, ppError))
+	return EAGLE_ERROR;
+
+    EagleInitToken(pState, &token);
+
+    if (++index >= length)
+	goto justADollarSign;
+
+    if (pText[index] == L'{') {
+	index++;
+
+	token.type = EAGLE_TOKEN_TEXT;
+	token.start = index;
+
+	while ((index < length) && (pText[index] != L'}')) {
+	    if (pText[index] == L'\n')
+		EagleCountLine(pState, index);
+
+	    index++;
+	}
+
+	if (index >= length) {
+	    pState->terminator = token.start - 1;
+	    pState->incomplete = TRUE;
+
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("missing close-brace for variable name"));
+	    return EAGLE_ERROR;
+	}
+
+	token.length = index - token.start;
+
+	if (!EagleAddToken(pState, &token, ppError))
+	    return EAGLE_ERROR;
+
+	index++;
+    } else {
+	token.type = EAGLE_TOKEN_TEXT;
+	token.start = index;
+
+	while (index < length) {
+	    WCHAR c = pText[index];
+
+	    if (c > 0x7F) {
+		*ppError = EaglePrintf(0,
+		    UNICODIFY("non-ASCII variable name character at %zu"),
+		    index);
+		return EAGLE_ERROR;
+	    }
+
+	    if (((c >= L'a') && (c <= L'z')) ||
+		    ((c >= L'A') && (c <= L'Z')) ||
+		    ((c >= L'0') && (c <= L'9')) || (c == L'_')) {
+		index++;
+		continue;
+	    }
+
+	    if ((c == L':') && ((index + 1) < length) &&
+		    (pText[index + 1] == L':')) {
+		index += 2;
+
+		while ((index < length) && (pText[index] == L':'))
+		    index++;
+
+		continue;
+	    }
+
+	    break;
+	}
+
+	array = ((index < length) && (pText[index] == L'('));
+	token.length = index - token.start;
+
+	if ((token.length == 0) && !array)
+	    goto justADollarSign;
+
+	if (!EagleAddToken(pState, &token, ppError))
+	    return EAGLE_ERROR;
+
+	if (array) {
+	    if (EagleParseTokens(pState, index + 1,
+		    CHAR_TYPE_CLOSE_PARENTHESIS, ppError) != EAGLE_OK) {
+		return EAGLE_ERROR;
+	    }
+
+	    if ((pState->terminator >= length) ||
+		    (pText[pState->terminator] != L')')) {
+		pState->terminator = index;
+		pState->incomplete = TRUE;
+
+		*ppError = EaglePrintf(0, UNICODIFY("missing )"));
+		return EAGLE_ERROR;
+	    }
+
+	    index = pState->terminator + 1;
+	}
+    }
+
+    /*
+     * Fixup the size and nested components of the variable token.  The
+     * variable name can span multiple lines.
+     */
+
+    pVariable = &pState->pBuffer->pTokens[variableIndex];
+    pVariable->length = index - pVariable->start;
+    pVariable->components = pState->pBuffer->count - (variableIndex + 1);
+    pVariable->endLine = pState->currentLine;
+
+    return EAGLE_OK;
+
+justADollarSign:
+    pVariable = &pState->pBuffer->pTokens[variableIndex];
+    pVariable->type = EAGLE_TOKEN_TEXT;
+    pVariable->length = 1;
+    pVariable->components = 0;
+
+    return EAGLE_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleParseTokens --
+ *
+ *	Parses text, variables, nested commands, and backslash sequences
+ *	until a character matching the mask is found.  This is the same as
+ *	the managed Parser.ParseTokens method.
+ *
+ * Results:
+ *	A standard Eagle return code.
+ *
+ * Side effects:
+ *	The parse state is modified.  Memory may be allocated.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static RETURNCODE
+EagleParseTokens(
+    LPPARSE_STATE pState,	/* The parse state. */
+    SIZE_T startIndex,		/* Offset of the first character. */
+    INT mask,			/* The CHAR_TYPE_* values that terminate
+				 * the tokens. */
+    LPCWSTR *ppError)		/* The error message, if any. */
+{
+    LPCWSTR pText = pState->pText;
+    SIZE_T length = pState->length;
+    LPTOKEN_BUFFER pBuffer = pState->pBuffer;
+    SIZE_T originalTokens = pBuffer->count;
+    SIZE_T index = startIndex;
+    INT charType = CHAR_TYPE_NONE;
+    BOOL nextLine = FALSE;
+    SCRIPT_TOKEN token;
+
+    while ((index < length) && (((charType = EagleGetCharType(
+	    pText[index], &nextLine)) & mask) == 0)) {
+	if (nextLine && EagleCountLine(pState, index))
+	    nextLine = FALSE;
+
+	EagleInitToken(pState, &token);
+	token.start = index;
+
+	if ((charType & CHAR_TYPE_SUBSTITUTION) == 0) {
+	    BOOL nextLine2 = FALSE;
+
+	    while ((++index < length) && ((EagleGetCharType(pText[index],
+		    &nextLine2) & (mask | CHAR_TYPE_SUBSTITUTION)) == 0)) {
+		if (nextLine2 && EagleCountLine(pState, index))
+		    nextLine2 = FALSE;
+	    }
+
+	    if (nextLine2 && EagleCountLine(pState, index))
+		nextLine2 = FALSE;
+
+	    token.type = EAGLE_TOKEN_TEXT;
+	    token.length = index - token.start;
+
+	    if (!EagleAddToken(pState, &token, ppError))
+		return EAGLE_ERROR;
+	} else if (pText[index] == L'$') {
+	    SIZE_T varToken;
+
+	    if ((pState->flags & EAGLE_PARSE_VARIABLES) == 0) {
+		token.type = EAGLE_TOKEN_TEXT;
+		token.length = 1;
+
+		if (!EagleAddToken(pState, &token, ppError))
+		    return EAGLE_ERROR;
+
+		index++;
+		continue;
+	    }
+
+	    varToken = pBuffer->count;
+
+	    if (EagleParseVariableName(pState, index, ppError) != EAGLE_OK)
+		return EAGLE_ERROR;
+
+	    index += pBuffer->pTokens[varToken].length;
+	} else if (pText[index] == L'[') {
+	    PARSE_STATE nested;
+
+	    if ((pState->flags & EAGLE_PARSE_COMMANDS) == 0) {
+		token.type = EAGLE_TOKEN_TEXT;
+		token.length = 1;
+
+		if (!EagleAddToken(pState, &token, ppError))
+		    return EAGLE_ERROR;
+
+		index++;
+		continue;
+	    }
+
+	    if (pState->depth >= LIBRARY_PARSE_MAXIMUM_DEPTH) {
+		*ppError = EaglePrintf(0,
+		    UNICODIFY("too many nested commands (%zu)"),
+		    pState->depth);
+		return EAGLE_ERROR;
+	    }
+
+	    index++;
+
+	    /*
+	     * The nested command has its own parse state, which starts on
+	     * the current line.  Its tokens are appended to the shared
+	     * buffer and then discarded.
+	     */
+
+	    memset(&nested, 0, sizeof(PARSE_STATE));
+	    nested.pText = pText;
+	    nested.length = length;
+	    nested.flags = pState->flags;
+	    nested.depth = pState->depth + 1;
+	    nested.currentLine = pState->currentLine;
+	    nested.pBuffer = pBuffer;
+	    nested.firstToken = pBuffer->count;
+
+	    while (1) {
+		if (EagleParseCommand(&nested, index, TRUE,
+			ppError) != EAGLE_OK) {
+		    pBuffer->count = nested.firstToken;
+		    pState->terminator = nested.terminator;
+		    pState->incomplete = nested.incomplete;
+		    return EAGLE_ERROR;
+		}
+
+		index = nested.commandStart + nested.commandLength;
+
+		if ((nested.terminator < length) &&
+			(pText[nested.terminator] == L']') &&
+			!nested.incomplete) {
+		    break;
+		}
+
+		if (index >= length) {
+		    pBuffer->count = nested.firstToken;
+		    pState->terminator = token.start;
+		    pState->incomplete = TRUE;
+
+		    *ppError = EaglePrintf(0,
+			UNICODIFY("missing close-bracket"));
+		    return EAGLE_ERROR;
+		}
+	    }
+
+	    pBuffer->count = nested.firstToken;
+
+	    token.type = EAGLE_TOKEN_COMMAND;
+	    token.length = index - token.start;
+
+	    if (!EagleAddToken(pState, &token, ppError))
+		return EAGLE_ERROR;
+	} else if (pText[index] == L'\\') {
+	    SIZE_T read = 0;
+
+	    if ((pState->flags & EAGLE_PARSE_BACKSLASHES) == 0) {
+		token.type = EAGLE_TOKEN_TEXT;
+		token.length = 1;
+
+		if (!EagleAddToken(pState, &token, ppError))
+		    return EAGLE_ERROR;
+
+		index++;
+		continue;
+	    }
+
+	    EagleParseBackslash(pText + index, length - index, &read, NULL);
+	    token.length = read;
+
+	    if (read == 1) {
+		token.type = EAGLE_TOKEN_TEXT;
+
+		if (!EagleAddToken(pState, &token, ppError))
+		    return EAGLE_ERROR;
+
+		index++;
+		continue;
+	    }
+
+	    if (pText[index + 1] == L'\n') {
+		EagleCountLine(pState, index + 1);
+
+		if ((length - index) == 2)
+		    pState->incomplete = TRUE;
+
+		if ((mask & CHAR_TYPE_SPACE) == CHAR_TYPE_SPACE) {
+		    if (pBuffer->count == originalTokens)
+			goto finishToken;
+
+		    break;
+		}
+	    }
+
+	    token.type = EAGLE_TOKEN_BACKSLASH;
+
+	    if (!EagleAddToken(pState, &token, ppError))
+		return EAGLE_ERROR;
+
+	    index += token.length;
+	} else {
+	    /*
+	     * This must be a null character, which is just text.
+	     */
+
+	    assert(pText[index] == L'\0');
+
+	    token.type = EAGLE_TOKEN_TEXT;
+	    token.length = 1;
+
+	    if (!EagleAddToken(pState, &token, ppError))
+		return EAGLE_ERROR;
+
+	    index++;
+	}
+    }
+
+    if (nextLine && EagleCountLine(pState, index))
+	nextLine = FALSE;
+
+    if (pBuffer->count != originalTokens)
+	goto afterFinishToken;
+
+    EagleInitToken(pState, &token);
+    token.start = index;
+
+finishToken:
+    token.type = EAGLE_TOKEN_TEXT;
+    token.length = 0;
+
+    if (!EagleAddToken(pState, &token, ppError))
+	return EAGLE_ERROR;
+
+afterFinishToken:
+    pState->terminator = index;
+
+    return EAGLE_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleParseQuotedString --
+ *
+ *	Parses a word enclosed in quotes, starting at the open quote.  This
+ *	is the same as the managed Parser.ParseQuotedString method.
+ *
+ * Results:
+ *	A standard Eagle return code.  Records at pTerminator the offset of
+ *	the character just after the close quote.
+ *
+ * Side effects:
+ *	The parse state is modified.  Memory may be allocated.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static RETURNCODE
+EagleParseQuotedString(
+    LPPARSE_STATE pState,	/* The parse state. */
+    SIZE_T startIndex,		/* Offset of the open quote. */
+    LPSIZE_T pTerminator,	/* OUT: Offset after the close quote. */
+    LPCWSTR *ppError)		/* The error message, if any. */
+{
+    if (EagleParseTokens(pState, startIndex + 1, CHAR_TYPE_QUOTE,
+	    ppError) != EAGLE_OK) {
+	return EAGLE_ERROR;
+    }
+
+    if ((pState->terminator >= pState->length) ||
+	    (pState->pText[pState->terminator] != L'"')) {
+	pState->terminator = startIndex;
+	pState->incomplete = TRUE;
+
+	*ppError = EaglePrintf(0, UNICODIFY("missing \""));
+	return EAGLE_ERROR;
+    }
+
+    *pTerminator = pState->terminator + 1;
+
+    return EAGLE_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleParseCommand --
+ *
+ *	Parses the next command, including any comments that precede it.
+ *	This is the same as the managed Parser.ParseCommand method.  Any
+ *	tokens from the previous command parsed using the same parse state
+ *	are discarded first.
+ *
+ * Results:
+ *	A standard Eagle return code.
+ *
+ * Side effects:
+ *	The parse state is modified.  Memory may be allocated.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static RETURNCODE
+EagleParseCommand(
+    LPPARSE_STATE pState,	/* The parse state. */
+    SIZE_T startIndex,		/* Offset of the first character. */
+    BOOL nested,		/* Non-zero if the command is within a
+				 * command substitution. */
+    LPCWSTR *ppError)		/* The error message, if any. */
+{
+    LPCWSTR pText = pState->pText;
+    SIZE_T length = pState->length;
+    LPTOKEN_BUFFER pBuffer = pState->pBuffer;
+    SIZE_T index, scanned, terminator;
+    INT terminators;
+
+    pState->lineStart = EAGLE_PARSE_INVALID_INDEX;
+    pState->commentStart = EAGLE_PARSE_INVALID_INDEX;
+    pState->commentLength = 0;
+    pState->commandStart = EAGLE_PARSE_INVALID_INDEX;
+    pState->commandLength = 0;
+    pState->commandWords = 0;
+    pState->terminator = length;
+    pState->incomplete = FALSE;
+
+    pBuffer->count = pState->firstToken;
+
+    terminators = nested ? (CHAR_TYPE_COMMAND_TERMINATOR |
+	CHAR_TYPE_CLOSE_BRACKET) : CHAR_TYPE_COMMAND_TERMINATOR;
+
+    index = startIndex + EagleParseComment(pState, startIndex);
+
+    if ((index >= length) && nested)
+	pState->incomplete = TRUE;
+
+    pState->commandStart = index;
+
+    while (1) {
+	SIZE_T wordIndex = pBuffer->count;
+	LPSCRIPT_TOKEN pWord;
+	SCRIPT_TOKEN token;
+	INT charType = CHAR_TYPE_NONE;
+
+	EagleInitToken(pState, &token);
+	token.type = EAGLE_TOKEN_WORD;
+
+	index += EagleParseWhiteSpace(pState, index, &charType);
+
+	if (index >= length) {
+	    pState->terminator = index;
 	    break;
-	case L'f':
-	    result = L'\f';
+	}
+
+	if ((charType & terminators) != 0) {
+	    pState->terminator = index;
+	    index++;
 	    break;
-	case L'n':
-	    result = L'\n';
+	}
+
+	token.start = index;
+
+	if (!EagleAddToken(pState, &token, ppError))
+	    goto error;
+
+	pState->commandWords++;
+
+	if (pText[index] == L'"') {
+	    if (EagleParseQuotedString(pState, index, &terminator,
+		    ppError) != EAGLE_OK) {
+		goto error;
+	    }
+
+	    index = terminator;
+	} else if (pText[index] == L'{') {
+	    if (EagleParseBraces(pState, index, &terminator,
+		    ppError) != EAGLE_OK) {
+		goto error;
+	    }
+
+	    index = terminator;
+	} else {
+	    if (EagleParseTokens(pState, index, CHAR_TYPE_SPACE |
+		    terminators, ppError) != EAGLE_OK) {
+		goto error;
+	    }
+
+	    index = pState->terminator;
+	}
+
+	pWord = &pBuffer->pTokens[wordIndex];
+	pWord->length = index - pWord->start;
+	pWord->components = pBuffer->count - (wordIndex + 1);
+
+	if ((pWord->components == 1) &&
+		(pBuffer->pTokens[wordIndex + 1].type == EAGLE_TOKEN_TEXT)) {
+	    pWord->type = EAGLE_TOKEN_SIMPLE_WORD;
+	}
+
+	scanned = EagleParseWhiteSpace(pState, index, &charType);
+
+	if (scanned > 0) {
+	    index += scanned;
+	    continue;
+	}
+
+	if (index >= length) {
+	    pState->terminator = index;
 	    break;
-	case L'r':
-	    result = L'\r';
+	}
+
+	if ((charType & terminators) != 0) {
+	    pState->terminator = index;
+	    index++;
 	    break;
-	case L't':
-	    result = L'\t';
+	}
+
+	if (pText[index - 1] == L'"') {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("extra characters after close-quote"));
+	} else {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("extra characters after close-brace"));
+	}
+
+	pState->terminator = index;
+	goto error;
+    }
+
+    pState->commandLength = index - pState->commandStart;
+
+    return EAGLE_OK;
+
+error:
+    if (pState->commandStart == EAGLE_PARSE_INVALID_INDEX)
+	pState->commandStart = 0;
+
+    pState->commandLength = length - pState->commandStart;
+
+    return EAGLE_ERROR;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_GetVersion --
+ *
+ *	This function returns the string representation of the version of
+ *	this library.
+ *
+ * Results:
+ *	The string representation of the version of this library -OR- NULL if
+ *	the version cannot be obtained.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+LPCWSTR
+Eagle_GetVersion(VOID)
+{
+    SIZE_T size = (LIBRARY_VERSION_LENGTH + 1 /* NUL */) * sizeof(WCHAR);
+    LPWSTR pBuffer = AllocateMemoryWrapper(size); /* HACK: Always calloc(). */
+
+    if (pBuffer == NULL) {
+	return NULL;
+    }
+
+    EagleFormat(pBuffer, LIBRARY_VERSION_LENGTH, LIBRARY_VERSION_FORMAT,
+	LIBRARY_UNICODE_NAME, LIBRARY_UNICODE_PATCH_LEVEL,
+	LIBRARY_UNICODE_SOURCE_ID, LIBRARY_UNICODE_SOURCE_TIMESTAMP,
+#if defined(_DEBUG)
+	UNICODIFY(" DEBUG"),
+#else
+	UNICODIFY(" RELEASE"),
+#endif
+	UNICODIFY(" SIZE_OF_WCHAR_T="), (int)sizeof(WCHAR),
+	UNICODIFY(" SIZE_OF_SIZE_T="), (int)sizeof(SIZE_T),
+#if defined(USE_32BIT_SIZE_T)
+	UNICODIFY(" USE_32BIT_SIZE_T=") UNICODIFY(STRINGIFY(USE_32BIT_SIZE_T)),
+#else
+	UNICODIFY(""),
+#endif
+#if defined(USE_SYSSTRINGLEN)
+	UNICODIFY(" USE_SYSSTRINGLEN=") UNICODIFY(STRINGIFY(USE_SYSSTRINGLEN)),
+#else
+	UNICODIFY(""),
+#endif
+#if defined(USE_HEAPAPI)
+	UNICODIFY(" USE_HEAPAPI=") UNICODIFY(STRINGIFY(USE_HEAPAPI)),
+#else
+	UNICODIFY(""),
+#endif
+#if defined(USE_POOL_ALLOCATOR)
+	UNICODIFY(" USE_POOL_ALLOCATOR=")
+	    UNICODIFY(STRINGIFY(USE_POOL_ALLOCATOR)),
+#else
+	UNICODIFY(""),
+#endif
+#if defined(USE_PARALLEL_SPLIT)
+	UNICODIFY(" USE_PARALLEL_SPLIT=")
+	    UNICODIFY(STRINGIFY(USE_PARALLEL_SPLIT)),
+#else
+	UNICODIFY(""),
+#endif
+#if defined(USE_SIMD_SCAN)
+	UNICODIFY(" USE_SIMD_SCAN=") UNICODIFY(STRINGIFY(USE_SIMD_SCAN))
+#else
+	UNICODIFY("")
+#endif
+    );
+
+    return pBuffer;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_FreeVersion --
+ *
+ *	This function frees the string representation of the version of
+ *	this library.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+VOID
+Eagle_FreeVersion(
+    LPVOID pVersion)	/* The memory block to free.  This memory block must
+			 * have been obtained from Eagle_GetVersion. */
+{
+    if (pVersion == NULL)
+	return;
+
+    FreeMemoryWrapper(pVersion); /* HACK: Always free(). */
+}
+
+#if defined(USE_HEAPAPI) && USE_HEAPAPI
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_SetMemoryHeap --
+ *
+ *	This function sets or resets the memory heap handle to use when
+ *	allocating and freeing memory.  This function is only available
+ *	when using the Win32 API.  This function is not thread-safe and
+ *	it should only be used when no other threads can call into this
+ *	library.
+ *
+ * Results:
+ *	The previous value of the memory heap handle -OR- NULL if it was
+ *	not previously set.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+HANDLE
+Eagle_SetMemoryHeap(
+    HANDLE hNewHeap)	/* The memory heap handle to use when allocating
+			 * or freeing memory. */
+{
+    HANDLE hOldHeap = hMemoryHeap;
+
+    assert((hOldHeap == NULL) || HeapValidate(hOldHeap, 0, NULL));
+    assert((hNewHeap == NULL) || HeapValidate(hNewHeap, 0, NULL));
+    assert(memoryBytesAllocated == 0);
+
+    hMemoryHeap = hNewHeap;
+
+    return hOldHeap;
+}
+#endif
+
+#if defined(USE_POOL_ALLOCATOR) && USE_POOL_ALLOCATOR
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_SetMemoryPool --
+ *
+ *	This function enables or disables private mode for the shared pool
+ *	of free memory blocks.  In private mode, free memory blocks are not
+ *	returned to the C runtime library until the Eagle_CompactMemoryPool
+ *	function is called.  Disabling private mode frees all the memory
+ *	blocks kept by the shared pool.  This function is only available
+ *	when using the pooled memory allocator.
+ *
+ * Results:
+ *	The previous value of the private mode flag.
+ *
+ * Side effects:
+ *	Memory may be freed.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+BOOL
+Eagle_SetMemoryPool(
+    BOOL bPrivate)	/* Non-zero to enable private mode. */
+{
+    BOOL bOldPrivate;
+
+    pthread_mutex_lock(&poolMutex);
+    bOldPrivate = poolPrivate;
+    poolPrivate = bPrivate;
+    pthread_mutex_unlock(&poolMutex);
+
+    if (!bPrivate)
+	EagleReleasePool();
+
+    return bOldPrivate;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_CompactMemoryPool --
+ *
+ *	This function frees all the memory blocks kept by the shared pool
+ *	and by the per-thread cache of the calling thread.  The per-thread
+ *	caches of other threads are bounded and they are moved into the
+ *	shared pool when those threads exit.  This function is only
+ *	available when using the pooled memory allocator.
+ *
+ * Results:
+ *	The number of bytes that were freed.
+ *
+ * Side effects:
+ *	Memory may be freed.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+SIZE_T
+Eagle_CompactMemoryPool(VOID)
+{
+    SIZE_T size = EagleReleasePool();
+
+    LIBRARY_DEBUG(("Eagle_CompactMemoryPool: freed %d bytes\n",
+	(int)size));
+
+    return size;
+}
+#endif
+
+#if defined(USE_PARALLEL_SPLIT) && USE_PARALLEL_SPLIT
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_GetSplitOptions --
+ *
+ *	This function queries the options used by Eagle_SplitList for very
+ *	large lists.  See Eagle_SetSplitOptions.  This function is only
+ *	available when splitting lists using more than one thread is
+ *	supported.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	The split options may be loaded from the environment.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+VOID
+Eagle_GetSplitOptions(
+    LPSIZE_T pThreshold,	/* OUT: The minimum list length, in
+				 * characters, to use more than one
+				 * thread for -OR- zero if disabled. */
+    LPSIZE_T pThreadCount)	/* OUT: The maximum number of threads -OR-
+				 * zero for one per processor. */
+{
+    pthread_once(&splitOptionsOnce, EagleLoadSplitOptions);
+
+    if (pThreshold != NULL)
+	*pThreshold = splitThreshold;
+
+    if (pThreadCount != NULL)
+	*pThreadCount = splitThreadCount;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_SetSplitOptions --
+ *
+ *	This function changes the options used by Eagle_SplitList for very
+ *	large lists.  Lists with at least the threshold number of characters
+ *	are cut into chunks, each of which is split by its own thread.  The
+ *	initial values come from the "SplitThresholdSpilornis" and
+ *	"SplitThreadsSpilornis" environment variables, if they are set.
+ *	This function is only available when splitting lists using more
+ *	than one thread is supported.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	The split options are changed.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+VOID
+Eagle_SetSplitOptions(
+    SIZE_T threshold,		/* The minimum list length, in characters,
+				 * to use more than one thread for -OR-
+				 * zero to disable. */
+    SIZE_T threadCount)		/* The maximum number of threads -OR- zero
+				 * for one per processor. */
+{
+    pthread_once(&splitOptionsOnce, EagleLoadSplitOptions);
+
+    splitThreshold = threshold;
+    splitThreadCount = threadCount;
+}
+#endif
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_AllocateMemory --
+ *
+ *	This function allocates a block of memory of at least the specified
+ *	size.  The memory is zeroed.
+ *
+ * Results:
+ *	The pointer to the new memory block -OR- NULL if the memory could not
+ *	be obtained.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+LPVOID
+Eagle_AllocateMemory(
+    SIZE_T size)	/* The size, in bytes, of the memory block to be
+			 * allocated. */
+{
+    return EagleAllocateBuffer(size, TRUE, EAGLE_MEMORY_SITE_OTHER);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleGetMemoryBucket --
+ *
+ *	This function determines the histogram bucket used to count memory
+ *	allocations of the specified size.  Bucket N counts the allocations
+ *	larger than 2^(N-1) bytes and no larger than 2^N bytes.
+ *
+ * Results:
+ *	The histogram bucket, from zero to EAGLE_MEMORY_BUCKETS - 1.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static INT
+EagleGetMemoryBucket(
+    SIZE_T size)	/* The size, in bytes, of the memory allocation. */
+{
+    INT bucket = 0;
+
+    while ((bucket < EAGLE_MEMORY_BUCKETS - 1) &&
+	    (((SIZE_T)1 << bucket) < size)) {
+	bucket++;
+    }
+
+    return bucket;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleUpdateMemoryPeak --
+ *
+ *	This function raises the peak number of bytes allocated, if the
+ *	specified total exceeds it.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static VOID
+EagleUpdateMemoryPeak(
+    SIZE_T total)	/* The number of bytes currently allocated. */
+{
+    SIZE_T peak = memoryBytesPeak;
+
+    while (total > peak) {
+	SIZE_T oldPeak = AtomicCompareExchangeWrapper(
+	    &memoryBytesPeak, total, peak);
+
+	if (oldPeak == peak)
 	    break;
-	case L'v':
-	    result = L'\v';
+
+	peak = oldPeak;
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleAllocateBuffer --
+ *
+ *	This function allocates a block of memory of at least the specified
+ *	size, which may be freed by the Eagle_FreeMemory function.  Unless
+ *	requested, the memory is not zeroed; therefore, it should only be
+ *	used when the caller overwrites all of the memory it reads.
+ *
+ * Results:
+ *	The pointer to the new memory block -OR- NULL if the memory could not
+ *	be obtained.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static LPVOID
+EagleAllocateBuffer(
+    SIZE_T size,	/* The size, in bytes, of the memory block to be
+			 * allocated. */
+    BOOL zero,		/* Non-zero if the memory block must be zeroed. */
+    INT site)		/* The call site, for the memory statistics.  This
+			 * must be one of the EAGLE_MEMORY_SITE_* values. */
+{
+    LPVOID pMemory = NULL;
+    SIZE_T memorySize;
+    SIZE_T total;
+
+    assert(sizeof(BYTE) >= 1);
+    assert(size >= 0);
+
+    if (size > 0) {
+	assert(size <= LIBRARY_MAXIMUM_SIZE_T);
+	pMemory = EagleAllocateMemory(size, zero);
+    }
+
+    memorySize = EagleMemorySize(pMemory);
+
+    if (pMemory != NULL) {
+#if !defined(NDEBUG)
+	if (!zero)
+	    memset(pMemory, LIBRARY_UNINITIALIZED_MEMORY, size);
+#endif
+
+	total = AtomicAddWrapper(&memoryBytesAllocated, memorySize);
+	EagleUpdateMemoryPeak(total);
+
+	assert((site >= 0) && (site < EAGLE_MEMORY_SITES));
+	AtomicAddWrapper(&memoryAllocationCount, 1);
+	AtomicAddWrapper(&memorySiteAllocations[site], 1);
+	AtomicAddWrapper(
+	    &memoryHistogram[site][EagleGetMemoryBucket(size)], 1);
+
+	LIBRARY_DEBUG(("Eagle_AllocateMemory: 0x%p, requested %d bytes, "
+	    "received %d bytes, total now %d bytes\n", pMemory, (int)size,
+	    (int)memorySize, (int)total));
+    } else {
+	LIBRARY_TRACE(("Eagle_AllocateMemory: out of memory (%d)\n",
+	    (int)size));
+    }
+
+    return pMemory;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_FreeMemory --
+ *
+ *	This function frees a block of memory that was previously allocated
+ *	by the Eagle_AllocateMemory function.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+VOID
+Eagle_FreeMemory(
+    LPVOID pMemory)	/* The memory block to free.  This memory block must
+			 * have been obtained from Eagle_AllocateMemory. */
+{
+    SIZE_T size;
+
+    if (pMemory == NULL)
+	return;
+
+    size = EagleMemorySize(pMemory);
+
+#if !defined(NDEBUG)
+    memset(pMemory, LIBRARY_FREED_MEMORY, size);
+#endif
+
+    AtomicSubtractWrapper(&memoryBytesAllocated, size);
+    AtomicAddWrapper(&memoryFreeCount, 1);
+
+    LIBRARY_DEBUG(("Eagle_FreeMemory: 0x%p, received %d bytes, total now "
+	"%d bytes\n", pMemory, (int)size, (int)memoryBytesAllocated));
+
+    EagleFreeMemory(pMemory);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_GetMemoryStatistics --
+ *
+ *	This function copies the memory statistics for this library into
+ *	the structure provided by the caller.  No memory is allocated, so
+ *	this function is cheap enough to be called frequently.
+ *
+ * Results:
+ *	The return value is normally EAGLE_OK.  If EAGLE_ERROR is returned,
+ *	it means the structure size does not match the one expected by
+ *	this library; in that case, the error message will contain more
+ *	details.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+RETURNCODE
+Eagle_GetMemoryStatistics(
+    SIZE_T size,		/* The size, in bytes, of the structure. */
+    LPMEMORY_STATISTICS pStatistics,
+				/* OUT: The memory statistics. */
+    LPCWSTR *ppError)		/* OUT: The error message, if any. */
+{
+    INT site;
+    INT bucket;
+
+    assert(ppError != NULL);
+
+    if ((pStatistics == NULL) || (size != sizeof(MEMORY_STATISTICS))) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("memory statistics size mismatch, have %zu, ")
+		UNICODIFY("need %zu"), size,
+		(SIZE_T)sizeof(MEMORY_STATISTICS));
+	}
+	return EAGLE_ERROR;
+    }
+
+    pStatistics->currentBytes = memoryBytesAllocated;
+    pStatistics->peakBytes = memoryBytesPeak;
+    pStatistics->allocationCount = memoryAllocationCount;
+    pStatistics->freeCount = memoryFreeCount;
+
+    for (site = 0; site < EAGLE_MEMORY_SITES; site++) {
+	pStatistics->siteAllocations[site] = memorySiteAllocations[site];
+
+	for (bucket = 0; bucket < EAGLE_MEMORY_BUCKETS; bucket++) {
+	    pStatistics->histogram[site][bucket] =
+		memoryHistogram[site][bucket];
+	}
+    }
+
+    return EAGLE_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_FreeElements --
+ *
+ *	This function frees all memory that is being used to contain the
+ *	array of list elements that was allocated by the Eagle_SplitList
+ *	function.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+VOID
+Eagle_FreeElements(
+    SIZE_T elementCount,	/* The number of list elements. */
+    LPWSTR *ppElements)		/* The list element array to free. */
+{
+    /*
+     * NOTE: The space to hold the element pointers as well as the element
+     *       strings themselves is actually one big block; therefore, just
+     *       call the normal memory freeing function on it.
+     */
+
+    Eagle_FreeMemory(ppElements);
+}
+
+#if defined(USE_PARALLEL_SPLIT) && USE_PARALLEL_SPLIT
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleGetEnvironmentSize --
+ *
+ *	Queries the value of an environment variable that should contain a
+ *	non-negative decimal integer.
+ *
+ * Results:
+ *	The integer value of the environment variable -OR- the default value
+ *	if it is not set or is not a valid integer.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleGetEnvironmentSize(
+    LPCSTR name,		/* The name of the environment variable. */
+    SIZE_T defaultValue)	/* The value to use if it is not usable. */
+{
+    LPCSTR value = getenv(name); /* POSIX */
+    SIZE_T result = 0;
+
+    if ((value == NULL) || (*value == '\0'))
+	return defaultValue;
+
+    for (; *value != '\0'; value++) {
+	if ((*value < '0') || (*value > '9'))
+	    return defaultValue;
+
+	if (result > (LIBRARY_MAXIMUM_SIZE_T - (*value - '0')) / 10)
+	    return defaultValue;
+
+	result = (result * 10) + (*value - '0');
+    }
+
+    return result;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleLoadSplitOptions --
+ *
+ *	Loads the options used when splitting very large lists from the
+ *	environment.  This function is called only once, via pthread_once.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	The split threshold and thread count may be changed.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static VOID
+EagleLoadSplitOptions(VOID)
+{
+    splitThreshold = EagleGetEnvironmentSize(SPLIT_THRESHOLD_VAR_NAME,
+	LIBRARY_SPLIT_THRESHOLD);
+
+    splitThreadCount = EagleGetEnvironmentSize(SPLIT_THREADS_VAR_NAME, 0);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleGetThreadCount --
+ *
+ *	Determines the maximum number of threads that should be used to
+ *	split, or sort, one very large list.  The split options must have
+ *	already been loaded.
+ *
+ * Results:
+ *	The configured number of threads -OR- the number of processors if
+ *	that was not configured.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleGetThreadCount(VOID)
+{
+    SIZE_T threadCount = splitThreadCount;
+
+    if (threadCount == 0) {
+	long processorCount = sysconf(_SC_NPROCESSORS_ONLN);
+
+	threadCount = (processorCount > 0) ? (SIZE_T)processorCount : 1;
+    }
+
+    if (threadCount > LIBRARY_SPLIT_MAXIMUM_THREADS)
+	threadCount = LIBRARY_SPLIT_MAXIMUM_THREADS;
+
+    return threadCount;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleGetSplitChunkCount --
+ *
+ *	Determines how many threads should be used to split a list with the
+ *	specified length.
+ *
+ * Results:
+ *	The number of chunks (i.e. threads) to use -OR- one if the list should
+ *	only be split by the calling thread.
+ *
+ * Side effects:
+ *	The split options may be loaded from the environment.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleGetSplitChunkCount(
+    SIZE_T length)		/* Length of string with list structure. */
+{
+    SIZE_T threshold, threadCount, chunkSize;
+
+    pthread_once(&splitOptionsOnce, EagleLoadSplitOptions);
+
+    threshold = splitThreshold;
+
+    if ((threshold == 0) || (length < threshold))
+	return 1;
+
+    threadCount = EagleGetThreadCount();
+
+    chunkSize = (threshold < LIBRARY_SPLIT_MINIMUM_CHUNK) ?
+	threshold : LIBRARY_SPLIT_MINIMUM_CHUNK;
+
+    if (threadCount > length / chunkSize)
+	threadCount = length / chunkSize;
+
+    return (threadCount > 1) ? threadCount : 1;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleFindSplitStart --
+ *
+ *	Finds the first position, at or after the specified offset, that may
+ *	be the start of a list element, i.e. the first character that is
+ *	not whitespace following a run of whitespace.  There is no way to
+ *	be sure without parsing the list from its start (e.g. the position
+ *	may be inside of braces); the caller must verify it later.
+ *
+ * Results:
+ *	The offset of the possible element start -OR- length if there is
+ *	none.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleFindSplitStart(
+    LPCWSTR pText,		/* Pointer to string with list structure. */
+    SIZE_T length,		/* Length of string with list structure. */
+    SIZE_T offset)		/* Offset to start looking from. */
+{
+    while ((offset < length) &&
+	    !iswspace(pText[offset])) { /* INTL: ISO space. */
+	offset++;
+    }
+    while ((offset < length) &&
+	    iswspace(pText[offset])) { /* INTL: ISO space. */
+	offset++;
+    }
+    return offset;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleSplitChunk --
+ *
+ *	Splits one chunk of a very large list, starting at its (assumed)
+ *	element start and stopping at the first element that starts at or
+ *	after the start of the next chunk.  Each element is copied to the
+ *	same offset within the result text that it had within the list;
+ *	therefore, only elements that fit before the start of the next
+ *	chunk are copied.  When counting, the number of whitespace runs in
+ *	the chunk is used to determine how many elements it can hold.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	The chunk is updated.  The error message, if any, must be freed by
+ *	the caller.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static VOID
+EagleSplitChunk(
+    LPSPLIT_CHUNK pChunk)	/* The chunk to split. */
+{
+    LPCWSTR pText = pChunk->pText;
+    LPCWSTR element, next;
+    LPWSTR dst;
+    SIZE_T offset, elSize;
+    BOOL literal;
+
+    if (pChunk->counting) {
+	SIZE_T end = (pChunk->limit < pChunk->length) ?
+	    pChunk->limit : pChunk->length;
+
+	pChunk->capacity = 1 + EagleCountSpaceRuns(pText + pChunk->start,
+	    end - pChunk->start);
+
+	return;
+    }
+
+    offset = pChunk->start;
+    pChunk->count = 0;
+
+    while ((offset < pChunk->length) && (offset < pChunk->limit)) {
+	if (pChunk->count >= pChunk->capacity) {
+	    pChunk->failed = TRUE;
 	    break;
-	case L'\\': /* COMPAT: Eagle only. */
-	    result = L'\\';
+	}
+	if (EagleFindElement(pText + offset, pChunk->length - offset,
+		&element, &next, &elSize, NULL, &literal,
+		&pChunk->pError) != EAGLE_OK) {
+	    pChunk->failed = TRUE;
 	    break;
-	case L'B':  /* COMPAT: Eagle only. */
-	    count += EagleParseBin(p + 1, numChars - 2, &result);
-	    if (count == 2) {
-		/* No digits -> This is just "B". */
-		result = L'B';
-	    } else {
-		/* Keep only the last byte (8 bin digits) */
-		result = (BYTE)result;
+	}
+	if (offset + elSize >= pChunk->limit) {
+	    break; /* NOTE: Element crosses into the next chunk. */
+	}
+	dst = pChunk->pBuffer + offset;
+	if (literal) {
+	    memcpy(dst, element, elSize * sizeof(WCHAR));
+	} else {
+	    elSize = EagleCopyAndCollapse(elSize, element, dst);
+	}
+	dst[elSize] = 0;
+	pChunk->pLengths[pChunk->count] = elSize;
+	pChunk->ppElements[pChunk->count] = dst;
+	pChunk->count++;
+	offset = (SIZE_T)(next - pText);
+    }
+
+    pChunk->next = offset;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleSplitChunkThread --
+ *
+ *	The thread start routine used to split one chunk of a very large
+ *	list.
+ *
+ * Results:
+ *	Always NULL.
+ *
+ * Side effects:
+ *	See EagleSplitChunk.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static LPVOID
+EagleSplitChunkThread(
+    LPVOID pData)		/* The chunk to split. */
+{
+    EagleSplitChunk((LPSPLIT_CHUNK)pData);
+    return NULL;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleRunSplitChunks --
+ *
+ *	Splits all the chunks of a very large list, each using its own
+ *	thread.  The first chunk is split by the calling thread.  If a
+ *	thread cannot be created, its chunk is split by the calling thread
+ *	as well.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Threads are created and waited upon.  See EagleSplitChunk.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static VOID
+EagleRunSplitChunks(
+    LPSPLIT_CHUNK pChunks,	/* The chunks to split. */
+    SIZE_T chunkCount)		/* The number of chunks. */
+{
+    pthread_t threads[LIBRARY_SPLIT_MAXIMUM_THREADS];
+    BOOL started[LIBRARY_SPLIT_MAXIMUM_THREADS];
+    SIZE_T index;
+
+    assert(chunkCount <= LIBRARY_SPLIT_MAXIMUM_THREADS);
+
+    for (index = 1; index < chunkCount; index++) {
+	started[index] = (pthread_create(&threads[index], NULL,
+	    EagleSplitChunkThread, &pChunks[index]) == 0);
+    }
+
+    EagleSplitChunk(&pChunks[0]);
+
+    for (index = 1; index < chunkCount; index++) {
+	if (started[index]) {
+	    pthread_join(threads[index], NULL);
+	} else {
+	    EagleSplitChunk(&pChunks[index]);
+	}
+    }
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleGetSortChunkCount --
+ *
+ *	Determines how many threads should be used to sort a list with the
+ *	specified number of elements.
+ *
+ * Results:
+ *	The number of chunks (i.e. threads) to use -OR- one if the list should
+ *	only be sorted by the calling thread.
+ *
+ * Side effects:
+ *	The split options may be loaded from the environment.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+EagleGetSortChunkCount(
+    SIZE_T elementCount)	/* The number of list elements. */
+{
+    SIZE_T threadCount;
+
+    if (elementCount < LIBRARY_SORT_THRESHOLD)
+	return 1;
+
+    pthread_once(&splitOptionsOnce, EagleLoadSplitOptions);
+
+    threadCount = EagleGetThreadCount();
+
+    if (threadCount > elementCount / LIBRARY_SORT_MINIMUM_CHUNK)
+	threadCount = elementCount / LIBRARY_SORT_MINIMUM_CHUNK;
+
+    return (threadCount > 1) ? threadCount : 1;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleSortTaskThread --
+ *
+ *	The thread start routine used to sort, or merge, one range of the
+ *	elements of a very large list.
+ *
+ * Results:
+ *	Always NULL.
+ *
+ * Side effects:
+ *	See EagleSortTask.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static LPVOID
+EagleSortTaskThread(
+    LPVOID pData)		/* The range to sort or merge. */
+{
+    EagleSortTask((LPSORT_TASK)pData);
+    return NULL;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleAddSplitFixup --
+ *
+ *	Adds an element, found while stitching the chunks of a very large
+ *	list back together, to the list of pending elements.
+ *
+ * Results:
+ *	Non-zero upon success -OR- zero if out of memory.
+ *
+ * Side effects:
+ *	Memory may be allocated and freed.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static BOOL
+EagleAddSplitFixup(
+    LPSPLIT_FIXUP pFixup,	/* The pending elements. */
+    SIZE_T elementLength,	/* The string length of the element. */
+    LPWSTR pElement)		/* The element. */
+{
+    if (pFixup->count >= pFixup->capacity) {
+	SIZE_T newCapacity = (pFixup->capacity > 0) ?
+	    pFixup->capacity * 2 : LIBRARY_SPLIT_FIXUP_SIZE;
+	LPSIZE_T pLengths;
+	LPWSTR *ppElements;
+
+	pLengths = EagleAllocateBuffer(newCapacity * sizeof(SIZE_T),
+	    FALSE, EAGLE_MEMORY_SITE_SPLIT);
+	if (pLengths == NULL) {
+	    return FALSE;
+	}
+	ppElements = EagleAllocateBuffer(newCapacity * sizeof(LPWSTR),
+	    FALSE, EAGLE_MEMORY_SITE_SPLIT);
+	if (ppElements == NULL) {
+	    Eagle_FreeMemory(pLengths);
+	    return FALSE;
+	}
+	if (pFixup->count > 0) {
+	    memcpy(pLengths, pFixup->pLengths,
+		pFixup->count * sizeof(SIZE_T));
+	    memcpy(ppElements, pFixup->ppElements,
+		pFixup->count * sizeof(LPWSTR));
+	}
+	Eagle_FreeMemory(pFixup->pLengths);
+	Eagle_FreeMemory(pFixup->ppElements);
+	pFixup->pLengths = pLengths;
+	pFixup->ppElements = ppElements;
+	pFixup->capacity = newCapacity;
+    }
+
+    pFixup->pLengths[pFixup->count] = elementLength;
+    pFixup->ppElements[pFixup->count] = pElement;
+    pFixup->count++;
+
+    return TRUE;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * EagleSplitListParallel --
+ *
+ *	Splits a very large list up into its constituent elements, using
+ *	more than one thread.  The list is cut into chunks at positions that
+ *	are likely to be element starts and each chunk is split by its own
+ *	thread.  Then, starting with the first chunk (which is known to be
+ *	correct), the elements are stitched back together: any elements
+ *	between the end of one chunk and the first element of the next chunk
+ *	that agrees with it (i.e. one starting at the same offset) are split
+ *	by the calling thread; after that, all the elements of the next chunk
+ *	must be correct.  In the worst case (e.g. one huge element in braces),
+ *	this degrades into splitting the list using only the calling thread.
+ *	The results are the same as those from Eagle_SplitList, except that
+ *	the text of each element is at the same offset within the result text
+ *	that it had within the list.
+ *
+ * Results
+ *	A standard Eagle return code.
+ *
+ * Side effects:
+ *	Memory is allocated and possibly freed.  Threads are created and
+ *	waited upon.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static RETURNCODE
+EagleSplitListParallel(
+    SIZE_T length,		/* Length of string with list structure. */
+    LPCWSTR pText,		/* Pointer to string with list structure. */
+    SIZE_T chunkCount,		/* The maximum number of chunks to use. */
+    LPSIZE_T pElementCount,	/* The number of list elements found. */
+    LPSIZE_T *ppElementLengths,	/* The string lengths of the list elements. */
+    LPCWSTR **pppElements,	/* The array of list elements. */
+    LPCWSTR *ppError)		/* The error message, if any. */
+{
+    LPSPLIT_CHUNK pChunks, pChunk;
+    SPLIT_FIXUP fixup;
+    LPCWSTR element, next;
+    LPSIZE_T argc = NULL;
+    LPWSTR *argv = NULL;
+    LPWSTR pBuffer, dst;
+    SIZE_T allocSize, size, start, offset, elSize;
+    SIZE_T count, index, cursor, keepCount, outIndex;
+    BOOL literal;
+    RETURNCODE result = EAGLE_ERROR;
+
+    assert(chunkCount > 1);
+    assert(chunkCount <= LIBRARY_SPLIT_MAXIMUM_THREADS);
+
+    /*
+     * NOTE: Make sure the instruction set level is detected before any of
+     *       the threads need it.
+     */
+
+    EagleGetScanLevel();
+
+    allocSize = chunkCount * sizeof(SPLIT_CHUNK);
+    pChunks = EagleAllocateScratch(allocSize, EAGLE_MEMORY_SITE_SPLIT);
+    if (pChunks == NULL) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("out of memory for list chunks (%zu)"),
+		allocSize);
+	}
+	return EAGLE_ERROR;
+    }
+    memset(pChunks, 0, allocSize);
+    memset(&fixup, 0, sizeof(SPLIT_FIXUP));
+
+    /*
+     * Pick the (assumed) element start for each chunk, at roughly equal
+     * intervals.  The first chunk starts with the first element.
+     */
+
+    start = 0;
+    while ((start < length) && iswspace(pText[start])) { /* INTL: ISO space. */
+	start++;
+    }
+    for (count = 0, index = 0; index < chunkCount; index++) {
+	if (index > 0) {
+	    start = EagleFindSplitStart(pText, length,
+		index * (length / chunkCount));
+	    if ((start >= length) || (start <= pChunks[count - 1].start)) {
+		continue;
+	    }
+	}
+	pChunk = &pChunks[count++];
+	pChunk->pText = pText;
+	pChunk->length = length;
+	pChunk->start = start;
+	pChunk->counting = TRUE;
+    }
+    for (index = 0; index < count; index++) {
+	pChunks[index].limit = (index + 1 < count) ?
+	    pChunks[index + 1].start : length + 1;
+    }
+
+    /*
+     * Figure out how much space to allocate, using the same estimate as
+     * Eagle_SplitList, for each chunk.
+     */
+
+    EagleRunSplitChunks(pChunks, count);
+
+    size = 2;
+    for (index = 0; index < count; index++) {
+	size += pChunks[index].capacity;
+    }
+    allocSize = size * sizeof(SIZE_T);
+    assert(allocSize > 0);
+    assert(allocSize <= LIBRARY_MAXIMUM_SIZE_T);
+    argc = EagleAllocateBuffer(allocSize, FALSE,
+	EAGLE_MEMORY_SITE_SPLIT);
+    if (argc == NULL) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("out of memory for list element lengths (%zu)"),
+		allocSize);
+	}
+	goto done;
+    }
+    allocSize = (size * sizeof(LPWSTR)) + ((length + 1) * sizeof(WCHAR));
+    assert(allocSize > 0);
+    assert(allocSize <= LIBRARY_MAXIMUM_SIZE_T);
+    argv = EagleAllocateBuffer(allocSize, FALSE,
+	EAGLE_MEMORY_SITE_SPLIT);
+    if (argv == NULL) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("out of memory for list element pointers (%zu)"),
+		allocSize);
+	}
+	goto done;
+    }
+
+    /*
+     * Split all the chunks.  Each chunk has its own range of slots in the
+     * arrays of element lengths and pointers.
+     */
+
+    pBuffer = (LPWSTR)(((LPBYTE)argv) + (size * sizeof(LPWSTR)));
+    for (offset = 0, index = 0; index < count; index++) {
+	pChunk = &pChunks[index];
+	pChunk->pBuffer = pBuffer;
+	pChunk->pLengths = argc + offset;
+	pChunk->ppElements = argv + offset;
+	pChunk->counting = FALSE;
+	offset += pChunk->capacity;
+    }
+
+    EagleRunSplitChunks(pChunks, count);
+
+    /*
+     * Stitch the chunks back together.  The elements of the first chunk
+     * are already in place.  Elements that must be split again are kept
+     * aside until the next chunk that agrees is found, since the slots
+     * they belong in may still be in use by that chunk.  The elements of
+     * each chunk can only move towards the front of the arrays.
+     */
+
+    outIndex = pChunks[0].count;
+    offset = pChunks[0].next;
+    index = 1;
+    cursor = 0;
+
+    while (offset < length) {
+	if (index < count) {
+	    pChunk = &pChunks[index];
+	    if (offset >= pChunk->limit) {
+		index++;
+		cursor = 0;
+		continue;
+	    }
+	    while ((cursor < pChunk->count) &&
+		    ((SIZE_T)(pChunk->ppElements[cursor] - pBuffer) < offset)) {
+		cursor++;
+	    }
+	    if (((cursor < pChunk->count) &&
+		    ((SIZE_T)(pChunk->ppElements[cursor] - pBuffer) == offset)) ||
+		    ((cursor == pChunk->count) && !pChunk->failed &&
+		    (pChunk->next == offset))) {
+		keepCount = pChunk->count - cursor;
+		memmove(argc + outIndex + fixup.count,
+		    pChunk->pLengths + cursor, keepCount * sizeof(SIZE_T));
+		memmove(argv + outIndex + fixup.count,
+		    pChunk->ppElements + cursor, keepCount * sizeof(LPWSTR));
+		if (fixup.count > 0) {
+		    memcpy(argc + outIndex, fixup.pLengths,
+			fixup.count * sizeof(SIZE_T));
+		    memcpy(argv + outIndex, fixup.ppElements,
+			fixup.count * sizeof(LPWSTR));
+		}
+		outIndex += fixup.count + keepCount;
+		fixup.count = 0;
+		offset = pChunk->next;
+		index++;
+		cursor = 0;
+		continue;
+	    }
+	}
+
+	result = EagleFindElement(pText + offset, length - offset, &element,
+				  &next, &elSize, NULL, &literal, ppError);
+	if (result != EAGLE_OK) {
+	    goto done;
+	}
+	dst = pBuffer + offset;
+	if (literal) {
+	    memcpy(dst, element, elSize * sizeof(WCHAR));
+	} else {
+	    elSize = EagleCopyAndCollapse(elSize, element, dst);
+	}
+	dst[elSize] = 0;
+	if (!EagleAddSplitFixup(&fixup, elSize, dst)) {
+	    if (ppError != NULL) {
+		*ppError = EaglePrintf(0,
+		    UNICODIFY("out of memory for list element fixups (%zu)"),
+		    fixup.capacity);
 	    }
+	    result = EAGLE_ERROR;
+	    goto done;
+	}
+	offset = (SIZE_T)(next - pText);
+    }
+
+    if (fixup.count > 0) {
+	memcpy(argc + outIndex, fixup.pLengths,
+	    fixup.count * sizeof(SIZE_T));
+	memcpy(argv + outIndex, fixup.ppElements,
+	    fixup.count * sizeof(LPWSTR));
+	outIndex += fixup.count;
+    }
+
+    assert(outIndex < size);
+    argc[outIndex] = 0;
+    argv[outIndex] = NULL;
+
+    *pElementCount = outIndex;
+    *ppElementLengths = argc;
+    *pppElements = (LPCWSTR *)argv;
+
+    argc = NULL;
+    argv = NULL;
+    result = EAGLE_OK;
+
+done:
+    for (index = 0; index < count; index++) {
+	Eagle_FreeMemory((LPVOID)pChunks[index].pError);
+    }
+    Eagle_FreeMemory(fixup.pLengths);
+    Eagle_FreeMemory(fixup.ppElements);
+    Eagle_FreeMemory(argc);
+    Eagle_FreeMemory(argv);
+    EagleFreeScratch(pChunks);
+
+    return result;
+}
+#endif
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_SplitList --
+ *
+ *	Splits a list up into its constituent elements.
+ *
+ * Results
+ *	The return value is normally EAGLE_OK, which means that the list was
+ *	successfully split up.  If EAGLE_ERROR is returned, it means that
+ *	"list" did not have proper list structure; in that case, the error
+ *	message will contain a more details.
+ *
+ * Side effects:
+ *	Memory is allocated and possibly freed.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+RETURNCODE
+Eagle_SplitList(
+    SIZE_T length,		/* Length of string with list structure. */
+    LPCWSTR pText,		/* Pointer to string with list structure. */
+    LPSIZE_T pElementCount,	/* The number of list elements found. */
+    LPSIZE_T *ppElementLengths,	/* The string lengths of the list elements. */
+    LPCWSTR **pppElements,	/* The array of list elements. */
+    LPCWSTR *ppError)		/* The error message, if any. */
+{
+    LPCWSTR q, element;
+    LPSIZE_T argc;
+    LPWSTR *argv;
+    LPWSTR p;
+    SIZE_T allocSize;
+    SIZE_T listLength, size, i, elSize;
+    BOOL literal;
+    RETURNCODE result;
+
+    assert(length >= 0);
+    assert(pText != NULL);
+    assert(pElementCount != NULL);
+    assert(ppElementLengths != NULL);
+    assert(pppElements != NULL);
+    assert(ppError != NULL);
+
+#if defined(USE_PARALLEL_SPLIT) && USE_PARALLEL_SPLIT
+    /*
+     * Very large lists may be split using more than one thread.
+     */
+
+    size = EagleGetSplitChunkCount(length);
+    if (size > 1) {
+	return EagleSplitListParallel(length, pText, size, pElementCount,
+	    ppElementLengths, pppElements, ppError);
+    }
+#endif
+
+    /*
+     * Figure out how much space to allocate.  There must be enough
+     * space for both the array of pointers and also for a copy of
+     * the list.  To estimate the number of pointers needed, count
+     * the number of runs of space characters in the list, since
+     * consecutive space can only count as a single list delimiter.
+     */
+
+    size = 2 + EagleCountSpaceRuns(pText, length);
+    listLength = length;
+    allocSize = size * sizeof(SIZE_T);
+    assert(allocSize > 0);
+    assert(allocSize <= LIBRARY_MAXIMUM_SIZE_T);
+    argc = EagleAllocateBuffer(allocSize, FALSE,
+	EAGLE_MEMORY_SITE_SPLIT);
+    if (argc == NULL) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("out of memory for list element lengths (%zu)"),
+		allocSize);
+	}
+	return EAGLE_ERROR;
+    }
+    allocSize = (size * sizeof(LPWSTR)) + ((listLength + 1) * sizeof(WCHAR));
+    assert(allocSize > 0);
+    assert(allocSize <= LIBRARY_MAXIMUM_SIZE_T);
+    argv = EagleAllocateBuffer(allocSize, FALSE,
+	EAGLE_MEMORY_SITE_SPLIT);
+    if (argv == NULL) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("out of memory for list element pointers (%zu)"),
+		allocSize);
+	}
+	Eagle_FreeMemory(argc);
+	return EAGLE_ERROR;
+    }
+    q = pText + length;
+    for (i = 0, p = (LPWSTR)(((LPBYTE)argv) + (size * sizeof(LPWSTR)));
+	    listLength > 0; i++) {
+	LPCWSTR prevList = pText;
+
+	result = EagleFindElement(pText, listLength, &element, &pText,
+				  &elSize, NULL, &literal, ppError);
+	if (result != EAGLE_OK) {
+	    Eagle_FreeMemory(argc);
+	    Eagle_FreeMemory(argv);
+	    return result;
+	}
+	listLength -= (SIZE_T)(pText - prevList);
+	if (element == q) {
 	    break;
-	case L'o': /* COMPAT: Eagle only. */
-	    count += EagleParseOct(p + 1, numChars - 2, &result);
-	    if (count == 2) {
-		/* No digits -> This is just "o". */
-		result = L'o';
-	    } else {
-		/* Keep only the last byte (3 oct digits) */
-		result = (BYTE)result;
+	}
+	if (i >= size) {
+	    if (ppError != NULL) {
+		*ppError = EaglePrintf(0,
+		    UNICODIFY("wrong estimated list size"));
 	    }
+	    Eagle_FreeMemory(argc);
+	    Eagle_FreeMemory(argv);
+	    return EAGLE_ERROR;
+	}
+	if (literal) {
+	    memcpy(p, element, elSize * sizeof(WCHAR));
+	} else {
+	    elSize = EagleCopyAndCollapse(elSize, element, p);
+	}
+	p[elSize] = 0;
+	argc[i] = elSize;
+	argv[i] = p;
+	p += elSize + 1;
+    }
+
+    argc[i] = 0;
+    argv[i] = NULL;
+
+    *pElementCount = i;
+    *ppElementLengths = argc;
+    *pppElements = (LPCWSTR *)argv; /* incompatible-pointer-types warning? */
+
+    return EAGLE_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_SplitListSpans --
+ *
+ *	Splits a list up into its constituent elements without copying them.
+ *	Each element is described by a span (i.e. an offset and a length)
+ *	within the original list text.  Only the elements that contain
+ *	backslash sequences are copied (and collapsed); the spans for those
+ *	elements refer to the separate unescaped text instead.
+ *
+ * Results
+ *	The return value is normally EAGLE_OK, which means that the list was
+ *	successfully split up.  If EAGLE_ERROR is returned, it means that
+ *	"list" did not have proper list structure; in that case, the error
+ *	message will contain a more details.  The span array and unescaped
+ *	text (if any) must be freed via Eagle_FreeMemory.
+ *
+ * Side effects:
+ *	Memory is allocated and possibly freed.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+RETURNCODE
+Eagle_SplitListSpans(
+    SIZE_T length,		/* Length of string with list structure. */
+    LPCWSTR pText,		/* Pointer to string with list structure. */
+    LPSIZE_T pElementCount,	/* The number of list elements found. */
+    LPELEMENT_SPAN *ppSpans,	/* The array of list element spans. */
+    LPCWSTR *ppUnescaped,	/* The unescaped text for those elements that
+				 * contain backslash sequences, if any. */
+    LPCWSTR *ppError)		/* The error message, if any. */
+{
+    LPCWSTR list, q, element;
+    LPELEMENT_SPAN spans;
+    LPWSTR unescaped = NULL;
+    LPWSTR p = NULL;
+    SIZE_T allocSize;
+    SIZE_T listLength, size, i, elSize;
+    BOOL literal;
+    RETURNCODE result;
+
+    assert(length >= 0);
+    assert(pText != NULL);
+    assert(pElementCount != NULL);
+    assert(ppSpans != NULL);
+    assert(ppUnescaped != NULL);
+    assert(ppError != NULL);
+
+    /*
+     * Figure out how many spans to allocate, using the same estimate
+     * as Eagle_SplitList.
+     */
+
+    size = 2 + EagleCountSpaceRuns(pText, length);
+    allocSize = size * sizeof(ELEMENT_SPAN);
+    assert(allocSize > 0);
+    assert(allocSize <= LIBRARY_MAXIMUM_SIZE_T);
+    spans = EagleAllocateBuffer(allocSize, FALSE,
+	EAGLE_MEMORY_SITE_SPLIT);
+    if (spans == NULL) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("out of memory for list element spans (%zu)"),
+		allocSize);
+	}
+	return EAGLE_ERROR;
+    }
+    list = pText;
+    listLength = length;
+    q = pText + length;
+    for (i = 0; listLength > 0; i++) {
+	LPCWSTR prevList = list;
+
+	result = EagleFindElement(list, listLength, &element, &list,
+				  &elSize, NULL, &literal, ppError);
+	if (result != EAGLE_OK) {
+	    Eagle_FreeMemory(spans);
+	    Eagle_FreeMemory(unescaped);
+	    return result;
+	}
+	listLength -= (SIZE_T)(list - prevList);
+	if (element == q) {
 	    break;
-	case L'd': /* COMPAT: Eagle only. */
-	    count += EagleParseDec(p + 1, numChars - 2, &result);
-	    if (count == 2) {
-		/* No digits -> This is just "d". */
-		result = L'd';
-	    } else {
-		/* Keep only the last byte (~3 dec digits) */
-		result = (BYTE)result;
+	}
+	if (i >= size) {
+	    if (ppError != NULL) {
+		*ppError = EaglePrintf(0,
+		    UNICODIFY("wrong estimated list size"));
+	    }
+	    Eagle_FreeMemory(spans);
+	    Eagle_FreeMemory(unescaped);
+	    return EAGLE_ERROR;
+	}
+	if (literal) {
+	    spans[i].offset = (SIZE_T)(element - pText);
+	    spans[i].length = elSize;
+	    spans[i].needsUnescape = FALSE;
+	    continue;
+	}
+	if (unescaped == NULL) {
+	    /*
+	     * Collapsing never makes an element longer; therefore, this
+	     * element plus the rest of the list is enough space for all
+	     * the unescaped text that remains to be produced.
+	     */
+
+	    allocSize = (elSize + listLength + 1) * sizeof(WCHAR);
+	    assert(allocSize > 0);
+	    assert(allocSize <= LIBRARY_MAXIMUM_SIZE_T);
+	    unescaped = EagleAllocateBuffer(allocSize, FALSE,
+		EAGLE_MEMORY_SITE_SPLIT);
+	    if (unescaped == NULL) {
+		if (ppError != NULL) {
+		    *ppError = EaglePrintf(0,
+			UNICODIFY("out of memory for unescaped list elements ")
+			UNICODIFY("(%zu)"),
+			allocSize);
+		}
+		Eagle_FreeMemory(spans);
+		return EAGLE_ERROR;
+	    }
+	    p = unescaped;
+	}
+	spans[i].offset = (SIZE_T)(p - unescaped);
+	spans[i].length = EagleCopyAndCollapse(elSize, element, p);
+	spans[i].needsUnescape = TRUE;
+	p += spans[i].length;
+    }
+
+    *pElementCount = i;
+    *ppSpans = spans;
+    *ppUnescaped = unescaped;
+
+    return EAGLE_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_SplitLists --
+ *
+ *	Splits several lists up into their constituent elements, using one
+ *	call.  All the results are placed into one contiguous block of memory,
+ *	which starts with the number of elements found in each list, followed
+ *	by the string lengths of all the elements, in order.  The text of all
+ *	the elements (also in order and without any terminators) is placed
+ *	at the end of the same block.
+ *
+ * Results
+ *	The return value is normally EAGLE_OK, which means that all the lists
+ *	were successfully split up.  If EAGLE_ERROR is returned, it means that
+ *	one of the lists did not have proper list structure; in that case, the
+ *	error message will contain a more details.  Only the block returned
+ *	via "ppCounts" must be freed, via Eagle_FreeMemory; "ppText" points
+ *	into that same block.
+ *
+ * Side effects:
+ *	Memory is allocated and possibly freed.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+RETURNCODE
+Eagle_SplitLists(
+    SIZE_T listCount,		/* The number of lists to split. */
+    LPCSIZE_T pLengths,		/* Lengths of strings with list structure. */
+    LPCWSTR *ppTexts,		/* Pointers to strings with list structure. */
+    LPSIZE_T pElementCount,	/* The number of list elements found in all
+				 * of the lists. */
+    LPSIZE_T *ppCounts,		/* The number of list elements found in each
+				 * list, followed by the string lengths of
+				 * all the list elements. */
+    LPCWSTR *ppText,		/* The text of all the list elements. */
+    LPCWSTR *ppError)		/* The error message, if any. */
+{
+    LPCWSTR list, q, element;
+    LPSIZE_T counts, lengths;
+    LPWSTR text, p;
+    SIZE_T allocSize, maxChars;
+    SIZE_T listLength, size, numChars, total, i, n, elSize;
+    BOOL literal;
+    RETURNCODE result;
+
+    assert(listCount >= 0);
+    assert((listCount == 0) || (pLengths != NULL));
+    assert((listCount == 0) || (ppTexts != NULL));
+    assert(pElementCount != NULL);
+    assert(ppCounts != NULL);
+    assert(ppText != NULL);
+    assert(ppError != NULL);
+
+    /*
+     * Figure out how much space to allocate, using the same estimate as
+     * Eagle_SplitList for each list.  Since the lengths of all the lists
+     * are added together, make sure the total cannot overflow; both the
+     * number of lists and the number of characters are limited so that
+     * the estimated size always fits.
+     */
+
+    maxChars = LIBRARY_MAXIMUM_SIZE_T /
+	(4 * (SIZE_T)(sizeof(SIZE_T) + sizeof(WCHAR)));
+    if (listCount > maxChars) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("too many lists (%zu)"), listCount);
+	}
+	return EAGLE_ERROR;
+    }
+    size = listCount;
+    numChars = 0;
+    for (n = 0; n < listCount; n++) {
+	/*
+	 * NOTE: The casts make negative lengths fail this check when
+	 *       SIZE_T is a signed type (i.e. USE_32BIT_SIZE_T).
+	 */
+	if ((size_t)pLengths[n] > (size_t)(maxChars - numChars)) {
+	    if (ppError != NULL) {
+		*ppError = EaglePrintf(0,
+		    UNICODIFY("lists are too large (%zu)"), n);
 	    }
-	    break;
-	case L'x':
-	    count += EagleParseHex(p + 1, numChars - 2, &result);
-	    if (count == 2) {
-		/* No digits -> This is just "x". */
-		result = L'x';
-	    } else {
-		/* Keep only the last byte (2 hex digits) */
-		result = (BYTE)result;
+	    return EAGLE_ERROR;
+	}
+	size += 2 + EagleCountSpaceRuns(ppTexts[n], pLengths[n]);
+	numChars += pLengths[n];
+    }
+    allocSize = (size * sizeof(SIZE_T)) + ((numChars + 1) * sizeof(WCHAR));
+    assert(allocSize > 0);
+    assert(allocSize <= LIBRARY_MAXIMUM_SIZE_T);
+    counts = EagleAllocateBuffer(allocSize, FALSE,
+	EAGLE_MEMORY_SITE_SPLIT);
+    if (counts == NULL) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("out of memory for list elements (%zu)"),
+		allocSize);
+	}
+	return EAGLE_ERROR;
+    }
+    lengths = counts + listCount;
+    text = (LPWSTR)(counts + size);
+    p = text;
+    total = 0;
+    for (n = 0; n < listCount; n++) {
+	list = ppTexts[n];
+	listLength = pLengths[n];
+	q = list + listLength;
+	for (i = 0; listLength > 0; i++) {
+	    LPCWSTR prevList = list;
+
+	    result = EagleFindElement(list, listLength, &element, &list,
+				      &elSize, NULL, &literal, ppError);
+	    if (result != EAGLE_OK) {
+		Eagle_FreeMemory(counts);
+		return result;
 	    }
-	    break;
-	case L'X': /* COMPAT: Eagle only. */
-	    count += EagleParseHex(p + 1, numChars - 2, &result);
-	    if (count == 2) {
-		/* No digits -> This is just "X". */
-		result = L'X';
+	    listLength -= (SIZE_T)(list - prevList);
+	    if (element == q) {
+		break;
 	    }
-	    break;
-	case L'u':
-	    count += EagleParseHex(
-		    p + 1, (numChars > 5) ? 4 : numChars - 2, &result);
-	    if (count == 2) {
-		/* No digits -> This is just "u". */
-		result = L'u';
+	    if (total >= size - listCount) {
+		if (ppError != NULL) {
+		    *ppError = EaglePrintf(0,
+			UNICODIFY("wrong estimated list size"));
+		}
+		Eagle_FreeMemory(counts);
+		return EAGLE_ERROR;
 	    }
-	    break;
-	case L'U': /* COMPAT: Tcl only. */
-	    count += EagleParseHex(
-		    p + 1, (numChars > 9) ? 8 : numChars - 2, &result);
-	    if (count == 2) {
-		/* No digits -> This is just "U". */
-		result = L'U';
+	    if (literal) {
+		memcpy(p, element, elSize * sizeof(WCHAR));
+	    } else {
+		elSize = EagleCopyAndCollapse(elSize, element, p);
 	    }
+	    lengths[total++] = elSize;
+	    p += elSize;
+	}
+	counts[n] = i;
+    }
+    *p = 0;
+
+    *pElementCount = total;
+    *ppCounts = counts;
+    *ppText = text;
+
+    return EAGLE_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_CountListElements --
+ *
+ *	Counts the elements in a list without extracting any of them.  The
+ *	entire list is scanned; therefore, a list that does not have proper
+ *	list structure is always reported as an error.
+ *
+ * Results:
+ *	A standard Eagle return code.
+ *
+ * Side effects:
+ *	None, except for the error message, if any.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+RETURNCODE
+Eagle_CountListElements(
+    SIZE_T length,		/* Length of string with list structure. */
+    LPCWSTR pText,		/* Pointer to string with list structure. */
+    LPSIZE_T pElementCount,	/* The number of list elements found. */
+    LPCWSTR *ppError)		/* The error message, if any. */
+{
+    LPCWSTR list, q, element;
+    SIZE_T listLength, count, elSize;
+    RETURNCODE result;
+
+    assert(length >= 0);
+    assert(pText != NULL);
+    assert(pElementCount != NULL);
+    assert(ppError != NULL);
+
+    list = pText;
+    listLength = length;
+    q = pText + length;
+    for (count = 0; listLength > 0; count++) {
+	LPCWSTR prevList = list;
+
+	result = EagleFindElement(list, listLength, &element, &list,
+				  &elSize, NULL, NULL, ppError);
+	if (result != EAGLE_OK) {
+	    return result;
+	}
+	listLength -= (SIZE_T)(list - prevList);
+	if (element == q) {
 	    break;
-	case L'\n':
-	    count--;
-	    do {
-		p++; count++;
-	    } while ((count < numChars) && ((*p == L' ') || (*p == L'\t')));
-	    result = L' ';
+	}
+    }
+
+    *pElementCount = count;
+
+    return EAGLE_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_GetListElement --
+ *
+ *	Extracts one element from a list, by index, without extracting any
+ *	of the others.  Scanning stops at the requested element; therefore,
+ *	the rest of the list is not checked for proper list structure.  The
+ *	caller should use Eagle_CountListElements first if that matters.
+ *
+ * Results:
+ *	A standard Eagle return code.  Upon success, the element pointer is
+ *	set to NULL if the index is beyond the end of the list; otherwise,
+ *	it must be freed via Eagle_FreeMemory.
+ *
+ * Side effects:
+ *	Memory is allocated for the requested element only.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+RETURNCODE
+Eagle_GetListElement(
+    SIZE_T length,		/* Length of string with list structure. */
+    LPCWSTR pText,		/* Pointer to string with list structure. */
+    SIZE_T index,		/* Zero-based index of the element. */
+    LPSIZE_T pElementLength,	/* The length of the element. */
+    LPCWSTR *ppElement,		/* The element -OR- NULL if not found. */
+    LPCWSTR *ppError)		/* The error message, if any. */
+{
+    LPCWSTR list, q, element;
+    LPWSTR p;
+    SIZE_T allocSize;
+    SIZE_T listLength, i, elSize;
+    BOOL literal;
+    RETURNCODE result;
+
+    assert(length >= 0);
+    assert(pText != NULL);
+    assert(index >= 0);
+    assert(pElementLength != NULL);
+    assert(ppElement != NULL);
+    assert(ppError != NULL);
+
+    *pElementLength = 0;
+    *ppElement = NULL;
+
+    list = pText;
+    listLength = length;
+    q = pText + length;
+    for (i = 0; listLength > 0; i++) {
+	LPCWSTR prevList = list;
+
+	result = EagleFindElement(list, listLength, &element, &list,
+				  &elSize, NULL, &literal, ppError);
+	if (result != EAGLE_OK) {
+	    return result;
+	}
+	listLength -= (SIZE_T)(list - prevList);
+	if (element == q) {
 	    break;
-	default:
-	    /*
-	     * Check for an octal number \oo?o?
-	     */
-	    if (iswdigit(*p) && (*p < L'8')) { /* INTL: digit */
-		result = (WCHAR)(*p - L'0');
-		p++;
-		if ((numChars == 2) || !iswdigit(*p) /* INTL: digit */
-			|| (*p >= L'8')) {
-		    break;
-		}
-		count = 3;
-		result = (WCHAR)((result << 3) + (*p - L'0'));
-		p++;
-		if ((numChars == 3) || !iswdigit(*p) /* INTL: digit */
-			|| (*p >= L'8')) {
-		    break;
-		}
-		count = 4;
-		result = (WCHAR)((result << 3) + (*p - L'0'));
-		break;
+	}
+	if (i < index) {
+	    continue;
+	}
+	allocSize = (elSize + 1) * sizeof(WCHAR);
+	assert(allocSize > 0);
+	assert(allocSize <= LIBRARY_MAXIMUM_SIZE_T);
+	p = EagleAllocateBuffer(allocSize, FALSE,
+	    EAGLE_MEMORY_SITE_QUERY);
+	if (p == NULL) {
+	    if (ppError != NULL) {
+		*ppError = EaglePrintf(0,
+		    UNICODIFY("out of memory for list element (%zu)"),
+		    allocSize);
 	    }
-	    result = *p;
-	    break;
+	    return EAGLE_ERROR;
+	}
+	if (literal) {
+	    memcpy(p, element, elSize * sizeof(WCHAR));
+	} else {
+	    elSize = EagleCopyAndCollapse(elSize, element, p);
+	}
+	p[elSize] = 0;
+	*pElementLength = elSize;
+	*ppElement = p;
+	break;
+    }
+
+    return EAGLE_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_GetListRange --
+ *
+ *	Extracts a range of elements from a list, as a new list, without
+ *	splitting the whole list.  Scanning stops at the end of the range.
+ *
+ * Results:
+ *	A standard Eagle return code.  The resulting text must be freed via
+ *	Eagle_FreeMemory.
+ *
+ * Side effects:
+ *	Memory is allocated and possibly freed.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+RETURNCODE
+Eagle_GetListRange(
+    SIZE_T length,		/* Length of string with list structure. */
+    LPCWSTR pText,		/* Pointer to string with list structure. */
+    SIZE_T firstIndex,		/* Index of the first element to keep. */
+    SIZE_T lastIndex,		/* Index of the last element to keep. */
+    LPSIZE_T pLength,		/* The string length of the resulting list. */
+    LPCWSTR *ppText,		/* The textual representation of the list. */
+    LPCWSTR *ppError)		/* The error message, if any. */
+{
+    SIZE_T count;
+
+    assert(firstIndex >= 0);
+    assert(lastIndex >= 0);
+
+    count = (lastIndex >= firstIndex) ? (lastIndex - firstIndex + 1) : 0;
+
+    return EagleEditList(length, pText, firstIndex, count, TRUE, 0, NULL,
+	NULL, pLength, ppText, ppError);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_ReplaceListRange --
+ *
+ *	Replaces a range of elements in a list with zero or more new ones,
+ *	without splitting the whole list.  When the range is empty, this
+ *	simply inserts the new elements before the first index.
+ *
+ * Results:
+ *	A standard Eagle return code.  The resulting text must be freed via
+ *	Eagle_FreeMemory.
+ *
+ * Side effects:
+ *	Memory is allocated and possibly freed.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+RETURNCODE
+Eagle_ReplaceListRange(
+    SIZE_T length,		/* Length of string with list structure. */
+    LPCWSTR pText,		/* Pointer to string with list structure. */
+    SIZE_T firstIndex,		/* Index of the first element to replace. */
+    SIZE_T deleteCount,		/* Number of elements to replace. */
+    SIZE_T elementCount,	/* The number of new list elements. */
+    LPCSIZE_T pElementLengths,	/* The string lengths of the new elements. */
+    LPCWSTR *ppElements,	/* The new list elements. */
+    LPSIZE_T pLength,		/* The string length of the resulting list. */
+    LPCWSTR *ppText,		/* The textual representation of the list. */
+    LPCWSTR *ppError)		/* The error message, if any. */
+{
+    assert(firstIndex >= 0);
+    assert(deleteCount >= 0);
+
+#if !defined(USE_SYSSTRINGLEN) || !USE_SYSSTRINGLEN
+    assert((elementCount == 0) || (pElementLengths != NULL));
+#else
+    assert(pElementLengths == NULL);
+#endif
+
+    return EagleEditList(length, pText, firstIndex, deleteCount, FALSE,
+	elementCount, pElementLengths, ppElements, pLength, ppText,
+	ppError);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_ListIterBegin --
+ *
+ *	Creates an iterator that can be used to extract the elements of
+ *	a list one at a time, via Eagle_ListIterNext, without splitting
+ *	the whole list up front.  The list text is not copied; therefore,
+ *	it must remain valid (and unmoved) until Eagle_ListIterEnd is
+ *	called.
+ *
+ * Results:
+ *	A standard Eagle return code.
+ *
+ * Side effects:
+ *	Memory is allocated.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+RETURNCODE
+Eagle_ListIterBegin(
+    SIZE_T length,		/* Length of string with list structure. */
+    LPCWSTR pText,		/* Pointer to string with list structure. */
+    LPLIST_ITERATOR *ppIterator,/* The newly created iterator. */
+    LPCWSTR *ppError)		/* The error message, if any. */
+{
+    LPLIST_ITERATOR pIterator;
+    SIZE_T allocSize;
+
+    assert(length >= 0);
+    assert(pText != NULL);
+    assert(ppIterator != NULL);
+    assert(ppError != NULL);
+
+    allocSize = sizeof(LIST_ITERATOR);
+    pIterator = EagleAllocateBuffer(allocSize, TRUE,
+	EAGLE_MEMORY_SITE_SPLIT);
+    if (pIterator == NULL) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("out of memory for list iterator (%zu)"),
+		allocSize);
+	}
+	return EAGLE_ERROR;
     }
 
-done:
+    pIterator->pText = pText;
+    pIterator->pNext = pText;
+    pIterator->pEnd = pText + length;
+    pIterator->remaining = length;
+    pIterator->pBuffer = NULL;
+    pIterator->bufferLength = 0;
 
-    if (readPtr != NULL) {
-	*readPtr = count;
-    }
-    dst[0] = (WCHAR)result;
-    if ((result & ~USHRT_MAX) != 0) {
-	dst[1] = *(((LPCWSTR)&result) + 1);
-	return 2;
-    }
-    return 1;
+    *ppIterator = pIterator;
+
+    return EAGLE_OK;
 }
-
+
 /*
  *---------------------------------------------------------------------------
  *
- * EagleCopyAndCollapse --
+ * Eagle_ListIterNext --
  *
- *	Copy a string and eliminate any backslashes that aren't in braces.
+ *	Extracts the next element from a list using an iterator that was
+ *	created by Eagle_ListIterBegin.  Elements that do not contain any
+ *	backslash sequences are not copied; the returned pointer refers
+ *	to the original list text.  Other elements are collapsed into a
+ *	buffer owned by the iterator, which is reused for each element.
+ *	In either case, the returned pointer is only valid until the next
+ *	call using the same iterator.
  *
  * Results:
- *	Count characters that get copied from src to dst. Along the way,
- *	backslash sequences are substituted in the copy.  After scanning
- *	count characters from src, a null character is placed at the end
- *	of dst.  Returns the number of characters that got written to dst.
+ *	A standard Eagle return code.  Upon success, the element pointer
+ *	is set to NULL if there are no more elements.
  *
  * Side effects:
- *	None.
+ *	Memory may be allocated and freed.
  *
  *---------------------------------------------------------------------------
  */
 
-static SIZE_T
-EagleCopyAndCollapse(
-    SIZE_T count,		/* Number of characters to copy from src. */
-    LPCWSTR src,		/* Copy from here... */
-    LPWSTR dst)			/* ... to here. */
+RETURNCODE
+Eagle_ListIterNext(
+    LPLIST_ITERATOR pIterator,	/* The iterator to use. */
+    LPELEMENT_SPAN pSpan,	/* The span of the element.  When it does
+				 * not contain backslash sequences, the
+				 * offset refers to the original list text;
+				 * otherwise, it is always zero. */
+    LPCWSTR *ppElement,		/* The first character of the element -OR-
+				 * NULL if there are no more elements. */
+    LPCWSTR *ppError)		/* The error message, if any. */
 {
-    SIZE_T newCount = 0;
+    LPCWSTR element, next;
+    SIZE_T elSize;
+    BOOL literal;
+    RETURNCODE result;
 
-    assert(count >= 0);
-    assert(src != NULL);
-    assert(dst != NULL);
+    assert(pIterator != NULL);
+    assert(pSpan != NULL);
+    assert(ppElement != NULL);
+    assert(ppError != NULL);
 
-    while (count > 0) {
-	WCHAR c = *src;
-	if (c == L'\\') {
-	    SIZE_T numRead;
-	    SIZE_T numWrite = EagleParseBackslash(src, count, &numRead, dst);
+    *ppElement = NULL;
 
-	    dst += numWrite;
-	    newCount += numWrite;
-	    src += numRead;
-	    count -= numRead;
-	} else {
-	    *dst = c;
-	    dst++;
-	    newCount++;
-	    src++;
-	    count--;
+    if (pIterator->remaining == 0) {
+	return EAGLE_OK;
+    }
+
+    result = EagleFindElement(pIterator->pNext, pIterator->remaining,
+			      &element, &next, &elSize, NULL, &literal,
+			      ppError);
+    if (result != EAGLE_OK) {
+	return result;
+    }
+    pIterator->remaining -= (SIZE_T)(next - pIterator->pNext);
+    pIterator->pNext = next;
+    if (element == pIterator->pEnd) {
+	/*
+	 * Only white space remained after the last element.
+	 */
+
+	pIterator->remaining = 0;
+	return EAGLE_OK;
+    }
+    if (literal) {
+	pSpan->offset = (SIZE_T)(element - pIterator->pText);
+	pSpan->length = elSize;
+	pSpan->needsUnescape = FALSE;
+	*ppElement = element;
+	return EAGLE_OK;
+    }
+    if (pIterator->bufferLength < elSize + 1) {
+	SIZE_T newLength = pIterator->bufferLength * 2;
+	SIZE_T allocSize;
+	LPWSTR pBuffer;
+
+	if (newLength < elSize + 1) {
+	    newLength = elSize + 1;
 	}
+	allocSize = newLength * sizeof(WCHAR);
+	assert(allocSize > 0);
+	assert(allocSize <= LIBRARY_MAXIMUM_SIZE_T);
+	pBuffer = EagleAllocateBuffer(allocSize, FALSE,
+	    EAGLE_MEMORY_SITE_SPLIT);
+	if (pBuffer == NULL) {
+	    if (ppError != NULL) {
+		*ppError = EaglePrintf(0,
+		    UNICODIFY("out of memory for list element (%zu)"),
+		    allocSize);
+	    }
+	    return EAGLE_ERROR;
+	}
+	Eagle_FreeMemory(pIterator->pBuffer);
+	pIterator->pBuffer = pBuffer;
+	pIterator->bufferLength = newLength;
     }
-    return newCount;
+    pSpan->offset = 0;
+    pSpan->length = EagleCopyAndCollapse(elSize, element,
+	pIterator->pBuffer);
+    pSpan->needsUnescape = TRUE;
+    *ppElement = pIterator->pBuffer;
+
+    return EAGLE_OK;
 }
-
+
 /*
  *---------------------------------------------------------------------------
  *
- * EagleScanCountedElement --
+ * Eagle_ListIterEnd --
  *
- *	This procedure is a companion procedure to
- *	EagleConvertCountedElement.  It scans a string to see what needs to
- *	be done to it (e.g. add backslashes or enclosing braces) to make the
- *	string into a valid Tcl list element.  If length is -1, then the
- *	string is scanned up to the first NUL character.
+ *	Frees an iterator that was created by Eagle_ListIterBegin.
  *
  * Results:
- *	The return value is an overestimate of the number of characters that
- *	will be needed by EagleConvertCountedElement to produce a valid list
- *	element from string.  The word at *flagPtr is filled in with a value
- *	needed by EagleConvertCountedElement when doing the actual
- *	conversion.
+ *	None.
  *
  * Side effects:
- *	None.
+ *	Memory is freed.
  *
  *---------------------------------------------------------------------------
  */
 
-static SIZE_T
-EagleScanCountedElement(
-    LPCWSTR string,		/* String to convert to Tcl list element. */
-    SIZE_T length,		/* Number of characters in string, or -1. */
-    FLAGS *flagPtr)		/* Where to store information to guide
-				 * EagleConvertCountedElement. */
+VOID
+Eagle_ListIterEnd(
+    LPLIST_ITERATOR pIterator)	/* The iterator to free. */
 {
-    FLAGS flags;
-    int nestingLevel;
-    LPCWSTR p, lastChar;
+    if (pIterator == NULL)
+	return;
 
-    assert((length >= 0) || (length == (SIZE_T)-1));
-    assert(flagPtr != NULL);
+    Eagle_FreeMemory(pIterator->pBuffer);
+    Eagle_FreeMemory(pIterator);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_JoinList --
+ *
+ *	Given a collection of strings, merge them together into a single
+ *	string that has proper Tcl list structure (i.e. Eagle_SplitList may
+ *	be used to retrieve strings equal to the original elements).
+ *
+ * Results:
+ *	A standard Eagle return code.
+ *
+ * Side effects:
+ *	Memory is allocated and possibly freed.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+RETURNCODE
+Eagle_JoinList(
+    SIZE_T elementCount,	/* The number of list elements present. */
+    LPCSIZE_T pElementLengths,	/* The string lengths of the list elements. */
+    LPCWSTR *ppElements,	/* The list elements. */
+    LPSIZE_T pLength,		/* The string length of the resulting list. */
+    LPCWSTR *ppText,		/* The textual representation of the list. */
+    LPCWSTR *ppError)		/* The error message, if any. */
+{
+    FLAGS localFlags[LIBRARY_LOCAL_FLAGS], *flagPtr;
+    SIZE_T allocSize;
+    SIZE_T i, numChars;
+    LPWSTR result, dst;
+
+    assert(elementCount >= 0);
+
+#if !defined(USE_SYSSTRINGLEN) || !USE_SYSSTRINGLEN
+    assert(pElementLengths != NULL);
+#else
+    assert(pElementLengths == NULL);
+#endif
+
+    assert(ppElements != NULL);
+    assert(ppText != NULL);
+    assert(ppError != NULL);
 
     /*
-     * This procedure and EagleConvertCountedElement together do two things:
-     *
-     * 1. They produce a proper list, one that will yield back the argument
-     *    strings when evaluated or when disassembled with Eagle_SplitList.
-     *    This is the most important thing.
-     *
-     * 2. They try to produce legible output, which means minimizing the use
-     *    of backslashes (using braces instead).  However, there are some
-     *    situations where backslashes must be used (e.g. an element like
-     *    "{abc": the leading brace will have to be backslashed.  For each
-     *    element, one of three things must be done:
-     *
-     *    (a) Use the element as-is (it doesn't contain any special
-     *        characters).  This is the most desirable option.
-     *
-     *    (b) Enclose the element in braces, but leave the contents alone.
-     *        This happens if the element contains embedded space, or if it
-     *        contains characters with special interpretation ($, [, ;, or \),
-     *        or if it starts with a brace or double-quote, or if there are
-     *        no characters in the element.
-     *
-     *    (c) Don't enclose the element in braces, but add backslashes to
-     *        prevent special interpretation of special characters.  This is
-     *        a last resort used when the argument would normally fall under
-     *        case (b) but contains unmatched braces.  It also occurs if the
-     *        last character of the argument is a backslash or if the element
-     *        contains a backslash followed by newline.
-     *
-     * The procedure figures out how many characters will be needed to store
-     * the result (actually, it overestimates). It also collects information
-     * about the element in the form of a flags word.
-     *
-     * Note: list elements produced by this procedure and
-     * EagleConvertCountedElement must have the property that they can be
-     * enclosed in curly braces to make sub-lists.  This means, for example,
-     * that we must not leave unmatched curly braces in the resulting list
-     * element.
+     * Pass 1: estimate space, gather flags.
      */
 
-    nestingLevel = 0;
-    flags = 0;
-    if (string == NULL) {
-	string = L"";
-    }
-    if (length == (SIZE_T)-1) {
-	length = (SIZE_T)wcslen(string);
+    if (elementCount <= LIBRARY_LOCAL_FLAGS) {
+	flagPtr = localFlags;
+    } else {
+	assert(elementCount > 0);
+	allocSize = elementCount * sizeof(FLAGS);
+	assert(allocSize > 0);
+	assert(allocSize <= LIBRARY_MAXIMUM_SIZE_T);
+	flagPtr = EagleAllocateScratch(allocSize, EAGLE_MEMORY_SITE_JOIN);
+	if (flagPtr == NULL) {
+	    if (ppError != NULL) {
+		*ppError = EaglePrintf(0,
+		    UNICODIFY("out of memory for list element flags (%zu)"),
+		    allocSize);
+	    }
+	    return EAGLE_ERROR;
+	}
     }
-    lastChar = string + length;
-    p = string;
-    if ((p == lastChar) || (*p == L'{') || (*p == L'"')) {
-	flags |= EAGLE_USE_BRACES;
+
+    numChars = 0;
+    for (i = 0; i < elementCount; i++) {
+	/*
+	 * If necessary, add space for the list element separator.
+	 */
+
+	if (i > 0) {
+	    numChars++; /* +1 SPACE */
+	}
+
+	numChars += EagleScanCountedElement(ppElements[i],
+	    SysStringLenWrapper(i) /* NON-PORTABLE? */,
+	    &flagPtr[i]);
+    }
+
+    /*
+     * Pass 2: copy into the result area.
+     */
+
+    allocSize = (numChars + 1) * sizeof(WCHAR);
+    assert(allocSize > 0);
+    assert(allocSize <= LIBRARY_MAXIMUM_SIZE_T);
+    result = EagleAllocateBuffer(allocSize, FALSE,
+	EAGLE_MEMORY_SITE_JOIN);
+    if (result == NULL) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("out of memory for list element text (%zu)"),
+		allocSize);
+	}
+	if (flagPtr != localFlags) {
+	    EagleFreeScratch(flagPtr);
+	}
+	return EAGLE_ERROR;
     }
-    for (; p < lastChar; p++) {
-	switch (*p) {
-	    case L'{':
-		nestingLevel++;
-		break;
-	    case L'}':
-		nestingLevel--;
-		if (nestingLevel < 0) {
-		    flags |= EAGLE_DONT_USE_BRACES | EAGLE_BRACES_UNMATCHED;
-		}
-		break;
-	    case L'[':
-	    case L'$':
-	    case L';':
-	    case L' ':
-	    case L'\f':
-	    case L'\n':
-	    case L'\r':
-	    case L'\t':
-	    case L'\v':
-		flags |= EAGLE_USE_BRACES;
-		break;
-	    case L'\\':
-		/*
-		 * The first portion of this check used to compare "p + 1"
-		 * against "lastChar" with the "==" operator; however, the
-		 * static analysis tool thinks that could lead to accessing
-		 * one character beyond the end of the string; therefore,
-		 * the check was changed to use the ">=" operator instead.
-		 *
-		 * Really, the loop invariant of the enclosing "for" loop
-		 * already defends against this, since the value of "p" is
-		 * guaranteed to be less than "lastChar" here; therefore,
-		 * the maximum value of "p + 1" is "lastChar", which would
-		 * cause the short-circuit semantics of the "if" statement,
-		 * thus preventing access to "p[1]".  Changing this to use
-		 * the ">=" operator should make it much easier for the
-		 * static analysis tool to figure all this out (i.e. since
-		 * it should then assert "(p + 1) < lastChar" at the point
-		 * where "p[1]" is used).
-		 */
-		if (((p + 1) >= lastChar) || (p[1] == L'\n')) {
-		    flags = EAGLE_DONT_USE_BRACES | EAGLE_BRACES_UNMATCHED;
-		} else {
-		    SIZE_T size;
 
-		    EagleParseBackslash(
-			p, (SIZE_T)(lastChar - p), &size, NULL);
+    numChars = 0;
+    dst = result;
+    for (i = 0; i < elementCount; i++) {
+	SIZE_T eleChars = 0;
 
-		    p += size - 1;
-		    flags |= EAGLE_USE_BRACES;
-		}
-		break;
+	/*
+	 * If necessary, add the list element separator.
+	 */
+
+	if (i > 0) {
+	    *dst = L' ';
+	    eleChars++;
+	    dst++;
 	}
+
+	eleChars += EagleConvertCountedElement(ppElements[i],
+		SysStringLenWrapper(i) /* NON-PORTABLE? */, dst,
+		flagPtr[i] | ((i == 0) ? 0 : EAGLE_DONT_QUOTE_HASH));
+
+	numChars += eleChars;
+	dst += (eleChars - (i > 0));
     }
-    if (nestingLevel != 0) {
-	flags = EAGLE_DONT_USE_BRACES | EAGLE_BRACES_UNMATCHED;
+    *dst = 0;
+
+    if (flagPtr != localFlags) {
+	EagleFreeScratch(flagPtr);
     }
-    *flagPtr = flags;
 
-    /*
-     * Allow enough space to backslash every character plus leave
-     * two spaces for braces.
-     */
+    *pLength = numChars;
+    *ppText = result;
 
-    return (SIZE_T)((2 * (p - string)) + 2);
+    return EAGLE_OK;
 }
-
+
 /*
  *---------------------------------------------------------------------------
  *
- * EagleConvertCountedElement --
+ * Eagle_JoinLists --
  *
- *	This is a companion procedure to EagleScanCountedElement.  Given the
- *	information produced by EagleScanCountedElement, this procedure
- *	converts a string to a list element equal to that string.
+ *	Given several collections of strings, merge each of them together
+ *	into a single string that has proper Tcl list structure, using one
+ *	call.  All the results are placed into one contiguous block of memory,
+ *	which starts with the string length of each resulting list, followed
+ *	by the text of the resulting lists, in order, each terminated by a
+ *	NUL character.
  *
  * Results:
- *	Information is copied to *dst in the form of a list element identical
- *	to src (i.e. if Eagle_SplitList is applied to dst it will produce a
- *	string identical to src).  The return value is a count of the number
- *	of characters copied (not including the terminating NULL character).
+ *	A standard Eagle return code.  Only the block returned via "ppLengths"
+ *	must be freed, via Eagle_FreeMemory; "ppText" points into that same
+ *	block.
  *
  * Side effects:
- *	None.
+ *	Memory is allocated and possibly freed.
  *
  *---------------------------------------------------------------------------
  */
 
-static SIZE_T
-EagleConvertCountedElement(
-    LPCWSTR src,		/* Source information for list element. */
-    SIZE_T length,		/* Number of characters in src, or -1. */
-    LPWSTR dst,			/* Place to put list-ified element. */
-    FLAGS flags)		/* Flags produced by Tcl_ScanElement. */
+RETURNCODE
+Eagle_JoinLists(
+    SIZE_T listCount,		/* The number of lists to create. */
+    LPCSIZE_T pElementCounts,	/* The number of list elements present for
+				 * each list. */
+    LPCSIZE_T pElementLengths,	/* The string lengths of all the list
+				 * elements. */
+    LPCWSTR *ppElements,	/* All the list elements, in order. */
+    LPSIZE_T *ppLengths,	/* The string length of each resulting list,
+				 * followed by the text of all of them. */
+    LPCWSTR *ppText,		/* The textual representation of the first
+				 * list; the others follow it. */
+    LPCWSTR *ppError)		/* The error message, if any. */
 {
-    LPWSTR p = dst;
-    LPCWSTR lastChar;
+    FLAGS localFlags[LIBRARY_LOCAL_FLAGS], *flagPtr;
+    SIZE_T allocSize;
+    SIZE_T elementCount, i, j, n, numChars;
+    LPSIZE_T lengths;
+    LPWSTR text, dst;
 
-    assert((length >= 0) || (length == (SIZE_T)-1));
-    assert(dst != NULL);
+    assert(listCount >= 0);
+    assert((listCount == 0) || (pElementCounts != NULL));
+
+#if !defined(USE_SYSSTRINGLEN) || !USE_SYSSTRINGLEN
+    assert(pElementLengths != NULL);
+#else
+    assert(pElementLengths == NULL);
+#endif
+
+    assert(ppElements != NULL);
+    assert(ppLengths != NULL);
+    assert(ppText != NULL);
+    assert(ppError != NULL);
+
+    elementCount = 0;
+    for (n = 0; n < listCount; n++) {
+	if ((size_t)pElementCounts[n] >
+		(size_t)(LIBRARY_MAXIMUM_SIZE_T - elementCount)) {
+	    if (ppError != NULL) {
+		*ppError = EaglePrintf(0,
+		    UNICODIFY("bad number of list elements (%zu)"), n);
+	    }
+	    return EAGLE_ERROR;
+	}
+	elementCount += pElementCounts[n];
+    }
 
     /*
-     * See the comment block at the beginning of the Tcl_ScanElement
-     * code for details of how this works.
+     * Pass 1: estimate space, gather flags.  This is exactly the same as
+     * Eagle_JoinList, except that each list also needs its length and its
+     * terminator.
      */
 
-    if (src && (length == (SIZE_T)-1)) {
-	length = (SIZE_T)wcslen(src);
-    }
-    if ((src == NULL) || (length == 0)) {
-	p[0] = L'{';
-	p[1] = L'}';
-	return 2;
+    if (elementCount <= LIBRARY_LOCAL_FLAGS) {
+	flagPtr = localFlags;
+    } else {
+	allocSize = elementCount * sizeof(FLAGS);
+	assert(allocSize > 0);
+	assert(allocSize <= LIBRARY_MAXIMUM_SIZE_T);
+	flagPtr = EagleAllocateScratch(allocSize, EAGLE_MEMORY_SITE_JOIN);
+	if (flagPtr == NULL) {
+	    if (ppError != NULL) {
+		*ppError = EaglePrintf(0,
+		    UNICODIFY("out of memory for list element flags (%zu)"),
+		    allocSize);
+	    }
+	    return EAGLE_ERROR;
+	}
     }
-    lastChar = src + length;
-    if ((*src == L'#') && !(flags & EAGLE_DONT_QUOTE_HASH)) {
-	flags |= EAGLE_USE_BRACES;
+
+    numChars = 0;
+    for (n = 0, i = 0; n < listCount; n++) {
+	for (j = 0; j < pElementCounts[n]; j++, i++) {
+	    if (j > 0) {
+		numChars++; /* +1 SPACE */
+	    }
+
+	    numChars += EagleScanCountedElement(ppElements[i],
+		SysStringLenWrapper(i) /* NON-PORTABLE? */,
+		&flagPtr[i]);
+	}
+	numChars++; /* +1 NUL */
     }
-    if ((flags & EAGLE_USE_BRACES) && !(flags & EAGLE_DONT_USE_BRACES)) {
-	*p = L'{';
-	p++;
-	for (; src != lastChar; src++, p++) {
-	    *p = *src;
+
+    /*
+     * Pass 2: copy into the result area.
+     */
+
+    allocSize = (listCount * sizeof(SIZE_T)) +
+	((numChars + 1) * sizeof(WCHAR));
+    assert(allocSize > 0);
+    assert(allocSize <= LIBRARY_MAXIMUM_SIZE_T);
+    lengths = EagleAllocateBuffer(allocSize, FALSE,
+	EAGLE_MEMORY_SITE_JOIN);
+    if (lengths == NULL) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("out of memory for list element text (%zu)"),
+		allocSize);
 	}
-	*p = L'}';
-	p++;
-    } else {
-	if (*src == L'{') {
-	    /*
-	     * Can't have a leading brace unless the whole element is
-	     * enclosed in braces.  Add a backslash before the brace.
-	     * Furthermore, this may destroy the balance between open
-	     * and close braces, so set EAGLE_BRACES_UNMATCHED.
-	     */
+	if (flagPtr != localFlags) {
+	    EagleFreeScratch(flagPtr);
+	}
+	return EAGLE_ERROR;
+    }
+
+    text = (LPWSTR)(lengths + listCount);
+    dst = text;
+    for (n = 0, i = 0; n < listCount; n++) {
+	LPWSTR start = dst;
+
+	for (j = 0; j < pElementCounts[n]; j++, i++) {
+	    SIZE_T eleChars;
 
-	    p[0] = L'\\';
-	    p[1] = L'{';
-	    p += 2;
-	    src++;
-	    flags |= EAGLE_BRACES_UNMATCHED;
-	} else if ((*src == L'#') && !(flags & EAGLE_DONT_QUOTE_HASH)) {
 	    /*
-	     * Leading '#' could be seen by [eval] as the start of
-	     * a comment, if on the first element of a list, so
-	     * quote it.
+	     * If necessary, add the list element separator.
 	     */
 
-	    p[0] = L'\\';
-	    p[1] = L'#';
-	    p += 2;
-	    src++;
+	    if (j > 0) {
+		*dst = L' ';
+		dst++;
+	    }
+
+	    eleChars = EagleConvertCountedElement(ppElements[i],
+		    SysStringLenWrapper(i) /* NON-PORTABLE? */, dst,
+		    flagPtr[i] | ((j == 0) ? 0 : EAGLE_DONT_QUOTE_HASH));
+
+	    dst += eleChars;
 	}
-	for (; src != lastChar; src++) {
-	    switch (*src) {
-		case L']':
-		case L'[':
-		case L'$':
-		case L';':
-		case L' ':
-		case L'\\':
-		case L'"':
-		    *p = L'\\';
-		    p++;
-		    break;
-		case L'{':
-		case L'}':
-		    /*
-		     * It may not seem necessary to backslash braces, but
-		     * it is.  The reason for this is that the resulting
-		     * list element may actually be an element of a sub-list
-		     * enclosed in braces (e.g. if Tcl_DStringStartSublist
-		     * has been invoked), so there may be a brace mismatch
-		     * if the braces aren't backslashed.
-		     */
+	lengths[n] = (SIZE_T)(dst - start);
+	*dst++ = 0;
+    }
+    *dst = 0;
 
-		    if (flags & EAGLE_BRACES_UNMATCHED) {
-			*p = L'\\';
-			p++;
-		    }
-		    break;
-		case L'\f':
-		    *p = L'\\';
-		    p++;
-		    *p = L'f';
-		    p++;
-		    continue;
-		case L'\n':
-		    *p = L'\\';
-		    p++;
-		    *p = L'n';
-		    p++;
-		    continue;
-		case L'\r':
-		    *p = L'\\';
-		    p++;
-		    *p = L'r';
-		    p++;
-		    continue;
-		case L'\t':
-		    *p = L'\\';
-		    p++;
-		    *p = L't';
-		    p++;
-		    continue;
-		case L'\v':
-		    *p = L'\\';
-		    p++;
-		    *p = L'v';
-		    p++;
-		    continue;
-	    }
-	    *p = *src;
-	    p++;
+    if (flagPtr != localFlags) {
+	EagleFreeScratch(flagPtr);
+    }
+
+    *ppLengths = lengths;
+    *ppText = text;
+
+    return EAGLE_OK;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_StringMatch --
+ *
+ *	Matches a string against a glob pattern, using the same semantics
+ *	as the [string match] command.  The pattern is not compiled first;
+ *	therefore, when the same pattern will be used to match many strings,
+ *	the Eagle_CompilePattern and Eagle_StringMatchMany functions should
+ *	be used instead.
+ *
+ * Results:
+ *	Non-zero if the string matches the pattern, zero otherwise.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+BOOL
+Eagle_StringMatch(
+    SIZE_T textLength,		/* Length of the string, in characters. */
+    LPCWSTR pText,		/* The string to match. */
+    SIZE_T patternLength,	/* Length of the pattern, in characters. */
+    LPCWSTR pPattern,		/* The glob pattern. */
+    INT flags)			/* The EAGLE_MATCH_* flags. */
+{
+    assert(textLength >= 0);
+    assert((textLength == 0) || (pText != NULL));
+    assert(patternLength >= 0);
+    assert((patternLength == 0) || (pPattern != NULL));
+
+    return EagleMatchGeneric(pText, textLength, pPattern, patternLength,
+	flags);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_CompilePattern --
+ *
+ *	Compiles a glob pattern for use with the Eagle_StringMatchMany
+ *	function.  The pattern text is copied and, if necessary, folded.
+ *	Patterns that consist of only literal characters, optionally
+ *	preceded and/or followed by asterisks, are recognized so that they
+ *	can be matched without using the generic algorithm.
+ *
+ * Results:
+ *	A standard Eagle return code.
+ *
+ * Side effects:
+ *	Memory is allocated.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+RETURNCODE
+Eagle_CompilePattern(
+    SIZE_T length,		/* Length of the pattern, in characters. */
+    LPCWSTR pPattern,		/* The glob pattern. */
+    INT flags,			/* The EAGLE_MATCH_* flags. */
+    LPMATCH_PATTERN *ppPattern,	/* The newly compiled pattern. */
+    LPCWSTR *ppError)		/* The error message, if any. */
+{
+    LPMATCH_PATTERN pCompiled;
+    SIZE_T allocSize, index;
+
+    assert(length >= 0);
+    assert((length == 0) || (pPattern != NULL));
+    assert(ppPattern != NULL);
+    assert(ppError != NULL);
+
+    if (length > ((LIBRARY_MAXIMUM_SIZE_T - (SIZE_T)sizeof(MATCH_PATTERN)) /
+	    (SIZE_T)(2 * sizeof(WCHAR)))) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("pattern is too long (%zu)"), length);
+	}
+	return EAGLE_ERROR;
+    }
+
+    allocSize = (SIZE_T)sizeof(MATCH_PATTERN) +
+	(2 * length * (SIZE_T)sizeof(WCHAR));
+    pCompiled = EagleAllocateBuffer(allocSize, FALSE,
+	EAGLE_MEMORY_SITE_OTHER);
+    if (pCompiled == NULL) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("out of memory for pattern (%zu)"),
+		allocSize);
 	}
+	return EAGLE_ERROR;
     }
-    return (SIZE_T)(p - dst);
+
+    pCompiled->flags = flags;
+    pCompiled->length = length;
+    pCompiled->pPattern = (LPWSTR)(pCompiled + 1);
+    pCompiled->pLiteral = pCompiled->pPattern + length;
+
+    for (index = 0; index < length; index++) {
+	pCompiled->pPattern[index] = (flags & EAGLE_MATCH_NO_CASE) ?
+	    EagleFoldCase(pPattern[index]) : pPattern[index];
+    }
+
+    pCompiled->kind = EagleClassifyPattern(pCompiled->pPattern, length,
+	pCompiled->pLiteral, &pCompiled->literalLength);
+
+    *ppPattern = pCompiled;
+
+    return EAGLE_OK;
 }
-
+
 /*
  *---------------------------------------------------------------------------
  *
- * EagleFindElement --
+ * Eagle_StringMatchMany --
  *
- *	Given a pointer into a Tcl list, locate the first (or next) element
- *	in the list.
+ *	Matches each string in a collection against a compiled glob pattern.
+ *	The results are stored in a bitmap supplied by the caller, which
+ *	must contain at least one bit per string, rounded up to a whole
+ *	byte.  The bit for each string is at the index of that string.  A
+ *	NULL string is treated as an empty string.
  *
  * Results:
- *	The return value is normally EAGLE_OK, which means that the element
- *	was successfully located.  If EAGLE_ERROR is returned it means that
- *	list didn't have proper list structure; the interp's result contains
- *	a more detailed error message.
- *
- *	If EAGLE_OK is returned, then *elementPtr will be set to point to
- *	the first element of list, and *nextPtr will be set to point to the
- *	character just after any white space following the last character
- *	that's part of the element. If this is the last argument in the
- *	list, then *nextPtr will point just after the last character in the
- *	list (i.e., at the character at list+listLength). If sizePtr is
- *	non-NULL, *sizePtr is filled in with the number of characters in the
- *	element.  If the element is in braces, then *elementPtr will point
- *	to the character after the opening brace and *sizePtr will not
- *	include either of the braces. If there isn't an element in the list,
- *	*sizePtr will be zero, and both *elementPtr and *termPtr will point
- *	just after the last character in the list. Note: this procedure does
- *	NOT collapse backslash sequences.
+ *	A standard Eagle return code.
  *
  * Side effects:
  *	None.
@@ -1443,320 +8518,413 @@ EagleConvertCountedElement(
  *---------------------------------------------------------------------------
  */
 
-static RETURNCODE
-EagleFindElement(
-    LPCWSTR list,		/* Points to the first character of a string
-				 * containing a Tcl list with zero or more
-				 * elements (possibly in braces). */
-    SIZE_T listLength,		/* Number of characters in the string. */
-    LPCWSTR *elementPtr,	/* Where to put address of first significant
-				 * character in first element of list. */
-    LPCWSTR *nextPtr,		/* Fill in with location of character just
-				 * after all white space following end of
-				 * argument (next arg or end of list). */
-    SIZE_T *sizePtr,		/* If non-zero, fill in with size of
-				 * element. */
-    LPBOOL bracePtr,		/* If non-zero, fill in with non-zero/zero
-				 * to indicate that arg was/wasn't
-				 * in braces. */
-    LPCWSTR *errorPtr)		/* Where to put the error message, if any. */
+RETURNCODE
+Eagle_StringMatchMany(
+    LPMATCH_PATTERN pPattern,	/* The compiled glob pattern. */
+    SIZE_T elementCount,	/* The number of strings present. */
+    LPCSIZE_T pElementLengths,	/* The lengths of the strings. */
+    LPCWSTR *ppElements,	/* The strings to match. */
+    LPBYTE pBitmap,		/* OUT: One bit per string, set if that
+				 * string matches the pattern. */
+    LPSIZE_T pMatchCount,	/* OUT: Number of matching strings. */
+    LPCWSTR *ppError)		/* The error message, if any. */
 {
-    LPCWSTR p = list;
-    LPCWSTR elemStart;		/* Points to first character of first element. */
-    LPCWSTR limit;		/* Points just after list's last character. */
-    int openBraces = 0;		/* Brace nesting level during parse. */
-    BOOL inQuotes = FALSE;
-    SIZE_T size = 0;		/* lint. */
-    SIZE_T numChars;
-    LPCWSTR p2;
+    SIZE_T i, matchCount = 0;
 
-    assert(list != NULL);
-    assert(listLength >= 0);
-    assert(elementPtr != NULL);
-    assert(nextPtr != NULL);
+    assert(elementCount >= 0);
 
-    /*
-     * Skim off leading white space and check for an opening brace or
-     * quote. We treat embedded NULs in the list as characters belonging
-     * to a list element.
-     */
+#if !defined(USE_SYSSTRINGLEN) || !USE_SYSSTRINGLEN
+    assert((elementCount == 0) || (pElementLengths != NULL));
+#else
+    assert(pElementLengths == NULL);
+#endif
 
-    limit = (list + listLength);
-    while ((p < limit) && iswspace(*p)) { /* INTL: ISO space. */
-	p++;
-    }
-    if (p == limit) { /* no element found */
-	elemStart = limit;
-	goto done;
+    assert((elementCount == 0) || (ppElements != NULL));
+    assert((elementCount == 0) || (pBitmap != NULL));
+    assert(pMatchCount != NULL);
+    assert(ppError != NULL);
+
+    if (pPattern == NULL) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0, UNICODIFY("invalid pattern"));
+	}
+	return EAGLE_ERROR;
     }
 
-    if (*p == L'{') {
-	openBraces++;
-	p++;
-    } else if (*p == L'"') {
-	inQuotes = TRUE;
-	p++;
+    if (elementCount > 0)
+	memset(pBitmap, 0, (elementCount + 7) / 8);
+
+    for (i = 0; i < elementCount; i++) {
+	LPCWSTR pText = ppElements[i];
+	SIZE_T textLength = (pText != NULL) ?
+	    SysStringLenWrapper(i) /* NON-PORTABLE? */ : 0;
+
+	if (EagleMatchPattern(pPattern, pText, textLength)) {
+	    pBitmap[i / 8] |= (BYTE)(1 << (i % 8));
+	    matchCount++;
+	}
     }
-    elemStart = p;
 
-    /*
-     * Find element's end (a space, close brace, or the end of the string).
-     */
+    *pMatchCount = matchCount;
 
-    while (p < limit) {
-	switch (*p) {
+    return EAGLE_OK;
+}
 
-	    /*
-	     * Open brace: don't treat specially unless the element is in
-	     * braces. In this case, keep a nesting count.
-	     */
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_FreePattern --
+ *
+ *	Frees a glob pattern that was compiled by Eagle_CompilePattern.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Memory is freed.
+ *
+ *---------------------------------------------------------------------------
+ */
 
-	    case L'{':
-		if (openBraces != 0) {
-		    openBraces++;
-		}
-		break;
+VOID
+Eagle_FreePattern(
+    LPMATCH_PATTERN pPattern)	/* The compiled pattern to free. */
+{
+    Eagle_FreeMemory(pPattern);
+}
 
-	    /*
-	     * Close brace: if element is in braces, keep nesting count and
-	     * quit when the last close brace is seen.
-	     */
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Eagle_ParseScript --
+ *
+ *	Parses every command in a script, producing the same tokens as the
+ *	managed Parser.ParseScript method, in one call.  Each command is
+ *	preceded by a separator token.  The tokens of nested commands are
+ *	not included, just like the managed parser.  The state of the parser
+ *	after the last command is recorded as well.  Any syntax error causes
+ *	the whole parse to fail; the managed parser should then be used to
+ *	obtain the partial results and error details.
+ *
+ * Results:
+ *	A standard Eagle return code.  The token array must be freed using
+ *	the Eagle_FreeMemory function.
+ *
+ * Side effects:
+ *	Memory is allocated.
+ *
+ *---------------------------------------------------------------------------
+ */
 
-	    case L'}':
-		if (openBraces > 1) {
-		    openBraces--;
-		} else if (openBraces == 1) {
-		    size = (SIZE_T)(p - elemStart);
-		    p++;
-		    if ((p >= limit)
-			    || iswspace(*p)) { /* INTL: ISO space. */
-			goto done;
-		    }
+RETURNCODE
+Eagle_ParseScript(
+    SIZE_T length,		/* Length of the script, in characters. */
+    LPCWSTR pText,		/* The script text. */
+    INT flags,			/* The EAGLE_PARSE_* flags. */
+    LPSCRIPT_STATE pState,	/* OUT: The final parser state. */
+    LPSIZE_T pTokenCount,	/* OUT: The number of tokens. */
+    LPSCRIPT_TOKEN *ppTokens,	/* OUT: The array of tokens. */
+    LPCWSTR *ppError)		/* The error message, if any. */
+{
+    TOKEN_BUFFER buffer;
+    PARSE_STATE state;
+    SCRIPT_TOKEN token;
+    LPSCRIPT_TOKEN pSeparator;
+    LPCWSTR pError = NULL;
+    SIZE_T separatorIndex, index = 0, commandCount = 0;
+    BOOL nested = (flags & EAGLE_PARSE_NESTED) ? TRUE : FALSE;
 
-		    /*
-		     * Garbage after the closing brace; return an error.
-		     */
+    assert(length >= 0);
+    assert((length == 0) || (pText != NULL));
+    assert(pState != NULL);
+    assert(pTokenCount != NULL);
+    assert(ppTokens != NULL);
+    assert(ppError != NULL);
 
-		    if (errorPtr != NULL) {
-			p2 = p;
-			while ((p2 < limit)
-				&& (!iswspace(*p2)) /* INTL: ISO space. */
-				&& (p2 < (p + 20))) {
-			    p2++;
-			}
-			*errorPtr = EaglePrintf(0,
-				L"list element in braces followed by "
-				L"\"%.*ls\" %ls", (int)(p2 - p), p,
-				L"instead of space");
-		    }
-		    return EAGLE_ERROR;
-		}
-		break;
+    if ((pState == NULL) || (pTokenCount == NULL) || (ppTokens == NULL)) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("invalid output parameters"));
+	}
+	return EAGLE_ERROR;
+    }
 
-	    /*
-	     * Backslash:  skip over everything up to the end of the
-	     * backslash sequence.
-	     */
+    memset(&buffer, 0, sizeof(TOKEN_BUFFER));
+    memset(&state, 0, sizeof(PARSE_STATE));
 
-	    case L'\\': {
-		EagleParseBackslash(p, (SIZE_T)(limit - p), &numChars, NULL);
-		p += (numChars - 1);
-		break;
-	    }
+    state.pText = pText;
+    state.length = length;
+    state.flags = flags;
+    state.pBuffer = &buffer;
 
-	    /*
-	     * Space: ignore if element is in braces or quotes; otherwise
-	     * terminate element.
-	     */
+    while (1) {
+	/*
+	 * The separator for each command comes before its tokens; however,
+	 * it cannot be filled in until the command has been parsed.
+	 */
 
-	    case L' ':
-	    case L'\f':
-	    case L'\n':
-	    case L'\r':
-	    case L'\t':
-	    case L'\v':
-		if ((openBraces == 0) && !inQuotes) {
-		    size = (SIZE_T)(p - elemStart);
-		    goto done;
-		}
-		break;
+	separatorIndex = buffer.count;
+	EagleInitToken(&state, &token);
 
-	    /*
-	     * Double-quote: if element is in quotes then terminate it.
-	     */
+	if (!EagleAddToken(&state, &token, &pError))
+	    goto error;
 
-	    case L'"':
-		if (inQuotes) {
-		    size = (SIZE_T)(p - elemStart);
-		    p++;
-		    if ((p >= limit)
-			    || iswspace(*p)) { /* INTL: ISO space */
-			goto done;
-		    }
+	state.firstToken = buffer.count;
 
-		    /*
-		     * Garbage after the closing quote; return an error.
-		     */
+	if (EagleParseCommand(&state, index, nested, &pError) != EAGLE_OK)
+	    goto error;
 
-		    if (errorPtr != NULL) {
-			p2 = p;
-			while ((p2 < limit)
-				&& (!iswspace(*p2)) /* INTL: ISO space */
-				&& (p2 < (p + 20))) {
-			    p2++;
-			}
-			*errorPtr = EaglePrintf(0,
-				L"list element in quotes followed by "
-				L"\"%.*ls\" %ls", (int)(p2 - p), p,
-				L"instead of space");
-		    }
-		    return EAGLE_ERROR;
-		}
-		break;
-	}
-	p++;
-    }
+	commandCount++;
 
-    /*
-     * End of list: terminate element.
-     */
+	pSeparator = &buffer.pTokens[separatorIndex];
+	EagleInitToken(&state, pSeparator);
+	pSeparator->type = EAGLE_TOKEN_SEPARATOR;
+	pSeparator->start = state.commandStart;
+	pSeparator->length = state.commandLength;
+	pSeparator->components = commandCount;
+
+	index = state.commandStart + state.commandLength;
 
-    if (p == limit) {
-	if (openBraces != 0) {
-	    if (errorPtr != NULL) {
-		*errorPtr = EaglePrintf(0, L"unmatched open brace in list");
-	    }
-	    return EAGLE_ERROR;
-	} else if (inQuotes) {
-	    if (errorPtr != NULL) {
-		*errorPtr = EaglePrintf(0, L"unmatched open quote in list");
-	    }
-	    return EAGLE_ERROR;
-	}
-	size = (SIZE_T)(p - elemStart);
+	if (index >= length)
+	    break;
     }
 
-done:
+    pState->currentLine = state.currentLine;
+    pState->lineStart = state.lineStart;
+    pState->commentStart = state.commentStart;
+    pState->commentLength = state.commentLength;
+    pState->commandStart = state.commandStart;
+    pState->commandLength = state.commandLength;
+    pState->commandWords = state.commandWords;
+    pState->terminator = state.terminator;
+    pState->incomplete = state.incomplete ? 1 : 0;
+    pState->commandCount = commandCount;
 
-    while ((p < limit) && iswspace(*p)) { /* INTL: ISO space. */
-	p++;
-    }
-    *elementPtr = elemStart;
-    *nextPtr = p;
-    if (sizePtr != NULL) {
-	*sizePtr = size;
-    }
-    if (bracePtr != NULL) {
-	*bracePtr = (openBraces != 0);
-    }
+    *pTokenCount = buffer.count;
+    *ppTokens = buffer.pTokens;
 
     return EAGLE_OK;
+
+error:
+    Eagle_FreeMemory(buffer.pTokens);
+
+    /*
+     * The parsing helpers always produce an error message; the caller may
+     * not want it.
+     */
+
+    if (ppError != NULL) {
+	*ppError = pError;
+    } else {
+	Eagle_FreeMemory((LPVOID)pError);
+    }
+
+    return EAGLE_ERROR;
 }
-
+
 /*
  *---------------------------------------------------------------------------
  *
- * Eagle_GetVersion --
+ * Eagle_SubstBackslashes --
  *
- *	This function returns the string representation of the version of
- *	this library.
+ *	Performs backslash substitution on a string, producing the same
+ *	result as the managed [subst -nocommands -novariables] command, in
+ *	one call.  The runs of characters without any backslash are found
+ *	using the fastest instruction set supported by the processor and
+ *	then copied all at once.  The result is never longer than the
+ *	original string.
  *
  * Results:
- *	The string representation of the version of this library -OR- NULL if
- *	the version cannot be obtained.
+ *	A standard Eagle return code.  The resulting string is terminated by
+ *	a NUL character and must be freed using the Eagle_FreeMemory
+ *	function.
  *
  * Side effects:
- *	None.
+ *	Memory is allocated.
  *
  *---------------------------------------------------------------------------
  */
 
-LPCWSTR
-Eagle_GetVersion(VOID)
+RETURNCODE
+Eagle_SubstBackslashes(
+    SIZE_T length,		/* Length of the string, in characters. */
+    LPCWSTR pText,		/* The string to substitute. */
+    LPSIZE_T pLength,		/* OUT: The length of the result. */
+    LPCWSTR *ppText,		/* OUT: The resulting string. */
+    LPCWSTR *ppError)		/* The error message, if any. */
 {
-    SIZE_T size = (LIBRARY_VERSION_LENGTH + 1 /* NUL */) * sizeof(WCHAR);
-    LPWSTR pBuffer = AllocateMemoryWrapper(size); /* HACK: Always calloc(). */
+    SIZE_T allocSize;
+    LPWSTR result;
 
-    if (pBuffer == NULL) {
-	return NULL;
+    assert(length >= 0);
+    assert((length == 0) || (pText != NULL));
+    assert(pLength != NULL);
+    assert(ppText != NULL);
+    assert(ppError != NULL);
+
+    if ((pLength == NULL) || (ppText == NULL)) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("invalid output parameters"));
+	}
+	return EAGLE_ERROR;
     }
 
-    swprintf(pBuffer, LIBRARY_VERSION_LENGTH, LIBRARY_VERSION_FORMAT,
-	LIBRARY_UNICODE_NAME, LIBRARY_UNICODE_PATCH_LEVEL,
-	LIBRARY_UNICODE_SOURCE_ID, LIBRARY_UNICODE_SOURCE_TIMESTAMP,
-#if defined(_DEBUG)
-	L" DEBUG",
-#else
-	L" RELEASE",
-#endif
-	L" SIZE_OF_WCHAR_T=", (int)sizeof(WCHAR),
-#if defined(USE_32BIT_SIZE_T)
-	L" USE_32BIT_SIZE_T=" UNICODIFY(STRINGIFY(USE_32BIT_SIZE_T)),
-#else
-	L"",
-#endif
-#if defined(USE_SYSSTRINGLEN)
-	L" USE_SYSSTRINGLEN=" UNICODIFY(STRINGIFY(USE_SYSSTRINGLEN)),
-#else
-	L"",
-#endif
-#if defined(USE_HEAPAPI)
-	L" USE_HEAPAPI=" UNICODIFY(STRINGIFY(USE_HEAPAPI))
-#else
-	L""
-#endif
-    );
+    allocSize = (length + 1) * sizeof(WCHAR);
+    assert(allocSize > 0);
+    assert(allocSize <= LIBRARY_MAXIMUM_SIZE_T);
+    result = EagleAllocateBuffer(allocSize, FALSE,
+	EAGLE_MEMORY_SITE_PARSE);
+    if (result == NULL) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("out of memory for substituted text (%zu)"),
+		allocSize);
+	}
+	return EAGLE_ERROR;
+    }
 
-#if defined(USE_WCHARSTRTOUSHORTSTR) && USE_WCHARSTRTOUSHORTSTR
-    EagleWcharStrToUshortStr(pBuffer);
-#endif
+    length = (length > 0) ? EagleCopyAndCollapse(length, pText, result) : 0;
+    result[length] = 0;
 
-    return pBuffer;
+    *pLength = length;
+    *ppText = result;
+
+    return EAGLE_OK;
 }
-
+
 /*
  *---------------------------------------------------------------------------
  *
- * Eagle_FreeVersion --
+ * Eagle_ParseNumbers --
  *
- *	This function frees the string representation of the version of
- *	this library.
+ *	Parses every element of a list as a wide integer, in one call,
+ *	without creating a string for any of them.  Elements with backslash
+ *	sequences are collapsed first, on the stack.  See the function
+ *	EagleParseWideInteger for the accepted syntax.
  *
  * Results:
- *	None.
+ *	A standard Eagle return code.  Upon success, the array of values, one
+ *	per element, must be freed using the Eagle_FreeMemory function.  It
+ *	is an error if any element is not a valid wide integer.
  *
  * Side effects:
- *	None.
+ *	Memory is allocated.
  *
  *---------------------------------------------------------------------------
  */
 
-VOID
-Eagle_FreeVersion(
-    LPVOID pVersion)	/* The memory block to free.  This memory block must
-			 * have been obtained from Eagle_GetVersion. */
+RETURNCODE
+Eagle_ParseNumbers(
+    SIZE_T length,		/* Length of string with list structure. */
+    LPCWSTR pText,		/* Pointer to string with list structure. */
+    LPSIZE_T pElementCount,	/* OUT: The number of list elements. */
+    LPWIDEINT *ppValues,	/* OUT: The value of each list element. */
+    LPCWSTR *ppError)		/* The error message, if any. */
 {
-    if (pVersion == NULL)
-	return;
+    LPCWSTR list, element;
+    SIZE_T listLength, count, index, elSize, allocSize;
+    LPWIDEINT values;
+    BOOL literal;
+    RETURNCODE result;
 
-    FreeMemoryWrapper(pVersion); /* HACK: Always free(). */
+    assert(length >= 0);
+    assert((length == 0) || (pText != NULL));
+    assert(pElementCount != NULL);
+    assert(ppValues != NULL);
+    assert(ppError != NULL);
+
+    if ((pElementCount == NULL) || (ppValues == NULL)) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("invalid output parameters"));
+	}
+	return EAGLE_ERROR;
+    }
+
+    /*
+     * NOTE: First, count the elements.  This also makes sure the whole
+     *       list has proper list structure before anything is allocated.
+     */
+    result = Eagle_CountListElements(length, pText, &count, ppError);
+    if (result != EAGLE_OK) {
+	return result;
+    }
+
+    allocSize = ((count > 0) ? count : 1) * sizeof(WIDEINT);
+    assert(allocSize > 0);
+    assert(allocSize <= LIBRARY_MAXIMUM_SIZE_T);
+    values = EagleAllocateBuffer(allocSize, FALSE,
+	EAGLE_MEMORY_SITE_QUERY);
+    if (values == NULL) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("out of memory for number values (%zu)"),
+		allocSize);
+	}
+	return EAGLE_ERROR;
+    }
+
+    list = pText;
+    listLength = length;
+    for (index = 0; index < count; index++) {
+	LPCWSTR prevList = list;
+	BOOL valid;
+
+	result = EagleFindElement(list, listLength, &element, &list,
+				  &elSize, NULL, &literal, ppError);
+	if (result != EAGLE_OK) {
+	    Eagle_FreeMemory(values);
+	    return result;
+	}
+	listLength -= (SIZE_T)(list - prevList);
+	assert(element != pText + length);
+
+	if (literal) {
+	    valid = EagleParseWideInteger(element, elSize, &values[index]);
+	} else {
+	    /*
+	     * NOTE: Collapsing never makes an element longer.  Any element
+	     *       that is too long for this buffer is simply rejected; it
+	     *       is extremely unlikely to be a number.
+	     */
+	    WCHAR buffer[LIBRARY_NUMBER_BUFFER_LENGTH];
+
+	    valid = (elSize <= LIBRARY_NUMBER_BUFFER_LENGTH) &&
+		EagleParseWideInteger(buffer, EagleCopyAndCollapse(elSize,
+		element, buffer), &values[index]);
+	}
+
+	if (!valid) {
+	    Eagle_FreeMemory(values);
+	    if (ppError != NULL) {
+		*ppError = EaglePrintf(0,
+		    UNICODIFY("expected wide integer for list element %zu"),
+		    index);
+	    }
+	    return EAGLE_ERROR;
+	}
+    }
+
+    *pElementCount = count;
+    *ppValues = values;
+
+    return EAGLE_OK;
 }
-
-#if defined(USE_HEAPAPI) && USE_HEAPAPI
+
 /*
  *---------------------------------------------------------------------------
  *
- * Eagle_SetMemoryHeap --
+ * EagleCompareSortElements --
  *
- *	This function sets or resets the memory heap handle to use when
- *	allocating and freeing memory.  This function is only available
- *	when using the Win32 API.  This function is not thread-safe and
- *	it should only be used when no other threads can call into this
- *	library.
+ *	Compares two elements of a list being sorted by Eagle_SortList.
+ *	Integer keys are compared by value.  Strings are compared by their
+ *	code units, with the ASCII letters optionally folded to upper case;
+ *	this matches the ordinal comparisons used by the managed code.
  *
  * Results:
- *	The previous value of the memory heap handle -OR- NULL if it was
- *	not previously set.
+ *	Less than zero, zero, or greater than zero if the first element
+ *	sorts before, with, or after the second element, respectively.
  *
  * Side effects:
  *	None.
@@ -1764,414 +8932,584 @@ Eagle_FreeVersion(
  *---------------------------------------------------------------------------
  */
 
-HANDLE
-Eagle_SetMemoryHeap(
-    HANDLE hNewHeap)	/* The memory heap handle to use when allocating
-			 * or freeing memory. */
+static INT
+EagleCompareSortElements(
+    LPSORT_CONTEXT pContext,	/* The elements being sorted. */
+    SIZE_T index1,		/* Index of the first element. */
+    SIZE_T index2)		/* Index of the second element. */
 {
-    HANDLE hOldHeap = hMemoryHeap;
+    INT result = 0;
 
-    assert((hOldHeap == NULL) || HeapValidate(hOldHeap, 0, NULL));
-    assert((hNewHeap == NULL) || HeapValidate(hNewHeap, 0, NULL));
-    assert(memoryBytesAllocated == 0);
+    if (pContext->pKeys != NULL) {
+	WIDEINT key1 = pContext->pKeys[index1];
+	WIDEINT key2 = pContext->pKeys[index2];
 
-    hMemoryHeap = hNewHeap;
+	if (key1 != key2)
+	    result = (key1 < key2) ? -1 : 1;
+    } else {
+	LPCSIZE_T pElementLengths = pContext->pElementLengths;
+	LPCWSTR *ppElements = pContext->ppElements;
+	LPCWSTR pText1 = ppElements[index1];
+	LPCWSTR pText2 = ppElements[index2];
+	SIZE_T length1 = (pText1 != NULL) ?
+	    SysStringLenWrapper(index1) /* NON-PORTABLE? */ : 0;
+	SIZE_T length2 = (pText2 != NULL) ?
+	    SysStringLenWrapper(index2) /* NON-PORTABLE? */ : 0;
+	SIZE_T length = (length1 < length2) ? length1 : length2;
+	SIZE_T index;
+
+	for (index = 0; index < length; index++) {
+	    WCHAR c1 = pText1[index];
+	    WCHAR c2 = pText2[index];
+
+	    if (pContext->noCase) {
+		if ((c1 >= 'a') && (c1 <= 'z'))
+		    c1 -= ('a' - 'A');
+
+		if ((c2 >= 'a') && (c2 <= 'z'))
+		    c2 -= ('a' - 'A');
+	    }
 
-    return hOldHeap;
+	    if (c1 != c2) {
+		result = (c1 < c2) ? -1 : 1;
+		break;
+	    }
+	}
+
+	if ((result == 0) && (length1 != length2))
+	    result = (length1 < length2) ? -1 : 1;
+    }
+
+    return pContext->decreasing ? -result : result;
 }
-#endif
-
+
 /*
  *---------------------------------------------------------------------------
  *
- * Eagle_AllocateMemory --
+ * EagleMergeSortRuns --
  *
- *	This function allocates a block of memory of at least the specified
- *	size.
+ *	Merges two adjacent sorted runs of element indexes.  The merge is
+ *	stable, i.e. elements that compare equal keep their order.  Either
+ *	run may be empty.
  *
  * Results:
- *	The pointer to the new memory block -OR- NULL if the memory could not
- *	be obtained.
+ *	None.
  *
  * Side effects:
- *	None.
+ *	The target indexes, from start to limit, are replaced.
  *
  *---------------------------------------------------------------------------
  */
 
-LPVOID
-Eagle_AllocateMemory(
-    SIZE_T size)	/* The size, in bytes, of the memory block to be
-			 * allocated. */
+static VOID
+EagleMergeSortRuns(
+    LPSORT_CONTEXT pContext,	/* The elements being sorted. */
+    LPCSIZE_T pSource,		/* The element indexes to merge. */
+    LPSIZE_T pTarget,		/* OUT: The merged element indexes. */
+    SIZE_T start,		/* Index where the first run starts. */
+    SIZE_T middle,		/* Index where the second run starts. */
+    SIZE_T limit)		/* One past the end of the second run. */
 {
-    LPVOID pMemory = NULL;
-    SIZE_T memorySize;
-
-    assert(sizeof(BYTE) >= 1);
-    assert(size >= 0);
+    SIZE_T left = start, right = middle, index = start;
 
-    if (size > 0) {
-	assert(size <= LIBRARY_MAXIMUM_SIZE_T);
-	pMemory = EagleAllocateMemory(size);
+    while ((left < middle) && (right < limit)) {
+	if (EagleCompareSortElements(pContext, pSource[right],
+		pSource[left]) < 0) {
+	    pTarget[index++] = pSource[right++];
+	} else {
+	    pTarget[index++] = pSource[left++];
+	}
     }
 
-    memorySize = EagleMemorySize(pMemory);
-
-    if (pMemory != NULL) {
-	memoryBytesAllocated += memorySize;
-
-	LIBRARY_DEBUG(("Eagle_AllocateMemory: 0x%p, requested %d bytes, "
-	    "received %d bytes, total now %d bytes\n", pMemory, (int)size,
-	    (int)memorySize, (int)memoryBytesAllocated));
-    } else {
-	LIBRARY_TRACE(("Eagle_AllocateMemory: out of memory (%d)\n",
-	    (int)size));
+    if (left < middle) {
+	memcpy(pTarget + index, pSource + left,
+	    (middle - left) * sizeof(SIZE_T));
+    } else if (right < limit) {
+	memcpy(pTarget + index, pSource + right,
+	    (limit - right) * sizeof(SIZE_T));
     }
-
-    return pMemory;
 }
-
+
 /*
  *---------------------------------------------------------------------------
  *
- * Eagle_FreeMemory --
+ * EagleSortChunk --
  *
- *	This function frees a block of memory that was previously allocated
- *	by the Eagle_AllocateMemory function.
+ *	Sorts one range of the elements of a list.  The integer keys for
+ *	the range are parsed first, exactly once.  Then, short runs are
+ *	sorted by insertion and merged, back and forth between the source
+ *	and the scratch space, until the whole range is sorted.
  *
  * Results:
  *	None.
  *
  * Side effects:
- *	None.
+ *	The task is updated.  Upon success, the source indexes, from start
+ *	to limit, are sorted.  The error message format, if any, is static.
  *
  *---------------------------------------------------------------------------
  */
 
-VOID
-Eagle_FreeMemory(
-    LPVOID pMemory)	/* The memory block to free.  This memory block must
-			 * have been obtained from Eagle_AllocateMemory. */
+static VOID
+EagleSortChunk(
+    LPSORT_TASK pTask)		/* The range to sort. */
 {
-    SIZE_T size;
+    LPSORT_CONTEXT pContext = pTask->pContext;
+    LPCSIZE_T pElementLengths = pContext->pElementLengths;
+    LPCWSTR *ppElements = pContext->ppElements;
+    LPSIZE_T pSource = pTask->pSource;
+    LPSIZE_T pTarget = pTask->pTarget;
+    SIZE_T start = pTask->start;
+    SIZE_T limit = pTask->limit;
+    SIZE_T index, width;
+
+    for (index = start; index < limit; index++) {
+	LPCWSTR pText = ppElements[index];
+	SIZE_T length = (pText != NULL) ?
+	    SysStringLenWrapper(index) /* NON-PORTABLE? */ : 0;
+
+	pSource[index] = index;
+
+	if (pContext->pKeys != NULL) {
+	    /*
+	     * NOTE: The keys are limited to half of the range of a wide
+	     *       integer.  The managed comparer subtracts the values,
+	     *       which cannot overflow within this range.
+	     */
+	    WIDEINT key;
+
+	    if ((pText == NULL) ||
+		    !EagleParseWideInteger(pText, length, &key)) {
+		pTask->pFormat = UNICODIFY(
+		    "expected wide integer for list element %zu");
+		pTask->errorIndex = index;
+		return;
+	    }
 
-    if (pMemory == NULL)
-	return;
+	    if ((key < -((WIDEINT)1 << 62)) || (key >= ((WIDEINT)1 << 62))) {
+		pTask->pFormat = UNICODIFY(
+		    "wide integer for list element %zu is too large");
+		pTask->errorIndex = index;
+		return;
+	    }
 
-    size = EagleMemorySize(pMemory);
+	    pContext->pKeys[index] = key;
+	} else if (pContext->noCase) {
+	    SIZE_T offset;
 
-#if !defined(NDEBUG)
-    memset(pMemory, LIBRARY_FREED_MEMORY, size);
-#endif
+	    for (offset = 0; offset < length; offset++) {
+		if (pText[offset] >= 0x80) {
+		    pTask->pFormat = UNICODIFY(
+			"list element %zu has non-ASCII characters");
+		    pTask->errorIndex = index;
+		    return;
+		}
+	    }
+	}
+    }
 
-    memoryBytesAllocated -= size;
+    for (index = start; index < limit; index += LIBRARY_SORT_RUN_LENGTH) {
+	SIZE_T runLimit = (limit - index > LIBRARY_SORT_RUN_LENGTH) ?
+	    index + LIBRARY_SORT_RUN_LENGTH : limit;
+	SIZE_T next;
 
-    LIBRARY_DEBUG(("Eagle_FreeMemory: 0x%p, received %d bytes, total now "
-	"%d bytes\n", pMemory, (int)size, (int)memoryBytesAllocated));
+	for (next = index + 1; next < runLimit; next++) {
+	    SIZE_T element = pSource[next];
+	    SIZE_T hole = next;
 
-    EagleFreeMemory(pMemory);
+	    while ((hole > index) && (EagleCompareSortElements(pContext,
+		    element, pSource[hole - 1]) < 0)) {
+		pSource[hole] = pSource[hole - 1];
+		hole--;
+	    }
+
+	    pSource[hole] = element;
+	}
+    }
+
+    for (width = LIBRARY_SORT_RUN_LENGTH; width < limit - start;
+	    width *= 2) {
+	LPSIZE_T pSwap;
+
+	for (index = start; index < limit; index += 2 * width) {
+	    SIZE_T middle = (limit - index > width) ? index + width : limit;
+	    SIZE_T runLimit = (limit - middle > width) ?
+		middle + width : limit;
+
+	    EagleMergeSortRuns(pContext, pSource, pTarget, index, middle,
+		runLimit);
+	}
+
+	pSwap = pSource;
+	pSource = pTarget;
+	pTarget = pSwap;
+    }
+
+    if (pSource != pTask->pSource) {
+	memcpy(pTask->pSource + start, pSource + start,
+	    (limit - start) * sizeof(SIZE_T));
+    }
 }
-
+
 /*
  *---------------------------------------------------------------------------
  *
- * Eagle_FreeElements --
+ * EagleSortTask --
  *
- *	This function frees all memory that is being used to contain the
- *	array of list elements that was allocated by the Eagle_SplitList
- *	function.
+ *	Sorts, or merges, one range of the elements of a list.
  *
  * Results:
  *	None.
  *
  * Side effects:
- *	None.
+ *	See EagleSortChunk and EagleMergeSortRuns.
  *
  *---------------------------------------------------------------------------
  */
 
-VOID
-Eagle_FreeElements(
-    SIZE_T elementCount,	/* The number of list elements. */
-    LPWSTR *ppElements)		/* The list element array to free. */
+static VOID
+EagleSortTask(
+    LPSORT_TASK pTask)		/* The range to sort or merge. */
 {
-    /*
-     * NOTE: The space to hold the element pointers as well as the element
-     *       strings themselves is actually one big block; therefore, just
-     *       call the normal memory freeing function on it.
-     */
-
-    Eagle_FreeMemory(ppElements);
+    if (pTask->merging) {
+	EagleMergeSortRuns(pTask->pContext, pTask->pSource, pTask->pTarget,
+	    pTask->start, pTask->middle, pTask->limit);
+    } else {
+	EagleSortChunk(pTask);
+    }
 }
-
+
 /*
  *---------------------------------------------------------------------------
  *
- * Eagle_SplitList --
+ * EagleRunSortTasks --
  *
- *	Splits a list up into its constituent elements.
+ *	Sorts, or merges, all the ranges of the elements of a list, each
+ *	using its own thread.  The first range is handled by the calling
+ *	thread.  If a thread cannot be created, its range is handled by the
+ *	calling thread as well.
  *
- * Results
- *	The return value is normally EAGLE_OK, which means that the list was
- *	successfully split up.  If EAGLE_ERROR is returned, it means that
- *	"list" did not have proper list structure; in that case, the error
- *	message will contain a more details.
+ * Results:
+ *	None.
  *
  * Side effects:
- *	Memory is allocated and possibly freed.
+ *	Threads may be created and waited upon.  See EagleSortTask.
  *
  *---------------------------------------------------------------------------
  */
 
-RETURNCODE
-Eagle_SplitList(
-    SIZE_T length,		/* Length of string with list structure. */
-    LPCWSTR pText,		/* Pointer to string with list structure. */
-    LPSIZE_T pElementCount,	/* The number of list elements found. */
-    LPSIZE_T *ppElementLengths,	/* The string lengths of the list elements. */
-    LPCWSTR **pppElements,	/* The array of list elements. */
-    LPCWSTR *ppError)		/* The error message, if any. */
+static VOID
+EagleRunSortTasks(
+    LPSORT_TASK pTasks,		/* The ranges to sort or merge. */
+    SIZE_T taskCount)		/* The number of ranges. */
 {
-    LPCWSTR l, q, element;
-    LPSIZE_T argc;
-    LPWSTR *argv;
-    LPWSTR p;
-    SIZE_T allocSize;
-    SIZE_T listLength, size, i, j, elSize;
-    BOOL brace;
-    RETURNCODE result;
-
-    assert(length >= 0);
-    assert(pText != NULL);
-    assert(pElementCount != NULL);
-    assert(ppElementLengths != NULL);
-    assert(pppElements != NULL);
-    assert(ppError != NULL);
+#if defined(USE_PARALLEL_SPLIT) && USE_PARALLEL_SPLIT
+    pthread_t threads[LIBRARY_SPLIT_MAXIMUM_THREADS];
+    BOOL started[LIBRARY_SPLIT_MAXIMUM_THREADS];
+    SIZE_T index;
 
-    /*
-     * Figure out how much space to allocate.  There must be enough
-     * space for both the array of pointers and also for a copy of
-     * the list.  To estimate the number of pointers needed, count
-     * the number of space characters in the list.
-     */
+    assert(taskCount <= LIBRARY_SPLIT_MAXIMUM_THREADS);
 
-    for (size = 2, j = 0, l = pText; j < length; j++, l++) {
-	if (iswspace(*l)) { /* INTL: ISO space. */
-	    size++;
-	    /* Consecutive space can only count as a single list delimiter */
-	    while (1) {
-		WCHAR next = *(l + 1);
-		if ((j + 1) >= length) {
-		    break;
-		}
-		j++; l++;
-		if (iswspace(next)) {
-		    continue;
-		}
-		break;
-	    }
-	}
-    }
-    listLength = length;
-    allocSize = size * sizeof(SIZE_T);
-    assert(allocSize > 0);
-    assert(allocSize <= LIBRARY_MAXIMUM_SIZE_T);
-    argc = Eagle_AllocateMemory(allocSize);
-    if (argc == NULL) {
-	if (ppError != NULL) {
-	    *ppError = EaglePrintf(0,
-		L"out of memory for list element lengths (%d)",
-		(int)allocSize);
-	}
-	return EAGLE_ERROR;
-    }
-    allocSize = (size * sizeof(LPWSTR)) + ((listLength + 1) * sizeof(WCHAR));
-    assert(allocSize > 0);
-    assert(allocSize <= LIBRARY_MAXIMUM_SIZE_T);
-    argv = Eagle_AllocateMemory(allocSize);
-    if (argv == NULL) {
-	if (ppError != NULL) {
-	    *ppError = EaglePrintf(0,
-		L"out of memory for list element pointers (%d)",
-		(int)allocSize);
-	}
-	Eagle_FreeMemory(argc);
-	return EAGLE_ERROR;
+    for (index = 1; index < taskCount; index++) {
+	started[index] = (pthread_create(&threads[index], NULL,
+	    EagleSortTaskThread, &pTasks[index]) == 0);
     }
-    q = pText + length;
-    for (i = 0, p = (LPWSTR)(((LPBYTE)argv) + (size * sizeof(LPWSTR)));
-	    listLength > 0; i++) {
-	LPCWSTR prevList = pText;
 
-	result = EagleFindElement(pText, listLength, &element, &pText,
-				  &elSize, &brace, ppError);
-	if (result != EAGLE_OK) {
-	    Eagle_FreeMemory(argc);
-	    Eagle_FreeMemory(argv);
-	    return result;
-	}
-	listLength -= (SIZE_T)(pText - prevList);
-	if (element == q) {
-	    break;
-	}
-	if (i >= size) {
-	    if (ppError != NULL) {
-		*ppError = EaglePrintf(0, L"wrong estimated list size");
-	    }
-	    Eagle_FreeMemory(argc);
-	    Eagle_FreeMemory(argv);
-	    return EAGLE_ERROR;
-	}
-	if (brace) {
-	    wcsncpy(p, element, elSize);
+    if (taskCount > 0)
+	EagleSortTask(&pTasks[0]);
+
+    for (index = 1; index < taskCount; index++) {
+	if (started[index]) {
+	    pthread_join(threads[index], NULL);
 	} else {
-	    elSize = EagleCopyAndCollapse(elSize, element, p);
+	    EagleSortTask(&pTasks[index]);
 	}
-	argc[i] = elSize;
-	argv[i] = p;
-	p += elSize + 1;
     }
+#else
+    SIZE_T index;
 
-    argc[i] = 0;
-    argv[i] = NULL;
-
-    *pElementCount = i;
-    *ppElementLengths = argc;
-    *pppElements = (LPCWSTR *)argv; /* incompatible-pointer-types warning? */
-
-    return EAGLE_OK;
+    for (index = 0; index < taskCount; index++)
+	EagleSortTask(&pTasks[index]);
+#endif
 }
-
+
 /*
  *---------------------------------------------------------------------------
  *
- * Eagle_JoinList --
+ * Eagle_SortList --
  *
- *	Given a collection of strings, merge them together into a single
- *	string that has proper Tcl list structure (i.e. Eagle_SplitList may
- *	be used to retrieve strings equal to the original elements).
+ *	Sorts the elements of a list, using a merge sort.  Very large lists
+ *	are split into chunks that are sorted by their own threads and then
+ *	merged, in pairs, also by their own threads.  In the integer mode,
+ *	the key for each element is parsed exactly once.  Elements that
+ *	compare equal must also be identical; otherwise, their order would
+ *	depend upon the sort algorithm and this function fails, so that the
+ *	caller can fall back to its own sort.
  *
  * Results:
- *	A standard Eagle return code.
+ *	A standard Eagle return code.  Upon success, the array of indexes,
+ *	one per element, holds the original index of each element in sorted
+ *	order and must be freed using the Eagle_FreeMemory function.
  *
  * Side effects:
- *	Memory is allocated and possibly freed.
+ *	Memory is allocated.  Threads may be created and waited upon.
  *
  *---------------------------------------------------------------------------
  */
 
 RETURNCODE
-Eagle_JoinList(
-    SIZE_T elementCount,	/* The number of list elements present. */
-    LPCSIZE_T pElementLengths,	/* The string lengths of the list elements. */
-    LPCWSTR *ppElements,	/* The list elements. */
-    LPSIZE_T pLength,		/* The string length of the resulting list. */
-    LPCWSTR *ppText,		/* The textual representation of the list. */
+Eagle_SortList(
+    SIZE_T elementCount,	/* The number of elements present. */
+    LPCSIZE_T pElementLengths,	/* The lengths of the elements. */
+    LPCWSTR *ppElements,	/* The elements to sort. */
+    INT flags,			/* The EAGLE_SORT_* flags to use. */
+    LPSIZE_T *ppIndexes,	/* OUT: The sorted element indexes. */
     LPCWSTR *ppError)		/* The error message, if any. */
 {
-    FLAGS localFlags[LIBRARY_LOCAL_FLAGS], *flagPtr;
-    SIZE_T allocSize;
-    SIZE_T i, numChars;
-    LPWSTR result, dst;
+    SORT_CONTEXT context;
+    LPSORT_TASK pTasks;
+    LPSIZE_T pIndexes, pScratch, pBounds;
+    SIZE_T chunkCount, runCount, taskCount, index, allocSize;
+    INT mode = flags & EAGLE_SORT_MODE_MASK;
 
     assert(elementCount >= 0);
 
 #if !defined(USE_SYSSTRINGLEN) || !USE_SYSSTRINGLEN
-    assert(pElementLengths != NULL);
+    assert((elementCount == 0) || (pElementLengths != NULL));
 #else
     assert(pElementLengths == NULL);
 #endif
 
-    assert(ppElements != NULL);
-    assert(ppText != NULL);
+    assert((elementCount == 0) || (ppElements != NULL));
+    assert(ppIndexes != NULL);
     assert(ppError != NULL);
 
-    /*
-     * Pass 1: estimate space, gather flags.
-     */
+    if (ppIndexes == NULL) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("invalid output parameters"));
+	}
+	return EAGLE_ERROR;
+    }
 
-    if (elementCount <= LIBRARY_LOCAL_FLAGS) {
-	flagPtr = localFlags;
-    } else {
-	assert(elementCount > 0);
-	allocSize = elementCount * sizeof(FLAGS);
+    if ((mode != EAGLE_SORT_ASCII) && (mode != EAGLE_SORT_INTEGER)) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("unsupported sort mode (%d)"), mode);
+	}
+	return EAGLE_ERROR;
+    }
+
+    if (elementCount > LIBRARY_MAXIMUM_SIZE_T / (SIZE_T)sizeof(WIDEINT)) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("too many list elements (%zu)"), elementCount);
+	}
+	return EAGLE_ERROR;
+    }
+
+    allocSize = ((elementCount > 0) ? elementCount : 1) * sizeof(SIZE_T);
+    assert(allocSize > 0);
+    assert(allocSize <= LIBRARY_MAXIMUM_SIZE_T);
+    pIndexes = EagleAllocateBuffer(allocSize, FALSE, EAGLE_MEMORY_SITE_SORT);
+    if (pIndexes == NULL) {
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("out of memory for sort indexes (%zu)"),
+		allocSize);
+	}
+	return EAGLE_ERROR;
+    }
+
+    if (elementCount < 2) {
+	if (elementCount > 0)
+	    pIndexes[0] = 0;
+
+	*ppIndexes = pIndexes;
+	return EAGLE_OK;
+    }
+
+    pScratch = EagleAllocateBuffer(allocSize, FALSE, EAGLE_MEMORY_SITE_SORT);
+    if (pScratch == NULL) {
+	Eagle_FreeMemory(pIndexes);
+	if (ppError != NULL) {
+	    *ppError = EaglePrintf(0,
+		UNICODIFY("out of memory for sort scratch (%zu)"),
+		allocSize);
+	}
+	return EAGLE_ERROR;
+    }
+
+    memset(&context, 0, sizeof(SORT_CONTEXT));
+    context.elementCount = elementCount;
+    context.pElementLengths = pElementLengths;
+    context.ppElements = ppElements;
+    context.noCase = ((flags & EAGLE_SORT_NO_CASE) != 0);
+    context.decreasing = ((flags & EAGLE_SORT_DECREASING) != 0);
+
+    if (mode == EAGLE_SORT_INTEGER) {
+	allocSize = elementCount * sizeof(WIDEINT);
 	assert(allocSize > 0);
 	assert(allocSize <= LIBRARY_MAXIMUM_SIZE_T);
-	flagPtr = Eagle_AllocateMemory(allocSize);
-	if (flagPtr == NULL) {
+	context.pKeys = EagleAllocateBuffer(allocSize, FALSE,
+	    EAGLE_MEMORY_SITE_SORT);
+	if (context.pKeys == NULL) {
+	    Eagle_FreeMemory(pScratch);
+	    Eagle_FreeMemory(pIndexes);
 	    if (ppError != NULL) {
 		*ppError = EaglePrintf(0,
-		    L"out of memory for list element flags (%d)",
-		    (int)allocSize);
+		    UNICODIFY("out of memory for sort keys (%zu)"),
+		    allocSize);
 	    }
 	    return EAGLE_ERROR;
 	}
     }
 
-    numChars = 0;
-    for (i = 0; i < elementCount; i++) {
-	/*
-	 * If necessary, add space for the list element separator.
-	 */
-
-	if (i > 0) {
-	    numChars++; /* +1 SPACE */
-	}
-
-	numChars += EagleScanCountedElement(ppElements[i],
-	    SysStringLenWrapper(i) /* NON-PORTABLE? */,
-	    &flagPtr[i]);
-    }
-
-    /*
-     * Pass 2: copy into the result area.
-     */
+#if defined(USE_PARALLEL_SPLIT) && USE_PARALLEL_SPLIT
+    chunkCount = EagleGetSortChunkCount(elementCount);
+#else
+    chunkCount = 1;
+#endif
 
-    allocSize = (numChars + 1) * sizeof(WCHAR);
+    allocSize = chunkCount * sizeof(SORT_TASK) +
+	(chunkCount + 1) * sizeof(SIZE_T);
     assert(allocSize > 0);
     assert(allocSize <= LIBRARY_MAXIMUM_SIZE_T);
-    result = Eagle_AllocateMemory(allocSize);
-    if (result == NULL) {
+    pTasks = EagleAllocateScratch(allocSize, EAGLE_MEMORY_SITE_SORT);
+    if (pTasks == NULL) {
+	if (context.pKeys != NULL)
+	    Eagle_FreeMemory(context.pKeys);
+	Eagle_FreeMemory(pScratch);
+	Eagle_FreeMemory(pIndexes);
 	if (ppError != NULL) {
 	    *ppError = EaglePrintf(0,
-		L"out of memory for list element text (%d)",
-		(int)allocSize);
-	}
-	if (flagPtr != localFlags) {
-	    Eagle_FreeMemory(flagPtr);
+		UNICODIFY("out of memory for sort tasks (%zu)"),
+		allocSize);
 	}
 	return EAGLE_ERROR;
     }
 
-    numChars = 0;
-    dst = result;
-    for (i = 0; i < elementCount; i++) {
-	SIZE_T eleChars = 0;
+    memset(pTasks, 0, chunkCount * sizeof(SORT_TASK));
+    pBounds = (LPSIZE_T)(pTasks + chunkCount);
 
-	/*
-	 * If necessary, add the list element separator.
-	 */
+    /*
+     * NOTE: First, sort each chunk.  The chunks differ in size by at most
+     *       one element.
+     */
+    for (index = 0; index <= chunkCount; index++) {
+	pBounds[index] = (elementCount / chunkCount) * index +
+	    ((index < elementCount % chunkCount) ?
+	    index : elementCount % chunkCount);
+    }
 
-	if (i > 0) {
-	    *dst = L' ';
-	    eleChars++;
-	    dst++;
+    for (index = 0; index < chunkCount; index++) {
+	pTasks[index].pContext = &context;
+	pTasks[index].pSource = pIndexes;
+	pTasks[index].pTarget = pScratch;
+	pTasks[index].start = pBounds[index];
+	pTasks[index].limit = pBounds[index + 1];
+    }
+
+    EagleRunSortTasks(pTasks, chunkCount);
+
+    for (index = 0; index < chunkCount; index++) {
+	if (pTasks[index].pFormat != NULL) {
+	    if (ppError != NULL) {
+		*ppError = EaglePrintf(0, pTasks[index].pFormat,
+		    pTasks[index].errorIndex);
+	    }
+	    goto failed;
 	}
+    }
 
-	eleChars += EagleConvertCountedElement(ppElements[i],
-		SysStringLenWrapper(i) /* NON-PORTABLE? */, dst,
-		flagPtr[i] | ((i == 0) ? 0 : EAGLE_DONT_QUOTE_HASH));
+    /*
+     * NOTE: Next, merge adjacent pairs of sorted runs until only one
+     *       remains.  A run without a partner is simply copied.
+     */
+    for (runCount = chunkCount; runCount > 1; runCount = taskCount) {
+	LPSIZE_T pSwap;
+
+	taskCount = (runCount + 1) / 2;
+
+	for (index = 0; index < taskCount; index++) {
+	    SIZE_T first = 2 * index;
+
+	    memset(&pTasks[index], 0, sizeof(SORT_TASK));
+	    pTasks[index].pContext = &context;
+	    pTasks[index].pSource = pIndexes;
+	    pTasks[index].pTarget = pScratch;
+	    pTasks[index].start = pBounds[first];
+	    pTasks[index].middle = pBounds[first + 1];
+	    pTasks[index].limit = (first + 2 <= runCount) ?
+		pBounds[first + 2] : pBounds[first + 1];
+	    pTasks[index].merging = TRUE;
+	}
 
-	numChars += eleChars;
-	dst += (eleChars - (i > 0));
+	EagleRunSortTasks(pTasks, taskCount);
+
+	for (index = 0; index < taskCount; index++)
+	    pBounds[index] = pBounds[2 * index];
+
+	pBounds[taskCount] = elementCount;
+
+	pSwap = pIndexes;
+	pIndexes = pScratch;
+	pScratch = pSwap;
     }
 
-    if (flagPtr != localFlags) {
-	Eagle_FreeMemory(flagPtr);
+    /*
+     * NOTE: Finally, make sure that elements comparing equal are also
+     *       identical.  This can only fail when ignoring case or when
+     *       comparing integers.
+     */
+    if (context.noCase || (context.pKeys != NULL)) {
+	for (index = 1; index < elementCount; index++) {
+	    SIZE_T index1 = pIndexes[index - 1];
+	    SIZE_T index2 = pIndexes[index];
+	    LPCWSTR pText1, pText2;
+	    SIZE_T length1, length2;
+
+	    if (EagleCompareSortElements(&context, index1, index2) != 0)
+		continue;
+
+	    pText1 = ppElements[index1];
+	    pText2 = ppElements[index2];
+	    length1 = (pText1 != NULL) ?
+		SysStringLenWrapper(index1) /* NON-PORTABLE? */ : 0;
+	    length2 = (pText2 != NULL) ?
+		SysStringLenWrapper(index2) /* NON-PORTABLE? */ : 0;
+
+	    if ((length1 != length2) || ((length1 > 0) &&
+		    (memcmp(pText1, pText2, length1 * sizeof(WCHAR)) != 0))) {
+		if (ppError != NULL) {
+		    *ppError = EaglePrintf(0,
+			UNICODIFY("list elements %zu and %zu compare equal"),
+			index1, index2);
+		}
+		goto failed;
+	    }
+	}
     }
 
-    *pLength = numChars;
-    *ppText = result;
+    EagleFreeScratch(pTasks);
+
+    if (context.pKeys != NULL)
+	Eagle_FreeMemory(context.pKeys);
+
+    Eagle_FreeMemory(pScratch);
+
+    *ppIndexes = pIndexes;
 
     return EAGLE_OK;
+
+failed:
+    EagleFreeScratch(pTasks);
+
+    if (context.pKeys != NULL)
+	Eagle_FreeMemory(context.pKeys);
+
+    Eagle_FreeMemory(pScratch);
+    Eagle_FreeMemory(pIndexes);
+
+    return EAGLE_ERROR;
 }
@@ -29,6 +29,11 @@
 
 /*****************************************************************************/
 
+#include <stddef.h>		/* NOTE: For size_t and wchar_t. */
+#include "SpilornisDef.h"	/* NOTE: For compile-time option defines. */
+
+/*****************************************************************************/
+
 #ifndef _CONST_DEFINED
 #define _CONST_DEFINED
 #define CONST const
@@ -49,14 +54,36 @@ typedef VOID *LPVOID;
 typedef const VOID *LPCVOID;
 #endif
 
+#ifndef _BOOL_DEFINED
+#define _BOOL_DEFINED
+typedef int BOOL;
+#endif
+
+#ifndef _BYTE_DEFINED
+#define _BYTE_DEFINED
+typedef unsigned char BYTE;
+#endif
+
+#ifndef _LPBYTE_DEFINED
+#define _LPBYTE_DEFINED
+typedef BYTE *LPBYTE;
+#endif
+
+#ifndef _INT_DEFINED
+#define _INT_DEFINED
+typedef int INT;
+#endif
+
 #ifndef __SIZE_T_DEFINED
 #define __SIZE_T_DEFINED
 /*
  * NOTE: If USE_32BIT_SIZE_T is defined and non-zero, use a 32-bit signed
- *       integer to represent all element counts and sizes (i.e. to better
- *       interoperate with managed code).  Technically, this SIZE_T type
- *       definition should be unsigned; however, for some reason, the CLR
- *       really wants string lengths and array element counts to be signed.
+ *       integer to represent all element counts and sizes.  This was the
+ *       default prior to the SIZE_OF_SIZE_T option being added to the
+ *       version string; however, it limits all allocations to 2GB.  The
+ *       managed code now marshals all element counts and sizes as native
+ *       pointer sized integers (i.e. IntPtr), which requires the default
+ *       SIZE_T type on 64-bit platforms.
  */
 #if defined(USE_32BIT_SIZE_T) && USE_32BIT_SIZE_T
 typedef int SIZE_T;
@@ -75,10 +102,37 @@ typedef SIZE_T *LPSIZE_T;
 typedef CONST SIZE_T *LPCSIZE_T;
 #endif
 
+#ifndef _WIDEINT_DEFINED
+#define _WIDEINT_DEFINED
+/*
+ * NOTE: This is a signed 64-bit integer, which matches the CLR "long" data
+ *       type.  It is used for the values produced by Eagle_ParseNumbers.
+ */
+#if defined(_MSC_VER)
+typedef __int64 WIDEINT;
+#else
+typedef long long WIDEINT;
+#endif
+#endif
+
+#ifndef _LPWIDEINT_DEFINED
+#define _LPWIDEINT_DEFINED
+typedef WIDEINT *LPWIDEINT;
+#endif
+
 #ifndef _WCHAR_DEFINED
 #define _WCHAR_DEFINED
+/*
+ * NOTE: All strings used by this library are UTF-16, to match the strings
+ *       used by the CLR.  When the "wchar_t" data type is wider than that
+ *       (e.g. gcc on Linux), an unsigned sixteen bit integer is used.
+ */
+#if defined(USE_UTF16_CHAR) && USE_UTF16_CHAR
+typedef unsigned short WCHAR;
+#else
 typedef wchar_t WCHAR;
 #endif
+#endif
 
 #ifndef _LPWSTR_DEFINED
 #define _LPWSTR_DEFINED
@@ -90,6 +144,183 @@ typedef WCHAR *LPWSTR;
 typedef CONST WCHAR *LPCWSTR;
 #endif
 
+#ifndef _ELEMENT_SPAN_DEFINED
+#define _ELEMENT_SPAN_DEFINED
+/*
+ * NOTE: This structure describes one list element found by the function
+ *       Eagle_SplitListSpans.  All fields use the SIZE_T type so that the
+ *       structure has no padding and is simple to read from managed code.
+ */
+typedef struct _ELEMENT_SPAN {
+    SIZE_T offset;		/* Offset of the first character. */
+    SIZE_T length;		/* Number of characters. */
+    SIZE_T needsUnescape;	/* Non-zero if the element contained any
+				 * backslash sequences.  In that case, the
+				 * offset and length refer to the unescaped
+				 * text, not the original list text. */
+} ELEMENT_SPAN, *LPELEMENT_SPAN;
+#endif
+
+#ifndef _EAGLE_MATCH_DEFINED
+#define _EAGLE_MATCH_DEFINED
+/*
+ * NOTE: These are the flags used by Eagle_StringMatch, et al.  The strict
+ *       range flag corresponds to the FixFor219233 interpreter flag, which
+ *       prevents a range from ending with the final close bracket of the
+ *       pattern.  Case folding only applies to the ASCII letters.
+ */
+#define EAGLE_MATCH_NONE			(0x0)
+#define EAGLE_MATCH_NO_CASE			(0x1)
+#define EAGLE_MATCH_STRICT_RANGE		(0x2)
+#endif
+
+#ifndef _EAGLE_SORT_DEFINED
+#define _EAGLE_SORT_DEFINED
+/*
+ * NOTE: These are the flags used by Eagle_SortList.  Exactly one of the
+ *       sort modes must be used.  The strings are compared by their UTF-16
+ *       code units; case folding is only supported for the ASCII letters,
+ *       which are folded to upper case.
+ */
+#define EAGLE_SORT_ASCII			(0x0)
+#define EAGLE_SORT_INTEGER			(0x1)
+#define EAGLE_SORT_MODE_MASK			(0xF)
+#define EAGLE_SORT_NO_CASE			(0x10)
+#define EAGLE_SORT_DECREASING			(0x20)
+#endif
+
+#ifndef _SCRIPT_TOKEN_DEFINED
+#define _SCRIPT_TOKEN_DEFINED
+/*
+ * NOTE: These are the flags used by Eagle_ParseScript.  The substitution
+ *       flags have the same values as the managed SubstitutionFlags.
+ */
+#define EAGLE_PARSE_NONE			(0x0)
+#define EAGLE_PARSE_BACKSLASHES			(0x2)
+#define EAGLE_PARSE_VARIABLES			(0x4)
+#define EAGLE_PARSE_COMMANDS			(0x8)
+#define EAGLE_PARSE_NESTED			(0x100)
+
+/*
+ * NOTE: These are the token types produced by Eagle_ParseScript.  They have
+ *       the same values as the managed TokenType.
+ */
+#define EAGLE_TOKEN_WORD			(0x2)
+#define EAGLE_TOKEN_SIMPLE_WORD			(0x4)
+#define EAGLE_TOKEN_TEXT			(0x8)
+#define EAGLE_TOKEN_BACKSLASH			(0x10)
+#define EAGLE_TOKEN_COMMAND			(0x20)
+#define EAGLE_TOKEN_VARIABLE			(0x40)
+#define EAGLE_TOKEN_SEPARATOR			(0x400)
+
+/*
+ * NOTE: This is the offset used by Eagle_ParseScript for a comment or line
+ *       that has not been seen.
+ */
+#define EAGLE_PARSE_INVALID_INDEX		((SIZE_T)-1)
+
+/*
+ * NOTE: This structure describes one token found by Eagle_ParseScript.  All
+ *       fields use the SIZE_T type so that the structure has no padding and
+ *       is simple to read from managed code.  Line numbers are relative to
+ *       the first line of the script, which is zero.
+ */
+typedef struct _SCRIPT_TOKEN {
+    SIZE_T type;		/* One of the EAGLE_TOKEN_* values. */
+    SIZE_T start;		/* Offset of the first character. */
+    SIZE_T length;		/* Number of characters. */
+    SIZE_T components;		/* Number of nested tokens that follow this
+				 * one -OR- for a separator, the number of
+				 * commands parsed so far. */
+    SIZE_T startLine;		/* Line where the token was started. */
+    SIZE_T endLine;		/* Line where the token was finished.  This
+				 * is always zero for a separator. */
+} SCRIPT_TOKEN, *LPSCRIPT_TOKEN;
+
+/*
+ * NOTE: This structure is filled in by Eagle_ParseScript.  It describes the
+ *       state of the parser after the last command in the script, using the
+ *       same names as the managed ParseState.  All fields use the SIZE_T type
+ *       for the same reasons as above.
+ */
+typedef struct _SCRIPT_STATE {
+    SIZE_T currentLine;		/* Line after the last command. */
+    SIZE_T lineStart;		/* Offset of the last line terminator that
+				 * was counted -OR- invalid. */
+    SIZE_T commentStart;	/* Offset of the comment preceding the last
+				 * command -OR- invalid. */
+    SIZE_T commentLength;	/* Number of characters in that comment. */
+    SIZE_T commandStart;	/* Offset of the last command. */
+    SIZE_T commandLength;	/* Number of characters in that command. */
+    SIZE_T commandWords;	/* Number of words in that command. */
+    SIZE_T terminator;		/* Offset of the character that terminated
+				 * that command. */
+    SIZE_T incomplete;		/* Non-zero if that command is incomplete. */
+    SIZE_T commandCount;	/* Number of commands parsed. */
+} SCRIPT_STATE, *LPSCRIPT_STATE;
+#endif
+
+#ifndef _MEMORY_STATISTICS_DEFINED
+#define _MEMORY_STATISTICS_DEFINED
+/*
+ * NOTE: These are the call sites that memory allocations are counted for
+ *       by the memory statistics.  Allocations made via the function
+ *       Eagle_AllocateMemory are counted as "other".
+ */
+#define EAGLE_MEMORY_SITE_OTHER			(0)
+#define EAGLE_MEMORY_SITE_SPLIT			(1)
+#define EAGLE_MEMORY_SITE_JOIN			(2)
+#define EAGLE_MEMORY_SITE_QUERY			(3)
+#define EAGLE_MEMORY_SITE_EDIT			(4)
+#define EAGLE_MEMORY_SITE_PRINTF		(5)
+#define EAGLE_MEMORY_SITE_PARSE			(6)
+#define EAGLE_MEMORY_SITE_SORT			(7)
+#define EAGLE_MEMORY_SITES			(8)
+
+/*
+ * NOTE: This is the number of buckets in the allocation size histogram.
+ *       Bucket N counts allocations larger than 2^(N-1) bytes and no larger
+ *       than 2^N bytes; the last bucket also counts any larger ones.
+ */
+#define EAGLE_MEMORY_BUCKETS			(32)
+
+/*
+ * NOTE: This structure is filled in by the function Eagle_GetMemoryStatistics.
+ *       All fields use the SIZE_T type so that the structure has no padding
+ *       and is simple to read from managed code.  The byte counts include
+ *       any rounding performed by the underlying memory allocator.
+ */
+typedef struct _MEMORY_STATISTICS {
+    SIZE_T currentBytes;	/* Number of bytes currently allocated. */
+    SIZE_T peakBytes;		/* Largest number of bytes ever allocated. */
+    SIZE_T allocationCount;	/* Number of memory allocations. */
+    SIZE_T freeCount;		/* Number of memory blocks freed. */
+    SIZE_T siteAllocations[EAGLE_MEMORY_SITES];
+				/* Number of allocations per call site. */
+    SIZE_T histogram[EAGLE_MEMORY_SITES][EAGLE_MEMORY_BUCKETS];
+				/* Allocation size histogram per call
+				 * site. */
+} MEMORY_STATISTICS, *LPMEMORY_STATISTICS;
+#endif
+
+#ifndef _LPLIST_ITERATOR_DEFINED
+#define _LPLIST_ITERATOR_DEFINED
+/*
+ * NOTE: This is an opaque handle used to extract the elements of a list one
+ *       at a time.  See Eagle_ListIterBegin, et al.
+ */
+typedef struct _LIST_ITERATOR LIST_ITERATOR, *LPLIST_ITERATOR;
+#endif
+
+#ifndef _LPMATCH_PATTERN_DEFINED
+#define _LPMATCH_PATTERN_DEFINED
+/*
+ * NOTE: This is an opaque handle to a compiled glob pattern.  See the
+ *       Eagle_CompilePattern function, et al.
+ */
+typedef struct _MATCH_PATTERN MATCH_PATTERN, *LPMATCH_PATTERN;
+#endif
+
 #ifndef _RETURNCODE_DEFINED
 #define _RETURNCODE_DEFINED
 typedef int RETURNCODE;
@@ -97,10 +328,6 @@ typedef int RETURNCODE;
 
 /*****************************************************************************/
 
-#include "SpilornisDef.h"	/* NOTE: For compile-time option defines. */
-
-/*****************************************************************************/
-
 /*
  * NOTE: These are the public functions exported by this library.
  */
@@ -113,6 +340,9 @@ EAGLE_EXTERN LPCWSTR	Eagle_GetVersion(VOID);
 EAGLE_EXTERN VOID	Eagle_FreeVersion(LPVOID pVersion);
 EAGLE_EXTERN LPVOID	Eagle_AllocateMemory(SIZE_T size);
 EAGLE_EXTERN VOID	Eagle_FreeMemory(LPVOID pMemory);
+EAGLE_EXTERN RETURNCODE	Eagle_GetMemoryStatistics(SIZE_T size,
+			    LPMEMORY_STATISTICS pStatistics,
+			    LPCWSTR *ppError);
 EAGLE_EXTERN VOID	Eagle_FreeElements(SIZE_T elementCount,
 			    LPWSTR *ppElements);
 EAGLE_EXTERN RETURNCODE	Eagle_SplitList(SIZE_T length, LPCWSTR pText,
@@ -120,16 +350,88 @@ EAGLE_EXTERN RETURNCODE	Eagle_SplitList(SIZE_T length, LPCWSTR pText,
 			    LPSIZE_T *ppElementLengths,
 			    LPCWSTR **pppElements,
 			    LPCWSTR *ppError);
+EAGLE_EXTERN RETURNCODE	Eagle_SplitListSpans(SIZE_T length, LPCWSTR pText,
+			    LPSIZE_T pElementCount,
+			    LPELEMENT_SPAN *ppSpans,
+			    LPCWSTR *ppUnescaped, LPCWSTR *ppError);
+EAGLE_EXTERN RETURNCODE	Eagle_SplitLists(SIZE_T listCount,
+			    LPCSIZE_T pLengths, LPCWSTR *ppTexts,
+			    LPSIZE_T pElementCount, LPSIZE_T *ppCounts,
+			    LPCWSTR *ppText, LPCWSTR *ppError);
+EAGLE_EXTERN RETURNCODE	Eagle_CountListElements(SIZE_T length,
+			    LPCWSTR pText, LPSIZE_T pElementCount,
+			    LPCWSTR *ppError);
+EAGLE_EXTERN RETURNCODE	Eagle_GetListElement(SIZE_T length, LPCWSTR pText,
+			    SIZE_T index, LPSIZE_T pElementLength,
+			    LPCWSTR *ppElement, LPCWSTR *ppError);
+EAGLE_EXTERN RETURNCODE	Eagle_GetListRange(SIZE_T length, LPCWSTR pText,
+			    SIZE_T firstIndex, SIZE_T lastIndex,
+			    LPSIZE_T pLength, LPCWSTR *ppText,
+			    LPCWSTR *ppError);
+EAGLE_EXTERN RETURNCODE	Eagle_ReplaceListRange(SIZE_T length,
+			    LPCWSTR pText, SIZE_T firstIndex,
+			    SIZE_T deleteCount, SIZE_T elementCount,
+			    LPCSIZE_T pElementLengths,
+			    LPCWSTR *ppElements, LPSIZE_T pLength,
+			    LPCWSTR *ppText, LPCWSTR *ppError);
+EAGLE_EXTERN RETURNCODE	Eagle_ListIterBegin(SIZE_T length, LPCWSTR pText,
+			    LPLIST_ITERATOR *ppIterator,
+			    LPCWSTR *ppError);
+EAGLE_EXTERN RETURNCODE	Eagle_ListIterNext(LPLIST_ITERATOR pIterator,
+			    LPELEMENT_SPAN pSpan, LPCWSTR *ppElement,
+			    LPCWSTR *ppError);
+EAGLE_EXTERN VOID	Eagle_ListIterEnd(LPLIST_ITERATOR pIterator);
 EAGLE_EXTERN RETURNCODE	Eagle_JoinList(SIZE_T elementCount,
 			    LPCSIZE_T pElementLengths,
 			    LPCWSTR *ppElements,
 			    LPSIZE_T pLength, LPCWSTR *ppText,
 			    LPCWSTR *ppError);
+EAGLE_EXTERN RETURNCODE	Eagle_JoinLists(SIZE_T listCount,
+			    LPCSIZE_T pElementCounts,
+			    LPCSIZE_T pElementLengths,
+			    LPCWSTR *ppElements, LPSIZE_T *ppLengths,
+			    LPCWSTR *ppText, LPCWSTR *ppError);
+EAGLE_EXTERN BOOL	Eagle_StringMatch(SIZE_T textLength,
+			    LPCWSTR pText, SIZE_T patternLength,
+			    LPCWSTR pPattern, INT flags);
+EAGLE_EXTERN RETURNCODE	Eagle_CompilePattern(SIZE_T length,
+			    LPCWSTR pPattern, INT flags,
+			    LPMATCH_PATTERN *ppPattern, LPCWSTR *ppError);
+EAGLE_EXTERN RETURNCODE	Eagle_StringMatchMany(LPMATCH_PATTERN pPattern,
+			    SIZE_T elementCount, LPCSIZE_T pElementLengths,
+			    LPCWSTR *ppElements, LPBYTE pBitmap,
+			    LPSIZE_T pMatchCount, LPCWSTR *ppError);
+EAGLE_EXTERN VOID	Eagle_FreePattern(LPMATCH_PATTERN pPattern);
+EAGLE_EXTERN RETURNCODE	Eagle_ParseScript(SIZE_T length, LPCWSTR pText,
+			    INT flags, LPSCRIPT_STATE pState,
+			    LPSIZE_T pTokenCount, LPSCRIPT_TOKEN *ppTokens,
+			    LPCWSTR *ppError);
+EAGLE_EXTERN RETURNCODE	Eagle_SubstBackslashes(SIZE_T length,
+			    LPCWSTR pText, LPSIZE_T pLength, LPCWSTR *ppText,
+			    LPCWSTR *ppError);
+EAGLE_EXTERN RETURNCODE	Eagle_ParseNumbers(SIZE_T length, LPCWSTR pText,
+			    LPSIZE_T pElementCount, LPWIDEINT *ppValues,
+			    LPCWSTR *ppError);
+EAGLE_EXTERN RETURNCODE	Eagle_SortList(SIZE_T elementCount,
+			    LPCSIZE_T pElementLengths, LPCWSTR *ppElements,
+			    INT flags, LPSIZE_T *ppIndexes, LPCWSTR *ppError);
 
 #if defined(USE_HEAPAPI) && USE_HEAPAPI
 EAGLE_EXTERN HANDLE	Eagle_SetMemoryHeap(HANDLE hNewHeap);
 #endif
 
+#if defined(USE_POOL_ALLOCATOR) && USE_POOL_ALLOCATOR
+EAGLE_EXTERN BOOL	Eagle_SetMemoryPool(BOOL bPrivate);
+EAGLE_EXTERN SIZE_T	Eagle_CompactMemoryPool(VOID);
+#endif
+
+#if defined(USE_PARALLEL_SPLIT) && USE_PARALLEL_SPLIT
+EAGLE_EXTERN VOID	Eagle_GetSplitOptions(LPSIZE_T pThreshold,
+			    LPSIZE_T pThreadCount);
+EAGLE_EXTERN VOID	Eagle_SetSplitOptions(SIZE_T threshold,
+			    SIZE_T threadCount);
+#endif
+
 /*****************************************************************************/
 
 #endif /* _SPILORNIS_H_ */
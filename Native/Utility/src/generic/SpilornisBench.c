@@ -0,0 +1,1235 @@
+/*
+ * SpilornisBench.c -- Eagle Native Utility Library (Spilornis) Benchmark
+ *
+ * Copyright (c) 2007-2012 by Joe Mistachkin.  All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution of
+ * this file, and for a DISCLAIMER OF ALL WARRANTIES.
+ *
+ * RCS: @(#) $Id: $
+ */
+
+/*
+ * NOTE: This is a standalone program that measures the performance of the
+ *       list handling functions exported by the native utility library.  It
+ *       loads the library dynamically (i.e. it does not link against it),
+ *       so the very same program may be used to compare different builds
+ *       of the library.  The input lists are generated using a fixed seed;
+ *       therefore, they are identical from one run to the next.  All of the
+ *       results are written to the standard output channel as JSON.  The
+ *       scalar code paths may be measured by using the "-scalar" option,
+ *       which simply sets the environment variable used by the library to
+ *       disable its SIMD code paths before the library is loaded.
+ */
+
+#include <dlfcn.h>		/* NOTE: For dlopen, dlsym, etc. */
+#include <stdio.h>		/* NOTE: For fprintf, printf, etc. */
+#include <stdlib.h>		/* NOTE: For malloc, setenv, strtoul, etc. */
+#include <string.h>		/* NOTE: For memset, strcmp, etc. */
+#include <time.h>		/* NOTE: For clock_gettime, etc. */
+#include <limits.h>		/* NOTE: For USHRT_MAX, etc. */
+#include <wchar.h>		/* NOTE: For WCHAR_MAX, etc. */
+
+#include "Spilornis.h"		/* NOTE: For public types and prototypes. */
+
+/*
+ * NOTE: These are the default values for the command line options.
+ */
+
+#define BENCH_DEFAULT_LIBRARY			"./spilornis.dll"
+#define BENCH_DEFAULT_SIZES			"1K,64K,1M,16M"
+#define BENCH_DEFAULT_SEED			(1)
+#define BENCH_DEFAULT_MINIMUM_TIME		(0.5)
+#define BENCH_MAXIMUM_ITERATIONS		(1000000)
+#define BENCH_MAXIMUM_SIZES			(32)
+
+/*
+ * NOTE: This is the largest list text that may be generated, in bytes.  The
+ *       library must be able to allocate a copy of the list text as well as
+ *       an array of element pointers for it in one block.
+ */
+
+#define BENCH_MAXIMUM_BYTES			(1 << 30)
+
+/*
+ * NOTE: This must be the same as the NO_SIMD_VAR_NAME used by the library.
+ */
+
+#define BENCH_NO_SIMD_VAR_NAME			"NoSimdSpilornis"
+
+/*
+ * NOTE: These are the kinds of list text that can be generated.  The list
+ *       elements in the "braces" corpus are nested up to this depth.
+ */
+
+#define BENCH_CORPUS_WORDS			(0)
+#define BENCH_CORPUS_BRACES			(1)
+#define BENCH_CORPUS_BACKSLASH			(2)
+#define BENCH_CORPUS_UNICODE			(3)
+#define BENCH_CORPORA				(4)
+
+#define BENCH_MAXIMUM_DEPTH			(8)
+
+/*
+ * NOTE: This is the maximum number of characters in one generated element.
+ */
+
+#define BENCH_MAXIMUM_ELEMENT			(256)
+
+static const char *corpusNames[BENCH_CORPORA] = {
+    "words", "braces", "backslash", "unicode"
+};
+
+/*
+ * NOTE: These are the function pointer types for the library exports that
+ *       are used by this program.
+ */
+
+typedef LPCWSTR (*GET_VERSION_PROC)(VOID);
+typedef VOID (*FREE_VERSION_PROC)(LPVOID pVersion);
+typedef VOID (*FREE_MEMORY_PROC)(LPVOID pMemory);
+typedef VOID (*FREE_ELEMENTS_PROC)(SIZE_T elementCount, LPWSTR *ppElements);
+
+typedef RETURNCODE (*GET_MEMORY_STATISTICS_PROC)(SIZE_T size,
+    LPMEMORY_STATISTICS pStatistics, LPCWSTR *ppError);
+
+typedef RETURNCODE (*SPLIT_LIST_PROC)(SIZE_T length, LPCWSTR pText,
+    LPSIZE_T pElementCount, LPSIZE_T *ppElementLengths,
+    LPCWSTR **pppElements, LPCWSTR *ppError);
+
+typedef RETURNCODE (*JOIN_LIST_PROC)(SIZE_T elementCount,
+    LPCSIZE_T pElementLengths, LPCWSTR *ppElements, LPSIZE_T pLength,
+    LPCWSTR *ppText, LPCWSTR *ppError);
+
+/*
+ * NOTE: This structure holds the library exports used by this program.  The
+ *       memory statistics export is optional, since older builds of the
+ *       library do not have it.
+ */
+
+typedef struct _BENCH_LIBRARY {
+    void *hModule;
+    GET_VERSION_PROC getVersion;
+    FREE_VERSION_PROC freeVersion;
+    FREE_MEMORY_PROC freeMemory;
+    FREE_ELEMENTS_PROC freeElements;
+    GET_MEMORY_STATISTICS_PROC getMemoryStatistics;
+    SPLIT_LIST_PROC splitList;
+    JOIN_LIST_PROC joinList;
+} BENCH_LIBRARY, *LPBENCH_LIBRARY;
+
+/*
+ * NOTE: This structure holds the results of measuring one operation.  The
+ *       allocation count is for a single call and is negative if it could
+ *       not be determined.
+ */
+
+typedef struct _BENCH_RESULT {
+    long iterations;
+    double seconds;
+    double bestSeconds;
+    long allocations;
+} BENCH_RESULT, *LPBENCH_RESULT;
+
+/*
+ * NOTE: This is the state of the pseudo-random number generator used to
+ *       build the input lists (i.e. "xorshift64*").
+ */
+
+static unsigned long long randomState;
+
+/*
+ * Prototypes for procedures defined later in this file:
+ */
+
+static void		SeedRandom(unsigned long long seed);
+static unsigned int	NextRandom(unsigned int limit);
+static double		GetSeconds(void);
+static int		ParseSize(const char *pString, SIZE_T *pSize);
+static int		ParseSizes(const char *pString, SIZE_T *pSizes,
+			    int *pCount);
+static int		ParseCorpora(const char *pString, int *pSelected);
+static void		WriteJsonString(FILE *pFile, LPCWSTR pString);
+static int		HasVersionOption(LPCWSTR pVersion,
+			    const char *pOption);
+static SIZE_T		AppendWord(LPWSTR pBuffer, SIZE_T length,
+			    int minimum, int maximum);
+static SIZE_T		AppendElement(int corpus, LPWSTR pBuffer);
+static LPWSTR		GenerateCorpus(int corpus, SIZE_T byteSize,
+			    LPSIZE_T pLength);
+static int		LoadBenchLibrary(const char *pFileName,
+			    LPBENCH_LIBRARY pLibrary);
+static long		GetAllocationCount(LPBENCH_LIBRARY pLibrary);
+static int		MeasureSplit(LPBENCH_LIBRARY pLibrary,
+			    double minimumTime, SIZE_T length,
+			    LPCWSTR pText, LPSIZE_T pElementCount,
+			    LPBENCH_RESULT pResult);
+static int		MeasureJoin(LPBENCH_LIBRARY pLibrary,
+			    double minimumTime, SIZE_T elementCount,
+			    LPCSIZE_T pElementLengths, LPCWSTR *ppElements,
+			    LPBENCH_RESULT pResult);
+static void		WriteResult(FILE *pFile, const char *pName,
+			    SIZE_T byteSize, SIZE_T elementCount,
+			    LPBENCH_RESULT pResult);
+static int		RunCorpus(FILE *pFile, LPBENCH_LIBRARY pLibrary,
+			    double minimumTime, int corpus,
+			    SIZE_T byteSize, int *pFirst);
+static void		Usage(const char *pProgram);
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * SeedRandom, NextRandom --
+ *
+ *	Seeds and queries the pseudo-random number generator used to build
+ *	the input lists.  The sequence of values depends only upon the seed.
+ *
+ * Results:
+ *	For NextRandom, a value from zero up to (but not including) limit.
+ *
+ * Side effects:
+ *	The generator state is modified.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static void
+SeedRandom(
+    unsigned long long seed)	/* The initial state, zero is remapped. */
+{
+    randomState = (seed != 0) ? seed : 0x9E3779B97F4A7C15ULL;
+}
+
+static unsigned int
+NextRandom(
+    unsigned int limit)		/* One more than the largest value wanted. */
+{
+    randomState ^= randomState >> 12;
+    randomState ^= randomState << 25;
+    randomState ^= randomState >> 27;
+
+    return (unsigned int)(
+	((randomState * 0x2545F4914F6CDD1DULL) >> 32) % limit);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GetSeconds --
+ *
+ *	Queries the monotonic clock.
+ *
+ * Results:
+ *	The current value of the monotonic clock, in seconds.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static double
+GetSeconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + ((double)now.tv_nsec / 1000000000.0);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ParseSize --
+ *
+ *	Parses a size in bytes, which may have a "K", "M", or "G" suffix
+ *	(i.e. powers of 1024).
+ *
+ * Results:
+ *	Non-zero upon success.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static int
+ParseSize(
+    const char *pString,	/* The string to parse. */
+    SIZE_T *pSize)		/* OUT: The parsed size, in bytes. */
+{
+    char *pEnd = NULL;
+    unsigned long long value = strtoull(pString, &pEnd, 10);
+
+    if ((pEnd == pString) || (value == 0))
+	return 0;
+
+    switch (*pEnd) {
+	case 'G': case 'g': value <<= 30; pEnd++; break;
+	case 'M': case 'm': value <<= 20; pEnd++; break;
+	case 'K': case 'k': value <<= 10; pEnd++; break;
+    }
+
+    if ((*pEnd != '\0') && (*pEnd != ','))
+	return 0;
+
+    if (value > (unsigned long long)BENCH_MAXIMUM_BYTES)
+	return 0;
+
+    *pSize = (SIZE_T)value;
+    return 1;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ParseSizes --
+ *
+ *	Parses a comma separated list of sizes.  See ParseSize.
+ *
+ * Results:
+ *	Non-zero upon success.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static int
+ParseSizes(
+    const char *pString,	/* The string to parse. */
+    SIZE_T *pSizes,		/* OUT: The parsed sizes. */
+    int *pCount)		/* OUT: The number of parsed sizes. */
+{
+    int count = 0;
+
+    while (1) {
+	if (count >= BENCH_MAXIMUM_SIZES)
+	    return 0;
+
+	if (!ParseSize(pString, &pSizes[count]))
+	    return 0;
+
+	count++;
+	pString = strchr(pString, ',');
+
+	if (pString == NULL)
+	    break;
+
+	pString++;
+    }
+
+    *pCount = count;
+    return 1;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * ParseCorpora --
+ *
+ *	Parses a comma separated list of corpus names -OR- "all".
+ *
+ * Results:
+ *	Non-zero upon success.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static int
+ParseCorpora(
+    const char *pString,	/* The string to parse. */
+    int *pSelected)		/* OUT: Non-zero for each selected corpus. */
+{
+    int corpus;
+
+    memset(pSelected, 0, BENCH_CORPORA * sizeof(int));
+
+    while (1) {
+	size_t length = strcspn(pString, ",");
+
+	if ((length == 3) && (strncmp(pString, "all", 3) == 0)) {
+	    for (corpus = 0; corpus < BENCH_CORPORA; corpus++)
+		pSelected[corpus] = 1;
+	} else {
+	    for (corpus = 0; corpus < BENCH_CORPORA; corpus++) {
+		if ((strlen(corpusNames[corpus]) == length) &&
+		    (strncmp(pString, corpusNames[corpus], length) == 0)) {
+		    pSelected[corpus] = 1;
+		    break;
+		}
+	    }
+
+	    if (corpus == BENCH_CORPORA)
+		return 0;
+	}
+
+	if (pString[length] == '\0')
+	    break;
+
+	pString += length + 1;
+    }
+
+    return 1;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * WriteJsonString --
+ *
+ *	Writes a UTF-16 string to the specified file as a quoted JSON string.
+ *	Any character outside of the printable ASCII range is escaped.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Output is written to the file.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static void
+WriteJsonString(
+    FILE *pFile,		/* The file to write to. */
+    LPCWSTR pString)		/* The NUL terminated string to write. */
+{
+    fputc('"', pFile);
+
+    if (pString != NULL) {
+	for (; *pString != 0; pString++) {
+	    unsigned int c = (unsigned int)*pString;
+
+	    if ((c == '"') || (c == '\\'))
+		fprintf(pFile, "\\%c", (char)c);
+	    else if ((c >= 0x20) && (c < 0x7F))
+		fputc((int)c, pFile);
+	    else
+		fprintf(pFile, "\\u%04x", c & 0xFFFF);
+	}
+    }
+
+    fputc('"', pFile);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * HasVersionOption --
+ *
+ *	Checks if the library version string contains the specified
+ *	compile-time option (e.g. " USE_32BIT_SIZE_T=1").
+ *
+ * Results:
+ *	Non-zero if the option is present.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static int
+HasVersionOption(
+    LPCWSTR pVersion,		/* The library version string. */
+    const char *pOption)	/* The ASCII option to look for. */
+{
+    if (pVersion == NULL)
+	return 0;
+
+    for (; *pVersion != 0; pVersion++) {
+	size_t index = 0;
+
+	while ((pOption[index] != '\0') &&
+		(pVersion[index] == (WCHAR)pOption[index])) {
+	    index++;
+	}
+
+	if (pOption[index] == '\0')
+	    return 1;
+    }
+
+    return 0;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * AppendWord --
+ *
+ *	Appends a random word made of lowercase ASCII letters to the buffer.
+ *
+ * Results:
+ *	The number of characters appended.
+ *
+ * Side effects:
+ *	The buffer is modified.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+AppendWord(
+    LPWSTR pBuffer,		/* The buffer to append to. */
+    SIZE_T length,		/* The current length of the buffer. */
+    int minimum,		/* The minimum word length. */
+    int maximum)		/* The maximum word length. */
+{
+    int count = minimum + (int)NextRandom(maximum - minimum + 1);
+    int index;
+
+    for (index = 0; index < count; index++)
+	pBuffer[length + index] = (WCHAR)('a' + NextRandom(26));
+
+    return (SIZE_T)count;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * AppendElement --
+ *
+ *	Appends one random list element of the specified kind to the buffer.
+ *	The buffer must have room for at least BENCH_MAXIMUM_ELEMENT
+ *	characters.  The element is not preceded or followed by a space.
+ *
+ * Results:
+ *	The number of characters appended.
+ *
+ * Side effects:
+ *	The buffer is modified.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static SIZE_T
+AppendElement(
+    int corpus,			/* The kind of element to generate. */
+    LPWSTR pBuffer)		/* The buffer to append to. */
+{
+    SIZE_T length = 0;
+
+    switch (corpus) {
+	case BENCH_CORPUS_WORDS: {
+	    /*
+	     * NOTE: A plain word, e.g. "abcdef".
+	     */
+
+	    length += AppendWord(pBuffer, length, 1, 12);
+	    break;
+	}
+	case BENCH_CORPUS_BRACES: {
+	    /*
+	     * NOTE: A braced sub-list, which is itself made up of words and
+	     *       more braced sub-lists, e.g. "{abc {de {f gh}} ij}".
+	     */
+
+	    int depth = 1 + (int)NextRandom(BENCH_MAXIMUM_DEPTH);
+	    int level;
+
+	    for (level = 0; level < depth; level++) {
+		pBuffer[length++] = '{';
+		length += AppendWord(pBuffer, length, 1, 6);
+		pBuffer[length++] = ' ';
+	    }
+
+	    length += AppendWord(pBuffer, length, 1, 6);
+
+	    for (level = 0; level < depth; level++) {
+		pBuffer[length++] = '}';
+
+		if (NextRandom(2) != 0) {
+		    pBuffer[length++] = ' ';
+		    length += AppendWord(pBuffer, length, 1, 6);
+		}
+	    }
+
+	    break;
+	}
+	case BENCH_CORPUS_BACKSLASH: {
+	    /*
+	     * NOTE: A word containing backslash sequences, all of which must
+	     *       be processed when splitting the list, e.g. "ab\tc\{\x41".
+	     */
+
+	    static const char *sequences[] = {
+		"\\n", "\\t", "\\\\", "\\{", "\\}", "\\\"", "\\ ", "\\x41",
+		"\\u00e9", "\\101", "\\a"
+	    };
+
+	    int count = 1 + (int)NextRandom(6);
+	    int index;
+
+	    for (index = 0; index < count; index++) {
+		const char *pSequence = sequences[NextRandom(
+		    sizeof(sequences) / sizeof(sequences[0]))];
+
+		length += AppendWord(pBuffer, length, 0, 4);
+
+		while (*pSequence != '\0')
+		    pBuffer[length++] = (WCHAR)*pSequence++;
+	    }
+
+	    break;
+	}
+	case BENCH_CORPUS_UNICODE: {
+	    /*
+	     * NOTE: A word made of non-ASCII characters, some of which are
+	     *       outside of the Basic Multilingual Plane (i.e. surrogate
+	     *       pairs).
+	     */
+
+	    int count = 1 + (int)NextRandom(10);
+	    int index;
+
+	    for (index = 0; index < count; index++) {
+		switch (NextRandom(4)) {
+		    case 0: /* Latin-1 Supplement */
+			pBuffer[length++] = (WCHAR)(0x00C0 + NextRandom(0x40));
+			break;
+		    case 1: /* Greek */
+			pBuffer[length++] = (WCHAR)(0x03B1 + NextRandom(0x19));
+			break;
+		    case 2: /* CJK Unified Ideographs */
+			pBuffer[length++] = (WCHAR)(0x4E00 + NextRandom(0x5000));
+			break;
+		    case 3: /* Supplementary planes (e.g. emoji) */
+			pBuffer[length++] = (WCHAR)0xD83D;
+			pBuffer[length++] = (WCHAR)(0xDE00 + NextRandom(0x50));
+			break;
+		}
+	    }
+
+	    break;
+	}
+    }
+
+    return length;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GenerateCorpus --
+ *
+ *	Generates the text of a list of the specified kind that is (almost)
+ *	exactly the specified number of bytes in size.  The list elements are
+ *	separated by single spaces, except for one in every 16, which is
+ *	followed by a newline instead.
+ *
+ * Results:
+ *	The NUL terminated list text -OR- NULL if out of memory.  The caller
+ *	must free it via free().
+ *
+ * Side effects:
+ *	The pseudo-random number generator state is modified.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static LPWSTR
+GenerateCorpus(
+    int corpus,			/* The kind of list to generate. */
+    SIZE_T byteSize,		/* The wanted size of the list text. */
+    LPSIZE_T pLength)		/* OUT: The length of the list text. */
+{
+    SIZE_T maximum = byteSize / sizeof(WCHAR);
+    SIZE_T length = 0;
+    SIZE_T count = 0;
+    LPWSTR pBuffer;
+
+    pBuffer = malloc(
+	((size_t)maximum + BENCH_MAXIMUM_ELEMENT + 2) * sizeof(WCHAR));
+
+    if (pBuffer == NULL)
+	return NULL;
+
+    while (length < maximum) {
+	SIZE_T added;
+
+	if (length > 0)
+	    pBuffer[length++] = ((++count % 16) == 0) ? '\n' : ' ';
+
+	added = AppendElement(corpus, pBuffer + length);
+
+	/*
+	 * NOTE: Never cut an element in half; that could produce a list
+	 *       with invalid structure.  Instead, trim trailing whitespace
+	 *       and stop.
+	 */
+
+	if (length + added > maximum) {
+	    if (length > 0)
+		length--;
+
+	    break;
+	}
+
+	length += added;
+    }
+
+    pBuffer[length] = 0;
+    *pLength = length;
+
+    return pBuffer;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * LoadBenchLibrary --
+ *
+ *	Loads the native utility library and looks up its exports.
+ *
+ * Results:
+ *	Non-zero upon success.
+ *
+ * Side effects:
+ *	The library is loaded.  An error message is written to the standard
+ *	error channel upon failure.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static int
+LoadBenchLibrary(
+    const char *pFileName,	/* The file name of the library. */
+    LPBENCH_LIBRARY pLibrary)	/* OUT: The loaded library. */
+{
+    memset(pLibrary, 0, sizeof(BENCH_LIBRARY));
+    pLibrary->hModule = dlopen(pFileName, RTLD_NOW | RTLD_LOCAL);
+
+    if (pLibrary->hModule == NULL) {
+	fprintf(stderr, "cannot load library: %s\n", dlerror());
+	return 0;
+    }
+
+#define LOOKUP_EXPORT(field, type, name) \
+    pLibrary->field = (type)dlsym(pLibrary->hModule, name)
+
+    LOOKUP_EXPORT(getVersion, GET_VERSION_PROC, "Eagle_GetVersion");
+    LOOKUP_EXPORT(freeVersion, FREE_VERSION_PROC, "Eagle_FreeVersion");
+    LOOKUP_EXPORT(freeMemory, FREE_MEMORY_PROC, "Eagle_FreeMemory");
+    LOOKUP_EXPORT(freeElements, FREE_ELEMENTS_PROC, "Eagle_FreeElements");
+    LOOKUP_EXPORT(getMemoryStatistics, GET_MEMORY_STATISTICS_PROC,
+	"Eagle_GetMemoryStatistics");
+    LOOKUP_EXPORT(splitList, SPLIT_LIST_PROC, "Eagle_SplitList");
+    LOOKUP_EXPORT(joinList, JOIN_LIST_PROC, "Eagle_JoinList");
+
+#undef LOOKUP_EXPORT
+
+    if ((pLibrary->getVersion == NULL) || (pLibrary->freeVersion == NULL) ||
+	(pLibrary->freeMemory == NULL) || (pLibrary->freeElements == NULL) ||
+	(pLibrary->splitList == NULL) || (pLibrary->joinList == NULL)) {
+	fprintf(stderr, "library \"%s\" is missing required exports\n",
+	    pFileName);
+
+	dlclose(pLibrary->hModule);
+	pLibrary->hModule = NULL;
+	return 0;
+    }
+
+    return 1;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * GetAllocationCount --
+ *
+ *	Queries the total number of memory allocations made by the library.
+ *
+ * Results:
+ *	The number of memory allocations -OR- -1 if the library does not
+ *	support memory statistics.
+ *
+ * Side effects:
+ *	None.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static long
+GetAllocationCount(
+    LPBENCH_LIBRARY pLibrary)	/* The loaded library. */
+{
+    MEMORY_STATISTICS statistics;
+    LPCWSTR pError = NULL;
+
+    if (pLibrary->getMemoryStatistics == NULL)
+	return -1;
+
+    if (pLibrary->getMemoryStatistics(sizeof(MEMORY_STATISTICS),
+	    &statistics, &pError) != EAGLE_OK) {
+	if (pError != NULL)
+	    pLibrary->freeMemory((LPVOID)pError);
+
+	return -1;
+    }
+
+    return (long)statistics.allocationCount;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * MeasureSplit --
+ *
+ *	Splits the list text repeatedly, until at least the minimum amount
+ *	of time has elapsed.
+ *
+ * Results:
+ *	Non-zero upon success.
+ *
+ * Side effects:
+ *	An error message is written to the standard error channel upon
+ *	failure.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static int
+MeasureSplit(
+    LPBENCH_LIBRARY pLibrary,	/* The loaded library. */
+    double minimumTime,		/* The minimum time to spend, in seconds. */
+    SIZE_T length,		/* The length of the list text. */
+    LPCWSTR pText,		/* The list text. */
+    LPSIZE_T pElementCount,	/* OUT: The number of list elements. */
+    LPBENCH_RESULT pResult)	/* OUT: The measurements. */
+{
+    long before = GetAllocationCount(pLibrary);
+
+    memset(pResult, 0, sizeof(BENCH_RESULT));
+    pResult->allocations = -1;
+
+    while ((pResult->iterations < BENCH_MAXIMUM_ITERATIONS) &&
+	    ((pResult->iterations == 0) || (pResult->seconds < minimumTime))) {
+	SIZE_T elementCount = 0;
+	LPSIZE_T pElementLengths = NULL;
+	LPCWSTR *ppElements = NULL;
+	LPCWSTR pError = NULL;
+	double start, elapsed;
+
+	start = GetSeconds();
+
+	if (pLibrary->splitList(length, pText, &elementCount,
+		&pElementLengths, &ppElements, &pError) != EAGLE_OK) {
+	    fprintf(stderr, "split failed: ");
+	    WriteJsonString(stderr, pError);
+	    fprintf(stderr, "\n");
+
+	    if (pError != NULL)
+		pLibrary->freeMemory((LPVOID)pError);
+
+	    return 0;
+	}
+
+	pLibrary->freeMemory(pElementLengths);
+	pLibrary->freeElements(elementCount, (LPWSTR *)ppElements);
+
+	elapsed = GetSeconds() - start;
+
+	if ((pResult->iterations == 0) || (elapsed < pResult->bestSeconds))
+	    pResult->bestSeconds = elapsed;
+
+	pResult->seconds += elapsed;
+	pResult->iterations++;
+
+	if ((pResult->iterations == 1) && (before >= 0))
+	    pResult->allocations = GetAllocationCount(pLibrary) - before;
+
+	*pElementCount = elementCount;
+    }
+
+    return 1;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * MeasureJoin --
+ *
+ *	Joins the list elements repeatedly, until at least the minimum
+ *	amount of time has elapsed.
+ *
+ * Results:
+ *	Non-zero upon success.
+ *
+ * Side effects:
+ *	An error message is written to the standard error channel upon
+ *	failure.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static int
+MeasureJoin(
+    LPBENCH_LIBRARY pLibrary,	/* The loaded library. */
+    double minimumTime,		/* The minimum time to spend, in seconds. */
+    SIZE_T elementCount,	/* The number of list elements. */
+    LPCSIZE_T pElementLengths,	/* The lengths of the list elements. */
+    LPCWSTR *ppElements,	/* The list elements. */
+    LPBENCH_RESULT pResult)	/* OUT: The measurements. */
+{
+    long before = GetAllocationCount(pLibrary);
+
+    memset(pResult, 0, sizeof(BENCH_RESULT));
+    pResult->allocations = -1;
+
+    while ((pResult->iterations < BENCH_MAXIMUM_ITERATIONS) &&
+	    ((pResult->iterations == 0) || (pResult->seconds < minimumTime))) {
+	SIZE_T length = 0;
+	LPCWSTR pText = NULL;
+	LPCWSTR pError = NULL;
+	double start, elapsed;
+
+	start = GetSeconds();
+
+	if (pLibrary->joinList(elementCount, pElementLengths, ppElements,
+		&length, &pText, &pError) != EAGLE_OK) {
+	    fprintf(stderr, "join failed: ");
+	    WriteJsonString(stderr, pError);
+	    fprintf(stderr, "\n");
+
+	    if (pError != NULL)
+		pLibrary->freeMemory((LPVOID)pError);
+
+	    return 0;
+	}
+
+	pLibrary->freeMemory((LPVOID)pText);
+
+	elapsed = GetSeconds() - start;
+
+	if ((pResult->iterations == 0) || (elapsed < pResult->bestSeconds))
+	    pResult->bestSeconds = elapsed;
+
+	pResult->seconds += elapsed;
+	pResult->iterations++;
+
+	if ((pResult->iterations == 1) && (before >= 0))
+	    pResult->allocations = GetAllocationCount(pLibrary) - before;
+    }
+
+    return 1;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * WriteResult --
+ *
+ *	Writes the measurements for one operation as a JSON object.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Output is written to the file.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static void
+WriteResult(
+    FILE *pFile,		/* The file to write to. */
+    const char *pName,		/* The name of the operation. */
+    SIZE_T byteSize,		/* The size of the list text, in bytes. */
+    SIZE_T elementCount,	/* The number of list elements. */
+    LPBENCH_RESULT pResult)	/* The measurements. */
+{
+    double average = pResult->seconds / (double)pResult->iterations;
+
+    fprintf(pFile,
+	"      \"%s\": {\"iterations\": %ld, \"averageSeconds\": %.9f, "
+	"\"bestSeconds\": %.9f, \"nsPerElement\": %.3f, "
+	"\"bytesPerSecond\": %.0f, \"allocations\": ",
+	pName, pResult->iterations, average, pResult->bestSeconds,
+	(elementCount > 0) ?
+	    (pResult->bestSeconds * 1000000000.0) / (double)elementCount : 0.0,
+	(pResult->bestSeconds > 0.0) ?
+	    (double)byteSize / pResult->bestSeconds : 0.0);
+
+    if (pResult->allocations >= 0)
+	fprintf(pFile, "%ld}", pResult->allocations);
+    else
+	fprintf(pFile, "null}");
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * RunCorpus --
+ *
+ *	Generates one list of the specified kind and size, then measures the
+ *	split and join operations on it.
+ *
+ * Results:
+ *	Non-zero upon success.
+ *
+ * Side effects:
+ *	Output is written to the file.  The first flag is cleared.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static int
+RunCorpus(
+    FILE *pFile,		/* The file to write to. */
+    LPBENCH_LIBRARY pLibrary,	/* The loaded library. */
+    double minimumTime,		/* The minimum time per operation. */
+    int corpus,			/* The kind of list to generate. */
+    SIZE_T byteSize,		/* The wanted size of the list text. */
+    int *pFirst)		/* IN/OUT: Non-zero before the first result. */
+{
+    SIZE_T length = 0;
+    SIZE_T elementCount = 0;
+    LPSIZE_T pElementLengths = NULL;
+    LPCWSTR *ppElements = NULL;
+    LPCWSTR pError = NULL;
+    LPWSTR pText;
+    BENCH_RESULT splitResult;
+    BENCH_RESULT joinResult;
+    int code = 0;
+
+    pText = GenerateCorpus(corpus, byteSize, &length);
+
+    if (pText == NULL) {
+	fprintf(stderr, "out of memory generating %s corpus (%ld bytes)\n",
+	    corpusNames[corpus], (long)byteSize);
+
+	return 0;
+    }
+
+    if (!MeasureSplit(pLibrary, minimumTime, length, pText, &elementCount,
+	    &splitResult)) {
+	goto done;
+    }
+
+    /*
+     * NOTE: The join operation needs the list elements; therefore, split
+     *       the list one more time (outside of the measured region).
+     */
+
+    if (pLibrary->splitList(length, pText, &elementCount, &pElementLengths,
+	    &ppElements, &pError) != EAGLE_OK) {
+	if (pError != NULL)
+	    pLibrary->freeMemory((LPVOID)pError);
+
+	goto done;
+    }
+
+    if (!MeasureJoin(pLibrary, minimumTime, elementCount, pElementLengths,
+	    ppElements, &joinResult)) {
+	goto done;
+    }
+
+    fprintf(pFile, "%s    {\"corpus\": \"%s\", \"bytes\": %ld, "
+	"\"characters\": %ld, \"elements\": %ld,\n", *pFirst ? "" : ",\n",
+	corpusNames[corpus], (long)(length * sizeof(WCHAR)), (long)length,
+	(long)elementCount);
+
+    WriteResult(pFile, "split", length * sizeof(WCHAR), elementCount,
+	&splitResult);
+
+    fprintf(pFile, ",\n");
+
+    WriteResult(pFile, "join", length * sizeof(WCHAR), elementCount,
+	&joinResult);
+
+    fprintf(pFile, "}");
+    fflush(pFile);
+
+    *pFirst = 0;
+    code = 1;
+
+done:
+    if (pElementLengths != NULL)
+	pLibrary->freeMemory(pElementLengths);
+
+    if (ppElements != NULL)
+	pLibrary->freeElements(elementCount, (LPWSTR *)ppElements);
+
+    free(pText);
+    return code;
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * Usage --
+ *
+ *	Writes the command line syntax to the standard error channel.
+ *
+ * Results:
+ *	None.
+ *
+ * Side effects:
+ *	Output is written to the standard error channel.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+static void
+Usage(
+    const char *pProgram)	/* The name of this program. */
+{
+    fprintf(stderr,
+	"usage: %s [-library <fileName>] [-corpus <name,...|all>]\n"
+	"       [-sizes <size,...>] [-seed <number>] [-time <seconds>]\n"
+	"       [-scalar]\n\n"
+	"corpus names: words, braces, backslash, unicode (default: all)\n"
+	"sizes are in bytes, with optional K/M/G suffix (default: %s)\n",
+	pProgram, BENCH_DEFAULT_SIZES);
+}
+
+/*
+ *---------------------------------------------------------------------------
+ *
+ * main --
+ *
+ *	The entry point for this program.
+ *
+ * Results:
+ *	Zero upon success, non-zero on failure.
+ *
+ * Side effects:
+ *	Output is written to the standard output channel.
+ *
+ *---------------------------------------------------------------------------
+ */
+
+int
+main(
+    int argc,			/* The number of command line arguments. */
+    char **argv)		/* The command line arguments. */
+{
+    const char *pFileName = BENCH_DEFAULT_LIBRARY;
+    SIZE_T sizes[BENCH_MAXIMUM_SIZES];
+    int sizeCount = 0;
+    int selected[BENCH_CORPORA];
+    unsigned long long seed = BENCH_DEFAULT_SEED;
+    double minimumTime = BENCH_DEFAULT_MINIMUM_TIME;
+    int scalar = 0;
+    BENCH_LIBRARY library;
+    LPCWSTR pVersion;
+    int index, corpus, first = 1, code = 0;
+
+    ParseSizes(BENCH_DEFAULT_SIZES, sizes, &sizeCount);
+    ParseCorpora("all", selected);
+
+    for (index = 1; index < argc; index++) {
+	const char *pOption = argv[index];
+
+	if (strcmp(pOption, "-scalar") == 0) {
+	    scalar = 1;
+	    continue;
+	}
+
+	if (index + 1 >= argc) {
+	    Usage(argv[0]);
+	    return 1;
+	}
+
+	index++;
+
+	if (strcmp(pOption, "-library") == 0) {
+	    pFileName = argv[index];
+	} else if (strcmp(pOption, "-corpus") == 0) {
+	    if (!ParseCorpora(argv[index], selected)) {
+		Usage(argv[0]);
+		return 1;
+	    }
+	} else if (strcmp(pOption, "-sizes") == 0) {
+	    if (!ParseSizes(argv[index], sizes, &sizeCount)) {
+		Usage(argv[0]);
+		return 1;
+	    }
+	} else if (strcmp(pOption, "-seed") == 0) {
+	    seed = strtoull(argv[index], NULL, 0);
+	} else if (strcmp(pOption, "-time") == 0) {
+	    minimumTime = strtod(argv[index], NULL);
+	} else {
+	    Usage(argv[0]);
+	    return 1;
+	}
+    }
+
+    /*
+     * NOTE: The library checks this environment variable only once, the
+     *       first time it needs to scan list text; therefore, it must be
+     *       set before the library is loaded.
+     */
+
+    if (scalar)
+	setenv(BENCH_NO_SIMD_VAR_NAME, "1", 1);
+    else
+	unsetenv(BENCH_NO_SIMD_VAR_NAME);
+
+    if (!LoadBenchLibrary(pFileName, &library))
+	return 1;
+
+    pVersion = library.getVersion();
+
+    /*
+     * NOTE: The SIZE_T type used by this program must match the one used
+     *       by the library; otherwise, every call would be garbage.
+     */
+
+#if defined(USE_32BIT_SIZE_T) && USE_32BIT_SIZE_T
+    if (!HasVersionOption(pVersion, " USE_32BIT_SIZE_T=1")) {
+#else
+    if (HasVersionOption(pVersion, " USE_32BIT_SIZE_T=1")) {
+#endif
+	fprintf(stderr, "library \"%s\" uses a different SIZE_T type\n",
+	    pFileName);
+
+	if (pVersion != NULL)
+	    library.freeVersion((LPVOID)pVersion);
+
+	dlclose(library.hModule);
+	return 1;
+    }
+
+    printf("{\n  \"version\": ");
+    WriteJsonString(stdout, pVersion);
+    printf(",\n  \"library\": \"%s\",\n  \"scan\": \"%s\",\n"
+	"  \"seed\": %llu,\n  \"minimumTime\": %g,\n"
+	"  \"sizeofSizeT\": %d,\n  \"results\": [\n", pFileName,
+	scalar ? "scalar" : "default", seed, minimumTime,
+	(int)sizeof(SIZE_T));
+
+    if (pVersion != NULL)
+	library.freeVersion((LPVOID)pVersion);
+
+    for (index = 0; index < sizeCount; index++) {
+	for (corpus = 0; corpus < BENCH_CORPORA; corpus++) {
+	    if (!selected[corpus])
+		continue;
+
+	    /*
+	     * NOTE: Reseed for each list, so that the list for any given
+	     *       corpus, size, and seed never depends upon what else
+	     *       was selected.
+	     */
+
+	    SeedRandom(seed + (unsigned long long)corpus);
+
+	    if (!RunCorpus(stdout, &library, minimumTime, corpus,
+		    sizes[index], &first)) {
+		code = 1;
+	    }
+	}
+    }
+
+    printf("\n  ]\n}\n");
+
+    dlclose(library.hModule);
+    return code;
+}
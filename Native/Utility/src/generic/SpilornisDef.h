@@ -18,17 +18,21 @@
  *       Mono runtime only support two byte characters in their P/Invoke
  *       marshalling subsystems.  Unfortunately, it appears that various
  *       compiler runtimes on non-Windows platforms (e.g. gcc on Linux)
- *       define "wchar_t" data type to be four bytes.  Most functions in
- *       this file cannot adapt to this difference; however, the version
- *       introspection entry point (i.e. "Eagle_GetVersion") can, since
- *       it is limited to output only.  This helps to enable the managed
- *       integration code to detect that the library is not suitable for
- *       use on those platforms (i.e. by detecting the SIZE_OF_WCHAR_T=4
- *       datum in the returned version string).
+ *       define "wchar_t" data type to be four bytes.  In that case, the
+ *       WCHAR data type used by this library is defined as an unsigned
+ *       sixteen bit integer instead (i.e. UTF-16 code units), which is
+ *       exactly what the managed code passes in and expects back.  This
+ *       means the C runtime library "wide" string functions cannot be
+ *       used; therefore, this library has its own versions of the few
+ *       that it needs.
  */
 
-#if defined(WCHAR_MAX) && defined(USHRT_MAX) && (WCHAR_MAX > USHRT_MAX)
-#define USE_WCHARSTRTOUSHORTSTR			1
+#if !defined(USE_UTF16_CHAR)
+#  if defined(__SIZEOF_WCHAR_T__) && (__SIZEOF_WCHAR_T__ > 2)
+#    define USE_UTF16_CHAR			1
+#  elif defined(WCHAR_MAX) && defined(USHRT_MAX) && (WCHAR_MAX > USHRT_MAX)
+#    define USE_UTF16_CHAR			1
+#  endif
 #endif
 
 /*
@@ -51,4 +55,87 @@
 #define USE_HEAPAPI				1
 #endif
 
+/*
+ * NOTE: Attempt to determine if we can use the pooled memory allocator,
+ *       which keeps freed memory blocks in size classes, with per-thread
+ *       caches, so they can be reused without calling into the C runtime
+ *       library.  This is only used when the Win32 API for heap memory
+ *       allocation is not available, because it requires POSIX threads.
+ */
+
+#if !defined(USE_POOL_ALLOCATOR) && !defined(_WIN32) && \
+    (!defined(USE_HEAPAPI) || !USE_HEAPAPI) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define USE_POOL_ALLOCATOR			1
+#endif
+
+/*
+ * NOTE: Attempt to determine if we can split very large lists using more
+ *       than one thread.  This requires POSIX threads.
+ */
+
+#if !defined(USE_PARALLEL_SPLIT) && !defined(_WIN32) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define USE_PARALLEL_SPLIT			1
+#endif
+
+/*
+ * NOTE: Attempt to determine if we can use per-thread storage for the small
+ *       arena used to hold scratch memory (e.g. the per-element flags used
+ *       by Eagle_JoinList).  Without it, scratch memory comes from the heap.
+ */
+
+#if !defined(USE_THREAD_ARENA)
+#  if defined(_MSC_VER) || defined(__GNUC__) || defined(__clang__)
+#    define USE_THREAD_ARENA			1
+#  endif
+#endif
+
+/*
+ * NOTE: Attempt to determine if we can use vector instructions to scan list
+ *       text.  The vector code operates on sixteen bit lanes, which matches
+ *       the WCHAR data type on all platforms.  It may be disabled via the
+ *       compiler command line (i.e. USE_SIMD_SCAN=0).
+ */
+
+#if !defined(USE_SIMD_SCAN)
+#  if defined(__SSE2__) || defined(_M_X64) || \
+      (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#    define USE_SIMD_SCAN			1
+#  elif defined(__aarch64__) || defined(_M_ARM64)
+#    define USE_SIMD_SCAN			1
+#  endif
+#endif
+
+/*
+ * NOTE: Each instruction set used to scan list text may also be disabled
+ *       individually via the compiler command line (e.g. USE_AVX2_SCAN=0).
+ *       The AVX2 code uses the SSE2 code for the trailing characters, so
+ *       disabling SSE2 also disables AVX2.
+ */
+
+#if defined(USE_SIMD_SCAN) && USE_SIMD_SCAN
+#  if defined(__SSE2__) || defined(_M_X64) || \
+      (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#    if !defined(USE_SSE2_SCAN)
+#      define USE_SSE2_SCAN			1
+#    endif
+#    if !defined(USE_AVX2_SCAN) && USE_SSE2_SCAN && \
+        ((defined(__GNUC__) && ((__GNUC__ > 4) || \
+        ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))) || \
+        defined(__clang__) || (defined(_MSC_VER) && (_MSC_VER >= 1700)))
+#      define USE_AVX2_SCAN			1
+#    endif
+#  elif defined(__aarch64__) || defined(_M_ARM64)
+#    if !defined(USE_NEON_SCAN)
+#      define USE_NEON_SCAN			1
+#    endif
+#  endif
+#endif
+
+#if defined(USE_AVX2_SCAN) && USE_AVX2_SCAN && \
+    (!defined(USE_SSE2_SCAN) || !USE_SSE2_SCAN)
+#  error "USE_AVX2_SCAN requires USE_SSE2_SCAN"
+#endif
+
 #endif /* _SPILORNIS_DEF_H_ */
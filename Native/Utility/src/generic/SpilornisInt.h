@@ -41,14 +41,76 @@
 #define STRINGIFY(x)				STRINGIFY1(x)
 #define STRINGIFY1(x)				#x
 
+/*
+ * NOTE: String literals must have the same character type as WCHAR.  When
+ *       the "wchar_t" data type is not used for that, this requires the C11
+ *       UTF-16 string literal prefix.
+ */
+
 #define UNICODIFY(x)				UNICODIFY1(x)
+#if defined(USE_UTF16_CHAR) && USE_UTF16_CHAR
+#define UNICODIFY1(x)				u##x
+#else
 #define UNICODIFY1(x)				L##x
+#endif
 
 /*****************************************************************************/
 
 #define NO_TRACE_VAR_NAME			"NoTraceSpilornis"
 #define NO_TRACE_UNICODE_VAR_NAME		UNICODIFY(NO_TRACE_VAR_NAME)
 
+#define NO_SIMD_VAR_NAME			"NoSimdSpilornis"
+#define NO_SIMD_UNICODE_VAR_NAME		UNICODIFY(NO_SIMD_VAR_NAME)
+
+#define SPLIT_THRESHOLD_VAR_NAME		"SplitThresholdSpilornis"
+#define SPLIT_THREADS_VAR_NAME			"SplitThreadsSpilornis"
+
+/*****************************************************************************/
+
+/*
+ * NOTE: These are the possible instruction set levels used when scanning
+ *       list text.  The level is detected at runtime, the first time it is
+ *       needed.
+ */
+
+#define SCAN_LEVEL_UNKNOWN			(0)
+#define SCAN_LEVEL_SCALAR			(1)
+#define SCAN_LEVEL_SSE2				(2)
+#define SCAN_LEVEL_AVX2				(3)
+#define SCAN_LEVEL_NEON				(4)
+
+/*****************************************************************************/
+
+/*
+ * NOTE: These are the kinds of compiled glob patterns.  All kinds, except
+ *       the generic one, can be matched without backtracking by comparing
+ *       the text against the literal portion of the pattern.
+ */
+
+#define MATCH_KIND_GENERIC			(0) /* e.g. "a?c", "[ab]*" */
+#define MATCH_KIND_ANY				(1) /* e.g. "*" */
+#define MATCH_KIND_EXACT			(2) /* e.g. "abc" */
+#define MATCH_KIND_PREFIX			(3) /* e.g. "abc*" */
+#define MATCH_KIND_SUFFIX			(4) /* e.g. "*abc" */
+#define MATCH_KIND_CONTAINS			(5) /* e.g. "*abc*" */
+
+/*****************************************************************************/
+
+/*
+ * NOTE: These are the character types used when parsing scripts.  They have
+ *       the same values as the managed CharacterType.  A line feed is always
+ *       a command terminator, never a space.
+ */
+
+#define CHAR_TYPE_NONE				(0x0)
+#define CHAR_TYPE_SPACE				(0x2)
+#define CHAR_TYPE_COMMAND_TERMINATOR		(0x4)
+#define CHAR_TYPE_SUBSTITUTION			(0x8)
+#define CHAR_TYPE_QUOTE				(0x10)
+#define CHAR_TYPE_CLOSE_PARENTHESIS		(0x20)
+#define CHAR_TYPE_CLOSE_BRACKET			(0x40)
+#define CHAR_TYPE_BRACE				(0x80)
+
 /*****************************************************************************/
 
 #define LIBRARY_UNICODE_NAME			UNICODIFY(LIBRARY_NAME)
@@ -60,18 +122,94 @@
 
 #ifndef NDEBUG
 #  define LIBRARY_FREED_MEMORY			(0xEA)
+#  define LIBRARY_UNINITIALIZED_MEMORY		(0xCD)
 #endif
 
+/*
+ * NOTE: This is the largest element count or size, in bytes, that will be
+ *       used.  When SIZE_T is unsigned, only half of its range is used, so
+ *       that the sum of any two such values cannot overflow.
+ */
+#if defined(USE_32BIT_SIZE_T) && USE_32BIT_SIZE_T
 #define LIBRARY_MAXIMUM_SIZE_T			((SIZE_T)0x7FFFFFFF)
+#else
+#define LIBRARY_MAXIMUM_SIZE_T			(((SIZE_T)-1) >> 1)
+#endif
 #define LIBRARY_RESULT_LENGTH			(192)
 #define LIBRARY_LOCAL_FLAGS			(20)
+#define LIBRARY_ARENA_SIZE			(16384)
 #define LIBRARY_VAR_BUFFER_LENGTH		(20)
+#define LIBRARY_INTEGER_BUFFER_LENGTH		(24)
+#define LIBRARY_NUMBER_BUFFER_LENGTH		(80)
 #define LIBRARY_TRACE_BUFFER_LENGTH		((SIZE_T)(4096-sizeof(DWORD)))
 
 /*****************************************************************************/
 
+/*
+ * NOTE: These are used by the pooled memory allocator.  The size classes
+ *       are powers of two, from 16 bytes to 64KB.  Larger memory blocks
+ *       are always obtained directly from the C runtime library.  Every
+ *       memory block is preceded by a header that records its size; the
+ *       header size preserves the alignment of the C runtime library.
+ *       The cache size is the number of bytes, per size class, that each
+ *       thread may keep; the shared size is the number of bytes, per size
+ *       class, kept by the shared pool when it is not in private mode.
+ */
+
+#define LIBRARY_POOL_CLASSES			(13)
+#define LIBRARY_POOL_MINIMUM_SHIFT		(4)
+#define LIBRARY_POOL_LARGE_CLASS		(-1)
+#define LIBRARY_POOL_HEADER_SIZE		(16)
+#define LIBRARY_POOL_CACHE_SIZE			(65536)
+#define LIBRARY_POOL_SHARED_SIZE		(1048576)
+
+/*****************************************************************************/
+
+/*
+ * NOTE: These are used when splitting very large lists using more than one
+ *       thread.  Lists shorter than the threshold, in characters, are always
+ *       split using only the calling thread.  Each thread is given at least
+ *       the minimum chunk size, in characters, unless the threshold itself
+ *       is smaller.  The fix-up size is the initial number of elements that
+ *       can be held while stitching the chunks back together.
+ */
+
+#define LIBRARY_SPLIT_THRESHOLD			(4194304)
+#define LIBRARY_SPLIT_MINIMUM_CHUNK		(262144)
+#define LIBRARY_SPLIT_MAXIMUM_THREADS		(256)
+#define LIBRARY_SPLIT_FIXUP_SIZE		(64)
+
+/*****************************************************************************/
+
+/*
+ * NOTE: These are used when sorting lists.  Lists with fewer elements than
+ *       the threshold are always sorted using only the calling thread; the
+ *       number of threads is otherwise the same as for splitting.  Each
+ *       thread is given at least the minimum chunk size, in elements.  The
+ *       run length is the number of elements that are insertion sorted
+ *       before they are merged.
+ */
+
+#define LIBRARY_SORT_THRESHOLD			(65536)
+#define LIBRARY_SORT_MINIMUM_CHUNK		(16384)
+#define LIBRARY_SORT_RUN_LENGTH			(32)
+
+/*****************************************************************************/
+
+/*
+ * NOTE: These are used when parsing scripts.  The token size is the initial
+ *       number of tokens that can be held; it is doubled as necessary.  The
+ *       maximum depth limits the nesting of commands within commands, so the
+ *       stack of the calling thread cannot be exhausted.
+ */
+
+#define LIBRARY_PARSE_TOKEN_SIZE		(256)
+#define LIBRARY_PARSE_MAXIMUM_DEPTH		(1000)
+
+/*****************************************************************************/
+
 #define LIBRARY_VERSION_LENGTH			(256)
-#define LIBRARY_VERSION_FORMAT			L"%ls v%ls [%ls %ls]%ls%ls%d%ls%ls%ls\0"
+#define LIBRARY_VERSION_FORMAT			UNICODIFY("%ls v%ls [%ls %ls]%ls%ls%d%ls%d%ls%ls%ls%ls%ls%ls")
 
 /*****************************************************************************/
 
@@ -86,6 +224,7 @@
 /*****************************************************************************/
 
 #define AllocateMemoryWrapper(size)		calloc((size), sizeof(BYTE))
+#define AllocateRawMemoryWrapper(size)		malloc((size))
 #define FreeMemoryWrapper(pMemory)		free((pMemory))
 
 #if defined(HAVE_MALLOC_H)
@@ -102,6 +241,71 @@
 
 /*****************************************************************************/
 
+/*
+ * NOTE: These macros are used to keep the memory accounting consistent when
+ *       this library is called from multiple threads at the same time.  The
+ *       result is the new value.
+ */
+
+#if defined(_MSC_VER)
+#  if defined(_WIN64) && \
+      (!defined(USE_32BIT_SIZE_T) || !USE_32BIT_SIZE_T)
+#    define AtomicAddWrapper(pValue, value) \
+	((SIZE_T)_InterlockedExchangeAdd64((volatile __int64 *)(pValue), \
+	    (__int64)(value)) + (value))
+#  else
+#    define AtomicAddWrapper(pValue, value) \
+	((SIZE_T)_InterlockedExchangeAdd((volatile long *)(pValue), \
+	    (long)(value)) + (value))
+#  endif
+#elif defined(__GNUC__) || defined(__clang__)
+#  define AtomicAddWrapper(pValue, value) \
+	__sync_add_and_fetch((pValue), (value))
+#else
+#  define AtomicAddWrapper(pValue, value)	(*(pValue) += (value))
+#endif
+
+#define AtomicSubtractWrapper(pValue, value) \
+	AtomicAddWrapper((pValue), (SIZE_T)0 - (value))
+
+/*
+ * NOTE: This macro stores the new value only if the current value is equal
+ *       to the old value.  The result is the original value.
+ */
+
+#if defined(_MSC_VER)
+#  if defined(_WIN64) && \
+      (!defined(USE_32BIT_SIZE_T) || !USE_32BIT_SIZE_T)
+#    define AtomicCompareExchangeWrapper(pValue, newValue, oldValue) \
+	((SIZE_T)_InterlockedCompareExchange64((volatile __int64 *)(pValue), \
+	    (__int64)(newValue), (__int64)(oldValue)))
+#  else
+#    define AtomicCompareExchangeWrapper(pValue, newValue, oldValue) \
+	((SIZE_T)_InterlockedCompareExchange((volatile long *)(pValue), \
+	    (long)(newValue), (long)(oldValue)))
+#  endif
+#elif defined(__GNUC__) || defined(__clang__)
+#  define AtomicCompareExchangeWrapper(pValue, newValue, oldValue) \
+	__sync_val_compare_and_swap((pValue), (oldValue), (newValue))
+#else
+#  define AtomicCompareExchangeWrapper(pValue, newValue, oldValue) \
+	((*(pValue) == (oldValue)) ? \
+	    (*(pValue) = (newValue), (oldValue)) : *(pValue))
+#endif
+
+/*
+ * NOTE: How should per-thread data be declared?  This is used for the
+ *       scratch memory arena (see USE_THREAD_ARENA).
+ */
+
+#if defined(_MSC_VER)
+#  define THREAD_LOCAL				__declspec(thread)
+#elif defined(__GNUC__) || defined(__clang__)
+#  define THREAD_LOCAL				__thread
+#endif
+
+/*****************************************************************************/
+
 #ifndef _CONST_DEFINED
 #define _CONST_DEFINED
 #define CONST const
@@ -172,6 +376,15 @@ typedef unsigned long UCSCHAR;
 typedef UCSCHAR *LPUCSCHAR;
 #endif
 
+#ifndef _UWIDEINT_DEFINED
+#define _UWIDEINT_DEFINED
+#if defined(_MSC_VER)
+typedef unsigned __int64 UWIDEINT;
+#else
+typedef unsigned long long UWIDEINT;
+#endif
+#endif
+
 #ifndef _BSTR_DEFINED
 #define _BSTR_DEFINED
 typedef wchar_t *BSTR;